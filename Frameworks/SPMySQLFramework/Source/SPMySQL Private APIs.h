@@ -101,6 +101,7 @@
 - (void)_updateLastErrorMessage:(NSString *)theErrorMessage;
 - (void)_updateLastErrorID:(NSUInteger)theErrorID;
 - (void)_updateLastSqlstate:(NSString *)theSqlstate;
+- (void)_discardPreparedStatementsClosingThem:(BOOL)closeStatements;
 
 @end
 
@@ -28,6 +28,21 @@
 //
 //  More info at <https://github.com/sequelpro/sequelpro>
 
+/**
+ * Supplies the data for a LOAD DATA LOCAL INFILE query: fills the buffer with up to bufferLength
+ * bytes, returning the number written, 0 once all the data has been supplied, or -1 to abort.
+ */
+typedef NSInteger (^SPMySQLLocalDataReader)(void *buffer, NSUInteger bufferLength);
+
+/**
+ * A value for a placeholder of a prepared statement: the bytes of a string in the encoding the
+ * statement was prepared with, sent as they are without escaping, or NULL bytes for SQL NULL.
+ */
+typedef struct {
+	const void *bytes;
+	NSUInteger length;
+} SPMySQLBoundValue;
+
 @interface SPMySQLConnection (Querying_and_Preparation)
 
 // Data preparation
@@ -53,6 +68,14 @@
 - (id)queryString:(NSString *)theQueryString usingEncoding:(NSStringEncoding)theEncoding withResultType:(SPMySQLResultType)theReturnType;
 - (id)queryString:(NSString *)theQueryString usingEncoding:(NSStringEncoding)theEncoding withResultType:(SPMySQLResultType)theReturnType assertingDatabase:(NSString *)databaseName;
 - (id)queryString:(NSString *)theQueryString usingEncoding:(NSStringEncoding)theEncoding withResultType:(SPMySQLResultType)theReturnType assertingDatabaseContext:(NSString *)databaseName;
+- (NSUInteger)queryStatements:(NSArray *)theQueries usingEncoding:(NSStringEncoding)theEncoding affectedRowCounts:(unsigned long long *)theAffectedRowCounts assertingDatabaseContext:(NSString *)databaseName;
+- (BOOL)queryLoadingLocalData:(NSString *)theQueryString usingEncoding:(NSStringEncoding)theEncoding fromReader:(SPMySQLLocalDataReader)theReader assertingDatabaseContext:(NSString *)databaseName;
+
+// Prepared statements
+- (BOOL)prepareStatement:(NSString *)theQueryString usingEncoding:(NSStringEncoding)theEncoding assertingDatabaseContext:(NSString *)databaseName;
+- (BOOL)queryPreparedStatement:(NSString *)theQueryString withValues:(const SPMySQLBoundValue *)theValues count:(NSUInteger)valueCount usingEncoding:(NSStringEncoding)theEncoding assertingDatabaseContext:(NSString *)databaseName;
+- (void)closePreparedStatement:(NSString *)theQueryString;
+- (void)closePreparedStatements;
 
 // Query convenience functions
 - (NSArray *)getAllRowsFromQuery:(NSString *)theQueryString;
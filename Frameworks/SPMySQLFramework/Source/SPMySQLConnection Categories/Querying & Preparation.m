@@ -40,9 +40,47 @@
     withResultType:(SPMySQLResultType)theReturnType
  assertingDatabase:(NSString *)databaseName
 databaseContextIsRequired:(BOOL)databaseContextIsRequired;
+- (MYSQL_STMT *)_preparedStatementForQuery:(NSString *)theQueryString
+                             usingEncoding:(NSStringEncoding)theEncoding
+                                   errorID:(NSUInteger *)theErrorID
+                              errorMessage:(NSString **)theErrorMessage
+                                  sqlstate:(NSString **)theSqlstate;
 
 @end
 
+// The number of prepared statements kept on the server at once
+static const NSUInteger SPMySQLMaxPreparedStatements = 8;
+
+/**
+ * Callbacks for the MySQL client library, which hand a LOAD DATA LOCAL INFILE query the data
+ * from the reader block supplied as userdata instead of opening the file the query names.
+ */
+static int _localDataInit(void **context, const char *filename, void *userdata)
+{
+	*context = userdata;
+
+	return 0;
+}
+
+static int _localDataRead(void *context, char *buffer, unsigned int bufferLength)
+{
+	SPMySQLLocalDataReader reader = (__bridge SPMySQLLocalDataReader)context;
+	NSInteger readLength = reader(buffer, bufferLength);
+
+	return (readLength < 0) ? -1 : (int)readLength;
+}
+
+static void _localDataEnd(void *context)
+{
+}
+
+static int _localDataError(void *context, char *errorMessage, unsigned int errorMessageLength)
+{
+	snprintf(errorMessage, errorMessageLength, "The data to load could not be read");
+
+	return 2000; // CR_UNKNOWN_ERROR
+}
+
 @implementation SPMySQLConnection (Querying_and_Preparation)
 
 #pragma mark -
@@ -539,6 +577,476 @@ databaseContextIsRequired:(BOOL)databaseContextIsRequired
 	return theResult;
 }
 
+/**
+ * Run several statements as a single multi-statement query, saving a network round
+ * trip for each statement after the first.  Any result sets are discarded.
+ * Multi-statement support is only enabled on the session for the duration of the call.
+ * The statements are run in order, stopping at the first which fails, and the number
+ * which succeeded is returned; if it is less than the number supplied, the statement
+ * at that index failed and the last error describes it.  The number of rows affected
+ * by each successful statement is written to the supplied array, if any.
+ * Returns NSNotFound if nothing was run, eg because the connection was unavailable, the
+ * combined query is larger than the maximum query size, the database context couldn't be
+ * asserted or multi-statement support couldn't be enabled; the statements can then be
+ * run individually instead.
+ */
+- (NSUInteger)queryStatements:(NSArray *)theQueries usingEncoding:(NSStringEncoding)theEncoding affectedRowCounts:(unsigned long long *)theAffectedRowCounts assertingDatabaseContext:(NSString *)databaseName
+{
+	NSString *theErrorMessage = nil;
+	NSUInteger theErrorID = 0;
+	NSString *theSqlstate = nil;
+	NSUInteger queryCount = [theQueries count];
+	lastQueryWasCancelled = NO;
+
+	if (!queryCount || userTriggeredDisconnect || state == SPMySQLDisconnected || state == SPMySQLConnecting) return NSNotFound;
+
+	// Ensure per-thread variables are set up
+	[self _validateThreadSetup];
+
+	// Check the connection if necessary, leaving the statements to be run individually if it couldn't be validated
+	if (![self checkConnectionIfNecessary]) return NSNotFound;
+
+	// Determine whether a maximum query size needs to be restored from a previous query
+	if (queryActionShouldRestoreMaxQuerySize != NSNotFound) {
+		[self _restoreMaximumQuerySizeAfterQuery];
+	}
+
+	// Join the statements, ending each on a new line so a trailing comment can't swallow the separator
+	NSMutableData *queryData = [NSMutableData data];
+	for (NSString *eachQuery in theQueries) {
+		[queryData appendData:[eachQuery dataUsingEncoding:theEncoding allowLossyConversion:YES]];
+		[queryData appendBytes:"\n;\n" length:3];
+	}
+
+	if ([queryData length] > maxQuerySize) return NSNotFound;
+
+	// Lock the connection while it's actively in use
+	[self _lockConnection];
+	if (!databaseAssertionState) {
+		databaseAssertionState = [[SADatabaseAssertionState alloc] init];
+	}
+
+	NSUInteger succeededCount = 0;
+	SADatabaseAssertionError *databaseAssertionError = [databaseAssertionState
+		assertDatabase:databaseName
+		required:YES
+		onMySQLConnection:mySQLConnection
+		errorStringEncodingValue:stringEncoding
+		stringEncodingProvider:^NSUInteger(NSString *characterSetName) {
+			return [SPMySQLConnection stringEncodingForMySQLCharset:[characterSetName UTF8String]];
+		}];
+
+	// Nothing has been sent if either of these fail, so leave the statements to be run individually
+	if (databaseAssertionError || mysql_set_server_option(mySQLConnection, MYSQL_OPTION_MULTI_STATEMENTS_ON)) {
+		[self _unlockConnection];
+
+		return NSNotFound;
+	}
+
+	// Only log the statements once they're certain to be sent, as they'll otherwise be logged again when run individually
+	if (delegateQueryLogging && delegateSupportsWillQueryString) {
+		for (NSString *eachQuery in theQueries) {
+			[delegate willQueryString:eachQuery connection:self];
+		}
+	}
+
+	int queryStatus = mysql_real_query(mySQLConnection, [queryData bytes], [queryData length]);
+
+	// Walk the results, one per statement, until a statement fails or none are left
+	while (!queryStatus) {
+		unsigned long long affectedRowCount = mysql_affected_rows(mySQLConnection);
+
+		if (mysql_field_count(mySQLConnection)) {
+			MYSQL_RES *eachResult = mysql_store_result(mySQLConnection);
+
+			if (eachResult) mysql_free_result(eachResult);
+		}
+
+		if (succeededCount < queryCount) {
+			[databaseAssertionState recordSuccessfulQuery:[theQueries objectAtIndex:succeededCount] onMySQLConnection:mySQLConnection];
+			if (theAffectedRowCounts) theAffectedRowCounts[succeededCount] = affectedRowCount;
+			lastQueryAffectedRowCount = affectedRowCount;
+		}
+		succeededCount++;
+
+		queryStatus = mysql_next_result(mySQLConnection);
+	}
+
+	// mysql_next_result returns -1 once there are no more results, or a positive value when the next statement failed
+	if (queryStatus > 0) {
+		theErrorMessage = [self _stringForCString:mysql_error(mySQLConnection)];
+		theErrorID = mysql_errno(mySQLConnection);
+		// sqlstate is always an ASCII string, regardless of charset (but use latin1 anyway as that is less picky about invalid bytes)
+		theSqlstate = _stringForCStringWithEncoding(mysql_sqlstate(mySQLConnection), NSISOLatin1StringEncoding);
+
+		// Discard anything left behind by the failure so the connection can be reused
+		[self _flushMultipleResultSets];
+	}
+
+	mysql_set_server_option(mySQLConnection, MYSQL_OPTION_MULTI_STATEMENTS_OFF);
+
+	lastConnectionUsedTime = _monotonicTime();
+
+	// Update the connection's stored insert ID if available
+	if (mySQLConnection->insert_id) {
+		lastQueryInsertID = mySQLConnection->insert_id;
+	}
+
+	// If the query was cancelled, override the error state
+	if (lastQueryWasCancelled) {
+		theErrorMessage = NSLocalizedString(@"Query cancelled.", @"Query cancelled error");
+		theErrorID = 1317;
+		theSqlstate = @"70100";
+	}
+
+	[self _unlockConnection];
+
+	// Update error string and ID
+	[self _updateLastErrorMessage:theErrorMessage];
+	[self _updateLastErrorID:theErrorID];
+	[self _updateLastSqlstate:theSqlstate];
+
+	return MIN(succeededCount, queryCount);
+}
+
+/**
+ * Run a LOAD DATA LOCAL INFILE query, supplying the data from the reader block rather than from
+ * the file named in the query, so that data can be streamed to the server as it is read or
+ * decompressed.  The connection must have been made with allowDataLocalInfile set, and the
+ * reader is called on the current thread while the query runs.
+ * Returns whether the query succeeded; the last error describes any failure, including the
+ * server refusing local data (ER_NOT_ALLOWED_COMMAND or ER_CLIENT_LOCAL_FILES_DISABLED), and
+ * the rows loaded are available from -rowsAffectedByLastQuery.
+ */
+- (BOOL)queryLoadingLocalData:(NSString *)theQueryString usingEncoding:(NSStringEncoding)theEncoding fromReader:(SPMySQLLocalDataReader)theReader assertingDatabaseContext:(NSString *)databaseName
+{
+	NSString *theErrorMessage = nil;
+	NSUInteger theErrorID = 0;
+	NSString *theSqlstate = nil;
+	unsigned long long theAffectedRowCount = (unsigned long long)~0;
+	lastQueryWasCancelled = NO;
+
+	if (userTriggeredDisconnect || state == SPMySQLDisconnected || state == SPMySQLConnecting) return NO;
+
+	// Ensure per-thread variables are set up
+	[self _validateThreadSetup];
+
+	if (![self checkConnectionIfNecessary]) return NO;
+
+	if (delegateQueryLogging && delegateSupportsWillQueryString) {
+		[delegate willQueryString:theQueryString connection:self];
+	}
+
+	NSData *queryData = [theQueryString dataUsingEncoding:theEncoding allowLossyConversion:YES];
+
+	// Lock the connection while it's actively in use
+	[self _lockConnection];
+	if (!databaseAssertionState) {
+		databaseAssertionState = [[SADatabaseAssertionState alloc] init];
+	}
+
+	SADatabaseAssertionError *databaseAssertionError = [databaseAssertionState
+		assertDatabase:databaseName
+		required:YES
+		onMySQLConnection:mySQLConnection
+		errorStringEncodingValue:stringEncoding
+		stringEncodingProvider:^NSUInteger(NSString *characterSetName) {
+			return [SPMySQLConnection stringEncodingForMySQLCharset:[characterSetName UTF8String]];
+		}];
+
+	if (databaseAssertionError) {
+		theErrorID = databaseAssertionError.errorID;
+		theErrorMessage = databaseAssertionError.message;
+		theSqlstate = databaseAssertionError.sqlState;
+	}
+	else {
+
+		// The handler is only installed for this query, so any other LOAD DATA LOCAL INFILE
+		// on the connection still reads the file it names
+		mysql_set_local_infile_handler(mySQLConnection, _localDataInit, _localDataRead, _localDataEnd, _localDataError, (__bridge void *)theReader);
+
+		if (!mysql_real_query(mySQLConnection, [queryData bytes], [queryData length])) {
+			[databaseAssertionState recordSuccessfulQuery:theQueryString onMySQLConnection:mySQLConnection];
+			theAffectedRowCount = mysql_affected_rows(mySQLConnection);
+		}
+		else {
+			theErrorMessage = [self _stringForCString:mysql_error(mySQLConnection)];
+			theErrorID = mysql_errno(mySQLConnection);
+			// sqlstate is always an ASCII string, regardless of charset (but use latin1 anyway as that is less picky about invalid bytes)
+			theSqlstate = _stringForCStringWithEncoding(mysql_sqlstate(mySQLConnection), NSISOLatin1StringEncoding);
+		}
+
+		mysql_set_local_infile_default(mySQLConnection);
+	}
+
+	lastConnectionUsedTime = _monotonicTime();
+
+	// If the query was cancelled, override the error state
+	if (lastQueryWasCancelled) {
+		theErrorMessage = NSLocalizedString(@"Query cancelled.", @"Query cancelled error");
+		theErrorID = 1317;
+		theSqlstate = @"70100";
+	}
+
+	[self _unlockConnection];
+
+	// Update error string and ID, and the rows affected
+	[self _updateLastErrorMessage:theErrorMessage];
+	[self _updateLastErrorID:theErrorID];
+	[self _updateLastSqlstate:theSqlstate];
+	lastQueryAffectedRowCount = theAffectedRowCount;
+
+	return !theErrorID;
+}
+
+/**
+ * Prepare a statement with ? placeholders for its values, keeping it on the connection so that
+ * running it with -queryPreparedStatement:withValues:count:usingEncoding:assertingDatabaseContext:
+ * only sends the values, the server having parsed the statement once.  Statements are kept until
+ * -closePreparedStatements is called or the connection is lost.
+ * Returns whether the statement could be prepared; the last error describes any failure, for
+ * example from a server which can't prepare that statement.
+ */
+- (BOOL)prepareStatement:(NSString *)theQueryString usingEncoding:(NSStringEncoding)theEncoding assertingDatabaseContext:(NSString *)databaseName
+{
+	NSString *theErrorMessage = nil;
+	NSUInteger theErrorID = 0;
+	NSString *theSqlstate = nil;
+	lastQueryWasCancelled = NO;
+
+	if (userTriggeredDisconnect || state == SPMySQLDisconnected || state == SPMySQLConnecting) return NO;
+
+	// Ensure per-thread variables are set up
+	[self _validateThreadSetup];
+
+	if (![self checkConnectionIfNecessary]) return NO;
+
+	// Lock the connection while it's actively in use
+	[self _lockConnection];
+	if (!databaseAssertionState) {
+		databaseAssertionState = [[SADatabaseAssertionState alloc] init];
+	}
+
+	SADatabaseAssertionError *databaseAssertionError = [databaseAssertionState
+		assertDatabase:databaseName
+		required:YES
+		onMySQLConnection:mySQLConnection
+		errorStringEncodingValue:stringEncoding
+		stringEncodingProvider:^NSUInteger(NSString *characterSetName) {
+			return [SPMySQLConnection stringEncodingForMySQLCharset:[characterSetName UTF8String]];
+		}];
+
+	if (databaseAssertionError) {
+		theErrorID = databaseAssertionError.errorID;
+		theErrorMessage = databaseAssertionError.message;
+		theSqlstate = databaseAssertionError.sqlState;
+	}
+	else {
+		[self _preparedStatementForQuery:theQueryString usingEncoding:theEncoding errorID:&theErrorID errorMessage:&theErrorMessage sqlstate:&theSqlstate];
+	}
+
+	lastConnectionUsedTime = _monotonicTime();
+
+	[self _unlockConnection];
+
+	// Update error string and ID
+	[self _updateLastErrorMessage:theErrorMessage];
+	[self _updateLastErrorID:theErrorID];
+	[self _updateLastSqlstate:theSqlstate];
+
+	return !theErrorID;
+}
+
+/**
+ * Run a statement prepared with -prepareStatement:usingEncoding:assertingDatabaseContext:,
+ * preparing it first if it isn't already, with a value for each of its placeholders.  The values
+ * are bound as strings exactly as supplied, so they need no escaping or quoting, and are sent to
+ * the server in a single packet; like any query, they must fit within max_allowed_packet.
+ * Returns whether the statement succeeded; the last error describes any failure, and the rows
+ * inserted are available from -rowsAffectedByLastQuery.
+ */
+- (BOOL)queryPreparedStatement:(NSString *)theQueryString withValues:(const SPMySQLBoundValue *)theValues count:(NSUInteger)valueCount usingEncoding:(NSStringEncoding)theEncoding assertingDatabaseContext:(NSString *)databaseName
+{
+	NSString *theErrorMessage = nil;
+	NSUInteger theErrorID = 0;
+	NSString *theSqlstate = nil;
+	unsigned long long theAffectedRowCount = (unsigned long long)~0;
+	lastQueryWasCancelled = NO;
+
+	if (userTriggeredDisconnect || state == SPMySQLDisconnected || state == SPMySQLConnecting) return NO;
+
+	// Ensure per-thread variables are set up
+	[self _validateThreadSetup];
+
+	if (![self checkConnectionIfNecessary]) return NO;
+
+	// Determine whether a maximum query size needs to be restored from a previous query
+	if (queryActionShouldRestoreMaxQuerySize != NSNotFound) {
+		[self _restoreMaximumQuerySizeAfterQuery];
+	}
+
+	if (delegateQueryLogging && delegateSupportsWillQueryString) {
+		[delegate willQueryString:theQueryString connection:self];
+	}
+
+	// Lock the connection while it's actively in use
+	[self _lockConnection];
+	if (!databaseAssertionState) {
+		databaseAssertionState = [[SADatabaseAssertionState alloc] init];
+	}
+
+	SADatabaseAssertionError *databaseAssertionError = [databaseAssertionState
+		assertDatabase:databaseName
+		required:YES
+		onMySQLConnection:mySQLConnection
+		errorStringEncodingValue:stringEncoding
+		stringEncodingProvider:^NSUInteger(NSString *characterSetName) {
+			return [SPMySQLConnection stringEncodingForMySQLCharset:[characterSetName UTF8String]];
+		}];
+
+	if (databaseAssertionError) {
+		theErrorID = databaseAssertionError.errorID;
+		theErrorMessage = databaseAssertionError.message;
+		theSqlstate = databaseAssertionError.sqlState;
+	}
+	else {
+		MYSQL_STMT *statement = [self _preparedStatementForQuery:theQueryString usingEncoding:theEncoding errorID:&theErrorID errorMessage:&theErrorMessage sqlstate:&theSqlstate];
+
+		if (statement && mysql_stmt_param_count(statement) != valueCount) {
+			theErrorMessage = NSLocalizedString(@"The number of values does not match the number of placeholders in the statement.", @"Prepared statement value count mismatch error");
+			theErrorID = CR_INVALID_PARAMETER_NO;
+			theSqlstate = @"HY000";
+		}
+		else if (statement) {
+
+			// Strings are bound by pointer, so the values are only copied into the packet sent
+			MYSQL_BIND *parameters = calloc(MAX(valueCount, 1), sizeof(MYSQL_BIND));
+
+			for (NSUInteger i = 0; i < valueCount; i++) {
+				if (theValues[i].bytes) {
+					parameters[i].buffer_type = MYSQL_TYPE_STRING;
+					parameters[i].buffer = (void *)theValues[i].bytes;
+					parameters[i].buffer_length = (unsigned long)theValues[i].length;
+				}
+				else {
+					parameters[i].buffer_type = MYSQL_TYPE_NULL;
+				}
+			}
+
+			if (!mysql_stmt_bind_param(statement, parameters) && !mysql_stmt_execute(statement)) {
+				[databaseAssertionState recordSuccessfulQuery:theQueryString onMySQLConnection:mySQLConnection];
+				theAffectedRowCount = mysql_stmt_affected_rows(statement);
+
+				if (mysql_stmt_insert_id(statement)) {
+					lastQueryInsertID = mysql_stmt_insert_id(statement);
+				}
+			}
+			else {
+				theErrorMessage = [self _stringForCString:mysql_stmt_error(statement)];
+				theErrorID = mysql_stmt_errno(statement);
+				// sqlstate is always an ASCII string, regardless of charset (but use latin1 anyway as that is less picky about invalid bytes)
+				theSqlstate = _stringForCStringWithEncoding(mysql_stmt_sqlstate(statement), NSISOLatin1StringEncoding);
+			}
+
+			free(parameters);
+		}
+	}
+
+	lastConnectionUsedTime = _monotonicTime();
+
+	// If the query was cancelled, override the error state
+	if (lastQueryWasCancelled) {
+		theErrorMessage = NSLocalizedString(@"Query cancelled.", @"Query cancelled error");
+		theErrorID = 1317;
+		theSqlstate = @"70100";
+	}
+
+	[self _unlockConnection];
+
+	// Update error string and ID, and the rows affected
+	[self _updateLastErrorMessage:theErrorMessage];
+	[self _updateLastErrorID:theErrorID];
+	[self _updateLastSqlstate:theSqlstate];
+	lastQueryAffectedRowCount = theAffectedRowCount;
+
+	return !theErrorID;
+}
+
+/**
+ * Close the statement prepared for a query, if there is one, freeing it on the server.  Other
+ * statements prepared on the connection are left as they are.
+ */
+- (void)closePreparedStatement:(NSString *)theQueryString
+{
+	[self _lockConnection];
+
+	NSValue *preparedStatement = [preparedStatements objectForKey:theQueryString];
+
+	if (preparedStatement) {
+		MYSQL_STMT *statement = (MYSQL_STMT *)[preparedStatement pointerValue];
+
+		// Without a connection only free the statement, as for -closePreparedStatements
+		if (!mySQLConnection) statement->mysql = NULL;
+
+		mysql_stmt_close(statement);
+		[preparedStatements removeObjectForKey:theQueryString];
+	}
+
+	[self _unlockConnection];
+}
+
+/**
+ * Close any statements prepared on the connection, freeing them on the server.
+ */
+- (void)closePreparedStatements
+{
+	[self _lockConnection];
+	[self _discardPreparedStatementsClosingThem:(mySQLConnection != NULL)];
+	[self _unlockConnection];
+}
+
+/**
+ * Returns the statement prepared for a query, preparing it if it hasn't been already; must be
+ * called with the connection locked.  If it can't be prepared, the error is returned by reference.
+ */
+- (MYSQL_STMT *)_preparedStatementForQuery:(NSString *)theQueryString usingEncoding:(NSStringEncoding)theEncoding errorID:(NSUInteger *)theErrorID errorMessage:(NSString **)theErrorMessage sqlstate:(NSString **)theSqlstate
+{
+	NSValue *preparedStatement = [preparedStatements objectForKey:theQueryString];
+
+	if (preparedStatement) return (MYSQL_STMT *)[preparedStatement pointerValue];
+
+	// Only keep a handful of statements on the server
+	if ([preparedStatements count] >= SPMySQLMaxPreparedStatements) {
+		[self _discardPreparedStatementsClosingThem:YES];
+	}
+
+	MYSQL_STMT *statement = mysql_stmt_init(mySQLConnection);
+
+	if (!statement) {
+		*theErrorMessage = [self _stringForCString:mysql_error(mySQLConnection)];
+		*theErrorID = mysql_errno(mySQLConnection);
+		*theSqlstate = _stringForCStringWithEncoding(mysql_sqlstate(mySQLConnection), NSISOLatin1StringEncoding);
+
+		return NULL;
+	}
+
+	NSData *queryData = [theQueryString dataUsingEncoding:theEncoding allowLossyConversion:YES];
+
+	if (mysql_stmt_prepare(statement, [queryData bytes], [queryData length])) {
+		*theErrorMessage = [self _stringForCString:mysql_stmt_error(statement)];
+		*theErrorID = mysql_stmt_errno(statement);
+		*theSqlstate = _stringForCStringWithEncoding(mysql_stmt_sqlstate(statement), NSISOLatin1StringEncoding);
+
+		mysql_stmt_close(statement);
+
+		return NULL;
+	}
+
+	[preparedStatements setObject:[NSValue valueWithPointer:statement] forKey:theQueryString];
+
+	return statement;
+}
+
 #pragma mark -
 #pragma mark Query convenience functions
 
@@ -768,6 +1276,24 @@ databaseContextIsRequired:(BOOL)databaseContextIsRequired
 	}
 }
 
+/**
+ * Free the statements prepared on the connection, also closing them on the server if the
+ * connection is still usable; must be called with the connection locked.  Otherwise the
+ * statements are detached from the connection first, so freeing them doesn't touch it.
+ */
+- (void)_discardPreparedStatementsClosingThem:(BOOL)closeStatements
+{
+	for (NSValue *eachStatement in [preparedStatements objectEnumerator]) {
+		MYSQL_STMT *statement = (MYSQL_STMT *)[eachStatement pointerValue];
+
+		if (!closeStatements) statement->mysql = NULL;
+
+		mysql_stmt_close(statement);
+	}
+
+	[preparedStatements removeAllObjects];
+}
+
 /**
  * Update lastErrorID, lastErrorMessage and lastSqlstate from connection
  */
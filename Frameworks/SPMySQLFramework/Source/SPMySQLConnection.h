@@ -135,6 +135,9 @@
 
 	// Queries
 	BOOL retryQueriesOnConnectionFailure;
+
+	// Prepared statements, by query, on the current connection
+	NSMutableDictionary *preparedStatements;
 	
 	SPMySQLClientFlags clientFlags;
 	
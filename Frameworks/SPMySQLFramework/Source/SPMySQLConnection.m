@@ -408,6 +408,8 @@ const SPMySQLClientFlags SPMySQLConnectionOptions =
 		// while running them
 		retryQueriesOnConnectionFailure = YES;
 
+		preparedStatements = [[NSMutableDictionary alloc] init];
+
 		_debugLastConnectedEvent = nil;
 
 		// Start the ping keepalive timer
@@ -761,6 +763,9 @@ asm(".desc ___crashreporter_info__, 0x10");
 	// Lock the connection for safety
 	[self _lockConnection];
 
+	// Statements prepared on any previous connection can't be used on the new one
+	[self _discardPreparedStatementsClosingThem:NO];
+
 	// Attempt the connection
 	mySQLConnection = [self _makeRawMySQLConnectionWithEncoding:encoding isMasterConnection:YES];
 
@@ -1320,8 +1325,14 @@ asm(".desc ___crashreporter_info__, 0x10");
 {
     SPLog(@"_disconnect");
 
-	// If state is connection lost, set state directly to disconnected.
+	// If state is connection lost, set state directly to disconnected, forgetting the statements
+	// prepared on the lost connection unless it's busy; they are forgotten on reconnecting anyway
 	if (state == SPMySQLConnectionLostInBackground) {
+		if ([self _tryLockConnection]) {
+			[self _discardPreparedStatementsClosingThem:NO];
+			[self _unlockConnection];
+		}
+
 		state = SPMySQLDisconnected;
 	}
 
@@ -1354,8 +1365,10 @@ asm(".desc ___crashreporter_info__, 0x10");
 	if (mySQLConnection && !mySQLConnection->net.reading_or_writing && mySQLConnection->net.vio && mySQLConnection->net.buff) {
         SPLog(@"calling mysql_close(mySQLConnection)");
 
+		[self _discardPreparedStatementsClosingThem:YES];
 		mysql_close(mySQLConnection);
 	}
+	[self _discardPreparedStatementsClosingThem:NO];
 	mySQLConnection = NULL;
 	serverVersionNumber = 0;
 	state = SPMySQLDisconnected;
@@ -44,6 +44,7 @@
 - (NSUInteger)length;
 - (NSData *)data;
 - (NSString *)wktString;
+- (NSString *)geoJSONString;
 - (NSDictionary *)coordinates;
 - (NSInteger)wkbType;
 - (NSString *)wktType;
@@ -56,6 +56,7 @@ typedef struct st_point_2d_
 
 static bool should_swap_order(int32_t srid, NSUInteger version);
 static void order_aware_memcpy(st_point_2d *pt, const void *src, bool needsSwap);
+static BOOL append_geojson_geometry(NSMutableString *json, const Byte *buffer, NSUInteger length, NSUInteger *ptr, bool needsSwap);
 
 @implementation SPMySQLGeometryData
 
@@ -740,6 +741,27 @@ static void order_aware_memcpy(st_point_2d *pt, const void *src, bool needsSwap)
 	return nil;
 }
 
+/**
+ * Return a GeoJSON geometry object (RFC 7946) of the internal format, eg. {"type":"Point","coordinates":[1,2]}.
+ * GeoJSON has no notion of a SRID, so it is omitted. Returns nil if the buffer can't be parsed.
+ */
+- (NSString *)geoJSONString
+{
+	int32_t srid;
+	NSUInteger ptr = BUFFER_START;
+
+	NSMutableString *json = [NSMutableString string];
+
+	if (bufferLength < SIZEOF_STORED_UINT32 + WKB_HEADER_SIZE) return nil;
+
+	memcpy(&srid, &geoBuffer[0], SIZEOF_STORED_UINT32);
+	ptr += SIZEOF_STORED_UINT32;
+
+	if (!append_geojson_geometry(json, geoBuffer, bufferLength, &ptr, should_swap_order(srid, serverMajorVersion))) return nil;
+
+	return json;
+}
+
 /**
  * Return the WKB type of the geoBuffer ie if buffer represents a POINT, LINESTRING, etc.
  * according to stored wkbType in header file. It returns -1 if an error occurred.
@@ -831,3 +853,132 @@ static void order_aware_memcpy(st_point_2d *pt, const void *src, bool needsSwap)
   }
 }
 
+
+// Reads a little endian uint32 at *ptr, advancing it. Returns NO if the buffer is too short.
+static BOOL read_geojson_uint32(const Byte *buffer, NSUInteger length, NSUInteger *ptr, uint32_t *value) {
+  if (*ptr + SIZEOF_STORED_UINT32 > length) return NO;
+
+  memcpy(value, &buffer[*ptr], SIZEOF_STORED_UINT32);
+  *ptr += SIZEOF_STORED_UINT32;
+
+  return YES;
+}
+
+// Appends a position, ie. [x,y], for the point at *ptr.
+static BOOL append_geojson_position(NSMutableString *json, const Byte *buffer, NSUInteger length, NSUInteger *ptr, bool needsSwap) {
+  st_point_2d aPoint;
+
+  if (*ptr + POINT_DATA_SIZE > length) return NO;
+
+  order_aware_memcpy(&aPoint, &buffer[*ptr], needsSwap);
+  *ptr += POINT_DATA_SIZE;
+
+  [json appendFormat:@"[%.17g,%.17g]", aPoint.x, aPoint.y];
+
+  return YES;
+}
+
+// Appends an array of positions, preceded in the buffer by their count, as found in line strings and polygon rings.
+static BOOL append_geojson_positions(NSMutableString *json, const Byte *buffer, NSUInteger length, NSUInteger *ptr, bool needsSwap) {
+  uint32_t i, numberOfPoints;
+
+  if (!read_geojson_uint32(buffer, length, ptr, &numberOfPoints)) return NO;
+
+  [json appendString:@"["];
+
+  for (i = 0; i < numberOfPoints; i++) {
+    if (i) [json appendString:@","];
+    if (!append_geojson_position(json, buffer, length, ptr, needsSwap)) return NO;
+  }
+
+  [json appendString:@"]"];
+
+  return YES;
+}
+
+// Reads a WKB header at *ptr, returning the geometry type. Only little endian (NDR) WKB, as sent by MySQL, is supported.
+static BOOL read_geojson_header(const Byte *buffer, NSUInteger length, NSUInteger *ptr, uint32_t *geoType) {
+  if (*ptr + WKB_HEADER_SIZE > length || buffer[*ptr] != 0x1) return NO;
+
+  (*ptr)++;
+
+  return read_geojson_uint32(buffer, length, ptr, geoType);
+}
+
+// Appends the "coordinates" member value of a non-collection geometry of the supplied type.
+static BOOL append_geojson_coordinates(NSMutableString *json, const Byte *buffer, NSUInteger length, NSUInteger *ptr, uint32_t geoType, bool needsSwap) {
+  uint32_t i, numberOfItems, itemType;
+
+  switch (geoType) {
+    case wkb_point:
+      return append_geojson_position(json, buffer, length, ptr, needsSwap);
+
+    case wkb_linestring:
+      return append_geojson_positions(json, buffer, length, ptr, needsSwap);
+
+    case wkb_polygon:
+      if (!read_geojson_uint32(buffer, length, ptr, &numberOfItems)) return NO;
+
+      [json appendString:@"["];
+
+      for (i = 0; i < numberOfItems; i++) {
+        if (i) [json appendString:@","];
+        if (!append_geojson_positions(json, buffer, length, ptr, needsSwap)) return NO;
+      }
+
+      [json appendString:@"]"];
+
+      return YES;
+
+    case wkb_multipoint:
+    case wkb_multilinestring:
+    case wkb_multipolygon:
+      if (!read_geojson_uint32(buffer, length, ptr, &numberOfItems)) return NO;
+
+      [json appendString:@"["];
+
+      // Each item is a complete WKB geometry of the corresponding single type
+      for (i = 0; i < numberOfItems; i++) {
+        if (i) [json appendString:@","];
+        if (!read_geojson_header(buffer, length, ptr, &itemType) || itemType != geoType - 3) return NO;
+        if (!append_geojson_coordinates(json, buffer, length, ptr, itemType, needsSwap)) return NO;
+      }
+
+      [json appendString:@"]"];
+
+      return YES;
+  }
+
+  return NO;
+}
+
+// Appends the GeoJSON geometry object of the WKB geometry at *ptr, recursing into geometry collections.
+static BOOL append_geojson_geometry(NSMutableString *json, const Byte *buffer, NSUInteger length, NSUInteger *ptr, bool needsSwap) {
+  static NSString *GEOJSON_TYPES[8] = { nil, @"Point", @"LineString", @"Polygon", @"MultiPoint", @"MultiLineString", @"MultiPolygon", @"GeometryCollection" };
+
+  uint32_t i, geoType, numberOfItems;
+
+  if (!read_geojson_header(buffer, length, ptr, &geoType) || geoType < wkb_point || geoType > wkb_geometrycollection) return NO;
+
+  [json appendFormat:@"{\"type\":\"%@\",", GEOJSON_TYPES[geoType]];
+
+  if (geoType == wkb_geometrycollection) {
+    if (!read_geojson_uint32(buffer, length, ptr, &numberOfItems)) return NO;
+
+    [json appendString:@"\"geometries\":["];
+
+    for (i = 0; i < numberOfItems; i++) {
+      if (i) [json appendString:@","];
+      if (!append_geojson_geometry(json, buffer, length, ptr, needsSwap)) return NO;
+    }
+  }
+  else {
+    [json appendString:@"\"coordinates\":"];
+
+    if (!append_geojson_coordinates(json, buffer, length, ptr, geoType, needsSwap)) return NO;
+  }
+
+  [json appendString:(geoType == wkb_geometrycollection) ? @"]}" : @"}"];
+
+  return YES;
+}
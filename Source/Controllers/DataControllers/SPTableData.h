@@ -76,6 +76,7 @@
 - (void) resetColumnData;
 - (BOOL) updateInformationForCurrentTable;
 - (NSDictionary *) informationForTable:(NSString *)tableName fromDatabase:(NSString *)database;
+- (NSDictionary *) informationForTable:(NSString *)tableName fromCreateSyntax:(NSString *)createSyntax ofType:(NSString *)tableType;
 - (BOOL) updateInformationForCurrentView;
 - (NSDictionary *) informationForView:(NSString *)viewName;
 - (NSDictionary *) informationForView:(NSString *)viewName fromDatabase:(NSString *)database;
@@ -639,6 +639,23 @@
     return tableData;
 }
 
+/**
+ * Extract table structure information from a CREATE statement which has already been retrieved, e.g. by
+ * an export, without querying the server again.
+ * @param tableName The table or view name.
+ * @param createSyntax The CREATE TABLE or CREATE VIEW syntax.
+ * @param tableType Either "Table" or "View", as named by the first field of the SHOW CREATE result.
+ */
+- (NSDictionary *) informationForTable:(NSString *)tableName fromCreateSyntax:(NSString *)createSyntax ofType:(NSString *)tableType
+{
+    if (![tableName length] || ![createSyntax isKindOfClass:[NSString class]]) return nil;
+
+    // As with -informationForTable:fromDatabase:, clear the previous call's constraints
+    [constraints removeAllObjects];
+
+    return [self parseCreateStatement:createSyntax ofType:tableType];
+}
+
 - (NSArray *)createTableSyntaxFromView:(NSString *)tableName withSyntaxResult:(NSArray *)syntaxResult
 {
     NSString *databaseName = [tableListInstance selectedDatabase];
@@ -0,0 +1,50 @@
+//
+//  SPArrowExporter.h
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPColumnarExporter.h"
+
+/**
+ * @class SPArrowExporter SPArrowExporter.h
+ *
+ * Apache Arrow IPC streaming format exporter.
+ *
+ * The output starts with a Schema message, followed by a RecordBatch message per batch of rows and an
+ * end-of-stream marker. String columns with a low number of distinct values in the first batch (and
+ * always ENUM and SET columns) are dictionary encoded; each of their record batches is preceded by a
+ * DictionaryBatch message replacing the previous batch's dictionary, so memory use stays bounded.
+ */
+@interface SPArrowExporter : SPColumnarExporter
+{
+	BOOL schemaWritten;
+
+	NSMutableIndexSet *dictionaryEncodedColumns;
+}
+
+@end
@@ -0,0 +1,620 @@
+//
+//  SPArrowExporter.m
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPArrowExporter.h"
+#import "SPColumnarColumn.h"
+
+#pragma mark FlatBuffers
+
+// The Arrow IPC metadata is serialised as FlatBuffers. Only the small subset of the FlatBuffers builder
+// needed to write Arrow's Message, Schema, RecordBatch and DictionaryBatch tables is implemented here.
+// As with the reference builder, the buffer is filled back to front so that children are always
+// serialised before, and therefore located after, the objects referencing them.
+
+#define SPFlatBufferMaximumFields 8
+
+typedef size_t SPFlatBufferOffset;
+
+typedef struct {
+	uint8_t *buffer;
+	size_t capacity;
+	size_t used;
+	size_t minimumAlignment;
+	size_t fields[SPFlatBufferMaximumFields];
+	int fieldCount;
+	size_t tableStart;
+} SPFlatBufferBuilder;
+
+static void SPFlatBufferInit(SPFlatBufferBuilder *builder)
+{
+	memset(builder, 0, sizeof(SPFlatBufferBuilder));
+
+	builder->capacity = 1024;
+	builder->buffer = malloc(builder->capacity);
+	builder->minimumAlignment = 1;
+}
+
+static void SPFlatBufferFree(SPFlatBufferBuilder *builder)
+{
+	free(builder->buffer);
+
+	builder->buffer = NULL;
+}
+
+static void SPFlatBufferReserve(SPFlatBufferBuilder *builder, size_t length)
+{
+	if (builder->capacity - builder->used >= length) return;
+
+	size_t capacity = MAX(builder->capacity * 2, builder->used + length);
+	uint8_t *buffer = malloc(capacity);
+
+	memcpy(buffer + capacity - builder->used, builder->buffer + builder->capacity - builder->used, builder->used);
+	free(builder->buffer);
+
+	builder->buffer = buffer;
+	builder->capacity = capacity;
+}
+
+static void SPFlatBufferPush(SPFlatBufferBuilder *builder, const void *bytes, size_t length)
+{
+	SPFlatBufferReserve(builder, length);
+
+	builder->used += length;
+
+	memcpy(builder->buffer + builder->capacity - builder->used, bytes, length);
+}
+
+static void SPFlatBufferPad(SPFlatBufferBuilder *builder, size_t length)
+{
+	SPFlatBufferReserve(builder, length);
+
+	builder->used += length;
+
+	memset(builder->buffer + builder->capacity - builder->used, 0, length);
+}
+
+/**
+ * Pads the buffer so that it is aligned to alignment once additional bytes have been pushed.
+ */
+static void SPFlatBufferPrepare(SPFlatBufferBuilder *builder, size_t alignment, size_t additional)
+{
+	if (alignment > builder->minimumAlignment) builder->minimumAlignment = alignment;
+
+	SPFlatBufferPad(builder, (~(builder->used + additional) + 1) & (alignment - 1));
+}
+
+static void SPFlatBufferStartTable(SPFlatBufferBuilder *builder)
+{
+	memset(builder->fields, 0, sizeof(builder->fields));
+
+	builder->fieldCount = 0;
+	builder->tableStart = builder->used;
+}
+
+static void SPFlatBufferAddScalar(SPFlatBufferBuilder *builder, int slot, const void *value, size_t size)
+{
+	SPFlatBufferPrepare(builder, size, 0);
+	SPFlatBufferPush(builder, value, size);
+
+	builder->fields[slot] = builder->used;
+	builder->fieldCount = MAX(builder->fieldCount, slot + 1);
+}
+
+static void SPFlatBufferAddUInt8(SPFlatBufferBuilder *builder, int slot, uint8_t value)
+{
+	SPFlatBufferAddScalar(builder, slot, &value, sizeof(value));
+}
+
+static void SPFlatBufferAddInt16(SPFlatBufferBuilder *builder, int slot, int16_t value)
+{
+	uint16_t littleEndian = CFSwapInt16HostToLittle((uint16_t)value);
+
+	SPFlatBufferAddScalar(builder, slot, &littleEndian, sizeof(littleEndian));
+}
+
+static void SPFlatBufferAddInt32(SPFlatBufferBuilder *builder, int slot, int32_t value)
+{
+	uint32_t littleEndian = CFSwapInt32HostToLittle((uint32_t)value);
+
+	SPFlatBufferAddScalar(builder, slot, &littleEndian, sizeof(littleEndian));
+}
+
+static void SPFlatBufferAddInt64(SPFlatBufferBuilder *builder, int slot, int64_t value)
+{
+	uint64_t littleEndian = CFSwapInt64HostToLittle((uint64_t)value);
+
+	SPFlatBufferAddScalar(builder, slot, &littleEndian, sizeof(littleEndian));
+}
+
+static void SPFlatBufferPushOffset(SPFlatBufferBuilder *builder, SPFlatBufferOffset offset)
+{
+	SPFlatBufferPrepare(builder, sizeof(uint32_t), 0);
+
+	// Offsets are relative to the location they are stored at
+	uint32_t relative = CFSwapInt32HostToLittle((uint32_t)(builder->used - offset + sizeof(uint32_t)));
+
+	SPFlatBufferPush(builder, &relative, sizeof(relative));
+}
+
+static void SPFlatBufferAddOffset(SPFlatBufferBuilder *builder, int slot, SPFlatBufferOffset offset)
+{
+	SPFlatBufferPushOffset(builder, offset);
+
+	builder->fields[slot] = builder->used;
+	builder->fieldCount = MAX(builder->fieldCount, slot + 1);
+}
+
+static SPFlatBufferOffset SPFlatBufferEndTable(SPFlatBufferBuilder *builder)
+{
+	int32_t vtableOffset = 0;
+
+	// Placeholder for the offset to the table's vtable
+	SPFlatBufferPrepare(builder, sizeof(int32_t), 0);
+	SPFlatBufferPush(builder, &vtableOffset, sizeof(vtableOffset));
+
+	SPFlatBufferOffset table = builder->used;
+
+	// The vtable holds the size of the vtable and table followed by the position of each field within the table
+	for (int slot = builder->fieldCount - 1; slot >= 0; slot--)
+	{
+		uint16_t position = CFSwapInt16HostToLittle((uint16_t)(builder->fields[slot] ? (table - builder->fields[slot]) : 0));
+
+		SPFlatBufferPush(builder, &position, sizeof(position));
+	}
+
+	uint16_t tableSize = CFSwapInt16HostToLittle((uint16_t)(table - builder->tableStart));
+	uint16_t vtableSize = CFSwapInt16HostToLittle((uint16_t)(sizeof(uint16_t) * (2 + builder->fieldCount)));
+
+	SPFlatBufferPush(builder, &tableSize, sizeof(tableSize));
+	SPFlatBufferPush(builder, &vtableSize, sizeof(vtableSize));
+
+	vtableOffset = (int32_t)CFSwapInt32HostToLittle((uint32_t)(builder->used - table));
+
+	memcpy(builder->buffer + builder->capacity - table, &vtableOffset, sizeof(vtableOffset));
+
+	return table;
+}
+
+static SPFlatBufferOffset SPFlatBufferCreateString(SPFlatBufferBuilder *builder, NSString *string)
+{
+	const char *bytes = [string UTF8String] ?: "";
+	size_t length = strlen(bytes);
+	uint32_t littleEndianLength = CFSwapInt32HostToLittle((uint32_t)length);
+
+	// Strings are zero terminated and prefixed with their length
+	SPFlatBufferPrepare(builder, sizeof(uint32_t), length + 1);
+	SPFlatBufferPad(builder, 1);
+	SPFlatBufferPush(builder, bytes, length);
+	SPFlatBufferPush(builder, &littleEndianLength, sizeof(littleEndianLength));
+
+	return builder->used;
+}
+
+static void SPFlatBufferStartVector(SPFlatBufferBuilder *builder, size_t elementSize, size_t count, size_t alignment)
+{
+	SPFlatBufferPrepare(builder, sizeof(uint32_t), elementSize * count);
+	SPFlatBufferPrepare(builder, alignment, elementSize * count);
+}
+
+static SPFlatBufferOffset SPFlatBufferEndVector(SPFlatBufferBuilder *builder, size_t count)
+{
+	uint32_t littleEndianCount = CFSwapInt32HostToLittle((uint32_t)count);
+
+	SPFlatBufferPrepare(builder, sizeof(uint32_t), 0);
+	SPFlatBufferPush(builder, &littleEndianCount, sizeof(littleEndianCount));
+
+	return builder->used;
+}
+
+static SPFlatBufferOffset SPFlatBufferCreateOffsetVector(SPFlatBufferBuilder *builder, const SPFlatBufferOffset *offsets, size_t count)
+{
+	SPFlatBufferStartVector(builder, sizeof(uint32_t), count, sizeof(uint32_t));
+
+	for (size_t i = count; i > 0; i--)
+	{
+		SPFlatBufferPushOffset(builder, offsets[i - 1]);
+	}
+
+	return SPFlatBufferEndVector(builder, count);
+}
+
+/**
+ * Creates a vector of pairs of 64 bit integers, the layout of both Arrow's FieldNode and Buffer structs.
+ */
+static SPFlatBufferOffset SPFlatBufferCreateInt64PairVector(SPFlatBufferBuilder *builder, NSData *pairs)
+{
+	size_t count = [pairs length] / (2 * sizeof(int64_t));
+	const int64_t *values = [pairs bytes];
+
+	SPFlatBufferStartVector(builder, 2 * sizeof(int64_t), count, sizeof(int64_t));
+
+	for (size_t i = count; i > 0; i--)
+	{
+		uint64_t pair[2] = { CFSwapInt64HostToLittle((uint64_t)values[(i - 1) * 2]), CFSwapInt64HostToLittle((uint64_t)values[((i - 1) * 2) + 1]) };
+
+		SPFlatBufferPush(builder, pair, sizeof(pair));
+	}
+
+	return SPFlatBufferEndVector(builder, count);
+}
+
+static NSData *SPFlatBufferFinish(SPFlatBufferBuilder *builder, SPFlatBufferOffset root)
+{
+	SPFlatBufferPrepare(builder, builder->minimumAlignment, sizeof(uint32_t));
+	SPFlatBufferPushOffset(builder, root);
+
+	return [NSData dataWithBytes:(builder->buffer + builder->capacity - builder->used) length:builder->used];
+}
+
+#pragma mark - Arrow
+
+// Message.fbs MetadataVersion
+static const int16_t SPArrowMetadataVersionV5 = 4;
+
+// Message.fbs MessageHeader union
+static const uint8_t SPArrowMessageHeaderSchema          = 1;
+static const uint8_t SPArrowMessageHeaderDictionaryBatch = 2;
+static const uint8_t SPArrowMessageHeaderRecordBatch     = 3;
+
+// Schema.fbs Type union
+static const uint8_t SPArrowTypeInt           = 2;
+static const uint8_t SPArrowTypeFloatingPoint = 3;
+static const uint8_t SPArrowTypeBinary        = 4;
+static const uint8_t SPArrowTypeUtf8          = 5;
+static const uint8_t SPArrowTypeDecimal       = 7;
+static const uint8_t SPArrowTypeDate          = 8;
+static const uint8_t SPArrowTypeTimestamp     = 10;
+
+// Schema.fbs Precision, DateUnit and TimeUnit enums
+static const int16_t SPArrowPrecisionSingle = 1;
+static const int16_t SPArrowPrecisionDouble = 2;
+static const int16_t SPArrowDateUnitDay = 0;
+static const int16_t SPArrowTimeUnitMicrosecond = 2;
+
+static const uint32_t SPArrowContinuationMarker = 0xFFFFFFFF;
+
+static void SPArrowAppendBuffer(NSMutableData *body, NSMutableData *buffers, const void *bytes, NSUInteger length);
+static SPFlatBufferOffset SPArrowCreateIntType(SPFlatBufferBuilder *builder, int32_t bitWidth, BOOL isSigned);
+
+@interface SPArrowExporter ()
+
+- (SPFlatBufferOffset)_createTypeForColumn:(SPColumnarColumn *)column builder:(SPFlatBufferBuilder *)builder typeType:(uint8_t *)typeType;
+- (SPFlatBufferOffset)_createRecordBatchWithLength:(NSUInteger)length nodes:(NSData *)nodes buffers:(NSData *)buffers builder:(SPFlatBufferBuilder *)builder;
+- (void)_writeSchemaForColumns:(NSArray *)columns;
+- (void)_writeDictionaryBatchForColumn:(SPColumnarColumn *)column withIdentifier:(NSUInteger)identifier;
+- (void)_writeRecordBatchForColumns:(NSArray *)columns rowCount:(NSUInteger)rowCount;
+- (void)_writeMessageWithHeader:(SPFlatBufferOffset)header ofType:(uint8_t)headerType body:(NSData *)body builder:(SPFlatBufferBuilder *)builder;
+
+@end
+
+@implementation SPArrowExporter
+
+- (instancetype)initWithDelegate:(NSObject *)exportDelegate
+{
+	if ((self = [super initWithDelegate:exportDelegate])) {
+		schemaWritten = NO;
+		dictionaryEncodedColumns = [[NSMutableIndexSet alloc] init];
+	}
+
+	return self;
+}
+
+#pragma mark -
+#pragma mark Columnar exporter
+
+- (void)writeBatchForColumns:(NSArray<SPColumnarColumn *> *)columns rowCount:(NSUInteger)rowCount
+{
+	// The schema fixes which columns are dictionary encoded, so decide based on the first batch
+	if (!schemaWritten) {
+		if ([self columnarOutputDictionaryEncoding]) {
+			[columns enumerateObjectsUsingBlock:^(SPColumnarColumn *column, NSUInteger idx, BOOL *stop) {
+				if ([column type] != SPColumnarStringType) return;
+
+				if ([column prefersDictionaryEncoding] || [column buildDictionaryWithMaximumLength:[self dictionaryLengthLimitForRowCount:rowCount]]) {
+					[self->dictionaryEncodedColumns addIndex:idx];
+				}
+			}];
+		}
+
+		[self _writeSchemaForColumns:columns];
+	}
+
+	// Each batch's dictionaries replace the previous ones, so only one batch of values is held at a time
+	[dictionaryEncodedColumns enumerateIndexesUsingBlock:^(NSUInteger idx, BOOL *stop) {
+		SPColumnarColumn *column = [columns objectAtIndex:idx];
+
+		if (![column dictionaryIndices]) [column buildDictionaryWithMaximumLength:NSUIntegerMax];
+
+		[self _writeDictionaryBatchForColumn:column withIdentifier:idx];
+	}];
+
+	[self _writeRecordBatchForColumns:columns rowCount:rowCount];
+}
+
+- (void)finishWritingForColumns:(NSArray<SPColumnarColumn *> *)columns
+{
+	// An empty result set still gets a schema
+	if (!schemaWritten) [self _writeSchemaForColumns:columns];
+
+	uint32_t endOfStream[2] = { SPArrowContinuationMarker, 0 };
+
+	[self writeColumnarData:[NSData dataWithBytes:endOfStream length:sizeof(endOfStream)]];
+}
+
+#pragma mark -
+#pragma mark Private API
+
+/**
+ * Creates the Schema.fbs Type table describing the values of the supplied column.
+ */
+- (SPFlatBufferOffset)_createTypeForColumn:(SPColumnarColumn *)column builder:(SPFlatBufferBuilder *)builder typeType:(uint8_t *)typeType
+{
+	switch ([column type])
+	{
+		case SPColumnarInt8Type:
+		case SPColumnarInt16Type:
+		case SPColumnarInt32Type:
+		case SPColumnarInt64Type:
+			*typeType = SPArrowTypeInt;
+			return SPArrowCreateIntType(builder, (int32_t)([column valueByteWidth] * 8), YES);
+		case SPColumnarUInt8Type:
+		case SPColumnarUInt16Type:
+		case SPColumnarUInt32Type:
+		case SPColumnarUInt64Type:
+			*typeType = SPArrowTypeInt;
+			return SPArrowCreateIntType(builder, (int32_t)([column valueByteWidth] * 8), NO);
+		case SPColumnarFloatType:
+		case SPColumnarDoubleType:
+			*typeType = SPArrowTypeFloatingPoint;
+			SPFlatBufferStartTable(builder);
+			SPFlatBufferAddInt16(builder, 0, ([column type] == SPColumnarFloatType) ? SPArrowPrecisionSingle : SPArrowPrecisionDouble);
+			return SPFlatBufferEndTable(builder);
+		case SPColumnarDecimalType:
+			*typeType = SPArrowTypeDecimal;
+			SPFlatBufferStartTable(builder);
+			SPFlatBufferAddInt32(builder, 0, (int32_t)[column precision]);
+			SPFlatBufferAddInt32(builder, 1, (int32_t)[column scale]);
+			SPFlatBufferAddInt32(builder, 2, 128);
+			return SPFlatBufferEndTable(builder);
+		case SPColumnarDateType:
+			*typeType = SPArrowTypeDate;
+			SPFlatBufferStartTable(builder);
+			SPFlatBufferAddInt16(builder, 0, SPArrowDateUnitDay);
+			return SPFlatBufferEndTable(builder);
+		case SPColumnarTimestampType:
+			*typeType = SPArrowTypeTimestamp;
+			SPFlatBufferStartTable(builder);
+			SPFlatBufferAddInt16(builder, 0, SPArrowTimeUnitMicrosecond);
+			return SPFlatBufferEndTable(builder);
+		case SPColumnarStringType:
+		case SPColumnarBinaryType:
+			*typeType = ([column type] == SPColumnarStringType) ? SPArrowTypeUtf8 : SPArrowTypeBinary;
+			SPFlatBufferStartTable(builder);
+			return SPFlatBufferEndTable(builder);
+	}
+
+	return 0;
+}
+
+/**
+ * Creates a Message.fbs RecordBatch table.
+ */
+- (SPFlatBufferOffset)_createRecordBatchWithLength:(NSUInteger)length nodes:(NSData *)nodes buffers:(NSData *)buffers builder:(SPFlatBufferBuilder *)builder
+{
+	SPFlatBufferOffset nodesVector = SPFlatBufferCreateInt64PairVector(builder, nodes);
+	SPFlatBufferOffset buffersVector = SPFlatBufferCreateInt64PairVector(builder, buffers);
+
+	SPFlatBufferStartTable(builder);
+	SPFlatBufferAddInt64(builder, 0, (int64_t)length);
+	SPFlatBufferAddOffset(builder, 1, nodesVector);
+	SPFlatBufferAddOffset(builder, 2, buffersVector);
+
+	return SPFlatBufferEndTable(builder);
+}
+
+- (void)_writeSchemaForColumns:(NSArray *)columns
+{
+	SPFlatBufferBuilder builder;
+	SPFlatBufferInit(&builder);
+
+	SPFlatBufferOffset *fields = calloc(MAX(1, [columns count]), sizeof(SPFlatBufferOffset));
+
+	for (NSUInteger i = 0; i < [columns count]; i++)
+	{
+		SPColumnarColumn *column = [columns objectAtIndex:i];
+		SPFlatBufferOffset dictionary = 0;
+		uint8_t typeType = 0;
+
+		SPFlatBufferOffset name = SPFlatBufferCreateString(&builder, [column name]);
+		SPFlatBufferOffset type = [self _createTypeForColumn:column builder:&builder typeType:&typeType];
+
+		// Dictionary encoded fields keep their value type, with the dictionary's id and index type alongside
+		if ([dictionaryEncodedColumns containsIndex:i]) {
+			SPFlatBufferOffset indexType = SPArrowCreateIntType(&builder, 32, YES);
+
+			SPFlatBufferStartTable(&builder);
+			SPFlatBufferAddInt64(&builder, 0, (int64_t)i);
+			SPFlatBufferAddOffset(&builder, 1, indexType);
+			dictionary = SPFlatBufferEndTable(&builder);
+		}
+
+		SPFlatBufferStartVector(&builder, sizeof(uint32_t), 0, sizeof(uint32_t));
+		SPFlatBufferOffset children = SPFlatBufferEndVector(&builder, 0);
+
+		SPFlatBufferStartTable(&builder);
+		SPFlatBufferAddOffset(&builder, 0, name);
+		SPFlatBufferAddUInt8(&builder, 1, 1);
+		SPFlatBufferAddUInt8(&builder, 2, typeType);
+		SPFlatBufferAddOffset(&builder, 3, type);
+		if (dictionary) SPFlatBufferAddOffset(&builder, 4, dictionary);
+		SPFlatBufferAddOffset(&builder, 5, children);
+		fields[i] = SPFlatBufferEndTable(&builder);
+	}
+
+	SPFlatBufferOffset fieldsVector = SPFlatBufferCreateOffsetVector(&builder, fields, [columns count]);
+
+	free(fields);
+
+	SPFlatBufferStartTable(&builder);
+	SPFlatBufferAddOffset(&builder, 1, fieldsVector);
+	SPFlatBufferOffset schema = SPFlatBufferEndTable(&builder);
+
+	[self _writeMessageWithHeader:schema ofType:SPArrowMessageHeaderSchema body:nil builder:&builder];
+
+	SPFlatBufferFree(&builder);
+
+	schemaWritten = YES;
+}
+
+- (void)_writeDictionaryBatchForColumn:(SPColumnarColumn *)column withIdentifier:(NSUInteger)identifier
+{
+	NSMutableData *body = [NSMutableData data];
+	NSMutableData *buffers = [NSMutableData data];
+
+	int64_t node[2] = { (int64_t)[column dictionaryLength], 0 };
+
+	SPArrowAppendBuffer(body, buffers, NULL, 0);
+	SPArrowAppendBuffer(body, buffers, [[column dictionaryOffsets] bytes], [[column dictionaryOffsets] length]);
+	SPArrowAppendBuffer(body, buffers, [[column dictionaryValues] bytes], [[column dictionaryValues] length]);
+
+	SPFlatBufferBuilder builder;
+	SPFlatBufferInit(&builder);
+
+	SPFlatBufferOffset data = [self _createRecordBatchWithLength:[column dictionaryLength] nodes:[NSData dataWithBytes:node length:sizeof(node)] buffers:buffers builder:&builder];
+
+	SPFlatBufferStartTable(&builder);
+	SPFlatBufferAddInt64(&builder, 0, (int64_t)identifier);
+	SPFlatBufferAddOffset(&builder, 1, data);
+	SPFlatBufferOffset dictionaryBatch = SPFlatBufferEndTable(&builder);
+
+	[self _writeMessageWithHeader:dictionaryBatch ofType:SPArrowMessageHeaderDictionaryBatch body:body builder:&builder];
+
+	SPFlatBufferFree(&builder);
+}
+
+- (void)_writeRecordBatchForColumns:(NSArray *)columns rowCount:(NSUInteger)rowCount
+{
+	NSMutableData *body = [NSMutableData data];
+	NSMutableData *nodes = [NSMutableData data];
+	NSMutableData *buffers = [NSMutableData data];
+
+	for (NSUInteger i = 0; i < [columns count]; i++)
+	{
+		SPColumnarColumn *column = [columns objectAtIndex:i];
+
+		int64_t node[2] = { (int64_t)[column length], (int64_t)[column nullCount] };
+
+		[nodes appendBytes:node length:sizeof(node)];
+
+		// The validity bitmap may be omitted if there are no NULLs
+		if ([column nullCount]) {
+			SPArrowAppendBuffer(body, buffers, [[column validity] bytes], [[column validity] length]);
+		}
+		else {
+			SPArrowAppendBuffer(body, buffers, NULL, 0);
+		}
+
+		if ([dictionaryEncodedColumns containsIndex:i]) {
+			SPArrowAppendBuffer(body, buffers, [[column dictionaryIndices] bytes], [[column dictionaryIndices] length]);
+		}
+		else {
+			if ([column isVariableLength]) {
+				SPArrowAppendBuffer(body, buffers, [[column offsets] bytes], [[column offsets] length]);
+			}
+
+			SPArrowAppendBuffer(body, buffers, [[column values] bytes], [[column values] length]);
+		}
+	}
+
+	SPFlatBufferBuilder builder;
+	SPFlatBufferInit(&builder);
+
+	SPFlatBufferOffset recordBatch = [self _createRecordBatchWithLength:rowCount nodes:nodes buffers:buffers builder:&builder];
+
+	[self _writeMessageWithHeader:recordBatch ofType:SPArrowMessageHeaderRecordBatch body:body builder:&builder];
+
+	SPFlatBufferFree(&builder);
+}
+
+/**
+ * Writes an encapsulated IPC message: a continuation marker, the length of the (8 byte aligned)
+ * metadata, the Message flatbuffer itself and finally the message body.
+ */
+- (void)_writeMessageWithHeader:(SPFlatBufferOffset)header ofType:(uint8_t)headerType body:(NSData *)body builder:(SPFlatBufferBuilder *)builder
+{
+	SPFlatBufferStartTable(builder);
+	SPFlatBufferAddInt16(builder, 0, SPArrowMetadataVersionV5);
+	SPFlatBufferAddUInt8(builder, 1, headerType);
+	SPFlatBufferAddOffset(builder, 2, header);
+	SPFlatBufferAddInt64(builder, 3, (int64_t)[body length]);
+	SPFlatBufferOffset message = SPFlatBufferEndTable(builder);
+
+	NSData *metadata = SPFlatBufferFinish(builder, message);
+
+	NSUInteger paddedLength = ([metadata length] + 7) & ~(NSUInteger)7;
+	uint32_t prefix[2] = { SPArrowContinuationMarker, CFSwapInt32HostToLittle((uint32_t)paddedLength) };
+
+	NSMutableData *data = [NSMutableData dataWithCapacity:(sizeof(prefix) + paddedLength + [body length])];
+
+	[data appendBytes:prefix length:sizeof(prefix)];
+	[data appendData:metadata];
+	[data setLength:(sizeof(prefix) + paddedLength)];
+
+	if (body) [data appendData:body];
+
+	[self writeColumnarData:data];
+}
+
+@end
+
+#pragma mark -
+
+/**
+ * Appends a buffer to a message body, padded to 8 bytes, and records its offset and length.
+ */
+static void SPArrowAppendBuffer(NSMutableData *body, NSMutableData *buffers, const void *bytes, NSUInteger length)
+{
+	int64_t buffer[2] = { (int64_t)[body length], (int64_t)length };
+
+	[buffers appendBytes:buffer length:sizeof(buffer)];
+
+	if (length) [body appendBytes:bytes length:length];
+
+	[body setLength:(([body length] + 7) & ~(NSUInteger)7)];
+}
+
+static SPFlatBufferOffset SPArrowCreateIntType(SPFlatBufferBuilder *builder, int32_t bitWidth, BOOL isSigned)
+{
+	SPFlatBufferStartTable(builder);
+	SPFlatBufferAddInt32(builder, 0, bitWidth);
+	SPFlatBufferAddUInt8(builder, 1, isSigned ? 1 : 0);
+
+	return SPFlatBufferEndTable(builder);
+}
@@ -30,14 +30,26 @@
 
 #import "SPCSVExporter.h"
 #import "SPFileHandle.h"
+#import "SPExportRowPrefetcher.h"
+#import "SPCSVRowEncoder.h"
 #import "SPTableData.h"
 #import "SPExportUtilities.h"
 #import "SPExportFile.h"
+#import "SPExportCheckpoint.h"
 #import "SPExportController.h"
 #import "SPFunctions.h"
 
 #import <SPMySQL/SPMySQL.h>
 
+// The size at which the rows buffered by the row encoder are written to the export file
+static const NSUInteger SPCSVExportWriteBufferSize = 1024 * 1024;
+
+@interface SPCSVExporter ()
+
+- (void)_writeEncodedRows:(SPCSVRowEncoder *)encoder;
+
+@end
+
 @implementation SPCSVExporter
 
 @synthesize delegate;
@@ -82,6 +94,8 @@
     NSArray *csvRow = nil;
     NSScanner *csvNumericTester = nil;
     SPMySQLFastStreamingResult *streamingResult = nil;
+    SPExportRowPrefetcher *rowPrefetcher = nil;
+    SPCSVRowEncoder *rowEncoder = nil;
     NSString *escapedEscapeString, *escapedFieldSeparatorString, *escapedEnclosingString, *escapedLineEndString, *dataConversionString;
     
     id csvCell;
@@ -90,6 +104,14 @@
     
     double lastProgressValue;
     NSUInteger i, totalRows, csvCellCount = 0;
+
+    NSUInteger chunkKeyIndex = NSNotFound, rowsFetchedForChunk = 0;
+    NSString *chunkKeyColumn = nil, *chunkLastKey = nil;
+    BOOL chunkKeyIsNumeric = NO;
+
+    // The field names line is repeated at the start of every part of a split export
+    BOOL splitOutput = [[self exportOutputFile] splitsOutput];
+    NSData *fieldNamesLine = nil;
     
     // Check to see if we have at least a table name or data array
     if ((![self csvTableName] && ![self csvDataArray]) ||
@@ -122,6 +144,22 @@
     [self setExportProcessIsRunning:YES];
     NSString *exportDatabaseName = (![self csvDataArray] && [self csvTableName]) ? [self databaseName] : nil;
 
+    // If resuming an interrupted export, skip tables which were already completely written
+    SPExportCheckpoint *checkpoint = ([self csvDataArray]) ? nil : [[self exportOutputFile] exportCheckpoint];
+
+    if ([checkpoint isTableCompleted:[self csvTableName]]) {
+        [self setExportProcessIsRunning:NO];
+
+        [delegate performSelectorOnMainThread:@selector(csvExportProcessComplete:) withObject:self waitUntilDone:NO];
+
+        return;
+    }
+
+    // When resuming part way through a table the field names precede the checkpoint
+    chunkLastKey = [checkpoint lastKeyForTable:[self csvTableName]];
+
+    if (chunkLastKey) [self setCsvOutputFieldNames:NO];
+
     lastProgressValue = 0;
     
     // Before the streaming query is started, build an array of numeric columns if a table
@@ -139,10 +177,22 @@
             tableDetails = [[NSDictionary alloc] initWithDictionary:(object) ? [[self csvTableData] informationForView:[self csvTableName] fromDatabase:exportDatabaseName] : [[self csvTableData] informationForTable:[self csvTableName] fromDatabase:exportDatabaseName]];
         }
         
+        // Walk tables with a single column primary key in key ordered chunks if requested
+        NSArray *primaryKeyFields = [tableDetails objectForKey:@"primarykeyfield"];
+
+        if ([self exportChunkRowCount] && [primaryKeyFields count] == 1) {
+            chunkKeyColumn = [primaryKeyFields firstObject];
+        }
+
         // Retrieve the table details via the data class, and use it to build an array containing column numeric status
         for (NSDictionary *column in [tableDetails objectForKey:@"columns"])
         {
             NSString *tableColumnTypeGrouping = [column objectForKey:@"typegrouping"];
+
+            if (chunkKeyColumn && [[column objectForKey:@"name"] isEqualToString:chunkKeyColumn]) {
+                chunkKeyIndex = [tableColumnNumericStatus count];
+                chunkKeyIsNumeric = ![[column objectForKey:@"binary"] boolValue] && [@[@"integer", @"float"] containsObject:tableColumnTypeGrouping];
+            }
             
             [tableColumnNumericStatus addObject:[NSNumber numberWithBool:
                                                  ([tableColumnTypeGrouping isEqualToString:@"bit"]
@@ -154,8 +204,18 @@
     
     // Make a streaming request for the data if the data array isn't set
     if ((![self csvDataArray]) && [self csvTableName]) {
-        totalRows		= [[connection getFirstFieldFromQuery:[NSString stringWithFormat:@"SELECT COUNT(1) FROM %@", [[self csvTableName] backtickQuotedString]] assertingDatabase:exportDatabaseName] integerValue];
-        streamingResult = [connection streamingQueryString:[NSString stringWithFormat:@"SELECT * FROM %@", [[self csvTableName] backtickQuotedString]] useLowMemoryBlockingStreaming:[self exportUsingLowMemoryBlockingStreaming] assertingDatabase:exportDatabaseName];
+        [self beginTransferStatisticsForTable:[self csvTableName]];
+
+        totalRows		= [self estimatedRowCountForTable:[self csvTableName] inDatabase:exportDatabaseName];
+
+        if (chunkKeyIndex != NSNotFound) {
+            streamingResult = [connection streamingQueryString:[self chunkQueryForColumns:@"*" fromTable:[self csvTableName] orderedByKey:chunkKeyColumn afterKey:chunkLastKey] useLowMemoryBlockingStreaming:[self exportUsingLowMemoryBlockingStreaming] assertingDatabase:exportDatabaseName];
+            rowPrefetcher = [self rowPrefetcherForStreamingResult:streamingResult];
+        }
+        else {
+            streamingResult = [connection streamingQueryString:[NSString stringWithFormat:@"SELECT * FROM %@", [[self csvTableName] backtickQuotedString]] useLowMemoryBlockingStreaming:[self exportUsingLowMemoryBlockingStreaming] assertingDatabase:exportDatabaseName];
+            rowPrefetcher = [self rowPrefetcherForStreamingResult:streamingResult];
+        }
     }
     
     // Detect and restore special characters being used as terminating or line end strings
@@ -202,6 +262,16 @@
     escapedEnclosingString      = [[self csvEscapeString] stringByAppendingString:[self csvEnclosingCharacterString]];
     escapedLineEndString        = [[self csvEscapeString] stringByAppendingString:[self csvLineEndingString]];
     
+    // When writing UTF-8, encode the rows straight into a byte buffer unless the options can't be handled
+    // that way, in which case the strings above are used to escape each cell
+    if ([self exportOutputEncoding] == NSUTF8StringEncoding) {
+        rowEncoder = [[SPCSVRowEncoder alloc] initWithFieldSeparator:[self csvFieldSeparatorString]
+                                                  enclosingCharacter:[self csvEnclosingCharacterString]
+                                                        escapeString:[self csvEscapeString]
+                                                          lineEnding:[self csvLineEndingString]
+                                                          nullString:[self csvNULLString]];
+    }
+    
     // Set up the starting row; for supplied arrays, which include the column
     // headers as the first row, decide whether to skip the first row.
     NSUInteger currentRowIndex = 0;
@@ -216,49 +286,7 @@
     
     while (1) 
     {
-        if(self.exportOutputFile.fileHandleError != nil){
-            SPMainQSync(^{
-                [(SPExportController*)self->delegate cancelExportForFile:self->exportOutputFile.exportFilePath];
-            });
-            return;
-        }
-        // Check for cancellation flag
-        if ([self isCancelled] ) {
-            if (streamingResult) {
-                [connection cancelCurrentQuery];
-                [streamingResult cancelResultLoad];
-            }
-            
-            return;
-        }
-        
-        // Retrieve the next row from the supplied data, either directly from the array...
-        BOOL forceNonNumericRow = NO;
-        if ([self csvDataArray]) {
-            csvRow = [[self csvDataArray] safeObjectAtIndex:currentRowIndex];
-        }
-        // Or by reading an appropriate row from the streaming result
-        else {
-            // If still requested to read the field names, get the field names
-            if ([self csvOutputFieldNames]) {
-                csvRow = [streamingResult fieldNames];
-                [self setCsvOutputFieldNames:NO];
-                forceNonNumericRow = YES;
-            } 
-            else {
-                csvRow = [streamingResult getRowAsArray];
-                
-                if (!csvRow) break;
-            }
-        }
-        
-        // Get the cell count if we don't already have it stored
-        if (!csvCellCount) csvCellCount = [csvRow count];
-        
-        [csvString setString:@""];
-        
-        for (i = 0 ; i < csvCellCount; i++) 
-        {
+        @autoreleasepool {
             if(self.exportOutputFile.fileHandleError != nil){
                 SPMainQSync(^{
                     [(SPExportController*)self->delegate cancelExportForFile:self->exportOutputFile.exportFilePath];
@@ -266,136 +294,294 @@
                 return;
             }
             // Check for cancellation flag
-            if ([self isCancelled]) {
+            if ([self isCancelled] ) {
+                if (streamingResult) {
+                    [connection cancelCurrentQuery];
+                    [rowPrefetcher cancelResultLoad];
+                }
+            
                 return;
             }
+        
+            // Retrieve the next row from the supplied data, either directly from the array...
+            BOOL forceNonNumericRow = NO;
+            if ([self csvDataArray]) {
+                csvRow = [[self csvDataArray] safeObjectAtIndex:currentRowIndex];
+            }
+            // Or by reading an appropriate row from the streaming result
+            else {
+                // If still requested to read the field names, get the field names
+                if ([self csvOutputFieldNames]) {
+                    csvRow = [streamingResult fieldNames];
+                    [self setCsvOutputFieldNames:NO];
+                    forceNonNumericRow = YES;
+                } 
+                else {
+                    csvRow = [rowPrefetcher getRowAsArray];
+
+                    // Once a full chunk has been written, checkpoint and fetch the rows following its last key
+                    if (!csvRow && chunkKeyIndex != NSNotFound && rowsFetchedForChunk == [self exportChunkRowCount] && ![connection queryErrored]) {
+                        [self _writeEncodedRows:rowEncoder];
+
+                        // Only data that reached the disk can be resumed from
+                        unsigned long long byteOffset = [[self exportOutputFile] synchronizedLength];
+
+                        if ([self exportOutputFile].fileHandleError == nil) [checkpoint recordLastKey:chunkLastKey forTable:[self csvTableName] atByteOffset:byteOffset];
+
+                        streamingResult = [connection streamingQueryString:[self chunkQueryForColumns:@"*" fromTable:[self csvTableName] orderedByKey:chunkKeyColumn afterKey:chunkLastKey] useLowMemoryBlockingStreaming:[self exportUsingLowMemoryBlockingStreaming] assertingDatabase:exportDatabaseName];
+                        rowPrefetcher = [self rowPrefetcherForStreamingResult:streamingResult];
+                        rowsFetchedForChunk = 0;
+
+                        csvRow = [rowPrefetcher getRowAsArray];
+                    }
+
+                    if (!csvRow) {
+
+                        // A failed chunk leaves the output at the previous checkpoint; stop so the export can be resumed from there
+                        if (chunkKeyIndex != NSNotFound && checkpoint && [connection queryErrored]) {
+                            NSString *errorMessage = [connection lastErrorMessage];
+
+                            SPMainQSync(^{
+                                [(SPExportController*)self->delegate interruptExportWithError:errorMessage];
+                            });
+
+                            return;
+                        }
+
+                        break;
+                    }
+
+                    if (chunkKeyIndex != NSNotFound) {
+                        rowsFetchedForChunk++;
+                        chunkLastKey = [self chunkKeyLiteralForValue:[csvRow safeObjectAtIndex:chunkKeyIndex] isNumeric:chunkKeyIsNumeric isHex:NO];
+                    }
+                }
+            }
+        
+            // Roll over to the next part between rows once the current one is full
+            if (splitOutput && !forceNonNumericRow) {
+                [self _writeEncodedRows:rowEncoder];
+
+                if ([[self exportOutputFile] currentPartIsFull]) {
+                    // Without a new part there is nowhere to write the remaining rows, so abort the export
+                    if (![[self exportOutputFile] startNextPart]) {
+                        if (streamingResult) {
+                            [connection cancelCurrentQuery];
+                            [rowPrefetcher cancelResultLoad];
+                        }
+
+                        SPMainQSync(^{
+                            [(SPExportController*)self->delegate cancelExportForFile:(self->exportOutputFile.fileHandleError ?: self->exportOutputFile.exportFilePath)];
+                        });
+                        return;
+                    }
+
+                    if (fieldNamesLine && [self exportOutputFile].fileHandleError == nil) [[self exportOutputFile] writeData:fieldNamesLine];
+                }
+            }
+
+            // Get the cell count if we don't already have it stored
+            if (!csvCellCount) csvCellCount = [csvRow count];
+        
+            [csvString setString:@""];
+
+            NSUInteger rowStart = [rowEncoder length];
+        
+            for (i = 0 ; i < csvCellCount; i++) 
+            {
+                if(self.exportOutputFile.fileHandleError != nil){
+                    SPMainQSync(^{
+                        [(SPExportController*)self->delegate cancelExportForFile:self->exportOutputFile.exportFilePath];
+                    });
+                    return;
+                }
+                // Check for cancellation flag
+                if ([self isCancelled]) {
+                    return;
+                }
             
-            csvCell = [csvRow safeObjectAtIndex:i];
+                csvCell = [csvRow safeObjectAtIndex:i];
             
-            // For NULL objects supplied from a queryResult, add an unenclosed null string as per prefs
-            if ([csvCell isNSNull]) {
-                [csvString appendString:[self csvNULLString]];
-                
-                if (i < (csvCellCount - 1)) [csvString appendString:[self csvFieldSeparatorString]];
+                // For NULL objects supplied from a queryResult, add an unenclosed null string as per prefs
+                if ([csvCell isNSNull]) {
+                    if (rowEncoder) {
+                        [rowEncoder appendNULL];
+
+                        if (i < (csvCellCount - 1)) [rowEncoder appendFieldSeparator];
+                    }
+                    else {
+                        [csvString appendString:[self csvNULLString]];
+
+                        if (i < (csvCellCount - 1)) [csvString appendString:[self csvFieldSeparatorString]];
+                    }
                 
-                continue;
-            }
+                    continue;
+                }
             
-            // Retrieve the contents of this cell
-            if ([csvCell isKindOfClass:[NSData class]]) {
-                dataConversionString = [[NSString alloc] initWithData:csvCell encoding:[self exportOutputEncoding]];
+                // Retrieve the contents of this cell
+                NSString *cellText;
+
+                if ([csvCell isKindOfClass:[NSData class]]) {
+                    dataConversionString = [[NSString alloc] initWithData:csvCell encoding:[self exportOutputEncoding]];
                 
-                if (dataConversionString == nil) {
-                    dataConversionString = [[NSString alloc] initWithData:csvCell encoding:NSASCIIStringEncoding];
-                }
+                    if (dataConversionString == nil) {
+                        dataConversionString = [[NSString alloc] initWithData:csvCell encoding:NSASCIIStringEncoding];
+                    }
                 
-                [csvCellString setString:[NSString stringWithString:dataConversionString]];
-            }
-            else if ([csvCell isKindOfClass:[SPMySQLGeometryData class]]) {
-                [csvCellString setString:[csvCell wktString]];
-            }
-            else {
-                [csvCellString setString:[csvCell description]];
-            }
+                    cellText = dataConversionString;
+                }
+                else if ([csvCell isKindOfClass:[SPMySQLGeometryData class]]) {
+                    cellText = [csvCell wktString];
+                }
+                else {
+                    cellText = [csvCell description];
+                }
             
-            // Add empty strings as a pair of enclosing characters.
-            if ([csvCellString length] == 0) {
-                [csvString appendString:[self csvEnclosingCharacterString]];
-                [csvString appendString:[self csvEnclosingCharacterString]];
-            }
-            else {
-                // is this the header row?
-                if (forceNonNumericRow) {
-                    csvCellIsNumeric = NO;
+                // Add empty strings as a pair of enclosing characters.
+                if ([cellText length] == 0) {
+                    if (rowEncoder) {
+                        [rowEncoder appendCellString:cellText enclosed:YES];
+                    }
+                    else {
+                        [csvString appendString:[self csvEnclosingCharacterString]];
+                        [csvString appendString:[self csvEnclosingCharacterString]];
+                    }
                 }
-                // If an array of bools supplying information as to whether the column is numeric has been supplied, use it.
-                else if ([tableColumnNumericStatus count] > 0) {
-                    csvCellIsNumeric = [[tableColumnNumericStatus safeObjectAtIndex:i] boolValue];
-                } 
-                // Otherwise, first test whether this cell contains data
-                else if ([[csvRow safeObjectAtIndex:i] isKindOfClass:[NSData class]]) {
-                    csvCellIsNumeric = NO;
-                } 
-                // Or fall back to testing numeric content via an NSScanner.
                 else {
-                    csvNumericTester = [NSScanner scannerWithString:csvCellString];
+                    // is this the header row?
+                    if (forceNonNumericRow) {
+                        csvCellIsNumeric = NO;
+                    }
+                    // If an array of bools supplying information as to whether the column is numeric has been supplied, use it.
+                    else if ([tableColumnNumericStatus count] > 0) {
+                        csvCellIsNumeric = [[tableColumnNumericStatus safeObjectAtIndex:i] boolValue];
+                    } 
+                    // Otherwise, first test whether this cell contains data
+                    else if ([[csvRow safeObjectAtIndex:i] isKindOfClass:[NSData class]]) {
+                        csvCellIsNumeric = NO;
+                    } 
+                    // Or fall back to testing numeric content via an NSScanner.
+                    else {
+                        csvNumericTester = [NSScanner scannerWithString:cellText];
                     
-                    csvCellIsNumeric = [csvNumericTester scanFloat:nil] && 
-                    [csvNumericTester isAtEnd] && 
-                    ([csvCellString characterAtIndex:0] != '0' || 
-                     [csvCellString length] == 1 || 
-                     ([csvCellString length] > 1 && 
-                      [csvCellString characterAtIndex:1] == '.'));
-                }
+                        csvCellIsNumeric = [csvNumericTester scanFloat:nil] && 
+                        [csvNumericTester isAtEnd] && 
+                        ([cellText characterAtIndex:0] != '0' || 
+                         [cellText length] == 1 || 
+                         ([cellText length] > 1 && 
+                          [cellText characterAtIndex:1] == '.'));
+                    }
                 
-                // Escape any occurrences of the escaping character
-                [csvCellString replaceOccurrencesOfString:[self csvEscapeString]
-                                               withString:escapedEscapeString
-                                                  options:NSLiteralSearch
-                                                    range:NSMakeRange(0, [csvCellString length])];
+                    if (rowEncoder) {
+                        [rowEncoder appendCellString:cellText enclosed:!csvCellIsNumeric];
+                    }
+                    else {
+                        [csvCellString setString:cellText];
+
+                        // Escape any occurrences of the escaping character
+                        [csvCellString replaceOccurrencesOfString:[self csvEscapeString]
+                                                       withString:escapedEscapeString
+                                                          options:NSLiteralSearch
+                                                            range:NSMakeRange(0, [csvCellString length])];
                 
-                // Escape any occurrences of the enclosure string
-                if (![[self csvEscapeString] isEqualToString:[self csvEnclosingCharacterString]]) {
-                    [csvCellString replaceOccurrencesOfString:[self csvEnclosingCharacterString]
-                                                   withString:escapedEnclosingString
-                                                      options:NSLiteralSearch
-                                                        range:NSMakeRange(0, [csvCellString length])];
-                }
+                        // Escape any occurrences of the enclosure string
+                        if (![[self csvEscapeString] isEqualToString:[self csvEnclosingCharacterString]]) {
+                            [csvCellString replaceOccurrencesOfString:[self csvEnclosingCharacterString]
+                                                           withString:escapedEnclosingString
+                                                              options:NSLiteralSearch
+                                                                range:NSMakeRange(0, [csvCellString length])];
+                        }
                 
-                // If the string isn't quoted or otherwise enclosed, escape occurrences of the field separators and line end character
-                if (quoteFieldSeparators || csvCellIsNumeric) {
-                    [csvCellString replaceOccurrencesOfString:[self csvFieldSeparatorString]
-                                                   withString:escapedFieldSeparatorString
-                                                      options:NSLiteralSearch
-                                                        range:NSMakeRange(0, [csvCellString length])];
-                    [csvCellString replaceOccurrencesOfString:[self csvLineEndingString]
-                                                   withString:escapedLineEndString
-                                                      options:NSLiteralSearch
-                                                        range:NSMakeRange(0, [csvCellString length])];
-                }
+                        // If the string isn't quoted or otherwise enclosed, escape occurrences of the field separators and line end character
+                        if (quoteFieldSeparators || csvCellIsNumeric) {
+                            [csvCellString replaceOccurrencesOfString:[self csvFieldSeparatorString]
+                                                           withString:escapedFieldSeparatorString
+                                                              options:NSLiteralSearch
+                                                                range:NSMakeRange(0, [csvCellString length])];
+                            [csvCellString replaceOccurrencesOfString:[self csvLineEndingString]
+                                                           withString:escapedLineEndString
+                                                              options:NSLiteralSearch
+                                                                range:NSMakeRange(0, [csvCellString length])];
+                        }
                 
-                // Write out the cell data by appending strings - this is significantly faster than stringWithFormat.
-                if (csvCellIsNumeric) {
-                    [csvString appendString:csvCellString];
-                } 
-                else {
-                    [csvString appendString:[self csvEnclosingCharacterString]];
-                    [csvString appendString:csvCellString];
-                    [csvString appendString:[self csvEnclosingCharacterString]];
+                        // Write out the cell data by appending strings - this is significantly faster than stringWithFormat.
+                        if (csvCellIsNumeric) {
+                            [csvString appendString:csvCellString];
+                        } 
+                        else {
+                            [csvString appendString:[self csvEnclosingCharacterString]];
+                            [csvString appendString:csvCellString];
+                            [csvString appendString:[self csvEnclosingCharacterString]];
+                        }
+                    }
                 }
-            }
             
-            if (i < ([csvRow count] - 1)) [csvString appendString:[self csvFieldSeparatorString]];
-        }
+                if (i < ([csvRow count] - 1)) {
+                    if (rowEncoder) [rowEncoder appendFieldSeparator];
+                    else [csvString appendString:[self csvFieldSeparatorString]];
+                }
+            }
         
-        // Append the line ending to the string for this row, and record the length processed for pool flushing
-        [csvString appendString:[self csvLineEndingString]];
+            if (rowEncoder) {
+                [rowEncoder appendLineEnding];
+
+                if (forceNonNumericRow) {
+                    fieldNamesLine = [NSData dataWithBytes:((const char *)[rowEncoder bytes] + rowStart) length:([rowEncoder length] - rowStart)];
+                }
+
+                if ([rowEncoder length] >= SPCSVExportWriteBufferSize) [self _writeEncodedRows:rowEncoder];
+            }
+            else {
+                // Append the line ending to the string for this row, and record the length processed for pool flushing
+                [csvString appendString:[self csvLineEndingString]];
         
-        // Write it to the fileHandle
-        [self writeString:csvString];
+                // Write it to the fileHandle
+                [self writeString:csvString];
+
+                if (forceNonNumericRow) fieldNamesLine = [csvString dataUsingEncoding:[self exportOutputEncoding]];
+            }
+
+            if (splitOutput && !forceNonNumericRow) {
+                [[self exportOutputFile] recordRows:1 forTable:[self csvTableName]];
+            }
         
-        currentRowIndex++;
+            currentRowIndex++;
+
+            [self setExportProcessedRowCount:currentRowIndex];
         
-        // Update the progress
-        if (totalRows && (currentRowIndex * ([self exportMaxProgress] / totalRows)) > lastProgressValue) {
-            
-            double progress = (currentRowIndex * ([self exportMaxProgress] / totalRows));
-            
-            [self setExportProgressValue:progress];
+            // Update the progress
+            double progress = [self exportProgressForProcessedRowCount:currentRowIndex ofEstimatedRowCount:totalRows];
+
+            if (progress > lastProgressValue) {
+                [self setExportProgressValue:progress];
             
-            lastProgressValue = progress;
-        }
+                lastProgressValue = progress;
+            }
         
-        // Inform the delegate that the export's progress has been updated
-        [delegate performSelectorOnMainThread:@selector(csvExportProcessProgressUpdated:) withObject:self waitUntilDone:NO];
+            // Inform the delegate that the export's progress has been updated
+            [delegate performSelectorOnMainThread:@selector(csvExportProcessProgressUpdated:) withObject:self waitUntilDone:NO];
         
-        // If an array was supplied and we've processed all rows, break
-        if ([self csvDataArray] && (totalRows == currentRowIndex)) break;
+            // If an array was supplied and we've processed all rows, break
+            if ([self csvDataArray] && (totalRows == currentRowIndex)) break;
+        }
     }
     
     // Write data to disk
-    [[[self exportOutputFile] exportFileHandle] synchronizeFile];
+    [self _writeEncodedRows:rowEncoder];
+
+    unsigned long long byteOffset = [[self exportOutputFile] synchronizedLength];
+
+    if(self.exportOutputFile.fileHandleError != nil){
+        SPMainQSync(^{
+            [(SPExportController*)self->delegate cancelExportForFile:self->exportOutputFile.exportFilePath];
+        });
+        return;
+    }
+
+    [checkpoint recordCompletedTable:[self csvTableName] atByteOffset:byteOffset];
     
+    [self endTransferStatisticsForTable];
+
     // Mark the process as not running
     [self setExportProcessIsRunning:NO];
     
@@ -403,4 +589,22 @@
     [delegate performSelectorOnMainThread:@selector(csvExportProcessComplete:) withObject:self waitUntilDone:NO];
 }
 
+#pragma mark -
+#pragma mark Private API
+
+/**
+ * Writes the rows buffered by the encoder to the export file and empties the buffer. The file handle
+ * copies the bytes into its own buffer, so they're handed over without copying them first.
+ */
+- (void)_writeEncodedRows:(SPCSVRowEncoder *)encoder
+{
+    if (![encoder length]) return;
+
+    if ([self exportOutputFile].fileHandleError == nil) {
+        [[self exportOutputFile] writeData:[NSData dataWithBytesNoCopy:(void *)[encoder bytes] length:[encoder length] freeWhenDone:NO]];
+    }
+
+    [encoder removeAllBytes];
+}
+
 @end
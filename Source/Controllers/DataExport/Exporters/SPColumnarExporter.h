@@ -0,0 +1,120 @@
+//
+//  SPColumnarExporter.h
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPExporter.h"
+#import "SPColumnarExporterProtocol.h"
+
+@class SPColumnarColumn;
+
+/**
+ * @class SPColumnarExporter SPColumnarExporter.h
+ *
+ * Base class of the columnar (Arrow and Parquet) exporters. It fetches the rows of a table or a supplied
+ * result set, maps the MySQL field types to columnar types and buffers the rows column by column in
+ * batches of at most columnarBatchRowCount rows (or SPColumnarExportBatchByteLimit bytes), handing each
+ * batch to the format specific subclass to be written. Only a single batch is held in memory at a time.
+ *
+ * Subclasses must override writeBatchForColumns:rowCount: and finishWritingForColumns:.
+ */
+@interface SPColumnarExporter : SPExporter
+{
+	NSArray *columnarDataArray;
+	NSArray *columnarFieldDefinitions;
+
+	NSString *columnarTableName;
+
+	BOOL columnarOutputDictionaryEncoding;
+
+	NSUInteger columnarBatchRowCount;
+
+	unsigned long long columnarBytesWritten;
+}
+
+/**
+ * @property delegate Exporter delegate
+ */
+@property (readwrite, weak) NSObject <SPColumnarExporterProtocol> *delegate;
+
+/**
+ * @property columnarDataArray Data array, with the field names as the first row
+ */
+@property (readwrite, strong) NSArray *columnarDataArray;
+
+/**
+ * @property columnarFieldDefinitions SPMySQLResult field definitions of the data array's columns
+ */
+@property (readwrite, strong) NSArray *columnarFieldDefinitions;
+
+/**
+ * @property columnarTableName Table name
+ */
+@property (readwrite, copy) NSString *columnarTableName;
+
+/**
+ * @property columnarOutputDictionaryEncoding Dictionary encode low cardinality string columns
+ */
+@property (readwrite, assign) BOOL columnarOutputDictionaryEncoding;
+
+/**
+ * @property columnarBatchRowCount The maximum number of rows per record batch or row group
+ */
+@property (readwrite, assign) NSUInteger columnarBatchRowCount;
+
+/**
+ * @property columnarBytesWritten The number of bytes written to the export file so far
+ */
+@property (readonly, assign) unsigned long long columnarBytesWritten;
+
+- (instancetype)initWithDelegate:(NSObject *)exportDelegate;
+
+#pragma mark Subclass API
+
+/**
+ * Writes the current batch of each column. Called once for every batch, with the columns in result order.
+ */
+- (void)writeBatchForColumns:(NSArray<SPColumnarColumn *> *)columns rowCount:(NSUInteger)rowCount;
+
+/**
+ * Completes the output once all batches have been written. Called even if the result set was empty.
+ */
+- (void)finishWritingForColumns:(NSArray<SPColumnarColumn *> *)columns;
+
+/**
+ * Writes data to the output file, keeping track of the number of bytes written.
+ */
+- (void)writeColumnarData:(NSData *)data;
+
+/**
+ * Returns the maximum number of distinct values a column may have in a batch of the supplied
+ * number of rows for it to be considered low cardinality and worth dictionary encoding.
+ */
+- (NSUInteger)dictionaryLengthLimitForRowCount:(NSUInteger)rowCount;
+
+@end
@@ -0,0 +1,312 @@
+//
+//  SPColumnarExporter.m
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPColumnarExporter.h"
+#import "SPColumnarColumn.h"
+#import "SPExportFile.h"
+#import "SPFileHandle.h"
+#import "SPExportRowPrefetcher.h"
+#import "SPExportUtilities.h"
+#import "SPExportController.h"
+#import "SPFunctions.h"
+
+#import <SPMySQL/SPMySQL.h>
+
+static const NSUInteger SPColumnarExportDefaultBatchRowCount = 65536;
+static const NSUInteger SPColumnarExportBatchByteLimit       = 64 * 1024 * 1024;
+
+@interface SPColumnarExporter ()
+
+- (NSArray *)_fieldDefinitionsForFieldNames:(NSArray *)fieldNames;
+- (NSUInteger)_bufferedByteLengthOfColumns:(NSArray *)columns;
+
+@end
+
+@implementation SPColumnarExporter
+
+@synthesize delegate;
+@synthesize columnarDataArray;
+@synthesize columnarFieldDefinitions;
+@synthesize columnarTableName;
+@synthesize columnarOutputDictionaryEncoding;
+@synthesize columnarBatchRowCount;
+@synthesize columnarBytesWritten;
+
+/**
+ * Initialise an instance of SPColumnarExporter using the supplied delegate.
+ *
+ * @param exportDelegate The exporter delegate
+ *
+ * @return The initialised instance
+ */
+- (instancetype)initWithDelegate:(NSObject<SPColumnarExporterProtocol> *)exportDelegate
+{
+	if ((self = [super init])) {
+		SPExportDelegateConformsToProtocol(exportDelegate, @protocol(SPColumnarExporterProtocol));
+
+		[self setDelegate:exportDelegate];
+
+		columnarOutputDictionaryEncoding = YES;
+		columnarBatchRowCount = SPColumnarExportDefaultBatchRowCount;
+		columnarBytesWritten = 0;
+	}
+
+	return self;
+}
+
+- (void)exportOperation
+{
+	NSArray *row = nil;
+	NSArray *fieldNames = nil;
+	NSArray *fieldDefinitions = nil;
+
+	SPMySQLFastStreamingResult *streamingResult = nil;
+	SPExportRowPrefetcher *rowPrefetcher = nil;
+
+	double lastProgressValue = 0;
+	NSUInteger i, totalRows, currentRowIndex = 0, batchRowCount = 0;
+
+	// Check to see if we have at least a table name or data array
+	if ((![self columnarTableName] && ![self columnarDataArray]) ||
+		([[self columnarTableName] length] == 0 && [[self columnarDataArray] count] == 0) ||
+		([self columnarTableName] && ![self columnarDataArray] && ![[self databaseName] length]))
+	{
+		return;
+	}
+
+	// Inform the delegate that the export process is about to begin
+	[delegate performSelectorOnMainThread:@selector(columnarExportProcessWillBegin:) withObject:self waitUntilDone:NO];
+
+	// Mark the process as running
+	[self setExportProcessIsRunning:YES];
+
+	// Make a streaming request for the data if the data array isn't set
+	if (![self columnarDataArray]) {
+		NSString *exportDatabaseName = [self databaseName];
+
+		[self beginTransferStatisticsForTable:[self columnarTableName]];
+
+		totalRows       = [self estimatedRowCountForTable:[self columnarTableName] inDatabase:exportDatabaseName];
+		streamingResult = [connection streamingQueryString:[NSString stringWithFormat:@"SELECT * FROM %@", [[self columnarTableName] backtickQuotedString]] useLowMemoryBlockingStreaming:[self exportUsingLowMemoryBlockingStreaming] assertingDatabase:exportDatabaseName];
+		rowPrefetcher = [self rowPrefetcherForStreamingResult:streamingResult];
+
+		fieldNames       = [streamingResult fieldNames];
+		fieldDefinitions = [streamingResult fieldDefinitions];
+	}
+	else {
+		// The first row of a supplied array holds the field names
+		totalRows        = [[self columnarDataArray] count] - 1;
+		fieldNames       = [[self columnarDataArray] firstObject];
+		fieldDefinitions = [self _fieldDefinitionsForFieldNames:fieldNames];
+	}
+
+	// Set up a column for each field, mapping its MySQL type to a columnar type
+	NSMutableArray *columns = [NSMutableArray arrayWithCapacity:[fieldNames count]];
+
+	for (i = 0; i < [fieldNames count]; i++)
+	{
+		NSDictionary *definition = [fieldDefinitions safeObjectAtIndex:i];
+
+		SPColumnarColumn *column = [SPColumnarColumn columnWithName:[[fieldNames safeObjectAtIndex:i] description] fieldDefinition:([definition isKindOfClass:[NSDictionary class]] ? definition : nil)];
+
+		[column setDataEncoding:[self exportOutputEncoding]];
+
+		[columns addObject:column];
+	}
+
+	NSUInteger maximumBatchRowCount = MAX(1, [self columnarBatchRowCount]);
+
+	// Inform the delegate that we are about to start writing the data to disk
+	[delegate performSelectorOnMainThread:@selector(columnarExportProcessWillBeginWritingData:) withObject:self waitUntilDone:NO];
+
+	while (1)
+	{
+		if (self.exportOutputFile.fileHandleError != nil) {
+			SPMainQSync(^{
+				[(SPExportController*)self->delegate cancelExportForFile:self->exportOutputFile.exportFilePath];
+			});
+			return;
+		}
+
+		// Check for cancellation flag
+		if ([self isCancelled]) {
+			if (streamingResult) {
+				[connection cancelCurrentQuery];
+				[rowPrefetcher cancelResultLoad];
+			}
+
+			return;
+		}
+
+		@autoreleasepool {
+
+			// Retrieve the next row from the supplied data, either directly from the array (skipping the field names)...
+			if ([self columnarDataArray]) {
+				if (currentRowIndex == totalRows) break;
+
+				row = [[self columnarDataArray] safeObjectAtIndex:(currentRowIndex + 1)];
+			}
+			// Or by reading an appropriate row from the streaming result
+			else {
+				row = [rowPrefetcher getRowAsArray];
+
+				if (!row) break;
+			}
+
+			for (i = 0; i < [columns count]; i++)
+			{
+				[(SPColumnarColumn *)[columns objectAtIndex:i] appendValue:[row safeObjectAtIndex:i]];
+			}
+		}
+
+		currentRowIndex++;
+		batchRowCount++;
+
+		// Hand the batch over to be written once it's full, keeping memory usage bounded
+		if (batchRowCount == maximumBatchRowCount || [self _bufferedByteLengthOfColumns:columns] >= SPColumnarExportBatchByteLimit) {
+			[self writeBatchForColumns:columns rowCount:batchRowCount];
+
+			for (SPColumnarColumn *column in columns) [column reset];
+
+			batchRowCount = 0;
+		}
+
+		[self setExportProcessedRowCount:currentRowIndex];
+
+		// Update the progress
+		double progress = [self exportProgressForProcessedRowCount:currentRowIndex ofEstimatedRowCount:totalRows];
+
+		if (progress > lastProgressValue) {
+			[self setExportProgressValue:progress];
+
+			lastProgressValue = progress;
+
+			// Inform the delegate that the export's progress has been updated
+			[delegate performSelectorOnMainThread:@selector(columnarExportProcessProgressUpdated:) withObject:self waitUntilDone:NO];
+		}
+	}
+
+	// Write the last, partial batch
+	if (batchRowCount) [self writeBatchForColumns:columns rowCount:batchRowCount];
+
+	[self finishWritingForColumns:columns];
+
+	// Write data to disk
+	[[[self exportOutputFile] exportFileHandle] synchronizeFile];
+
+	[self endTransferStatisticsForTable];
+
+	// Mark the process as not running
+	[self setExportProcessIsRunning:NO];
+
+	// Inform the delegate that the export process is complete
+	[delegate performSelectorOnMainThread:@selector(columnarExportProcessComplete:) withObject:self waitUntilDone:NO];
+}
+
+#pragma mark -
+#pragma mark Subclass API
+
+/**
+ * This method should never be called as all subclasses should override it.
+ */
+- (void)writeBatchForColumns:(NSArray<SPColumnarColumn *> *)columns rowCount:(NSUInteger)rowCount
+{
+	[NSException raise:NSInternalInconsistencyException format:@"Cannot call %s, must be overriden in a subclass. See SPColumnarExporter.h",__PRETTY_FUNCTION__];
+}
+
+/**
+ * This method should never be called as all subclasses should override it.
+ */
+- (void)finishWritingForColumns:(NSArray<SPColumnarColumn *> *)columns
+{
+	[NSException raise:NSInternalInconsistencyException format:@"Cannot call %s, must be overriden in a subclass. See SPColumnarExporter.h",__PRETTY_FUNCTION__];
+}
+
+- (void)writeColumnarData:(NSData *)data
+{
+	if ([self exportOutputFile].fileHandleError != nil) return;
+
+	[[self exportOutputFile] writeData:data];
+
+	columnarBytesWritten += [data length];
+}
+
+- (NSUInteger)dictionaryLengthLimitForRowCount:(NSUInteger)rowCount
+{
+	// A dictionary only pays off when values repeat on average at least twice
+	return MAX(1, rowCount / 2);
+}
+
+#pragma mark -
+#pragma mark Private API
+
+/**
+ * Returns the supplied field definitions in the order of the data array's columns. The columns of a
+ * result view can be reordered or hidden, so definitions are matched up by name, in order, to cope
+ * with duplicate names. Columns without a definition get an NSNull placeholder.
+ *
+ * @param fieldNames The field names of the data array
+ */
+- (NSArray *)_fieldDefinitionsForFieldNames:(NSArray *)fieldNames
+{
+	NSMutableArray *definitions = [NSMutableArray arrayWithCapacity:[fieldNames count]];
+	NSMutableIndexSet *usedDefinitions = [NSMutableIndexSet indexSet];
+
+	for (id fieldName in fieldNames)
+	{
+		NSUInteger index = [[self columnarFieldDefinitions] indexOfObjectPassingTest:^BOOL(NSDictionary *definition, NSUInteger idx, BOOL *stop) {
+			return ![usedDefinitions containsIndex:idx] && [[definition objectForKey:@"name"] isEqualToString:[fieldName description]];
+		}];
+
+		if (index == NSNotFound) {
+			[definitions addObject:[NSNull null]];
+			continue;
+		}
+
+		[usedDefinitions addIndex:index];
+		[definitions addObject:[[self columnarFieldDefinitions] objectAtIndex:index]];
+	}
+
+	return definitions;
+}
+
+/**
+ * Returns the number of bytes buffered by all of the supplied columns.
+ */
+- (NSUInteger)_bufferedByteLengthOfColumns:(NSArray *)columns
+{
+	NSUInteger byteLength = 0;
+
+	for (SPColumnarColumn *column in columns) byteLength += [column bufferedByteLength];
+
+	return byteLength;
+}
+
+@end
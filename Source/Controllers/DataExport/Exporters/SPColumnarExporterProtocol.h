@@ -0,0 +1,68 @@
+//
+//  SPColumnarExporterProtocol.h
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+@class SPColumnarExporter;
+
+/**
+ * @protocol SPColumnarExporterProtocol SPColumnarExporterProtocol.h
+ *
+ * Columnar (Arrow and Parquet) exporter delegate protocol.
+ */
+@protocol SPColumnarExporterProtocol
+
+/**
+ * Called when the columnar export process is about to begin.
+ *
+ * @param SPColumnarExporter The expoter calling the method.
+ */
+- (void)columnarExportProcessWillBegin:(SPColumnarExporter *)exporter;
+
+/**
+ * Called when the columnar export process is complete.
+ *
+ * @param SPColumnarExporter The expoter calling the method.
+ */
+- (void)columnarExportProcessComplete:(SPColumnarExporter *)exporter;
+
+/**
+ * Called when the progress of the columnar export process is updated.
+ *
+ * @param SPColumnarExporter The expoter calling the method.
+ */
+- (void)columnarExportProcessProgressUpdated:(SPColumnarExporter *)exporter;
+
+/**
+ * Called when the columnar export process is about to begin writing data to disk.
+ *
+ * @param SPColumnarExporter The expoter calling the method.
+ */
+- (void)columnarExportProcessWillBeginWritingData:(SPColumnarExporter *)exporter;
+
+@end
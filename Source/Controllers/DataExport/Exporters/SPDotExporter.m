@@ -34,6 +34,7 @@
 #import "SPTableData.h"
 #import "SPExportUtilities.h"
 #import "SPExportFile.h"
+#import "SPExportMetadataCache.h"
 #import "SPExportController.h"
 #import "SPFunctions.h"
 
@@ -109,6 +110,17 @@
     
     NSMutableArray *fkInfo = [[NSMutableArray alloc] init];
     
+    // Fetch the CREATE statements for all tables up front over a small connection pool; columns and
+    // relations are then parsed from those instead of issuing a round trip per table.
+    // information_schema views are rewritten as tables by SPTableData, so those always take its own path.
+    SPExportMetadataCache *metadataCache = nil;
+    
+    if (![[self dotDatabaseName] isEqualToString:SPMySQLInformationSchemaDatabase]) {
+        metadataCache = [[SPExportMetadataCache alloc] initWithConnection:connection database:[self dotDatabaseName]];
+        
+        [metadataCache prefetchCreateStatementsForTables:[self dotExportTables] procedures:nil functions:nil forOperation:self];
+    }
+    
     // Process the tables
     for (NSUInteger i = 0; i < [[self dotExportTables] count]; i++) 
     {
@@ -127,7 +139,19 @@
         
         NSString *tableName = [[self dotExportTables] safeObjectAtIndex:i];
         NSString *tableLinkName = [self dotForceLowerTableNames] ? [tableName lowercaseString] : tableName;
-        NSDictionary *tableInfo = [[self dotTableData] informationForTable:tableName fromDatabase:[self dotDatabaseName]];
+        NSDictionary *createResult = [metadataCache createResultForTable:tableName];
+        NSDictionary *tableInfo;
+        
+        if (createResult) {
+            BOOL isView = ([createResult objectForKey:@"Create View"] != nil);
+            
+            tableInfo = [[self dotTableData] informationForTable:tableName
+                                                fromCreateSyntax:[createResult objectForKey:(isView ? @"Create View" : @"Create Table")]
+                                                          ofType:(isView ? @"View" : @"Table")];
+        }
+        else {
+            tableInfo = [[self dotTableData] informationForTable:tableName fromDatabase:[self dotDatabaseName]];
+        }
         
         // Set the current table
         [self setDotExportCurrentTable:tableName];
@@ -53,7 +53,7 @@
  * explicity called.
  */
 
-@class SPMySQLConnection, SPExportFile, SPServerSupport;
+@class SPMySQLConnection, SPMySQLStreamingResult, SPExportFile, SPExportRowPrefetcher, SPServerSupport, SPTransferStatistics;
 
 @interface SPExporter : NSOperation
 {	
@@ -75,6 +75,19 @@
 	SPExportFile *exportOutputFile;
 
 	NSStringEncoding exportOutputEncoding;
+
+	NSUInteger exportChunkRowCount;
+
+	NSUInteger exportProcessedRowCount;
+
+	SPTransferStatistics *transferStatistics;
+	SPExportRowPrefetcher *statisticsRowPrefetcher;
+	NSString *statisticsTableName;
+	NSUInteger reportedRowCount;
+	uint64_t reportedRowWaitNanoseconds;
+	uint64_t reportedWriterWaitNanoseconds;
+	uint64_t statisticsMarkTimestamp;
+	uint64_t statisticsTableTimestamp;
 }
 
 /**
@@ -132,6 +145,21 @@
  */
 @property(readwrite, assign) NSStringEncoding exportOutputEncoding;
 
+/**
+ * @property exportChunkRowCount If non-zero, tables with a single column primary key are fetched in key ordered chunks of this many rows
+ */
+@property(readwrite, assign) NSUInteger exportChunkRowCount;
+
+/**
+ * @property exportProcessedRowCount The number of rows of the current table or result written so far
+ */
+@property(readwrite, assign) NSUInteger exportProcessedRowCount;
+
+/**
+ * @property transferStatistics The statistics the export's rows, server bytes and stage times are added to, if any
+ */
+@property(readwrite, strong) SPTransferStatistics *transferStatistics;
+
 - (BOOL)exportOutputCompressFile;
 
 - (void)setExportOutputCompressFile:(BOOL)compress;
@@ -158,4 +186,62 @@
          Someone needs to check if that was an oversight or intentional.
 - (void)writeUTF8String:(NSString *)input;
 
+/**
+ * Returns the query selecting the next chunk of a table walked in primary key order.
+ * @param columns    The select list
+ * @param table      The table name
+ * @param keyColumn  The single primary key column
+ * @param keyLiteral The SQL literal of the last key already exported, or nil for the first chunk
+ */
+- (NSString *)chunkQueryForColumns:(NSString *)columns fromTable:(NSString *)table orderedByKey:(NSString *)keyColumn afterKey:(NSString *)keyLiteral;
+
+/**
+ * Returns a SQL literal for a primary key value as returned by the server, for use in the next chunk query.
+ * @param value     The key value
+ * @param isNumeric Whether the value can be used as-is
+ * @param isHex     Whether the value was selected as HEX() of a binary column
+ */
+- (NSString *)chunkKeyLiteralForValue:(id)value isNumeric:(BOOL)isNumeric isHex:(BOOL)isHex;
+
+/**
+ * Returns the server's estimate of the number of rows in a table, for drawing progress without counting them.
+ * Returns 0 if there is no estimate, as for views.
+ * @param table    The table name
+ * @param database The database the table is in
+ */
+- (NSUInteger)estimatedRowCountForTable:(NSString *)table inDatabase:(NSString *)database;
+
+/**
+ * Returns the progress value for a number of processed rows of an estimated total. Estimates can be
+ * short of the real row count, so the value is capped just below the maximum until the export ends.
+ * @param rowCount          The number of rows processed
+ * @param estimatedRowCount The estimated total number of rows; if 0, the progress is always 0
+ */
+- (double)exportProgressForProcessedRowCount:(NSUInteger)rowCount ofEstimatedRowCount:(NSUInteger)estimatedRowCount;
+
+/**
+ * Returns a prefetcher reading the rows of a streaming result on a background thread, so that fetching the
+ * next rows overlaps with encoding the current ones. Read rows from the prefetcher instead of the result.
+ * @param streamingResult The result, before any rows have been read from it
+ */
+- (SPExportRowPrefetcher *)rowPrefetcherForStreamingResult:(SPMySQLStreamingResult *)streamingResult;
+
+/**
+ * Logs how busy each stage of the export - fetching, encoding, compressing and writing - has been, to
+ * show which one limits the export's speed.
+ * @param prefetcher The prefetcher the rows were read from
+ */
+- (void)logStageUtilisationForRowPrefetcher:(SPExportRowPrefetcher *)prefetcher;
+
+/**
+ * Starts timing a table for the transfer statistics. Does nothing if there are no statistics.
+ * @param table The table about to be exported
+ */
+- (void)beginTransferStatisticsForTable:(NSString *)table;
+
+/**
+ * Records the table started by beginTransferStatisticsForTable:, with its duration and the processed row count.
+ */
+- (void)endTransferStatisticsForTable;
+
 @end
@@ -31,6 +31,20 @@
 #import "SPExporter.h"
 #import "SPExportFile.h"
 #import "SPFileHandle.h"
+#import "SPExportRowPrefetcher.h"
+#import "SPTransferStatistics.h"
+
+#import <SPMySQL/SPMySQL.h>
+
+// How often the exporter's time is split between waiting on the server and encoding
+static const uint64_t SPExporterStatisticsInterval = 100 * NSEC_PER_MSEC;
+
+@interface SPExporter ()
+
+- (void)_reportStageTimes;
+- (unsigned long long)_serverBytesSent;
+
+@end
 
 @implementation SPExporter
 
@@ -45,6 +59,8 @@
 @synthesize exportOutputFile;
 @synthesize exportOutputEncoding;
 @synthesize exportMaxProgress;
+@synthesize exportChunkRowCount;
+@synthesize transferStatistics;
 
 /**
  * Initialise an instance of SPExporter, while setting some default values.
@@ -75,7 +91,21 @@
 {
 	@autoreleasepool {
 		@try {
+			unsigned long long serverBytesSent = [self _serverBytesSent];
+
+			statisticsMarkTimestamp = SPPipelineTimestamp();
+
 			[self exportOperation];
+
+			if (transferStatistics) {
+				[self _reportStageTimes];
+
+				statisticsRowPrefetcher = nil;
+
+				unsigned long long serverBytesSentAfter = [self _serverBytesSent];
+
+				if (serverBytesSentAfter > serverBytesSent) [transferStatistics addServerBytes:serverBytesSentAfter - serverBytesSent];
+			}
 		}
 		@catch(NSException *e) {
 			[[NSApp onMainThread] reportException:e];
@@ -83,6 +113,30 @@
 	}
 }
 
+- (NSUInteger)exportProcessedRowCount
+{
+	return exportProcessedRowCount;
+}
+
+/**
+ * Sets the number of rows of the current table or result written so far, adding the newly written
+ * rows to the transfer statistics. Exporters restart the count for each table.
+ */
+- (void)setExportProcessedRowCount:(NSUInteger)rowCount
+{
+	exportProcessedRowCount = rowCount;
+
+	if (!transferStatistics) return;
+
+	if (rowCount < reportedRowCount) reportedRowCount = 0;
+
+	[transferStatistics addRows:rowCount - reportedRowCount];
+
+	reportedRowCount = rowCount;
+
+	if ((SPPipelineTimestamp() - statisticsMarkTimestamp) >= SPExporterStatisticsInterval) [self _reportStageTimes];
+}
+
 /**
  * This method should never be called as all subclasses should override it.
  */
@@ -130,6 +184,84 @@
     }
 }
 
+- (NSString *)chunkQueryForColumns:(NSString *)columns fromTable:(NSString *)table orderedByKey:(NSString *)keyColumn afterKey:(NSString *)keyLiteral
+{
+	NSMutableString *query = [NSMutableString stringWithFormat:@"SELECT %@ FROM %@", columns, [table backtickQuotedString]];
+
+	if (keyLiteral) {
+		[query appendFormat:@" WHERE %@ > %@", [keyColumn backtickQuotedString], keyLiteral];
+	}
+
+	[query appendFormat:@" ORDER BY %@ LIMIT %lu", [keyColumn backtickQuotedString], (unsigned long)[self exportChunkRowCount]];
+
+	return query;
+}
+
+- (NSString *)chunkKeyLiteralForValue:(id)value isNumeric:(BOOL)isNumeric isHex:(BOOL)isHex
+{
+	if (isHex) return [NSString stringWithFormat:@"X'%@'", value];
+
+	if ([value isKindOfClass:[NSData class]]) return [connection escapeAndQuoteData:value];
+
+	if (isNumeric) return [value description];
+
+	return [connection escapeAndQuoteString:[value description]];
+}
+
+- (NSUInteger)estimatedRowCountForTable:(NSString *)table inDatabase:(NSString *)database
+{
+	if (![table length] || ![database length]) return 0;
+
+	// TABLE_ROWS comes from the storage engine's statistics, so unlike COUNT(1) it doesn't scan the table
+	id rowCount = [connection getFirstFieldFromQuery:[NSString stringWithFormat:@"SELECT TABLE_ROWS FROM information_schema.TABLES WHERE TABLE_SCHEMA = %@ AND TABLE_NAME = %@", [connection escapeAndQuoteString:database], [connection escapeAndQuoteString:table]]];
+
+	if (![rowCount respondsToSelector:@selector(longLongValue)] || [rowCount longLongValue] <= 0) return 0;
+
+	return (NSUInteger)[rowCount longLongValue];
+}
+
+- (double)exportProgressForProcessedRowCount:(NSUInteger)rowCount ofEstimatedRowCount:(NSUInteger)estimatedRowCount
+{
+	if (!estimatedRowCount) return 0;
+
+	return MIN((double)rowCount / estimatedRowCount, 0.99) * [self exportMaxProgress];
+}
+
+- (SPExportRowPrefetcher *)rowPrefetcherForStreamingResult:(SPMySQLStreamingResult *)streamingResult
+{
+	SPExportRowPrefetcher *prefetcher;
+
+	// Low memory streaming is chosen for tables with very large rows, so only fetch a single row ahead
+	if ([self exportUsingLowMemoryBlockingStreaming]) {
+		prefetcher = [[SPExportRowPrefetcher alloc] initWithStreamingResult:streamingResult batchSize:1 queueCapacity:1];
+	}
+	else {
+		prefetcher = [[SPExportRowPrefetcher alloc] initWithStreamingResult:streamingResult batchSize:256 queueCapacity:4];
+	}
+
+	if (transferStatistics) {
+
+		// Account for the time spent waiting on the previous result before switching over
+		[self _reportStageTimes];
+
+		statisticsRowPrefetcher = prefetcher;
+		reportedRowWaitNanoseconds = 0;
+	}
+
+	return prefetcher;
+}
+
+- (void)logStageUtilisationForRowPrefetcher:(SPExportRowPrefetcher *)prefetcher
+{
+	SPFileHandle *fileHandle = [[self exportOutputFile] exportFileHandle];
+
+	SPLog(@"Export stage utilisation: fetch %.0f%%, compression %.0f%%, disk %.0f%%; encoding waited %.3fs for rows",
+		  SPPipelineStageUtilisation([prefetcher fetchStageCounters]) * 100,
+		  SPPipelineStageUtilisation([fileHandle countersForWriteStage:SPFileHandleCompressionStage]) * 100,
+		  SPPipelineStageUtilisation([fileHandle countersForWriteStage:SPFileHandleDiskWriteStage]) * 100,
+		  [prefetcher rowWaitNanoseconds] / 1e9);
+}
+
 /**
  * Get rid of the export data.
  */
@@ -139,4 +271,69 @@
 	
 }
 
+- (void)beginTransferStatisticsForTable:(NSString *)table
+{
+	if (!transferStatistics) return;
+
+	statisticsTableName = [table copy];
+	statisticsTableTimestamp = SPPipelineTimestamp();
+}
+
+- (void)endTransferStatisticsForTable
+{
+	if (!transferStatistics || !statisticsTableName) return;
+
+	[transferStatistics recordTable:statisticsTableName rowCount:[self exportProcessedRowCount] duration:SPPipelineTimestamp() - statisticsTableTimestamp];
+
+	statisticsTableName = nil;
+}
+
+#pragma mark -
+#pragma mark Private API
+
+/**
+ * Splits the exporter's time since the last report between waiting on the server for rows, waiting
+ * on the file for compression or the disk to catch up, and encoding - which is whatever remains.
+ */
+- (void)_reportStageTimes
+{
+	uint64_t now = SPPipelineTimestamp();
+	uint64_t rowWaitNanoseconds = [statisticsRowPrefetcher rowWaitNanoseconds];
+	uint64_t writerWaitNanoseconds = [[self exportOutputFile] writerWaitNanoseconds];
+
+	uint64_t serverNanoseconds = (rowWaitNanoseconds > reportedRowWaitNanoseconds) ? rowWaitNanoseconds - reportedRowWaitNanoseconds : 0;
+	uint64_t fileNanoseconds = (writerWaitNanoseconds > reportedWriterWaitNanoseconds) ? writerWaitNanoseconds - reportedWriterWaitNanoseconds : 0;
+	uint64_t elapsedNanoseconds = now - statisticsMarkTimestamp;
+
+	[transferStatistics addNanoseconds:serverNanoseconds toStage:SPTransferServerStage];
+
+	if (elapsedNanoseconds > serverNanoseconds + fileNanoseconds) {
+		[transferStatistics addNanoseconds:elapsedNanoseconds - serverNanoseconds - fileNanoseconds toStage:SPTransferEncodingStage];
+	}
+
+	reportedRowWaitNanoseconds = rowWaitNanoseconds;
+	reportedWriterWaitNanoseconds = writerWaitNanoseconds;
+	statisticsMarkTimestamp = now;
+}
+
+/**
+ * Returns the number of bytes the server has sent over the connection, sampled around the export to
+ * measure the data received without counting it row by row. Returns 0 without statistics, or if the
+ * connection isn't usable.
+ */
+- (unsigned long long)_serverBytesSent
+{
+	if (!transferStatistics || ![connection isConnected] || [self isCancelled]) return 0;
+
+	SPMySQLResult *result = [connection queryString:@"SHOW SESSION STATUS LIKE 'Bytes_sent'"];
+
+	if ([connection queryErrored]) return 0;
+
+	[result setReturnDataAsStrings:YES];
+
+	NSArray *row = [result getRowAsArray];
+
+	return ([row count] > 1) ? (unsigned long long)[[row objectAtIndex:1] longLongValue] : 0;
+}
+
 @end
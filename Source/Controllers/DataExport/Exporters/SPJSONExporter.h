@@ -0,0 +1,85 @@
+//
+//  SPJSONExporter.h
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+
+#import "SPExporter.h"
+#import "SPJSONExporterProtocol.h"
+
+/**
+ * @class SPJSONExporter SPJSONExporter.h
+ *
+ * JSON exporter class. Writes the rows of a table or a supplied result set as JSON objects keyed by
+ * field name, either one per line (NDJSON) or as a single array. Rows are streamed from the server
+ * and encoded by an SPJSONRowEncoder into a buffer which is written out in large blocks.
+ */
+@interface SPJSONExporter : SPExporter
+{
+	NSArray *jsonDataArray;
+	NSArray *jsonFieldDefinitions;
+
+	NSString *jsonTableName;
+
+	SPJSONExportFormat jsonFormat;
+	SPJSONExportBinaryEncoding jsonBinaryEncoding;
+}
+
+/**
+ * @property delegate Exporter delegate
+ */
+@property (readwrite, weak) NSObject <SPJSONExporterProtocol> *delegate;
+
+/**
+ * @property jsonDataArray Data array, with the field names as the first row
+ */
+@property (readwrite, strong) NSArray *jsonDataArray;
+
+/**
+ * @property jsonFieldDefinitions SPMySQLResult field definitions of the data array's columns
+ */
+@property (readwrite, strong) NSArray *jsonFieldDefinitions;
+
+/**
+ * @property jsonTableName Table name
+ */
+@property (readwrite, copy) NSString *jsonTableName;
+
+/**
+ * @property jsonFormat Whether to write NDJSON or a JSON array
+ */
+@property (readwrite, assign) SPJSONExportFormat jsonFormat;
+
+/**
+ * @property jsonBinaryEncoding How the values of binary columns are encoded
+ */
+@property (readwrite, assign) SPJSONExportBinaryEncoding jsonBinaryEncoding;
+
+- (instancetype)initWithDelegate:(NSObject *)exportDelegate;
+
+@end
@@ -0,0 +1,265 @@
+//
+//  SPJSONExporter.m
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+
+#import "SPJSONExporter.h"
+#import "SPJSONRowEncoder.h"
+#import "SPExportFile.h"
+#import "SPFileHandle.h"
+#import "SPExportRowPrefetcher.h"
+#import "SPExportUtilities.h"
+#import "SPExportController.h"
+#import "SPFunctions.h"
+
+#import <SPMySQL/SPMySQL.h>
+
+// Encoded rows are buffered until they reach this size, so the file handle is written to in large blocks
+static const NSUInteger SPJSONExportWriteBufferSize = 1024 * 1024;
+
+@interface SPJSONExporter ()
+
+- (NSArray *)_fieldDefinitionsForFieldNames:(NSArray *)fieldNames;
+- (void)_writeEncodedRows:(SPJSONRowEncoder *)encoder;
+
+@end
+
+@implementation SPJSONExporter
+
+@synthesize delegate;
+@synthesize jsonDataArray;
+@synthesize jsonFieldDefinitions;
+@synthesize jsonTableName;
+@synthesize jsonFormat;
+@synthesize jsonBinaryEncoding;
+
+/**
+ * Initialise an instance of SPJSONExporter using the supplied delegate.
+ *
+ * @param exportDelegate The exporter delegate
+ *
+ * @return The initialised instance
+ */
+- (instancetype)initWithDelegate:(NSObject<SPJSONExporterProtocol> *)exportDelegate
+{
+	if ((self = [super init])) {
+		SPExportDelegateConformsToProtocol(exportDelegate, @protocol(SPJSONExporterProtocol));
+
+		[self setDelegate:exportDelegate];
+
+		jsonFormat = SPJSONExportNDJSONFormat;
+		jsonBinaryEncoding = SPJSONExportBase64Encoding;
+	}
+
+	return self;
+}
+
+- (void)exportOperation
+{
+	NSArray *row = nil;
+	NSArray *fieldNames = nil;
+	NSArray *fieldDefinitions = nil;
+
+	SPMySQLFastStreamingResult *streamingResult = nil;
+	SPExportRowPrefetcher *rowPrefetcher = nil;
+
+	double lastProgressValue = 0;
+	NSUInteger totalRows, currentRowIndex = 0;
+
+	BOOL isArrayFormat = ([self jsonFormat] == SPJSONExportArrayFormat);
+
+	// Check to see if we have at least a table name or data array
+	if ((![self jsonTableName] && ![self jsonDataArray]) ||
+		([[self jsonTableName] length] == 0 && [[self jsonDataArray] count] == 0) ||
+		([self jsonTableName] && ![self jsonDataArray] && ![[self databaseName] length]))
+	{
+		return;
+	}
+
+	// Inform the delegate that the export process is about to begin
+	[delegate performSelectorOnMainThread:@selector(jsonExportProcessWillBegin:) withObject:self waitUntilDone:NO];
+
+	// Mark the process as running
+	[self setExportProcessIsRunning:YES];
+
+	// Make a streaming request for the data if the data array isn't set
+	if (![self jsonDataArray]) {
+		NSString *exportDatabaseName = [self databaseName];
+
+		[self beginTransferStatisticsForTable:[self jsonTableName]];
+
+		totalRows       = [self estimatedRowCountForTable:[self jsonTableName] inDatabase:exportDatabaseName];
+		streamingResult = [connection streamingQueryString:[NSString stringWithFormat:@"SELECT * FROM %@", [[self jsonTableName] backtickQuotedString]] useLowMemoryBlockingStreaming:[self exportUsingLowMemoryBlockingStreaming] assertingDatabase:exportDatabaseName];
+		rowPrefetcher = [self rowPrefetcherForStreamingResult:streamingResult];
+
+		fieldNames       = [streamingResult fieldNames];
+		fieldDefinitions = [streamingResult fieldDefinitions];
+	}
+	else {
+		// The first row of a supplied array holds the field names
+		totalRows        = [[self jsonDataArray] count] - 1;
+		fieldNames       = [[self jsonDataArray] firstObject];
+		fieldDefinitions = [self _fieldDefinitionsForFieldNames:fieldNames];
+	}
+
+	SPJSONRowEncoder *encoder = [[SPJSONRowEncoder alloc] initWithFieldNames:fieldNames fieldDefinitions:fieldDefinitions];
+
+	[encoder setBinaryEncoding:[self jsonBinaryEncoding]];
+	[encoder setDataEncoding:[self exportOutputEncoding]];
+
+	// Inform the delegate that we are about to start writing the data to disk
+	[delegate performSelectorOnMainThread:@selector(jsonExportProcessWillBeginWritingData:) withObject:self waitUntilDone:NO];
+
+	if (isArrayFormat) [encoder appendUTF8String:"["];
+
+	while (1)
+	{
+		if (self.exportOutputFile.fileHandleError != nil) {
+			SPMainQSync(^{
+				[(SPExportController*)self->delegate cancelExportForFile:self->exportOutputFile.exportFilePath];
+			});
+			return;
+		}
+
+		// Check for cancellation flag
+		if ([self isCancelled]) {
+			if (streamingResult) {
+				[connection cancelCurrentQuery];
+				[rowPrefetcher cancelResultLoad];
+			}
+
+			return;
+		}
+
+		@autoreleasepool {
+
+			// Retrieve the next row from the supplied data, either directly from the array (skipping the field names)...
+			if ([self jsonDataArray]) {
+				if (currentRowIndex == totalRows) break;
+
+				row = [[self jsonDataArray] safeObjectAtIndex:(currentRowIndex + 1)];
+			}
+			// Or by reading an appropriate row from the streaming result
+			else {
+				row = [rowPrefetcher getRowAsArray];
+
+				if (!row) break;
+			}
+
+			if (isArrayFormat) [encoder appendUTF8String:(currentRowIndex ? ",\n" : "\n")];
+
+			[encoder appendRow:row];
+
+			if (!isArrayFormat) [encoder appendUTF8String:"\n"];
+		}
+
+		currentRowIndex++;
+
+		if ([encoder length] >= SPJSONExportWriteBufferSize) [self _writeEncodedRows:encoder];
+
+		[self setExportProcessedRowCount:currentRowIndex];
+
+		// Update the progress
+		double progress = [self exportProgressForProcessedRowCount:currentRowIndex ofEstimatedRowCount:totalRows];
+
+		if (progress > lastProgressValue) {
+			[self setExportProgressValue:progress];
+
+			lastProgressValue = progress;
+
+			// Inform the delegate that the export's progress has been updated
+			[delegate performSelectorOnMainThread:@selector(jsonExportProcessProgressUpdated:) withObject:self waitUntilDone:NO];
+		}
+	}
+
+	if (isArrayFormat) [encoder appendUTF8String:(currentRowIndex ? "\n]\n" : "]\n")];
+
+	[self _writeEncodedRows:encoder];
+
+	// Write data to disk
+	[[[self exportOutputFile] exportFileHandle] synchronizeFile];
+
+	[self endTransferStatisticsForTable];
+
+	// Mark the process as not running
+	[self setExportProcessIsRunning:NO];
+
+	// Inform the delegate that the export process is complete
+	[delegate performSelectorOnMainThread:@selector(jsonExportProcessComplete:) withObject:self waitUntilDone:NO];
+}
+
+#pragma mark -
+#pragma mark Private API
+
+/**
+ * Returns the supplied field definitions in the order of the data array's columns. The columns of a
+ * result view can be reordered or hidden, so definitions are matched up by name, in order, to cope
+ * with duplicate names. Columns without a definition get an NSNull placeholder and are written as strings.
+ *
+ * @param fieldNames The field names of the data array
+ */
+- (NSArray *)_fieldDefinitionsForFieldNames:(NSArray *)fieldNames
+{
+	NSMutableArray *definitions = [NSMutableArray arrayWithCapacity:[fieldNames count]];
+	NSMutableIndexSet *usedDefinitions = [NSMutableIndexSet indexSet];
+
+	for (id fieldName in fieldNames)
+	{
+		NSUInteger index = [[self jsonFieldDefinitions] indexOfObjectPassingTest:^BOOL(NSDictionary *definition, NSUInteger idx, BOOL *stop) {
+			return ![usedDefinitions containsIndex:idx] && [[definition objectForKey:@"name"] isEqualToString:[fieldName description]];
+		}];
+
+		if (index == NSNotFound) {
+			[definitions addObject:[NSNull null]];
+			continue;
+		}
+
+		[usedDefinitions addIndex:index];
+		[definitions addObject:[[self jsonFieldDefinitions] objectAtIndex:index]];
+	}
+
+	return definitions;
+}
+
+/**
+ * Writes the rows buffered by the encoder to the export file and empties the buffer. The file handle
+ * copies the bytes into its own buffer, so they're handed over without copying them first.
+ */
+- (void)_writeEncodedRows:(SPJSONRowEncoder *)encoder
+{
+	if (![encoder length]) return;
+
+	if ([self exportOutputFile].fileHandleError == nil) {
+		[[self exportOutputFile] writeData:[NSData dataWithBytesNoCopy:(void *)[encoder bytes] length:[encoder length] freeWhenDone:NO]];
+	}
+
+	[encoder removeAllBytes];
+}
+
+@end
@@ -0,0 +1,69 @@
+//
+//  SPJSONExporterProtocol.h
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+
+@class SPJSONExporter;
+
+/**
+ * @protocol SPJSONExporterProtocol SPJSONExporterProtocol.h
+ *
+ * JSON exporter delegate protocol.
+ */
+@protocol SPJSONExporterProtocol
+
+/**
+ * Called when the JSON export process is about to begin.
+ *
+ * @param SPJSONExporter The expoter calling the method.
+ */
+- (void)jsonExportProcessWillBegin:(SPJSONExporter *)exporter;
+
+/**
+ * Called when the JSON export process is complete.
+ *
+ * @param SPJSONExporter The expoter calling the method.
+ */
+- (void)jsonExportProcessComplete:(SPJSONExporter *)exporter;
+
+/**
+ * Called when the progress of the JSON export process is updated.
+ *
+ * @param SPJSONExporter The expoter calling the method.
+ */
+- (void)jsonExportProcessProgressUpdated:(SPJSONExporter *)exporter;
+
+/**
+ * Called when the JSON export process is about to begin writing data to disk.
+ *
+ * @param SPJSONExporter The expoter calling the method.
+ */
+- (void)jsonExportProcessWillBeginWritingData:(SPJSONExporter *)exporter;
+
+@end
@@ -0,0 +1,741 @@
+//
+//  SPParquetExporter.m
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPParquetExporter.h"
+#import "SPColumnarColumn.h"
+
+#pragma mark Thrift compact protocol
+
+// Parquet's file metadata and page headers are serialised using Thrift's compact protocol. Only writing
+// the handful of types used by parquet.thrift is implemented here. Structs are written by tracking the
+// id of the last field written, as field ids are encoded as a delta to the previous field's id.
+
+static const uint8_t SPThriftTypeBooleanTrue  = 1;
+static const uint8_t SPThriftTypeBooleanFalse = 2;
+static const uint8_t SPThriftTypeByte         = 3;
+static const uint8_t SPThriftTypeI32          = 5;
+static const uint8_t SPThriftTypeI64          = 6;
+static const uint8_t SPThriftTypeBinary       = 8;
+static const uint8_t SPThriftTypeList         = 9;
+static const uint8_t SPThriftTypeStruct       = 12;
+
+static void SPThriftWriteBytes(NSMutableData *data, const void *bytes, NSUInteger length)
+{
+	[data appendBytes:bytes length:length];
+}
+
+static void SPThriftWriteByte(NSMutableData *data, uint8_t byte)
+{
+	SPThriftWriteBytes(data, &byte, 1);
+}
+
+/**
+ * Writes an unsigned LEB128 varint, which is also the encoding of the RLE/bit-packing hybrid run headers.
+ */
+static void SPThriftWriteVarint(NSMutableData *data, uint64_t value)
+{
+	uint8_t bytes[10];
+	NSUInteger length = 0;
+
+	while (value >= 0x80)
+	{
+		bytes[length++] = (uint8_t)(value | 0x80);
+		value >>= 7;
+	}
+
+	bytes[length++] = (uint8_t)value;
+
+	SPThriftWriteBytes(data, bytes, length);
+}
+
+static void SPThriftWriteZigZag(NSMutableData *data, int64_t value)
+{
+	SPThriftWriteVarint(data, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+}
+
+static void SPThriftWriteFieldBegin(NSMutableData *data, int16_t *lastFieldId, int16_t fieldId, uint8_t type)
+{
+	int16_t delta = fieldId - *lastFieldId;
+
+	if (delta > 0 && delta <= 15) {
+		SPThriftWriteByte(data, (uint8_t)((delta << 4) | type));
+	}
+	else {
+		SPThriftWriteByte(data, type);
+		SPThriftWriteZigZag(data, fieldId);
+	}
+
+	*lastFieldId = fieldId;
+}
+
+static void SPThriftWriteStructEnd(NSMutableData *data)
+{
+	SPThriftWriteByte(data, 0);
+}
+
+static void SPThriftWriteListBegin(NSMutableData *data, uint8_t elementType, NSUInteger count)
+{
+	if (count < 15) {
+		SPThriftWriteByte(data, (uint8_t)((count << 4) | elementType));
+	}
+	else {
+		SPThriftWriteByte(data, 0xF0 | elementType);
+		SPThriftWriteVarint(data, count);
+	}
+}
+
+static void SPThriftWriteBoolField(NSMutableData *data, int16_t *lastFieldId, int16_t fieldId, BOOL value)
+{
+	// Booleans are encoded in the field header's type
+	SPThriftWriteFieldBegin(data, lastFieldId, fieldId, value ? SPThriftTypeBooleanTrue : SPThriftTypeBooleanFalse);
+}
+
+static void SPThriftWriteByteField(NSMutableData *data, int16_t *lastFieldId, int16_t fieldId, int8_t value)
+{
+	SPThriftWriteFieldBegin(data, lastFieldId, fieldId, SPThriftTypeByte);
+	SPThriftWriteByte(data, (uint8_t)value);
+}
+
+static void SPThriftWriteI32Field(NSMutableData *data, int16_t *lastFieldId, int16_t fieldId, int32_t value)
+{
+	SPThriftWriteFieldBegin(data, lastFieldId, fieldId, SPThriftTypeI32);
+	SPThriftWriteZigZag(data, value);
+}
+
+static void SPThriftWriteI64Field(NSMutableData *data, int16_t *lastFieldId, int16_t fieldId, int64_t value)
+{
+	SPThriftWriteFieldBegin(data, lastFieldId, fieldId, SPThriftTypeI64);
+	SPThriftWriteZigZag(data, value);
+}
+
+static void SPThriftWriteBinary(NSMutableData *data, const void *bytes, NSUInteger length)
+{
+	SPThriftWriteVarint(data, length);
+	SPThriftWriteBytes(data, bytes, length);
+}
+
+static void SPThriftWriteStringField(NSMutableData *data, int16_t *lastFieldId, int16_t fieldId, NSString *string)
+{
+	NSData *bytes = [string dataUsingEncoding:NSUTF8StringEncoding];
+
+	SPThriftWriteFieldBegin(data, lastFieldId, fieldId, SPThriftTypeBinary);
+	SPThriftWriteBinary(data, [bytes bytes], [bytes length]);
+}
+
+#pragma mark - Parquet
+
+static const char SPParquetMagic[4] = { 'P', 'A', 'R', '1' };
+
+// parquet.thrift Type
+static const int32_t SPParquetTypeInt32             = 1;
+static const int32_t SPParquetTypeInt64             = 2;
+static const int32_t SPParquetTypeFloat             = 4;
+static const int32_t SPParquetTypeDouble            = 5;
+static const int32_t SPParquetTypeByteArray         = 6;
+static const int32_t SPParquetTypeFixedLenByteArray = 7;
+
+// parquet.thrift ConvertedType
+static const int32_t SPParquetConvertedTypeNone    = -1;
+static const int32_t SPParquetConvertedTypeUTF8    = 0;
+static const int32_t SPParquetConvertedTypeDecimal = 5;
+static const int32_t SPParquetConvertedTypeDate    = 6;
+static const int32_t SPParquetConvertedTypeUInt8   = 11;
+static const int32_t SPParquetConvertedTypeInt8    = 15;
+
+// parquet.thrift LogicalType union
+static const int16_t SPParquetLogicalTypeString    = 1;
+static const int16_t SPParquetLogicalTypeDecimal   = 5;
+static const int16_t SPParquetLogicalTypeDate      = 6;
+static const int16_t SPParquetLogicalTypeTimestamp = 8;
+static const int16_t SPParquetLogicalTypeInteger   = 10;
+
+// parquet.thrift TimeUnit union
+static const int16_t SPParquetTimeUnitMicros = 2;
+
+// parquet.thrift FieldRepetitionType
+static const int32_t SPParquetRepetitionOptional = 1;
+
+// parquet.thrift Encoding
+static const int32_t SPParquetEncodingPlain          = 0;
+static const int32_t SPParquetEncodingRLE            = 3;
+static const int32_t SPParquetEncodingRLEDictionary  = 8;
+
+// parquet.thrift PageType
+static const int32_t SPParquetPageTypeData       = 0;
+static const int32_t SPParquetPageTypeDictionary = 2;
+
+// Decimals are written as 16 byte, big-endian two's complement fixed length byte arrays
+static const NSUInteger SPParquetDecimalByteLength = 16;
+
+static inline BOOL SPParquetIsValid(const uint8_t *validity, NSUInteger index)
+{
+	return (!validity || (validity[index >> 3] & (1 << (index & 7))));
+}
+
+/**
+ * Writes the RLE/bit-packing hybrid encoded, length prefixed definition levels of an optional column.
+ * A single run is used if all or none of the values are NULL; otherwise the validity bitmap already
+ * is the bit-packed encoding of the levels, with a bit width of 1.
+ */
+static void SPParquetAppendDefinitionLevels(NSMutableData *data, const uint8_t *validity, NSUInteger length, NSUInteger nullCount)
+{
+	NSMutableData *levels = [NSMutableData data];
+
+	if (nullCount == 0 || nullCount == length) {
+		SPThriftWriteVarint(levels, (uint64_t)length << 1);
+		SPThriftWriteByte(levels, nullCount ? 0 : 1);
+	}
+	else {
+		NSUInteger groups = (length + 7) / 8;
+
+		SPThriftWriteVarint(levels, ((uint64_t)groups << 1) | 1);
+		SPThriftWriteBytes(levels, validity, groups);
+	}
+
+	uint32_t levelsLength = CFSwapInt32HostToLittle((uint32_t)[levels length]);
+
+	SPThriftWriteBytes(data, &levelsLength, sizeof(levelsLength));
+	SPThriftWriteBytes(data, [levels bytes], [levels length]);
+}
+
+/**
+ * Writes the dictionary indices of the non-NULL values, preceded by their bit width, as a single
+ * bit-packed run.
+ */
+static void SPParquetAppendDictionaryIndices(NSMutableData *data, const int32_t *indices, const uint8_t *validity, NSUInteger length, NSUInteger dictionaryLength)
+{
+	uint8_t bitWidth = 1;
+
+	while (bitWidth < 32 && ((uint64_t)1 << bitWidth) < dictionaryLength) bitWidth++;
+
+	SPThriftWriteByte(data, bitWidth);
+
+	NSUInteger count = 0;
+
+	for (NSUInteger i = 0; i < length; i++)
+	{
+		if (SPParquetIsValid(validity, i)) count++;
+	}
+
+	if (!count) return;
+
+	// Runs are made of groups of 8 values, so the last group is padded with zeros
+	NSUInteger groups = (count + 7) / 8;
+	NSMutableData *packed = [NSMutableData dataWithLength:(groups * bitWidth)];
+
+	uint8_t *output = [packed mutableBytes];
+	uint64_t buffer = 0;
+	NSUInteger bufferedBits = 0;
+
+	for (NSUInteger i = 0; i < length; i++)
+	{
+		if (!SPParquetIsValid(validity, i)) continue;
+
+		buffer |= (uint64_t)(uint32_t)indices[i] << bufferedBits;
+		bufferedBits += bitWidth;
+
+		while (bufferedBits >= 8)
+		{
+			*output++ = (uint8_t)buffer;
+			buffer >>= 8;
+			bufferedBits -= 8;
+		}
+	}
+
+	if (bufferedBits) *output = (uint8_t)buffer;
+
+	SPThriftWriteVarint(data, ((uint64_t)groups << 1) | 1);
+	SPThriftWriteBytes(data, [packed bytes], [packed length]);
+}
+
+/**
+ * Writes the PLAIN encoding of the non-NULL values of a variable length column: each value's
+ * length as a 4 byte little-endian integer followed by its bytes.
+ */
+static void SPParquetAppendByteArrays(NSMutableData *data, const uint8_t *values, const int32_t *offsets, const uint8_t *validity, NSUInteger length)
+{
+	for (NSUInteger i = 0; i < length; i++)
+	{
+		if (!SPParquetIsValid(validity, i)) continue;
+
+		uint32_t valueLength = (uint32_t)(offsets[i + 1] - offsets[i]);
+		uint32_t littleEndianLength = CFSwapInt32HostToLittle(valueLength);
+
+		SPThriftWriteBytes(data, &littleEndianLength, sizeof(littleEndianLength));
+		SPThriftWriteBytes(data, values + offsets[i], valueLength);
+	}
+}
+
+@interface SPParquetExporter ()
+
+- (void)_writeMagicIfNeeded;
+- (NSData *)_writeColumnChunkForColumn:(SPColumnarColumn *)column rowCount:(NSUInteger)rowCount;
+- (void)_writePageOfType:(int32_t)pageType valueCount:(NSUInteger)valueCount encoding:(int32_t)encoding data:(NSData *)pageData;
+- (void)_appendPlainValuesOfColumn:(SPColumnarColumn *)column toData:(NSMutableData *)data;
+- (void)_appendSchemaElementForColumn:(SPColumnarColumn *)column toData:(NSMutableData *)data;
+- (int32_t)_physicalTypeOfColumn:(SPColumnarColumn *)column;
+
+@end
+
+@implementation SPParquetExporter
+
+- (instancetype)initWithDelegate:(NSObject *)exportDelegate
+{
+	if ((self = [super initWithDelegate:exportDelegate])) {
+		magicWritten = NO;
+		rowGroups = [[NSMutableArray alloc] init];
+		totalRowCount = 0;
+	}
+
+	return self;
+}
+
+#pragma mark -
+#pragma mark Columnar exporter
+
+- (void)writeBatchForColumns:(NSArray<SPColumnarColumn *> *)columns rowCount:(NSUInteger)rowCount
+{
+	[self _writeMagicIfNeeded];
+
+	unsigned long long rowGroupStart = [self columnarBytesWritten];
+
+	NSMutableData *rowGroup = [NSMutableData data];
+	int16_t field = 0;
+
+	// RowGroup.columns
+	SPThriftWriteFieldBegin(rowGroup, &field, 1, SPThriftTypeList);
+	SPThriftWriteListBegin(rowGroup, SPThriftTypeStruct, [columns count]);
+
+	for (SPColumnarColumn *column in columns)
+	{
+		[rowGroup appendData:[self _writeColumnChunkForColumn:column rowCount:rowCount]];
+	}
+
+	// RowGroup.total_byte_size and num_rows
+	SPThriftWriteI64Field(rowGroup, &field, 2, (int64_t)([self columnarBytesWritten] - rowGroupStart));
+	SPThriftWriteI64Field(rowGroup, &field, 3, (int64_t)rowCount);
+	SPThriftWriteStructEnd(rowGroup);
+
+	[rowGroups addObject:rowGroup];
+
+	totalRowCount += rowCount;
+}
+
+- (void)finishWritingForColumns:(NSArray<SPColumnarColumn *> *)columns
+{
+	[self _writeMagicIfNeeded];
+
+	NSMutableData *metadata = [NSMutableData data];
+	int16_t field = 0;
+
+	// FileMetaData.version
+	SPThriftWriteI32Field(metadata, &field, 1, 1);
+
+	// FileMetaData.schema, a root element followed by one element per column
+	SPThriftWriteFieldBegin(metadata, &field, 2, SPThriftTypeList);
+	SPThriftWriteListBegin(metadata, SPThriftTypeStruct, [columns count] + 1);
+
+	int16_t rootField = 0;
+
+	SPThriftWriteStringField(metadata, &rootField, 4, @"schema");
+	SPThriftWriteI32Field(metadata, &rootField, 5, (int32_t)[columns count]);
+	SPThriftWriteStructEnd(metadata);
+
+	for (SPColumnarColumn *column in columns)
+	{
+		[self _appendSchemaElementForColumn:column toData:metadata];
+	}
+
+	// FileMetaData.num_rows and row_groups
+	SPThriftWriteI64Field(metadata, &field, 3, (int64_t)totalRowCount);
+	SPThriftWriteFieldBegin(metadata, &field, 4, SPThriftTypeList);
+	SPThriftWriteListBegin(metadata, SPThriftTypeStruct, [rowGroups count]);
+
+	for (NSData *rowGroup in rowGroups)
+	{
+		[metadata appendData:rowGroup];
+	}
+
+	// FileMetaData.created_by
+	SPThriftWriteStringField(metadata, &field, 6, [NSString stringWithFormat:@"Sequel Ace version %@", [[[NSBundle mainBundle] infoDictionary] objectForKey:@"CFBundleShortVersionString"]]);
+	SPThriftWriteStructEnd(metadata);
+
+	uint32_t metadataLength = CFSwapInt32HostToLittle((uint32_t)[metadata length]);
+
+	[self writeColumnarData:metadata];
+	[self writeColumnarData:[NSData dataWithBytes:&metadataLength length:sizeof(metadataLength)]];
+	[self writeColumnarData:[NSData dataWithBytes:SPParquetMagic length:sizeof(SPParquetMagic)]];
+}
+
+#pragma mark -
+#pragma mark Private API
+
+- (void)_writeMagicIfNeeded
+{
+	if (magicWritten) return;
+
+	[self writeColumnarData:[NSData dataWithBytes:SPParquetMagic length:sizeof(SPParquetMagic)]];
+
+	magicWritten = YES;
+}
+
+/**
+ * Writes the pages of the supplied column's current batch and returns its ColumnChunk metadata.
+ */
+- (NSData *)_writeColumnChunkForColumn:(SPColumnarColumn *)column rowCount:(NSUInteger)rowCount
+{
+	BOOL useDictionary = NO;
+
+	// Unlike Arrow, each row group can decide whether to use a dictionary independently
+	if ([self columnarOutputDictionaryEncoding] && [column type] == SPColumnarStringType) {
+		NSUInteger maximumLength = [column prefersDictionaryEncoding] ? NSUIntegerMax : [self dictionaryLengthLimitForRowCount:rowCount];
+
+		useDictionary = [column buildDictionaryWithMaximumLength:maximumLength];
+	}
+
+	const uint8_t *validity = [column nullCount] ? [[column validity] bytes] : NULL;
+
+	unsigned long long chunkStart = [self columnarBytesWritten];
+
+	if (useDictionary) {
+		NSMutableData *dictionaryPage = [NSMutableData data];
+
+		SPParquetAppendByteArrays(dictionaryPage, [[column dictionaryValues] bytes], [[column dictionaryOffsets] bytes], NULL, [column dictionaryLength]);
+
+		[self _writePageOfType:SPParquetPageTypeDictionary valueCount:[column dictionaryLength] encoding:SPParquetEncodingPlain data:dictionaryPage];
+	}
+
+	unsigned long long dataPageOffset = [self columnarBytesWritten];
+
+	NSMutableData *dataPage = [NSMutableData data];
+
+	SPParquetAppendDefinitionLevels(dataPage, validity, [column length], [column nullCount]);
+
+	if (useDictionary) {
+		SPParquetAppendDictionaryIndices(dataPage, [[column dictionaryIndices] bytes], validity, [column length], [column dictionaryLength]);
+	}
+	else {
+		[self _appendPlainValuesOfColumn:column toData:dataPage];
+	}
+
+	[self _writePageOfType:SPParquetPageTypeData valueCount:rowCount encoding:(useDictionary ? SPParquetEncodingRLEDictionary : SPParquetEncodingPlain) data:dataPage];
+
+	int64_t chunkLength = (int64_t)([self columnarBytesWritten] - chunkStart);
+
+	NSMutableData *chunk = [NSMutableData data];
+	int16_t field = 0;
+	int16_t metadataField = 0;
+
+	// ColumnChunk.file_offset and meta_data
+	SPThriftWriteI64Field(chunk, &field, 2, (int64_t)chunkStart);
+	SPThriftWriteFieldBegin(chunk, &field, 3, SPThriftTypeStruct);
+
+	SPThriftWriteI32Field(chunk, &metadataField, 1, [self _physicalTypeOfColumn:column]);
+
+	SPThriftWriteFieldBegin(chunk, &metadataField, 2, SPThriftTypeList);
+	SPThriftWriteListBegin(chunk, SPThriftTypeI32, useDictionary ? 3 : 2);
+	SPThriftWriteZigZag(chunk, SPParquetEncodingPlain);
+	SPThriftWriteZigZag(chunk, SPParquetEncodingRLE);
+	if (useDictionary) SPThriftWriteZigZag(chunk, SPParquetEncodingRLEDictionary);
+
+	NSData *name = [[column name] dataUsingEncoding:NSUTF8StringEncoding];
+
+	SPThriftWriteFieldBegin(chunk, &metadataField, 3, SPThriftTypeList);
+	SPThriftWriteListBegin(chunk, SPThriftTypeBinary, 1);
+	SPThriftWriteBinary(chunk, [name bytes], [name length]);
+
+	SPThriftWriteI32Field(chunk, &metadataField, 4, 0); // UNCOMPRESSED
+	SPThriftWriteI64Field(chunk, &metadataField, 5, (int64_t)rowCount);
+	SPThriftWriteI64Field(chunk, &metadataField, 6, chunkLength);
+	SPThriftWriteI64Field(chunk, &metadataField, 7, chunkLength);
+	SPThriftWriteI64Field(chunk, &metadataField, 9, (int64_t)dataPageOffset);
+	if (useDictionary) SPThriftWriteI64Field(chunk, &metadataField, 11, (int64_t)chunkStart);
+
+	SPThriftWriteStructEnd(chunk);
+	SPThriftWriteStructEnd(chunk);
+
+	return chunk;
+}
+
+/**
+ * Writes a PageHeader followed by the (uncompressed) page data.
+ */
+- (void)_writePageOfType:(int32_t)pageType valueCount:(NSUInteger)valueCount encoding:(int32_t)encoding data:(NSData *)pageData
+{
+	NSMutableData *header = [NSMutableData data];
+	int16_t field = 0;
+	int16_t pageField = 0;
+
+	SPThriftWriteI32Field(header, &field, 1, pageType);
+	SPThriftWriteI32Field(header, &field, 2, (int32_t)[pageData length]);
+	SPThriftWriteI32Field(header, &field, 3, (int32_t)[pageData length]);
+
+	if (pageType == SPParquetPageTypeData) {
+
+		// PageHeader.data_page_header
+		SPThriftWriteFieldBegin(header, &field, 5, SPThriftTypeStruct);
+		SPThriftWriteI32Field(header, &pageField, 1, (int32_t)valueCount);
+		SPThriftWriteI32Field(header, &pageField, 2, encoding);
+		SPThriftWriteI32Field(header, &pageField, 3, SPParquetEncodingRLE);
+		SPThriftWriteI32Field(header, &pageField, 4, SPParquetEncodingRLE);
+	}
+	else {
+
+		// PageHeader.dictionary_page_header
+		SPThriftWriteFieldBegin(header, &field, 7, SPThriftTypeStruct);
+		SPThriftWriteI32Field(header, &pageField, 1, (int32_t)valueCount);
+		SPThriftWriteI32Field(header, &pageField, 2, encoding);
+	}
+
+	SPThriftWriteStructEnd(header);
+	SPThriftWriteStructEnd(header);
+
+	[self writeColumnarData:header];
+	[self writeColumnarData:pageData];
+}
+
+/**
+ * Writes the PLAIN encoding of the non-NULL values of the supplied column's current batch.
+ */
+- (void)_appendPlainValuesOfColumn:(SPColumnarColumn *)column toData:(NSMutableData *)data
+{
+	const uint8_t *values = [[column values] bytes];
+	const uint8_t *validity = [column nullCount] ? [[column validity] bytes] : NULL;
+
+	if ([column isVariableLength]) {
+		SPParquetAppendByteArrays(data, values, [[column offsets] bytes], validity, [column length]);
+
+		return;
+	}
+
+	SPColumnarType type = [column type];
+	NSUInteger width = [column valueByteWidth];
+
+	// Values which are stored as is can be copied in one go if there are no NULLs to skip
+	BOOL needsConversion = (width < sizeof(int32_t) || type == SPColumnarDecimalType);
+
+	if (!validity && !needsConversion) {
+		[data appendData:[column values]];
+
+		return;
+	}
+
+	for (NSUInteger i = 0; i < [column length]; i++)
+	{
+		if (!SPParquetIsValid(validity, i)) continue;
+
+		const uint8_t *value = values + (i * width);
+
+		if (!needsConversion) {
+			[data appendBytes:value length:width];
+
+			continue;
+		}
+
+		int32_t widened = 0;
+
+		switch (type)
+		{
+			case SPColumnarInt8Type:
+				widened = *(const int8_t *)value;
+				break;
+			case SPColumnarUInt8Type:
+				widened = *value;
+				break;
+			case SPColumnarInt16Type:
+			{
+				int16_t int16Value;
+				memcpy(&int16Value, value, sizeof(int16Value));
+				widened = CFSwapInt16LittleToHost(int16Value);
+				break;
+			}
+			case SPColumnarUInt16Type:
+			{
+				uint16_t uint16Value;
+				memcpy(&uint16Value, value, sizeof(uint16Value));
+				widened = CFSwapInt16LittleToHost(uint16Value);
+				break;
+			}
+			case SPColumnarDecimalType:
+			{
+				// Little-endian to big-endian
+				uint8_t decimal[SPParquetDecimalByteLength];
+
+				for (NSUInteger j = 0; j < SPParquetDecimalByteLength; j++) decimal[j] = value[SPParquetDecimalByteLength - 1 - j];
+
+				[data appendBytes:decimal length:SPParquetDecimalByteLength];
+
+				continue;
+			}
+			default:
+				break;
+		}
+
+		// 8 and 16 bit integers are stored as INT32
+		widened = (int32_t)CFSwapInt32HostToLittle((uint32_t)widened);
+
+		[data appendBytes:&widened length:sizeof(widened)];
+	}
+}
+
+/**
+ * Writes the SchemaElement describing the supplied column, including both the legacy converted type
+ * and the logical type so that older and newer readers alike interpret the values correctly.
+ */
+- (void)_appendSchemaElementForColumn:(SPColumnarColumn *)column toData:(NSMutableData *)data
+{
+	int16_t field = 0;
+	int16_t logicalTypeField = 0;
+	int16_t logicalTypeValueField = 0;
+
+	SPColumnarType type = [column type];
+	int32_t convertedType = SPParquetConvertedTypeNone;
+
+	SPThriftWriteI32Field(data, &field, 1, [self _physicalTypeOfColumn:column]);
+
+	if (type == SPColumnarDecimalType) SPThriftWriteI32Field(data, &field, 2, (int32_t)SPParquetDecimalByteLength);
+
+	SPThriftWriteI32Field(data, &field, 3, SPParquetRepetitionOptional);
+	SPThriftWriteStringField(data, &field, 4, [column name]);
+
+	switch (type)
+	{
+		case SPColumnarInt8Type:
+		case SPColumnarInt16Type:
+		case SPColumnarInt32Type:
+		case SPColumnarInt64Type:
+			convertedType = SPParquetConvertedTypeInt8 + (int32_t)log2([column valueByteWidth]);
+			break;
+		case SPColumnarUInt8Type:
+		case SPColumnarUInt16Type:
+		case SPColumnarUInt32Type:
+		case SPColumnarUInt64Type:
+			convertedType = SPParquetConvertedTypeUInt8 + (int32_t)log2([column valueByteWidth]);
+			break;
+		case SPColumnarDecimalType:
+			convertedType = SPParquetConvertedTypeDecimal;
+			break;
+		case SPColumnarDateType:
+			convertedType = SPParquetConvertedTypeDate;
+			break;
+		case SPColumnarStringType:
+			convertedType = SPParquetConvertedTypeUTF8;
+			break;
+		default:
+			break;
+	}
+
+	if (convertedType != SPParquetConvertedTypeNone) SPThriftWriteI32Field(data, &field, 6, convertedType);
+
+	if (type == SPColumnarDecimalType) {
+		SPThriftWriteI32Field(data, &field, 7, (int32_t)[column scale]);
+		SPThriftWriteI32Field(data, &field, 8, (int32_t)[column precision]);
+	}
+
+	// SchemaElement.logicalType
+	switch (type)
+	{
+		case SPColumnarInt8Type:
+		case SPColumnarInt16Type:
+		case SPColumnarInt32Type:
+		case SPColumnarInt64Type:
+		case SPColumnarUInt8Type:
+		case SPColumnarUInt16Type:
+		case SPColumnarUInt32Type:
+		case SPColumnarUInt64Type:
+			SPThriftWriteFieldBegin(data, &field, 10, SPThriftTypeStruct);
+			SPThriftWriteFieldBegin(data, &logicalTypeField, SPParquetLogicalTypeInteger, SPThriftTypeStruct);
+			SPThriftWriteByteField(data, &logicalTypeValueField, 1, (int8_t)([column valueByteWidth] * 8));
+			SPThriftWriteBoolField(data, &logicalTypeValueField, 2, (type <= SPColumnarInt64Type));
+			break;
+		case SPColumnarDecimalType:
+			SPThriftWriteFieldBegin(data, &field, 10, SPThriftTypeStruct);
+			SPThriftWriteFieldBegin(data, &logicalTypeField, SPParquetLogicalTypeDecimal, SPThriftTypeStruct);
+			SPThriftWriteI32Field(data, &logicalTypeValueField, 1, (int32_t)[column scale]);
+			SPThriftWriteI32Field(data, &logicalTypeValueField, 2, (int32_t)[column precision]);
+			break;
+		case SPColumnarDateType:
+			SPThriftWriteFieldBegin(data, &field, 10, SPThriftTypeStruct);
+			SPThriftWriteFieldBegin(data, &logicalTypeField, SPParquetLogicalTypeDate, SPThriftTypeStruct);
+			break;
+		case SPColumnarTimestampType:
+		{
+			int16_t timeUnitField = 0;
+
+			// MySQL DATETIME values are local times, so aren't adjusted to UTC
+			SPThriftWriteFieldBegin(data, &field, 10, SPThriftTypeStruct);
+			SPThriftWriteFieldBegin(data, &logicalTypeField, SPParquetLogicalTypeTimestamp, SPThriftTypeStruct);
+			SPThriftWriteBoolField(data, &logicalTypeValueField, 1, NO);
+			SPThriftWriteFieldBegin(data, &logicalTypeValueField, 2, SPThriftTypeStruct);
+			SPThriftWriteFieldBegin(data, &timeUnitField, SPParquetTimeUnitMicros, SPThriftTypeStruct);
+			SPThriftWriteStructEnd(data);
+			SPThriftWriteStructEnd(data);
+			break;
+		}
+		case SPColumnarStringType:
+			SPThriftWriteFieldBegin(data, &field, 10, SPThriftTypeStruct);
+			SPThriftWriteFieldBegin(data, &logicalTypeField, SPParquetLogicalTypeString, SPThriftTypeStruct);
+			break;
+		default:
+			break;
+	}
+
+	// Close the logical type's value and the LogicalType union
+	if (logicalTypeField) {
+		SPThriftWriteStructEnd(data);
+		SPThriftWriteStructEnd(data);
+	}
+
+	SPThriftWriteStructEnd(data);
+}
+
+- (int32_t)_physicalTypeOfColumn:(SPColumnarColumn *)column
+{
+	switch ([column type])
+	{
+		case SPColumnarInt64Type:
+		case SPColumnarUInt64Type:
+		case SPColumnarTimestampType:
+			return SPParquetTypeInt64;
+		case SPColumnarFloatType:
+			return SPParquetTypeFloat;
+		case SPColumnarDoubleType:
+			return SPParquetTypeDouble;
+		case SPColumnarDecimalType:
+			return SPParquetTypeFixedLenByteArray;
+		case SPColumnarStringType:
+		case SPColumnarBinaryType:
+			return SPParquetTypeByteArray;
+		default:
+			return SPParquetTypeInt32;
+	}
+}
+
+@end
@@ -31,8 +31,12 @@
 #import "SPSQLExporter.h"
 #import "SPTablesList.h"
 #import "SPFileHandle.h"
+#import "SPExportRowPrefetcher.h"
 #import "SPExportUtilities.h"
 #import "SPExportFile.h"
+#import "SPExportCheckpoint.h"
+#import "SPExportMetadataCache.h"
+#import "SPTransferStatistics.h"
 #import "SPTableData.h"
 #import "RegexKitLite.h"
 #import "SPExportController.h"
@@ -44,6 +48,7 @@
 @interface SPSQLExporter ()
 
 - (NSString *)_createViewPlaceholderSyntaxForView:(NSString *)viewName;
+- (NSString *)_dumpFooterString;
 
 @end
 
@@ -94,6 +99,10 @@
     NSMutableString *sqlString  = [[NSMutableString alloc] init];
     NSString *oldSqlMode        = nil;
 
+    // If a checkpoint exists for the output file, anything before its byte offset has already been written
+    SPExportCheckpoint *checkpoint = [[self exportOutputFile] exportCheckpoint];
+    BOOL resumingExport = [checkpoint hasProgress];
+
     // Check that we have all the required info before starting the export
     if ((![self sqlExportTables])     || ([[self sqlExportTables] count] == 0)          ||
         (![self sqlDatabaseHost])     || ([[self sqlDatabaseHost] isEqualToString:@""]) ||
@@ -249,10 +258,48 @@
     [metaString appendString:@"/*!40101 SET @OLD_SQL_MODE='NO_AUTO_VALUE_ON_ZERO', SQL_MODE='NO_AUTO_VALUE_ON_ZERO' */;\n"];
     [metaString appendString:@"/*!40111 SET @OLD_SQL_NOTES=@@SQL_NOTES, SQL_NOTES=0 */;\n\n\n"];
 
-    [self writeString:metaString];
+    // Every part of a split export starts with the same header, so that each can be restored on its own
+    BOOL splitOutput = [[self exportOutputFile] splitsOutput];
+    NSString *partHeader = [metaString copy];
+
+    if (!resumingExport) {
+        [self writeString:metaString];
+
+        unsigned long long byteOffset = [[self exportOutputFile] synchronizedLength];
+
+        if ([self exportOutputFile].fileHandleError == nil) [checkpoint recordByteOffset:byteOffset];
+    }
 
     NSMutableDictionary *viewSyntaxes = [NSMutableDictionary dictionary];
 
+    // Retrieve the CREATE statements and triggers of all objects up front rather than one round trip at a time
+    SPExportMetadataCache *metadataCache = [[SPExportMetadataCache alloc] initWithConnection:connection database:[self sqlDatabaseName]];
+    NSMutableArray *prefetchTables = [NSMutableArray arrayWithCapacity:[tables count]];
+    NSMutableArray *prefetchProcs = [NSMutableArray arrayWithCapacity:[procs count]];
+    NSMutableArray *prefetchFuncs = [NSMutableArray arrayWithCapacity:[funcs count]];
+    BOOL exportsTriggers = NO;
+
+    for (NSArray *table in tables)
+    {
+        [prefetchTables addObject:[table firstObject]];
+
+        if ([[table safeObjectAtIndex:1] boolValue]) exportsTriggers = YES;
+    }
+
+    for (NSArray *item in procs)
+    {
+        if ([[item safeObjectAtIndex:1] boolValue]) [prefetchProcs addObject:[item firstObject]];
+    }
+
+    for (NSArray *item in funcs)
+    {
+        if ([[item safeObjectAtIndex:1] boolValue]) [prefetchFuncs addObject:[item firstObject]];
+    }
+
+    [metadataCache prefetchCreateStatementsForTables:prefetchTables procedures:prefetchProcs functions:prefetchFuncs forOperation:self];
+
+    if (exportsTriggers && [prefetchTables count] > 1) [metadataCache prefetchTriggers];
+
     // Loop through the selected tables
     for (NSArray *table in tables) {
         @autoreleasepool {
@@ -285,6 +332,9 @@
             // Set the current table
             [self setSqlExportCurrentTable:tableName];
 
+            [self beginTransferStatisticsForTable:tableName];
+            [self setExportProcessedRowCount:0];
+
             // Inform the delegate that we are about to start fetcihing data for the current table
             [delegate performSelectorOnMainThread:@selector(sqlExportProcessWillBeginFetchingData:) withObject:self waitUntilDone:NO];
 
@@ -294,13 +344,27 @@
             SPTableType tableType = SPTableTypeTable;
             // Determine whether this table is a table or a view via the CREATE TABLE command, and keep the create table syntax
             {
-                SPMySQLResult *queryResult = [connection queryString:[NSString stringWithFormat:@"SHOW CREATE TABLE %@", [tableName backtickQuotedString]] assertingDatabase:[self sqlDatabaseName]];
+                NSDictionary *tableDetails = [metadataCache createResultForTable:tableName];
+
+                if (!tableDetails) {
+                    SPMySQLResult *queryResult = [connection queryString:[NSString stringWithFormat:@"SHOW CREATE TABLE %@", [tableName backtickQuotedString]] assertingDatabase:[self sqlDatabaseName]];
 
-                [queryResult setReturnDataAsStrings:YES];
+                    [queryResult setReturnDataAsStrings:YES];
 
-                if ([queryResult numberOfRows]) {
-                    NSDictionary *tableDetails = [[NSDictionary alloc] initWithDictionary:[queryResult getRowAsDictionary]];
+                    if ([queryResult numberOfRows]) {
+                        tableDetails = [[NSDictionary alloc] initWithDictionary:[queryResult getRowAsDictionary]];
+                    }
+
+                    if ([connection queryErrored]) {
+                        [errors appendFormat:@"%@\n", [connection lastErrorMessage]];
+
+                        [self writeUTF8String:[NSString stringWithFormat:@"# Error: %@\n\n\n", [connection lastErrorMessage]]];
 
+                        continue;
+                    }
+                }
+
+                if (tableDetails) {
                     if ([tableDetails objectForKey:@"Create View"]) {
                         [viewSyntaxes
                             setValue: [NSString stringWithFormat:@"%@%@",
@@ -310,25 +374,37 @@
                         ];
                         createTableSyntax = [self _createViewPlaceholderSyntaxForView:tableName];
                         tableType = SPTableTypeView;
+
+                        if ([connection queryErrored]) {
+                            [errors appendFormat:@"%@\n", [connection lastErrorMessage]];
+
+                            [self writeUTF8String:[NSString stringWithFormat:@"# Error: %@\n\n\n", [connection lastErrorMessage]]];
+
+                            continue;
+                        }
                     }
                     else {
                         createTableSyntax = [[tableDetails objectForKey:@"Create Table"] copy];
                         tableType = SPTableTypeTable;
                     }
                 }
+            }
 
-                if ([connection queryErrored]) {
-                    [errors appendFormat:@"%@\n", [connection lastErrorMessage]];
+            // Tables completed before a resumed export was interrupted only need their view syntax collecting
+            if ([checkpoint isTableCompleted:tableName]) {
+                continue;
+            }
 
-                    [self writeUTF8String:[NSString stringWithFormat:@"# Error: %@\n\n\n", [connection lastErrorMessage]]];
+            // When resuming part way through a table, its structure and earlier rows precede the checkpoint
+            NSString *resumeKey = [checkpoint lastKeyForTable:tableName];
 
-                    continue;
-                }
+            if (resumeKey) {
+                sqlOutputIncludeStructure = NO;
+                sqlOutputIncludeDropSyntax = NO;
             }
 
 
-
-            if(tableType == SPTableTypeTable) {
+            if(tableType == SPTableTypeTable && !resumeKey) {
                 // Add the name of table
                 [self writeString:[NSString stringWithFormat:@"# %@ %@\n# ------------------------------------------------------------\n\n", NSLocalizedString(@"Dump of table", @"sql export dump of table label"), tableName]];
             }
@@ -353,12 +429,21 @@
 
                 [self writeUTF8String:createTableSyntax];
                 [self writeUTF8String:@";\n\n"];
+
+                [[self exportOutputFile] recordStructureForTable:tableName];
             }
 
             // Add the table content if required
             if (sqlOutputIncludeContent && (tableType == SPTableTypeTable)) {
                 // Retrieve the table details via the data class, and use it to build an array containing column numeric status
-                NSDictionary *tableDetails = [NSDictionary dictionaryWithDictionary:[sqlTableDataInstance informationForTable:tableName fromDatabase:[self sqlDatabaseName]]];
+                // Parse the CREATE syntax retrieved above rather than having the table data query it again
+                NSDictionary *parsedTableDetails = nil;
+
+                if ([createTableSyntax isKindOfClass:[NSString class]] && ![[self sqlDatabaseName] isEqualToString:SPMySQLInformationSchemaDatabase]) {
+                    parsedTableDetails = [sqlTableDataInstance informationForTable:tableName fromCreateSyntax:createTableSyntax ofType:@"Table"];
+                }
+
+                NSDictionary *tableDetails = [NSDictionary dictionaryWithDictionary:parsedTableDetails ?: [sqlTableDataInstance informationForTable:tableName fromDatabase:[self sqlDatabaseName]]];
 
                 NSUInteger colCount = [[tableDetails objectForKey:@"columns"] count];
                 NSUInteger colCountRetained = colCount;
@@ -434,46 +519,56 @@
                     }
                 }
 
-                // Retrieve the number of rows in the table for progress bar drawing
-                NSArray *rowArray = [[connection queryString:[NSString stringWithFormat:@"SELECT COUNT(1) FROM %@", [tableName backtickQuotedString]] assertingDatabase:[self sqlDatabaseName]] getRowAsArray];
+                // Draw progress against the server's estimate of the number of rows, as an exact COUNT(1) scans the whole table
+                NSUInteger rowCount = [self estimatedRowCountForTable:tableName inDatabase:[self sqlDatabaseName]];
 
-                if ([connection queryErrored] || ![rowArray count]) {
-                    [errors appendFormat:@"%@\n", [connection lastErrorMessage]];
-                    [self writeUTF8String:[NSString stringWithFormat:@"# Error: %@\n\n\n", [connection lastErrorMessage]]];
-                    free(useRawDataForColumnAtIndex);
-                    free(useRawHexDataForColumnAtIndex);
-                    continue;
+                // Walk tables with a single column primary key in key ordered chunks if requested; each chunk is a
+                // short query, and the output can be checkpointed between chunks so the export can be resumed
+                NSUInteger chunkKeyIndex = NSNotFound;
+                NSArray *primaryKeyFields = [tableDetails objectForKey:@"primarykeyfield"];
+
+                if ([self exportChunkRowCount] && [primaryKeyFields count] == 1) {
+                    chunkKeyIndex = [rawColumnNames indexOfObject:[primaryKeyFields firstObject]];
                 }
 
-                NSUInteger rowCount = [[rowArray firstObject] integerValue];
+                BOOL exportInChunks = (chunkKeyIndex != NSNotFound);
+                NSString *chunkLastKey = exportInChunks ? resumeKey : nil;
+                NSUInteger rowsFetchedForChunk = 0;
 
-                if (rowCount) {
-                    // Set up a result set in streaming mode
-                    SPMySQLStreamingResult *streamingResult = [connection streamingQueryString:[NSString stringWithFormat:@"SELECT %@ FROM %@", [queryColumnDetails componentsJoinedByString:@", "], [tableName backtickQuotedString]] useLowMemoryBlockingStreaming:([self exportUsingLowMemoryBlockingStreaming]) assertingDatabase:[self sqlDatabaseName]];
+                // Inform the delegate that we are about to start writing data for the current table
+                [delegate performSelectorOnMainThread:@selector(sqlExportProcessWillBeginWritingData:) withObject:self waitUntilDone:NO];
 
-                    // Inform the delegate that we are about to start writing data for the current table
-                    [delegate performSelectorOnMainThread:@selector(sqlExportProcessWillBeginWritingData:) withObject:self waitUntilDone:NO];
+                NSUInteger queryLength = 0;
 
-                    NSUInteger queryLength = 0;
+                // The table is locked once its first row has been fetched, so nothing is written for empty tables;
+                // when resuming the lock was written before the checkpoint
+                BOOL tableIsLocked = (chunkLastKey != nil);
 
-                    // Lock the table for writing and disable keys if supported
-                    [metaString setString:@""];
-                    [metaString appendFormat:@"LOCK TABLES %@ WRITE;\n/*!40000 ALTER TABLE %@ DISABLE KEYS */;\n\n", [tableName backtickQuotedString], [tableName backtickQuotedString]];
+                // Iterate through the rows to construct a VALUES group for each
+                NSUInteger rowsWrittenForTable = 0;
+                NSUInteger rowsWrittenForCurrentStmt = 0;
+                BOOL insertStatementIsOpen = NO;
+
+                do {
+                    NSString *selectString = [NSString stringWithFormat:@"SELECT %@ FROM %@", [queryColumnDetails componentsJoinedByString:@", "], [tableName backtickQuotedString]];
 
-                    [self writeString:metaString];
+                    if (exportInChunks) {
+                        selectString = [self chunkQueryForColumns:[queryColumnDetails componentsJoinedByString:@", "] fromTable:tableName orderedByKey:[primaryKeyFields firstObject] afterKey:chunkLastKey];
+                    }
+
+                    // Set up a result set in streaming mode
+                    SPMySQLStreamingResult *streamingResult = [connection streamingQueryString:selectString useLowMemoryBlockingStreaming:([self exportUsingLowMemoryBlockingStreaming]) assertingDatabase:[self sqlDatabaseName]];
 
-                    // Construct the start of the insertion command
-                    [self writeUTF8String:[NSString stringWithFormat:@"INSERT INTO %@ (%@)\nVALUES", [tableName backtickQuotedString], [rawColumnNames componentsJoinedAndBacktickQuoted]]];
+                    // Fetch rows on a background thread while this one encodes them
+                    SPExportRowPrefetcher *rowPrefetcher = [self rowPrefetcherForStreamingResult:streamingResult];
 
-                    // Iterate through the rows to construct a VALUES group for each
-                    NSUInteger rowsWrittenForTable = 0;
-                    NSUInteger rowsWrittenForCurrentStmt = 0;
+                    rowsFetchedForChunk = 0;
 
                     // Inform the delegate that we are about to start writing the data to disk
                     [delegate performSelectorOnMainThread:@selector(sqlExportProcessWillBeginWritingData:) withObject:self waitUntilDone:NO];
 
                     NSArray *row;
-                    while ((row = [streamingResult getRowAsArray]))
+                    while ((row = [rowPrefetcher getRowAsArray]))
                     {
 
                         if(self.exportOutputFile.fileHandleError != nil){
@@ -486,7 +581,7 @@
                         // Check for cancellation flag
                         if ([self isCancelled]) {
                             [connection cancelCurrentQuery];
-                            [streamingResult cancelResultLoad];
+                            [rowPrefetcher cancelResultLoad];
                             free(useRawDataForColumnAtIndex);
                             free(useRawHexDataForColumnAtIndex);
 
@@ -494,8 +589,48 @@
                             return;
                         }
 
+                        // Roll over to the next part between statements once the current one is full, releasing
+                        // the table lock and restoring the session settings so that each part is self-contained
+                        if (splitOutput && tableIsLocked && [[self exportOutputFile] currentPartIsFull]) {
+                            if (insertStatementIsOpen) {
+                                [self writeUTF8String:@";\n\n"];
+                                insertStatementIsOpen = NO;
+                            }
+
+                            [self writeUTF8String:[NSString stringWithFormat:@"/*!40000 ALTER TABLE %@ ENABLE KEYS */;\nUNLOCK TABLES;\n", [tableName backtickQuotedString]]];
+                            [self writeUTF8String:[self _dumpFooterString]];
+
+                            // Without a new part there is nowhere to write the remaining rows, so abort the export
+                            if (![[self exportOutputFile] startNextPart]) {
+                                [connection cancelCurrentQuery];
+                                [rowPrefetcher cancelResultLoad];
+                                free(useRawDataForColumnAtIndex);
+                                free(useRawHexDataForColumnAtIndex);
+
+                                SPMainQSync(^{
+                                    [(SPExportController*)self->delegate cancelExportForFile:(self->exportOutputFile.fileHandleError ?: self->exportOutputFile.exportFilePath)];
+                                });
+                                [self endCleanup:oldSqlMode];
+                                return;
+                            }
+
+                            [self writeString:partHeader];
+
+                            tableIsLocked = NO;
+                        }
+
+                        // Lock the table for writing and disable keys if supported
+                        if (!tableIsLocked) {
+                            [metaString setString:@""];
+                            [metaString appendFormat:@"LOCK TABLES %@ WRITE;\n/*!40000 ALTER TABLE %@ DISABLE KEYS */;\n\n", [tableName backtickQuotedString], [tableName backtickQuotedString]];
+
+                            [self writeString:metaString];
+
+                            tableIsLocked = YES;
+                        }
+
                         // Update the progress
-                        NSUInteger progress = (NSUInteger)((rowsWrittenForTable + 1) * ([self exportMaxProgress] / rowCount));
+                        NSUInteger progress = (NSUInteger)[self exportProgressForProcessedRowCount:(rowsWrittenForTable + 1) ofEstimatedRowCount:rowCount];
 
                         if (progress > lastProgressValue) {
                             [self setExportProgressValue:progress];
@@ -507,7 +642,18 @@
 
                         // Set up the new row as appropriate.  If a new INSERT statement should be created,
                         // set one up; otherwise, set up a new row
-                        if ((([self sqlInsertDivider] == SPSQLInsertEveryNDataBytes) && (queryLength >= ([self sqlInsertAfterNValue] * 1024))) ||
+                        if (!insertStatementIsOpen) {
+                            [sqlString setString:@"INSERT INTO "];
+                            [sqlString appendString:[tableName backtickQuotedString]];
+                            [sqlString appendString:@" ("];
+                            [sqlString appendString:[rawColumnNames componentsJoinedAndBacktickQuoted]];
+                            [sqlString appendString:@")\nVALUES\n\t("];
+
+                            insertStatementIsOpen = YES;
+                            queryLength = 0;
+                            rowsWrittenForCurrentStmt = 0;
+                        }
+                        else if ((([self sqlInsertDivider] == SPSQLInsertEveryNDataBytes) && (queryLength >= ([self sqlInsertAfterNValue] * 1024))) ||
                             (([self sqlInsertDivider] == SPSQLInsertEveryNRows) && (rowsWrittenForCurrentStmt == [self sqlInsertAfterNValue])))
                         {
                             [sqlString setString:@";\n\nINSERT INTO "];
@@ -519,9 +665,6 @@
                             queryLength = 0;
                             rowsWrittenForCurrentStmt = 0;
                         }
-                        else if (rowsWrittenForTable == 0) {
-                            [sqlString setString:@"\n\t("];
-                        }
                         else {
                             [sqlString setString:@",\n\t("];
                         }
@@ -604,18 +747,63 @@
 
                         rowsWrittenForTable++;
                         rowsWrittenForCurrentStmt++;
+
+                        if (splitOutput) [[self exportOutputFile] recordRows:1 forTable:tableName];
+
+                        [self setExportProcessedRowCount:rowsWrittenForTable];
+                        rowsFetchedForChunk++;
+
+                        // Remember the key of the last row written so the next chunk can continue after it
+                        if (exportInChunks) {
+                            chunkLastKey = [self chunkKeyLiteralForValue:[row safeObjectAtIndex:chunkKeyIndex] isNumeric:useRawDataForColumnAtIndex[chunkKeyIndex] isHex:useRawHexDataForColumnAtIndex[chunkKeyIndex]];
+                        }
                     }
 
-                    // Complete the command
+                    [self logStageUtilisationForRowPrefetcher:rowPrefetcher];
+
+                    if (!exportInChunks) break;
+
+                    // A failed chunk leaves the output at the previous checkpoint; stop so the export can be resumed from there
+                    if ([connection queryErrored]) {
+                        if (!checkpoint) break;
+
+                        NSString *errorMessage = [connection lastErrorMessage];
+
+                        free(useRawDataForColumnAtIndex);
+                        free(useRawHexDataForColumnAtIndex);
+
+                        SPMainQSync(^{
+                            [(SPExportController*)self->delegate interruptExportWithError:errorMessage];
+                        });
+
+                        [self endCleanup:oldSqlMode];
+                        return;
+                    }
+
+                    // Complete the command at the end of each chunk, so the checkpoint never falls within a statement
+                    if (insertStatementIsOpen) {
+                        [self writeUTF8String:@";\n\n"];
+                        insertStatementIsOpen = NO;
+
+                        // Only data that reached the disk can be resumed from
+                        unsigned long long byteOffset = [[self exportOutputFile] synchronizedLength];
+
+                        if ([self exportOutputFile].fileHandleError == nil) [checkpoint recordLastKey:chunkLastKey forTable:tableName atByteOffset:byteOffset];
+                    }
+                }
+                while (rowsFetchedForChunk == [self exportChunkRowCount]);
+
+                // Complete the command
+                if (insertStatementIsOpen) {
                     [self writeUTF8String:@";\n\n"];
+                }
 
-                    // Unlock the table and re-enable keys if supported
+                // Unlock the table and re-enable keys if supported
+                if (tableIsLocked) {
                     [metaString setString:@""];
                     [metaString appendFormat:@"/*!40000 ALTER TABLE %@ ENABLE KEYS */;\nUNLOCK TABLES;\n", [tableName backtickQuotedString]];
 
                     [self writeUTF8String:metaString];
-
-                    // Release the result set
                 }
 
                 free(useRawDataForColumnAtIndex);
@@ -631,17 +819,38 @@
             }
 
             // Add triggers if the structure export was enabled
-            if (sqlOutputIncludeStructure) {
-                SPMySQLResult *queryResult = [connection queryString:[NSString stringWithFormat:@"/*!50003 SHOW TRIGGERS WHERE `Table` = %@ */", [tableName tickQuotedString]] assertingDatabase:[self sqlDatabaseName]];
+            if ([[table safeObjectAtIndex:1] boolValue]) {
+                NSArray *triggerRows = [metadataCache triggersForTable:tableName];
 
-                [queryResult setReturnDataAsStrings:YES];
+                if (!triggerRows) {
+                    SPMySQLResult *queryResult = [connection queryString:[NSString stringWithFormat:@"/*!50003 SHOW TRIGGERS WHERE `Table` = %@ */", [tableName tickQuotedString]] assertingDatabase:[self sqlDatabaseName]];
 
-                if ([queryResult numberOfRows]) {
+                    [queryResult setReturnDataAsStrings:YES];
+
+                    NSMutableArray *queriedTriggerRows = [NSMutableArray arrayWithCapacity:(NSUInteger)[queryResult numberOfRows]];
+
+                    for (NSUInteger s = 0; s < [queryResult numberOfRows]; s++)
+                    {
+                        [queriedTriggerRows addObject:[queryResult getRowAsDictionary]];
+                    }
+
+                    triggerRows = queriedTriggerRows;
+
+                    if ([connection queryErrored]) {
+                        [errors appendFormat:@"%@\n", [connection lastErrorMessage]];
+
+                        if ([self sqlOutputIncludeErrors]) {
+                            [self writeUTF8String:[NSString stringWithFormat:@"# Error: %@\n", [connection lastErrorMessage]]];
+                        }
+                    }
+                }
+
+                if ([triggerRows count]) {
 
                     [metaString setString:@"\n"];
                     [metaString appendString:@"DELIMITER ;;\n"];
 
-                    for (NSUInteger s = 0; s < [queryResult numberOfRows]; s++)
+                    for (NSDictionary *triggers in triggerRows)
                     {
 
                         if(self.exportOutputFile.fileHandleError != nil){
@@ -657,8 +866,6 @@
                             return;
                         }
 
-                        NSDictionary *triggers = [[NSDictionary alloc] initWithDictionary:[queryResult getRowAsDictionary]];
-
                         // Definer is user@host but we need to escape it to `user`@`host`
                         NSArray *triggersDefiner = [[triggers objectForKey:@"Definer"] componentsSeparatedByString:@"@"];
 
@@ -677,18 +884,16 @@
 
                     [self writeUTF8String:metaString];
                 }
-
-                if ([connection queryErrored]) {
-                    [errors appendFormat:@"%@\n", [connection lastErrorMessage]];
-
-                    if ([self sqlOutputIncludeErrors]) {
-                        [self writeUTF8String:[NSString stringWithFormat:@"# Error: %@\n", [connection lastErrorMessage]]];
-                    }
-                }
             }
 
             // Add an additional separator between tables
             [self writeUTF8String:@"\n\n"];
+
+            unsigned long long byteOffset = [[self exportOutputFile] synchronizedLength];
+
+            if ([self exportOutputFile].fileHandleError == nil) [checkpoint recordCompletedTable:tableName atByteOffset:byteOffset];
+
+            [self endTransferStatisticsForTable];
         }
     }
 
@@ -827,19 +1032,23 @@
                                                 [[procedureDefiner firstObject] backtickQuotedString],
                                                 [[procedureDefiner safeObjectAtIndex:1] backtickQuotedString]];
 
-                    SPMySQLResult *createProcedureResult = [connection queryString:[NSString stringWithFormat:@"/*!50003 SHOW CREATE %@ %@ */", procedureType,
-                                                                                    [procedureName backtickQuotedString]] assertingDatabase:[self sqlDatabaseName]];
-                    [createProcedureResult setReturnDataAsStrings:YES];
-                    if ([connection queryErrored]) {
-                        [errors appendFormat:@"%@\n", [connection lastErrorMessage]];
+                    NSDictionary *procedureInfo = [metadataCache createResultForRoutine:procedureName ofType:procedureType];
 
-                        if ([self sqlOutputIncludeErrors]) {
-                            [self writeUTF8String:[NSString stringWithFormat:@"# Error: %@\n", [connection lastErrorMessage]]];
+                    if (!procedureInfo) {
+                        SPMySQLResult *createProcedureResult = [connection queryString:[NSString stringWithFormat:@"/*!50003 SHOW CREATE %@ %@ */", procedureType,
+                                                                                        [procedureName backtickQuotedString]] assertingDatabase:[self sqlDatabaseName]];
+                        [createProcedureResult setReturnDataAsStrings:YES];
+                        if ([connection queryErrored]) {
+                            [errors appendFormat:@"%@\n", [connection lastErrorMessage]];
+
+                            if ([self sqlOutputIncludeErrors]) {
+                                [self writeUTF8String:[NSString stringWithFormat:@"# Error: %@\n", [connection lastErrorMessage]]];
+                            }
+                            continue;
                         }
-                        continue;
-                    }
 
-                    NSDictionary *procedureInfo = [[NSDictionary alloc] initWithDictionary:[createProcedureResult getRowAsDictionary]];
+                        procedureInfo = [[NSDictionary alloc] initWithDictionary:[createProcedureResult getRowAsDictionary]];
+                    }
 
                     [metaString appendFormat:@"/*!50003 SET SESSION SQL_MODE=\"%@\"*/;;\n", [procedureInfo objectForKey:@"sql_mode"]];
 
@@ -883,26 +1092,38 @@
         }
     }
 
-    // Restore unique checks, foreign key checks, and other settings saved at the start
-    [metaString setString:@"\n"];
-    [metaString appendString:@"/*!40111 SET SQL_NOTES=@OLD_SQL_NOTES */;\n"];
-    [metaString appendString:@"/*!40101 SET SQL_MODE=@OLD_SQL_MODE */;\n"];
-    [metaString appendString:@"/*!40014 SET FOREIGN_KEY_CHECKS=@OLD_FOREIGN_KEY_CHECKS */;\n"];
-
-    // Restore the client encoding to the original encoding before import
-    [metaString appendString:@"/*!40101 SET CHARACTER_SET_CLIENT=@OLD_CHARACTER_SET_CLIENT */;\n"];
-    [metaString appendString:@"/*!40101 SET CHARACTER_SET_RESULTS=@OLD_CHARACTER_SET_RESULTS */;\n"];
-    [metaString appendString:@"/*!40101 SET COLLATION_CONNECTION=@OLD_COLLATION_CONNECTION */;\n"];
-
     // Write footer-type information to the file
-    [self writeUTF8String:metaString];
+    [self writeUTF8String:[self _dumpFooterString]];
 
     // Set export errors
     [self setSqlExportErrors:errors];
 
+    // Each failed statement adds a line to the errors
+    if ([self transferStatistics] && [errors length]) {
+        __block uint64_t errorCount = 0;
+
+        [errors enumerateLinesUsingBlock:^(NSString *line, BOOL *stop) {
+            if ([line length]) errorCount++;
+        }];
+
+        [[self transferStatistics] addStatements:0 errors:errorCount];
+    }
+
     // Close the file
     [[self exportOutputFile] close];
 
+    // Writing the end of the file may still have failed, in which case the export isn't complete
+    if(self.exportOutputFile.fileHandleError != nil){
+        SPMainQSync(^{
+            [(SPExportController*)self->delegate cancelExportForFile:self->exportOutputFile.exportFilePath];
+        });
+        [self endCleanup:oldSqlMode];
+        return;
+    }
+
+    // The export is complete, so there is nothing left to resume
+    [checkpoint removeManifest];
+
     // Mark the process as not running
     [self setExportProcessIsRunning:NO];
 
@@ -928,6 +1149,28 @@
     return ([[self sqlExportErrors] length] != 0);
 }
 
+/**
+ * Returns the dump footer, which restores unique checks, foreign key checks, the client encoding
+ * and other settings saved by the dump header.
+ *
+ * @return The footer statements
+ */
+- (NSString *)_dumpFooterString
+{
+    NSMutableString *footer = [NSMutableString stringWithString:@"\n"];
+
+    [footer appendString:@"/*!40111 SET SQL_NOTES=@OLD_SQL_NOTES */;\n"];
+    [footer appendString:@"/*!40101 SET SQL_MODE=@OLD_SQL_MODE */;\n"];
+    [footer appendString:@"/*!40014 SET FOREIGN_KEY_CHECKS=@OLD_FOREIGN_KEY_CHECKS */;\n"];
+
+    // Restore the client encoding to the original encoding before import
+    [footer appendString:@"/*!40101 SET CHARACTER_SET_CLIENT=@OLD_CHARACTER_SET_CLIENT */;\n"];
+    [footer appendString:@"/*!40101 SET CHARACTER_SET_RESULTS=@OLD_CHARACTER_SET_RESULTS */;\n"];
+    [footer appendString:@"/*!40101 SET COLLATION_CONNECTION=@OLD_COLLATION_CONNECTION */;\n"];
+
+    return footer;
+}
+
 /**
  * Retrieve information for a view and use that to construct a CREATE TABLE string for an equivalent basic
  * table. Allows the construction of placeholder tables to resolve view interdependencies within dumps.
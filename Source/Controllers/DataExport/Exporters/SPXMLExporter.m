@@ -31,11 +31,22 @@
 #import "SPXMLExporter.h"
 #import "SPExportFile.h"
 #import "SPFileHandle.h"
+#import "SPExportRowPrefetcher.h"
+#import "SPXMLRowEncoder.h"
 #import "SPExportUtilities.h"
 #import "SPExportController.h"
 #import "SPFunctions.h"
 #import <SPMySQL/SPMySQL.h>
 
+// The size at which the rows buffered by the row encoder are written to the export file
+static const NSUInteger SPXMLExportWriteBufferSize = 1024 * 1024;
+
+@interface SPXMLExporter ()
+
+- (void)_writeEncodedRows:(SPXMLRowEncoder *)encoder;
+
+@end
+
 @implementation SPXMLExporter
 
 @synthesize delegate;
@@ -76,6 +87,8 @@
     SPMySQLResult *statusResult = nil;
     SPMySQLResult *structureResult = nil;
     SPMySQLFastStreamingResult *streamingResult = nil;
+    SPExportRowPrefetcher *rowPrefetcher = nil;
+    SPXMLRowEncoder *rowEncoder = nil;
 
     NSMutableArray *xmlTags    = [NSMutableArray array];
     NSMutableString *xmlString = [NSMutableString string];
@@ -107,8 +120,11 @@
         isTableExport = YES;
         NSString *exportDatabaseName = [self databaseName];
 
-        totalRows       = [[connection getFirstFieldFromQuery:[NSString stringWithFormat:@"SELECT COUNT(1) FROM %@", [[self xmlTableName] backtickQuotedString]] assertingDatabase:exportDatabaseName] integerValue];
+        [self beginTransferStatisticsForTable:[self xmlTableName]];
+
+        totalRows       = [self estimatedRowCountForTable:[self xmlTableName] inDatabase:exportDatabaseName];
         streamingResult = [connection streamingQueryString:[NSString stringWithFormat:@"SELECT * FROM %@", [[self xmlTableName] backtickQuotedString]] useLowMemoryBlockingStreaming:[self exportUsingLowMemoryBlockingStreaming] assertingDatabase:exportDatabaseName];
+        rowPrefetcher = [self rowPrefetcherForStreamingResult:streamingResult];
 
         // Only include the structure if necessary
         if (([self xmlFormat] == SPXMLExportMySQLFormat) && [self xmlOutputIncludeStructure]) {
@@ -169,14 +185,23 @@
     // Only proceed to export the content if this is not a table export or it is and include content is selected
     if ((!isTableExport) || (isTableExport && [self xmlOutputIncludeContent])) {
 
-        // Set up an array of encoded field names as opening and closing tags
         fieldNames = ([self xmlDataArray]) ?  [[self xmlDataArray] firstObject] : [streamingResult fieldNames];
-        for (i = 0; i < [fieldNames count]; i++)
-        {
-            [xmlTags addObject:[NSMutableArray array]];
 
-            [[xmlTags safeObjectAtIndex:i] addObject:[NSString stringWithFormat:@"\t\t<%@>", [[[fieldNames safeObjectAtIndex:i] description] HTMLEscapeString]]];
-            [[xmlTags safeObjectAtIndex:i] addObject:[NSString stringWithFormat:@"</%@>\n", [[[fieldNames safeObjectAtIndex:i] description] HTMLEscapeString]]];
+        // When writing UTF-8, encode the rows straight into a byte buffer with the tags rendered once per column
+        if ([self exportOutputEncoding] == NSUTF8StringEncoding) {
+            rowEncoder = [[SPXMLRowEncoder alloc] initWithFieldNames:fieldNames format:[self xmlFormat] nullString:[self xmlNULLString]];
+
+            [rowEncoder setDataEncoding:[self exportOutputEncoding]];
+        }
+        // Otherwise set up an array of encoded field names as opening and closing tags
+        else {
+            for (i = 0; i < [fieldNames count]; i++)
+            {
+                [xmlTags addObject:[NSMutableArray array]];
+
+                [[xmlTags safeObjectAtIndex:i] addObject:[NSString stringWithFormat:@"\t\t<%@>", [[[fieldNames safeObjectAtIndex:i] description] HTMLEscapeString]]];
+                [[xmlTags safeObjectAtIndex:i] addObject:[NSString stringWithFormat:@"</%@>\n", [[[fieldNames safeObjectAtIndex:i] description] HTMLEscapeString]]];
+            }
         }
 
         // If required, write an opening tag in the form of the table name
@@ -195,131 +220,143 @@
 
         while (1)
         {
+            @autoreleasepool {
 
-            if(self.exportOutputFile.fileHandleError != nil){
-                SPMainQSync(^{
-                    [(SPExportController*)self->delegate cancelExportForFile:self->exportOutputFile.exportFilePath];
-                });
-                return;
-            }
-            
-            // Check for cancellation flag
-            if ([self isCancelled]) {
-                if (streamingResult) {
-                    [connection cancelCurrentQuery];
-                    [streamingResult cancelResultLoad];
-                }
-
-                return;
-            }
-
-            // Retrieve the next row from the supplied data, either directly from the array...
-            if ([self xmlDataArray]) {
-                xmlRow = [[self xmlDataArray] safeObjectAtIndex:currentRowIndex];
-            }
-            // Or by reading an appropriate row from the streaming result
-            else {
-                xmlRow = [streamingResult getRowAsArray];
-
-                if (!xmlRow) break;
-            }
-
-            // Get the cell count if we don't already have it stored
-            if (!xmlRowCount) xmlRowCount = [xmlRow count];
-
-            // Construct the row
-            [xmlString setString:@"\t<row>\n"];
-
-            for (i = 0; i < xmlRowCount; i++)
-            {
                 if(self.exportOutputFile.fileHandleError != nil){
                     SPMainQSync(^{
                         [(SPExportController*)self->delegate cancelExportForFile:self->exportOutputFile.exportFilePath];
                     });
                     return;
                 }
-                
+            
                 // Check for cancellation flag
                 if ([self isCancelled]) {
                     if (streamingResult) {
                         [connection cancelCurrentQuery];
-                        [streamingResult cancelResultLoad];
+                        [rowPrefetcher cancelResultLoad];
                     }
+
                     return;
                 }
 
-                BOOL dataIsNULL = NO;
-                id data = [xmlRow safeObjectAtIndex:i];
-
-                // Retrieve the contents of this tag
-                if ([data isKindOfClass:[NSData class]]) {
-                    dataConversionString = [[NSString alloc] initWithData:data encoding:[self exportOutputEncoding]];
-
-                    if (dataConversionString == nil) {
-                        dataConversionString = [[NSString alloc] initWithData:data encoding:NSASCIIStringEncoding];
-                    }
+                // Retrieve the next row from the supplied data, either directly from the array...
+                if ([self xmlDataArray]) {
+                    xmlRow = [[self xmlDataArray] safeObjectAtIndex:currentRowIndex];
+                }
+                // Or by reading an appropriate row from the streaming result
+                else {
+                    xmlRow = [rowPrefetcher getRowAsArray];
 
-                    [xmlItem setString:[NSString stringWithString:dataConversionString]];
+                    if (!xmlRow) break;
                 }
 
-                // Check for null value using a pointer comparison; as [NSNull null] is a singleton this works correctly.
-                else if (data == [NSNull null]) {
-                    dataIsNULL = YES;
+                if (rowEncoder) {
+                    [rowEncoder appendRow:xmlRow];
 
-                    if ([self xmlFormat] == SPXMLExportPlainFormat) {
-                        [xmlItem setString:[self xmlNULLString]];
-                    }
-                }
-                else if ([data isKindOfClass:[SPMySQLGeometryData class]]) {
-                    [xmlItem setString:[data wktString]];
+                    if ([rowEncoder length] >= SPXMLExportWriteBufferSize) [self _writeEncodedRows:rowEncoder];
                 }
                 else {
-                    [xmlItem setString:[data description]];
-                }
+                    // Get the cell count if we don't already have it stored
+                    if (!xmlRowCount) xmlRowCount = [xmlRow count];
+
+                    // Construct the row
+                    [xmlString setString:@"\t<row>\n"];
+
+                    for (i = 0; i < xmlRowCount; i++)
+                    {
+                        if(self.exportOutputFile.fileHandleError != nil){
+                            SPMainQSync(^{
+                                [(SPExportController*)self->delegate cancelExportForFile:self->exportOutputFile.exportFilePath];
+                            });
+                            return;
+                        }
+                
+                        // Check for cancellation flag
+                        if ([self isCancelled]) {
+                            if (streamingResult) {
+                                [connection cancelCurrentQuery];
+                                [rowPrefetcher cancelResultLoad];
+                            }
+                            return;
+                        }
+
+                        BOOL dataIsNULL = NO;
+                        id data = [xmlRow safeObjectAtIndex:i];
+
+                        // Retrieve the contents of this tag
+                        if ([data isKindOfClass:[NSData class]]) {
+                            dataConversionString = [[NSString alloc] initWithData:data encoding:[self exportOutputEncoding]];
+
+                            if (dataConversionString == nil) {
+                                dataConversionString = [[NSString alloc] initWithData:data encoding:NSASCIIStringEncoding];
+                            }
+
+                            [xmlItem setString:[NSString stringWithString:dataConversionString]];
+                        }
+
+                        // Check for null value using a pointer comparison; as [NSNull null] is a singleton this works correctly.
+                        else if (data == [NSNull null]) {
+                            dataIsNULL = YES;
+
+                            if ([self xmlFormat] == SPXMLExportPlainFormat) {
+                                [xmlItem setString:[self xmlNULLString]];
+                            }
+                        }
+                        else if ([data isKindOfClass:[SPMySQLGeometryData class]]) {
+                            [xmlItem setString:[data wktString]];
+                        }
+                        else {
+                            [xmlItem setString:[data description]];
+                        }
+
+                        if ([self xmlFormat] == SPXMLExportMySQLFormat) {
+                            [xmlString appendFormat:@"\t\t<field name=\"%@\"", [[[fieldNames safeObjectAtIndex:i] description] HTMLEscapeString]];
+
+                            if (dataIsNULL) {
+                                [xmlString appendString:@" xsi:nil=\"true\" />\n"];
+                            }
+                            else {
+                                [xmlString appendFormat:@">%@</field>\n", [xmlItem XMLEscapeStringForContent]];
+                            }
+                        }
+                        else if ([self xmlFormat] == SPXMLExportPlainFormat) {
+                            // Add the opening and closing tag and the contents to the XML string
+                            [xmlString appendString:[[xmlTags safeObjectAtIndex:i] firstObject]];
+                            [xmlString appendString:[xmlItem XMLEscapeStringForContent]];
+                            [xmlString appendString:[[xmlTags safeObjectAtIndex:i] safeObjectAtIndex:1]];
+                        }
+                    }
 
-                if ([self xmlFormat] == SPXMLExportMySQLFormat) {
-                    [xmlString appendFormat:@"\t\t<field name=\"%@\"", [[[fieldNames safeObjectAtIndex:i] description] HTMLEscapeString]];
+                    [xmlString appendString:@"\t</row>\n\n"];
 
-                    if (dataIsNULL) {
-                        [xmlString appendString:@" xsi:nil=\"true\" />\n"];
-                    }
-                    else {
-                        [xmlString appendFormat:@">%@</field>\n", [xmlItem XMLEscapeStringForContent]];
-                    }
-                }
-                else if ([self xmlFormat] == SPXMLExportPlainFormat) {
-                    // Add the opening and closing tag and the contents to the XML string
-                    [xmlString appendString:[[xmlTags safeObjectAtIndex:i] firstObject]];
-                    [xmlString appendString:[xmlItem XMLEscapeStringForContent]];
-                    [xmlString appendString:[[xmlTags safeObjectAtIndex:i] safeObjectAtIndex:1]];
+                    // Write the row to the filehandle
+                    [self writeString:xmlString];
                 }
-            }
 
-            [xmlString appendString:@"\t</row>\n\n"];
+                // Update the progress counter and progress bar
+                currentRowIndex++;
 
-            // Write the row to the filehandle
-            [self writeString:xmlString];
+                [self setExportProcessedRowCount:([self xmlDataArray] ? currentRowIndex - 1 : currentRowIndex)];
 
-            // Update the progress counter and progress bar
-            currentRowIndex++;
+                // Update the progress
+                double progress = [self exportProgressForProcessedRowCount:currentRowIndex ofEstimatedRowCount:totalRows];
 
-            // Update the progress
-            if (totalRows && (currentRowIndex * ([self exportMaxProgress] / totalRows)) > lastProgressValue) {
+                if (progress > lastProgressValue) {
+                    [self setExportProgressValue:progress];
 
-                double progress = (currentRowIndex * ([self exportMaxProgress] / totalRows));
+                    lastProgressValue = progress;
+                }
 
-                [self setExportProgressValue:progress];
+                // Inform the delegate that the export's progress has been updated
+                [delegate performSelectorOnMainThread:@selector(xmlExportProcessProgressUpdated:) withObject:self waitUntilDone:NO];
 
-                lastProgressValue = progress;
+                // If an array was supplied and we've processed all rows, break
+                if ([self xmlDataArray] && totalRows == currentRowIndex) break;
             }
-
-            // Inform the delegate that the export's progress has been updated
-            [delegate performSelectorOnMainThread:@selector(xmlExportProcessProgressUpdated:) withObject:self waitUntilDone:NO];
-
-            // If an array was supplied and we've processed all rows, break
-            if ([self xmlDataArray] && totalRows == currentRowIndex) break;
         }
 
+        [self _writeEncodedRows:rowEncoder];
+
         if (([self xmlFormat] == SPXMLExportMySQLFormat) && isTableExport) {
             [self writeString:@"\t</table_data>\n\n"];
         }
@@ -331,6 +368,8 @@
     // Write data to disk
     [[[self exportOutputFile] exportFileHandle] synchronizeFile];
 
+    [self endTransferStatisticsForTable];
+
     // Mark the process as not running
     [self setExportProcessIsRunning:NO];
 
@@ -338,4 +377,22 @@
     [delegate performSelectorOnMainThread:@selector(xmlExportProcessComplete:) withObject:self waitUntilDone:NO];
 }
 
+#pragma mark -
+#pragma mark Private API
+
+/**
+ * Writes the rows buffered by the encoder to the export file and empties the buffer. The file handle
+ * copies the bytes into its own buffer, so they're handed over without copying them first.
+ */
+- (void)_writeEncodedRows:(SPXMLRowEncoder *)encoder
+{
+    if (![encoder length]) return;
+
+    if ([self exportOutputFile].fileHandleError == nil) {
+        [[self exportOutputFile] writeData:[NSData dataWithBytesNoCopy:(void *)[encoder bytes] length:[encoder length] freeWhenDone:NO]];
+    }
+
+    [encoder removeAllBytes];
+}
+
 @end
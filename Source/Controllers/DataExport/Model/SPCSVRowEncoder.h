@@ -0,0 +1,89 @@
+//
+//  SPCSVRowEncoder.h
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+
+/**
+ * @class SPCSVRowEncoder SPCSVRowEncoder.h
+ *
+ * Encodes CSV cells into a single reusable UTF-8 byte buffer, producing the same output as the
+ * string based escaping in SPCSVExporter. Each cell is scanned for the first byte of the escape,
+ * enclosing, field separator and line ending strings sixteen bytes at a time using SSE2 or NEON
+ * (with a lookup table fallback), so runs without any special characters are copied with a single
+ * memcpy and only the few cells that contain them are escaped byte by byte.
+ *
+ * Only ASCII option strings which can't be confused with each other are supported; use
+ * +canEncodeWithFieldSeparator:enclosingCharacter:escapeString:lineEnding: to check before
+ * creating an encoder, and fall back to string escaping otherwise.
+ *
+ * The owner is expected to write out and remove the buffered bytes once they reach a suitable size.
+ */
+@interface SPCSVRowEncoder : NSObject
+{
+	NSData *escapeBytes;
+	NSData *enclosureBytes;
+	NSData *separatorBytes;
+	NSData *lineEndingBytes;
+	NSData *nullBytes;
+
+	BOOL escapeIsEnclosure;
+
+	unsigned char enclosedSpecialBytes[256];
+	unsigned char unenclosedSpecialBytes[256];
+
+	unsigned char enclosedTriggers[4];
+	unsigned char unenclosedTriggers[4];
+
+	unsigned char *buffer;
+	NSUInteger bufferLength;
+	NSUInteger bufferCapacity;
+
+	char *scratch;
+	NSUInteger scratchCapacity;
+}
+
+/**
+ * @property length The number of bytes currently buffered
+ */
+@property (readonly, assign) NSUInteger length;
+
++ (BOOL)canEncodeWithFieldSeparator:(NSString *)separator enclosingCharacter:(NSString *)enclosure escapeString:(NSString *)escape lineEnding:(NSString *)lineEnding;
+
+- (instancetype)initWithFieldSeparator:(NSString *)separator enclosingCharacter:(NSString *)enclosure escapeString:(NSString *)escape lineEnding:(NSString *)lineEnding nullString:(NSString *)nullString;
+
+- (void)appendCellString:(NSString *)cell enclosed:(BOOL)enclosed;
+- (void)appendNULL;
+- (void)appendFieldSeparator;
+- (void)appendLineEnding;
+- (void)appendData:(NSData *)data;
+
+- (const void *)bytes;
+- (void)removeAllBytes;
+
+@end
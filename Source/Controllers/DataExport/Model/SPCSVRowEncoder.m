@@ -0,0 +1,384 @@
+//
+//  SPCSVRowEncoder.m
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+
+#import "SPCSVRowEncoder.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+static NSUInteger SPCSVNextSpecialByte(const unsigned char *bytes, NSUInteger length, const unsigned char *triggers, const unsigned char *specialBytes);
+static BOOL SPCSVStringMatches(const unsigned char *bytes, NSUInteger length, NSData *string);
+
+@interface SPCSVRowEncoder ()
+
++ (NSData *)_ASCIIBytesOfString:(NSString *)string;
+
+- (void)_reserveCapacity:(NSUInteger)additionalLength;
+- (void)_appendBytes:(const void *)bytes length:(NSUInteger)length;
+- (void)_appendEscapedBytes:(const unsigned char *)bytes length:(NSUInteger)length escapingSeparators:(BOOL)escapeSeparators;
+- (const char *)_UTF8BytesOfString:(NSString *)string length:(NSUInteger *)length;
+
+@end
+
+@implementation SPCSVRowEncoder
+
+@synthesize length = bufferLength;
+
+/**
+ * Returns whether cells can be encoded with the supplied option strings, which must already have
+ * any \t, \n or \r sequences replaced by the characters they stand for.
+ *
+ * The escape, separator and line ending strings must be non-empty ASCII; the enclosing string may
+ * be empty. So that escaping each cell in a single pass gives the same result as escaping each
+ * string in turn, none of the strings may contain the first character of another.
+ */
++ (BOOL)canEncodeWithFieldSeparator:(NSString *)separator enclosingCharacter:(NSString *)enclosure escapeString:(NSString *)escape lineEnding:(NSString *)lineEnding
+{
+	NSData *escapeData = [self _ASCIIBytesOfString:escape];
+	NSData *enclosureData = [self _ASCIIBytesOfString:enclosure];
+	NSData *separatorData = [self _ASCIIBytesOfString:separator];
+	NSData *lineEndingData = [self _ASCIIBytesOfString:lineEnding];
+
+	if (!escapeData || !enclosureData || !separatorData || !lineEndingData) return NO;
+
+	if (![escapeData length] || ![separatorData length] || ![lineEndingData length]) return NO;
+
+	NSMutableArray *strings = [NSMutableArray arrayWithObjects:escapeData, separatorData, lineEndingData, nil];
+
+	// An enclosing string which is the same as the escape string is escaped as the escape string
+	if ([enclosureData length] && ![enclosureData isEqualToData:escapeData]) [strings addObject:enclosureData];
+
+	for (NSData *string in strings)
+	{
+		for (NSData *other in strings)
+		{
+			if (string == other) continue;
+
+			if (memchr([string bytes], *(const unsigned char *)[other bytes], [string length])) return NO;
+		}
+	}
+
+	return YES;
+}
+
+/**
+ * Initialise an encoder using the supplied option strings.
+ *
+ * @return The initialised instance, or nil if the strings aren't supported
+ */
+- (instancetype)initWithFieldSeparator:(NSString *)separator enclosingCharacter:(NSString *)enclosure escapeString:(NSString *)escape lineEnding:(NSString *)lineEnding nullString:(NSString *)nullString
+{
+	if (![SPCSVRowEncoder canEncodeWithFieldSeparator:separator enclosingCharacter:enclosure escapeString:escape lineEnding:lineEnding]) return nil;
+
+	if ((self = [super init])) {
+		escapeBytes = [SPCSVRowEncoder _ASCIIBytesOfString:escape];
+		enclosureBytes = [SPCSVRowEncoder _ASCIIBytesOfString:enclosure];
+		separatorBytes = [SPCSVRowEncoder _ASCIIBytesOfString:separator];
+		lineEndingBytes = [SPCSVRowEncoder _ASCIIBytesOfString:lineEnding];
+		nullBytes = [(nullString ?: @"") dataUsingEncoding:NSUTF8StringEncoding];
+
+		escapeIsEnclosure = [enclosureBytes isEqualToData:escapeBytes];
+
+		unsigned char escapeByte = *(const unsigned char *)[escapeBytes bytes];
+		unsigned char enclosureByte = [enclosureBytes length] ? *(const unsigned char *)[enclosureBytes bytes] : escapeByte;
+		unsigned char separatorByte = *(const unsigned char *)[separatorBytes bytes];
+		unsigned char lineEndingByte = *(const unsigned char *)[lineEndingBytes bytes];
+
+		// Enclosed cells only need the escape and enclosing strings escaping, others the separators and line endings too
+		unsigned char enclosed[4] = { escapeByte, enclosureByte, escapeByte, escapeByte };
+		unsigned char unenclosed[4] = { escapeByte, enclosureByte, separatorByte, lineEndingByte };
+
+		memcpy(enclosedTriggers, enclosed, 4);
+		memcpy(unenclosedTriggers, unenclosed, 4);
+
+		memset(enclosedSpecialBytes, 0, 256);
+		memset(unenclosedSpecialBytes, 0, 256);
+
+		for (NSUInteger i = 0; i < 4; i++)
+		{
+			enclosedSpecialBytes[enclosed[i]] = 1;
+			unenclosedSpecialBytes[unenclosed[i]] = 1;
+		}
+	}
+
+	return self;
+}
+
+/**
+ * Appends a cell's text. Enclosed cells are wrapped in the enclosing string; unenclosed cells, and
+ * all cells when there is no enclosing string, have their separators and line endings escaped.
+ * Empty cells are always written as a pair of enclosing strings.
+ */
+- (void)appendCellString:(NSString *)cell enclosed:(BOOL)enclosed
+{
+	NSUInteger length = 0;
+	const char *bytes = [self _UTF8BytesOfString:cell length:&length];
+
+	if (!length) {
+		[self _appendBytes:[enclosureBytes bytes] length:[enclosureBytes length]];
+		[self _appendBytes:[enclosureBytes bytes] length:[enclosureBytes length]];
+
+		return;
+	}
+
+	if (enclosed) [self _appendBytes:[enclosureBytes bytes] length:[enclosureBytes length]];
+
+	[self _appendEscapedBytes:(const unsigned char *)bytes length:length escapingSeparators:(!enclosed || ![enclosureBytes length])];
+
+	if (enclosed) [self _appendBytes:[enclosureBytes bytes] length:[enclosureBytes length]];
+}
+
+- (void)appendNULL
+{
+	[self _appendBytes:[nullBytes bytes] length:[nullBytes length]];
+}
+
+- (void)appendFieldSeparator
+{
+	[self _appendBytes:[separatorBytes bytes] length:[separatorBytes length]];
+}
+
+- (void)appendLineEnding
+{
+	[self _appendBytes:[lineEndingBytes bytes] length:[lineEndingBytes length]];
+}
+
+/**
+ * Appends bytes as-is, such as a previously encoded row.
+ */
+- (void)appendData:(NSData *)data
+{
+	[self _appendBytes:[data bytes] length:[data length]];
+}
+
+- (const void *)bytes
+{
+	return buffer;
+}
+
+- (void)removeAllBytes
+{
+	bufferLength = 0;
+}
+
+#pragma mark -
+#pragma mark Private API
+
++ (NSData *)_ASCIIBytesOfString:(NSString *)string
+{
+	return [string dataUsingEncoding:NSASCIIStringEncoding allowLossyConversion:NO];
+}
+
+/**
+ * Appends UTF-8 bytes, preceding each occurrence of the escape and enclosing strings, and of the
+ * separator and line ending strings if requested, by the escape string. The option strings are
+ * ASCII, so can't match part of a multibyte character.
+ */
+- (void)_appendEscapedBytes:(const unsigned char *)bytes length:(NSUInteger)length escapingSeparators:(BOOL)escapeSeparators
+{
+	const unsigned char *triggers = escapeSeparators ? unenclosedTriggers : enclosedTriggers;
+	const unsigned char *specialBytes = escapeSeparators ? unenclosedSpecialBytes : enclosedSpecialBytes;
+
+	NSUInteger position = 0;
+
+	while (position < length)
+	{
+		NSUInteger special = position + SPCSVNextSpecialByte(bytes + position, length - position, triggers, specialBytes);
+
+		if (special > position) [self _appendBytes:(bytes + position) length:(special - position)];
+
+		if (special == length) break;
+
+		const unsigned char *remaining = bytes + special;
+		NSUInteger remainingLength = length - special;
+		NSData *match = nil;
+
+		if (SPCSVStringMatches(remaining, remainingLength, escapeBytes)) {
+			match = escapeBytes;
+		}
+		else if (!escapeIsEnclosure && SPCSVStringMatches(remaining, remainingLength, enclosureBytes)) {
+			match = enclosureBytes;
+		}
+		else if (escapeSeparators && SPCSVStringMatches(remaining, remainingLength, separatorBytes)) {
+			match = separatorBytes;
+		}
+		else if (escapeSeparators && SPCSVStringMatches(remaining, remainingLength, lineEndingBytes)) {
+			match = lineEndingBytes;
+		}
+
+		// Only the first character of a longer string matched, so it's copied as-is
+		if (!match) {
+			[self _appendBytes:remaining length:1];
+
+			position = special + 1;
+
+			continue;
+		}
+
+		[self _appendBytes:[escapeBytes bytes] length:[escapeBytes length]];
+		[self _appendBytes:[match bytes] length:[match length]];
+
+		position = special + [match length];
+	}
+}
+
+- (void)_appendBytes:(const void *)bytes length:(NSUInteger)length
+{
+	if (!length) return;
+
+	[self _reserveCapacity:length];
+
+	memcpy(buffer + bufferLength, bytes, length);
+
+	bufferLength += length;
+}
+
+/**
+ * Grows the buffer, if necessary, so it can hold the supplied number of additional bytes.
+ */
+- (void)_reserveCapacity:(NSUInteger)additionalLength
+{
+	if (bufferLength + additionalLength <= bufferCapacity) return;
+
+	NSUInteger capacity = MAX(bufferCapacity * 2, 4096);
+
+	while (capacity < bufferLength + additionalLength) capacity *= 2;
+
+	buffer = reallocf(buffer, capacity);
+
+	if (!buffer) [NSException raise:NSMallocException format:@"Unable to allocate %lu bytes for the CSV export buffer", (unsigned long)capacity];
+
+	bufferCapacity = capacity;
+}
+
+/**
+ * Returns the UTF-8 bytes of a string. ASCII strings stored as single bytes are used directly;
+ * others are converted into a scratch buffer reused between cells. The bytes are only valid until
+ * the next call.
+ */
+- (const char *)_UTF8BytesOfString:(NSString *)string length:(NSUInteger *)length
+{
+	*length = 0;
+
+	if (!string) return NULL;
+
+	// Only available when the contents are ASCII, so the byte length is the string's length
+	const char *directBytes = CFStringGetCStringPtr((__bridge CFStringRef)string, kCFStringEncodingUTF8);
+
+	if (directBytes) {
+		*length = [string length];
+
+		return directBytes;
+	}
+
+	NSUInteger maximumLength = [string maximumLengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+
+	if (maximumLength > scratchCapacity) {
+		scratchCapacity = MAX(maximumLength, 1024);
+		scratch = reallocf(scratch, scratchCapacity);
+
+		if (!scratch) [NSException raise:NSMallocException format:@"Unable to allocate %lu bytes for the CSV export buffer", (unsigned long)scratchCapacity];
+	}
+
+	[string getBytes:scratch maxLength:maximumLength usedLength:length encoding:NSUTF8StringEncoding options:0 range:NSMakeRange(0, [string length]) remainingRange:NULL];
+
+	return scratch;
+}
+
+- (void)dealloc
+{
+	if (buffer) free(buffer);
+	if (scratch) free(scratch);
+}
+
+@end
+
+/**
+ * Returns the offset of the first byte which is one of the four trigger bytes, or the length if
+ * there is none. Sixteen bytes are compared at a time where SSE2 or NEON is available, with the
+ * lookup table of the same bytes used for the remainder.
+ */
+static NSUInteger SPCSVNextSpecialByte(const unsigned char *bytes, NSUInteger length, const unsigned char *triggers, const unsigned char *specialBytes)
+{
+	NSUInteger i = 0;
+
+#if defined(__SSE2__)
+	const __m128i first = _mm_set1_epi8((char)triggers[0]);
+	const __m128i second = _mm_set1_epi8((char)triggers[1]);
+	const __m128i third = _mm_set1_epi8((char)triggers[2]);
+	const __m128i fourth = _mm_set1_epi8((char)triggers[3]);
+
+	for (; i + 16 <= length; i += 16)
+	{
+		__m128i block = _mm_loadu_si128((const __m128i *)(bytes + i));
+		__m128i matches = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, first), _mm_cmpeq_epi8(block, second)),
+		                               _mm_or_si128(_mm_cmpeq_epi8(block, third), _mm_cmpeq_epi8(block, fourth)));
+
+		int mask = _mm_movemask_epi8(matches);
+
+		if (mask) return i + (NSUInteger)__builtin_ctz((unsigned int)mask);
+	}
+#elif defined(__ARM_NEON)
+	const uint8x16_t first = vdupq_n_u8(triggers[0]);
+	const uint8x16_t second = vdupq_n_u8(triggers[1]);
+	const uint8x16_t third = vdupq_n_u8(triggers[2]);
+	const uint8x16_t fourth = vdupq_n_u8(triggers[3]);
+
+	for (; i + 16 <= length; i += 16)
+	{
+		uint8x16_t block = vld1q_u8(bytes + i);
+		uint8x16_t matches = vorrq_u8(vorrq_u8(vceqq_u8(block, first), vceqq_u8(block, second)),
+		                              vorrq_u8(vceqq_u8(block, third), vceqq_u8(block, fourth)));
+
+		// Narrow each byte's comparison result to four bits, so the first match is the lowest set nibble
+		uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(matches), 4)), 0);
+
+		if (mask) return i + (NSUInteger)(__builtin_ctzll(mask) >> 2);
+	}
+#endif
+
+	for (; i < length; i++)
+	{
+		if (specialBytes[bytes[i]]) return i;
+	}
+
+	return length;
+}
+
+static BOOL SPCSVStringMatches(const unsigned char *bytes, NSUInteger length, NSData *string)
+{
+	NSUInteger stringLength = [string length];
+
+	return stringLength && stringLength <= length && !memcmp(bytes, [string bytes], stringLength);
+}
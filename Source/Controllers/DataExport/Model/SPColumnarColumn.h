@@ -0,0 +1,177 @@
+//
+//  SPColumnarColumn.h
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+/**
+ * Value types a column can be exported as by the columnar (Arrow and Parquet) exporters.
+ */
+typedef NS_ENUM(NSUInteger, SPColumnarType) {
+	SPColumnarInt8Type      = 0,
+	SPColumnarInt16Type     = 1,
+	SPColumnarInt32Type     = 2,
+	SPColumnarInt64Type     = 3,
+	SPColumnarUInt8Type     = 4,
+	SPColumnarUInt16Type    = 5,
+	SPColumnarUInt32Type    = 6,
+	SPColumnarUInt64Type    = 7,
+	SPColumnarFloatType     = 8,
+	SPColumnarDoubleType    = 9,
+	SPColumnarDecimalType   = 10, // 128 bit, two's complement, scaled by 10^scale
+	SPColumnarDateType      = 11, // 32 bit, days since the UNIX epoch
+	SPColumnarTimestampType = 12, // 64 bit, microseconds since the UNIX epoch, without a time zone
+	SPColumnarStringType    = 13, // UTF-8
+	SPColumnarBinaryType    = 14
+};
+
+/**
+ * @class SPColumnarColumn SPColumnarColumn.h
+ *
+ * A single column of a columnar export. The column knows the type its MySQL values are mapped to
+ * and buffers the values of the current batch using the Arrow memory layout: an LSB ordered
+ * validity bitmap, a values buffer of fixed width values or, for strings and binary data, an
+ * offsets buffer of 32 bit offsets into the values buffer.
+ *
+ * Once a batch has been written the column is reset and reused for the next one, so the memory
+ * used is bounded by the size of a batch rather than the size of the result set.
+ */
+@interface SPColumnarColumn : NSObject
+{
+	NSString *name;
+	SPColumnarType type;
+
+	NSUInteger precision;
+	NSUInteger scale;
+
+	BOOL prefersDictionaryEncoding;
+
+	NSUInteger length;
+	NSUInteger nullCount;
+
+	NSMutableData *validity;
+	NSMutableData *values;
+	NSMutableData *offsets;
+
+	NSMutableData *dictionaryIndices;
+	NSMutableData *dictionaryValues;
+	NSMutableData *dictionaryOffsets;
+	NSUInteger dictionaryLength;
+
+	NSStringEncoding dataEncoding;
+}
+
+/**
+ * @property name The column name
+ */
+@property (readonly, copy) NSString *name;
+
+/**
+ * @property type The type values are exported as
+ */
+@property (readonly, assign) SPColumnarType type;
+
+/**
+ * @property precision The number of decimal digits of decimal columns
+ */
+@property (readwrite, assign) NSUInteger precision;
+
+/**
+ * @property scale The number of fractional decimal digits of decimal columns
+ */
+@property (readwrite, assign) NSUInteger scale;
+
+/**
+ * @property prefersDictionaryEncoding Whether the column is known to have few distinct values (ENUM and SET columns)
+ */
+@property (readwrite, assign) BOOL prefersDictionaryEncoding;
+
+/**
+ * @property dataEncoding The encoding used to convert data values of string columns to text
+ */
+@property (readwrite, assign) NSStringEncoding dataEncoding;
+
+/**
+ * @property length The number of values in the current batch
+ */
+@property (readonly, assign) NSUInteger length;
+
+/**
+ * @property nullCount The number of NULL values in the current batch
+ */
+@property (readonly, assign) NSUInteger nullCount;
+
+/**
+ * @property validity The validity bitmap of the current batch
+ */
+@property (readonly, strong) NSData *validity;
+
+/**
+ * @property values The fixed width values, or the bytes of the variable length values, of the current batch
+ */
+@property (readonly, strong) NSData *values;
+
+/**
+ * @property offsets The length + 1 value offsets of variable length columns
+ */
+@property (readonly, strong) NSData *offsets;
+
+/**
+ * @property dictionaryIndices The 32 bit dictionary index of each value, once a dictionary has been built
+ */
+@property (readonly, strong) NSData *dictionaryIndices;
+
+/**
+ * @property dictionaryValues The bytes of the distinct values, once a dictionary has been built
+ */
+@property (readonly, strong) NSData *dictionaryValues;
+
+/**
+ * @property dictionaryOffsets The dictionaryLength + 1 offsets into dictionaryValues
+ */
+@property (readonly, strong) NSData *dictionaryOffsets;
+
+/**
+ * @property dictionaryLength The number of distinct values in the dictionary
+ */
+@property (readonly, assign) NSUInteger dictionaryLength;
+
++ (SPColumnarColumn *)columnWithName:(NSString *)columnName fieldDefinition:(NSDictionary *)definition;
+
+- (instancetype)initWithName:(NSString *)columnName type:(SPColumnarType)columnType;
+
+- (void)appendValue:(id)value;
+- (void)reset;
+
+- (BOOL)isVariableLength;
+- (NSUInteger)valueByteWidth;
+- (NSUInteger)bufferedByteLength;
+- (BOOL)isNullAtIndex:(NSUInteger)index;
+
+- (BOOL)buildDictionaryWithMaximumLength:(NSUInteger)maximumLength;
+
+@end
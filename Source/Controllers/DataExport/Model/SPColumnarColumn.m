@@ -0,0 +1,570 @@
+//
+//  SPColumnarColumn.m
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPColumnarColumn.h"
+
+#import <SPMySQL/SPMySQL.h>
+
+// The widest decimal that fits into 128 bits
+static const NSUInteger SPColumnarMaximumDecimalPrecision = 38;
+
+static BOOL SPColumnarParseDecimal(const char *string, NSUInteger scale, __int128 *result);
+static BOOL SPColumnarParseDate(const char *string, int32_t *days);
+static BOOL SPColumnarParseTimestamp(const char *string, int64_t *microseconds);
+static int64_t SPColumnarDaysFromCivil(int64_t year, unsigned month, unsigned day);
+
+@implementation SPColumnarColumn
+
+@synthesize name;
+@synthesize type;
+@synthesize precision;
+@synthesize scale;
+@synthesize prefersDictionaryEncoding;
+@synthesize dataEncoding;
+@synthesize length;
+@synthesize nullCount;
+@synthesize validity;
+@synthesize values;
+@synthesize offsets;
+@synthesize dictionaryIndices;
+@synthesize dictionaryValues;
+@synthesize dictionaryOffsets;
+@synthesize dictionaryLength;
+
+#pragma mark -
+#pragma mark Initialisation
+
+/**
+ * Returns a column for the supplied field, mapping its MySQL type as described by SPMySQLResult's
+ * field definitions to the closest columnar type. Types without an exact equivalent (e.g. TIME, whose
+ * range exceeds a day, and decimals wider than 38 digits) are exported as strings.
+ *
+ * @param columnName The name of the column
+ * @param definition The field definition, or nil if it is not known
+ *
+ * @return The initialised column
+ */
++ (SPColumnarColumn *)columnWithName:(NSString *)columnName fieldDefinition:(NSDictionary *)definition
+{
+	NSString *fieldType = [[definition objectForKey:@"type"] uppercaseString];
+	NSString *typeGrouping = [definition objectForKey:@"typegrouping"];
+
+	BOOL isUnsigned = [[definition objectForKey:@"UNSIGNED_FLAG"] boolValue];
+
+	SPColumnarType columnType = SPColumnarStringType;
+	NSUInteger decimalScale = 0, decimalPrecision = 0;
+
+	if ([fieldType isEqualToString:@"TINYINT"]) {
+		columnType = isUnsigned ? SPColumnarUInt8Type : SPColumnarInt8Type;
+	}
+	else if ([fieldType isEqualToString:@"SMALLINT"]) {
+		columnType = isUnsigned ? SPColumnarUInt16Type : SPColumnarInt16Type;
+	}
+	else if ([fieldType isEqualToString:@"MEDIUMINT"] || [fieldType isEqualToString:@"INT"]) {
+		columnType = isUnsigned ? SPColumnarUInt32Type : SPColumnarInt32Type;
+	}
+	else if ([fieldType isEqualToString:@"BIGINT"]) {
+		columnType = isUnsigned ? SPColumnarUInt64Type : SPColumnarInt64Type;
+	}
+	else if ([fieldType isEqualToString:@"YEAR"]) {
+		columnType = SPColumnarInt16Type;
+	}
+	else if ([fieldType isEqualToString:@"FLOAT"]) {
+		columnType = SPColumnarFloatType;
+	}
+	else if ([fieldType isEqualToString:@"DOUBLE"]) {
+		columnType = SPColumnarDoubleType;
+	}
+	else if ([fieldType isEqualToString:@"DECIMAL"]) {
+
+		// The display length of a decimal includes the decimal point and the sign of signed columns
+		NSUInteger displayLength = [[definition objectForKey:@"byte_length"] unsignedIntegerValue];
+
+		decimalScale = [[definition objectForKey:@"decimals"] unsignedIntegerValue];
+		decimalPrecision = displayLength - ((decimalScale > 0) ? 1 : 0) - (isUnsigned ? 0 : 1);
+
+		if (displayLength > decimalScale && decimalPrecision > 0 && decimalPrecision >= decimalScale && decimalPrecision <= SPColumnarMaximumDecimalPrecision) {
+			columnType = SPColumnarDecimalType;
+		}
+	}
+	else if ([fieldType isEqualToString:@"DATE"]) {
+		columnType = SPColumnarDateType;
+	}
+	else if ([fieldType isEqualToString:@"DATETIME"] || [fieldType isEqualToString:@"TIMESTAMP"]) {
+		columnType = SPColumnarTimestampType;
+	}
+	else if ([typeGrouping isEqualToString:@"binary"] || [typeGrouping isEqualToString:@"blobdata"]) {
+		columnType = SPColumnarBinaryType;
+	}
+
+	SPColumnarColumn *column = [[SPColumnarColumn alloc] initWithName:columnName type:columnType];
+
+	if (columnType == SPColumnarDecimalType) {
+		[column setPrecision:decimalPrecision];
+		[column setScale:decimalScale];
+	}
+
+	[column setPrefersDictionaryEncoding:[typeGrouping isEqualToString:@"enum"]];
+
+	return column;
+}
+
+/**
+ * Initialise an empty column of the supplied type.
+ *
+ * @param columnName The name of the column
+ * @param columnType The type values are exported as
+ *
+ * @return The initialised instance
+ */
+- (instancetype)initWithName:(NSString *)columnName type:(SPColumnarType)columnType
+{
+	if ((self = [super init])) {
+		name = [columnName copy];
+		type = columnType;
+		dataEncoding = NSUTF8StringEncoding;
+
+		validity = [[NSMutableData alloc] init];
+		values = [[NSMutableData alloc] init];
+		offsets = [[NSMutableData alloc] init];
+
+		[self reset];
+	}
+
+	return self;
+}
+
+#pragma mark -
+#pragma mark Buffering
+
+/**
+ * Appends a value as returned by SPMySQL (an NSString, NSNumber, NSData, geometry object or NSNull)
+ * to the current batch. Values which can't be represented in the column's type are stored as NULL.
+ *
+ * @param value The value to append
+ */
+- (void)appendValue:(id)value
+{
+	if ((length % 8) == 0) [validity increaseLengthBy:1];
+
+	BOOL isValid = [self _appendValue:value];
+
+	if (isValid) {
+		((uint8_t *)[validity mutableBytes])[length / 8] |= (uint8_t)(1 << (length % 8));
+	}
+	else {
+		nullCount++;
+	}
+
+	length++;
+
+	if ([self isVariableLength]) {
+		int32_t offset = (int32_t)[values length];
+
+		[offsets appendBytes:&offset length:sizeof(offset)];
+	}
+}
+
+/**
+ * Empties the column ready for the next batch.
+ */
+- (void)reset
+{
+	length = 0;
+	nullCount = 0;
+
+	[validity setLength:0];
+	[values setLength:0];
+	[offsets setLength:0];
+
+	if ([self isVariableLength]) {
+		int32_t offset = 0;
+
+		[offsets appendBytes:&offset length:sizeof(offset)];
+	}
+
+	dictionaryIndices = nil;
+	dictionaryValues = nil;
+	dictionaryOffsets = nil;
+	dictionaryLength = 0;
+}
+
+/**
+ * Returns whether the column stores variable length (string or binary) values.
+ */
+- (BOOL)isVariableLength
+{
+	return (type == SPColumnarStringType || type == SPColumnarBinaryType);
+}
+
+/**
+ * Returns the width in bytes of each value of fixed width columns, or 0 for variable length columns.
+ */
+- (NSUInteger)valueByteWidth
+{
+	switch (type)
+	{
+		case SPColumnarInt8Type:
+		case SPColumnarUInt8Type:
+			return 1;
+		case SPColumnarInt16Type:
+		case SPColumnarUInt16Type:
+			return 2;
+		case SPColumnarInt32Type:
+		case SPColumnarUInt32Type:
+		case SPColumnarFloatType:
+		case SPColumnarDateType:
+			return 4;
+		case SPColumnarInt64Type:
+		case SPColumnarUInt64Type:
+		case SPColumnarDoubleType:
+		case SPColumnarTimestampType:
+			return 8;
+		case SPColumnarDecimalType:
+			return 16;
+		case SPColumnarStringType:
+		case SPColumnarBinaryType:
+			return 0;
+	}
+
+	return 0;
+}
+
+/**
+ * Returns the number of bytes currently buffered by the column.
+ */
+- (NSUInteger)bufferedByteLength
+{
+	return [validity length] + [values length] + [offsets length];
+}
+
+/**
+ * Returns whether the value at the supplied index of the current batch is NULL.
+ *
+ * @param index The row index within the batch
+ */
+- (BOOL)isNullAtIndex:(NSUInteger)index
+{
+	return (((const uint8_t *)[validity bytes])[index / 8] & (1 << (index % 8))) == 0;
+}
+
+#pragma mark -
+#pragma mark Dictionary encoding
+
+/**
+ * Builds a dictionary of the distinct values of the current batch of a string column, along with the
+ * index of each value in it. Building stops as soon as more than the supplied number of distinct
+ * values have been found, which allows callers to only dictionary encode low cardinality columns.
+ *
+ * @param maximumLength The maximum number of distinct values, or NSUIntegerMax to always build the dictionary
+ *
+ * @return A BOOL indicating whether a dictionary was built
+ */
+- (BOOL)buildDictionaryWithMaximumLength:(NSUInteger)maximumLength
+{
+	if (type != SPColumnarStringType) return NO;
+
+	const uint8_t *bytes = [values bytes];
+	const int32_t *valueOffsets = [offsets bytes];
+
+	NSMutableDictionary *indexes = [[NSMutableDictionary alloc] init];
+
+	NSMutableData *indices = [NSMutableData dataWithLength:(length * sizeof(int32_t))];
+	NSMutableData *distinctValues = [NSMutableData data];
+	NSMutableData *distinctOffsets = [NSMutableData dataWithLength:sizeof(int32_t)];
+
+	int32_t *indexBuffer = [indices mutableBytes];
+
+	for (NSUInteger i = 0; i < length; i++)
+	{
+		if ([self isNullAtIndex:i]) continue;
+
+		// The keys reference the batch's buffer, which isn't modified while the dictionary is built
+		NSData *key = [NSData dataWithBytesNoCopy:(void *)(bytes + valueOffsets[i]) length:(NSUInteger)(valueOffsets[i + 1] - valueOffsets[i]) freeWhenDone:NO];
+		NSNumber *index = [indexes objectForKey:key];
+
+		if (!index) {
+			if ([indexes count] >= maximumLength) return NO;
+
+			index = @([indexes count]);
+
+			[indexes setObject:index forKey:key];
+			[distinctValues appendData:key];
+
+			int32_t offset = (int32_t)[distinctValues length];
+
+			[distinctOffsets appendBytes:&offset length:sizeof(offset)];
+		}
+
+		indexBuffer[i] = [index intValue];
+	}
+
+	dictionaryIndices = indices;
+	dictionaryValues = distinctValues;
+	dictionaryOffsets = distinctOffsets;
+	dictionaryLength = [indexes count];
+
+	return YES;
+}
+
+#pragma mark -
+#pragma mark Private API
+
+/**
+ * Converts and appends the supplied value to the values buffer.
+ *
+ * @return A BOOL indicating whether the value is valid, i.e. not NULL
+ */
+- (BOOL)_appendValue:(id)value
+{
+	BOOL isValid = (value && value != [NSNull null]);
+
+	// Variable length values
+	if ([self isVariableLength]) {
+		if (!isValid) return NO;
+
+		if ([value isKindOfClass:[NSData class]]) {
+
+			// Only text that is valid in the connection's encoding can be stored in UTF-8 columns
+			if (type == SPColumnarStringType && dataEncoding != NSUTF8StringEncoding) {
+				NSString *string = [[NSString alloc] initWithData:value encoding:dataEncoding];
+
+				if (!string) return NO;
+
+				value = string;
+			}
+			else {
+				[values appendData:value];
+				return YES;
+			}
+		}
+
+		if ([value isKindOfClass:[SPMySQLGeometryData class]]) value = [value wktString];
+
+		const char *string = [[value description] UTF8String];
+
+		if (string) [values appendBytes:string length:strlen(string)];
+
+		return (string != NULL);
+	}
+
+	// Fixed width values
+	NSUInteger width = [self valueByteWidth];
+	uint8_t buffer[16] = {0};
+
+	if (isValid) {
+		if ([value isKindOfClass:[NSData class]]) {
+			value = [[NSString alloc] initWithData:value encoding:dataEncoding];
+		}
+
+		const char *string = [[value description] UTF8String];
+
+		isValid = (string != NULL && *string != '\0');
+
+		if (isValid) {
+			char *end = NULL;
+
+			switch (type)
+			{
+				case SPColumnarInt8Type:
+				case SPColumnarInt16Type:
+				case SPColumnarInt32Type:
+				case SPColumnarInt64Type:
+				{
+					long long integer = strtoll(string, &end, 10);
+					memcpy(buffer, &integer, width);
+					break;
+				}
+				case SPColumnarUInt8Type:
+				case SPColumnarUInt16Type:
+				case SPColumnarUInt32Type:
+				case SPColumnarUInt64Type:
+				{
+					unsigned long long integer = strtoull(string, &end, 10);
+					memcpy(buffer, &integer, width);
+					break;
+				}
+				case SPColumnarFloatType:
+				{
+					float real = strtof(string, &end);
+					memcpy(buffer, &real, width);
+					break;
+				}
+				case SPColumnarDoubleType:
+				{
+					double real = strtod(string, &end);
+					memcpy(buffer, &real, width);
+					break;
+				}
+				case SPColumnarDecimalType:
+				{
+					__int128 decimal = 0;
+					isValid = SPColumnarParseDecimal(string, scale, &decimal);
+					memcpy(buffer, &decimal, width);
+					break;
+				}
+				case SPColumnarDateType:
+				{
+					int32_t days = 0;
+					isValid = SPColumnarParseDate(string, &days);
+					memcpy(buffer, &days, width);
+					break;
+				}
+				case SPColumnarTimestampType:
+				{
+					int64_t microseconds = 0;
+					isValid = SPColumnarParseTimestamp(string, &microseconds);
+					memcpy(buffer, &microseconds, width);
+					break;
+				}
+				case SPColumnarStringType:
+				case SPColumnarBinaryType:
+					break;
+			}
+
+			// Integers and reals must have been parsed in their entirety
+			if (end && *end != '\0') isValid = NO;
+		}
+	}
+
+	if (!isValid) memset(buffer, 0, sizeof(buffer));
+
+	[values appendBytes:buffer length:width];
+
+	return isValid;
+}
+
+@end
+
+#pragma mark -
+#pragma mark Value parsing
+
+/**
+ * Parses a decimal string such as "-1234.50" into an integer scaled by 10^scale.
+ */
+static BOOL SPColumnarParseDecimal(const char *string, NSUInteger scale, __int128 *result)
+{
+	BOOL negative = NO, seenPoint = NO, seenDigit = NO;
+	NSUInteger fractionalDigits = 0;
+	__int128 value = 0;
+
+	if (*string == '-' || *string == '+') negative = (*string++ == '-');
+
+	for (; *string; string++)
+	{
+		if (*string == '.' && !seenPoint) {
+			seenPoint = YES;
+			continue;
+		}
+
+		if (*string < '0' || *string > '9') return NO;
+
+		// Digits beyond the column's scale can't occur in MySQL's output; ignore them rather than overflow
+		if (seenPoint && fractionalDigits == scale) continue;
+
+		value = (value * 10) + (*string - '0');
+		seenDigit = YES;
+
+		if (seenPoint) fractionalDigits++;
+	}
+
+	if (!seenDigit) return NO;
+
+	for (; fractionalDigits < scale; fractionalDigits++) value *= 10;
+
+	*result = negative ? -value : value;
+
+	return YES;
+}
+
+/**
+ * Parses a MySQL date ("YYYY-MM-DD") into days since the UNIX epoch. Zero and partial dates
+ * such as "0000-00-00" have no equivalent and are rejected.
+ */
+static BOOL SPColumnarParseDate(const char *string, int32_t *days)
+{
+	int year = 0, month = 0, day = 0;
+
+	if (sscanf(string, "%d-%d-%d", &year, &month, &day) != 3) return NO;
+
+	if (month < 1 || month > 12 || day < 1 || day > 31) return NO;
+
+	*days = (int32_t)SPColumnarDaysFromCivil(year, (unsigned)month, (unsigned)day);
+
+	return YES;
+}
+
+/**
+ * Parses a MySQL datetime or timestamp ("YYYY-MM-DD HH:MM:SS[.ffffff]") into microseconds since the
+ * UNIX epoch, without applying any time zone.
+ */
+static BOOL SPColumnarParseTimestamp(const char *string, int64_t *microseconds)
+{
+	int year = 0, month = 0, day = 0, hour = 0, minute = 0, second = 0, consumed = 0;
+
+	if (sscanf(string, "%d-%d-%d %d:%d:%d%n", &year, &month, &day, &hour, &minute, &second, &consumed) != 6) return NO;
+
+	if (month < 1 || month > 12 || day < 1 || day > 31) return NO;
+
+	int64_t fraction = 0;
+	const char *fractionString = string + consumed;
+
+	if (*fractionString == '.') {
+		int digits = 0;
+
+		for (fractionString++; *fractionString >= '0' && *fractionString <= '9' && digits < 6; fractionString++, digits++)
+		{
+			fraction = (fraction * 10) + (*fractionString - '0');
+		}
+
+		for (; digits < 6; digits++) fraction *= 10;
+	}
+
+	int64_t seconds = (SPColumnarDaysFromCivil(year, (unsigned)month, (unsigned)day) * 86400) + (hour * 3600) + (minute * 60) + second;
+
+	*microseconds = (seconds * 1000000) + fraction;
+
+	return YES;
+}
+
+/**
+ * Returns the number of days between the UNIX epoch and the supplied proleptic Gregorian date.
+ */
+static int64_t SPColumnarDaysFromCivil(int64_t year, unsigned month, unsigned day)
+{
+	year -= (month <= 2);
+
+	int64_t era = ((year >= 0) ? year : (year - 399)) / 400;
+	unsigned yearOfEra = (unsigned)(year - (era * 400));
+	unsigned dayOfYear = ((153 * ((month > 2) ? (month - 3) : (month + 9))) + 2) / 5 + day - 1;
+	unsigned dayOfEra = (yearOfEra * 365) + (yearOfEra / 4) - (yearOfEra / 100) + dayOfYear;
+
+	return (era * 146097) + (int64_t)dayOfEra - 719468;
+}
@@ -0,0 +1,101 @@
+//
+//  SPExportCheckpoint.h
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+/**
+ * @class SPExportCheckpoint SPExportCheckpoint.h
+ *
+ * Records how far a chunked export has progressed in a sidecar manifest stored next to the
+ * export file. The manifest lists the tables that have been completely written, the table
+ * currently being exported together with the last primary key value written for it, and the
+ * byte offset in the export file at which the output was last in a consistent state. An
+ * interrupted export can then be resumed by truncating the file to that offset and
+ * continuing from the recorded position.
+ */
+@interface SPExportCheckpoint : NSObject
+{
+	NSString *exportFilePath;
+	NSString *exportFormat;
+	NSString *databaseName;
+
+	NSMutableArray *completedTables;
+	NSString *currentTable;
+	NSString *lastKey;
+
+	unsigned long long byteOffset;
+}
+
+/**
+ * @property exportFilePath The path of the export file this checkpoint belongs to
+ */
+@property (readonly, copy) NSString *exportFilePath;
+
+/**
+ * @property exportFormat The export format description (e.g. SQL or CSV) the file was written in
+ */
+@property (readwrite, copy) NSString *exportFormat;
+
+/**
+ * @property databaseName The database the export was taken from
+ */
+@property (readwrite, copy) NSString *databaseName;
+
+/**
+ * @property currentTable The table that was being exported when the checkpoint was last recorded
+ */
+@property (readonly, copy) NSString *currentTable;
+
+/**
+ * @property lastKey The SQL literal of the last primary key value written for the current table
+ */
+@property (readonly, copy) NSString *lastKey;
+
+/**
+ * @property byteOffset The offset of the last consistent position in the export file
+ */
+@property (readonly, assign) unsigned long long byteOffset;
+
++ (NSString *)manifestPathForExportFilePath:(NSString *)path;
++ (SPExportCheckpoint *)checkpointForExportFilePath:(NSString *)path;
+
+- (instancetype)initWithExportFilePath:(NSString *)path;
+
+- (BOOL)hasProgress;
+- (BOOL)isTableCompleted:(NSString *)table;
+- (BOOL)hasOutputForTable:(NSString *)table;
+- (NSString *)lastKeyForTable:(NSString *)table;
+
+- (void)recordByteOffset:(unsigned long long)offset;
+- (void)recordLastKey:(NSString *)key forTable:(NSString *)table atByteOffset:(unsigned long long)offset;
+- (void)recordCompletedTable:(NSString *)table atByteOffset:(unsigned long long)offset;
+
+- (BOOL)writeManifest;
+- (void)removeManifest;
+
+@end
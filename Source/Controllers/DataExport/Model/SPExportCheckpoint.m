@@ -0,0 +1,250 @@
+//
+//  SPExportCheckpoint.m
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPExportCheckpoint.h"
+
+static NSString *SPExportCheckpointManifestExtension = @"checkpoint";
+static const NSInteger SPExportCheckpointManifestVersion = 1;
+
+static NSString *SPExportCheckpointVersionKey         = @"version";
+static NSString *SPExportCheckpointFormatKey          = @"format";
+static NSString *SPExportCheckpointDatabaseKey        = @"database";
+static NSString *SPExportCheckpointCompletedTablesKey = @"completedTables";
+static NSString *SPExportCheckpointCurrentTableKey    = @"currentTable";
+static NSString *SPExportCheckpointLastKeyKey         = @"lastKey";
+static NSString *SPExportCheckpointByteOffsetKey      = @"byteOffset";
+
+@implementation SPExportCheckpoint
+
+@synthesize exportFilePath;
+@synthesize exportFormat;
+@synthesize databaseName;
+@synthesize currentTable;
+@synthesize lastKey;
+@synthesize byteOffset;
+
+#pragma mark -
+#pragma mark Initialisation
+
+/**
+ * Returns the path of the sidecar manifest used for the supplied export file.
+ *
+ * @param path The path of the export file
+ *
+ * @return The manifest path
+ */
++ (NSString *)manifestPathForExportFilePath:(NSString *)path
+{
+	return [path stringByAppendingPathExtension:SPExportCheckpointManifestExtension];
+}
+
+/**
+ * Loads the checkpoint previously recorded for the supplied export file.
+ *
+ * @param path The path of the export file
+ *
+ * @return The checkpoint or nil if no valid manifest exists for the file
+ */
++ (SPExportCheckpoint *)checkpointForExportFilePath:(NSString *)path
+{
+	NSData *manifestData = [NSData dataWithContentsOfFile:[self manifestPathForExportFilePath:path]];
+
+	if (!manifestData) return nil;
+
+	NSDictionary *manifest = [NSPropertyListSerialization propertyListWithData:manifestData options:NSPropertyListImmutable format:NULL error:NULL];
+
+	if (![manifest isKindOfClass:[NSDictionary class]] || [[manifest objectForKey:SPExportCheckpointVersionKey] integerValue] != SPExportCheckpointManifestVersion) return nil;
+
+	SPExportCheckpoint *checkpoint = [[SPExportCheckpoint alloc] initWithExportFilePath:path];
+
+	[checkpoint setExportFormat:[manifest objectForKey:SPExportCheckpointFormatKey]];
+	[checkpoint setDatabaseName:[manifest objectForKey:SPExportCheckpointDatabaseKey]];
+
+	id tables = [manifest objectForKey:SPExportCheckpointCompletedTablesKey];
+
+	if ([tables isKindOfClass:[NSArray class]]) [checkpoint->completedTables addObjectsFromArray:tables];
+
+	checkpoint->currentTable = [[manifest objectForKey:SPExportCheckpointCurrentTableKey] copy];
+	checkpoint->lastKey = [[manifest objectForKey:SPExportCheckpointLastKeyKey] copy];
+	checkpoint->byteOffset = [[manifest objectForKey:SPExportCheckpointByteOffsetKey] unsignedLongLongValue];
+
+	return checkpoint;
+}
+
+/**
+ * Initialise an empty checkpoint for the supplied export file.
+ *
+ * @param path The path of the export file
+ *
+ * @return The initialised instance
+ */
+- (instancetype)initWithExportFilePath:(NSString *)path
+{
+	if ((self = [super init])) {
+		exportFilePath = [path copy];
+		completedTables = [[NSMutableArray alloc] init];
+		currentTable = nil;
+		lastKey = nil;
+		byteOffset = 0;
+	}
+
+	return self;
+}
+
+#pragma mark -
+#pragma mark Checkpoint state
+
+/**
+ * Returns whether any output has been recorded, i.e. whether there is anything to resume from.
+ */
+- (BOOL)hasProgress
+{
+	return (byteOffset > 0);
+}
+
+/**
+ * Returns whether the supplied table has been completely written.
+ *
+ * @param table The table name
+ */
+- (BOOL)isTableCompleted:(NSString *)table
+{
+	return [completedTables containsObject:table];
+}
+
+/**
+ * Returns whether any data for the supplied table precedes the recorded byte offset, either
+ * because the table was completed or because it was part way through being exported.
+ *
+ * @param table The table name
+ */
+- (BOOL)hasOutputForTable:(NSString *)table
+{
+	return [self isTableCompleted:table] || [self lastKeyForTable:table] != nil;
+}
+
+/**
+ * Returns the last primary key literal written for the supplied table, or nil if the
+ * table was not being exported when the checkpoint was recorded.
+ *
+ * @param table The table name
+ */
+- (NSString *)lastKeyForTable:(NSString *)table
+{
+	return [currentTable isEqualToString:table] ? lastKey : nil;
+}
+
+/**
+ * Records a consistent position in the export file which isn't tied to a table (e.g. after the dump header).
+ *
+ * @param offset The byte offset in the export file
+ */
+- (void)recordByteOffset:(unsigned long long)offset
+{
+	byteOffset = offset;
+
+	[self writeManifest];
+}
+
+/**
+ * Records that all rows of the supplied table up to and including the supplied key have been written.
+ *
+ * @param key    The SQL literal of the last primary key value written
+ * @param table  The table name
+ * @param offset The byte offset in the export file after the last complete chunk
+ */
+- (void)recordLastKey:(NSString *)key forTable:(NSString *)table atByteOffset:(unsigned long long)offset
+{
+	currentTable = [table copy];
+	lastKey = [key copy];
+	byteOffset = offset;
+
+	[self writeManifest];
+}
+
+/**
+ * Records that the supplied table has been completely written.
+ *
+ * @param table  The table name
+ * @param offset The byte offset in the export file after the table's output
+ */
+- (void)recordCompletedTable:(NSString *)table atByteOffset:(unsigned long long)offset
+{
+	if (![completedTables containsObject:table]) [completedTables addObject:table];
+
+	currentTable = nil;
+	lastKey = nil;
+	byteOffset = offset;
+
+	[self writeManifest];
+}
+
+#pragma mark -
+#pragma mark Manifest
+
+/**
+ * Writes the checkpoint to the sidecar manifest, replacing the previous one atomically.
+ *
+ * @return A BOOL indicating the success of writing the manifest
+ */
+- (BOOL)writeManifest
+{
+	NSMutableDictionary *manifest = [NSMutableDictionary dictionaryWithDictionary:@{
+		SPExportCheckpointVersionKey:         @(SPExportCheckpointManifestVersion),
+		SPExportCheckpointCompletedTablesKey: [completedTables copy],
+		SPExportCheckpointByteOffsetKey:      @(byteOffset)
+	}];
+
+	if (exportFormat) [manifest setObject:exportFormat forKey:SPExportCheckpointFormatKey];
+	if (databaseName) [manifest setObject:databaseName forKey:SPExportCheckpointDatabaseKey];
+
+	if (currentTable && lastKey) {
+		[manifest setObject:currentTable forKey:SPExportCheckpointCurrentTableKey];
+		[manifest setObject:lastKey forKey:SPExportCheckpointLastKeyKey];
+	}
+
+	NSData *manifestData = [NSPropertyListSerialization dataWithPropertyList:manifest format:NSPropertyListXMLFormat_v1_0 options:0 error:NULL];
+
+	return [manifestData writeToFile:[[self class] manifestPathForExportFilePath:exportFilePath] atomically:YES];
+}
+
+/**
+ * Removes the sidecar manifest from disk, e.g. once the export has completed.
+ */
+- (void)removeManifest
+{
+	NSString *manifestPath = [[self class] manifestPathForExportFilePath:exportFilePath];
+
+	if ([[NSFileManager defaultManager] fileExistsAtPath:manifestPath]) {
+		[[NSFileManager defaultManager] removeItemAtPath:manifestPath error:nil];
+	}
+}
+
+@end
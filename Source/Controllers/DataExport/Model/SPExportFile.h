@@ -29,6 +29,9 @@
 //  More info at <https://github.com/sequelpro/sequelpro>
 
 @class SPFileHandle;
+@class SPExportCheckpoint;
+@class SPExportPartManifest;
+@class SPTransferStatistics;
 
 /**
  * @class SPExportFile SPExportFile.h
@@ -48,6 +51,20 @@
 	BOOL exportFileNeedsXMLHeader;
 	
 	SPFileHandle *exportFileHandle;
+	SPExportCheckpoint *exportCheckpoint;
+
+	SPExportPartManifest *exportPartManifest;
+	unsigned long long splitByteLimit;
+	NSUInteger splitRowLimit;
+	unsigned long long currentPartLength;
+	NSUInteger currentPartRowCount;
+
+	SPTransferStatistics *transferStatistics;
+	unsigned long long reportedStoredLength;
+	uint64_t reportedCompressionNanoseconds;
+	uint64_t reportedDiskNanoseconds;
+	uint64_t reportedWriterWaitNanoseconds;
+	uint64_t writerWaitNanoseconds;
 	
 	SPExportFileHandleStatus exportFileHandleStatus;
 }
@@ -88,6 +105,36 @@
  */
 @property (readonly) SPExportFileHandleStatus exportFileHandleStatus;
 
+/**
+ * @property exportCheckpoint The resume checkpoint of a chunked export, nil if the export can't be resumed
+ */
+@property (readwrite, strong) SPExportCheckpoint *exportCheckpoint;
+
+/**
+ * @property splitByteLimit The number of (uncompressed) bytes after which the output rolls over to a new part, 0 for no limit
+ */
+@property (readwrite, assign) unsigned long long splitByteLimit;
+
+/**
+ * @property splitRowLimit The number of rows after which the output rolls over to a new part, 0 for no limit
+ */
+@property (readwrite, assign) NSUInteger splitRowLimit;
+
+/**
+ * @property exportPartManifest The manifest listing the parts of a split export, nil if the output isn't split
+ */
+@property (readonly) SPExportPartManifest *exportPartManifest;
+
+/**
+ * @property transferStatistics The statistics the file's written, stored and compressed lengths are added to, if any
+ */
+@property (readwrite, strong) SPTransferStatistics *transferStatistics;
+
+/**
+ * @property writerWaitNanoseconds The time writes have spent blocked waiting for compression or the disk to catch up
+ */
+@property (readonly) uint64_t writerWaitNanoseconds;
+
 + (SPExportFile *)exportFileAtPath:(NSString *)path;
 
 - (instancetype)initWithFilePath:(NSString *)path;
@@ -96,6 +143,15 @@
 - (BOOL)delete;
 - (void)writeData:(NSData *)data;
 - (SPExportFileHandleStatus)createExportFileHandle:(BOOL)overwrite;
+- (SPExportFileHandleStatus)resumeExportFileHandleFromCheckpoint:(SPExportCheckpoint *)checkpoint;
+- (unsigned long long)synchronizedLength;
 - (void)setCompressionFormat:(SPFileCompressionFormat)fileCompressionFormat;
 
+- (void)splitOutputWithFormat:(NSString *)format database:(NSString *)database;
+- (BOOL)splitsOutput;
+- (BOOL)currentPartIsFull;
+- (BOOL)startNextPart;
+- (void)recordRows:(NSUInteger)rowCount forTable:(NSString *)table;
+- (void)recordStructureForTable:(NSString *)table;
+
 @end
@@ -30,12 +30,18 @@
 
 #import "SPExportFile.h"
 #import "SPFileHandle.h"
+#import "SPExportCheckpoint.h"
+#import "SPExportPartManifest.h"
+#import "SPTransferStatistics.h"
 
 #import "sequel-ace-Swift.h"
 
 @interface SPExportFile ()
 
 - (SPExportFileHandleStatus)_createFileHandle;
+- (void)_reportFileHandleStatistics;
+- (void)_resetFileHandleStatistics;
+- (BOOL)_checkForWriteFailure;
 
 @end
 
@@ -48,6 +54,12 @@
 @synthesize exportFileHandleStatus;
 @synthesize exportFileNeedsUserChosenDir;
 @synthesize fileHandleError;
+@synthesize exportCheckpoint;
+@synthesize exportPartManifest;
+@synthesize splitByteLimit;
+@synthesize splitRowLimit;
+@synthesize transferStatistics;
+@synthesize writerWaitNanoseconds;
 
 #pragma mark -
 #pragma mark Initialisation
@@ -101,6 +113,15 @@
     SPLog(@"calling closeFile");
 
 	[[self exportFileHandle] closeFile];
+
+	[self _checkForWriteFailure];
+
+	[self _reportFileHandleStatistics];
+
+	if (exportPartManifest) {
+		[exportPartManifest recordFileSizeOfCurrentPart];
+		[exportPartManifest writeManifest];
+	}
 }
 
 /**
@@ -110,12 +131,27 @@
  */
 - (BOOL)delete
 {
-	if ((![self exportFilePath]) || (![self exportFileHandle]) || ([[self exportFilePath] length] == 0)) return NO;
+	if ((![self exportFilePath]) || (![self exportFileHandle] && !exportPartManifest) || ([[self exportFilePath] length] == 0)) return NO;
 
 	// Ensure the file is closed to allow all processing threads to close
 	[self close];
 
+	// A resume checkpoint is meaningless without the file it describes
+	[[self exportCheckpoint] removeManifest];
+
 	NSFileManager *fileManager = [NSFileManager defaultManager];
+
+	// Remove any further parts of a split export along with their manifest
+	if (exportPartManifest) {
+		for (NSString *partPath in [exportPartManifest partPaths])
+		{
+			if (![partPath isEqualToString:[self exportFilePath]] && [fileManager fileExistsAtPath:partPath]) {
+				[fileManager removeItemAtPath:partPath error:nil];
+			}
+		}
+
+		[exportPartManifest removeManifest];
+	}
 	
 	if ([fileManager fileExistsAtPath:[self exportFilePath]]) {
 		return [fileManager removeItemAtPath:[self exportFilePath] error:nil];
@@ -140,8 +176,18 @@
         fileHandleError = exportFilePath;
 		return;
 	}
-			
+
+	currentPartLength += [data length];
+
 	[[self exportFileHandle] writeData:data];
+
+	[self _checkForWriteFailure];
+
+	if (transferStatistics) {
+		[transferStatistics addFileBytes:[data length]];
+
+		[self _reportFileHandleStatistics];
+	}
 }
 
 /**
@@ -188,6 +234,67 @@
 	return exportFileHandleStatus;
 }
 
+/**
+ * Reopens an existing export file for appending at the supplied checkpoint. Anything written after the
+ * checkpoint's byte offset is discarded first, as it may end part way through a statement or row.
+ *
+ * @param checkpoint The checkpoint from which the export will be resumed
+ *
+ * @return One of SPExportFileHandleStatus indicating the status of its creation.
+ */
+- (SPExportFileHandleStatus)resumeExportFileHandleFromCheckpoint:(SPExportCheckpoint *)checkpoint
+{
+	NSFileManager *fileManager = [NSFileManager defaultManager];
+	NSDictionary *attributes = [fileManager attributesOfItemAtPath:[self exportFilePath] error:nil];
+
+	// The file must still hold at least everything up to the checkpoint
+	if (!attributes || ![fileManager isWritableFileAtPath:[self exportFilePath]] || [attributes fileSize] < [checkpoint byteOffset]) {
+		exportFileHandleStatus = SPExportFileHandleFailed;
+
+		return exportFileHandleStatus;
+	}
+
+	if (truncate([[self exportFilePath] fileSystemRepresentation], (off_t)[checkpoint byteOffset]) != 0) {
+		SPLog(@"truncate failed: %@", [self exportFilePath]);
+		exportFileHandleStatus = SPExportFileHandleFailed;
+
+		return exportFileHandleStatus;
+	}
+
+	exportFileHandle = [SPFileHandle fileHandleForAppendingAtPath:[self exportFilePath]];
+
+	[self _resetFileHandleStatistics];
+
+	if (!exportFileHandle) {
+		exportFileHandleStatus = SPExportFileHandleFailed;
+
+		return exportFileHandleStatus;
+	}
+
+	[self setExportCheckpoint:checkpoint];
+
+	exportFileHandleStatus = SPExportFileHandleCreated;
+
+	return exportFileHandleStatus;
+}
+
+/**
+ * Blocks until all data written so far is on disk and returns the length of the file's content,
+ * which can be recorded as a resume checkpoint for uncompressed files.
+ *
+ * @return The number of bytes written to the file
+ */
+- (unsigned long long)synchronizedLength
+{
+	if (![self exportFileHandle]) return 0;
+
+	[[self exportFileHandle] synchronizeFile];
+
+	[self _checkForWriteFailure];
+
+	return [[self exportFileHandle] dataWrittenLength];
+}
+
 /**
  * Sets the compression level on the newly created file. Throws an exception
  * if attempting to set the compression level when no file handle exists.
@@ -204,9 +311,142 @@
 	[[self exportFileHandle] setCompressionFormat:fileCompressionFormat];
 }
 
+#pragma mark -
+#pragma mark Split Output
+
+/**
+ * Splits the output of the newly created file into numbered parts according to the split limits, which
+ * must have been set. The file itself becomes the first part, and a manifest listing the parts is
+ * maintained next to it.
+ *
+ * @param format   The export format description recorded in the manifest
+ * @param database The database name recorded in the manifest
+ */
+- (void)splitOutputWithFormat:(NSString *)format database:(NSString *)database
+{
+	if (!splitByteLimit && !splitRowLimit) return;
+
+	exportPartManifest = [[SPExportPartManifest alloc] initWithExportFilePath:[self exportFilePath]];
+
+	[exportPartManifest setExportFormat:format];
+	[exportPartManifest setDatabaseName:database];
+	[exportPartManifest beginNextPart];
+	[exportPartManifest writeManifest];
+
+	currentPartLength = 0;
+	currentPartRowCount = 0;
+}
+
+/**
+ * Returns whether the output is split into parts.
+ */
+- (BOOL)splitsOutput
+{
+	return (exportPartManifest != nil);
+}
+
+/**
+ * Returns whether the current part has reached one of the split limits. Exporters check this at points
+ * where a new part can start cleanly, e.g. between statements, so parts may slightly exceed the limits.
+ */
+- (BOOL)currentPartIsFull
+{
+	if (!exportPartManifest) return NO;
+
+	return (splitByteLimit && currentPartLength >= splitByteLimit) || (splitRowLimit && currentPartRowCount >= splitRowLimit);
+}
+
+/**
+ * Closes the current part and continues the output in a new one, using the same compression format.
+ *
+ * @return A BOOL indicating whether the new part was created; on failure the file handle error is set
+ */
+- (BOOL)startNextPart
+{
+	if (!exportPartManifest || ![self exportFileHandle]) return NO;
+
+	SPFileCompressionFormat compressionFormat = [[self exportFileHandle] compressionFormat];
+
+	[self close];
+
+	// The finished part couldn't be written completely, so there is nothing to continue
+	if (fileHandleError) return NO;
+
+	NSString *partPath = [exportPartManifest beginNextPart];
+
+	exportFileHandle = nil;
+
+	if ([[NSFileManager defaultManager] createFileAtPath:partPath contents:[NSData data] attributes:nil]) {
+		exportFileHandle = [SPFileHandle fileHandleForWritingAtPath:partPath];
+	}
+
+	[self _resetFileHandleStatistics];
+
+	if (!exportFileHandle) {
+		SPLog(@"Failed to create export part: %@", partPath);
+		fileHandleError = partPath;
+
+		return NO;
+	}
+
+	[exportFileHandle setCompressionFormat:compressionFormat];
+
+	currentPartLength = 0;
+	currentPartRowCount = 0;
+
+	[exportPartManifest writeManifest];
+
+	return YES;
+}
+
+/**
+ * Records that the supplied number of rows of a table have been written to the current part.
+ *
+ * @param rowCount The number of rows written
+ * @param table    The table name
+ */
+- (void)recordRows:(NSUInteger)rowCount forTable:(NSString *)table
+{
+	if (!exportPartManifest) return;
+
+	currentPartRowCount += rowCount;
+
+	[exportPartManifest recordRows:rowCount forTable:table];
+}
+
+/**
+ * Records that the structure of the supplied table has been written to the current part.
+ *
+ * @param table The table name
+ */
+- (void)recordStructureForTable:(NSString *)table
+{
+	[exportPartManifest recordStructureForTable:table];
+}
+
 #pragma mark -
 #pragma mark Private API
 
+/**
+ * Sets the file handle error to the file being written if the file handle failed to write any of its data.
+ *
+ * @return A BOOL indicating whether writing has failed
+ */
+- (BOOL)_checkForWriteFailure
+{
+	if (![[self exportFileHandle] writeFailed]) return NO;
+
+	if (!fileHandleError) {
+		NSString *path = exportPartManifest ? [[exportPartManifest partPaths] lastObject] : nil;
+
+		SPLog(@"Failed to write to: %@", path ?: exportFilePath);
+
+		fileHandleError = path ?: exportFilePath;
+	}
+
+	return YES;
+}
+
 /**
  * Creates the actual empty file handle and establishes a file handle to it.
  *
@@ -224,6 +464,8 @@
 	
 	// Retrieve a filehandle for the file, attempting to delete it on failure.
 	exportFileHandle = [SPFileHandle fileHandleForWritingAtPath:[self exportFilePath]];
+
+	[self _resetFileHandleStatistics];
 	
 	if (!exportFileHandle) {
         SPLog(@"fileHandleForWritingAtPath failed: %@",[self exportFilePath]);
@@ -235,4 +477,40 @@
 	return SPExportFileHandleCreated;
 }
 
+/**
+ * Adds whatever the current file handle has stored, and the time its compression and disk stages
+ * have spent busy, to the transfer statistics since they were last reported.
+ */
+- (void)_reportFileHandleStatistics
+{
+	if (!exportFileHandle) return;
+
+	unsigned long long storedLength = [exportFileHandle dataStoredLength];
+	uint64_t compressionNanoseconds = [exportFileHandle countersForWriteStage:SPFileHandleCompressionStage].busyNanoseconds;
+	uint64_t diskNanoseconds = [exportFileHandle countersForWriteStage:SPFileHandleDiskWriteStage].busyNanoseconds;
+	uint64_t waitNanoseconds = [exportFileHandle writerWaitNanoseconds];
+
+	[transferStatistics addStoredFileBytes:storedLength - reportedStoredLength];
+	[transferStatistics addNanoseconds:compressionNanoseconds - reportedCompressionNanoseconds toStage:SPTransferCompressionStage];
+	[transferStatistics addNanoseconds:diskNanoseconds - reportedDiskNanoseconds toStage:SPTransferDiskStage];
+
+	writerWaitNanoseconds += waitNanoseconds - reportedWriterWaitNanoseconds;
+
+	reportedStoredLength = storedLength;
+	reportedCompressionNanoseconds = compressionNanoseconds;
+	reportedDiskNanoseconds = diskNanoseconds;
+	reportedWriterWaitNanoseconds = waitNanoseconds;
+}
+
+/**
+ * Restarts the reported figures for a newly created file handle, whose counters start at zero.
+ */
+- (void)_resetFileHandleStatistics
+{
+	reportedStoredLength = 0;
+	reportedCompressionNanoseconds = 0;
+	reportedDiskNanoseconds = 0;
+	reportedWriterWaitNanoseconds = 0;
+}
+
 @end
@@ -0,0 +1,55 @@
+//
+//  SPExportLoadedResult.h
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+
+@class SPDataStorage;
+
+/**
+ * @class SPExportLoadedResult SPExportLoadedResult.h
+ *
+ * Presents a result which has already been loaded into an SPDataStorage as the data array exporters
+ * consume: the first object holds the field names, each following object one row. Rows are only
+ * created when an exporter asks for them, so exporting a loaded result neither re-runs its query nor
+ * copies the whole result into arrays up front. Values are converted the same way as for a copied
+ * result: NULLs are preserved, geometry is written as WKT and binary data as a string.
+ */
+@interface SPExportLoadedResult : NSArray
+{
+	SPDataStorage *resultData;
+	NSArray *fieldNames;
+	NSUInteger *columnIndexes;
+	NSUInteger columnCount;
+	NSUInteger rowCount;
+	NSStringEncoding stringEncoding;
+}
+
+- (instancetype)initWithDataStorage:(SPDataStorage *)storage fieldNames:(NSArray *)names columnIndexes:(NSArray *)indexes stringEncoding:(NSStringEncoding)encoding;
+
+@end
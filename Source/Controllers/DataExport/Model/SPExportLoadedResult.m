@@ -0,0 +1,115 @@
+//
+//  SPExportLoadedResult.m
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+
+#import "SPExportLoadedResult.h"
+#import "SPDataStorage.h"
+
+#import <SPMySQL/SPMySQL.h>
+
+@implementation SPExportLoadedResult
+
+/**
+ * Initialise an instance presenting the supplied loaded result.
+ *
+ * @param storage  The data storage holding the completely loaded result
+ * @param names    The field names, in output order
+ * @param indexes  The storage column index (NSNumber) of each field, in output order
+ * @param encoding The encoding used to convert binary data to strings
+ *
+ * @return The initialised instance
+ */
+- (instancetype)initWithDataStorage:(SPDataStorage *)storage fieldNames:(NSArray *)names columnIndexes:(NSArray *)indexes stringEncoding:(NSStringEncoding)encoding
+{
+	if ((self = [super init])) {
+		resultData = storage;
+		fieldNames = [names copy];
+		stringEncoding = encoding;
+
+		// The row count is fixed up front, as the result is complete and the export sheet prevents edits
+		rowCount = [storage count];
+		columnCount = [indexes count];
+		columnIndexes = calloc(MAX(columnCount, 1), sizeof(NSUInteger));
+
+		for (NSUInteger i = 0; i < columnCount; i++)
+		{
+			columnIndexes[i] = [[indexes objectAtIndex:i] unsignedIntegerValue];
+		}
+	}
+
+	return self;
+}
+
+#pragma mark -
+#pragma mark NSArray primitives
+
+- (NSUInteger)count
+{
+	return rowCount + 1;
+}
+
+/**
+ * Returns the field names for index 0, otherwise a newly created array holding the row before the index.
+ */
+- (id)objectAtIndex:(NSUInteger)index
+{
+	if (index == 0) return fieldNames;
+
+	if (index > rowCount) {
+		[NSException raise:NSRangeException format:@"Requested export row (%llu) beyond bounds (%llu)", (unsigned long long)index, (unsigned long long)rowCount];
+	}
+
+	NSMutableArray *row = [NSMutableArray arrayWithCapacity:columnCount];
+
+	for (NSUInteger i = 0; i < columnCount; i++)
+	{
+		id value = SPDataStorageObjectAtRowAndColumn(resultData, index - 1, columnIndexes[i]);
+
+		if ([value isKindOfClass:[SPMySQLGeometryData class]]) {
+			value = [value wktString];
+		}
+		else if ([value isKindOfClass:[NSData class]]) {
+			value = [value stringRepresentationUsingEncoding:stringEncoding];
+		}
+
+		[row addObject:value];
+	}
+
+	return row;
+}
+
+#pragma mark -
+
+- (void)dealloc
+{
+	free(columnIndexes);
+}
+
+@end
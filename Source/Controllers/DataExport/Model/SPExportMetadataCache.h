@@ -0,0 +1,68 @@
+//
+//  SPExportMetadataCache.h
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+
+#import <SPMySQL/SPMySQL.h>
+
+/**
+ * @class SPExportMetadataCache SPExportMetadataCache.h
+ *
+ * Prefetches the schema metadata an export needs before it starts writing, instead of querying it one
+ * object at a time. The SHOW CREATE statements of tables and routines are retrieved in parallel over a
+ * small pool of copies of the export connection, each using the export session's SQL mode so they return
+ * the same DDL as the export connection would, and the triggers of the whole database are read with a
+ * single information_schema query. Exporters ask the cache first and fall back to querying the server
+ * themselves for anything it doesn't hold, e.g. when the schema is too small to be worth a pool.
+ */
+@interface SPExportMetadataCache : NSObject <SPMySQLConnectionDelegate>
+{
+	SPMySQLConnection *connection;
+	NSString *databaseName;
+	NSString *sqlMode;
+
+	NSMutableDictionary *createResults;
+	NSMutableDictionary *tableTriggers;
+}
+
+/**
+ * @property databaseName The database the metadata is retrieved from
+ */
+@property (readonly, copy) NSString *databaseName;
+
+- (instancetype)initWithConnection:(SPMySQLConnection *)aConnection database:(NSString *)database;
+
+- (void)prefetchCreateStatementsForTables:(NSArray *)tables procedures:(NSArray *)procedures functions:(NSArray *)functions forOperation:(NSOperation *)operation;
+- (void)prefetchTriggers;
+
+- (NSDictionary *)createResultForTable:(NSString *)table;
+- (NSDictionary *)createResultForRoutine:(NSString *)routine ofType:(NSString *)routineType;
+- (NSArray *)triggersForTable:(NSString *)table;
+
+@end
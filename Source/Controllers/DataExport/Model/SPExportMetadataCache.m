@@ -0,0 +1,291 @@
+//
+//  SPExportMetadataCache.m
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+
+#import "SPExportMetadataCache.h"
+
+// The most connections opened to fetch CREATE statements, and the fewest statements worth a connection
+static const NSUInteger SPExportMetadataMaxConnections = 4;
+static const NSUInteger SPExportMetadataStatementsPerConnection = 32;
+
+@interface SPExportMetadataCache ()
+
+- (SPMySQLConnection *)_connectedCopyOfConnection;
+- (NSString *)_keyForObject:(NSString *)name ofType:(NSString *)type;
+
+@end
+
+@implementation SPExportMetadataCache
+
+@synthesize databaseName;
+
+#pragma mark -
+#pragma mark Initialisation
+
+/**
+ * Initialise an empty cache for the supplied connection and database.
+ *
+ * @param aConnection The export connection, which the pooled connections are copied from
+ * @param database    The database the metadata is retrieved from
+ *
+ * @return The initialised instance
+ */
+- (instancetype)initWithConnection:(SPMySQLConnection *)aConnection database:(NSString *)database
+{
+	if ((self = [super init])) {
+		connection = aConnection;
+		databaseName = [database copy];
+		createResults = [[NSMutableDictionary alloc] init];
+		tableTriggers = nil;
+	}
+
+	return self;
+}
+
+#pragma mark -
+#pragma mark Prefetching
+
+/**
+ * Retrieves the SHOW CREATE results of the supplied tables and routines in parallel, blocking until all
+ * have been retrieved or the operation has been cancelled. Statements which fail aren't cached, so the
+ * exporter retrieves them again itself and reports the error as usual.
+ *
+ * @param tables     The names of the tables and views
+ * @param procedures The names of the stored procedures
+ * @param functions  The names of the stored functions
+ * @param operation  The export operation, whose cancellation stops the prefetch
+ */
+- (void)prefetchCreateStatementsForTables:(NSArray *)tables procedures:(NSArray *)procedures functions:(NSArray *)functions forOperation:(NSOperation *)operation
+{
+	NSMutableArray *keys = [NSMutableArray array];
+
+	for (NSString *table in tables) [keys addObject:[self _keyForObject:table ofType:@"TABLE"]];
+	for (NSString *procedure in procedures) [keys addObject:[self _keyForObject:procedure ofType:@"PROCEDURE"]];
+	for (NSString *function in functions) [keys addObject:[self _keyForObject:function ofType:@"FUNCTION"]];
+
+	NSUInteger connectionCount = MIN(SPExportMetadataMaxConnections, [keys count] / SPExportMetadataStatementsPerConnection);
+
+	// Opening connections isn't worth it for a handful of statements
+	if (connectionCount < 2) return;
+
+	// The SQL mode affects the quoting of SHOW CREATE results, so the pooled connections use the export session's
+	SPMySQLResult *sqlModeResult = [connection queryString:@"SELECT @@SESSION.sql_mode"];
+
+	if ([connection queryErrored]) return;
+
+	[sqlModeResult setReturnDataAsStrings:YES];
+
+	sqlMode = [[[sqlModeResult getRowAsArray] firstObject] unboxNull];
+
+	if (!sqlMode) return;
+
+	__block NSUInteger nextKeyIndex = 0;
+
+	dispatch_apply(connectionCount, dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^(size_t worker) {
+		@autoreleasepool {
+			SPMySQLConnection *workerConnection = [self _connectedCopyOfConnection];
+
+			if (!workerConnection) return;
+
+			NSMutableDictionary *results = [NSMutableDictionary dictionary];
+
+			while (![operation isCancelled])
+			{
+				NSString *key = nil;
+
+				@synchronized(keys) {
+					if (nextKeyIndex < [keys count]) key = [keys objectAtIndex:nextKeyIndex++];
+				}
+
+				if (!key) break;
+
+				NSRange separator = [key rangeOfString:@" "];
+
+				SPMySQLResult *result = [workerConnection queryString:[NSString stringWithFormat:@"SHOW CREATE %@ %@", [key substringToIndex:separator.location], [[key substringFromIndex:NSMaxRange(separator)] backtickQuotedString]]];
+
+				[result setReturnDataAsStrings:YES];
+
+				if ([workerConnection queryErrored] || ![result numberOfRows]) continue;
+
+				NSDictionary *row = [result getRowAsDictionary];
+
+				if (row) [results setObject:row forKey:key];
+			}
+
+			[workerConnection disconnect];
+
+			@synchronized(self->createResults) {
+				[self->createResults addEntriesFromDictionary:results];
+			}
+		}
+	});
+}
+
+/**
+ * Retrieves the triggers of all tables in the database with a single information_schema query, returning
+ * the same fields as SHOW TRIGGERS. On failure no triggers are cached and each table's are queried instead.
+ */
+- (void)prefetchTriggers
+{
+	// Triggers are executed in ACTION_ORDER if there are several for the same timing and event
+	NSString *order = [connection serverVersionIsGreaterThanOrEqualTo:5 minorVersion:7 releaseVersion:2] ? @"EVENT_OBJECT_TABLE, ACTION_ORDER" : @"EVENT_OBJECT_TABLE, TRIGGER_NAME";
+
+	SPMySQLResult *result = [connection queryString:[NSString stringWithFormat:@"SELECT TRIGGER_NAME AS `Trigger`, EVENT_MANIPULATION AS `Event`, EVENT_OBJECT_TABLE AS `Table`, ACTION_STATEMENT AS `Statement`, ACTION_TIMING AS `Timing`, SQL_MODE AS `sql_mode`, DEFINER AS `Definer` FROM information_schema.TRIGGERS WHERE EVENT_OBJECT_SCHEMA = %@ ORDER BY %@", [databaseName tickQuotedString], order]];
+
+	if ([connection queryErrored]) return;
+
+	[result setReturnDataAsStrings:YES];
+
+	NSMutableDictionary *triggers = [NSMutableDictionary dictionary];
+
+	for (NSUInteger i = 0; i < [result numberOfRows]; i++)
+	{
+		NSDictionary *trigger = [result getRowAsDictionary];
+		NSString *table = [trigger objectForKey:@"Table"];
+
+		if (![triggers objectForKey:table]) [triggers setObject:[NSMutableArray array] forKey:table];
+
+		[[triggers objectForKey:table] addObject:trigger];
+	}
+
+	tableTriggers = triggers;
+}
+
+#pragma mark -
+#pragma mark Cached metadata
+
+/**
+ * Returns the SHOW CREATE TABLE result row (with either Create Table or Create View) for the supplied
+ * table, or nil if it hasn't been prefetched.
+ *
+ * @param table The table or view name
+ */
+- (NSDictionary *)createResultForTable:(NSString *)table
+{
+	@synchronized(createResults) {
+		return [createResults objectForKey:[self _keyForObject:table ofType:@"TABLE"]];
+	}
+}
+
+/**
+ * Returns the SHOW CREATE PROCEDURE or FUNCTION result row for the supplied routine, or nil if it
+ * hasn't been prefetched.
+ *
+ * @param routine     The routine name
+ * @param routineType Either PROCEDURE or FUNCTION
+ */
+- (NSDictionary *)createResultForRoutine:(NSString *)routine ofType:(NSString *)routineType
+{
+	@synchronized(createResults) {
+		return [createResults objectForKey:[self _keyForObject:routine ofType:routineType]];
+	}
+}
+
+/**
+ * Returns the triggers of the supplied table in SHOW TRIGGERS form, an empty array if it has none, or
+ * nil if the triggers haven't been prefetched.
+ *
+ * @param table The table name
+ */
+- (NSArray *)triggersForTable:(NSString *)table
+{
+	if (!tableTriggers) return nil;
+
+	return [tableTriggers objectForKey:table] ?: @[];
+}
+
+#pragma mark -
+#pragma mark SPMySQLConnection delegate methods
+
+/**
+ * Forward keychain password requests for the pooled connections to the export connection's delegate.
+ */
+- (NSString *)keychainPasswordForConnection:(id)aConnection
+{
+	NSObject <SPMySQLConnectionDelegate> *connectionDelegate = [connection delegate];
+
+	if (![connectionDelegate respondsToSelector:@selector(keychainPasswordForConnection:)]) return nil;
+
+	return [connectionDelegate keychainPasswordForConnection:connection];
+}
+
+/**
+ * Pooled connections are never reconnected; whatever they failed to fetch is queried by the exporter.
+ */
+- (SPMySQLConnectionLostDecision)connectionLost:(id)aConnection
+{
+	return SPMySQLConnectionLostDisconnect;
+}
+
+#pragma mark -
+#pragma mark Private API
+
+/**
+ * Returns a new connection with the export connection's settings and session SQL mode, connected to the
+ * cached database, or nil if any of those couldn't be applied.
+ */
+- (SPMySQLConnection *)_connectedCopyOfConnection
+{
+	SPMySQLConnection *copy = [connection copy];
+
+	[copy setDelegate:self];
+	[copy setDelegateQueryLogging:NO];
+	[copy setRetryQueriesOnConnectionFailure:NO];
+
+	if (![copy connect]) return nil;
+
+	if (![copy selectDatabase:databaseName]) {
+		[copy disconnect];
+
+		return nil;
+	}
+
+	[copy setEncoding:@"utf8mb4"];
+
+	[copy queryString:[NSString stringWithFormat:@"SET SQL_MODE=%@", [sqlMode tickQuotedString]]];
+
+	if ([copy queryErrored]) {
+		[copy disconnect];
+
+		return nil;
+	}
+
+	return copy;
+}
+
+/**
+ * Returns the cache key of a schema object, which is unique as the type never contains a space.
+ */
+- (NSString *)_keyForObject:(NSString *)name ofType:(NSString *)type
+{
+	return [NSString stringWithFormat:@"%@ %@", type, name];
+}
+
+@end
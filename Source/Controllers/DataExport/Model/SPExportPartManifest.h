@@ -0,0 +1,86 @@
+//
+//  SPExportPartManifest.h
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+
+/**
+ * @class SPExportPartManifest SPExportPartManifest.h
+ *
+ * Describes an export which has been split into several numbered part files. The manifest is stored
+ * next to the first part and lists every part together with its size on disk and the number of rows
+ * it holds for each table, as well as the part containing each table's structure. Parts can then be
+ * verified and transferred individually, and restored in parallel once each table's structure exists.
+ */
+@interface SPExportPartManifest : NSObject
+{
+	NSString *exportFilePath;
+	NSString *exportFormat;
+	NSString *databaseName;
+
+	NSMutableArray *parts;
+	NSMutableDictionary *structureParts;
+}
+
+/**
+ * @property exportFilePath The path of the first part, from which the other part paths are derived
+ */
+@property (readonly, copy) NSString *exportFilePath;
+
+/**
+ * @property exportFormat The export format description (e.g. SQL or CSV) the parts were written in
+ */
+@property (readwrite, copy) NSString *exportFormat;
+
+/**
+ * @property databaseName The database the export was taken from
+ */
+@property (readwrite, copy) NSString *databaseName;
+
++ (NSString *)manifestPathForExportFilePath:(NSString *)path;
++ (NSString *)pathForPart:(NSUInteger)part ofExportFilePath:(NSString *)path;
++ (SPExportPartManifest *)manifestForExportFilePath:(NSString *)path;
+
+- (instancetype)initWithExportFilePath:(NSString *)path;
+
+- (NSUInteger)partCount;
+- (NSArray *)partPaths;
+- (NSArray *)partPathsForTable:(NSString *)table;
+- (NSString *)structurePartPathForTable:(NSString *)table;
+- (NSUInteger)rowCountForTable:(NSString *)table inPart:(NSUInteger)part;
+- (unsigned long long)fileSizeOfPart:(NSUInteger)part;
+
+- (NSString *)beginNextPart;
+- (void)recordRows:(NSUInteger)rowCount forTable:(NSString *)table;
+- (void)recordStructureForTable:(NSString *)table;
+- (void)recordFileSizeOfCurrentPart;
+
+- (BOOL)writeManifest;
+- (void)removeManifest;
+
+@end
@@ -0,0 +1,382 @@
+//
+//  SPExportPartManifest.m
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+
+#import "SPExportPartManifest.h"
+
+static NSString *SPExportPartManifestExtension = @"parts";
+static const NSInteger SPExportPartManifestVersion = 1;
+
+static NSString *SPExportPartManifestVersionKey         = @"version";
+static NSString *SPExportPartManifestFormatKey          = @"format";
+static NSString *SPExportPartManifestDatabaseKey        = @"database";
+static NSString *SPExportPartManifestPartsKey           = @"parts";
+static NSString *SPExportPartManifestStructurePartsKey  = @"structureParts";
+static NSString *SPExportPartManifestFileKey            = @"file";
+static NSString *SPExportPartManifestFileSizeKey        = @"bytes";
+static NSString *SPExportPartManifestTablesKey          = @"tables";
+static NSString *SPExportPartManifestTableNameKey       = @"name";
+static NSString *SPExportPartManifestTableRowCountKey   = @"rows";
+
+@interface SPExportPartManifest ()
+
+- (NSString *)_pathForPartFileName:(NSString *)fileName;
+
+@end
+
+@implementation SPExportPartManifest
+
+@synthesize exportFilePath;
+@synthesize exportFormat;
+@synthesize databaseName;
+
+#pragma mark -
+#pragma mark Initialisation
+
+/**
+ * Returns the path of the manifest used for the supplied (first part) export file.
+ *
+ * @param path The path of the export file
+ *
+ * @return The manifest path
+ */
++ (NSString *)manifestPathForExportFilePath:(NSString *)path
+{
+	return [path stringByAppendingPathExtension:SPExportPartManifestExtension];
+}
+
+/**
+ * Returns the path of the supplied part of an export. The first part keeps the export file's own
+ * path; later parts insert a zero padded part number in front of the format and compression
+ * extensions, e.g. dump.sql.gz, dump.part0002.sql.gz, dump.part0003.sql.gz.
+ *
+ * @param part The one-based part number
+ * @param path The path of the export file
+ *
+ * @return The part path
+ */
++ (NSString *)pathForPart:(NSUInteger)part ofExportFilePath:(NSString *)path
+{
+	if (part <= 1) return path;
+
+	NSString *stem = [path lastPathComponent];
+	NSMutableArray *extensions = [NSMutableArray array];
+
+	while ([@[@"gz", @"bz2"] containsObject:[[stem pathExtension] lowercaseString]]) {
+		[extensions insertObject:[stem pathExtension] atIndex:0];
+		stem = [stem stringByDeletingPathExtension];
+	}
+
+	if ([[stem pathExtension] length]) {
+		[extensions insertObject:[stem pathExtension] atIndex:0];
+		stem = [stem stringByDeletingPathExtension];
+	}
+
+	NSString *fileName = [stem stringByAppendingFormat:@".part%04lu", (unsigned long)part];
+
+	for (NSString *extension in extensions)
+	{
+		fileName = [fileName stringByAppendingPathExtension:extension];
+	}
+
+	return [[path stringByDeletingLastPathComponent] stringByAppendingPathComponent:fileName];
+}
+
+/**
+ * Loads the manifest previously written for the supplied export file.
+ *
+ * @param path The path of the export file (i.e. its first part)
+ *
+ * @return The manifest or nil if no valid manifest exists for the file
+ */
++ (SPExportPartManifest *)manifestForExportFilePath:(NSString *)path
+{
+	NSData *manifestData = [NSData dataWithContentsOfFile:[self manifestPathForExportFilePath:path]];
+
+	if (!manifestData) return nil;
+
+	NSDictionary *manifest = [NSPropertyListSerialization propertyListWithData:manifestData options:NSPropertyListMutableContainers format:NULL error:NULL];
+
+	if (![manifest isKindOfClass:[NSDictionary class]] || [[manifest objectForKey:SPExportPartManifestVersionKey] integerValue] != SPExportPartManifestVersion) return nil;
+
+	id loadedParts = [manifest objectForKey:SPExportPartManifestPartsKey];
+	id loadedStructureParts = [manifest objectForKey:SPExportPartManifestStructurePartsKey];
+
+	if (![loadedParts isKindOfClass:[NSArray class]]) return nil;
+
+	SPExportPartManifest *partManifest = [[SPExportPartManifest alloc] initWithExportFilePath:path];
+
+	[partManifest setExportFormat:[manifest objectForKey:SPExportPartManifestFormatKey]];
+	[partManifest setDatabaseName:[manifest objectForKey:SPExportPartManifestDatabaseKey]];
+
+	for (id part in loadedParts)
+	{
+		if (![part isKindOfClass:[NSDictionary class]] || ![[part objectForKey:SPExportPartManifestFileKey] isKindOfClass:[NSString class]]) return nil;
+
+		[partManifest->parts addObject:part];
+	}
+
+	if ([loadedStructureParts isKindOfClass:[NSDictionary class]]) [partManifest->structureParts addEntriesFromDictionary:loadedStructureParts];
+
+	return partManifest;
+}
+
+/**
+ * Initialise an empty manifest for the supplied export file.
+ *
+ * @param path The path of the export file, which becomes the first part
+ *
+ * @return The initialised instance
+ */
+- (instancetype)initWithExportFilePath:(NSString *)path
+{
+	if ((self = [super init])) {
+		exportFilePath = [path copy];
+		parts = [[NSMutableArray alloc] init];
+		structureParts = [[NSMutableDictionary alloc] init];
+	}
+
+	return self;
+}
+
+#pragma mark -
+#pragma mark Parts
+
+/**
+ * Returns the number of parts the export consists of.
+ */
+- (NSUInteger)partCount
+{
+	return [parts count];
+}
+
+/**
+ * Returns the paths of all parts in order.
+ */
+- (NSArray *)partPaths
+{
+	NSMutableArray *paths = [NSMutableArray arrayWithCapacity:[parts count]];
+
+	for (NSDictionary *part in parts)
+	{
+		[paths addObject:[self _pathForPartFileName:[part objectForKey:SPExportPartManifestFileKey]]];
+	}
+
+	return paths;
+}
+
+/**
+ * Returns the paths of the parts holding rows of the supplied table, in order.
+ *
+ * @param table The table name
+ */
+- (NSArray *)partPathsForTable:(NSString *)table
+{
+	NSMutableArray *paths = [NSMutableArray array];
+
+	for (NSDictionary *part in parts)
+	{
+		for (NSDictionary *tableEntry in [part objectForKey:SPExportPartManifestTablesKey])
+		{
+			if ([[tableEntry objectForKey:SPExportPartManifestTableNameKey] isEqualToString:table]) {
+				[paths addObject:[self _pathForPartFileName:[part objectForKey:SPExportPartManifestFileKey]]];
+				break;
+			}
+		}
+	}
+
+	return paths;
+}
+
+/**
+ * Returns the path of the part holding the structure of the supplied table, which has to be
+ * restored before any other part holding rows of the table, or nil if no structure was exported.
+ *
+ * @param table The table name
+ */
+- (NSString *)structurePartPathForTable:(NSString *)table
+{
+	NSString *fileName = [structureParts objectForKey:table];
+
+	return fileName ? [self _pathForPartFileName:fileName] : nil;
+}
+
+/**
+ * Returns the number of rows of the supplied table held by the supplied part.
+ *
+ * @param table The table name
+ * @param part  The one-based part number
+ */
+- (NSUInteger)rowCountForTable:(NSString *)table inPart:(NSUInteger)part
+{
+	if (part < 1 || part > [parts count]) return 0;
+
+	for (NSDictionary *tableEntry in [[parts objectAtIndex:part - 1] objectForKey:SPExportPartManifestTablesKey])
+	{
+		if ([[tableEntry objectForKey:SPExportPartManifestTableNameKey] isEqualToString:table]) {
+			return [[tableEntry objectForKey:SPExportPartManifestTableRowCountKey] unsignedIntegerValue];
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * Returns the size on disk recorded for the supplied part, allowing transferred parts to be verified.
+ *
+ * @param part The one-based part number
+ */
+- (unsigned long long)fileSizeOfPart:(NSUInteger)part
+{
+	if (part < 1 || part > [parts count]) return 0;
+
+	return [[[parts objectAtIndex:part - 1] objectForKey:SPExportPartManifestFileSizeKey] unsignedLongLongValue];
+}
+
+/**
+ * Adds the next part to the manifest, which subsequently recorded rows and structure belong to.
+ *
+ * @return The path of the new part
+ */
+- (NSString *)beginNextPart
+{
+	NSString *path = [[self class] pathForPart:[parts count] + 1 ofExportFilePath:exportFilePath];
+
+	[parts addObject:[NSMutableDictionary dictionaryWithDictionary:@{
+		SPExportPartManifestFileKey:     [path lastPathComponent],
+		SPExportPartManifestFileSizeKey: @0,
+		SPExportPartManifestTablesKey:   [NSMutableArray array]
+	}]];
+
+	return path;
+}
+
+/**
+ * Records that the supplied number of rows of a table have been written to the current part.
+ *
+ * @param rowCount The number of rows written
+ * @param table    The table name
+ */
+- (void)recordRows:(NSUInteger)rowCount forTable:(NSString *)table
+{
+	NSMutableArray *tables = [[parts lastObject] objectForKey:SPExportPartManifestTablesKey];
+
+	if (!tables || !table) return;
+
+	NSMutableDictionary *tableEntry = [tables lastObject];
+
+	if ([[tableEntry objectForKey:SPExportPartManifestTableNameKey] isEqualToString:table]) {
+		[tableEntry setObject:@([[tableEntry objectForKey:SPExportPartManifestTableRowCountKey] unsignedIntegerValue] + rowCount) forKey:SPExportPartManifestTableRowCountKey];
+	}
+	else {
+		[tables addObject:[NSMutableDictionary dictionaryWithDictionary:@{
+			SPExportPartManifestTableNameKey:     table,
+			SPExportPartManifestTableRowCountKey: @(rowCount)
+		}]];
+	}
+}
+
+/**
+ * Records that the structure of the supplied table has been written to the current part.
+ *
+ * @param table The table name
+ */
+- (void)recordStructureForTable:(NSString *)table
+{
+	if (![parts count] || !table) return;
+
+	[structureParts setObject:[[parts lastObject] objectForKey:SPExportPartManifestFileKey] forKey:table];
+}
+
+/**
+ * Records the size on disk of the current part, which must have been closed.
+ */
+- (void)recordFileSizeOfCurrentPart
+{
+	NSMutableDictionary *part = [parts lastObject];
+
+	if (!part) return;
+
+	NSDictionary *attributes = [[NSFileManager defaultManager] attributesOfItemAtPath:[self _pathForPartFileName:[part objectForKey:SPExportPartManifestFileKey]] error:nil];
+
+	[part setObject:@([attributes fileSize]) forKey:SPExportPartManifestFileSizeKey];
+}
+
+#pragma mark -
+#pragma mark Manifest
+
+/**
+ * Writes the manifest next to the first part, replacing the previous one atomically.
+ *
+ * @return A BOOL indicating the success of writing the manifest
+ */
+- (BOOL)writeManifest
+{
+	NSMutableDictionary *manifest = [NSMutableDictionary dictionaryWithDictionary:@{
+		SPExportPartManifestVersionKey:        @(SPExportPartManifestVersion),
+		SPExportPartManifestPartsKey:          parts,
+		SPExportPartManifestStructurePartsKey: structureParts
+	}];
+
+	if (exportFormat) [manifest setObject:exportFormat forKey:SPExportPartManifestFormatKey];
+	if (databaseName) [manifest setObject:databaseName forKey:SPExportPartManifestDatabaseKey];
+
+	NSData *manifestData = [NSPropertyListSerialization dataWithPropertyList:manifest format:NSPropertyListXMLFormat_v1_0 options:0 error:NULL];
+
+	return [manifestData writeToFile:[[self class] manifestPathForExportFilePath:exportFilePath] atomically:YES];
+}
+
+/**
+ * Removes the manifest from disk.
+ */
+- (void)removeManifest
+{
+	NSString *manifestPath = [[self class] manifestPathForExportFilePath:exportFilePath];
+
+	if ([[NSFileManager defaultManager] fileExistsAtPath:manifestPath]) {
+		[[NSFileManager defaultManager] removeItemAtPath:manifestPath error:nil];
+	}
+}
+
+#pragma mark -
+#pragma mark Private API
+
+/**
+ * Resolves a part file name recorded in the manifest against the directory of the first part, so
+ * the parts can be moved together with their manifest.
+ *
+ * @param fileName The part's file name
+ */
+- (NSString *)_pathForPartFileName:(NSString *)fileName
+{
+	return [[exportFilePath stringByDeletingLastPathComponent] stringByAppendingPathComponent:fileName];
+}
+
+@end
@@ -0,0 +1,63 @@
+//
+//  SPExportRowPrefetcher.h
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPBoundedQueue.h"
+
+@class SPMySQLStreamingResult;
+@class SPExportRowFetchStage;
+
+/**
+ * @class SPExportRowPrefetcher SPExportRowPrefetcher.h
+ *
+ * Reads the rows of a streaming result on a background thread, ahead of the exporter
+ * consuming them. Rows are handed over in batches through a bounded queue, so fetching
+ * and decoding the next rows overlaps with encoding the current ones, while never
+ * holding more than a few batches in memory.
+ *
+ * Rows are read with getRowAsArray, mirroring the streaming result itself. An exporter
+ * stopping before the result is exhausted should call cancelResultLoad.
+ */
+@interface SPExportRowPrefetcher : NSObject
+{
+	SPExportRowFetchStage *fetchStage;
+
+	NSArray *currentBatch;
+	NSUInteger currentBatchIndex;
+}
+
+- (instancetype)initWithStreamingResult:(SPMySQLStreamingResult *)streamingResult batchSize:(NSUInteger)batchSize queueCapacity:(NSUInteger)queueCapacity;
+
+- (NSArray *)getRowAsArray;
+- (void)cancelResultLoad;
+
+- (SPPipelineStageCounters)fetchStageCounters;
+- (uint64_t)rowWaitNanoseconds;
+
+@end
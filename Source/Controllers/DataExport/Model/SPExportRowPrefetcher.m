@@ -0,0 +1,192 @@
+//
+//  SPExportRowPrefetcher.m
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPExportRowPrefetcher.h"
+
+#import <SPMySQL/SPMySQL.h>
+
+/**
+ * The fetch stage's state, kept apart from the prefetcher so that the background thread,
+ * which retains it, doesn't keep the prefetcher alive; releasing the prefetcher then
+ * cancels the stage.
+ */
+@interface SPExportRowFetchStage : NSObject
+{
+	@public
+	SPMySQLStreamingResult *streamingResult;
+	SPBoundedQueue *batchQueue;
+	NSUInteger batchSize;
+	dispatch_semaphore_t finished;
+	_Atomic uint64_t busyNanoseconds;
+}
+
+- (void)fetchRows;
+
+@end
+
+@implementation SPExportRowFetchStage
+
+/**
+ * Reads rows from the streaming result into batches and queues them until the result is
+ * exhausted or the queue is cancelled.
+ */
+- (void)fetchRows
+{
+	@autoreleasepool {
+		BOOL resultExhausted = NO;
+
+		while (!resultExhausted && ![batchQueue isCancelled])
+		{
+			@autoreleasepool {
+				uint64_t start = SPPipelineTimestamp();
+
+				NSMutableArray *batch = [NSMutableArray arrayWithCapacity:batchSize];
+				NSArray *row = nil;
+
+				while ([batch count] < batchSize && (row = [streamingResult getRowAsArray]))
+				{
+					[batch addObject:row];
+				}
+
+				resultExhausted = (row == nil);
+
+				atomic_fetch_add(&busyNanoseconds, SPPipelineTimestamp() - start);
+
+				if ([batch count]) [batchQueue enqueue:batch];
+			}
+		}
+
+		// Discard any rows left behind so the connection is released
+		if (!resultExhausted) [streamingResult cancelResultLoad];
+
+		[batchQueue close];
+
+		dispatch_semaphore_signal(finished);
+	}
+}
+
+@end
+
+@implementation SPExportRowPrefetcher
+
+/**
+ * Initialises a prefetcher for the supplied streaming result, which must not yet have had
+ * any rows read. Rows are handed over in batches of the supplied size, with up to the supplied
+ * number of batches fetched ahead of the consumer.
+ */
+- (instancetype)initWithStreamingResult:(SPMySQLStreamingResult *)streamingResult batchSize:(NSUInteger)batchSize queueCapacity:(NSUInteger)queueCapacity
+{
+	if ((self = [super init])) {
+		fetchStage = [[SPExportRowFetchStage alloc] init];
+
+		fetchStage->streamingResult = streamingResult;
+		fetchStage->batchQueue = [[SPBoundedQueue alloc] initWithCapacity:queueCapacity];
+		fetchStage->batchSize = MAX(batchSize, 1);
+		fetchStage->finished = dispatch_semaphore_create(0);
+
+		atomic_init(&fetchStage->busyNanoseconds, 0);
+
+		currentBatch = nil;
+		currentBatchIndex = 0;
+
+		NSThread *fetchThread = [[NSThread alloc] initWithTarget:fetchStage selector:@selector(fetchRows) object:nil];
+
+		[fetchThread setName:@"SPExportRowPrefetcher row fetching thread"];
+		[fetchThread start];
+	}
+
+	return self;
+}
+
+/**
+ * Returns the next row of the result, waiting for it to be fetched if necessary, or nil once
+ * all rows have been returned.
+ */
+- (NSArray *)getRowAsArray
+{
+	if (currentBatchIndex == [currentBatch count]) {
+		currentBatch = [fetchStage->batchQueue dequeue];
+		currentBatchIndex = 0;
+
+		if (!currentBatch) return nil;
+	}
+
+	return [currentBatch objectAtIndex:currentBatchIndex++];
+}
+
+/**
+ * Stops fetching rows, discards any that haven't been read and waits for the streaming
+ * result to be released. Cancel the running query first if the rest of the result
+ * shouldn't be downloaded.
+ */
+- (void)cancelResultLoad
+{
+	if ([fetchStage->batchQueue isCancelled]) return;
+
+	[fetchStage->batchQueue cancel];
+
+	dispatch_semaphore_wait(fetchStage->finished, DISPATCH_TIME_FOREVER);
+
+	currentBatch = nil;
+	currentBatchIndex = 0;
+}
+
+/**
+ * Returns how the fetch stage has spent its time: busy reading rows, including waiting on the
+ * network, or waiting for the consumer to make room for another batch.
+ */
+- (SPPipelineStageCounters)fetchStageCounters
+{
+	SPPipelineStageCounters counters;
+
+	counters.items = [fetchStage->batchQueue enqueuedCount];
+	counters.busyNanoseconds = atomic_load(&fetchStage->busyNanoseconds);
+	counters.waitNanoseconds = [fetchStage->batchQueue producerWaitNanoseconds];
+
+	return counters;
+}
+
+/**
+ * Returns the time the consumer has spent waiting for rows to be fetched.
+ */
+- (uint64_t)rowWaitNanoseconds
+{
+	return [fetchStage->batchQueue consumerWaitNanoseconds];
+}
+
+#pragma mark -
+
+- (void)dealloc
+{
+	// Stop the fetch thread if the consumer gave up without cancelling
+	[fetchStage->batchQueue cancel];
+}
+
+@end
@@ -0,0 +1,94 @@
+//
+//  SPJSONRowEncoder.h
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+
+/**
+ * How the values of a column are written by SPJSONRowEncoder.
+ */
+typedef NS_ENUM(NSUInteger, SPJSONValueKind) {
+	SPJSONStringKind = 0, // Escaped and quoted text
+	SPJSONNumberKind = 1, // Written unquoted, provided the server's text is a valid JSON number
+	SPJSONRawKind    = 2, // Native JSON columns, which the server returns as valid JSON text
+	SPJSONBinaryKind = 3  // Base64 or hex encoded, quoted
+};
+
+/**
+ * @class SPJSONRowEncoder SPJSONRowEncoder.h
+ *
+ * Encodes result rows as JSON objects, keyed by field name, into a single reusable byte buffer. The
+ * value kind of each column and the escaped object keys are determined once, up front, and rows are
+ * then encoded with plain C string handling, so encoding a row only allocates when a value has to be
+ * converted from data using the string encoding. The output is always UTF-8, as required by RFC 8259.
+ *
+ * The owner is expected to write out and remove the buffered bytes once they reach a suitable size.
+ */
+@interface SPJSONRowEncoder : NSObject
+{
+	NSUInteger columnCount;
+	SPJSONValueKind *columnKinds;
+	NSArray *columnKeys;
+
+	SPJSONExportBinaryEncoding binaryEncoding;
+	NSStringEncoding dataEncoding;
+
+	unsigned char *buffer;
+	NSUInteger bufferLength;
+	NSUInteger bufferCapacity;
+
+	char *scratch;
+	NSUInteger scratchCapacity;
+}
+
+/**
+ * @property binaryEncoding How the values of binary columns are encoded
+ */
+@property (readwrite, assign) SPJSONExportBinaryEncoding binaryEncoding;
+
+/**
+ * @property dataEncoding The encoding used to convert data values of text columns to text
+ */
+@property (readwrite, assign) NSStringEncoding dataEncoding;
+
+/**
+ * @property length The number of bytes currently buffered
+ */
+@property (readonly, assign) NSUInteger length;
+
++ (SPJSONValueKind)valueKindForFieldDefinition:(NSDictionary *)definition;
+
+- (instancetype)initWithFieldNames:(NSArray *)fieldNames fieldDefinitions:(NSArray *)fieldDefinitions;
+
+- (void)appendRow:(NSArray *)row;
+- (void)appendUTF8String:(const char *)string;
+
+- (const void *)bytes;
+- (void)removeAllBytes;
+
+@end
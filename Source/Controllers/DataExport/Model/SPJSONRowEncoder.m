@@ -0,0 +1,429 @@
+//
+//  SPJSONRowEncoder.m
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+
+#import "SPJSONRowEncoder.h"
+
+#import <SPMySQL/SPMySQL.h>
+
+// The escape sequence character of each byte which can't appear unescaped in a JSON string, 'u' meaning \u00XX
+static const char SPJSONEscapeCharacters[256] = {
+	'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'b', 't', 'n', 'u', 'f', 'r', 'u', 'u',
+	'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u',
+	0, 0, '"', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, '\\', 0, 0, 0
+};
+
+static const char SPJSONHexDigits[] = "0123456789abcdef";
+static const char SPJSONBase64Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static BOOL SPJSONIsNumber(const char *string, NSUInteger length);
+
+@interface SPJSONRowEncoder ()
+
+- (void)_reserveCapacity:(NSUInteger)additionalLength;
+- (void)_appendBytes:(const void *)bytes length:(NSUInteger)length;
+- (void)_appendEscapedBytes:(const char *)bytes length:(NSUInteger)length;
+- (void)_appendValue:(id)value ofKind:(SPJSONValueKind)kind;
+- (void)_appendBinaryData:(NSData *)data;
+- (const char *)_UTF8BytesOfString:(NSString *)string length:(NSUInteger *)length;
+
+@end
+
+@implementation SPJSONRowEncoder
+
+@synthesize binaryEncoding;
+@synthesize dataEncoding;
+@synthesize length = bufferLength;
+
+/**
+ * Returns how values of the supplied field definition are encoded. Numeric types are written as
+ * numbers, JSON columns are embedded as-is and binary columns are encoded; everything else,
+ * including BIT, date and time values, is written as a string.
+ *
+ * @param definition The field definition, or nil if it is not known
+ */
++ (SPJSONValueKind)valueKindForFieldDefinition:(NSDictionary *)definition
+{
+	NSString *fieldType = [[definition objectForKey:@"type"] uppercaseString];
+	NSString *typeGrouping = [definition objectForKey:@"typegrouping"];
+
+	if ([fieldType isEqualToString:@"JSON"]) return SPJSONRawKind;
+
+	if ([typeGrouping isEqualToString:@"integer"] || [typeGrouping isEqualToString:@"float"]) return SPJSONNumberKind;
+
+	if ([typeGrouping isEqualToString:@"binary"] || [typeGrouping isEqualToString:@"blobdata"]) return SPJSONBinaryKind;
+
+	return SPJSONStringKind;
+}
+
+/**
+ * Initialise an encoder for rows with the supplied fields.
+ *
+ * @param fieldNames       The field names, used as the object keys
+ * @param fieldDefinitions The field definitions in the same order, with NSNull for unknown fields
+ *
+ * @return The initialised instance
+ */
+- (instancetype)initWithFieldNames:(NSArray *)fieldNames fieldDefinitions:(NSArray *)fieldDefinitions
+{
+	if ((self = [super init])) {
+		columnCount = [fieldNames count];
+		columnKinds = calloc(MAX(columnCount, 1), sizeof(SPJSONValueKind));
+
+		binaryEncoding = SPJSONExportBase64Encoding;
+		dataEncoding = NSUTF8StringEncoding;
+
+		NSMutableArray *keys = [NSMutableArray arrayWithCapacity:columnCount];
+
+		for (NSUInteger i = 0; i < columnCount; i++)
+		{
+			NSDictionary *definition = [fieldDefinitions safeObjectAtIndex:i];
+
+			columnKinds[i] = [SPJSONRowEncoder valueKindForFieldDefinition:([definition isKindOfClass:[NSDictionary class]] ? definition : nil)];
+
+			// Encode each key, along with its separators, once, as it's written for every row
+			[self _appendBytes:(i ? ",\"" : "\"") length:(i ? 2 : 1)];
+
+			NSUInteger nameLength = 0;
+			const char *name = [self _UTF8BytesOfString:[[fieldNames objectAtIndex:i] description] length:&nameLength];
+
+			[self _appendEscapedBytes:name length:nameLength];
+			[self _appendBytes:"\":" length:2];
+
+			[keys addObject:[NSData dataWithBytes:buffer length:bufferLength]];
+
+			[self removeAllBytes];
+		}
+
+		columnKeys = keys;
+	}
+
+	return self;
+}
+
+/**
+ * Appends a row as a JSON object, without any trailing separator.
+ *
+ * @param row The row's values, in field order
+ */
+- (void)appendRow:(NSArray *)row
+{
+	[self _appendBytes:"{" length:1];
+
+	for (NSUInteger i = 0; i < columnCount; i++)
+	{
+		NSData *key = [columnKeys objectAtIndex:i];
+
+		[self _appendBytes:[key bytes] length:[key length]];
+		[self _appendValue:[row safeObjectAtIndex:i] ofKind:columnKinds[i]];
+	}
+
+	[self _appendBytes:"}" length:1];
+}
+
+/**
+ * Appends literal text, such as separators or array brackets, as-is.
+ */
+- (void)appendUTF8String:(const char *)string
+{
+	[self _appendBytes:string length:strlen(string)];
+}
+
+- (const void *)bytes
+{
+	return buffer;
+}
+
+- (void)removeAllBytes
+{
+	bufferLength = 0;
+}
+
+#pragma mark -
+#pragma mark Private API
+
+- (void)_appendValue:(id)value ofKind:(SPJSONValueKind)kind
+{
+	if (!value || value == [NSNull null]) {
+		[self _appendBytes:"null" length:4];
+		return;
+	}
+
+	if ([value isKindOfClass:[SPMySQLGeometryData class]]) {
+		NSString *geoJSON = [(SPMySQLGeometryData *)value geoJSONString];
+
+		if (!geoJSON) {
+			[self _appendBytes:"null" length:4];
+			return;
+		}
+
+		value = geoJSON;
+		kind = SPJSONRawKind;
+	}
+	else if ([value isKindOfClass:[NSData class]]) {
+		NSString *string = nil;
+
+		if (kind != SPJSONBinaryKind) string = [[NSString alloc] initWithData:value encoding:dataEncoding];
+
+		// Data which isn't text is written using the binary encoding, whatever the column type
+		if (!string) {
+			[self _appendBinaryData:value];
+			return;
+		}
+
+		value = string;
+	}
+
+	NSUInteger length = 0;
+	const char *bytes = [self _UTF8BytesOfString:[value description] length:&length];
+
+	switch (kind)
+	{
+		case SPJSONNumberKind:
+			// Values such as "inf" or a zero filled "007" aren't valid JSON numbers, so are written as strings
+			if (SPJSONIsNumber(bytes, length)) {
+				[self _appendBytes:bytes length:length];
+				return;
+			}
+			break;
+		case SPJSONRawKind:
+			if (length) {
+				[self _appendBytes:bytes length:length];
+				return;
+			}
+			break;
+		case SPJSONBinaryKind:
+		case SPJSONStringKind:
+			break;
+	}
+
+	[self _appendBytes:"\"" length:1];
+	[self _appendEscapedBytes:bytes length:length];
+	[self _appendBytes:"\"" length:1];
+}
+
+/**
+ * Appends data as a quoted base64 or hex string, depending on the binary encoding.
+ */
+- (void)_appendBinaryData:(NSData *)data
+{
+	const unsigned char *bytes = [data bytes];
+	NSUInteger i, length = [data length];
+
+	if (binaryEncoding == SPJSONExportHexEncoding) {
+		[self _reserveCapacity:(length * 2) + 2];
+
+		unsigned char *output = buffer + bufferLength;
+
+		*output++ = '"';
+
+		for (i = 0; i < length; i++)
+		{
+			*output++ = SPJSONHexDigits[bytes[i] >> 4];
+			*output++ = SPJSONHexDigits[bytes[i] & 0x0f];
+		}
+
+		*output++ = '"';
+
+		bufferLength = output - buffer;
+
+		return;
+	}
+
+	[self _reserveCapacity:(((length + 2) / 3) * 4) + 2];
+
+	unsigned char *output = buffer + bufferLength;
+
+	*output++ = '"';
+
+	for (i = 0; i + 2 < length; i += 3)
+	{
+		uint32_t triple = ((uint32_t)bytes[i] << 16) | ((uint32_t)bytes[i + 1] << 8) | bytes[i + 2];
+
+		*output++ = SPJSONBase64Alphabet[(triple >> 18) & 0x3f];
+		*output++ = SPJSONBase64Alphabet[(triple >> 12) & 0x3f];
+		*output++ = SPJSONBase64Alphabet[(triple >> 6) & 0x3f];
+		*output++ = SPJSONBase64Alphabet[triple & 0x3f];
+	}
+
+	if (i < length) {
+		uint32_t triple = (uint32_t)bytes[i] << 16;
+
+		if (i + 1 < length) triple |= (uint32_t)bytes[i + 1] << 8;
+
+		*output++ = SPJSONBase64Alphabet[(triple >> 18) & 0x3f];
+		*output++ = SPJSONBase64Alphabet[(triple >> 12) & 0x3f];
+		*output++ = (i + 1 < length) ? SPJSONBase64Alphabet[(triple >> 6) & 0x3f] : '=';
+		*output++ = '=';
+	}
+
+	*output++ = '"';
+
+	bufferLength = output - buffer;
+}
+
+/**
+ * Appends UTF-8 bytes, escaping quotes, backslashes and control characters. Runs of bytes which
+ * don't need escaping, which is nearly all of them, are copied in one go.
+ */
+- (void)_appendEscapedBytes:(const char *)bytes length:(NSUInteger)length
+{
+	NSUInteger runStart = 0;
+
+	for (NSUInteger i = 0; i < length; i++)
+	{
+		char escape = SPJSONEscapeCharacters[(unsigned char)bytes[i]];
+
+		if (!escape) continue;
+
+		if (i > runStart) [self _appendBytes:(bytes + runStart) length:(i - runStart)];
+
+		if (escape == 'u') {
+			char sequence[6] = { '\\', 'u', '0', '0', SPJSONHexDigits[(unsigned char)bytes[i] >> 4], SPJSONHexDigits[bytes[i] & 0x0f] };
+
+			[self _appendBytes:sequence length:6];
+		}
+		else {
+			char sequence[2] = { '\\', escape };
+
+			[self _appendBytes:sequence length:2];
+		}
+
+		runStart = i + 1;
+	}
+
+	if (length > runStart) [self _appendBytes:(bytes + runStart) length:(length - runStart)];
+}
+
+- (void)_appendBytes:(const void *)bytes length:(NSUInteger)length
+{
+	[self _reserveCapacity:length];
+
+	memcpy(buffer + bufferLength, bytes, length);
+
+	bufferLength += length;
+}
+
+/**
+ * Grows the buffer, if necessary, so it can hold the supplied number of additional bytes.
+ */
+- (void)_reserveCapacity:(NSUInteger)additionalLength
+{
+	if (bufferLength + additionalLength <= bufferCapacity) return;
+
+	NSUInteger capacity = MAX(bufferCapacity * 2, 4096);
+
+	while (capacity < bufferLength + additionalLength) capacity *= 2;
+
+	buffer = reallocf(buffer, capacity);
+
+	if (!buffer) [NSException raise:NSMallocException format:@"Unable to allocate %lu bytes for the JSON export buffer", (unsigned long)capacity];
+
+	bufferCapacity = capacity;
+}
+
+/**
+ * Returns the UTF-8 bytes of a string, converted into a scratch buffer reused between values.
+ * The bytes are only valid until the next call.
+ */
+- (const char *)_UTF8BytesOfString:(NSString *)string length:(NSUInteger *)length
+{
+	NSUInteger maximumLength = [string maximumLengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+
+	if (maximumLength > scratchCapacity) {
+		scratchCapacity = MAX(maximumLength, 1024);
+		scratch = reallocf(scratch, scratchCapacity);
+
+		if (!scratch) [NSException raise:NSMallocException format:@"Unable to allocate %lu bytes for the JSON export buffer", (unsigned long)scratchCapacity];
+	}
+
+	*length = 0;
+
+	[string getBytes:scratch maxLength:maximumLength usedLength:length encoding:NSUTF8StringEncoding options:0 range:NSMakeRange(0, [string length]) remainingRange:NULL];
+
+	return scratch;
+}
+
+- (void)dealloc
+{
+	if (columnKinds) free(columnKinds);
+	if (buffer) free(buffer);
+	if (scratch) free(scratch);
+}
+
+@end
+
+/**
+ * Returns whether the supplied text is a number as defined by RFC 8259:
+ * an optional minus sign, an integer without leading zeros, an optional fraction and an optional exponent.
+ */
+static BOOL SPJSONIsNumber(const char *string, NSUInteger length)
+{
+	NSUInteger i = 0;
+
+	if (i < length && string[i] == '-') i++;
+
+	if (i == length) return NO;
+
+	if (string[i] == '0') {
+		i++;
+	}
+	else if (string[i] >= '1' && string[i] <= '9') {
+		while (i < length && string[i] >= '0' && string[i] <= '9') i++;
+	}
+	else {
+		return NO;
+	}
+
+	if (i < length && string[i] == '.') {
+		NSUInteger fractionStart = ++i;
+
+		while (i < length && string[i] >= '0' && string[i] <= '9') i++;
+
+		if (i == fractionStart) return NO;
+	}
+
+	if (i < length && (string[i] == 'e' || string[i] == 'E')) {
+		i++;
+
+		if (i < length && (string[i] == '+' || string[i] == '-')) i++;
+
+		NSUInteger exponentStart = i;
+
+		while (i < length && string[i] >= '0' && string[i] <= '9') i++;
+
+		if (i == exponentStart) return NO;
+	}
+
+	return (i == length);
+}
@@ -0,0 +1,78 @@
+//
+//  SPXMLRowEncoder.h
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+
+/**
+ * @class SPXMLRowEncoder SPXMLRowEncoder.h
+ *
+ * Encodes result rows as XML row elements into a single reusable UTF-8 byte buffer, in either the
+ * mysqldump compatible or the plain format. The tags of each column are rendered once, up front,
+ * and content is escaped in a single pass which copies runs without &, < or > in one go, so
+ * encoding a row only allocates when a value has to be converted from data using the string encoding.
+ *
+ * The owner is expected to write out and remove the buffered bytes once they reach a suitable size.
+ */
+@interface SPXMLRowEncoder : NSObject
+{
+	NSUInteger columnCount;
+	NSArray *openingTags;
+	NSArray *closingTags;
+	NSArray *nilElements;
+
+	SPXMLExportFormat format;
+	NSString *nullString;
+	NSStringEncoding dataEncoding;
+
+	unsigned char *buffer;
+	NSUInteger bufferLength;
+	NSUInteger bufferCapacity;
+
+	char *scratch;
+	NSUInteger scratchCapacity;
+}
+
+/**
+ * @property dataEncoding The encoding used to convert data values to text
+ */
+@property (readwrite, assign) NSStringEncoding dataEncoding;
+
+/**
+ * @property length The number of bytes currently buffered
+ */
+@property (readonly, assign) NSUInteger length;
+
+- (instancetype)initWithFieldNames:(NSArray *)fieldNames format:(SPXMLExportFormat)exportFormat nullString:(NSString *)nullValue;
+
+- (void)appendRow:(NSArray *)row;
+
+- (const void *)bytes;
+- (void)removeAllBytes;
+
+@end
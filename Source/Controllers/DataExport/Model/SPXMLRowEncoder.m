@@ -0,0 +1,253 @@
+//
+//  SPXMLRowEncoder.m
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+
+#import "SPXMLRowEncoder.h"
+
+#import <SPMySQL/SPMySQL.h>
+
+// The entity of each byte which can't appear unescaped in element content
+static const char *SPXMLContentEntities[256] = {
+	['&'] = "&amp;",
+	['<'] = "&lt;",
+	['>'] = "&gt;"
+};
+
+@interface SPXMLRowEncoder ()
+
+- (void)_reserveCapacity:(NSUInteger)additionalLength;
+- (void)_appendBytes:(const void *)bytes length:(NSUInteger)length;
+- (void)_appendData:(NSData *)data;
+- (void)_appendEscapedString:(NSString *)string;
+- (const char *)_UTF8BytesOfString:(NSString *)string length:(NSUInteger *)length;
+
+@end
+
+@implementation SPXMLRowEncoder
+
+@synthesize dataEncoding;
+@synthesize length = bufferLength;
+
+/**
+ * Initialise an encoder for rows with the supplied fields.
+ *
+ * @param fieldNames   The field names, used as the element names in the plain format and the name attributes otherwise
+ * @param exportFormat The XML format to write
+ * @param nullValue    The content written for NULL values in the plain format
+ *
+ * @return The initialised instance
+ */
+- (instancetype)initWithFieldNames:(NSArray *)fieldNames format:(SPXMLExportFormat)exportFormat nullString:(NSString *)nullValue
+{
+	if ((self = [super init])) {
+		columnCount = [fieldNames count];
+		format = exportFormat;
+		nullString = [nullValue copy] ?: @"";
+		dataEncoding = NSUTF8StringEncoding;
+
+		NSMutableArray *opening = [NSMutableArray arrayWithCapacity:columnCount];
+		NSMutableArray *closing = [NSMutableArray arrayWithCapacity:columnCount];
+		NSMutableArray *nils = [NSMutableArray arrayWithCapacity:columnCount];
+
+		for (NSUInteger i = 0; i < columnCount; i++)
+		{
+			NSString *name = [[[fieldNames objectAtIndex:i] description] HTMLEscapeString];
+
+			if (format == SPXMLExportMySQLFormat) {
+				[opening addObject:[[NSString stringWithFormat:@"\t\t<field name=\"%@\">", name] dataUsingEncoding:NSUTF8StringEncoding]];
+				[closing addObject:[@"</field>\n" dataUsingEncoding:NSUTF8StringEncoding]];
+				[nils addObject:[[NSString stringWithFormat:@"\t\t<field name=\"%@\" xsi:nil=\"true\" />\n", name] dataUsingEncoding:NSUTF8StringEncoding]];
+			}
+			else {
+				[opening addObject:[[NSString stringWithFormat:@"\t\t<%@>", name] dataUsingEncoding:NSUTF8StringEncoding]];
+				[closing addObject:[[NSString stringWithFormat:@"</%@>\n", name] dataUsingEncoding:NSUTF8StringEncoding]];
+			}
+		}
+
+		openingTags = opening;
+		closingTags = closing;
+		nilElements = nils;
+	}
+
+	return self;
+}
+
+/**
+ * Appends a row element containing an element for each of the row's values.
+ *
+ * @param row The row's values, in field order
+ */
+- (void)appendRow:(NSArray *)row
+{
+	[self _appendBytes:"\t<row>\n" length:7];
+
+	for (NSUInteger i = 0; i < columnCount; i++)
+	{
+		id value = [row safeObjectAtIndex:i];
+
+		if (!value || value == [NSNull null]) {
+			if (format == SPXMLExportMySQLFormat) {
+				[self _appendData:[nilElements objectAtIndex:i]];
+
+				continue;
+			}
+
+			value = nullString;
+		}
+		else if ([value isKindOfClass:[NSData class]]) {
+			NSString *string = [[NSString alloc] initWithData:value encoding:dataEncoding];
+
+			value = string ?: [[NSString alloc] initWithData:value encoding:NSASCIIStringEncoding];
+		}
+		else if ([value isKindOfClass:[SPMySQLGeometryData class]]) {
+			value = [(SPMySQLGeometryData *)value wktString];
+		}
+
+		[self _appendData:[openingTags objectAtIndex:i]];
+		[self _appendEscapedString:[value description]];
+		[self _appendData:[closingTags objectAtIndex:i]];
+	}
+
+	[self _appendBytes:"\t</row>\n\n" length:9];
+}
+
+- (const void *)bytes
+{
+	return buffer;
+}
+
+- (void)removeAllBytes
+{
+	bufferLength = 0;
+}
+
+#pragma mark -
+#pragma mark Private API
+
+/**
+ * Appends the UTF-8 bytes of a string, replacing &, < and > with entities. Runs of bytes which
+ * don't need escaping, which is nearly all of them, are copied in one go.
+ */
+- (void)_appendEscapedString:(NSString *)string
+{
+	NSUInteger length = 0;
+	const char *bytes = [self _UTF8BytesOfString:string length:&length];
+
+	NSUInteger runStart = 0;
+
+	for (NSUInteger i = 0; i < length; i++)
+	{
+		const char *entity = SPXMLContentEntities[(unsigned char)bytes[i]];
+
+		if (!entity) continue;
+
+		if (i > runStart) [self _appendBytes:(bytes + runStart) length:(i - runStart)];
+
+		[self _appendBytes:entity length:strlen(entity)];
+
+		runStart = i + 1;
+	}
+
+	if (length > runStart) [self _appendBytes:(bytes + runStart) length:(length - runStart)];
+}
+
+- (void)_appendData:(NSData *)data
+{
+	[self _appendBytes:[data bytes] length:[data length]];
+}
+
+- (void)_appendBytes:(const void *)bytes length:(NSUInteger)length
+{
+	[self _reserveCapacity:length];
+
+	memcpy(buffer + bufferLength, bytes, length);
+
+	bufferLength += length;
+}
+
+/**
+ * Grows the buffer, if necessary, so it can hold the supplied number of additional bytes.
+ */
+- (void)_reserveCapacity:(NSUInteger)additionalLength
+{
+	if (bufferLength + additionalLength <= bufferCapacity) return;
+
+	NSUInteger capacity = MAX(bufferCapacity * 2, 4096);
+
+	while (capacity < bufferLength + additionalLength) capacity *= 2;
+
+	buffer = reallocf(buffer, capacity);
+
+	if (!buffer) [NSException raise:NSMallocException format:@"Unable to allocate %lu bytes for the XML export buffer", (unsigned long)capacity];
+
+	bufferCapacity = capacity;
+}
+
+/**
+ * Returns the UTF-8 bytes of a string. ASCII strings stored as single bytes are used directly;
+ * others are converted into a scratch buffer reused between values. The bytes are only valid
+ * until the next call.
+ */
+- (const char *)_UTF8BytesOfString:(NSString *)string length:(NSUInteger *)length
+{
+	*length = 0;
+
+	if (!string) return NULL;
+
+	// Only available when the contents are ASCII, so the byte length is the string's length
+	const char *directBytes = CFStringGetCStringPtr((__bridge CFStringRef)string, kCFStringEncodingUTF8);
+
+	if (directBytes) {
+		*length = [string length];
+
+		return directBytes;
+	}
+
+	NSUInteger maximumLength = [string maximumLengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+
+	if (maximumLength > scratchCapacity) {
+		scratchCapacity = MAX(maximumLength, 1024);
+		scratch = reallocf(scratch, scratchCapacity);
+
+		if (!scratch) [NSException raise:NSMallocException format:@"Unable to allocate %lu bytes for the XML export buffer", (unsigned long)scratchCapacity];
+	}
+
+	[string getBytes:scratch maxLength:maximumLength usedLength:length encoding:NSUTF8StringEncoding options:0 range:NSMakeRange(0, [string length]) remainingRange:NULL];
+
+	return scratch;
+}
+
+- (void)dealloc
+{
+	if (buffer) free(buffer);
+	if (scratch) free(scratch);
+}
+
+@end
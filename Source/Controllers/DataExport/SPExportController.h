@@ -35,9 +35,13 @@
 @class SPTableData;
 @class SPMySQLConnection;
 @class SPServerSupport;
+@class SPExporter;
 @class SPCSVExporter;
 @class SPXMLExporter;
+@class SPColumnarExporter;
+@class SPJSONExporter;
 @class SPExportFile;
+@class SPTransferStatistics;
 
 /**
  * @class SPExportController SPExportController.h
@@ -90,6 +94,8 @@
 	IBOutlet NSTextField *exportProgressText;
 	IBOutlet NSTextField *exportFormatInfoText;
 	IBOutlet NSProgressIndicator *exportProgressIndicator;
+	IBOutlet NSTextField *exportProgressRateText;
+	IBOutlet NSTextField *exportProgressStatisticsText;
 	
 	// Custom filename view
 	IBOutlet NSButton *exportCustomFilenameViewButton;
@@ -126,6 +132,14 @@
 	// Dot
 	IBOutlet NSButton *exportDotForceLowerTableNamesCheck;
 
+	// Arrow / Parquet
+	IBOutlet NSButton *exportArrowDictionaryEncodeCheck;
+	IBOutlet NSButton *exportParquetDictionaryEncodeCheck;
+
+	// JSON
+	IBOutlet NSPopUpButton *exportJSONFormatPopUpButton;
+	IBOutlet NSPopUpButton *exportJSONBinaryEncodingPopUpButton;
+
 	/**
 	 * Whether the awakeFromNib routine has already been run
 	 */
@@ -238,6 +252,19 @@
 	NSUInteger windowMinHeigth;
 	
 	NSDictionary *localizedTokenNames;
+
+	/**
+	 * Throughput readout state for the exporter currently reporting progress
+	 */
+	SPExporter *rateExporter;
+	NSUInteger rateStartRowCount;
+	CFAbsoluteTime rateStartTime;
+	CFAbsoluteTime rateLastUpdateTime;
+
+	/**
+	 * Throughput telemetry for the export in progress
+	 */
+	SPTransferStatistics *transferStatistics;
 }
 
 /**
@@ -288,12 +315,14 @@
 - (IBAction)exportCustomQueryResultAsFormat:(id)sender;
 
 - (IBAction)toggleXMLOutputFormat:(id)sender;
+- (IBAction)toggleJSONOutputFormat:(id)sender;
 - (IBAction)toggleSQLIncludeStructure:(NSButton *)sender;
 - (IBAction)toggleSQLIncludeContent:(NSButton *)sender;
 - (IBAction)toggleSQLIncludeDropSyntax:(NSButton *)sender;
 - (IBAction)toggleNewFilePerTable:(NSButton *)sender;
 
 - (void)cancelExportForFile:(NSString*)fileName;
+- (void)interruptExportWithError:(NSString *)errorMessage;
 
 #pragma mark - SPExportInitializer
 
@@ -305,6 +334,8 @@
 
 - (SPCSVExporter *)initializeCSVExporterForTable:(NSString *)table orDataArray:(NSArray *)dataArray;
 - (SPXMLExporter *)initializeXMLExporterForTable:(NSString *)table orDataArray:(NSArray *)dataArray;
+- (SPColumnarExporter *)initializeColumnarExporterForTable:(NSString *)table orDataArray:(NSArray *)dataArray;
+- (SPJSONExporter *)initializeJSONExporterForTable:(NSString *)table orDataArray:(NSArray *)dataArray;
 
 #pragma mark - SPExportFileUtilities
 
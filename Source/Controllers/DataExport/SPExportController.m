@@ -34,6 +34,7 @@
 #import "SPTableData.h"
 #import "SPTableContent.h"
 #import "SPExportFile.h"
+#import "SPExportCheckpoint.h"
 #import "SPExportFileNameTokenObject.h"
 #import "SPDatabaseDocument.h"
 #import "SPThreadAdditions.h"
@@ -45,13 +46,19 @@
 #import "SPSQLExporter.h"
 #import "SPXMLExporter.h"
 #import "SPDotExporter.h"
+#import "SPArrowExporter.h"
+#import "SPParquetExporter.h"
+#import "SPJSONExporter.h"
 #import "SPExporter.h"
+#import "SPTransferStatistics.h"
 #import "SPCSVExporterProtocol.h"
 #import "SPSQLExporterProtocol.h"
 #import "SPXMLExporterProtocol.h"
 #import "SPDotExporterProtocol.h"
 #import "SPPDFExporterProtocol.h"
 #import "SPHTMLExporterProtocol.h"
+#import "SPColumnarExporterProtocol.h"
+#import "SPJSONExporterProtocol.h"
 #import "SPFunctions.h"
 #import "sequel-ace-Swift.h"
 
@@ -72,7 +79,8 @@ typedef enum
 {
 	SPExportErrorCancelExport   = 0,
 	SPExportErrorReplaceFiles   = 1,
-	SPExportErrorSkipErrorFiles = 2
+	SPExportErrorSkipErrorFiles = 2,
+	SPExportErrorResumeFiles    = 3
 }
 SPExportErrorChoice;
 
@@ -92,10 +100,12 @@ static inline void SetOnOff(NSNumber *ref,id obj);
 
 // Formal conformance for methods AppKit moved off the informal NSObject
 // categories; implementing them without it is deprecated. No behavior change.
-@interface SPExportController () <SPCSVExporterProtocol, SPSQLExporterProtocol, SPXMLExporterProtocol, SPDotExporterProtocol, SPPDFExporterProtocol, SPHTMLExporterProtocol, NSMenuItemValidation, NSControlTextEditingDelegate>
+@interface SPExportController () <SPCSVExporterProtocol, SPSQLExporterProtocol, SPXMLExporterProtocol, SPDotExporterProtocol, SPPDFExporterProtocol, SPHTMLExporterProtocol, SPColumnarExporterProtocol, SPJSONExporterProtocol, NSMenuItemValidation, NSControlTextEditingDelegate>
 @property (readwrite, copy) NSString *exportDatabaseName;
 
 - (void)_switchTab;
+- (SPExportType)_exportTypeForTabIdentifier:(NSString *)identifier;
+- (NSString *)_tabIdentifierForExportType:(SPExportType)type;
 - (void)_checkForDatabaseChanges;
 - (void)_displayExportTypeOptions:(BOOL)display;
 - (void)_updateExportFormatInformation;
@@ -114,6 +124,12 @@ static inline void SetOnOff(NSNumber *ref,id obj);
 #pragma mark - SPExportFileUtilitiesPrivateAPI
 
 - (void)_openExportSheet;
+- (SPFileCompressionFormat)_exportCompressionFormat;
+- (NSUInteger)_exportChunkRowCount;
+- (void)_attachCheckpointToExportFile:(SPExportFile *)file;
+- (BOOL)_exportSplitsOutput;
+- (void)_applySplitLimitsToExportFile:(SPExportFile *)file;
+- (SPExportCheckpoint *)_resumableCheckpointForExportFile:(SPExportFile *)file;
 
 #pragma mark - SPExportControllerDelegate
 
@@ -127,6 +143,8 @@ static inline void SetOnOff(NSNumber *ref,id obj);
 + (NSString *)describeExportType:(SPExportType)et;
 + (NSString *)describeCompressionFormat:(SPFileCompressionFormat)cf;
 + (NSString *)describeXMLExportFormat:(SPXMLExportFormat)xf;
++ (NSString *)describeJSONExportFormat:(SPJSONExportFormat)jf;
++ (NSString *)describeJSONExportBinaryEncoding:(SPJSONExportBinaryEncoding)je;
 + (NSString *)describeSQLExportInsertDivider:(SPSQLExportInsertDivider)eid;
 
 // these will store the C enum constant named by NSString in dst and return YES,
@@ -135,6 +153,8 @@ static inline void SetOnOff(NSNumber *ref,id obj);
 + (BOOL)copyCompressionFormatForDescription:(NSString *)esd to:(SPFileCompressionFormat *)dst;
 + (BOOL)copyExportTypeForDescription:(NSString *)esd to:(SPExportType *)dst;
 + (BOOL)copyXMLExportFormatForDescription:(NSString *)xfd to:(SPXMLExportFormat *)dst;
++ (BOOL)copyJSONExportFormatForDescription:(NSString *)jfd to:(SPJSONExportFormat *)dst;
++ (BOOL)copyJSONExportBinaryEncodingForDescription:(NSString *)jed to:(SPJSONExportBinaryEncoding *)dst;
 + (BOOL)copySQLExportInsertDividerForDescription:(NSString *)xfd to:(SPSQLExportInsertDivider *)dst;
 
 - (NSDictionary *)exporterSettings;
@@ -142,28 +162,39 @@ static inline void SetOnOff(NSNumber *ref,id obj);
 - (NSDictionary *)dotSettings;
 - (NSDictionary *)xmlSettings;
 - (NSDictionary *)sqlSettings;
+- (NSDictionary *)columnarSettings;
+- (NSDictionary *)jsonSettings;
 
 - (void)applyExporterSettings:(NSDictionary *)settings;
 - (void)applyCsvSettings:(NSDictionary *)settings;
 - (void)applyDotSettings:(NSDictionary *)settings;
 - (void)applyXmlSettings:(NSDictionary *)settings;
 - (void)applySqlSettings:(NSDictionary *)settings;
+- (void)applyColumnarSettings:(NSDictionary *)settings;
+- (void)applyJsonSettings:(NSDictionary *)settings;
 
 - (id)exporterSpecificSettingsForSchemaObject:(NSString *)name ofType:(SPTableType)type;
 - (id)dotSpecificSettingsForSchemaObject:(NSString *)name ofType:(SPTableType)type;
 - (id)xmlSpecificSettingsForSchemaObject:(NSString *)name ofType:(SPTableType)type;
 - (id)csvSpecificSettingsForSchemaObject:(NSString *)name ofType:(SPTableType)type;
 - (id)sqlSpecificSettingsForSchemaObject:(NSString *)name ofType:(SPTableType)type;
+- (id)columnarSpecificSettingsForSchemaObject:(NSString *)name ofType:(SPTableType)type;
+- (id)jsonSpecificSettingsForSchemaObject:(NSString *)name ofType:(SPTableType)type;
 
 - (void)applyExporterSpecificSettings:(id)settings forSchemaObject:(NSString *)name ofType:(SPTableType)type;
 - (void)applyDotSpecificSettings:(id)settings forSchemaObject:(NSString *)name ofType:(SPTableType)type;
 - (void)applyXmlSpecificSettings:(id)settings forSchemaObject:(NSString *)name ofType:(SPTableType)type;
 - (void)applyCsvSpecificSettings:(id)settings forSchemaObject:(NSString *)name ofType:(SPTableType)type;
 - (void)applySqlSpecificSettings:(id)settings forSchemaObject:(NSString *)name ofType:(SPTableType)type;
+- (void)applyColumnarSpecificSettings:(id)settings forSchemaObject:(NSString *)name ofType:(SPTableType)type;
+- (void)applyJsonSpecificSettings:(id)settings forSchemaObject:(NSString *)name ofType:(SPTableType)type;
 
 #pragma mark - Shared Private
 
 - (void)_hideExportProgress;
+- (void)_resetExportProgressRate;
+- (BOOL)_closeExportFile:(SPExportFile *)file;
+- (void)_updateExportProgressRateForExporter:(SPExporter *)exporter;
 
 @end
 
@@ -302,7 +333,7 @@ static inline void SetOnOff(NSNumber *ref,id obj);
 	// overwrite those with settings for the current export
 	
 	// Select the correct tab
-	if(format != SPAnyExportType) [exportTypeTabBar selectTabViewItemAtIndex:format];
+	if(format != SPAnyExportType) [exportTypeTabBar selectTabViewItemWithIdentifier:[self _tabIdentifierForExportType:format]];
 	
 	[self updateDisplayedExportFilename];
 	
@@ -523,6 +554,16 @@ set_input:
     [self cancelExport:@{ @"type" : SPExportFileHandleError, @"fileName" : fileName }];
 }
 
+/**
+ * Stops a chunked export which failed part way through, keeping the output up to its last checkpoint
+ * so that it can be resumed.
+ */
+- (void)interruptExportWithError:(NSString *)errorMessage
+{
+    SPLog(@"Chunked export interrupted: %@", errorMessage);
+    [self cancelExport:@{ @"type" : SPExportInterruptedError, @"message" : errorMessage ?: @"" }];
+}
+
 /**
  * Cancel's the export operation by stopping the current table export loop and marking any current SPExporter
  * NSOperation subclasses as cancelled.
@@ -534,6 +575,10 @@ set_input:
             NSString *message = [NSString stringWithFormat:NSLocalizedString(@"Error while writing to the export file. Could not open file: %@", @"Error while writing to the export file"), [sender safeObjectForKey:@"fileName"]];
             [NSAlert createWarningAlertWithTitle:NSLocalizedString(@"Export Error", @"Export Error") message:message callback:nil];
         }
+        else if ([[sender safeObjectForKey:@"type"] isEqualToString:SPExportInterruptedError]) {
+            NSString *message = [NSString stringWithFormat:NSLocalizedString(@"The export was interrupted by an error: %@\n\nThe partially written file has been kept. Export to the same location again and choose Resume to continue from the last checkpoint.", @"export interrupted message"), [sender safeObjectForKey:@"message"]];
+            [NSAlert createWarningAlertWithTitle:NSLocalizedString(@"Export Interrupted", @"export interrupted title") message:message callback:nil];
+        }
     }
 
 	[self setExportCancelled:YES];
@@ -576,9 +621,14 @@ set_input:
 
 - (void)_queueIsEmptyAfterCancelling:(id)sender
 {
-	// Loop the cached export file paths and remove them from disk if they exist
+	// Loop the cached export file paths and remove them from disk if they exist, unless they can be resumed
 	for (SPExportFile *file in exportFiles)
 	{
+		if ([[file exportCheckpoint] hasProgress]) {
+			[file close];
+			continue;
+		}
+
 		[file delete];
 	}
 	
@@ -607,6 +657,100 @@ set_input:
 	// Stop the progress indicator
 	[exportProgressIndicator stopAnimation:self];
 	[exportProgressIndicator setUsesThreadedAnimation:NO];
+
+	[self _resetExportProgressRate];
+}
+
+/**
+ * Clears the throughput readout on the progress sheet.
+ */
+- (void)_resetExportProgressRate
+{
+	rateExporter = nil;
+
+	[exportProgressRateText setStringValue:@""];
+	[exportProgressStatisticsText setStringValue:@""];
+}
+
+/**
+ * Closes the supplied export file, cancelling the export if any of its data couldn't be written.
+ *
+ * @return A BOOL indicating whether the file was written completely
+ */
+- (BOOL)_closeExportFile:(SPExportFile *)file
+{
+	[file close];
+
+	if ([file fileHandleError] == nil) return YES;
+
+	[self cancelExportForFile:[file exportFilePath]];
+
+	return NO;
+}
+
+/**
+ * Updates the throughput and estimated time remaining readout on the progress sheet from the supplied
+ * exporter's processed row count and progress value. The measurement restarts whenever a different
+ * exporter reports progress or the exporter moves on to a new table.
+ */
+- (void)_updateExportProgressRateForExporter:(SPExporter *)exporter
+{
+	NSUInteger rowCount = [exporter exportProcessedRowCount];
+	CFAbsoluteTime now = CFAbsoluteTimeGetCurrent();
+
+	if (exporter != rateExporter || rowCount < rateStartRowCount) {
+		rateExporter = exporter;
+		rateStartRowCount = rowCount;
+		rateStartTime = now;
+		rateLastUpdateTime = now;
+
+		[exportProgressRateText setStringValue:@""];
+
+		return;
+	}
+
+	// Avoid redrawing the readout for every progress tick
+	if ((now - rateLastUpdateTime) < 0.5) return;
+
+	rateLastUpdateTime = now;
+
+	if (transferStatistics) [exportProgressStatisticsText setStringValue:[transferStatistics progressSummary]];
+
+	CFAbsoluteTime elapsed = now - rateStartTime;
+
+	if (elapsed <= 0 || rowCount <= rateStartRowCount) return;
+
+	double rowsPerSecond = (rowCount - rateStartRowCount) / elapsed;
+
+	static NSNumberFormatter *rateFormatter = nil;
+	static NSDateComponentsFormatter *remainingFormatter = nil;
+	static dispatch_once_t onceToken;
+
+	dispatch_once(&onceToken, ^{
+		rateFormatter = [[NSNumberFormatter alloc] init];
+		[rateFormatter setNumberStyle:NSNumberFormatterDecimalStyle];
+		[rateFormatter setMaximumFractionDigits:0];
+
+		remainingFormatter = [[NSDateComponentsFormatter alloc] init];
+		[remainingFormatter setUnitsStyle:NSDateComponentsFormatterUnitsStyleFull];
+		[remainingFormatter setMaximumUnitCount:1];
+		[remainingFormatter setIncludesApproximationPhrase:YES];
+		[remainingFormatter setIncludesTimeRemainingPhrase:YES];
+	});
+
+	NSString *rate = [NSString stringWithFormat:NSLocalizedString(@"%@ rows/s", @"export progress throughput label"), [rateFormatter stringFromNumber:@(rowsPerSecond)]];
+
+	// Estimate the time remaining from the progress made since the measurement started
+	double progress = [exporter exportProgressValue] / MAX(1.0, [exporter exportMaxProgress]);
+
+	if (progress > 0 && progress < 1) {
+		NSTimeInterval remaining = elapsed * ((1 - progress) / progress);
+		NSString *remainingString = [remainingFormatter stringFromTimeInterval:MAX(1.0, remaining)];
+
+		if (remainingString) rate = [NSString stringWithFormat:@"%@ — %@", rate, remainingString];
+	}
+
+	[exportProgressRateText setStringValue:rate];
 }
 
 // NSOpenSavePanelDelegate - not sure why this wasn't enabled before...
@@ -867,6 +1011,14 @@ set_input:
 	}
 }
 
+/**
+ * Updates the displayed filename, whose extension depends on the selected JSON output format.
+ */
+- (IBAction)toggleJSONOutputFormat:(id)sender
+{
+	[self updateDisplayedExportFilename];
+}
+
 /**
  * Toggles the display of the advanced options box.
  */
@@ -1017,7 +1169,7 @@ set_input:
 	NSString *type = [[[exportTypeTabBar selectedTabViewItem] identifier] lowercaseString];
 	
 	// Determine the export type
-	exportType = [exportTypeTabBar indexOfTabViewItemWithIdentifier:type];
+	exportType = [self _exportTypeForTabIdentifier:type];
 	
 	// Determine what data to use (filtered result, custom query result or selected table(s)) for the export operation
 	exportSource = (exportType == SPDotExport) ? SPTableExport : [exportInputPopUpButton indexOfSelectedItem];
@@ -1030,10 +1182,15 @@ set_input:
 	//BOOL isHTML = (exportType == SPHTMLExport);
 	//BOOL isPDF  = (exportType == SPPDFExport);
 	BOOL isDot  = (exportType == SPDotExport);
+	BOOL isColumnar = (exportType == SPArrowExport || exportType == SPParquetExport);
+	BOOL isJSON = (exportType == SPJSONExport);
 	
-	BOOL enable = (isCSV || isXML /* || isHTML || isPDF  */ || isDot);
+	BOOL enable = (isCSV || isXML /* || isHTML || isPDF  */ || isDot || isColumnar || isJSON);
 	
-	[exportFilePerTableCheck setHidden:(isSQL || isDot)];		
+	// Columnar formats always write a file per table, as each file has a single schema, and
+	// so does JSON, as a file of several arrays, or of rows with differing keys, is of little use
+	[exportFilePerTableCheck setHidden:(isSQL || isDot || isColumnar || isJSON)];		
+	[exportOutputCompressionFormatPopupButton setEnabled:(!isColumnar)];
 	[exportTableList setEnabled:(!isDot)];
 	[exportSelectAllTablesButton setEnabled:(!isDot)];
 	[exportDeselectAllTablesButton setEnabled:(!isDot)];
@@ -1086,13 +1243,49 @@ set_input:
 		[exportDotForceLowerTableNamesCheck setState:(serverLowerCaseTableNameValue == 0)?NSControlStateValueOff:NSControlStateValueOn];
 	}
 	
-	[self _displayExportTypeOptions:(isSQL || isCSV || isXML || isDot)];
+	[self _displayExportTypeOptions:(isSQL || isCSV || isXML || isDot || isColumnar || isJSON)];
 	[self updateAvailableExportFilenameTokens];
 	
 	[self updateDisplayedExportFilename];
 	[self _updateExportFormatInformation];
 }
 
+/**
+ * Returns the export type of the export type tab with the supplied identifier.
+ *
+ * Tabs are only present for the supported export types, so their index doesn't match the type.
+ */
+- (SPExportType)_exportTypeForTabIdentifier:(NSString *)identifier
+{
+	NSNumber *type = [@{
+		@"sql":     @(SPSQLExport),
+		@"csv":     @(SPCSVExport),
+		@"xml":     @(SPXMLExport),
+		@"dot":     @(SPDotExport),
+		@"arrow":   @(SPArrowExport),
+		@"parquet": @(SPParquetExport),
+		@"json":    @(SPJSONExport)
+	} objectForKey:[identifier lowercaseString]];
+
+	return type ? [type unsignedIntegerValue] : SPSQLExport;
+}
+
+/**
+ * Returns the identifier of the export type tab of the supplied export type.
+ */
+- (NSString *)_tabIdentifierForExportType:(SPExportType)type
+{
+	switch (type) {
+		case SPCSVExport:     return @"csv";
+		case SPXMLExport:     return @"xml";
+		case SPDotExport:     return @"dot";
+		case SPArrowExport:   return @"arrow";
+		case SPParquetExport: return @"parquet";
+		case SPJSONExport:    return @"json";
+		default:              return @"sql";
+	}
+}
+
 /**
  * Checks for changes in the current database, by refreshing the table list and warning the user if required.
  */
@@ -1172,6 +1365,9 @@ set_input:
 			if (numberOfTables <= 1) break;
 		case SPXMLExport:
 		case SPDotExport:
+		case SPArrowExport:
+		case SPParquetExport:
+		case SPJSONExport:
 			noteText = NSLocalizedString(@"Import of the selected data is currently not supported.", @"Export file format cannot be imported warning");
 			break;
 		default:
@@ -1228,12 +1424,14 @@ set_input:
 		BOOL isXML  = (exportType == SPXMLExport);
 		BOOL isHTML = (exportType == SPHTMLExport);
 		BOOL isPDF  = (exportType == SPPDFExport);
+		BOOL isColumnar = (exportType == SPArrowExport || exportType == SPParquetExport);
+		BOOL isJSON = (exportType == SPJSONExport);
 
 		BOOL structureEnabled = [[uiStateDict objectForKey:SPSQLExportStructureEnabled] boolValue];
 		BOOL contentEnabled   = [[uiStateDict objectForKey:SPSQLExportContentEnabled] boolValue];
 		BOOL dropEnabled      = [[uiStateDict objectForKey:SPSQLExportDropEnabled] boolValue];
 
-		if (isCSV || isXML || isHTML || isPDF || (isSQL && ((!structureEnabled) || (!dropEnabled)))) {
+		if (isCSV || isXML || isHTML || isPDF || isColumnar || isJSON || (isSQL && ((!structureEnabled) || (!dropEnabled)))) {
 			enable = NO;
 
 			// Only enable the button if at least one table is selected
@@ -1321,6 +1519,17 @@ set_input:
 	[exportProgressIndicator setIndeterminate:NO];
 	[exportProgressIndicator setDoubleValue:0];
 
+	[self _resetExportProgressRate];
+
+	// Every exporter and file of the export adds to the same statistics
+	transferStatistics = [[SPTransferStatistics alloc] initWithDirection:SPTransferExport];
+
+	for (SPExporter *exporter in exporters)
+	{
+		[exporter setTransferStatistics:transferStatistics];
+		[[exporter exportOutputFile] setTransferStatistics:transferStatistics];
+	}
+
 	// If it's not already displayed, open the progress sheet
 	if (![exportProgressWindow isVisible]) {
 		[[tableDocumentInstance parentWindowControllerWindow] beginSheet:exportProgressWindow completionHandler:nil];
@@ -1358,6 +1567,15 @@ set_input:
 	// Restore query mode
 	[tableDocumentInstance setQueryMode:SPInterfaceQueryMode];
 
+	// Save the throughput report next to the (first) export file if enabled
+	[transferStatistics finish];
+
+	if ([prefs boolForKey:SPWriteTransferReports]) {
+		[transferStatistics writeReportForFileAtPath:[[exportFiles firstObject] exportFilePath]];
+	}
+
+	transferStatistics = nil;
+
 	// Display export finished notification
 	[self displayExportFinishedNotification];
 
@@ -1381,8 +1599,8 @@ set_input:
 
 	NSMutableArray *exportTables = [NSMutableArray array];
 
-	// Set whether or not we are to export to multiple files
-	[self setExportToMultipleFiles:[exportFilePerTableCheck state]];
+	// Set whether or not we are to export to multiple files, which columnar and JSON formats always do
+	[self setExportToMultipleFiles:((exportType == SPArrowExport) || (exportType == SPParquetExport) || (exportType == SPJSONExport) || [exportFilePerTableCheck state])];
 
 	// Get the data depending on the source
 	switch (exportSource)
@@ -1391,7 +1609,8 @@ set_input:
 			dataArray = [tableContentInstance currentDataResultWithNULLs:YES hideBLOBs:NO];
 			break;
 		case SPQueryExport:
-			dataArray = [customQueryInstance currentDataResultWithNULLs:YES truncateDataFields:NO];
+			// Export the loaded result directly from its store, without re-running or copying it
+			dataArray = [customQueryInstance currentDataResultForExport];
 			break;
 		case SPTableExport:
 			// Create an array of tables to export
@@ -1444,6 +1663,15 @@ set_input:
 		case SPDotExport:
 			exportTypeLabel = @"Dot";
 			break;
+		case SPArrowExport:
+			exportTypeLabel = @"Arrow";
+			break;
+		case SPParquetExport:
+			exportTypeLabel = @"Parquet";
+			break;
+		case SPJSONExport:
+			exportTypeLabel = @"JSON";
+			break;
 		case SPPDFExport:
 		case SPHTMLExport:
 		case SPExcelExport:
@@ -1691,6 +1919,46 @@ set_input:
 
 		[exporters addObject:dotExporter];
 	}
+	// Arrow and Parquet export
+	else if (exportType == SPArrowExport || exportType == SPParquetExport) {
+
+		// Start the export process depending on the data source
+		if (exportSource == SPTableExport) {
+
+			// Cache the number of tables being exported
+			exportTableCount = [exportTables count];
+
+			// Loop through the tables, creating an exporter, and file, for each
+			for (NSString *table in exportTables)
+			{
+				[exporters addObject:[self initializeColumnarExporterForTable:table orDataArray:nil]];
+			}
+		}
+		else {
+			[exporters safeAddObject:[self initializeColumnarExporterForTable:nil orDataArray:dataArray]];
+		}
+	}
+	// JSON export
+	else if (exportType == SPJSONExport) {
+
+		// Start the export process depending on the data source
+		if (exportSource == SPTableExport) {
+
+			// Cache the number of tables being exported
+			exportTableCount = [exportTables count];
+
+			// Loop through the tables, creating an exporter, and file, for each
+			for (NSString *table in exportTables)
+			{
+				[exporters addObject:[self initializeJSONExporterForTable:table orDataArray:nil]];
+			}
+		}
+		else {
+			[exporters safeAddObject:[self initializeJSONExporterForTable:nil orDataArray:dataArray]];
+		}
+	}
+
+	SPFileCompressionFormat compressionFormat = [self _exportCompressionFormat];
 
 	// For each of the created exporters, set their generic properties
 	for (SPExporter *exporter in exporters)
@@ -1701,8 +1969,9 @@ set_input:
 		[exporter setExportOutputEncoding:[connection stringEncoding]];
 		[exporter setExportMaxProgress:(NSInteger)[exportProgressIndicator bounds].size.width];
 		[exporter setExportUsingLowMemoryBlockingStreaming:([exportProcessLowMemoryButton state] == NSControlStateValueOn)];
-		[exporter setExportOutputCompressionFormat:(SPFileCompressionFormat)[exportOutputCompressionFormatPopupButton indexOfSelectedItem]];
-		[exporter setExportOutputCompressFile:([exportOutputCompressionFormatPopupButton indexOfSelectedItem] != SPNoCompression)];
+		[exporter setExportOutputCompressionFormat:compressionFormat];
+		[exporter setExportOutputCompressFile:(compressionFormat != SPNoCompression)];
+		[exporter setExportChunkRowCount:[self _exportChunkRowCount]];
 	}
 
 	NSMutableArray *problemFiles = [[NSMutableArray alloc] init];
@@ -1712,7 +1981,7 @@ set_input:
 	{
 		if ([exportFile createExportFileHandle:NO] == SPExportFileHandleCreated) {
 
-			[exportFile setCompressionFormat:(SPFileCompressionFormat)[exportOutputCompressionFormatPopupButton indexOfSelectedItem]];
+			[exportFile setCompressionFormat:compressionFormat];
 
 			if ([exportFile exportFileNeedsCSVHeader]) {
 				[self writeCSVHeaderToExportFile:exportFile];
@@ -1720,6 +1989,9 @@ set_input:
 			else if ([exportFile exportFileNeedsXMLHeader]) {
 				[self writeXMLHeaderToExportFile:exportFile];
 			}
+
+			[self _applySplitLimitsToExportFile:exportFile];
+			[self _attachCheckpointToExportFile:exportFile];
 		}
 		else {
 			[problemFiles addObject:exportFile];
@@ -1873,6 +2145,140 @@ set_input:
 	return xmlExporter;
 }
 
+/**
+ * Initialises an Arrow or Parquet exporter, depending on the selected export type, for the supplied
+ * table name or data array. As every output file has a single schema, a file is always created.
+ *
+ * @param table     The table name for which the exporter should be created for (can be nil).
+ * @param dataArray The MySQL result data array for which the exporter should be created for (can be nil).
+ */
+- (SPColumnarExporter *)initializeColumnarExporterForTable:(NSString *)table orDataArray:(NSArray *)dataArray
+{
+	SPColumnarExporter *columnarExporter = nil;
+
+	if (exportType == SPParquetExport) {
+		columnarExporter = [[SPParquetExporter alloc] initWithDelegate:self];
+
+		[columnarExporter setColumnarOutputDictionaryEncoding:[exportParquetDictionaryEncodeCheck state]];
+	}
+	else {
+		columnarExporter = [[SPArrowExporter alloc] initWithDelegate:self];
+
+		[columnarExporter setColumnarOutputDictionaryEncoding:[exportArrowDictionaryEncodeCheck state]];
+	}
+
+	// If required set the data array, along with its field definitions which determine the column types
+	if (exportSource != SPTableExport) {
+		[columnarExporter setColumnarDataArray:dataArray];
+
+		if (exportSource == SPQueryExport) {
+			[columnarExporter setColumnarFieldDefinitions:[customQueryInstance dataColumnDefinitions]];
+		}
+		else {
+			[columnarExporter setColumnarFieldDefinitions:[tableContentInstance dataColumnDefinitions]];
+		}
+	}
+
+	[columnarExporter setColumnarTableName:table];
+
+	if (createCustomFilename) {
+
+		// Create custom filename based on the selected format
+		[exportFilename setString:[self expandCustomFilenameFormatUsingTableName:table]];
+
+		// If the user chose to use a custom filename format and we exporting to multiple files, make
+		// sure the table name is included to ensure the output files are unique.
+		if (exportTableCount > 1) {
+			BOOL tableNameInTokens = NO;
+			NSArray *representedObjects = [exportCustomFilenameTokenField objectValue];
+			for (id representedObject in representedObjects) {
+				if ([representedObject isKindOfClass:[SPExportFileNameTokenObject class]] && [[representedObject tokenId] isEqualToString:SPFileNameTableTokenName]) tableNameInTokens = YES;
+			}
+			[exportFilename setString:(tableNameInTokens ? exportFilename : [exportFilename stringByAppendingFormat:@"_%@", table])];
+		}
+	}
+	else {
+		BOOL isSingleFileExport = (exportSource != SPTableExport || exportTableCount == 1);
+		[exportFilename setString:(isSingleFileExport) ? [self generateDefaultExportFilename] : table];
+	}
+
+	// Only append the extension if necessary
+	if (![[exportFilename pathExtension] length]) {
+		[exportFilename setString:[exportFilename stringByAppendingPathExtension:[self currentDefaultExportFileExtension]]];
+	}
+
+	SPExportFile *file = [SPExportFile exportFileAtPath:[[exportPathField stringValue] stringByAppendingPathComponent:exportFilename]];
+
+	[exportFiles addObject:file];
+
+	[columnarExporter setExportOutputFile:file];
+
+	return columnarExporter;
+}
+
+/**
+ * Initialises a JSON exporter for the supplied table name or data array. Every table is written to
+ * its own file, so a file is always created.
+ *
+ * @param table     The table name for which the exporter should be created for (can be nil).
+ * @param dataArray The MySQL result data array for which the exporter should be created for (can be nil).
+ */
+- (SPJSONExporter *)initializeJSONExporterForTable:(NSString *)table orDataArray:(NSArray *)dataArray
+{
+	SPJSONExporter *jsonExporter = [[SPJSONExporter alloc] initWithDelegate:self];
+
+	[jsonExporter setJsonFormat:[exportJSONFormatPopUpButton indexOfSelectedItem]];
+	[jsonExporter setJsonBinaryEncoding:[exportJSONBinaryEncodingPopUpButton indexOfSelectedItem]];
+
+	// If required set the data array, along with its field definitions which determine how values are written
+	if (exportSource != SPTableExport) {
+		[jsonExporter setJsonDataArray:dataArray];
+
+		if (exportSource == SPQueryExport) {
+			[jsonExporter setJsonFieldDefinitions:[customQueryInstance dataColumnDefinitions]];
+		}
+		else {
+			[jsonExporter setJsonFieldDefinitions:[tableContentInstance dataColumnDefinitions]];
+		}
+	}
+
+	[jsonExporter setJsonTableName:table];
+
+	if (createCustomFilename) {
+
+		// Create custom filename based on the selected format
+		[exportFilename setString:[self expandCustomFilenameFormatUsingTableName:table]];
+
+		// If the user chose to use a custom filename format and we exporting to multiple files, make
+		// sure the table name is included to ensure the output files are unique.
+		if (exportTableCount > 1) {
+			BOOL tableNameInTokens = NO;
+			NSArray *representedObjects = [exportCustomFilenameTokenField objectValue];
+			for (id representedObject in representedObjects) {
+				if ([representedObject isKindOfClass:[SPExportFileNameTokenObject class]] && [[representedObject tokenId] isEqualToString:SPFileNameTableTokenName]) tableNameInTokens = YES;
+			}
+			[exportFilename setString:(tableNameInTokens ? exportFilename : [exportFilename stringByAppendingFormat:@"_%@", table])];
+		}
+	}
+	else {
+		BOOL isSingleFileExport = (exportSource != SPTableExport || exportTableCount == 1);
+		[exportFilename setString:(isSingleFileExport) ? [self generateDefaultExportFilename] : table];
+	}
+
+	// Only append the extension if necessary
+	if (![[exportFilename pathExtension] length]) {
+		[exportFilename setString:[exportFilename stringByAppendingPathExtension:[self currentDefaultExportFileExtension]]];
+	}
+
+	SPExportFile *file = [SPExportFile exportFileAtPath:[[exportPathField stringValue] stringByAppendingPathComponent:exportFilename]];
+
+	[exportFiles addObject:file];
+
+	[jsonExporter setExportOutputFile:file];
+
+	return jsonExporter;
+}
+
 #pragma mark - SPExportFileUtilitiesPrivateAPI
 
 /**
@@ -1972,6 +2378,7 @@ set_input:
 	NSUInteger parentFoldersNotWritable = 0;
 	NSUInteger filesFailed = 0;
 	NSUInteger noExportDirChosen = 0;
+	NSUInteger filesResumable = 0;
 
 	for (SPExportFile *file in files)
 	{
@@ -1981,6 +2388,8 @@ set_input:
 		}
 		else if ([file exportFileHandleStatus] == SPExportFileHandleExists) {
 			filesAlreadyExisting++;
+
+			if ([self _resumableCheckpointForExportFile:file]) filesResumable++;
 		}
 		// For file handles that we failed to create for some unknown reason, ignore them and remove any
 		// exporters that are associated with them.
@@ -2042,9 +2451,19 @@ set_input:
 
 		if ((filesAlreadyExisting + filesFailed) != [exportFiles count]) {
 			[alert addButtonWithTitle:NSLocalizedString(@"Skip existing", @"skip existing button")];
-			[[[alert buttons] objectAtIndex:2] setTag:SPExportErrorSkipErrorFiles];
-			[[[alert buttons] objectAtIndex:2] setKeyEquivalent:@"s"];
-			[[[alert buttons] objectAtIndex:2] setKeyEquivalentModifierMask:NSEventModifierFlagCommand];
+			[[[alert buttons] lastObject] setTag:SPExportErrorSkipErrorFiles];
+			[[[alert buttons] lastObject] setKeyEquivalent:@"s"];
+			[[[alert buttons] lastObject] setKeyEquivalentModifierMask:NSEventModifierFlagCommand];
+		}
+
+		// Interrupted chunked exports can be continued from their last checkpoint instead
+		if (filesResumable) {
+			[alert setInformativeText:[[alert informativeText] stringByAppendingString:NSLocalizedString(@"\n\nAn interrupted export can be resumed from its last checkpoint.", @"export file can be resumed explanatory text")]];
+
+			[alert addButtonWithTitle:NSLocalizedString(@"Resume", @"resume export button")];
+			[[[alert buttons] lastObject] setTag:SPExportErrorResumeFiles];
+			[[[alert buttons] lastObject] setKeyEquivalent:@"e"];
+			[[[alert buttons] lastObject] setKeyEquivalentModifierMask:NSEventModifierFlagCommand];
 		}
 	}
 	// If one or multiple files failed, but only due to unhandled errors, show a short dialog
@@ -2129,15 +2548,20 @@ set_input:
 			[self performSelector:@selector(startExport) withObject:nil afterDelay:0.1];
 		}
 	}
-	// Overwrite the files and continue
-	else if (returnCode == SPExportErrorReplaceFiles) {
+	// Overwrite the files (or, when resuming, append to those with a checkpoint) and continue
+	else if (returnCode == SPExportErrorReplaceFiles || returnCode == SPExportErrorResumeFiles) {
 
 		for (SPExportFile *file in files)
 		{
 			if ([file exportFileHandleStatus] == SPExportFileHandleExists) {
+				SPExportCheckpoint *checkpoint = (returnCode == SPExportErrorResumeFiles) ? [self _resumableCheckpointForExportFile:file] : nil;
+
+				if (checkpoint && [file resumeExportFileHandleFromCheckpoint:checkpoint] == SPExportFileHandleCreated) {
+					continue;
+				}
 
 				if ([file createExportFileHandle:YES] == SPExportFileHandleCreated) {
-					[file setCompressionFormat:(SPFileCompressionFormat)[exportOutputCompressionFormatPopupButton indexOfSelectedItem]];
+					[file setCompressionFormat:[self _exportCompressionFormat]];
 
 					if ([file exportFileNeedsCSVHeader]) {
 						[self writeCSVHeaderToExportFile:file];
@@ -2145,6 +2569,9 @@ set_input:
 					else if ([file exportFileNeedsXMLHeader]) {
 						[self writeXMLHeaderToExportFile:file];
 					}
+
+					[self _applySplitLimitsToExportFile:file];
+					[self _attachCheckpointToExportFile:file];
 				}
 			}
 		}
@@ -2171,6 +2598,91 @@ set_input:
 	}
 }
 
+/**
+ * Returns the number of rows per chunk to use when walking tables in primary key order, or 0 if tables
+ * should be exported using a single query.  Only SQL and CSV table exports support chunking.
+ */
+- (NSUInteger)_exportChunkRowCount
+{
+	if (exportSource != SPTableExport || (exportType != SPSQLExport && exportType != SPCSVExport)) return 0;
+
+	if (![prefs boolForKey:SPExportChunkedByPrimaryKey]) return 0;
+
+	return (NSUInteger)MAX(1, [prefs integerForKey:SPExportChunkRowCount]);
+}
+
+/**
+ * Sets up a resume checkpoint for a newly created export file if the export is chunked.
+ * Compressed output can't be truncated back to a checkpoint, so it is never resumable.
+ *
+ * @param file The export file
+ */
+- (void)_attachCheckpointToExportFile:(SPExportFile *)file
+{
+	if (![self _exportChunkRowCount] || [exportOutputCompressionFormatPopupButton indexOfSelectedItem] != SPNoCompression || [file splitsOutput]) return;
+
+	SPExportCheckpoint *checkpoint = [[SPExportCheckpoint alloc] initWithExportFilePath:[file exportFilePath]];
+
+	[checkpoint setExportFormat:exportTypeLabel];
+	[checkpoint setDatabaseName:self.exportDatabaseName];
+
+	// Remove any stale manifest left by a previous export to the same path
+	[checkpoint removeManifest];
+
+	[file setExportCheckpoint:checkpoint];
+}
+
+/**
+ * Returns whether the output of the current export is split into numbered parts after a number of
+ * megabytes or rows.  Only SQL and CSV table exports support splitting.
+ */
+- (BOOL)_exportSplitsOutput
+{
+	if (exportSource != SPTableExport || (exportType != SPSQLExport && exportType != SPCSVExport)) return NO;
+
+	return ([prefs integerForKey:SPExportSplitFileSizeMB] > 0 || [prefs integerForKey:SPExportSplitFileRowCount] > 0);
+}
+
+/**
+ * Sets up the newly created export file to roll over to a new part whenever the configured size or
+ * row limit is reached.  Split exports are never resumable, as a checkpoint only covers a single file.
+ *
+ * @param file The export file
+ */
+- (void)_applySplitLimitsToExportFile:(SPExportFile *)file
+{
+	if (![self _exportSplitsOutput]) return;
+
+	[file setSplitByteLimit:(unsigned long long)MAX(0, [prefs integerForKey:SPExportSplitFileSizeMB]) * 1024 * 1024];
+	[file setSplitRowLimit:(NSUInteger)MAX(0, [prefs integerForKey:SPExportSplitFileRowCount])];
+
+	[file splitOutputWithFormat:exportTypeLabel database:self.exportDatabaseName];
+}
+
+/**
+ * Returns the checkpoint of an interrupted export to the supplied (existing) file, if the
+ * current export can be resumed from it.
+ *
+ * @param file The export file
+ *
+ * @return The checkpoint or nil
+ */
+- (SPExportCheckpoint *)_resumableCheckpointForExportFile:(SPExportFile *)file
+{
+	if (![self _exportChunkRowCount] || [exportOutputCompressionFormatPopupButton indexOfSelectedItem] != SPNoCompression || [self _exportSplitsOutput]) return nil;
+
+	SPExportCheckpoint *checkpoint = [SPExportCheckpoint checkpointForExportFilePath:[file exportFilePath]];
+
+	if (![checkpoint hasProgress] ||
+		![[checkpoint exportFormat] isEqualToString:exportTypeLabel] ||
+		![[checkpoint databaseName] isEqualToString:self.exportDatabaseName])
+	{
+		return nil;
+	}
+
+	return checkpoint;
+}
+
 /**
  * Re-open the export sheet without resetting the interface - for use on error.
  */
@@ -2199,6 +2711,17 @@ set_input:
     }];
 }
 
+/**
+ * Returns the compression format of the export files. Columnar formats are already compact and
+ * need to be seekable by their readers, so are never compressed as a whole.
+ */
+- (SPFileCompressionFormat)_exportCompressionFormat
+{
+	if (exportType == SPArrowExport || exportType == SPParquetExport) return SPNoCompression;
+
+	return (SPFileCompressionFormat)[exportOutputCompressionFormatPopupButton indexOfSelectedItem];
+}
+
 #pragma mark - SPExportFilenameUtilities
 
 /**
@@ -2387,6 +2910,15 @@ set_input:
 		case SPDotExport:
 			extension = @"dot";
 			break;
+		case SPArrowExport:
+			extension = @"arrows";
+			break;
+		case SPParquetExport:
+			extension = @"parquet";
+			break;
+		case SPJSONExport:
+			extension = ([exportJSONFormatPopUpButton indexOfSelectedItem] == SPJSONExportArrayFormat) ? @"json" : @"ndjson";
+			break;
 		case SPPDFExport:
 		case SPHTMLExport:
 		case SPExcelExport:
@@ -2395,9 +2927,9 @@ set_input:
 			return nil;
 	}
 
-	if ([exportOutputCompressionFormatPopupButton indexOfSelectedItem] != SPNoCompression) {
+	if ([self _exportCompressionFormat] != SPNoCompression) {
 
-		SPFileCompressionFormat compressionFormat = (SPFileCompressionFormat)[exportOutputCompressionFormatPopupButton indexOfSelectedItem];
+		SPFileCompressionFormat compressionFormat = [self _exportCompressionFormat];
 
 		if ([extension length] > 0) {
 			extension = [extension stringByAppendingPathExtension:(compressionFormat == SPGzipCompression) ? @"gz" : @"bz2"];
@@ -2945,6 +3477,9 @@ set_input:
 			NAMEOF(SPCSVExport);
 			NAMEOF(SPXMLExport);
 			NAMEOF(SPDotExport);
+			NAMEOF(SPArrowExport);
+			NAMEOF(SPParquetExport);
+			NAMEOF(SPJSONExport);
 			NAMEOF(SPPDFExport);
 			NAMEOF(SPHTMLExport);
 			NAMEOF(SPExcelExport);
@@ -2959,6 +3494,9 @@ set_input:
 	VALUEOF(SPCSVExport, etd, dst);
 	VALUEOF(SPXMLExport, etd, dst);
 	VALUEOF(SPDotExport, etd, dst);
+	VALUEOF(SPArrowExport, etd, dst);
+	VALUEOF(SPParquetExport, etd, dst);
+	VALUEOF(SPJSONExport, etd, dst);
 	//VALUEOF(SPPDFExport, etd, dst);
 	//VALUEOF(SPHTMLExport, etd, dst);
 	//VALUEOF(SPExcelExport, etd, dst);
@@ -2999,6 +3537,38 @@ set_input:
 	return NO;
 }
 
++ (NSString *)describeJSONExportFormat:(SPJSONExportFormat)jf
+{
+	switch (jf) {
+			NAMEOF(SPJSONExportNDJSONFormat);
+			NAMEOF(SPJSONExportArrayFormat);
+	}
+	return nil;
+}
+
++ (BOOL)copyJSONExportFormatForDescription:(NSString *)jfd to:(SPJSONExportFormat *)dst
+{
+	VALUEOF(SPJSONExportNDJSONFormat, jfd, dst);
+	VALUEOF(SPJSONExportArrayFormat,  jfd, dst);
+	return NO;
+}
+
++ (NSString *)describeJSONExportBinaryEncoding:(SPJSONExportBinaryEncoding)je
+{
+	switch (je) {
+			NAMEOF(SPJSONExportBase64Encoding);
+			NAMEOF(SPJSONExportHexEncoding);
+	}
+	return nil;
+}
+
++ (BOOL)copyJSONExportBinaryEncodingForDescription:(NSString *)jed to:(SPJSONExportBinaryEncoding *)dst
+{
+	VALUEOF(SPJSONExportBase64Encoding, jed, dst);
+	VALUEOF(SPJSONExportHexEncoding,    jed, dst);
+	return NO;
+}
+
 + (NSString *)describeSQLExportInsertDivider:(SPSQLExportInsertDivider)eid
 {
 	switch (eid) {
@@ -3259,7 +3829,7 @@ set_input:
 	
 	SPExportType et;
 	if((o = [dict safeObjectForKey:@"exportType"]) && [[self class] copyExportTypeForDescription:o to:&et]) {
-		[exportTypeTabBar selectTabViewItemAtIndex:et];
+		[exportTypeTabBar selectTabViewItemWithIdentifier:[self _tabIdentifierForExportType:et]];
 	}
 
 	//exportType should be changed first, as exportSource depends on it
@@ -3309,6 +3879,11 @@ set_input:
 			return [self xmlSettings];
 		case SPDotExport:
 			return [self dotSettings];
+		case SPArrowExport:
+		case SPParquetExport:
+			return [self columnarSettings];
+		case SPJSONExport:
+			return [self jsonSettings];
 		case SPExcelExport:
 		case SPHTMLExport:
 		case SPPDFExport:
@@ -3330,6 +3905,11 @@ set_input:
 			return [self applyXmlSettings:settings];
 		case SPDotExport:
 			return [self applyDotSettings:settings];
+		case SPArrowExport:
+		case SPParquetExport:
+			return [self applyColumnarSettings:settings];
+		case SPJSONExport:
+			return [self applyJsonSettings:settings];
 		case SPExcelExport:
 		case SPHTMLExport:
 		case SPPDFExport:
@@ -3378,6 +3958,40 @@ set_input:
 	if((o = [settings objectForKey:@"DotForceLowerTableNames"])) SetOnOff(o, exportDotForceLowerTableNamesCheck);
 }
 
+- (NSDictionary *)columnarSettings
+{
+	NSButton *dictionaryEncodeCheck = (exportType == SPParquetExport) ? exportParquetDictionaryEncodeCheck : exportArrowDictionaryEncodeCheck;
+
+	return @{@"DictionaryEncode": IsOn(dictionaryEncodeCheck)};
+}
+
+- (void)applyColumnarSettings:(NSDictionary *)settings
+{
+	id o;
+	NSButton *dictionaryEncodeCheck = (exportType == SPParquetExport) ? exportParquetDictionaryEncodeCheck : exportArrowDictionaryEncodeCheck;
+
+	if((o = [settings objectForKey:@"DictionaryEncode"])) SetOnOff(o, dictionaryEncodeCheck);
+}
+
+- (NSDictionary *)jsonSettings
+{
+	return @{
+			 @"JSONFormat":         [[self class] describeJSONExportFormat:(SPJSONExportFormat)[exportJSONFormatPopUpButton indexOfSelectedItem]],
+			 @"JSONBinaryEncoding": [[self class] describeJSONExportBinaryEncoding:(SPJSONExportBinaryEncoding)[exportJSONBinaryEncodingPopUpButton indexOfSelectedItem]]
+			 };
+}
+
+- (void)applyJsonSettings:(NSDictionary *)settings
+{
+	id o;
+	SPJSONExportFormat jsonf;
+	SPJSONExportBinaryEncoding jsone;
+	if((o = [settings safeObjectForKey:@"JSONFormat"]) && [[self class] copyJSONExportFormatForDescription:o to:&jsonf]) [exportJSONFormatPopUpButton selectItemAtIndex:jsonf];
+	if((o = [settings safeObjectForKey:@"JSONBinaryEncoding"]) && [[self class] copyJSONExportBinaryEncodingForDescription:o to:&jsone]) [exportJSONBinaryEncodingPopUpButton selectItemAtIndex:jsone];
+
+	[self toggleJSONOutputFormat:exportJSONFormatPopUpButton];
+}
+
 - (NSDictionary *)xmlSettings
 {
 	return @{
@@ -3468,6 +4082,11 @@ set_input:
 			return [self xmlSpecificSettingsForSchemaObject:name ofType:type];
 		case SPDotExport:
 			return [self dotSpecificSettingsForSchemaObject:name ofType:type];
+		case SPArrowExport:
+		case SPParquetExport:
+			return [self columnarSpecificSettingsForSchemaObject:name ofType:type];
+		case SPJSONExport:
+			return [self jsonSpecificSettingsForSchemaObject:name ofType:type];
 		case SPExcelExport:
 		case SPHTMLExport:
 		case SPPDFExport:
@@ -3489,6 +4108,11 @@ set_input:
 			return [self applyXmlSpecificSettings:settings forSchemaObject:name ofType:type];
 		case SPDotExport:
 			return [self applyDotSpecificSettings:settings forSchemaObject:name ofType:type];
+		case SPArrowExport:
+		case SPParquetExport:
+			return [self applyColumnarSpecificSettings:settings forSchemaObject:name ofType:type];
+		case SPJSONExport:
+			return [self applyJsonSpecificSettings:settings forSchemaObject:name ofType:type];
 		case SPExcelExport:
 		case SPHTMLExport:
 		case SPPDFExport:
@@ -3538,6 +4162,62 @@ set_input:
 	}
 }
 
+- (id)columnarSpecificSettingsForSchemaObject:(NSString *)name ofType:(SPTableType)type
+{
+	// Arrow and Parquet per table setting is only yes/no
+	if(type == SPTableTypeTable) {
+		// we have to look through the table views' rows to find the current checkbox value...
+		for (NSArray *table in tables) {
+			if([[table firstObject] isEqualTo:name]) {
+				return @([[table safeObjectAtIndex:2] boolValue]);
+			}
+		}
+	}
+	return nil;
+}
+
+- (void)applyColumnarSpecificSettings:(id)settings forSchemaObject:(NSString *)name ofType:(SPTableType)type
+{
+	// Arrow and Parquet per table setting is only yes/no
+	if(type == SPTableTypeTable) {
+		// we have to look through the table views' rows to find the appropriate table...
+		for (NSMutableArray *table in tables) {
+			if([[table firstObject] isEqualTo:name]) {
+				[table safeReplaceObjectAtIndex:2 withObject:@([settings boolValue])];
+				return;
+			}
+		}
+	}
+}
+
+- (id)jsonSpecificSettingsForSchemaObject:(NSString *)name ofType:(SPTableType)type
+{
+	// JSON per table setting is only yes/no
+	if(type == SPTableTypeTable) {
+		// we have to look through the table views' rows to find the current checkbox value...
+		for (NSArray *table in tables) {
+			if([[table firstObject] isEqualTo:name]) {
+				return @([[table safeObjectAtIndex:2] boolValue]);
+			}
+		}
+	}
+	return nil;
+}
+
+- (void)applyJsonSpecificSettings:(id)settings forSchemaObject:(NSString *)name ofType:(SPTableType)type
+{
+	// JSON per table setting is only yes/no
+	if(type == SPTableTypeTable) {
+		// we have to look through the table views' rows to find the appropriate table...
+		for (NSMutableArray *table in tables) {
+			if([[table firstObject] isEqualTo:name]) {
+				[table safeReplaceObjectAtIndex:2 withObject:@([settings boolValue])];
+				return;
+			}
+		}
+	}
+}
+
 - (id)csvSpecificSettingsForSchemaObject:(NSString *)name ofType:(SPTableType)type
 {
 	// CSV per table setting is only yes/no
@@ -3651,8 +4331,9 @@ set_input:
 	// If required add the next exporter to the operation queue
 	if ((exportCount > 0) && (exportSource == SPTableExport)) {
 
-		// If we're only exporting to a single file then write a header for the next table
-		if (!exportToMultipleFiles) {
+		// If we're only exporting to a single file then write a header for the next table, unless a resumed
+		// export already wrote it before its checkpoint
+		if (!exportToMultipleFiles && ![[[exporter exportOutputFile] exportCheckpoint] hasOutputForTable:[(SPCSVExporter *)[exporters firstObject] csvTableName]]) {
 
 			// If we're exporting multiple tables to a single file then append some space and the next table's
 			// name, but only if there is at least 2 exportes left.
@@ -3666,8 +4347,8 @@ set_input:
 		}
 		// Otherwise close the file handle of the exporter that just finished
 		// ensuring it's data is written to disk.
-		else {
-			[[exporter exportOutputFile] close];
+		else if (![self _closeExportFile:[exporter exportOutputFile]]) {
+			return;
 		}
 
 		[operationQueue addOperation:[exporters firstObject]];
@@ -3679,7 +4360,13 @@ set_input:
 	// Otherwise if the exporter list is empty, close the progress sheet
 	else {
 		// Close the last exporter's file handle
-		[[exporter exportOutputFile] close];
+		if (![self _closeExportFile:[exporter exportOutputFile]]) return;
+
+		// The export is complete, so there is nothing left to resume
+		for (SPExportFile *file in exportFiles)
+		{
+			[[file exportCheckpoint] removeManifest];
+		}
 
 		[self exportEnded];
 	}
@@ -3706,6 +4393,8 @@ set_input:
 - (void)csvExportProcessProgressUpdated:(SPCSVExporter *)exporter
 {
 	[exportProgressIndicator setDoubleValue:[exporter exportProgressValue]];
+
+	[self _updateExportProgressRateForExporter:exporter];
 }
 
 #pragma mark - SPSQLExporterDelegate
@@ -3737,6 +4426,8 @@ set_input:
 	}
 
 	[exportProgressIndicator setDoubleValue:[exporter exportProgressValue]];
+
+	[self _updateExportProgressRateForExporter:exporter];
 }
 
 - (void)sqlExportProcessWillBeginFetchingData:(SPSQLExporter *)exporter
@@ -3799,7 +4490,8 @@ set_input:
 			}
 
 			[[exporter exportOutputFile] writeData:[string dataUsingEncoding:[connection stringEncoding]]];
-			[[exporter exportOutputFile] close];
+
+			if (![self _closeExportFile:[exporter exportOutputFile]]) return;
 		}
 
 		[operationQueue addOperation:[exporters firstObject]];
@@ -3820,7 +4512,8 @@ set_input:
 		}
 
 		[[exporter exportOutputFile] writeData:[string dataUsingEncoding:[connection stringEncoding]]];
-		[[exporter exportOutputFile] close];
+
+		if (![self _closeExportFile:[exporter exportOutputFile]]) return;
 
 		[self exportEnded];
 	}
@@ -3829,6 +4522,8 @@ set_input:
 - (void)xmlExportProcessProgressUpdated:(SPXMLExporter *)exporter
 {
 	[[exportProgressIndicator onMainThread] setDoubleValue:[exporter exportProgressValue]];
+
+	[self _updateExportProgressRateForExporter:exporter];
 }
 
 - (void)xmlExportProcessWillBeginWritingData:(SPXMLExporter *)exporter
@@ -3849,6 +4544,144 @@ set_input:
 	[exportProgressIndicator setDoubleValue:0];
 }
 
+#pragma mark - SPColumnarExporterDelegate
+
+- (void)columnarExportProcessWillBegin:(SPColumnarExporter *)exporter
+{
+	[exportProgressText displayIfNeeded];
+
+	[exportProgressIndicator setIndeterminate:YES];
+	[exportProgressIndicator setUsesThreadedAnimation:YES];
+	[exportProgressIndicator startAnimation:self];
+
+	// Only update the progress text if this is a table export
+	if (exportSource == SPTableExport) {
+
+		// Update the current table export index
+		currentTableExportIndex = (exportTableCount - [exporters count]);
+
+		[exportProgressText setStringValue:[NSString stringWithFormat:NSLocalizedString(@"Table %lu of %lu (%@): Fetching data...", @"export label showing that the app is fetching data for a specific table"), currentTableExportIndex, exportTableCount, [exporter columnarTableName]]];
+	}
+	else {
+		[exportProgressText setStringValue:NSLocalizedString(@"Fetching data...", @"export label showing that the app is fetching data")];
+	}
+
+	[exportProgressText displayIfNeeded];
+}
+
+- (void)columnarExportProcessComplete:(SPColumnarExporter *)exporter
+{
+	// Every table is written to its own file, which is complete once its exporter has finished
+	if (![self _closeExportFile:[exporter exportOutputFile]]) return;
+
+	// If required add the next exporter to the operation queue
+	if (([exporters count] > 0) && (exportSource == SPTableExport)) {
+		[operationQueue addOperation:[exporters firstObject]];
+
+		// Remove the exporter we just added to the operation queue from our list of exporters
+		// so we know it's already been done.
+		[exporters safeRemoveObjectAtIndex:0];
+	}
+	// Otherwise if the exporter list is empty, close the progress sheet
+	else {
+		[self exportEnded];
+	}
+}
+
+- (void)columnarExportProcessProgressUpdated:(SPColumnarExporter *)exporter
+{
+	[[exportProgressIndicator onMainThread] setDoubleValue:[exporter exportProgressValue]];
+
+	[self _updateExportProgressRateForExporter:exporter];
+}
+
+- (void)columnarExportProcessWillBeginWritingData:(SPColumnarExporter *)exporter
+{
+	// Only update the progress text if this is a table export
+	if (exportSource == SPTableExport) {
+		[exportProgressText setStringValue:[NSString stringWithFormat:NSLocalizedString(@"Table %lu of %lu (%@): Writing data...", @"export label showing app if writing data for a specific table"), currentTableExportIndex, exportTableCount, [exporter columnarTableName]]];
+	}
+	else {
+		[exportProgressText setStringValue:NSLocalizedString(@"Writing data...", @"export label showing app is writing data")];
+	}
+
+	[exportProgressText displayIfNeeded];
+
+	[exportProgressIndicator stopAnimation:self];
+	[exportProgressIndicator setUsesThreadedAnimation:NO];
+	[exportProgressIndicator setIndeterminate:NO];
+	[exportProgressIndicator setDoubleValue:0];
+}
+
+#pragma mark - SPJSONExporterDelegate
+
+- (void)jsonExportProcessWillBegin:(SPJSONExporter *)exporter
+{
+	[exportProgressText displayIfNeeded];
+
+	[exportProgressIndicator setIndeterminate:YES];
+	[exportProgressIndicator setUsesThreadedAnimation:YES];
+	[exportProgressIndicator startAnimation:self];
+
+	// Only update the progress text if this is a table export
+	if (exportSource == SPTableExport) {
+
+		// Update the current table export index
+		currentTableExportIndex = (exportTableCount - [exporters count]);
+
+		[exportProgressText setStringValue:[NSString stringWithFormat:NSLocalizedString(@"Table %lu of %lu (%@): Fetching data...", @"export label showing that the app is fetching data for a specific table"), currentTableExportIndex, exportTableCount, [exporter jsonTableName]]];
+	}
+	else {
+		[exportProgressText setStringValue:NSLocalizedString(@"Fetching data...", @"export label showing that the app is fetching data")];
+	}
+
+	[exportProgressText displayIfNeeded];
+}
+
+- (void)jsonExportProcessComplete:(SPJSONExporter *)exporter
+{
+	// Every table is written to its own file, which is complete once its exporter has finished
+	if (![self _closeExportFile:[exporter exportOutputFile]]) return;
+
+	// If required add the next exporter to the operation queue
+	if (([exporters count] > 0) && (exportSource == SPTableExport)) {
+		[operationQueue addOperation:[exporters firstObject]];
+
+		// Remove the exporter we just added to the operation queue from our list of exporters
+		// so we know it's already been done.
+		[exporters safeRemoveObjectAtIndex:0];
+	}
+	// Otherwise if the exporter list is empty, close the progress sheet
+	else {
+		[self exportEnded];
+	}
+}
+
+- (void)jsonExportProcessProgressUpdated:(SPJSONExporter *)exporter
+{
+	[[exportProgressIndicator onMainThread] setDoubleValue:[exporter exportProgressValue]];
+
+	[self _updateExportProgressRateForExporter:exporter];
+}
+
+- (void)jsonExportProcessWillBeginWritingData:(SPJSONExporter *)exporter
+{
+	// Only update the progress text if this is a table export
+	if (exportSource == SPTableExport) {
+		[exportProgressText setStringValue:[NSString stringWithFormat:NSLocalizedString(@"Table %lu of %lu (%@): Writing data...", @"export label showing app if writing data for a specific table"), currentTableExportIndex, exportTableCount, [exporter jsonTableName]]];
+	}
+	else {
+		[exportProgressText setStringValue:NSLocalizedString(@"Writing data...", @"export label showing app is writing data")];
+	}
+
+	[exportProgressText displayIfNeeded];
+
+	[exportProgressIndicator stopAnimation:self];
+	[exportProgressIndicator setUsesThreadedAnimation:NO];
+	[exportProgressIndicator setIndeterminate:NO];
+	[exportProgressIndicator setDoubleValue:0];
+}
+
 #pragma mark - SPDotExporterDelegate
 
 - (void)dotExportProcessWillBegin:(SPDotExporter *)exporter
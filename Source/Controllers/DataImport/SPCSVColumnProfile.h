@@ -0,0 +1,63 @@
+//
+//  SPCSVColumnProfile.h
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+/**
+ * @class SPCSVColumnProfile SPCSVColumnProfile.h
+ *
+ * Sums up the values of each column of some CSV rows - whether every value is an integer, and the
+ * longest value - for choosing the types of the columns of a table to import the rows into.
+ */
+@interface SPCSVColumnProfile : NSObject
+{
+	NSUInteger columnCount;
+	NSUInteger *maxLengths;
+	BOOL *columnsAreText;
+	NSUInteger rowCount;
+}
+
+/**
+ * @property columnCount The number of columns profiled; rows with more have the rest ignored
+ */
+@property (readonly, assign) NSUInteger columnCount;
+
+/**
+ * @property rowCount The number of rows profiled
+ */
+@property (readonly, assign) NSUInteger rowCount;
+
+- (instancetype)initWithColumnCount:(NSUInteger)count;
+
+- (void)addRow:(NSArray *)row;
+- (void)addProfile:(SPCSVColumnProfile *)profile;
+
+- (BOOL)columnIsInteger:(NSUInteger)column;
+- (NSUInteger)maxLengthOfColumn:(NSUInteger)column;
+
+@end
@@ -0,0 +1,114 @@
+//
+//  SPCSVColumnProfile.m
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPCSVColumnProfile.h"
+
+@implementation SPCSVColumnProfile
+
+@synthesize columnCount;
+@synthesize rowCount;
+
+/**
+ * Initialises a profile of the supplied number of columns, holding no rows yet; until values are
+ * added every column counts as an integer column.
+ */
+- (instancetype)initWithColumnCount:(NSUInteger)count
+{
+	if ((self = [super init])) {
+		columnCount = count;
+		rowCount = 0;
+		maxLengths = calloc(MAX(count, 1), sizeof(NSUInteger));
+		columnsAreText = calloc(MAX(count, 1), sizeof(BOOL));
+	}
+
+	return self;
+}
+
+/**
+ * Adds the values of a row. NULLs, and values which weren't loaded, don't count.
+ */
+- (void)addRow:(NSArray *)row
+{
+	NSUInteger valueCount = MIN([row count], columnCount);
+
+	for (NSUInteger column = 0; column < valueCount; column++)
+	{
+		id value = [row objectAtIndex:column];
+
+		if ([value isNSNull] || [value isSPNotLoaded]) continue;
+
+		if ([value isKindOfClass:[NSString class]] && maxLengths[column] < [(NSString *)value length]) {
+			maxLengths[column] = [(NSString *)value length];
+		}
+
+		// Anything which doesn't survive being read as a number and written out again is text
+		if (!columnsAreText[column] && ![[[NSNumber numberWithLongLong:[value longLongValue]] stringValue] isEqualToString:value]) {
+			columnsAreText[column] = YES;
+		}
+	}
+
+	rowCount++;
+}
+
+/**
+ * Adds the rows of another profile of the same columns.
+ */
+- (void)addProfile:(SPCSVColumnProfile *)profile
+{
+	NSUInteger sharedColumnCount = MIN(columnCount, [profile columnCount]);
+
+	for (NSUInteger column = 0; column < sharedColumnCount; column++)
+	{
+		maxLengths[column] = MAX(maxLengths[column], profile->maxLengths[column]);
+		columnsAreText[column] = columnsAreText[column] || profile->columnsAreText[column];
+	}
+
+	rowCount += [profile rowCount];
+}
+
+- (BOOL)columnIsInteger:(NSUInteger)column
+{
+	return column < columnCount && !columnsAreText[column];
+}
+
+- (NSUInteger)maxLengthOfColumn:(NSUInteger)column
+{
+	return column < columnCount ? maxLengths[column] : 0;
+}
+
+#pragma mark -
+
+- (void)dealloc
+{
+	free(maxLengths);
+	free(columnsAreText);
+}
+
+@end
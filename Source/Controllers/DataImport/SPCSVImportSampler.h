@@ -0,0 +1,86 @@
+//
+//  SPCSVImportSampler.h
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+@class SPCSVParser;
+@class SPCSVColumnProfile;
+
+/**
+ * @class SPCSVImportSampler SPCSVImportSampler.h
+ *
+ * Holds a sample of a CSV file for the field mapper: the start of the file, and, for uncompressed
+ * files too large to take whole, a few slices from random points further on. The sample is read
+ * once and kept, so when the import is started again with other CSV settings it is only parsed
+ * again, without reading the file.
+ *
+ * Each time the sample is parsed, the columns of its rows are profiled in the background, ready
+ * for choosing column types should the rows be imported into a new table. Rows from the random
+ * slices are parsed from the first line ending in each slice, and only kept if they have as many
+ * fields as the first row of the file, which leaves out most rows misread by starting in the
+ * middle of a quoted field.
+ */
+@interface SPCSVImportSampler : NSObject
+{
+	NSString *filePath;
+	unsigned long long fileSize;
+	NSDate *fileModificationDate;
+
+	NSData *headData;
+	NSArray *sliceData;
+	BOOL sampleIsWholeFile;
+
+	dispatch_group_t profileGroup;
+	SPCSVColumnProfile *firstRowProfile;
+	SPCSVColumnProfile *remainingRowsProfile;
+}
+
+/**
+ * @property filePath The path of the sampled file
+ */
+@property (readonly, copy) NSString *filePath;
+
+/**
+ * @property headData The start of the file, decompressed
+ */
+@property (readonly, strong) NSData *headData;
+
+/**
+ * @property sampleIsWholeFile Whether the start of the file held all of it
+ */
+@property (readonly, assign) BOOL sampleIsWholeFile;
+
+- (instancetype)initWithPath:(NSString *)path;
+
+- (BOOL)readSample;
+- (BOOL)isSampleOfFileAtPath:(NSString *)path;
+
+- (NSArray *)rowsParsedWithSettingsOfParser:(SPCSVParser *)settingsParser encoding:(NSStringEncoding)encoding limit:(NSUInteger)rowLimit;
+- (SPCSVColumnProfile *)columnProfileIncludingFirstRow:(BOOL)includeFirstRow;
+
+@end
@@ -0,0 +1,293 @@
+//
+//  SPCSVImportSampler.m
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPCSVImportSampler.h"
+#import "SPCSVParser.h"
+#import "SPCSVColumnProfile.h"
+#import "SPFileHandle.h"
+#import <fcntl.h>
+#import <unistd.h>
+
+// How much of the start of the file is sampled
+static const NSUInteger SPCSVImportSampleHeadLength = 1024 * 1024;
+
+// The number and length of the slices sampled from further on in uncompressed files
+static const NSUInteger SPCSVImportSampleSliceCount = 8;
+static const NSUInteger SPCSVImportSampleSliceLength = 64 * 1024;
+
+@interface SPCSVImportSampler ()
+
+- (SPCSVParser *)_parserWithSettingsOfParser:(SPCSVParser *)settingsParser;
+- (void)_appendData:(NSData *)data toParser:(SPCSVParser *)parser encoding:(NSStringEncoding)encoding isComplete:(BOOL)isComplete;
+
+@end
+
+@implementation SPCSVImportSampler
+
+@synthesize filePath;
+@synthesize headData;
+@synthesize sampleIsWholeFile;
+
+/**
+ * Initialises a sampler for the file at the supplied path, without reading it yet.
+ */
+- (instancetype)initWithPath:(NSString *)path
+{
+	if ((self = [super init])) {
+		NSDictionary *attributes = [[NSFileManager defaultManager] attributesOfItemAtPath:path error:NULL];
+
+		filePath = [path copy];
+		fileSize = [[attributes objectForKey:NSFileSize] unsignedLongLongValue];
+		fileModificationDate = [attributes objectForKey:NSFileModificationDate];
+		sampleIsWholeFile = NO;
+	}
+
+	return self;
+}
+
+/**
+ * Reads the sample: the start of the file, decompressed if need be, and for uncompressed files
+ * larger than that, slices from evenly spaced stretches of the rest of the file.
+ *
+ * @return NO if the file couldn't be opened or read
+ */
+- (BOOL)readSample
+{
+	SPFileHandle *fileHandle = [SPFileHandle fileHandleForReadingAtPath:filePath];
+	NSMutableData *head = nil;
+
+	if (!fileHandle) return NO;
+
+	// Read a byte more than is kept, to tell whether the start is all there is
+	@try {
+		head = [fileHandle readDataOfLength:SPCSVImportSampleHeadLength + 1];
+	}
+	@catch (NSException *exception) {
+		[fileHandle closeFile];
+		return NO;
+	}
+
+	BOOL fileIsCompressed = ([fileHandle compressionFormat] != SPNoCompression);
+
+	[fileHandle closeFile];
+
+	sampleIsWholeFile = ([head length] <= SPCSVImportSampleHeadLength);
+
+	if (!sampleIsWholeFile) [head setLength:SPCSVImportSampleHeadLength];
+
+	headData = head;
+
+	// Compressed files can't be read from the middle without decompressing everything before it
+	NSMutableArray *slices = [NSMutableArray array];
+
+	if (!fileIsCompressed && fileSize > SPCSVImportSampleHeadLength + SPCSVImportSampleSliceCount * SPCSVImportSampleSliceLength) {
+		int fileDescriptor = open([filePath fileSystemRepresentation], O_RDONLY);
+
+		if (fileDescriptor >= 0) {
+			unsigned long long stretchLength = (fileSize - SPCSVImportSampleHeadLength) / SPCSVImportSampleSliceCount;
+
+			for (NSUInteger i = 0; i < SPCSVImportSampleSliceCount; i++)
+			{
+				off_t sliceOffset = (off_t)(SPCSVImportSampleHeadLength + i * stretchLength + arc4random_uniform((uint32_t)MIN(stretchLength - SPCSVImportSampleSliceLength, (unsigned long long)UINT32_MAX)));
+				NSMutableData *slice = [NSMutableData dataWithLength:SPCSVImportSampleSliceLength];
+				ssize_t readLength = pread(fileDescriptor, [slice mutableBytes], SPCSVImportSampleSliceLength, sliceOffset);
+
+				if (readLength <= 0) continue;
+
+				[slice setLength:(NSUInteger)readLength];
+				[slices addObject:slice];
+			}
+
+			close(fileDescriptor);
+		}
+	}
+
+	sliceData = slices;
+
+	return YES;
+}
+
+/**
+ * Returns whether the sample is of the file at the supplied path, as it is now.
+ */
+- (BOOL)isSampleOfFileAtPath:(NSString *)path
+{
+	if (!headData || ![filePath isEqualToString:path]) return NO;
+
+	NSDictionary *attributes = [[NSFileManager defaultManager] attributesOfItemAtPath:path error:NULL];
+
+	return fileSize == [[attributes objectForKey:NSFileSize] unsignedLongLongValue] && [fileModificationDate isEqual:[attributes objectForKey:NSFileModificationDate]];
+}
+
+/**
+ * Parses the start of the file with the CSV settings of the supplied parser, which is left as it
+ * is, and starts profiling the columns of the whole sample in the background.
+ *
+ * @param settingsParser The parser to take the field and line terminators, quote, escape and
+ *                       NULL settings from
+ * @param encoding       The encoding of the file
+ * @param rowLimit       The most rows to return
+ *
+ * @return The first rows of the file
+ */
+- (NSArray *)rowsParsedWithSettingsOfParser:(SPCSVParser *)settingsParser encoding:(NSStringEncoding)encoding limit:(NSUInteger)rowLimit
+{
+	// Let the profiling of any earlier parse finish before replacing it
+	if (profileGroup) dispatch_group_wait(profileGroup, DISPATCH_TIME_FOREVER);
+
+	SPCSVParser *headParser = [self _parserWithSettingsOfParser:settingsParser];
+	NSMutableArray *headRows = [NSMutableArray array];
+	NSData *head = headData;
+	NSArray *row;
+
+	if (encoding == NSUTF8StringEncoding && [head length] >= 3 && !memcmp([head bytes], "\xEF\xBB\xBF", 3)) {
+		head = [head subdataWithRange:NSMakeRange(3, [head length] - 3)];
+	}
+
+	[self _appendData:head toParser:headParser encoding:encoding isComplete:sampleIsWholeFile];
+
+	while ((row = [headParser getRowAsArrayAndTrimString:YES stringIsComplete:sampleIsWholeFile])) [headRows addObject:row];
+
+	// The slices are parsed while profiling, so set up their parsers while the settings are to hand
+	NSData *lineTerminatorData = [[settingsParser lineTerminatorString] dataUsingEncoding:encoding];
+	NSMutableArray *sliceParsers = [NSMutableArray array];
+
+	for (NSUInteger i = 0; i < [sliceData count]; i++) [sliceParsers addObject:[self _parserWithSettingsOfParser:settingsParser]];
+
+	NSArray *slices = sliceData;
+
+	firstRowProfile = nil;
+	remainingRowsProfile = nil;
+	profileGroup = dispatch_group_create();
+
+	dispatch_group_async(profileGroup, dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+		NSUInteger columnCount = [[headRows firstObject] count];
+		SPCSVColumnProfile *firstProfile = [[SPCSVColumnProfile alloc] initWithColumnCount:columnCount];
+		SPCSVColumnProfile *remainingProfile = [[SPCSVColumnProfile alloc] initWithColumnCount:columnCount];
+
+		if ([headRows count]) [firstProfile addRow:[headRows firstObject]];
+
+		for (NSUInteger i = 1; i < [headRows count]; i++) [remainingProfile addRow:[headRows objectAtIndex:i]];
+
+		for (NSUInteger i = 0; i < [slices count] && [lineTerminatorData length]; i++)
+		{
+			NSData *slice = [slices objectAtIndex:i];
+			SPCSVParser *sliceParser = [sliceParsers objectAtIndex:i];
+			NSRange firstLineEnd = [slice rangeOfData:lineTerminatorData options:0 range:NSMakeRange(0, [slice length])];
+			NSArray *sliceRow;
+
+			if (firstLineEnd.location == NSNotFound) continue;
+
+			[self _appendData:[slice subdataWithRange:NSMakeRange(NSMaxRange(firstLineEnd), [slice length] - NSMaxRange(firstLineEnd))] toParser:sliceParser encoding:encoding isComplete:NO];
+
+			while ((sliceRow = [sliceParser getRowAsArrayAndTrimString:YES stringIsComplete:NO]))
+			{
+				if ([sliceRow count] == columnCount) [remainingProfile addRow:sliceRow];
+			}
+		}
+
+		self->firstRowProfile = firstProfile;
+		self->remainingRowsProfile = remainingProfile;
+	});
+
+	if ([headRows count] > rowLimit) return [headRows subarrayWithRange:NSMakeRange(0, rowLimit)];
+
+	return headRows;
+}
+
+/**
+ * Returns the profile of the columns of the rows last parsed, waiting for the profiling to finish
+ * if need be, or nil if the sample hasn't been parsed.
+ *
+ * @param includeFirstRow Whether to include the first row, which may instead be a header
+ */
+- (SPCSVColumnProfile *)columnProfileIncludingFirstRow:(BOOL)includeFirstRow
+{
+	if (!profileGroup) return nil;
+
+	dispatch_group_wait(profileGroup, DISPATCH_TIME_FOREVER);
+
+	if (!includeFirstRow) return remainingRowsProfile;
+
+	SPCSVColumnProfile *profile = [[SPCSVColumnProfile alloc] initWithColumnCount:[firstRowProfile columnCount]];
+
+	[profile addProfile:firstRowProfile];
+	[profile addProfile:remainingRowsProfile];
+
+	return profile;
+}
+
+#pragma mark -
+#pragma mark Private API
+
+/**
+ * Returns a new parser with the CSV settings of the supplied parser.
+ */
+- (SPCSVParser *)_parserWithSettingsOfParser:(SPCSVParser *)settingsParser
+{
+	SPCSVParser *parser = [[SPCSVParser alloc] init];
+
+	[parser setFieldTerminatorString:[settingsParser fieldTerminatorString] convertDisplayStrings:NO];
+	[parser setLineTerminatorString:[settingsParser lineTerminatorString] convertDisplayStrings:NO];
+	[parser setFieldQuoteString:[settingsParser fieldQuoteString] convertDisplayStrings:NO];
+	[parser setEscapeString:[settingsParser escapeString] convertDisplayStrings:NO];
+	[parser setEscapeStringsAreMatchedStrictly:[settingsParser escapeStringsAreMatchedStrictly]];
+	[parser setNullReplacementString:[settingsParser nullReplacementString]];
+
+	return parser;
+}
+
+/**
+ * Hands sampled data to a parser. UTF-8 data is parsed as it is; other encodings are decoded
+ * first, up to the last line ending of data which isn't the end of the file so that a character
+ * cut in two at the end of the sample doesn't spoil the rest.
+ */
+- (void)_appendData:(NSData *)data toParser:(SPCSVParser *)parser encoding:(NSStringEncoding)encoding isComplete:(BOOL)isComplete
+{
+	if (encoding == NSUTF8StringEncoding) {
+		[parser appendData:data];
+		return;
+	}
+
+	NSUInteger decodeLength = [data length];
+
+	if (!isComplete) {
+		NSData *lineTerminatorData = [[parser lineTerminatorString] dataUsingEncoding:encoding];
+		NSRange lastLineEnd = [lineTerminatorData length] ? [data rangeOfData:lineTerminatorData options:NSDataSearchBackwards range:NSMakeRange(0, [data length])] : NSMakeRange(NSNotFound, 0);
+
+		decodeLength = (lastLineEnd.location == NSNotFound) ? 0 : NSMaxRange(lastLineEnd);
+	}
+
+	NSString *decodedString = [[NSString alloc] initWithBytes:[data bytes] length:decodeLength encoding:encoding];
+
+	if (decodedString) [parser appendString:decodedString];
+}
+
+@end
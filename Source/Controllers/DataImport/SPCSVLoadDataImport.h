@@ -0,0 +1,67 @@
+//
+//  SPCSVLoadDataImport.h
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import <SPMySQL/SPMySQL.h>
+
+@class SPFileHandle;
+
+/**
+ * @class SPCSVLoadDataImport SPCSVLoadDataImport.h
+ *
+ * Loads a CSV file into a table with LOAD DATA LOCAL INFILE, letting the server parse the rows rather
+ * than sending them as INSERT statements. The file is streamed to the server from an SPFileHandle, so
+ * compressed files are decompressed as they are sent, and whatever file the server asks for, the data
+ * only ever comes from that file handle.
+ *
+ * The import connection is used if it was made allowing local data; otherwise a copy of it is opened
+ * which does.
+ */
+@interface SPCSVLoadDataImport : NSObject <SPMySQLConnectionDelegate>
+{
+	SPMySQLConnection *connection;
+	SPMySQLConnection *loadConnection;
+	NSString *readErrorMessage;
+	BOOL localDataRejected;
+}
+
++ (NSString *)formatClauseWithFieldTerminator:(NSString *)fieldTerminator lineTerminator:(NSString *)lineTerminator fieldQuote:(NSString *)fieldQuote escape:(NSString *)escape;
++ (NSString *)quotedString:(NSString *)aString;
+
+- (instancetype)initWithConnection:(SPMySQLConnection *)aConnection;
+
+- (BOOL)loadFileHandle:(SPFileHandle *)fileHandle withQuery:(NSString *)query inDatabase:(NSString *)databaseName chunkHandler:(BOOL (^)(NSUInteger chunkLength, uint64_t readStart))chunkHandler;
+
+- (BOOL)localDataRejected;
+- (unsigned long long)rowsLoaded;
+- (NSString *)lastErrorMessage;
+- (NSArray *)warnings;
+- (void)close;
+
+@end
@@ -0,0 +1,320 @@
+//
+//  SPCSVLoadDataImport.m
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPCSVLoadDataImport.h"
+#import "SPFileHandle.h"
+#import "SPBoundedQueue.h"
+
+// The size of the reads from the file; the client library sends the data on in packets of its own size
+static const NSUInteger SPCSVLoadDataChunkLength = 256 * 1024;
+
+@interface SPCSVLoadDataImport ()
+
+- (SPMySQLConnection *)_connectedCopyOfConnection;
+
+@end
+
+@implementation SPCSVLoadDataImport
+
+#pragma mark -
+#pragma mark Query construction
+
+/**
+ * Returns the FIELDS and LINES clauses of a LOAD DATA query reading CSV as SPCSVParser would, or nil
+ * if the server can't read it that way; LOAD DATA only supports single character quotes and escapes.
+ *
+ * The server already reads doubled quotes within quoted fields as quotes, so an escape which is the
+ * field quote needs no ESCAPED BY of its own. Any other escape can't be used: the server also decodes
+ * sequences such as \n, \t and \N, which the parser keeps as they are. A field which is the word
+ * NULL unquoted is read as NULL as long as there is a field quote.
+ */
++ (NSString *)formatClauseWithFieldTerminator:(NSString *)fieldTerminator lineTerminator:(NSString *)lineTerminator fieldQuote:(NSString *)fieldQuote escape:(NSString *)escape
+{
+	if (![fieldTerminator length] || ![lineTerminator length]) return nil;
+	if ([fieldQuote length] > 1 || [escape length] > 1) return nil;
+
+	if ([escape length] && ![escape isEqualToString:fieldQuote]) return nil;
+
+	NSMutableString *formatClause = [NSMutableString stringWithFormat:@"FIELDS TERMINATED BY %@", [self quotedString:fieldTerminator]];
+
+	if ([fieldQuote length]) [formatClause appendFormat:@" OPTIONALLY ENCLOSED BY %@", [self quotedString:fieldQuote]];
+
+	[formatClause appendFormat:@" ESCAPED BY '' LINES TERMINATED BY %@", [self quotedString:lineTerminator]];
+
+	return formatClause;
+}
+
+/**
+ * Returns the string as a quoted SQL string literal, escaping the characters which can't appear in
+ * one as they are; unlike the connection's escaping this doesn't depend on the connection encoding,
+ * which suits the ASCII terminators of a LOAD DATA query.
+ */
++ (NSString *)quotedString:(NSString *)aString
+{
+	NSMutableString *quotedString = [NSMutableString stringWithCapacity:[aString length] + 2];
+	NSUInteger i;
+
+	[quotedString appendString:@"'"];
+
+	for (i = 0; i < [aString length]; i++)
+	{
+		unichar character = [aString characterAtIndex:i];
+
+		switch (character) {
+			case '\\': [quotedString appendString:@"\\\\"]; break;
+			case '\'': [quotedString appendString:@"\\'"]; break;
+			case '\n': [quotedString appendString:@"\\n"]; break;
+			case '\r': [quotedString appendString:@"\\r"]; break;
+			case '\t': [quotedString appendString:@"\\t"]; break;
+			case '\0': [quotedString appendString:@"\\0"]; break;
+			default: [quotedString appendFormat:@"%C", character];
+		}
+	}
+
+	[quotedString appendString:@"'"];
+
+	return quotedString;
+}
+
+#pragma mark -
+#pragma mark Initialisation
+
+/**
+ * Initialise a load for the supplied import connection, opening a copy of it if it wasn't made
+ * allowing local data.
+ *
+ * @param aConnection The import connection
+ *
+ * @return The initialised instance, or nil if no connection allowing local data could be opened, or
+ *         the server has local data disabled
+ */
+- (instancetype)initWithConnection:(SPMySQLConnection *)aConnection
+{
+	if ((self = [super init])) {
+		connection = aConnection;
+
+		if ([connection allowDataLocalInfile]) {
+			loadConnection = connection;
+		}
+		else {
+			loadConnection = [self _connectedCopyOfConnection];
+
+			if (!loadConnection) return nil;
+		}
+
+		// Check the server allows local data before any of the file is read
+		id localInfile = [loadConnection getFirstFieldFromQuery:@"SELECT @@local_infile"];
+
+		if ([loadConnection queryErrored] || ![localInfile respondsToSelector:@selector(integerValue)] || ![localInfile integerValue]) {
+			[self close];
+			return nil;
+		}
+	}
+
+	return self;
+}
+
+#pragma mark -
+#pragma mark Loading
+
+/**
+ * Runs the LOAD DATA LOCAL INFILE query, sending the remainder of the file handle as its data. A UTF-8
+ * byte order mark at the start of the data is skipped, as the server would otherwise load it as part
+ * of the first field.
+ *
+ * @param fileHandle   The file to load, read from its current position
+ * @param query        The LOAD DATA LOCAL INFILE query
+ * @param databaseName The database the query is run in
+ * @param chunkHandler Called on the current thread after each chunk of the file is read, with its
+ *                     length and when the read started; return NO to cancel the load
+ *
+ * @return Whether the data was loaded; -localDataRejected returns whether the server refused it
+ */
+- (BOOL)loadFileHandle:(SPFileHandle *)fileHandle withQuery:(NSString *)query inDatabase:(NSString *)databaseName chunkHandler:(BOOL (^)(NSUInteger chunkLength, uint64_t readStart))chunkHandler
+{
+	__block NSData *chunk = nil;
+	__block NSUInteger chunkOffset = 0;
+	__block BOOL atStart = YES;
+
+	readErrorMessage = nil;
+	localDataRejected = NO;
+
+	SPMySQLLocalDataReader reader = ^NSInteger(void *buffer, NSUInteger bufferLength) {
+		while (!chunk || chunkOffset == [chunk length])
+		{
+			uint64_t readStart = SPPipelineTimestamp();
+
+			@try {
+				chunk = [fileHandle readStreamedDataOfLength:SPCSVLoadDataChunkLength];
+			}
+			@catch (NSException *exception) {
+				self->readErrorMessage = [exception reason];
+				return -1;
+			}
+
+			chunkOffset = 0;
+
+			if (![chunk length]) return 0;
+
+			if (atStart) {
+				atStart = NO;
+				if ([chunk length] >= 3 && !memcmp([chunk bytes], "\xEF\xBB\xBF", 3)) chunkOffset = 3;
+			}
+
+			if (chunkHandler && !chunkHandler([chunk length], readStart)) return -1;
+		}
+
+		NSUInteger copyLength = MIN(bufferLength, [chunk length] - chunkOffset);
+
+		memcpy(buffer, (const uint8_t *)[chunk bytes] + chunkOffset, copyLength);
+		chunkOffset += copyLength;
+
+		return (NSInteger)copyLength;
+	};
+
+	if ([loadConnection queryLoadingLocalData:query usingEncoding:[loadConnection stringEncoding] fromReader:reader assertingDatabaseContext:databaseName]) return YES;
+
+	switch ([loadConnection lastErrorID]) {
+		case 1148: // ER_NOT_ALLOWED_COMMAND
+		case 2068: // CR_LOAD_DATA_LOCAL_INFILE_REJECTED
+		case 3948: // ER_CLIENT_LOCAL_FILES_DISABLED
+			localDataRejected = YES;
+			break;
+	}
+
+	return NO;
+}
+
+/**
+ * Returns whether the server refused the local data of the last load, in which case none of it was
+ * loaded and the rows can be imported some other way.
+ */
+- (BOOL)localDataRejected
+{
+	return localDataRejected;
+}
+
+/**
+ * Returns the number of rows the last load added or replaced.
+ */
+- (unsigned long long)rowsLoaded
+{
+	return [loadConnection rowsAffectedByLastQuery];
+}
+
+/**
+ * Returns why the last load failed.
+ */
+- (NSString *)lastErrorMessage
+{
+	if (readErrorMessage) return readErrorMessage;
+
+	return [loadConnection lastErrorMessage];
+}
+
+/**
+ * Returns the warnings left by the last load, which include the rows it couldn't load; with local
+ * data the server skips such rows rather than stopping.
+ */
+- (NSArray *)warnings
+{
+	NSMutableArray *warnings = [NSMutableArray array];
+	SPMySQLResult *result = [loadConnection queryString:@"SHOW WARNINGS"];
+	NSArray *row;
+
+	[result setReturnDataAsStrings:YES];
+
+	while ((row = [result getRowAsArray]))
+	{
+		if ([row count] < 3) continue;
+
+		[warnings addObject:[NSString stringWithFormat:@"%@ %@: %@", [row objectAtIndex:0], [row objectAtIndex:1], [row objectAtIndex:2]]];
+	}
+
+	return warnings;
+}
+
+/**
+ * Disconnects any copy of the import connection which was opened.
+ */
+- (void)close
+{
+	if (loadConnection && loadConnection != connection) [loadConnection disconnect];
+
+	loadConnection = nil;
+}
+
+#pragma mark -
+#pragma mark SPMySQLConnection delegate methods
+
+/**
+ * Forward keychain password requests for the copy of the connection to the import connection's delegate.
+ */
+- (NSString *)keychainPasswordForConnection:(id)aConnection
+{
+	NSObject <SPMySQLConnectionDelegate> *connectionDelegate = [connection delegate];
+
+	if (![connectionDelegate respondsToSelector:@selector(keychainPasswordForConnection:)]) return nil;
+
+	return [connectionDelegate keychainPasswordForConnection:connection];
+}
+
+/**
+ * The copy of the connection is never reconnected, as a load can't be resumed part way through.
+ */
+- (SPMySQLConnectionLostDecision)connectionLost:(id)aConnection
+{
+	return SPMySQLConnectionLostDisconnect;
+}
+
+#pragma mark -
+#pragma mark Private API
+
+/**
+ * Returns a new connection with the import connection's settings and character set, which allows
+ * local data.
+ */
+- (SPMySQLConnection *)_connectedCopyOfConnection
+{
+	SPMySQLConnection *copy = [connection copy];
+
+	[copy setDelegate:self];
+	[copy setDelegateQueryLogging:NO];
+	[copy setRetryQueriesOnConnectionFailure:NO];
+	[copy setAllowDataLocalInfile:YES];
+
+	if (![copy connect]) return nil;
+
+	[copy setEncoding:[connection encoding]];
+
+	return copy;
+}
+
+@end
@@ -0,0 +1,83 @@
+//
+//  SPCSVPreparedInsert.h
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+
+#import <SPMySQL/SPMySQL.h>
+
+/**
+ * @class SPCSVPreparedInsert SPCSVPreparedInsert.h
+ *
+ * Inserts batches of CSV rows with prepared multi-row INSERT statements, for imports which can't
+ * be left to LOAD DATA. Each batch's values are encoded into one buffer and bound to the statement's
+ * placeholders as they are, so there is no escaping and no query string to build for every batch;
+ * the server parses a statement once for each row count and reuses it.
+ *
+ * Rows are added a value at a time, in the column order of the INSERT, and then sent together.
+ */
+@interface SPCSVPreparedInsert : NSObject
+{
+	SPMySQLConnection *connection;
+	NSString *insertString;
+	NSString *tailString;
+	NSUInteger columnCount;
+	NSStringEncoding encoding;
+	NSUInteger maxRowsPerStatement;
+
+	NSMutableData *valueData;
+	NSUInteger *valueOffsets;
+	NSUInteger *valueLengths;
+	NSUInteger valueCount;
+	NSUInteger valueCapacity;
+
+	NSMutableDictionary *statementQueries;
+	NSMutableIndexSet *preparedRowCounts;
+}
+
+/**
+ * @property maxRowsPerStatement The most rows a statement can hold, given the limit on placeholders
+ */
+@property (readonly, assign) NSUInteger maxRowsPerStatement;
+
++ (NSString *)queryWithInsertString:(NSString *)anInsertString tailString:(NSString *)aTailString columnCount:(NSUInteger)aColumnCount rowCount:(NSUInteger)rowCount;
+
+- (instancetype)initWithConnection:(SPMySQLConnection *)aConnection insertString:(NSString *)anInsertString tailString:(NSString *)aTailString columnCount:(NSUInteger)aColumnCount;
+
+- (void)appendString:(NSString *)aString;
+- (void)appendNull;
+- (NSUInteger)rowCount;
+- (NSUInteger)executeLength;
+- (void)removeRowsFromIndex:(NSUInteger)rowIndex;
+- (void)removeAllRows;
+
+- (BOOL)prepareStatementForRowCount:(NSUInteger)rowCount inDatabase:(NSString *)databaseName;
+- (BOOL)executeInDatabase:(NSString *)databaseName;
+- (void)close;
+
+@end
@@ -0,0 +1,289 @@
+//
+//  SPCSVPreparedInsert.m
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+
+#import "SPCSVPreparedInsert.h"
+
+// The most placeholders the server accepts in one prepared statement
+static const NSUInteger SPCSVPreparedInsertMaxPlaceholders = 65535;
+
+// The bytes each value adds to the execute packet besides its own: its type, and its length
+static const NSUInteger SPCSVPreparedInsertValueOverhead = 11;
+
+@interface SPCSVPreparedInsert ()
+
+- (void)_reserveValues:(NSUInteger)count;
+- (NSString *)_queryForRowCount:(NSUInteger)rowCount;
+
+@end
+
+@implementation SPCSVPreparedInsert
+
+@synthesize maxRowsPerStatement;
+
+/**
+ * Returns the INSERT for a number of rows: the insert string, which ends with the VALUES keyword,
+ * a group of placeholders for each row, and the tail string, if any.
+ */
++ (NSString *)queryWithInsertString:(NSString *)anInsertString tailString:(NSString *)aTailString columnCount:(NSUInteger)aColumnCount rowCount:(NSUInteger)rowCount
+{
+	NSMutableString *rowPlaceholders = [NSMutableString stringWithCapacity:aColumnCount * 2 + 1];
+
+	[rowPlaceholders appendString:@"("];
+
+	for (NSUInteger i = 0; i < aColumnCount; i++) {
+		[rowPlaceholders appendString:i ? @",?" : @"?"];
+	}
+
+	[rowPlaceholders appendString:@")"];
+
+	NSMutableString *query = [NSMutableString stringWithCapacity:[anInsertString length] + rowCount * ([rowPlaceholders length] + 2) + [aTailString length] + 1];
+
+	[query appendString:anInsertString];
+
+	for (NSUInteger i = 0; i < rowCount; i++) {
+		if (i) [query appendString:@",\n"];
+		[query appendString:rowPlaceholders];
+	}
+
+	if ([aTailString length]) [query appendFormat:@" %@", aTailString];
+
+	return query;
+}
+
+/**
+ * Initialise an insert of rows of the supplied number of columns through the connection, using
+ * the connection's current encoding.
+ *
+ * @param anInsertString The start of the INSERT, up to and including the VALUES keyword
+ * @param aTailString    Anything to follow the rows, such as an ON DUPLICATE KEY UPDATE clause
+ */
+- (instancetype)initWithConnection:(SPMySQLConnection *)aConnection insertString:(NSString *)anInsertString tailString:(NSString *)aTailString columnCount:(NSUInteger)aColumnCount
+{
+	if ((self = [super init])) {
+		connection = aConnection;
+		insertString = [anInsertString copy];
+		tailString = [aTailString copy];
+		columnCount = MAX(aColumnCount, 1);
+		encoding = [aConnection stringEncoding];
+		maxRowsPerStatement = MAX(SPCSVPreparedInsertMaxPlaceholders / columnCount, 1);
+
+		valueData = [[NSMutableData alloc] init];
+		valueOffsets = NULL;
+		valueLengths = NULL;
+		valueCount = 0;
+		valueCapacity = 0;
+
+		statementQueries = [[NSMutableDictionary alloc] init];
+		preparedRowCounts = [[NSMutableIndexSet alloc] init];
+	}
+
+	return self;
+}
+
+#pragma mark -
+#pragma mark Rows
+
+/**
+ * Adds a value to the current row, encoded as it is, without escaping or quoting.
+ */
+- (void)appendString:(NSString *)aString
+{
+	NSUInteger offset = [valueData length];
+	NSUInteger usedLength = 0;
+	NSUInteger maxLength = [aString maximumLengthOfBytesUsingEncoding:encoding];
+
+	[self _reserveValues:1];
+
+	[valueData setLength:offset + maxLength];
+	[aString getBytes:(char *)[valueData mutableBytes] + offset maxLength:maxLength usedLength:&usedLength encoding:encoding options:NSStringEncodingConversionAllowLossy range:NSMakeRange(0, [aString length]) remainingRange:NULL];
+	[valueData setLength:offset + usedLength];
+
+	valueOffsets[valueCount] = offset;
+	valueLengths[valueCount] = usedLength;
+	valueCount++;
+}
+
+/**
+ * Adds a NULL to the current row.
+ */
+- (void)appendNull
+{
+	[self _reserveValues:1];
+
+	valueOffsets[valueCount] = NSNotFound;
+	valueLengths[valueCount] = 0;
+	valueCount++;
+}
+
+/**
+ * Returns the number of complete rows added.
+ */
+- (NSUInteger)rowCount
+{
+	return valueCount / columnCount;
+}
+
+/**
+ * Returns roughly how long the packet sending the rows added will be, to compare against the
+ * connection's maximum query size.
+ */
+- (NSUInteger)executeLength
+{
+	return [valueData length] + valueCount * SPCSVPreparedInsertValueOverhead + valueCount / 8 + 16;
+}
+
+/**
+ * Removes the rows from the supplied index onwards, such as a row which took a batch over length.
+ */
+- (void)removeRowsFromIndex:(NSUInteger)rowIndex
+{
+	NSUInteger firstValue = rowIndex * columnCount;
+
+	if (firstValue >= valueCount) return;
+
+	// Values are laid out in order, so the first value removed which isn't NULL marks the end of the rest
+	for (NSUInteger i = firstValue; i < valueCount; i++) {
+		if (valueOffsets[i] != NSNotFound) {
+			[valueData setLength:valueOffsets[i]];
+			break;
+		}
+	}
+
+	valueCount = firstValue;
+}
+
+/**
+ * Removes all the rows added, ready for the next batch.
+ */
+- (void)removeAllRows
+{
+	[valueData setLength:0];
+	valueCount = 0;
+}
+
+#pragma mark -
+#pragma mark Statements
+
+/**
+ * Prepares the statement for a number of rows, if it hasn't been already. If it can't be prepared,
+ * for example because the server can't prepare statements, the connection's last error says why.
+ */
+- (BOOL)prepareStatementForRowCount:(NSUInteger)rowCount inDatabase:(NSString *)databaseName
+{
+	if ([preparedRowCounts containsIndex:rowCount]) return YES;
+
+	if (![connection prepareStatement:[self _queryForRowCount:rowCount] usingEncoding:encoding assertingDatabaseContext:databaseName]) return NO;
+
+	[preparedRowCounts addIndex:rowCount];
+
+	return YES;
+}
+
+/**
+ * Runs the statement for the rows added, with their values. Returns whether it succeeded; the
+ * connection's last error and rows affected describe the outcome as for any query.
+ */
+- (BOOL)executeInDatabase:(NSString *)databaseName
+{
+	NSUInteger rowCount = [self rowCount];
+	NSUInteger boundCount = rowCount * columnCount;
+
+	if (!rowCount) return YES;
+
+	// Empty values still need a pointer, as a NULL one is sent as SQL NULL
+	const char *valueBytes = [valueData length] ? [valueData bytes] : "";
+	SPMySQLBoundValue *values = malloc(boundCount * sizeof(SPMySQLBoundValue));
+
+	for (NSUInteger i = 0; i < boundCount; i++) {
+		values[i].bytes = (valueOffsets[i] == NSNotFound) ? NULL : valueBytes + valueOffsets[i];
+		values[i].length = valueLengths[i];
+	}
+
+	BOOL succeeded = [connection queryPreparedStatement:[self _queryForRowCount:rowCount] withValues:values count:boundCount usingEncoding:encoding assertingDatabaseContext:databaseName];
+
+	free(values);
+
+	return succeeded;
+}
+
+/**
+ * Frees the statements this insert prepared on the server, leaving any others prepared on the
+ * connection; the insert can't be used afterwards.
+ */
+- (void)close
+{
+	[preparedRowCounts enumerateIndexesUsingBlock:^(NSUInteger rowCount, BOOL *stop) {
+		[self->connection closePreparedStatement:[self _queryForRowCount:rowCount]];
+	}];
+
+	[preparedRowCounts removeAllIndexes];
+	[self removeAllRows];
+}
+
+#pragma mark -
+#pragma mark Private API
+
+/**
+ * Makes room for more values in the value arrays.
+ */
+- (void)_reserveValues:(NSUInteger)count
+{
+	if (valueCount + count <= valueCapacity) return;
+
+	valueCapacity = MAX(valueCapacity * 2, MAX(valueCount + count, columnCount * 64));
+	valueOffsets = realloc(valueOffsets, valueCapacity * sizeof(NSUInteger));
+	valueLengths = realloc(valueLengths, valueCapacity * sizeof(NSUInteger));
+}
+
+/**
+ * Returns the query for a number of rows, building it only the first time.
+ */
+- (NSString *)_queryForRowCount:(NSUInteger)rowCount
+{
+	NSString *query = [statementQueries objectForKey:@(rowCount)];
+
+	if (!query) {
+		query = [[self class] queryWithInsertString:insertString tailString:tailString columnCount:columnCount rowCount:rowCount];
+		[statementQueries setObject:query forKey:@(rowCount)];
+	}
+
+	return query;
+}
+
+#pragma mark -
+
+- (void)dealloc
+{
+	free(valueOffsets);
+	free(valueLengths);
+}
+
+@end
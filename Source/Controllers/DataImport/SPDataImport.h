@@ -37,6 +37,12 @@
 @class SPTableData;
 @class SPTableStructure;
 @class SPTablesList;
+@class SPTransferStatistics;
+@class SPImportBatchSizer;
+@class SPImportBulkLoadSession;
+@class SPImportCheckpoint;
+@class SPCSVImportSampler;
+@class SPCSVPreparedInsert;
 
 typedef enum {
 	SPFieldMapperInProgress = 1,
@@ -78,6 +84,7 @@ typedef enum {
 	IBOutlet NSProgressIndicator *singleProgressBar;
 	IBOutlet NSTextField *singleProgressTitle;
 	IBOutlet NSTextField *singleProgressText;
+	IBOutlet NSTextField *singleProgressStatisticsText;
 
 	SPMySQLConnection *mySQLConnection;
 
@@ -107,6 +114,16 @@ typedef enum {
 	BOOL progressCancelled;
 	BOOL mainNibLoaded;
 
+	SPTransferStatistics *importStatistics;
+	NSUInteger importStatisticsReadLength;
+	CFAbsoluteTime importStatisticsUpdateTime;
+	SPImportBatchSizer *csvBatchSizer;
+	SPImportBulkLoadSession *bulkLoadSession;
+	SPImportCheckpoint *importCheckpoint;
+	BOOL importCheckpointWriteFailed;
+	SPCSVImportSampler *csvImportSampler;
+	SPCSVPreparedInsert *csvPreparedInsert;
+
 	NSMutableArray *geometryFields;
 	NSMutableIndexSet *geometryFieldsMapIndex;
 	NSMutableArray *bitFields;
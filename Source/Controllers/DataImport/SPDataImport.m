@@ -35,7 +35,14 @@
 #import "SPTableStructure.h"
 #import "SPDatabaseStructure.h"
 #import "SPCustomQuery.h"
-#import "SPSQLParser.h"
+#import "SPSQLStatementReader.h"
+#import "SPSQLParallelRestore.h"
+#import "SPCSVLoadDataImport.h"
+#import "SPImportBatchSizer.h"
+#import "SPImportBulkLoadSession.h"
+#import "SPImportCheckpoint.h"
+#import "SPCSVImportSampler.h"
+#import "SPCSVPreparedInsert.h"
 #import "SPCSVParser.h"
 #import "SPTableData.h"
 #import "RegexKitLite.h"
@@ -46,6 +53,8 @@
 #import "SPFunctions.h"
 #import "SPQueryController.h"
 #import "SPConstants.h"
+#import "SPTransferStatistics.h"
+#import "SPBoundedQueue.h"
 
 #import <SPMySQL/SPMySQL.h>
 
@@ -53,12 +62,47 @@
 
 #define SP_FILE_READ_ERROR_STRING NSLocalizedString(@"File read error", @"File read error title (Import Dialog)")
 
+// The most SQL statements sent to the server in a single multi-statement query
+static const NSUInteger SPImportMaxBatchStatements = 1000;
+
+// The time each multi-row INSERT of a CSV import should take on the server
+static const uint64_t SPCSVImportBatchTargetNanoseconds = 250 * NSEC_PER_MSEC;
+
+// How much of a CSV file to read at a time when parsing on several threads, so each pass has
+// enough to split between them
+static const NSUInteger SPCSVImportParallelReadLength = 32 * 1024 * 1024;
+
+// The rows of a CSV file shown in the field mapper, and how much of the file to read at a time
+// until the field mapping is known, so the field mapper opens without waiting for a large read
+static const NSUInteger SPCSVImportPreviewRowCount = 100;
+static const NSUInteger SPCSVImportMappingReadLength = 256 * 1024;
+
+// The rows a fast bulk load imports normally first, to measure what it gains
+static const NSUInteger SPImportBulkLoadCalibrationRows = 5000;
+
 @interface SPDataImport ()
 
 - (void)_startBackgroundImportTaskForFilename:(NSString *)filename;
 - (void)_importBackgroundProcess:(NSDictionary *)userInfo;
 - (void)_closeAndStopProgressSheet;
 - (NSString *)_getLineEndingForFile:(NSString *)filePath;
+- (void)_beginImportStatistics;
+- (void)_recordImportReadOfLength:(NSUInteger)length fromFileHandle:(SPFileHandle *)fileHandle startedAt:(uint64_t)start;
+- (void)_recordImportQuery:(NSString *)query encoding:(NSStringEncoding)encoding startedAt:(uint64_t)start;
+- (void)_recordImportStatementOfLength:(NSUInteger)length startedAt:(uint64_t)start;
+- (void)_handleSQLImportError:(NSString *)errorMessage errorID:(NSUInteger)errorID inQuery:(NSString *)query sequenceNumber:(NSUInteger)sequenceNumber errors:(NSMutableString *)errors ignoringSQLErrors:(BOOL *)ignoreSQLErrors ignoringCharsetError:(BOOL *)ignoreCharsetError;
+- (void)_updateSQLImportProgressForStatement:(SPSQLImportStatement *)sqlStatement fileIsCompressed:(BOOL)fileIsCompressed fileTotalLength:(NSUInteger)fileTotalLength;
+- (void)_abortCSVImportOfFile:(NSString *)filename withEncodingError:(NSStringEncoding)csvEncoding rowsImported:(NSInteger)rowsImported;
+- (NSString *)_loadDataQueryForCSVFile:(NSString *)filename parser:(SPCSVParser *)csvParser encoding:(NSStringEncoding)csvEncoding sample:(NSData *)csvSampleData;
+- (BOOL)_loadCSVFile:(NSString *)filename withQuery:(NSString *)loadDataQuery databaseName:(NSString *)databaseName fileTotalLength:(NSUInteger)fileTotalLength errors:(NSMutableString *)errors rowsImported:(NSInteger *)rowsImported;
+- (SPCSVPreparedInsert *)_preparedInsertWithInsertString:(NSString *)insertString;
+- (void)_appendMappedRow:(NSArray *)csvRowArray toPreparedInsert:(SPCSVPreparedInsert *)preparedInsert;
+- (void)_updateImportStatisticsText;
+- (void)_finishImportStatisticsForFile:(NSString *)filename;
+- (void)_beginBulkLoadSessionCalibrating:(BOOL)calibrate;
+- (NSString *)_endImportSessionWithErrors:(NSMutableString *)errors completed:(BOOL)completed;
+- (BOOL)_offerToResumeImportOfFile:(NSString *)filename format:(NSString *)format;
+- (void)_writeImportCheckpointImmediately:(BOOL)immediately errors:(NSMutableString *)errors;
 
 @property (readwrite, strong) NSFileManager *fileManager;
 
@@ -337,18 +381,16 @@
 /**
  * Streaming data processing method to import a supplied SQL file.
  *
- * The file is read in chunk by chunk; each chunk is then checked
- * for line endings, which are used to split the data into parts
- * which can be parsed to NSStrings in the appropriate encoding.
- *
- * The NSStrings are then fed to a SQL parser, which splits them
- * into statements ready to be executed.
+ * The file is read, decompressed and split into statements on
+ * background threads by a SPSQLStatementReader, while this thread
+ * executes the statements in order, keeping the connection busy.
+ * Progress and errors are reported against each statement's
+ * position in the file.
  */
 - (void)importSQLFile:(NSString *)filename
 {
 	SPLog(@"Starting import....");
 	
-//	TODO: this is slowwwwwwww
 #ifdef DEBUG
 	NSDate *startDate;
 	NSDate *endDate;
@@ -357,27 +399,25 @@
 #endif
 
 	SPFileHandle *sqlFileHandle;
-	NSMutableData *sqlDataBuffer;
-	const unsigned char *sqlDataBufferBytes;
-	NSData *fileChunk;
-	NSString *sqlString;
-	SPSQLParser *sqlParser;
+	SPSQLStatementReader *sqlReader;
+	SPSQLImportStatement *sqlStatement;
 	NSString *query;
 	NSMutableString *errors = [NSMutableString string];
-	NSInteger fileChunkMaxLength = 1024 * 1024;
 	NSUInteger fileTotalLength = 0;
-	NSUInteger fileProcessedLength = 0;
 	NSInteger queriesPerformed = 0;
-	NSInteger dataBufferLength = 0;
-	NSInteger dataBufferPosition = 0;
-	NSInteger dataBufferLastQueryEndPosition = 0;
 	BOOL fileIsCompressed;
-	BOOL allDataRead = NO;
 	BOOL ignoreSQLErrors = ([[importSQLErrorHandlingPopup onMainThread] selectedTag] == SPSQLImportIgnoreErrors);
 	BOOL ignoreCharsetError = NO;
 	NSStringEncoding sqlEncoding = NSUTF8StringEncoding;
 	NSString *connectionEncodingToRestore = nil;
-	NSCharacterSet *whitespaceAndNewlineCharset = [NSCharacterSet whitespaceAndNewlineCharacterSet];
+	BOOL batchStatements = [prefs boolForKey:SPImportBatchStatements];
+	NSMutableArray *readAheadStatements = [NSMutableArray array];
+	NSMutableArray *batchedRowCounts = [NSMutableArray array];
+	NSString *batchErrorMessage = nil;
+	NSUInteger batchErrorID = 0;
+	BOOL batchStoppedAtStatement = NO;
+	BOOL runNextStatementAlone = NO;
+	SPSQLParallelRestore *parallelRestore = nil;
 
 	// Open a filehandle for the SQL file
 	sqlFileHandle = [SPFileHandle fileHandleForReadingAtPath:filename];
@@ -393,6 +433,10 @@
 	fileTotalLength = (NSUInteger)[[[fileManager attributesOfItemAtPath:filename error:NULL] objectForKey:NSFileSize] longLongValue];
 	if (!fileTotalLength) fileTotalLength = 1;
 
+	// Offer to carry on from where an earlier import of the file stopped
+	BOOL resumingImport = [self _offerToResumeImportOfFile:filename format:@"SQL"];
+	BOOL useParallelRestore = [prefs boolForKey:SPImportParallelRestore] && !resumingImport;
+
 	SPMainQSync(^{
 		// Reset progress interface
 		[self->errorsView setString:@""];
@@ -407,6 +451,8 @@
 		[[self->tableDocumentInstance parentWindowControllerWindow] beginSheet:self->singleProgressSheet completionHandler:nil];
 	});
 
+	[self _beginImportStatistics];
+
 	[tableDocumentInstance setQueryMode:SPImportExportQueryMode];
 	NSString *databaseName = [tableDocumentInstance database];
 	BOOL databaseNamesAreCaseSensitive = NO;
@@ -429,6 +475,15 @@
 		sqlEncoding = [importEncodingPopup selectedTag];
 	}
 
+	// A resumed import reads the file as it was read before.  Otherwise keep a checkpoint to resume
+	// from, where statements are split from the file's own bytes and all run on this connection
+	if (resumingImport) {
+		sqlEncoding = [importCheckpoint encoding];
+	}
+	else if ([prefs boolForKey:SPImportCheckpoints] && SPSQLEncodingCanBeSplitAsBytes(sqlEncoding) && !useParallelRestore && ![filename hasPrefix:SPImportClipboardTempFileNamePrefix]) {
+		importCheckpoint = [[SPImportCheckpoint alloc] initWithImportFilePath:filename format:@"SQL" encoding:sqlEncoding];
+	}
+
 	//store the sqlMode to restore, if the import changes it
 	NSString *sqlModeToRestore = nil;
 	{
@@ -439,287 +494,371 @@
 		sqlModeToRestore = [[res getRowAsArray] objectAtIndex:0];
 	}
 
+	// Switch to fast bulk loading if selected; the parallel restore loads on other connections, so
+	// is given the same settings from the start rather than measured against a normal import
+	[self _beginBulkLoadSessionCalibrating:!useParallelRestore];
+
+	// Make the session settings the skipped statements made, and move past them in the file
+	if (resumingImport) {
+		[[singleProgressText onMainThread] setStringValue:NSLocalizedString(@"Skipping to where the import stopped...", @"text showing that the app is skipping the part of a file already imported")];
+
+		for (NSString *sessionStatement in [importCheckpoint sessionStatements])
+		{
+			[mySQLConnection queryString:sessionStatement];
+		}
+
+		if ([importCheckpoint databaseName] && [mySQLConnection selectDatabase:[importCheckpoint databaseName]]) {
+			databaseName = [importCheckpoint databaseName];
+		}
+
+		if (![sqlFileHandle skipDataOfLength:[importCheckpoint offset]]) {
+			[self _endImportSessionWithErrors:nil completed:NO];
+			if (connectionEncodingToRestore) {
+				[mySQLConnection queryString:[NSString stringWithFormat:@"SET NAMES '%@'", connectionEncodingToRestore]];
+			}
+			if (sqlModeToRestore) {
+				[mySQLConnection queryString:[NSString stringWithFormat:@"SET SQL_MODE=%@", [sqlModeToRestore tickQuotedString]]];
+			}
+			[self _finishImportStatisticsForFile:filename];
+			[self _closeAndStopProgressSheet];
+			[NSAlert createWarningAlertWithTitle:SP_FILE_READ_ERROR_STRING message:NSLocalizedString(@"The file ends before the point the earlier import stopped at, so the import can't be resumed.", @"SQL import resume error where the file is shorter than the checkpoint") callback:nil];
+			[tableDocumentInstance setQueryMode:SPInterfaceQueryMode];
+			return;
+		}
+	}
+
 	SPMySQLServerStatusBits serverStatus;
 	// initialize
 	serverStatus.noBackslashEscapes = 0; // for the moment we only care about that flag
 
-	// Read in the file in a loop
-	sqlParser = [[SPSQLParser alloc] init];
-	[sqlParser setDelimiterSupport:YES];
+	// Read and split the file on background threads while the statements are run here in order
 	[mySQLConnection updateServerStatusBits:&serverStatus];
-	[sqlParser setNoBackslashEscapes:serverStatus.noBackslashEscapes];
-	sqlDataBuffer = [[NSMutableData alloc] init];
+	if (resumingImport) {
+		sqlReader = [[SPSQLStatementReader alloc] initWithFileHandle:sqlFileHandle encoding:sqlEncoding noBackslashEscapes:serverStatus.noBackslashEscapes statistics:importStatistics resumingAtOffset:(NSUInteger)[importCheckpoint offset] afterStatement:[importCheckpoint position] delimiter:[importCheckpoint delimiter]];
+	}
+	else {
+		sqlReader = [[SPSQLStatementReader alloc] initWithFileHandle:sqlFileHandle encoding:sqlEncoding noBackslashEscapes:serverStatus.noBackslashEscapes statistics:importStatistics];
+	}
+
+	// Optionally load the dump's table data over several connections at once; if no further
+	// connection can be opened the import simply runs on its own
+	if (useParallelRestore) {
+		parallelRestore = [[SPSQLParallelRestore alloc] initWithConnection:mySQLConnection encoding:sqlEncoding maxConnections:[prefs integerForKey:SPImportParallelRestoreConnections] batchStatements:batchStatements statistics:importStatistics];
+
+		if (connectionEncodingToRestore) {
+			[parallelRestore addSessionStatement:[NSString stringWithFormat:@"SET NAMES '%@'", [SPMySQLConnection mySQLCharsetForStringEncoding:sqlEncoding]]];
+		}
+
+		for (NSString *sessionStatement in [bulkLoadSession sessionStatements])
+		{
+			[parallelRestore addSessionStatement:sessionStatement];
+		}
+	}
+
 	while (1) {
         @autoreleasepool {
 
-            if (progressCancelled) break;
-
-            @try {
-                fileChunk = [sqlFileHandle readDataOfLength:fileChunkMaxLength];
+            // Statements read ahead while filling a batch come before any still to be read
+            if ([readAheadStatements count]) {
+                sqlStatement = [readAheadStatements objectAtIndex:0];
+                [readAheadStatements removeObjectAtIndex:0];
             }
-            // Report file read errors, and bail
-            @catch (NSException *exception) {
-                if (connectionEncodingToRestore) {
-                    [mySQLConnection queryString:[NSString stringWithFormat:@"SET NAMES '%@'", connectionEncodingToRestore]];
-                }
-                if (sqlModeToRestore) {
-                    [mySQLConnection queryString:[NSString stringWithFormat:@"SET SQL_MODE=%@", [sqlModeToRestore tickQuotedString]]];
-                }
+            else {
+                sqlStatement = [sqlReader nextStatement];
+            }
+
+            if (!sqlStatement || progressCancelled) break;
+
+            // Before running the statement, check that we actually have a connection.
+            // If not, check the connection if appropriate and then clean up and exit if appropriate.
+            if (![mySQLConnection isConnected] && ([mySQLConnection userTriggeredDisconnect] || ![mySQLConnection checkConnection])) {
+                if ([filename hasPrefix:SPImportClipboardTempFileNamePrefix]) [fileManager removeItemAtPath:filename error:nil];
 
+                [sqlReader cancel];
+                [parallelRestore cancel];
+                [parallelRestore finish];
+                [self _endImportSessionWithErrors:errors completed:NO];
                 [self _closeAndStopProgressSheet];
+                [errors appendString:NSLocalizedString(@"The connection to the server was lost during the import.  The import is only partially complete.", @"Connection lost during import error message")];
+                [self showErrorSheetWithMessage:errors];
 
-                [NSAlert createWarningAlertWithTitle:SP_FILE_READ_ERROR_STRING message:[NSString stringWithFormat:NSLocalizedString(@"An error occurred when reading the file.\n\nOnly %ld queries were executed.\n\n(%@)", @"SQL read error, including detail from system"), (long)queriesPerformed, [exception reason]] callback:nil];
-                [tableDocumentInstance setQueryMode:SPInterfaceQueryMode];
-                if([filename hasPrefix:SPImportClipboardTempFileNamePrefix]) [fileManager removeItemAtPath:filename error:nil];
                 return;
             }
 
-            // If no data returned, end of file - set a marker to ensure full processing
-            if (!fileChunk || ![fileChunk length]) {
-                allDataRead = YES;
+            query = [sqlStatement query];
 
-                // Otherwise add the data to the read/parse buffer
-            } else {
-                [sqlDataBuffer appendData:fileChunk];
-            }
+            // Table data sections are handed to the parallel restore, which also holds back anything
+            // else until the data it could depend on has loaded
+            if (parallelRestore && ![batchedRowCounts count] && !batchStoppedAtStatement) {
+                BOOL statementTaken = [parallelRestore takeStatement:sqlStatement inDatabase:databaseName];
 
-            // Step through the data buffer, identifying line endings to parse the data with
-            sqlDataBufferBytes = [sqlDataBuffer bytes];
-            dataBufferLength = [sqlDataBuffer length];
-            for ( ; dataBufferPosition < dataBufferLength || allDataRead; dataBufferPosition++) {
-                if (sqlDataBufferBytes[dataBufferPosition] == 0x0A || sqlDataBufferBytes[dataBufferPosition] == 0x0D || allDataRead) {
+                for (NSDictionary *failure in [parallelRestore takeFailures])
+                {
+                    if (progressCancelled) break;
 
-                    // Keep reading through any other line endings
-                    while (dataBufferPosition + 1 < dataBufferLength
-                           && (sqlDataBufferBytes[dataBufferPosition+1] == 0x0A
-                               || sqlDataBufferBytes[dataBufferPosition+1] == 0x0D))
-                    {
-                        dataBufferPosition++;
-                    }
-
-                    // Try to generate a NSString with the resulting data
-                    sqlString = [[NSString alloc] initWithData:[sqlDataBuffer subdataWithRange:NSMakeRange(dataBufferLastQueryEndPosition, dataBufferPosition - dataBufferLastQueryEndPosition)]
-                                                      encoding:sqlEncoding];
-                    if (!sqlString) {
-                        if (connectionEncodingToRestore) {
-                            [mySQLConnection queryString:[NSString stringWithFormat:@"SET NAMES '%@'", connectionEncodingToRestore]];
-                        }
-                        if (sqlModeToRestore) {
-                            [mySQLConnection queryString:[NSString stringWithFormat:@"SET SQL_MODE=%@", [sqlModeToRestore tickQuotedString]]];
-                        }
-
-                        [self _closeAndStopProgressSheet];
+                    [self _handleSQLImportError:[failure objectForKey:@"errorMessage"] errorID:[[failure objectForKey:@"errorID"] unsignedIntegerValue] inQuery:[failure objectForKey:@"query"] sequenceNumber:[[failure objectForKey:@"sequenceNumber"] unsignedIntegerValue] errors:errors ignoringSQLErrors:&ignoreSQLErrors ignoringCharsetError:&ignoreCharsetError];
+                }
 
-                        NSString *displayEncoding;
+                if ([parallelRestore connectionLost] && !progressCancelled) {
+                    [errors appendString:NSLocalizedString(@"The connection to the server was lost during the import.  The import is only partially complete.", @"Connection lost during import error message")];
+                    progressCancelled = YES;
+                }
 
-                        if (![[importEncodingPopup onMainThread] indexOfSelectedItem]) {
-                            displayEncoding = [NSString stringWithFormat:@"%@ - %@", [[importEncodingPopup onMainThread] titleOfSelectedItem], [NSString localizedNameOfStringEncoding:sqlEncoding]];
-                        } else {
-                            displayEncoding = [NSString localizedNameOfStringEncoding:sqlEncoding];
-                        }
-                        [NSAlert createWarningAlertWithTitle:SP_FILE_READ_ERROR_STRING message:[NSString stringWithFormat:NSLocalizedString(@"An error occurred when reading the file, as it could not be read in the encoding you selected (%@).\n\nOnly %ld queries were executed.", @"SQL encoding read error"), displayEncoding, (long)queriesPerformed] callback:nil];
-                        [tableDocumentInstance setQueryMode:SPInterfaceQueryMode];
-                        if([filename hasPrefix:SPImportClipboardTempFileNamePrefix]) [fileManager removeItemAtPath:filename error:nil];
-                        return;
-                    }
+                if (progressCancelled) break;
 
-                    // Add the NSString segment to the SQL parser and release it
-                    [sqlParser appendString:sqlString];
+                if (statementTaken) {
+                    queriesPerformed++;
 
-                    if (allDataRead) break;
+                    [self _updateSQLImportProgressForStatement:sqlStatement fileIsCompressed:fileIsCompressed fileTotalLength:fileTotalLength];
 
-                    // Increment the query end position marker
-                    dataBufferLastQueryEndPosition = dataBufferPosition;
+                    continue;
                 }
             }
 
-            // Trim the data buffer if part of it was used
-            if (dataBufferLastQueryEndPosition) {
-                [sqlDataBuffer setData:[sqlDataBuffer subdataWithRange:NSMakeRange(dataBufferLastQueryEndPosition, dataBufferLength - dataBufferLastQueryEndPosition)]];
-                dataBufferPosition -= dataBufferLastQueryEndPosition;
-                dataBufferLastQueryEndPosition = 0;
+            // Only a case-only DROP comparison needs lower_case_table_names.
+            // Query it before that DROP so the DROP remains the most recent
+            // statement for any following diagnostic query in the import.
+            if (!databaseNameCaseSensitivityWasLoaded
+                && [SASQLDatabaseContext requiresDatabaseNameCaseSensitivityLookupForQuery:query
+                                                                         currentDatabase:databaseName
+                                                                            serverVersion:serverVersion
+                                                                          serverIsMariaDB:serverIsMariaDB]) {
+                id lowerCaseTableNames = [mySQLConnection getFirstFieldFromQuery:@"SELECT @@lower_case_table_names" assertingDatabase:databaseName];
+                // If the setting cannot be read, prefer clearing a case-only match over retaining a stale assertion.
+                databaseNamesAreCaseSensitive = [lowerCaseTableNames respondsToSelector:@selector(integerValue)] && [lowerCaseTableNames integerValue] == 0;
+                databaseNameCaseSensitivityWasLoaded = YES;
             }
 
-            // Before entering the following loop, check that we actually have a connection.
-            // If not, check the connection if appropriate and then clean up and exit if appropriate.
-            if (![mySQLConnection isConnected] && ([mySQLConnection userTriggeredDisconnect] || ![mySQLConnection checkConnection])) {
-                if ([filename hasPrefix:SPImportClipboardTempFileNamePrefix]) [fileManager removeItemAtPath:filename error:nil];
+            BOOL queryErrored = NO;
+            BOOL queryFailed = NO;
+            BOOL ranInBatch = NO;
+            NSString *queryErrorMessage = nil;
+            NSUInteger queryErrorID = 0;
+            unsigned long long queryRowCount = 0;
+
+            // The statement may already have been run as part of a batch...
+            if ([batchedRowCounts count]) {
+                queryRowCount = [[batchedRowCounts objectAtIndex:0] unsignedLongLongValue];
+                [batchedRowCounts removeObjectAtIndex:0];
+                ranInBatch = YES;
+            }
+            // ...or be the one the batch stopped at, in which case it failed
+            else if (batchStoppedAtStatement) {
+                queryErrored = queryFailed = YES;
+                queryErrorMessage = batchErrorMessage;
+                queryErrorID = batchErrorID;
+                batchStoppedAtStatement = NO;
+                ranInBatch = YES;
+            }
+            // Otherwise send a run of small INSERTs in one round trip where possible
+            else if (batchStatements && !runNextStatementAlone && [sqlStatement canBeBatched]) {
+                NSMutableArray *batch = [NSMutableArray arrayWithObject:sqlStatement];
+                NSUInteger batchLength = [sqlStatement queryLength] + 3;
+                NSUInteger maxBatchLength = [mySQLConnection maxQuerySize];
+
+                while ([batch count] < SPImportMaxBatchStatements) {
+                    SPSQLImportStatement *nextStatement;
+
+                    if ([readAheadStatements count]) {
+                        nextStatement = [readAheadStatements objectAtIndex:0];
+                        [readAheadStatements removeObjectAtIndex:0];
+                    }
+                    else {
+                        nextStatement = [sqlReader nextStatement];
+                    }
 
-                [self _closeAndStopProgressSheet];
-                [errors appendString:NSLocalizedString(@"The connection to the server was lost during the import.  The import is only partially complete.", @"Connection lost during import error message")];
-                [self showErrorSheetWithMessage:errors];
+                    if (!nextStatement) break;
 
-                return;
-            }
+                    // Anything else is kept back for its own turn; a statement which may change
+                    // the sql_mode is never batched, so the reader isn't asked for more until it has run
+                    if (![nextStatement canBeBatched] || batchLength + [nextStatement queryLength] + 3 > maxBatchLength) {
+                        [readAheadStatements insertObject:nextStatement atIndex:0];
+                        break;
+                    }
 
-            // Extract and process any complete SQL queries that can be found in the strings parsed so far
-            while ((query = [sqlParser trimAndReturnStringToCharacter:';' trimmingInclusively:YES returningInclusively:NO])) {
-                if (progressCancelled) break;
-                fileProcessedLength += [query lengthOfBytesUsingEncoding:sqlEncoding] + 1;
+                    [batch addObject:nextStatement];
+                    batchLength += [nextStatement queryLength] + 3;
+                }
 
-                // Ensure whitespace is removed from both ends, and normalise if necessary.
-                if ([sqlParser containsCarriageReturns]) {
-                    query = [SPSQLParser normaliseQueryForExecution:query];
-                } else {
-                    query = [query stringByTrimmingCharactersInSet:whitespaceAndNewlineCharset];
+                // The rest of the batch is still processed one statement at a time below, in order
+                if ([batch count] > 1) {
+                    [readAheadStatements insertObjects:[batch subarrayWithRange:NSMakeRange(1, [batch count] - 1)] atIndexes:[NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, [batch count] - 1)]];
                 }
 
-                // Skip blank or whitespace-only queries to avoid errors
-                if (![query length]) continue;
-
-                // Only a case-only DROP comparison needs lower_case_table_names.
-                // Query it before that DROP so the DROP remains the most recent
-                // statement for any following diagnostic query in the import.
-                if (!databaseNameCaseSensitivityWasLoaded
-                    && [SASQLDatabaseContext requiresDatabaseNameCaseSensitivityLookupForQuery:query
-                                                                             currentDatabase:databaseName
-                                                                                serverVersion:serverVersion
-                                                                              serverIsMariaDB:serverIsMariaDB]) {
-                    id lowerCaseTableNames = [mySQLConnection getFirstFieldFromQuery:@"SELECT @@lower_case_table_names" assertingDatabase:databaseName];
-                    // If the setting cannot be read, prefer clearing a case-only match over retaining a stale assertion.
-                    databaseNamesAreCaseSensitive = [lowerCaseTableNames respondsToSelector:@selector(integerValue)] && [lowerCaseTableNames integerValue] == 0;
-                    databaseNameCaseSensitivityWasLoaded = YES;
+                unsigned long long *rowCounts = calloc([batch count], sizeof(unsigned long long));
+                uint64_t batchStart = SPPipelineTimestamp();
+                NSUInteger succeededCount = NSNotFound;
+
+                // A lone statement gains nothing from the multi-statement round trips
+                if ([batch count] > 1) {
+                    succeededCount = [mySQLConnection queryStatements:[batch valueForKey:@"query"] usingEncoding:sqlEncoding affectedRowCounts:rowCounts assertingDatabaseContext:databaseName];
                 }
 
-                // Run the query
-                [mySQLConnection queryString:query usingEncoding:sqlEncoding withResultType:SPMySQLResultAsResult assertingDatabaseContext:databaseName];
+                if (succeededCount != NSNotFound) {
+                    BOOL batchFailed = (succeededCount < [batch count]);
 
-                // in case the query was a "SET @@sql_mode = ...", the server_status may have changed
-                if([mySQLConnection updateServerStatusBits:&serverStatus]) [sqlParser setNoBackslashEscapes:serverStatus.noBackslashEscapes];
-
-                // Check for any errors
-                if ([mySQLConnection queryErrored] && ![[mySQLConnection lastErrorMessage] isEqualToString:@"Query was empty"]) {
-                    [errors appendFormat:NSLocalizedString(@"[ERROR in query %ld] %@\n", @"error text when multiple custom query failed"), (long)(queriesPerformed+1), [mySQLConnection lastErrorMessage]];
-
-                    // if the error is about utf8mb4 not being supported by the server display a more helpful message.
-                    // Note: the same error will occur when doing CREATE TABLE... with utf8mb4.
-                    if([mySQLConnection lastErrorID] == 1115 /* ER_UNKNOWN_CHARACTER_SET */ && [[mySQLConnection lastErrorMessage] rangeOfString:@"utf8mb4" options:NSCaseInsensitiveSearch].location != NSNotFound && [query rangeOfString:@"SET NAMES" options:NSCaseInsensitiveSearch].location != NSNotFound) {
-                        if (!ignoreCharsetError) {
-                            __block NSInteger charsetErrorSheetReturnCode;
-
-                            SPMainQSync(^{
-                                NSAlert *charsetErrorAlert = [[NSAlert alloc] init];
-                                [charsetErrorAlert setMessageText:NSLocalizedString(@"Incompatible encoding in SQL file", @"sql import error message")];
-                                [charsetErrorAlert setInformativeText:NSLocalizedString(@"The SQL file uses utf8mb4 encoding, but your MySQL version only supports the limited utf8 subset.\n\nYou can continue the import, but any non-BMP characters in the SQL file (eg. some typographic and scientific special characters, archaic CJK logograms, emojis) will be unrecoverably lost!", @"sql import : charset error alert : detail message")];
-
-                                // Order of buttons matters! first button has "firstButtonReturn" return value from runModal(), etc
-                                [charsetErrorAlert addButtonWithTitle:NSLocalizedString(@"Import Anyway", @"sql import : charset error alert : continue button")];
-                                [charsetErrorAlert addButtonWithTitle:NSLocalizedString(@"Cancel", @"cancel button")];
-
-                                charsetErrorSheetReturnCode = [charsetErrorAlert runModal];
-                            });
-
-                            switch (charsetErrorSheetReturnCode) {
-                                    // don't display the message a second time
-                                case NSAlertFirstButtonReturn:
-                                    ignoreCharsetError = YES;
-                                    break;
-                                    // Otherwise, stop
-                                default:
-                                    [errors appendString:NSLocalizedString(@"Import cancelled!\n", @"import cancelled message")];
-                                    progressCancelled = YES;
-                            }
-                        }
+                    // A lost connection isn't the statement's fault, so it's run again on its own,
+                    // where the connection can be re-established and the statement retried
+                    BOOL reportFailure = batchFailed && ![SPMySQLConnection isErrorIDConnectionError:[mySQLConnection lastErrorID]];
+
+                    [importStatistics addNanoseconds:SPPipelineTimestamp() - batchStart toStage:SPTransferServerStage];
+                    [importStatistics addServerBytes:batchLength];
+                    [importStatistics addStatements:succeededCount + (reportFailure ? 1 : 0) errors:reportFailure ? 1 : 0];
+
+                    for (NSUInteger i = 1; i < succeededCount; i++)
+                    {
+                        [batchedRowCounts addObject:@(rowCounts[i])];
+                    }
+
+                    if (succeededCount) {
+                        queryRowCount = rowCounts[0];
+                        ranInBatch = YES;
                     }
-                    // If not set to ignore errors, ask what to do.  Use NSAlert rather than
-                    // SPBeginWaitingAlertSheet as there is already a modal sheet in progress.
-                    else if (!ignoreSQLErrors) {
-                        __block NSInteger sqlImportErrorSheetReturnCode;
-
-                        SPMainQSync(^{
-                            NSAlert *sqlErrorAlert = [[NSAlert alloc] init];
-                            [sqlErrorAlert setMessageText:NSLocalizedString(@"An error occurred while importing SQL", @"sql import error message")];
-                            [sqlErrorAlert setInformativeText:[NSString stringWithFormat:NSLocalizedString(@"[ERROR in query %ld] %@\n", @"error text when multiple custom query failed"), (long)(queriesPerformed+1), [self->mySQLConnection lastErrorMessage]]];
-
-                            // Order of buttons matters! first button has "firstButtonReturn" return value from runModal(), etc
-                            [sqlErrorAlert addButtonWithTitle:NSLocalizedString(@"Continue", @"continue button")];
-                            [sqlErrorAlert addButtonWithTitle:NSLocalizedString(@"Ignore All Errors", @"ignore errors button")];
-                            [sqlErrorAlert addButtonWithTitle:NSLocalizedString(@"Stop", @"stop button")];
-
-                            sqlImportErrorSheetReturnCode = [sqlErrorAlert runModal];
-                        });
-
-                        switch (sqlImportErrorSheetReturnCode) {
-                            case NSAlertFirstButtonReturn: // On "continue", no additional action is required
-                                break;
-                            case NSAlertSecondButtonReturn: // Ignore all future errors if asked to
-                                ignoreSQLErrors = YES;
-                                break;
-                            default: // Otherwise, stop
-                                [errors appendString:NSLocalizedString(@"Import cancelled!\n", @"import cancelled message")];
-                                progressCancelled = YES;
+
+                    if (reportFailure) {
+                        if (succeededCount) {
+                            batchStoppedAtStatement = YES;
+                            batchErrorMessage = [mySQLConnection lastErrorMessage];
+                            batchErrorID = [mySQLConnection lastErrorID];
+                        }
+                        else {
+                            queryErrored = queryFailed = YES;
+                            queryErrorMessage = [mySQLConnection lastErrorMessage];
+                            queryErrorID = [mySQLConnection lastErrorID];
+                            ranInBatch = YES;
                         }
                     }
-                }
-                else if (![mySQLConnection queryErrored]) {
-                    databaseName = [SASQLDatabaseContext databaseNameAfterSuccessfulQuery:query
-                                                                              currentDatabase:databaseName
-                                                       databaseNamesAreCaseSensitive:databaseNamesAreCaseSensitive
-                                                                        serverVersion:serverVersion
-                                                                        serverIsMariaDB:serverIsMariaDB];
+                    else if (batchFailed && succeededCount) {
+                        runNextStatementAlone = YES;
+                    }
                 }
 
-                // Increment the processed queries count
-                queriesPerformed++;
-#ifdef DEBUG
-                endDate = [NSDate date];
-                interval = [endDate timeIntervalSinceDate:startDate];
-                SPLog(@"Import time taken: %@, for %ld queries", [NSString stringWithFormat:@"%.3f", interval], (long)queriesPerformed);
-#endif
-                // Update the progress bar
-                if (fileIsCompressed) {
-                    [[singleProgressBar onMainThread] setDoubleValue:[sqlFileHandle realDataReadLength]];
-                    [[singleProgressText onMainThread] setStringValue:[NSString stringWithFormat:NSLocalizedString(@"Imported %@ of SQL", @"SQL import progress text where total size is unknown"),
-                                                                       [NSByteCountFormatter stringWithByteSize:fileProcessedLength]]];
-                } else {
-                    [[singleProgressBar onMainThread] setDoubleValue:fileProcessedLength];
-                    [[singleProgressText onMainThread] setStringValue:[NSString stringWithFormat:NSLocalizedString(@"Imported %@ of %@", @"SQL import progress text"),
-                                                                       [NSByteCountFormatter stringWithByteSize:fileProcessedLength],
-                                                                       [NSByteCountFormatter stringWithByteSize:fileTotalLength]]];
+                free(rowCounts);
+            }
+
+            // Run the statement by itself
+            if (!ranInBatch) {
+                uint64_t queryStart = SPPipelineTimestamp();
+
+                [mySQLConnection queryString:query usingEncoding:sqlEncoding withResultType:SPMySQLResultAsResult assertingDatabaseContext:databaseName];
+
+                [self _recordImportQuery:query encoding:sqlEncoding startedAt:queryStart];
+
+                queryErrored = [mySQLConnection queryErrored];
+                queryFailed = queryErrored && ![[mySQLConnection lastErrorMessage] isEqualToString:@"Query was empty"];
+                queryErrorMessage = [mySQLConnection lastErrorMessage];
+                queryErrorID = [mySQLConnection lastErrorID];
+                queryRowCount = [mySQLConnection rowsAffectedByLastQuery];
+                runNextStatementAlone = NO;
+            }
+
+            // SQL files are imported statement by statement, so count the rows each one inserted
+            if (!queryErrored) [importStatistics addRows:queryRowCount];
+
+            BOOL importCommitted = bulkLoadSession ? [bulkLoadSession checkpoint] : YES;
+
+            // A statement within a transaction the file started isn't committed yet, and would be rolled
+            // back if the connection were lost, so it can't be skipped when resuming
+            BOOL serverStatusUpdated = [mySQLConnection updateServerStatusBits:&serverStatus];
+
+            if (!serverStatusUpdated || serverStatus.inTransaction) importCommitted = NO;
+
+            // in case the query was a "SET @@sql_mode = ...", the server_status may have changed;
+            // the reader waits to hear how backslashes are now treated before splitting any further
+            if ([sqlStatement mayChangeServerStatus]) {
+                [sqlReader resumeWithNoBackslashEscapes:serverStatus.noBackslashEscapes];
+            }
+
+            // Check for any errors
+            if (queryFailed) {
+                [self _handleSQLImportError:queryErrorMessage errorID:queryErrorID inQuery:query sequenceNumber:[sqlStatement sequenceNumber] errors:errors ignoringSQLErrors:&ignoreSQLErrors ignoringCharsetError:&ignoreCharsetError];
+            }
+            else if (!queryErrored) {
+                databaseName = [SASQLDatabaseContext databaseNameAfterSuccessfulQuery:query
+                                                                          currentDatabase:databaseName
+                                                   databaseNamesAreCaseSensitive:databaseNamesAreCaseSensitive
+                                                                    serverVersion:serverVersion
+                                                                    serverIsMariaDB:serverIsMariaDB];
+            }
+
+            // Keep track of how far the import has got, leaving a statement which stopped it to run again
+            if (importCheckpoint && !(queryFailed && progressCancelled)) {
+                if (!queryErrored && SPSQLQueryIsSessionStatement(query)) [importCheckpoint recordSessionStatement:query];
+
+                [importCheckpoint recordPosition:[sqlStatement sequenceNumber] offset:[sqlStatement processedLength] storedOffset:[sqlStatement storedLength] delimiter:[sqlStatement delimiter] databaseName:databaseName];
+
+                // Save every commit of a fast bulk load; otherwise each statement commits, so every so often
+                if (importCommitted) {
+                    [importCheckpoint commitRecordedPosition];
+
+                    [self _writeImportCheckpointImmediately:[bulkLoadSession started] errors:errors];
                 }
             }
 
-            // If all the data has been read, break out of the processing loop
-            if (allDataRead) break;
+            // Increment the processed queries count
+            queriesPerformed++;
+#ifdef DEBUG
+            endDate = [NSDate date];
+            interval = [endDate timeIntervalSinceDate:startDate];
+            SPLog(@"Import time taken: %@, for %ld queries", [NSString stringWithFormat:@"%.3f", interval], (long)queriesPerformed);
+#endif
+            // Update the progress bar
+            [self _updateSQLImportProgressForStatement:sqlStatement fileIsCompressed:fileIsCompressed fileTotalLength:fileTotalLength];
         }
     }
 
-	// If any text remains in the SQL parser, it's an unterminated query - execute it.
-	query = [sqlParser stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]];
-	if ([query length] && !progressCancelled) {
-
-		if (!databaseNameCaseSensitivityWasLoaded
-			&& [SASQLDatabaseContext requiresDatabaseNameCaseSensitivityLookupForQuery:query
-			                                                         currentDatabase:databaseName
-			                                                            serverVersion:serverVersion
-			                                                          serverIsMariaDB:serverIsMariaDB]) {
-			id lowerCaseTableNames = [mySQLConnection getFirstFieldFromQuery:@"SELECT @@lower_case_table_names" assertingDatabase:databaseName];
-			// If the setting cannot be read, prefer clearing a case-only match over retaining a stale assertion.
-			databaseNamesAreCaseSensitive = [lowerCaseTableNames respondsToSelector:@selector(integerValue)] && [lowerCaseTableNames integerValue] == 0;
-			databaseNameCaseSensitivityWasLoaded = YES;
+	// Stop reading if the import was cancelled, and report anything which stopped the reading early
+	[sqlReader cancel];
+
+	// Wait for the rest of the table data, reporting any errors loading it
+	if (parallelRestore) {
+		if (progressCancelled) [parallelRestore cancel];
+
+		[parallelRestore finish];
+
+		for (NSDictionary *failure in [parallelRestore takeFailures])
+		{
+			if (progressCancelled) break;
+
+			[self _handleSQLImportError:[failure objectForKey:@"errorMessage"] errorID:[[failure objectForKey:@"errorID"] unsignedIntegerValue] inQuery:[failure objectForKey:@"query"] sequenceNumber:[[failure objectForKey:@"sequenceNumber"] unsignedIntegerValue] errors:errors ignoringSQLErrors:&ignoreSQLErrors ignoringCharsetError:&ignoreCharsetError];
 		}
+	}
 
-		// Run the query
-		[mySQLConnection queryString:query usingEncoding:sqlEncoding withResultType:SPMySQLResultAsResult assertingDatabaseContext:databaseName];
-		// we don't care for the server_status that is set AFTER the last query has been executed
+	SPLog(@"SQL import pipeline utilisation: read %.2f, split %.2f; waited %.3fs for statements",
+	      SPPipelineStageUtilisation([sqlReader readStageCounters]),
+	      SPPipelineStageUtilisation([sqlReader splitStageCounters]),
+	      [sqlReader statementWaitNanoseconds] / (double)NSEC_PER_SEC);
 
-		// Check for any errors
-		if ([mySQLConnection queryErrored] && ![[mySQLConnection lastErrorMessage] isEqualToString:@"Query was empty"]) {
-			[errors appendFormat:NSLocalizedString(@"[ERROR in query %ld] %@\n", @"error text when multiple custom query failed"), (long)(queriesPerformed+1), [mySQLConnection lastErrorMessage]];
+	if (!progressCancelled && ([sqlReader readErrorReason] || [sqlReader decodingFailed])) {
+		[self _endImportSessionWithErrors:nil completed:NO];
+		if (connectionEncodingToRestore) {
+			[mySQLConnection queryString:[NSString stringWithFormat:@"SET NAMES '%@'", connectionEncodingToRestore]];
 		}
-		else if (![mySQLConnection queryErrored]) {
-			databaseName = [SASQLDatabaseContext databaseNameAfterSuccessfulQuery:query
-			                                                                  currentDatabase:databaseName
-			                                           databaseNamesAreCaseSensitive:databaseNamesAreCaseSensitive
-			                                                            serverVersion:serverVersion
-			                                                            serverIsMariaDB:serverIsMariaDB];
+		if (sqlModeToRestore) {
+			[mySQLConnection queryString:[NSString stringWithFormat:@"SET SQL_MODE=%@", [sqlModeToRestore tickQuotedString]]];
 		}
 
-		// Increment the processed queries count
-		queriesPerformed++;
+		[self _closeAndStopProgressSheet];
+
+		if ([sqlReader readErrorReason]) {
+			[NSAlert createWarningAlertWithTitle:SP_FILE_READ_ERROR_STRING message:[NSString stringWithFormat:NSLocalizedString(@"An error occurred when reading the file.\n\nOnly %ld queries were executed.\n\n(%@)", @"SQL read error, including detail from system"), (long)queriesPerformed, [sqlReader readErrorReason]] callback:nil];
+		} else {
+			NSString *displayEncoding;
+
+			if (![[importEncodingPopup onMainThread] indexOfSelectedItem]) {
+				displayEncoding = [NSString stringWithFormat:@"%@ - %@", [[importEncodingPopup onMainThread] titleOfSelectedItem], [NSString localizedNameOfStringEncoding:sqlEncoding]];
+			} else {
+				displayEncoding = [NSString localizedNameOfStringEncoding:sqlEncoding];
+			}
+			[NSAlert createWarningAlertWithTitle:SP_FILE_READ_ERROR_STRING message:[NSString stringWithFormat:NSLocalizedString(@"An error occurred when reading the file, as it could not be read in the encoding you selected (%@).\n\nOnly %ld queries were executed.", @"SQL encoding read error"), displayEncoding, (long)queriesPerformed] callback:nil];
+		}
+		[tableDocumentInstance setQueryMode:SPInterfaceQueryMode];
+		if([filename hasPrefix:SPImportClipboardTempFileNamePrefix]) [fileManager removeItemAtPath:filename error:nil];
+		return;
 	}
 
 	// Clean up
+	NSString *bulkLoadSummary = [self _endImportSessionWithErrors:errors completed:!progressCancelled];
 	if (connectionEncodingToRestore) {
 		[mySQLConnection queryString:[NSString stringWithFormat:@"SET NAMES '%@'", connectionEncodingToRestore]];
 	}
@@ -727,6 +866,7 @@
 		[mySQLConnection queryString:[NSString stringWithFormat:@"SET SQL_MODE=%@", [sqlModeToRestore tickQuotedString]]];
 	}
 	[tableDocumentInstance setQueryMode:SPInterfaceQueryMode];
+	[self _finishImportStatisticsForFile:filename];
 	if([filename hasPrefix:SPImportClipboardTempFileNamePrefix]) [fileManager removeItemAtPath:filename error:nil];
 
 	// Close progress sheet
@@ -750,7 +890,9 @@
 	[[tableDocumentInstance databaseStructureRetrieval] queryDbStructureInBackgroundWithUserInfo:@{@"forceUpdate" : @YES}];
 
 	// Import finished notification
-	[SANotificationCenter.shared postNotificationWithTitle:@"Import Finished" body:[NSString stringWithFormat:NSLocalizedString(@"Finished importing %@", @"description for finished importing notification"), [filename lastPathComponent]]];
+	NSString *notificationBody = [NSString stringWithFormat:NSLocalizedString(@"Finished importing %@", @"description for finished importing notification"), [filename lastPathComponent]];
+	if (bulkLoadSummary) notificationBody = [notificationBody stringByAppendingFormat:@"\n%@", bulkLoadSummary];
+	[SANotificationCenter.shared postNotificationWithTitle:@"Import Finished" body:notificationBody];
 
 #ifdef DEBUG
 	endDate = [NSDate date];
@@ -793,9 +935,13 @@
 	NSMutableArray *parsedRows = [[NSMutableArray alloc] init];
 	NSMutableArray *parsePositions = [[NSMutableArray alloc] init];
 	NSArray *csvRowArray;
-	NSInteger fileChunkMaxLength = 256 * 1024;
-	NSUInteger csvRowsPerQuery = 1000;
 	NSUInteger csvRowsThisQuery;
+	NSUInteger csvQueryLength;
+	NSStringEncoding csvQueryEncoding;
+	NSUInteger csvReadLength;
+	NSData *csvSampleData = nil;
+	NSArray *csvPreviewRows = nil;
+	BOOL csvPreviewIsComplete = NO;
 	NSUInteger fileTotalLength = 0;
 	BOOL fileIsCompressed;
 	NSInteger rowsImported = 0;
@@ -806,6 +952,12 @@
 	NSUInteger i;
 	BOOL allDataRead = NO;
 	BOOL insertBaseStringHasEntries;
+	BOOL csvDataIsUTF8;
+	BOOL loadDataAttempted = NO;
+	BOOL csvLoadedByServer = NO;
+	NSUInteger csvRowsToSkip = 0;
+	NSUInteger csvRowsProcessed = 0;
+	uint64_t queryStart;
 	__block NSStringEncoding csvEncoding;
 
 	fieldMappingArray = nil;
@@ -833,6 +985,9 @@
 	if (!fileTotalLength) fileTotalLength = 1;
 	fileIsCompressed = ([csvFileHandle compressionFormat] != SPNoCompression);
 
+	// Offer to carry on from where an earlier import of the file stopped
+	BOOL resumingImport = [self _offerToResumeImportOfFile:filename format:@"CSV"];
+
 	// Reset progress interface
 	SPMainQSync(^{
 		[self->errorsView setString:@""];
@@ -846,6 +1001,11 @@
 		[[self->tableDocumentInstance parentWindowControllerWindow] beginSheet:self->singleProgressSheet completionHandler:nil];
 	});
 
+	[self _beginImportStatistics];
+
+	// Size the INSERT batches to the connection's max_allowed_packet, then to the server's pace
+	csvBatchSizer = [[SPImportBatchSizer alloc] initWithMaxQuerySize:[mySQLConnection maxQuerySize] targetNanoseconds:SPCSVImportBatchTargetNanoseconds];
+
 	[tableDocumentInstance setQueryMode:SPImportExportQueryMode];
 	NSString *databaseName = [tableDocumentInstance database];
 
@@ -864,6 +1024,16 @@
 		csvEncoding = [fileManager detectEncodingforFileAtPath:filename];
 	}
 
+	// A resumed import reads the file as it was read before, skipping the rows already imported;
+	// parsing them again costs little next to inserting them.  Otherwise keep a checkpoint to resume from
+	if (resumingImport) {
+		csvEncoding = [importCheckpoint encoding];
+		csvRowsToSkip = [importCheckpoint position];
+	}
+	else if ([prefs boolForKey:SPImportCheckpoints] && ![filename hasPrefix:SPImportClipboardTempFileNamePrefix]) {
+		importCheckpoint = [[SPImportCheckpoint alloc] initWithImportFilePath:filename format:@"CSV" encoding:csvEncoding];
+	}
+
 	// Read in the file in a loop.  The loop actually needs to perform three tasks: read in
 	// CSV data and parse them into row arrays; present the field mapping interface once it
 	// has some data to show within the interface; and use the field mapping data to construct
@@ -896,16 +1066,56 @@
 	csvLineTerminatorBytes = [csvLineTerminatorData bytes];
 	csvLineTerminatorLength = [csvLineTerminatorData length];
 
+	// UTF-8 files are handed to the parser as read, without first being split into lines and
+	// decoded; only the fields of each parsed row are decoded
+	csvDataIsUTF8 = (csvEncoding == NSUTF8StringEncoding);
+
+	// Sample the file for the field mapper.  The sample is kept, so going back to the file chooser
+	// to change the CSV settings only parses it again, without reading the file
+	if (![csvImportSampler isSampleOfFileAtPath:filename]) {
+		csvImportSampler = [[SPCSVImportSampler alloc] initWithPath:filename];
+
+		if (![csvImportSampler readSample]) csvImportSampler = nil;
+	}
+
+	// Ask for one row more than is shown, to tell whether the rows shown are all there are
+	csvPreviewRows = [csvImportSampler rowsParsedWithSettingsOfParser:csvParser encoding:csvEncoding limit:SPCSVImportPreviewRowCount + 1];
+
+	if ([csvPreviewRows count]) {
+		csvPreviewIsComplete = [csvImportSampler sampleIsWholeFile] && [csvPreviewRows count] <= SPCSVImportPreviewRowCount;
+
+		if (!csvPreviewIsComplete) csvPreviewRows = [csvPreviewRows subarrayWithRange:NSMakeRange(0, MIN([csvPreviewRows count], SPCSVImportPreviewRowCount))];
+
+		csvSampleData = [[csvImportSampler headData] subdataWithRange:NSMakeRange(0, MIN([[csvImportSampler headData] length], (NSUInteger)(256 * 1024)))];
+	}
+	else {
+		csvPreviewRows = nil;
+	}
+
+	// Parse large reads on all the cores, reading enough at a time to share out between them
+	csvReadLength = [csvBatchSizer readChunkLength];
+	if ([prefs boolForKey:SPCSVImportParallelParsing] && [[NSProcessInfo processInfo] activeProcessorCount] > 1) {
+		[csvParser setParsingThreads:[[NSProcessInfo processInfo] activeProcessorCount]];
+		csvReadLength = MAX(csvReadLength, SPCSVImportParallelReadLength);
+	}
+
 	csvDataBuffer = [[NSMutableData alloc] init];
 	while (1) {
 		if (progressCancelled) break;
 
 		@try {
-			fileChunk = [csvFileHandle readDataOfLength:fileChunkMaxLength];
+			uint64_t readStart = SPPipelineTimestamp();
+
+			// Uncompressed files are read as slices of a mapping of the file, and compressed ones
+			// are decompressed in the background; either way the parser works through them in place
+			fileChunk = [csvFileHandle readStreamedDataOfLength:fieldMappingArray ? csvReadLength : SPCSVImportMappingReadLength];
+
+			[self _recordImportReadOfLength:[fileChunk length] fromFileHandle:csvFileHandle startedAt:readStart];
 		}
 
 		// Report file read errors, and bail
 		@catch (NSException *exception) {
+			[self _endImportSessionWithErrors:nil completed:NO];
 			[self _closeAndStopProgressSheet];
 			[NSAlert createWarningAlertWithTitle:SP_FILE_READ_ERROR_STRING message:[NSString stringWithFormat:NSLocalizedString(@"An error occurred when reading the file.\n\nOnly %ld rows were imported.\n\n(%@)", @"CSV read error, including detail string from system"), (long)rowsImported, [exception reason]] callback:nil];
 			[tableDocumentInstance setQueryMode:SPInterfaceQueryMode];
@@ -914,11 +1124,27 @@
 			return;
 		}
 
+		// Keep the start of the file to judge whether the server could load it
+		if (!csvSampleData && [fileChunk length]) {
+			csvSampleData = [fileChunk subdataWithRange:NSMakeRange(0, MIN([fileChunk length], (NSUInteger)(256 * 1024)))];
+		}
+
 		// If no data returned, end of file - set a marker to ensure full processing
 		if (!fileChunk || ![fileChunk length]) {
 			allDataRead = YES;
 
-		// Otherwise add the data to the read/parse buffer
+		// Otherwise add UTF-8 data straight to the parser, skipping any byte order mark
+		} else if (csvDataIsUTF8) {
+			if (![csvParser totalLengthParsed] && ![csvParser length] && [fileChunk length] >= 3 && !memcmp([fileChunk bytes], "\xEF\xBB\xBF", 3)) {
+				NSData *chunkWithByteOrderMark = fileChunk;
+
+				fileChunk = [[NSData alloc] initWithBytesNoCopy:(void *)((const uint8_t *)[chunkWithByteOrderMark bytes] + 3) length:[chunkWithByteOrderMark length] - 3 deallocator:^(void *bytes, NSUInteger length) {
+					(void)chunkWithByteOrderMark;
+				}];
+			}
+			[csvParser appendDataNoCopy:fileChunk];
+
+		// Or add the data to the read/parse buffer
 		} else {
 			[csvDataBuffer appendData:fileChunk];
 		}
@@ -926,7 +1152,7 @@
 		// Step through the data buffer, identifying line endings to parse the data with
 		csvDataBufferBytes = [csvDataBuffer bytes];
 		dataBufferLength = [csvDataBuffer length];
-		for ( ; dataBufferPosition < dataBufferLength || allDataRead; dataBufferPosition++) {
+		for ( ; !csvDataIsUTF8 && (dataBufferPosition < dataBufferLength || allDataRead); dataBufferPosition++) {
 			BOOL atLineEnding = NO;
 			BOOL atPartialLineEnding = NO;
 			NSInteger segmentEndPosition = dataBufferPosition;
@@ -956,21 +1182,9 @@
 				}
 
 				// Try to generate a NSString with the resulting data
-				csvString = [[NSString alloc] initWithData:[csvDataBuffer subdataWithRange:NSMakeRange(dataBufferLastQueryEndPosition, segmentEndPosition - dataBufferLastQueryEndPosition)] encoding:csvEncoding];
+				csvString = [[NSString alloc] initWithBytes:csvDataBufferBytes + dataBufferLastQueryEndPosition length:(NSUInteger)(segmentEndPosition - dataBufferLastQueryEndPosition) encoding:csvEncoding];
 				if (!csvString) {
-					[self _closeAndStopProgressSheet];
-					SPMainQSync(^{
-						NSString *displayEncoding;
-						if (![self->importEncodingPopup indexOfSelectedItem]) {
-							displayEncoding = [NSString stringWithFormat:@"%@ - %@", [self->importEncodingPopup titleOfSelectedItem], [NSString localizedNameOfStringEncoding:csvEncoding]];
-						} else {
-							displayEncoding = [NSString localizedNameOfStringEncoding:csvEncoding];
-						}
-						[NSAlert createWarningAlertWithTitle:SP_FILE_READ_ERROR_STRING message:[NSString stringWithFormat:NSLocalizedString(@"An error occurred when reading the file, as it could not be read using the encoding you selected (%@).\n\nOnly %ld rows were imported.", @"CSV encoding read error"), displayEncoding, (long)rowsImported] callback:nil];
-					});
-					[tableDocumentInstance setQueryMode:SPInterfaceQueryMode];
-					if([filename hasPrefix:SPImportClipboardTempFileNamePrefix])
-						[fileManager removeItemAtPath:filename error:nil];
+					[self _abortCSVImportOfFile:filename withEncodingError:csvEncoding rowsImported:rowsImported];
 					return;
 				}
 
@@ -989,7 +1203,7 @@
 
 		// Trim the data buffer if part of it was used
 		if (dataBufferLastQueryEndPosition) {
-			[csvDataBuffer setData:[csvDataBuffer subdataWithRange:NSMakeRange(dataBufferLastQueryEndPosition, dataBufferLength - dataBufferLastQueryEndPosition)]];
+			[csvDataBuffer replaceBytesInRange:NSMakeRange(0, dataBufferLastQueryEndPosition) withBytes:NULL length:0];
 			dataBufferPosition -= dataBufferLastQueryEndPosition;
 			dataBufferLastQueryEndPosition = 0;
 		}
@@ -998,25 +1212,41 @@
 		// rows have been read, in order to ensure short files are still processed.
 		while ((csvRowArray = [csvParser getRowAsArrayAndTrimString:YES stringIsComplete:allDataRead]) || (allDataRead && [parsedRows count])) {
 
+			// Fields which aren't valid UTF-8 mean the file isn't in the encoding selected
+			if ([csvParser decodingFailed]) {
+				[self _abortCSVImportOfFile:filename withEncodingError:csvEncoding rowsImported:rowsImported];
+				return;
+			}
+
 			// If valid, add the row array and length to local storage
 			if (csvRowArray) {
 				[parsedRows addObject:csvRowArray];
 				[parsePositions addObject:@([csvParser totalLengthParsed])];
 			}
 
-			// If we have no field mapping array, and either the first hundred rows or all
-			// the rows, request the field mapping from the user.
+			// If we have no field mapping array, and either the rows of the file's sample, the
+			// first hundred rows or all the rows, request the field mapping from the user.
 			if (!fieldMappingArray
-				&& ([parsedRows count] >= 100 || (!csvRowArray && allDataRead)))
+				&& (csvPreviewRows || [parsedRows count] >= SPCSVImportPreviewRowCount || (!csvRowArray && allDataRead)))
 			{
 				[self _closeAndStopProgressSheet];
-				if (![self buildFieldMappingArrayWithData:parsedRows isPreview:!allDataRead ofSoureFile:filename databaseName:databaseName]) {
+
+				// Don't count the time the user spends mapping fields
+				[importStatistics pause];
+
+				// Show the sample's rows where there are some, as they don't depend on how much has been read
+				NSArray *mappingRows = csvPreviewRows ? csvPreviewRows : parsedRows;
+				BOOL mappingRowsArePreview = csvPreviewRows ? !csvPreviewIsComplete : !allDataRead;
+
+				if (![self buildFieldMappingArrayWithData:mappingRows isPreview:mappingRowsArePreview ofSoureFile:filename databaseName:databaseName]) {
 					[tableDocumentInstance setQueryMode:SPInterfaceQueryMode];
 					if([filename hasPrefix:SPImportClipboardTempFileNamePrefix])
 						[fileManager removeItemAtPath:filename error:nil];
 					return;
 				}
 
+				[importStatistics resume];
+
 				// Reset progress interface and open the progress sheet
 				SPMainQSync(^{
 					[self->singleProgressBar setMaxValue:fileTotalLength];
@@ -1079,10 +1309,51 @@
 				}
 			}
 			if (!fieldMappingArray) continue;
+
+			// Plain column-mapped imports can be left to the server, which reads the whole file in one
+			// LOAD DATA query; if it can't, the rows are inserted here as usual
+			if (!loadDataAttempted) {
+				loadDataAttempted = YES;
+
+				// A resumed import only carries on into the same table; into any other it starts again
+				if (csvRowsToSkip && ![[importCheckpoint tableName] isEqualToString:selectedTableTarget]) {
+					csvRowsToSkip = 0;
+					importCheckpoint = [[SPImportCheckpoint alloc] initWithImportFilePath:filename format:@"CSV" encoding:csvEncoding];
+				}
+				[importCheckpoint setTableName:selectedTableTarget];
+
+				NSString *loadDataQuery = csvRowsToSkip ? nil : [self _loadDataQueryForCSVFile:filename parser:csvParser encoding:csvEncoding sample:csvSampleData];
+
+				if (loadDataQuery && [self _loadCSVFile:filename withQuery:loadDataQuery databaseName:databaseName fileTotalLength:fileTotalLength errors:errors rowsImported:&rowsImported]) {
+					csvLoadedByServer = YES;
+					csvBatchSizer = nil;
+					break;
+				}
+
+				// Otherwise the rows are inserted here, so switch to fast bulk loading if selected
+				[self _beginBulkLoadSessionCalibrating:YES];
+				if ([prefs boolForKey:SPImportBulkLoadDisableKeys]) [bulkLoadSession disableKeysForTable:selectedTableTarget inDatabase:databaseName];
+
+				// Send the rows as the values of prepared statements where they can be, keeping to
+				// powers of two rows per batch so a few statements serve the whole import
+				csvPreparedInsert = [self _preparedInsertWithInsertString:insertBaseString];
+				if (csvPreparedInsert) [csvBatchSizer setRoundsRowsToPowersOfTwo:YES];
+			}
+
+			// Rows imported before the import was resumed are parsed again, but not sent
+			if (csvRowsToSkip && [parsedRows count]) {
+				NSUInteger skipCount = MIN(csvRowsToSkip, [parsedRows count]);
+
+				[parsedRows removeObjectsInRange:NSMakeRange(0, skipCount)];
+				[parsePositions removeObjectsInRange:NSMakeRange(0, skipCount)];
+				csvRowsToSkip -= skipCount;
+				csvRowsProcessed += skipCount;
+			}
 			
 			// Before entering the following loop, check that we actually have a connection.
 			// If not, check the connection if appropriate and then clean up and exit if appropriate.
 			if (![mySQLConnection isConnected] && ([mySQLConnection userTriggeredDisconnect] || ![mySQLConnection checkConnection])) {
+				[self _endImportSessionWithErrors:nil completed:NO];
 				[self _closeAndStopProgressSheet];
 				[tableDocumentInstance setQueryMode:SPInterfaceQueryMode];
 				if([filename hasPrefix:SPImportClipboardTempFileNamePrefix])
@@ -1090,27 +1361,86 @@
 				return;
 			}
 
-			// If we have more than the csvRowsPerQuery amount, or if we're at the end of the
-			// available data, construct and run a query.
-			while ([parsedRows count] >= csvRowsPerQuery
+			// If we have a full batch of rows, or if we're at the end of the available data,
+			// construct and run a query.
+			while ([parsedRows count] >= [csvBatchSizer rowsPerBatch]
 					|| (!csvRowArray && allDataRead && [parsedRows count]))
 			{
 				if (progressCancelled) break;
 				csvRowsThisQuery = 0;
-				if(!importMethodIsUpdate) {
+				if (csvPreparedInsert) {
+					NSUInteger statementRows = MIN(MIN([csvBatchSizer rowsPerBatch], [parsedRows count]), [csvPreparedInsert maxRowsPerStatement]);
+
+					for (i = 0; i < statementRows; i++) {
+						[self _appendMappedRow:[parsedRows objectAtIndex:i] toPreparedInsert:csvPreparedInsert];
+
+						// As with a query, a row too long for a batch of its own is still sent alone
+						if (i > 0 && [csvPreparedInsert executeLength] > [csvBatchSizer maxBatchLength]) {
+							[csvPreparedInsert removeRowsFromIndex:i];
+							break;
+						}
+					}
+
+					// A batch cut short by length is cut to a power of two rows, to use a statement
+					// which has already been prepared; the last rows of the file go in one of their own
+					if ([csvPreparedInsert rowCount] < statementRows) {
+						NSUInteger roundedRows = 1;
+
+						while (roundedRows * 2 <= [csvPreparedInsert rowCount]) roundedRows *= 2;
+
+						[csvPreparedInsert removeRowsFromIndex:roundedRows];
+					}
+
+					csvRowsThisQuery = [csvPreparedInsert rowCount];
+
+					// If the server can't prepare the statement, carry on sending the rows in queries
+					if (![csvPreparedInsert prepareStatementForRowCount:csvRowsThisQuery inDatabase:databaseName]) {
+						[csvPreparedInsert close];
+						csvPreparedInsert = nil;
+						[csvBatchSizer setRoundsRowsToPowersOfTwo:NO];
+						continue;
+					}
+
+					// Perform the query
+					queryStart = SPPipelineTimestamp();
+
+					[csvPreparedInsert executeInDatabase:databaseName];
+
+					if (![mySQLConnection queryErrored]) [csvBatchSizer recordBatchOfRows:csvRowsThisQuery duration:SPPipelineTimestamp() - queryStart];
+
+					[self _recordImportStatementOfLength:[csvPreparedInsert executeLength] startedAt:queryStart];
+
+					[csvPreparedInsert removeAllRows];
+				} else if(!importMethodIsUpdate) {
 					query = [[NSMutableString alloc] initWithString:insertBaseString];
-					for (i = 0; i < csvRowsPerQuery && i < [parsedRows count]; i++) {
+					csvQueryEncoding = [mySQLConnection stringEncoding];
+					csvQueryLength = [query lengthOfBytesUsingEncoding:csvQueryEncoding];
+					if (csvImportMethodHasTail) csvQueryLength += [csvImportTailString lengthOfBytesUsingEncoding:csvQueryEncoding] + 1;
+					for (i = 0; i < [csvBatchSizer rowsPerBatch] && i < [parsedRows count]; i++) {
+						NSString *rowValueString = [[self mappedValueStringForRowArray:[parsedRows objectAtIndex:i]] description];
+						NSUInteger rowValueLength = [rowValueString lengthOfBytesUsingEncoding:csvQueryEncoding] + 2;
+
+						// A row too long for a batch of its own is still sent, alone, leaving the
+						// connection to raise max_allowed_packet for it where it can
+						if (i > 0 && csvQueryLength + rowValueLength > [csvBatchSizer maxBatchLength]) break;
+
 						if (i > 0) [query appendString:@",\n"];
-						[query appendString:[[self mappedValueStringForRowArray:[parsedRows objectAtIndex:i]] description]];
+						[query appendString:rowValueString];
+						csvQueryLength += rowValueLength;
 						csvRowsThisQuery++;
-						if ([query length] > 250000) break;
 					}
 
 					// Perform the query
+					queryStart = SPPipelineTimestamp();
+
 					if(csvImportMethodHasTail)
 						[mySQLConnection queryString:[NSString stringWithFormat:@"%@ %@", query, csvImportTailString] assertingDatabaseContext:databaseName];
 					else
 						[mySQLConnection queryString:query assertingDatabaseContext:databaseName];
+
+					if (![mySQLConnection queryErrored]) [csvBatchSizer recordBatchOfRows:csvRowsThisQuery duration:SPPipelineTimestamp() - queryStart];
+
+					[self _recordImportQuery:query encoding:csvQueryEncoding startedAt:queryStart];
 				} else {
 					if(insertRemainingRowsAfterUpdate) {
 						[insertRemainingBaseString setString:@"INSERT INTO "];
@@ -1132,11 +1462,15 @@
 						[query appendString:[self mappedUpdateSetStatementStringForRowArray:[parsedRows objectAtIndex:i]]];
 
 						// Perform the query
+						queryStart = SPPipelineTimestamp();
+
 						if(csvImportMethodHasTail)
 							[mySQLConnection queryString:[NSString stringWithFormat:@"%@ %@", query, csvImportTailString] assertingDatabaseContext:databaseName];
 						else
 							[mySQLConnection queryString:query assertingDatabaseContext:databaseName];
 
+						[self _recordImportQuery:query encoding:[mySQLConnection stringEncoding] startedAt:queryStart];
+
 						if ([mySQLConnection queryErrored]) {
 							[[tableDocumentInstance onMainThread] showConsole];
 							[errors appendFormat:
@@ -1153,11 +1487,15 @@
 							[query appendString:[self mappedValueStringForRowArray:[parsedRows objectAtIndex:i]]];
 
 							// Perform the query
+							queryStart = SPPipelineTimestamp();
+
 							if(csvImportMethodHasTail)
 								[mySQLConnection queryString:[NSString stringWithFormat:@"%@ %@", query, csvImportTailString] assertingDatabaseContext:databaseName];
 							else
 								[mySQLConnection queryString:query assertingDatabaseContext:databaseName];
 
+							[self _recordImportQuery:query encoding:[mySQLConnection stringEncoding] startedAt:queryStart];
+
 							if ([mySQLConnection queryErrored]) {
 								[errors appendFormat:
 									NSLocalizedString(@"[ERROR in row %ld] %@\n", @"error text when reading of csv file gave errors"),
@@ -1167,6 +1505,7 @@
 
 						rowsImported++;
 						csvRowsThisQuery++;
+						if (![mySQLConnection queryErrored]) [importStatistics addRows:1];
 #warning Updating the UI for every single row is likely a performance killer (even without synchronization).
 						SPMainQSync(^{
 							if (fileIsCompressed) {
@@ -1192,11 +1531,15 @@
 						[query appendString:[self mappedValueStringForRowArray:[parsedRows objectAtIndex:i]]];
 
 						// Perform the query
+						queryStart = SPPipelineTimestamp();
+
 						if(csvImportMethodHasTail)
 							[mySQLConnection queryString:[NSString stringWithFormat:@"%@ %@", query, csvImportTailString] assertingDatabaseContext:databaseName];
 						else
 							[mySQLConnection queryString:query assertingDatabaseContext:databaseName];
 
+						[self _recordImportQuery:query encoding:[mySQLConnection stringEncoding] startedAt:queryStart];
+
 						if ([mySQLConnection queryErrored]) {
 							[errors appendFormat:
 								NSLocalizedString(@"[ERROR in row %ld] %@\n", @"error text when reading of csv file gave errors"),
@@ -1207,6 +1550,7 @@
 						}
 #warning duplicate code (see above)
 						rowsImported++;
+						if (![mySQLConnection queryErrored]) [importStatistics addRows:1];
 						SPMainQSync(^{
 							if (fileIsCompressed) {
 								[self->singleProgressBar setDoubleValue:[csvFileHandle realDataReadLength]];
@@ -1219,6 +1563,7 @@
 					}
 				} else {
 					rowsImported += csvRowsThisQuery;
+					[importStatistics addRows:csvRowsThisQuery];
 #warning duplicate code (see above)
 					SPMainQSync(^{
 						if (fileIsCompressed) {
@@ -1231,6 +1576,22 @@
 					});
 				}
 
+				BOOL importCommitted = bulkLoadSession ? [bulkLoadSession checkpoint] : YES;
+
+				// Keep track of how far the import has got, saving every commit of a fast bulk load
+				csvRowsProcessed += csvRowsThisQuery;
+				if (importCheckpoint && csvRowsThisQuery) {
+					[importCheckpoint recordPosition:csvRowsProcessed offset:[[parsePositions objectAtIndex:csvRowsThisQuery - 1] unsignedLongLongValue] storedOffset:[csvFileHandle realDataReadLength] delimiter:nil databaseName:databaseName];
+
+					if (importCommitted) {
+						[importCheckpoint commitRecordedPosition];
+
+						[self _writeImportCheckpointImmediately:[bulkLoadSession started] errors:errors];
+					}
+				}
+
+				[self _updateImportStatisticsText];
+
 				// Update the arrays
 				[parsedRows removeObjectsInRange:NSMakeRange(0, csvRowsThisQuery)];
 				[parsePositions removeObjectsInRange:NSMakeRange(0, csvRowsThisQuery)];
@@ -1238,11 +1599,13 @@
 		}
 		
 		// If all the data has been read, break out of the processing loop
-		if (allDataRead) break;
+		if (allDataRead || csvLoadedByServer) break;
 	}
 
 	// Clean up
+	NSString *bulkLoadSummary = [self _endImportSessionWithErrors:errors completed:!progressCancelled];
 	[tableDocumentInstance setQueryMode:SPInterfaceQueryMode];
+	[self _finishImportStatisticsForFile:filename];
 	if([filename hasPrefix:SPImportClipboardTempFileNamePrefix])
 		[fileManager removeItemAtPath:filename error:nil];
 
@@ -1255,7 +1618,9 @@
 	}
 	
 	// Import finished notification
-	[SANotificationCenter.shared postNotificationWithTitle:@"Import Finished" body:[NSString stringWithFormat:NSLocalizedString(@"Finished importing %@", @"description for finished importing notification"), [filename lastPathComponent]]];
+	NSString *notificationBody = [NSString stringWithFormat:NSLocalizedString(@"Finished importing %@", @"description for finished importing notification"), [filename lastPathComponent]];
+	if (bulkLoadSummary) notificationBody = [notificationBody stringByAppendingFormat:@"\n%@", bulkLoadSummary];
+	[SANotificationCenter.shared postNotificationWithTitle:@"Import Finished" body:notificationBody];
 
 	SPMainQSync(^{
 
@@ -1325,6 +1690,7 @@
 		[fieldMapperController setConnection:self->mySQLConnection];
 		[fieldMapperController setDatabaseName:databaseName];
 		[fieldMapperController setSourcePath:filename];
+		[fieldMapperController setImportSampler:[self->csvImportSampler isSampleOfFileAtPath:filename] ? self->csvImportSampler : nil];
 		[fieldMapperController setImportDataArray:self->fieldMappingImportArray hasHeader:[self->importFieldNamesSwitch state] isPreview:self->fieldMappingImportArrayIsPreview];
 		
 		// Show field mapper sheet and set the focus to it
@@ -1769,6 +2135,600 @@
 	});
 }
 
+/**
+ * Starts the throughput statistics for an import, and clears their readout on the progress sheet.
+ */
+- (void)_beginImportStatistics
+{
+	importStatistics = [[SPTransferStatistics alloc] initWithDirection:SPTransferImport];
+	importStatisticsReadLength = 0;
+	importStatisticsUpdateTime = 0;
+	csvBatchSizer = nil;
+
+	[[singleProgressStatisticsText onMainThread] setStringValue:@""];
+}
+
+/**
+ * Adds a chunk read from the import file to the statistics. Reading decompresses compressed files,
+ * so the time counts as decompression for those and as disk time otherwise.
+ */
+- (void)_recordImportReadOfLength:(NSUInteger)length fromFileHandle:(SPFileHandle *)fileHandle startedAt:(uint64_t)start
+{
+	NSUInteger readLength = [fileHandle realDataReadLength];
+
+	[importStatistics addFileBytes:length];
+	[importStatistics addStoredFileBytes:(readLength > importStatisticsReadLength) ? readLength - importStatisticsReadLength : 0];
+	[importStatistics addNanoseconds:SPPipelineTimestamp() - start toStage:([fileHandle compressionFormat] != SPNoCompression) ? SPTransferCompressionStage : SPTransferDiskStage];
+
+	importStatisticsReadLength = readLength;
+}
+
+/**
+ * Shows how far through the file a SQL import is, as of the supplied statement.
+ */
+- (void)_updateSQLImportProgressForStatement:(SPSQLImportStatement *)sqlStatement fileIsCompressed:(BOOL)fileIsCompressed fileTotalLength:(NSUInteger)fileTotalLength
+{
+	if (fileIsCompressed) {
+		[[singleProgressBar onMainThread] setDoubleValue:[sqlStatement storedLength]];
+		[[singleProgressText onMainThread] setStringValue:[NSString stringWithFormat:NSLocalizedString(@"Imported %@ of SQL", @"SQL import progress text where total size is unknown"),
+		                                                   [NSByteCountFormatter stringWithByteSize:[sqlStatement processedLength]]]];
+	} else {
+		[[singleProgressBar onMainThread] setDoubleValue:[sqlStatement processedLength]];
+		[[singleProgressText onMainThread] setStringValue:[NSString stringWithFormat:NSLocalizedString(@"Imported %@ of %@", @"SQL import progress text"),
+		                                                   [NSByteCountFormatter stringWithByteSize:[sqlStatement processedLength]],
+		                                                   [NSByteCountFormatter stringWithByteSize:fileTotalLength]]];
+	}
+
+	[self _updateImportStatisticsText];
+}
+
+/**
+ * Returns a LOAD DATA LOCAL INFILE query importing the CSV file with the field mapping chosen, or nil
+ * if the import needs handling row by row. That covers updates and ON DUPLICATE KEY UPDATE clauses,
+ * global values and geometry or bit columns, CSV settings the server can't read the same way, and
+ * files where the parser's skipping of whitespace around fields and of blank lines matters, judged
+ * from the sample read from the start of the file.
+ *
+ * CSV columns which aren't imported are read into @dummy; columns imported into one table column as
+ * they are load straight into it, and the rest are read into variables and assigned with SET.
+ */
+- (NSString *)_loadDataQueryForCSVFile:(NSString *)filename parser:(SPCSVParser *)csvParser encoding:(NSStringEncoding)csvEncoding sample:(NSData *)csvSampleData
+{
+	NSString *fieldTerminator = [csvParser fieldTerminatorString];
+	NSString *lineTerminator = [csvParser lineTerminatorString];
+	NSString *fieldQuote = [csvParser fieldQuoteString];
+	NSString *escape = [csvParser escapeString];
+	NSString *characterSet = [SPMySQLConnection mySQLCharsetForStringEncoding:csvEncoding];
+	NSInteger i, j;
+
+	if (![prefs boolForKey:SPCSVImportUseLoadData]) return nil;
+	if (importMethodIsUpdate || csvImportMethodHasTail || !characterSet) return nil;
+
+	// The server only reads unquoted NULL as NULL when fields can be quoted, and only \N otherwise
+	if (![fieldQuote length] || ![[csvParser nullReplacementString] isEqualToString:@"NULL"]) return nil;
+	if ([escape length] && ![escape isEqualToString:fieldQuote]) return nil;
+
+	NSString *formatClause = [SPCSVLoadDataImport formatClauseWithFieldTerminator:fieldTerminator lineTerminator:lineTerminator fieldQuote:fieldQuote escape:escape];
+
+	if (!formatClause) return nil;
+
+	// The server loads whitespace around fields and blank lines as data, which the parser skips.
+	// The sample may end part way through a character, which is left off
+	NSString *sample = nil;
+
+	for (NSUInteger trimLength = 0; !sample && trimLength < 4 && trimLength < [csvSampleData length]; trimLength++) {
+		sample = [[NSString alloc] initWithData:[csvSampleData subdataWithRange:NSMakeRange(0, [csvSampleData length] - trimLength)] encoding:csvEncoding];
+	}
+	if (!sample) return nil;
+
+	for (NSString *padding in @[@" ", @"\t"]) {
+		if ([fieldTerminator isEqualToString:padding]) continue;
+
+		if ([sample rangeOfString:[fieldTerminator stringByAppendingString:padding]].location != NSNotFound
+			|| [sample rangeOfString:[lineTerminator stringByAppendingString:padding]].location != NSNotFound
+			|| [sample hasPrefix:padding]) return nil;
+	}
+	if ([sample rangeOfString:[lineTerminator stringByAppendingString:lineTerminator]].location != NSNotFound) return nil;
+
+	// Work out where each CSV column goes
+	NSMutableArray *columnTargets = [NSMutableArray arrayWithCapacity:numberOfImportDataColumns];
+	NSMutableArray *setAssignments = [NSMutableArray array];
+
+	for (j = 0; j < numberOfImportDataColumns; j++) [columnTargets addObject:[NSMutableIndexSet indexSet]];
+
+	for (i = 0; i < (NSInteger)[fieldMappingArray count]; i++) {
+		if ([[fieldMapperOperator safeObjectAtIndex:i] integerValue] > 0) continue;
+
+		NSString *fieldName = [fieldMappingTableColumnNames safeObjectAtIndex:i];
+		NSInteger mapColumn = [[fieldMappingArray safeObjectAtIndex:i] integerValue];
+
+		if (mapColumn < 0 || mapColumn >= numberOfImportDataColumns) return nil;
+		if ([geometryFields containsObject:fieldName] || [bitFields containsObject:fieldName]) return nil;
+
+		[[columnTargets objectAtIndex:mapColumn] addIndex:i];
+	}
+
+	NSMutableArray *columnList = [NSMutableArray arrayWithCapacity:numberOfImportDataColumns];
+
+	for (j = 0; j < numberOfImportDataColumns; j++) {
+		NSIndexSet *targets = [columnTargets objectAtIndex:j];
+
+		if (![targets count]) {
+			[columnList addObject:@"@dummy"];
+			continue;
+		}
+
+		// A single plain column needs no variable
+		if ([targets count] == 1 && ![nullableNumericFieldsMapIndex containsIndex:[targets firstIndex]]) {
+			[columnList addObject:[[fieldMappingTableColumnNames safeObjectAtIndex:[targets firstIndex]] backtickQuotedString]];
+			continue;
+		}
+
+		NSString *variable = [NSString stringWithFormat:@"@column%ld", (long)(j + 1)];
+
+		[columnList addObject:variable];
+
+		[targets enumerateIndexesUsingBlock:^(NSUInteger targetIndex, BOOL *stop) {
+			NSString *target = [[self->fieldMappingTableColumnNames safeObjectAtIndex:targetIndex] backtickQuotedString];
+
+			// Empty strings are imported into nullable numeric columns as NULL
+			if ([self->nullableNumericFieldsMapIndex containsIndex:targetIndex]) {
+				[setAssignments addObject:[NSString stringWithFormat:@"%@ = NULLIF(%@, '')", target, variable]];
+			} else {
+				[setAssignments addObject:[NSString stringWithFormat:@"%@ = %@", target, variable]];
+			}
+		}];
+	}
+
+	// LOAD DATA takes the priority and duplicate handling of the INSERT or REPLACE chosen
+	NSMutableString *query = [NSMutableString stringWithString:@"LOAD DATA "];
+
+	if ([csvImportHeaderString rangeOfString:@"LOW_PRIORITY "].location != NSNotFound) [query appendString:@"LOW_PRIORITY "];
+
+	[query appendFormat:@"LOCAL INFILE %@ ", [SPCSVLoadDataImport quotedString:[filename lastPathComponent]]];
+
+	if ([csvImportHeaderString hasPrefix:@"REPLACE"]) {
+		[query appendString:@"REPLACE "];
+	} else if ([csvImportHeaderString rangeOfString:@"IGNORE "].location != NSNotFound) {
+		[query appendString:@"IGNORE "];
+	}
+
+	[query appendFormat:@"INTO TABLE %@ CHARACTER SET %@ %@", [selectedTableTarget backtickQuotedString], characterSet, formatClause];
+
+	if ([[importFieldNamesSwitch onMainThread] state] == NSControlStateValueOn) [query appendString:@" IGNORE 1 LINES"];
+
+	[query appendFormat:@" (%@)", [columnList componentsJoinedByString:@", "]];
+
+	if ([setAssignments count]) [query appendFormat:@" SET %@", [setAssignments componentsJoinedByString:@", "]];
+
+	return query;
+}
+
+/**
+ * Imports the CSV file with the LOAD DATA query, streaming it to the server from the start. Returns
+ * NO without importing anything if the server or connection won't accept local data, so the import
+ * can go on row by row; otherwise the import is over, and any error or warnings are added to the
+ * errors to show.
+ */
+- (BOOL)_loadCSVFile:(NSString *)filename withQuery:(NSString *)loadDataQuery databaseName:(NSString *)databaseName fileTotalLength:(NSUInteger)fileTotalLength errors:(NSMutableString *)errors rowsImported:(NSInteger *)rowsImported
+{
+	SPFileHandle *loadFileHandle = [SPFileHandle fileHandleForReadingAtPath:filename];
+
+	if (!loadFileHandle) return NO;
+
+	SPCSVLoadDataImport *loadDataImport = [[SPCSVLoadDataImport alloc] initWithConnection:mySQLConnection];
+
+	if (!loadDataImport) return NO;
+
+	BOOL fileIsCompressed = ([loadFileHandle compressionFormat] != SPNoCompression);
+	__block NSUInteger bytesRead = 0;
+
+	SPMainQSync(^{
+		[self->singleProgressText setStringValue:NSLocalizedString(@"Loading data...", @"text showing that the server is loading CSV data")];
+	});
+
+	BOOL loaded = [loadDataImport loadFileHandle:loadFileHandle withQuery:loadDataQuery inDatabase:databaseName chunkHandler:^BOOL(NSUInteger chunkLength, uint64_t readStart) {
+		[self _recordImportReadOfLength:chunkLength fromFileHandle:loadFileHandle startedAt:readStart];
+
+		bytesRead += chunkLength;
+
+		SPMainQSync(^{
+			if (fileIsCompressed) {
+				[self->singleProgressBar setDoubleValue:[loadFileHandle realDataReadLength]];
+				[self->singleProgressText setStringValue:[NSString stringWithFormat:NSLocalizedString(@"Imported %@ of CSV data", @"CSV import progress text where total size is unknown"), [NSByteCountFormatter stringWithByteSize:bytesRead]]];
+			} else {
+				[self->singleProgressBar setDoubleValue:bytesRead];
+				[self->singleProgressText setStringValue:[NSString stringWithFormat:NSLocalizedString(@"Imported %@ of %@", @"CSV import progress text"), [NSByteCountFormatter stringWithByteSize:bytesRead], [NSByteCountFormatter stringWithByteSize:fileTotalLength]]];
+			}
+		});
+
+		[self _updateImportStatisticsText];
+
+		return !self->progressCancelled;
+	}];
+
+	[loadFileHandle closeFile];
+
+	// Nothing was loaded if the server refused the data
+	if (!loaded && [loadDataImport localDataRejected]) {
+		[loadDataImport close];
+		return NO;
+	}
+
+	if (loaded) {
+		*rowsImported = (NSInteger)[loadDataImport rowsLoaded];
+		[importStatistics addRows:[loadDataImport rowsLoaded]];
+
+		// Rows the server skipped are only reported as warnings
+		for (NSString *warning in [loadDataImport warnings]) {
+			[errors appendFormat:NSLocalizedString(@"[WARNING] %@\n", @"warning text when loading a csv file skipped or changed rows"), warning];
+		}
+	}
+	else if (!progressCancelled) {
+		[errors appendFormat:NSLocalizedString(@"[ERROR] %@\n", @"error text when loading a csv file failed"), [loadDataImport lastErrorMessage]];
+
+		if (user_defaults_get_bool_ud(SPConsoleEnableImportExportLogging, prefs) == YES) {
+			[[SPQueryController sharedQueryController] showErrorInConsole:[loadDataImport lastErrorMessage] connection:mySQLConnection.host database:databaseName];
+		}
+	}
+
+	if ([errors length]) [[tableDocumentInstance onMainThread] showConsole];
+
+	[loadDataImport close];
+
+	return YES;
+}
+
+/**
+ * Returns an insert sending CSV rows as the values of prepared statements, if selected and if the
+ * field mapping only maps file columns and table defaults straight into table columns; global
+ * values are SQL of their own, and geometry and bit columns need their values wrapped in SQL.
+ *
+ * @param insertString The start of each INSERT, up to and including the VALUES keyword
+ */
+- (SPCSVPreparedInsert *)_preparedInsertWithInsertString:(NSString *)insertString
+{
+	if (importMethodIsUpdate || ![prefs boolForKey:SPCSVImportPreparedInserts]) return nil;
+	if ([geometryFieldsMapIndex count] || [bitFieldsMapIndex count]) return nil;
+
+	NSUInteger columnCount = 0;
+
+	for (NSUInteger i = 0; i < [fieldMappingArray count]; i++) {
+		if ([[fieldMapperOperator safeObjectAtIndex:i] integerValue] > 0) continue;
+
+		if (fieldMappingArrayHasGlobalVariables && [[fieldMappingArray safeObjectAtIndex:i] integerValue] >= numberOfImportDataColumns) return nil;
+
+		columnCount++;
+	}
+
+	if (!columnCount) return nil;
+
+	return [[SPCSVPreparedInsert alloc] initWithConnection:mySQLConnection insertString:insertString tailString:(csvImportMethodHasTail ? csvImportTailString : nil) columnCount:columnCount];
+}
+
+/**
+ * Adds the values of a CSV row to a prepared insert, based on the field mapping array; the values
+ * are those -mappedValueStringForRowArray: would quote, sent without quoting or escaping.
+ */
+- (void)_appendMappedRow:(NSArray *)csvRowArray toPreparedInsert:(SPCSVPreparedInsert *)preparedInsert
+{
+	NSUInteger mappingArrayCount = [fieldMappingArray count];
+
+	for (NSUInteger i = 0; i < mappingArrayCount; i++) {
+
+		// Skip unmapped columns
+		if ([[fieldMapperOperator safeObjectAtIndex:i] integerValue] > 0) continue;
+
+		id cellData = [csvRowArray safeObjectAtIndex:[[fieldMappingArray safeObjectAtIndex:i] integerValue]];
+
+		// If import column isn't specified import the table column default value
+		if ([cellData isSPNotLoaded]) cellData = [fieldMappingTableDefaultValues safeObjectAtIndex:i];
+
+		// Insert a NULL if the cell is an NSNull, or is a nullable numeric field and empty
+		if (!cellData || [cellData isNSNull] || ([nullableNumericFieldsMapIndex containsIndex:i] && [[cellData description] isEqualToString:@""])) {
+			[preparedInsert appendNull];
+		}
+		else {
+			[preparedInsert appendString:[cellData description]];
+		}
+	}
+}
+
+/**
+ * Reports a CSV file which couldn't be read in the encoding selected, and stops its import.
+ */
+- (void)_abortCSVImportOfFile:(NSString *)filename withEncodingError:(NSStringEncoding)csvEncoding rowsImported:(NSInteger)rowsImported
+{
+	[self _endImportSessionWithErrors:nil completed:NO];
+	[self _closeAndStopProgressSheet];
+	SPMainQSync(^{
+		NSString *displayEncoding;
+		if (![self->importEncodingPopup indexOfSelectedItem]) {
+			displayEncoding = [NSString stringWithFormat:@"%@ - %@", [self->importEncodingPopup titleOfSelectedItem], [NSString localizedNameOfStringEncoding:csvEncoding]];
+		} else {
+			displayEncoding = [NSString localizedNameOfStringEncoding:csvEncoding];
+		}
+		[NSAlert createWarningAlertWithTitle:SP_FILE_READ_ERROR_STRING message:[NSString stringWithFormat:NSLocalizedString(@"An error occurred when reading the file, as it could not be read using the encoding you selected (%@).\n\nOnly %ld rows were imported.", @"CSV encoding read error"), displayEncoding, (long)rowsImported] callback:nil];
+	});
+	[tableDocumentInstance setQueryMode:SPInterfaceQueryMode];
+	if([filename hasPrefix:SPImportClipboardTempFileNamePrefix])
+		[fileManager removeItemAtPath:filename error:nil];
+}
+
+/**
+ * Adds a failed statement of a SQL import to the errors and, unless errors are being ignored, asks
+ * whether to carry on; choosing to stop cancels the import.
+ */
+- (void)_handleSQLImportError:(NSString *)errorMessage errorID:(NSUInteger)errorID inQuery:(NSString *)query sequenceNumber:(NSUInteger)sequenceNumber errors:(NSMutableString *)errors ignoringSQLErrors:(BOOL *)ignoreSQLErrors ignoringCharsetError:(BOOL *)ignoreCharsetError
+{
+	[errors appendFormat:NSLocalizedString(@"[ERROR in query %ld] %@\n", @"error text when multiple custom query failed"), (long)sequenceNumber, errorMessage];
+
+	// if the error is about utf8mb4 not being supported by the server display a more helpful message.
+	// Note: the same error will occur when doing CREATE TABLE... with utf8mb4.
+	if(errorID == 1115 /* ER_UNKNOWN_CHARACTER_SET */ && [errorMessage rangeOfString:@"utf8mb4" options:NSCaseInsensitiveSearch].location != NSNotFound && [query rangeOfString:@"SET NAMES" options:NSCaseInsensitiveSearch].location != NSNotFound) {
+		if (!*ignoreCharsetError) {
+			__block NSInteger charsetErrorSheetReturnCode;
+
+			SPMainQSync(^{
+				NSAlert *charsetErrorAlert = [[NSAlert alloc] init];
+				[charsetErrorAlert setMessageText:NSLocalizedString(@"Incompatible encoding in SQL file", @"sql import error message")];
+				[charsetErrorAlert setInformativeText:NSLocalizedString(@"The SQL file uses utf8mb4 encoding, but your MySQL version only supports the limited utf8 subset.\n\nYou can continue the import, but any non-BMP characters in the SQL file (eg. some typographic and scientific special characters, archaic CJK logograms, emojis) will be unrecoverably lost!", @"sql import : charset error alert : detail message")];
+
+				// Order of buttons matters! first button has "firstButtonReturn" return value from runModal(), etc
+				[charsetErrorAlert addButtonWithTitle:NSLocalizedString(@"Import Anyway", @"sql import : charset error alert : continue button")];
+				[charsetErrorAlert addButtonWithTitle:NSLocalizedString(@"Cancel", @"cancel button")];
+
+				charsetErrorSheetReturnCode = [charsetErrorAlert runModal];
+			});
+
+			switch (charsetErrorSheetReturnCode) {
+					// don't display the message a second time
+				case NSAlertFirstButtonReturn:
+					*ignoreCharsetError = YES;
+					break;
+					// Otherwise, stop
+				default:
+					[errors appendString:NSLocalizedString(@"Import cancelled!\n", @"import cancelled message")];
+					progressCancelled = YES;
+			}
+		}
+	}
+	// If not set to ignore errors, ask what to do.  Use NSAlert rather than
+	// SPBeginWaitingAlertSheet as there is already a modal sheet in progress.
+	else if (!*ignoreSQLErrors) {
+		__block NSInteger sqlImportErrorSheetReturnCode;
+
+		SPMainQSync(^{
+			NSAlert *sqlErrorAlert = [[NSAlert alloc] init];
+			[sqlErrorAlert setMessageText:NSLocalizedString(@"An error occurred while importing SQL", @"sql import error message")];
+			[sqlErrorAlert setInformativeText:[NSString stringWithFormat:NSLocalizedString(@"[ERROR in query %ld] %@\n", @"error text when multiple custom query failed"), (long)sequenceNumber, errorMessage]];
+
+			// Order of buttons matters! first button has "firstButtonReturn" return value from runModal(), etc
+			[sqlErrorAlert addButtonWithTitle:NSLocalizedString(@"Continue", @"continue button")];
+			[sqlErrorAlert addButtonWithTitle:NSLocalizedString(@"Ignore All Errors", @"ignore errors button")];
+			[sqlErrorAlert addButtonWithTitle:NSLocalizedString(@"Stop", @"stop button")];
+
+			sqlImportErrorSheetReturnCode = [sqlErrorAlert runModal];
+		});
+
+		switch (sqlImportErrorSheetReturnCode) {
+			case NSAlertFirstButtonReturn: // On "continue", no additional action is required
+				break;
+			case NSAlertSecondButtonReturn: // Ignore all future errors if asked to
+				*ignoreSQLErrors = YES;
+				break;
+			default: // Otherwise, stop
+				[errors appendString:NSLocalizedString(@"Import cancelled!\n", @"import cancelled message")];
+				progressCancelled = YES;
+		}
+	}
+}
+
+/**
+ * Adds a statement sent to the server to the statistics, along with whether it failed.
+ */
+- (void)_recordImportQuery:(NSString *)query encoding:(NSStringEncoding)encoding startedAt:(uint64_t)start
+{
+	[self _recordImportStatementOfLength:[query lengthOfBytesUsingEncoding:encoding] startedAt:start];
+}
+
+/**
+ * Adds a statement of the supplied length in bytes, which has just run, to the statistics.
+ */
+- (void)_recordImportStatementOfLength:(NSUInteger)length startedAt:(uint64_t)start
+{
+	BOOL failed = [mySQLConnection queryErrored] && ![[mySQLConnection lastErrorMessage] isEqualToString:@"Query was empty"];
+
+	[importStatistics addNanoseconds:SPPipelineTimestamp() - start toStage:SPTransferServerStage];
+	[importStatistics addServerBytes:length];
+	[importStatistics addStatements:1 errors:failed ? 1 : 0];
+}
+
+/**
+ * Shows the statistics on the progress sheet, at most twice a second. A CSV import does everything
+ * on one thread, so time not spent reading or waiting on the server went on parsing; the SQL
+ * statement reader records its own parsing time, which overlaps with the server's.
+ */
+- (void)_updateImportStatisticsText
+{
+	CFAbsoluteTime now = CFAbsoluteTimeGetCurrent();
+
+	if ((now - importStatisticsUpdateTime) < 0.5) return;
+
+	importStatisticsUpdateTime = now;
+
+	[importStatistics addUnattributedTimeToStage:SPTransferEncodingStage];
+
+	NSString *summary = [importStatistics progressSummary];
+
+	// CSV imports also show how the INSERT batches are being sized
+	if ([csvBatchSizer measuredBatches]) {
+		summary = [summary stringByAppendingFormat:NSLocalizedString(@"\nBatches of %1$@ rows, %2$@ statements/s", @"CSV import statistics : batch size and statement rate line"),
+			[NSNumberFormatter localizedStringFromNumber:@([csvBatchSizer rowsPerBatch]) numberStyle:NSNumberFormatterDecimalStyle],
+			[NSNumberFormatter localizedStringFromNumber:@(round([importStatistics statementsPerSecond] * 10) / 10) numberStyle:NSNumberFormatterDecimalStyle]];
+	}
+
+	// A fast bulk load shows what it's gaining once it has been measured
+	NSString *bulkLoadSummary = [bulkLoadSession speedupSummary];
+	if (bulkLoadSummary) summary = [summary stringByAppendingFormat:@"\n%@", bulkLoadSummary];
+
+	[[singleProgressStatisticsText onMainThread] setStringValue:summary];
+}
+
+/**
+ * Stops the import statistics, saving them next to the imported file if reports are enabled.
+ */
+- (void)_finishImportStatisticsForFile:(NSString *)filename
+{
+	[importStatistics finish];
+	[importStatistics addUnattributedTimeToStage:SPTransferEncodingStage];
+
+	// Clipboard imports go through a temporary file, which is about to be removed
+	if ([prefs boolForKey:SPWriteTransferReports] && ![filename hasPrefix:SPImportClipboardTempFileNamePrefix]) {
+		[importStatistics writeReportForFileAtPath:filename];
+	}
+
+	importStatistics = nil;
+	csvBatchSizer = nil;
+
+	[[singleProgressStatisticsText onMainThread] setStringValue:@""];
+}
+
+/**
+ * Switches the import connection to fast bulk loading, if selected, for the rest of the import.
+ *
+ * @param calibrate Whether to import some rows normally first, to measure the speedup against
+ */
+- (void)_beginBulkLoadSessionCalibrating:(BOOL)calibrate
+{
+	if (bulkLoadSession || ![prefs boolForKey:SPImportFastBulkLoad]) return;
+
+	bulkLoadSession = [[SPImportBulkLoadSession alloc] initWithConnection:mySQLConnection statistics:importStatistics transactionRows:[prefs integerForKey:SPImportBulkLoadTransactionRows] calibrationRows:calibrate ? SPImportBulkLoadCalibrationRows : 0];
+}
+
+/**
+ * Ends an import's fast bulk load and checkpoint. The rest of a fast bulk load is committed and the
+ * connection's settings restored, adding a failed commit to the errors if supplied. An import which
+ * stopped early keeps its checkpoint, moved on to the last statement run if that was committed and
+ * isn't within a transaction still open on the server, so it can be resumed; one which completed no
+ * longer needs it.
+ *
+ * @return The speedup line for the import summary, or nil if there is none
+ */
+- (NSString *)_endImportSessionWithErrors:(NSMutableString *)errors completed:(BOOL)completed
+{
+	BOOL importCommitted = YES;
+	NSString *bulkLoadSummary = nil;
+
+	// Free any prepared statements on the server
+	[csvPreparedInsert close];
+	csvPreparedInsert = nil;
+
+	if (bulkLoadSession) {
+		importCommitted = [bulkLoadSession finish];
+
+		if (!importCommitted) {
+			[errors appendFormat:NSLocalizedString(@"[ERROR] The rows imported could not all be committed: %@\n", @"fast bulk load commit failed error message"), [bulkLoadSession lastErrorMessage]];
+		}
+
+		bulkLoadSummary = [bulkLoadSession speedupSummary];
+		bulkLoadSession = nil;
+	}
+
+	if (completed) {
+		[importCheckpoint removeCheckpoint];
+	}
+	else {
+		// Nothing run since a transaction the file started is committed yet
+		SPMySQLServerStatusBits serverStatus;
+
+		if (importCommitted && (![mySQLConnection updateServerStatusBits:&serverStatus] || serverStatus.inTransaction)) importCommitted = NO;
+
+		if (importCommitted) [importCheckpoint commitRecordedPosition];
+		[self _writeImportCheckpointImmediately:YES errors:errors];
+	}
+
+	importCheckpoint = nil;
+
+	return bulkLoadSummary;
+}
+
+/**
+ * Saves the import's checkpoint, straight away or if it's due, adding a warning to the errors the
+ * first time it can't be saved, as the import then can't be resumed from where it stops.
+ */
+- (void)_writeImportCheckpointImmediately:(BOOL)immediately errors:(NSMutableString *)errors
+{
+	if (!importCheckpoint) return;
+
+	if (immediately) [importCheckpoint writeCheckpoint];
+	else [importCheckpoint writeCheckpointIfDue];
+
+	if (![importCheckpoint writeError] || importCheckpointWriteFailed) return;
+
+	importCheckpointWriteFailed = YES;
+
+	NSString *reason = [[importCheckpoint writeError] localizedDescription];
+
+	[errors appendFormat:NSLocalizedString(@"[WARNING] The import checkpoint could not be saved, so this import can't be resumed if it stops: %@\n", @"import checkpoint could not be saved warning"), reason];
+
+	if (user_defaults_get_bool_ud(SPConsoleEnableImportExportLogging, prefs) == YES) {
+		[[SPQueryController sharedQueryController] showErrorInConsole:reason connection:mySQLConnection.host database:nil];
+	}
+}
+
+/**
+ * Looks for a checkpoint left by an earlier import of the file which stopped part way, and asks
+ * whether to carry on from there. Choosing to import the whole file again discards the checkpoint.
+ *
+ * @return Whether to resume from the checkpoint, which is then the import's checkpoint
+ */
+- (BOOL)_offerToResumeImportOfFile:(NSString *)filename format:(NSString *)format
+{
+	importCheckpoint = nil;
+	importCheckpointWriteFailed = NO;
+
+	if (![prefs boolForKey:SPImportCheckpoints] || [filename hasPrefix:SPImportClipboardTempFileNamePrefix]) return NO;
+
+	SPImportCheckpoint *checkpoint = [SPImportCheckpoint checkpointForImportFilePath:filename format:format];
+
+	if (![checkpoint position]) return NO;
+
+	NSString *stoppedAt;
+
+	if ([format isEqualToString:@"CSV"]) {
+		stoppedAt = [NSString stringWithFormat:NSLocalizedString(@"An earlier import of “%1$@” into %2$@ stopped after %3$@ rows.", @"resume CSV import message : file name, table name, row count"),
+			[filename lastPathComponent], [checkpoint tableName], [NSNumberFormatter localizedStringFromNumber:@([checkpoint position]) numberStyle:NSNumberFormatterDecimalStyle]];
+	}
+	else {
+		stoppedAt = [NSString stringWithFormat:NSLocalizedString(@"An earlier import of “%1$@” stopped after statement %2$@, %3$@ into the file.", @"resume SQL import message : file name, statement number, amount of SQL read"),
+			[filename lastPathComponent], [NSNumberFormatter localizedStringFromNumber:@([checkpoint position]) numberStyle:NSNumberFormatterDecimalStyle], [NSByteCountFormatter stringWithByteSize:(long long)[checkpoint offset]]];
+	}
+
+	__block NSModalResponse resumeResponse;
+
+	SPMainQSync(^{
+		NSAlert *resumeAlert = [[NSAlert alloc] init];
+		[resumeAlert setMessageText:NSLocalizedString(@"Resume import from checkpoint?", @"resume import title")];
+		[resumeAlert setInformativeText:[stoppedAt stringByAppendingFormat:@"\n\n%@", NSLocalizedString(@"You can carry on from there, or import the whole file again.", @"resume import informative message")]];
+
+		// Order of buttons matters! first button has "firstButtonReturn" return value from runModal(), etc
+		[resumeAlert addButtonWithTitle:NSLocalizedString(@"Resume", @"resume import button")];
+		[resumeAlert addButtonWithTitle:NSLocalizedString(@"Start Over", @"import whole file again button")];
+
+		resumeResponse = [resumeAlert runModal];
+	});
+
+	if (resumeResponse != NSAlertFirstButtonReturn) {
+		[checkpoint removeCheckpoint];
+		return NO;
+	}
+
+	importCheckpoint = checkpoint;
+
+	return YES;
+}
+
 /**
  * Tries to determine the line endings of the specified file using the 'file' command.
  */
@@ -32,6 +32,7 @@
 @class SPTableView;
 @class SPTablesList;
 @class SPMySQLConnection;
+@class SPCSVImportSampler;
 
 @interface SPFieldMapperController : NSWindowController <NSTokenFieldCellDelegate, NSMenuDelegate>
 {
@@ -128,6 +129,7 @@
 	NSString *databaseName;
 
 	NSString *sourcePath;
+	SPCSVImportSampler *importSampler;
 
 	NSUserDefaults *prefs;
 	
@@ -148,6 +150,7 @@
 
 @property (copy) NSString* sourcePath;
 @property (copy) NSString *databaseName;
+@property (strong) SPCSVImportSampler *importSampler;
 
 - (instancetype)initWithDelegate:(id)managerDelegate;
 
@@ -38,6 +38,8 @@
 #import "RegexKitLite.h"
 #import "SPDatabaseData.h"
 #import "SPFunctions.h"
+#import "SPCSVImportSampler.h"
+#import "SPCSVColumnProfile.h"
 #import <SPMySQL/SPMySQL.h>
 
 #import "sequel-ace-Swift.h"
@@ -50,8 +52,6 @@ static NSString *SPTableViewOperatorColumnID    = @"operator";
 static NSString *SPTableViewValueIndexColumnID  = @"value_index";
 static NSString *SPTableViewGlobalValueColumnID = @"global_value";
 static NSString *SPTableViewSqlColumnID         = @"sql";
-static NSUInteger SPSourceColumnTypeText        = 0;
-static NSUInteger SPSourceColumnTypeInteger     = 1;
 
 // Formal conformance for methods AppKit moved off the informal NSObject
 // categories; implementing them without it is deprecated. No behavior change.
@@ -63,6 +63,7 @@ static NSUInteger SPSourceColumnTypeInteger     = 1;
 
 @synthesize sourcePath;
 @synthesize databaseName;
+@synthesize importSampler;
 
 #pragma mark -
 #pragma mark Initialisation
@@ -809,34 +810,17 @@ static NSUInteger SPSourceColumnTypeInteger     = 1;
 	[newTableButton setHidden:YES];
 	[newTableNameTextField selectText:nil];
 
-	// Check length and type of fieldMappingImportArray values
-	NSInteger maxLengthOfSourceColumns [numberOfImportColumns];
-	NSUInteger typeOfSourceColumns [numberOfImportColumns];
+	// Check length and type of the source values, from the file's sample, which reaches further
+	// into the file, if there is one, or else from the rows shown
+	SPCSVColumnProfile *columnProfile = [importSampler columnProfileIncludingFirstRow:![self importFieldNamesHeader]];
 	NSInteger columnCounter;
+	NSUInteger i;
 
-	// Set up initial defaults for the column states
-	for (columnCounter = 0; columnCounter < numberOfImportColumns; columnCounter++) {
-		maxLengthOfSourceColumns[columnCounter] = 0;
-		typeOfSourceColumns[columnCounter] = SPSourceColumnTypeInteger;
-	}
-
-	// Step through the currently known data and get the types and values
-	NSUInteger i = ([self importFieldNamesHeader] ? 1 : 0);
-	NSArray *row;
-	id col;
-	for ( ; i < [fieldMappingImportArray count]; i++) {
-		row = [fieldMappingImportArray safeObjectAtIndex:i];
-		for (columnCounter = 0; columnCounter < numberOfImportColumns; columnCounter++) {
-			col = [row safeObjectAtIndex:columnCounter];
-			if(col && ![col isNSNull] && ![col isSPNotLoaded]) {
-				if([col isKindOfClass:[NSString class]] && maxLengthOfSourceColumns[columnCounter] < (NSInteger)[(NSString*)col length]) {
-					maxLengthOfSourceColumns[columnCounter] = [(NSString*)col length];
-				}
-				if(typeOfSourceColumns[columnCounter] == SPSourceColumnTypeInteger) {
-					if(![[[NSNumber numberWithLongLong:[col longLongValue]] stringValue] isEqualToString:col])
-					typeOfSourceColumns[columnCounter] = SPSourceColumnTypeText;
-				}
-			}
+	if ((NSInteger)[columnProfile columnCount] != numberOfImportColumns) {
+		columnProfile = [[SPCSVColumnProfile alloc] initWithColumnCount:numberOfImportColumns];
+
+		for (i = ([self importFieldNamesHeader] ? 1 : 0); i < [fieldMappingImportArray count]; i++) {
+			[columnProfile addRow:[fieldMappingImportArray safeObjectAtIndex:i]];
 		}
 	}
 
@@ -860,21 +844,23 @@ static NSUInteger SPSourceColumnTypeInteger     = 1;
 
 		[fieldMappingTableDefaultValues addObject:@""];
 
-		if (typeOfSourceColumns[columnCounter] == SPSourceColumnTypeInteger) {
-			if (maxLengthOfSourceColumns[columnCounter] < 9)
+		NSUInteger maxLengthOfSourceColumn = [columnProfile maxLengthOfColumn:columnCounter];
+
+		if ([columnProfile columnIsInteger:columnCounter]) {
+			if (maxLengthOfSourceColumn < 9)
 				[fieldMappingTableTypes addObject:@"INT(11)"];
 			else
 				[fieldMappingTableTypes addObject:@"BIGINT(11)"];
 		} else {
 			if (serverGreaterThanVersion4) {
-				if (maxLengthOfSourceColumns[columnCounter] < 256)
+				if (maxLengthOfSourceColumn < 256)
 					[fieldMappingTableTypes addObject:@"VARCHAR(255)"];
-				else if (maxLengthOfSourceColumns[columnCounter] < 32768)
+				else if (maxLengthOfSourceColumn < 32768)
 					[fieldMappingTableTypes addObject:@"VARCHAR(32767)"];
 				else
 					[fieldMappingTableTypes addObject:@"TEXT"];
 			} else {
-				if (maxLengthOfSourceColumns[columnCounter] < 256)
+				if (maxLengthOfSourceColumn < 256)
 					[fieldMappingTableTypes addObject:@"VARCHAR(255)"];
 				else
 					[fieldMappingTableTypes addObject:@"TEXT"];
@@ -0,0 +1,82 @@
+//
+//  SPImportBatchSizer.h
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+
+/**
+ * @class SPImportBatchSizer SPImportBatchSizer.h
+ *
+ * Decides how many rows go into each multi-row INSERT of a CSV import.
+ *
+ * A batch is limited in two ways: by length, to a fraction of the connection's max_allowed_packet
+ * so it never has to be raised mid-import, and by row count, which is tuned after every batch from
+ * the time the server took per row so each statement takes roughly the target time. Narrow rows
+ * therefore go in large batches, while wide rows stop at the length limit well before they would
+ * make the server reject or the client resize the packet.
+ *
+ * Batches run as prepared statements need a statement for each row count, so for those the row
+ * count can be kept to powers of two, letting a handful of statements serve the whole import.
+ */
+@interface SPImportBatchSizer : NSObject
+{
+	NSUInteger rowsPerBatch;
+	NSUInteger maxBatchLength;
+	uint64_t targetNanoseconds;
+	double nanosecondsPerRow;
+	NSUInteger measuredBatches;
+	BOOL roundsRowsToPowersOfTwo;
+}
+
+/**
+ * @property rowsPerBatch The number of rows the next batch may hold
+ */
+@property (readonly, assign) NSUInteger rowsPerBatch;
+
+/**
+ * @property maxBatchLength The number of bytes the next batch's query may take up
+ */
+@property (readonly, assign) NSUInteger maxBatchLength;
+
+/**
+ * @property measuredBatches The number of batches the row count has been tuned from
+ */
+@property (readonly, assign) NSUInteger measuredBatches;
+
+/**
+ * @property roundsRowsToPowersOfTwo Whether the row count is always a power of two
+ */
+@property (readwrite, assign, nonatomic) BOOL roundsRowsToPowersOfTwo;
+
+- (instancetype)initWithMaxQuerySize:(NSUInteger)maxQuerySize targetNanoseconds:(uint64_t)nanoseconds;
+
+- (void)recordBatchOfRows:(NSUInteger)rowCount duration:(uint64_t)nanoseconds;
+
+- (NSUInteger)readChunkLength;
+
+@end
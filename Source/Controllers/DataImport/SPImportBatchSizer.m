@@ -0,0 +1,132 @@
+//
+//  SPImportBatchSizer.m
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+
+#import "SPImportBatchSizer.h"
+
+// Share of max_allowed_packet a batch may use, leaving room for the INSERT header and any tail
+static const double SPImportBatchPacketShare = 0.75;
+
+// Even with a very large max_allowed_packet, batches past this length only hold the server up
+static const NSUInteger SPImportBatchMaxLength = 64 * 1024 * 1024;
+static const NSUInteger SPImportBatchMinLength = 16 * 1024;
+
+static const NSUInteger SPImportBatchInitialRows = 1000;
+static const NSUInteger SPImportBatchMinRows = 10;
+static const NSUInteger SPImportBatchMaxRows = 100000;
+
+// The row count limits when it's kept to powers of two
+static const NSUInteger SPImportBatchMinPowerOfTwoRows = 16;
+static const NSUInteger SPImportBatchMaxPowerOfTwoRows = 65536;
+
+static const NSUInteger SPImportMinReadChunkLength = 256 * 1024;
+static const NSUInteger SPImportMaxReadChunkLength = 4 * 1024 * 1024;
+
+/**
+ * Returns the power of two nearest the supplied row count, within the limits for a row count.
+ */
+static NSUInteger _SPNearestPowerOfTwoRows(NSUInteger rowCount)
+{
+	NSUInteger powerOfTwo = SPImportBatchMinPowerOfTwoRows;
+
+	// Round up past the halfway point between neighbouring powers of two
+	while (powerOfTwo < SPImportBatchMaxPowerOfTwoRows && rowCount >= powerOfTwo + powerOfTwo / 2) powerOfTwo *= 2;
+
+	return powerOfTwo;
+}
+
+@implementation SPImportBatchSizer
+
+@synthesize rowsPerBatch;
+@synthesize maxBatchLength;
+@synthesize measuredBatches;
+@synthesize roundsRowsToPowersOfTwo;
+
+/**
+ * Initialise a sizer for a connection with the supplied maximum query size, aiming for each
+ * batch to take the supplied time on the server.
+ */
+- (instancetype)initWithMaxQuerySize:(NSUInteger)maxQuerySize targetNanoseconds:(uint64_t)nanoseconds
+{
+	if ((self = [super init])) {
+		rowsPerBatch = SPImportBatchInitialRows;
+		maxBatchLength = MAX(MIN((NSUInteger)(maxQuerySize * SPImportBatchPacketShare), SPImportBatchMaxLength), SPImportBatchMinLength);
+		targetNanoseconds = nanoseconds;
+		nanosecondsPerRow = 0;
+		measuredBatches = 0;
+	}
+
+	return self;
+}
+
+/**
+ * Tunes the row count from a batch which ran successfully. The time per row is smoothed over
+ * recent batches, and the row count moves at most a factor of two each time, so a single slow
+ * statement - say, one which waited on a lock - doesn't swing the batch size about. A batch
+ * short of the row count stopped at the length limit or the end of the data, so gives no
+ * reason to allow more rows.
+ */
+- (void)recordBatchOfRows:(NSUInteger)rowCount duration:(uint64_t)nanoseconds
+{
+	if (!rowCount || !targetNanoseconds) return;
+
+	double sample = nanoseconds / (double)rowCount;
+
+	nanosecondsPerRow = nanosecondsPerRow ? (nanosecondsPerRow + sample) / 2 : sample;
+
+	double idealRows = nanosecondsPerRow > 0 ? targetNanoseconds / nanosecondsPerRow : SPImportBatchMaxRows;
+	NSUInteger nextRows = (NSUInteger)MIN(MAX(idealRows, rowsPerBatch / 2.0), rowsPerBatch * 2.0);
+
+	if (rowCount < rowsPerBatch && nextRows > rowsPerBatch) nextRows = rowsPerBatch;
+
+	rowsPerBatch = MAX(MIN(nextRows, SPImportBatchMaxRows), SPImportBatchMinRows);
+	if (roundsRowsToPowersOfTwo) rowsPerBatch = _SPNearestPowerOfTwoRows(rowsPerBatch);
+	measuredBatches++;
+}
+
+/**
+ * Sets whether the row count is kept to powers of two, rounding the current count if so.
+ */
+- (void)setRoundsRowsToPowersOfTwo:(BOOL)roundRows
+{
+	roundsRowsToPowersOfTwo = roundRows;
+
+	if (roundsRowsToPowersOfTwo) rowsPerBatch = _SPNearestPowerOfTwoRows(rowsPerBatch);
+}
+
+/**
+ * Returns how much of the file to read at a time, enough to fill a good part of a batch.
+ */
+- (NSUInteger)readChunkLength
+{
+	return MAX(MIN(maxBatchLength / 2, SPImportMaxReadChunkLength), SPImportMinReadChunkLength);
+}
+
+@end
@@ -0,0 +1,98 @@
+//
+//  SPImportBulkLoadSession.h
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import <SPMySQL/SPMySQL.h>
+
+@class SPTransferStatistics;
+
+/**
+ * @class SPImportBulkLoadSession SPImportBulkLoadSession.h
+ *
+ * Switches an import connection into a fast bulk-loading mode for the length of an import, and
+ * back again afterwards.
+ *
+ * While loading, unique_checks and foreign_key_checks are turned off, as is sql_log_bin where the
+ * user is allowed to change it, and autocommit is replaced by a commit every so many rows. The
+ * table being loaded can also have its non-unique indexes disabled, where it is a MyISAM table,
+ * so they are rebuilt once at the end. The session's original settings are read before anything
+ * is changed and put back when the session finishes, however the import ends.
+ *
+ * The import first runs normally for a short calibration of rows, so the server time per row
+ * with and without the session can be compared to show what it gained.
+ */
+@interface SPImportBulkLoadSession : NSObject
+{
+	SPMySQLConnection *connection;
+	SPTransferStatistics *statistics;
+
+	NSUInteger transactionRows;
+	NSUInteger calibrationRows;
+	NSString *disableKeysTable;
+	NSString *disableKeysDatabase;
+	BOOL keysDisabled;
+
+	NSMutableDictionary *originalSettings;
+	NSMutableArray *restoreStatements;
+	NSMutableArray *sessionStatements;
+	BOOL started;
+	BOOL finished;
+	NSString *lastErrorMessage;
+
+	uint64_t calibrationStartRows;
+	uint64_t calibrationStartNanoseconds;
+	BOOL calibrationStarted;
+	uint64_t baselineRows;
+	uint64_t baselineNanoseconds;
+	uint64_t bulkStartRows;
+	uint64_t bulkStartNanoseconds;
+	uint64_t bulkRows;
+	uint64_t bulkNanoseconds;
+	uint64_t rowsAtLastCommit;
+}
+
+/**
+ * @property started Whether the connection has been switched into bulk-loading mode
+ */
+@property (readonly, assign) BOOL started;
+
++ (double)speedupWithBaselineRows:(uint64_t)normalRows nanoseconds:(uint64_t)normalNanoseconds bulkRows:(uint64_t)fastRows nanoseconds:(uint64_t)fastNanoseconds;
+
+- (instancetype)initWithConnection:(SPMySQLConnection *)aConnection statistics:(SPTransferStatistics *)transferStatistics transactionRows:(NSUInteger)rowsPerTransaction calibrationRows:(NSUInteger)rowsToCalibrate;
+
+- (void)disableKeysForTable:(NSString *)table inDatabase:(NSString *)databaseName;
+- (BOOL)checkpoint;
+- (NSArray *)sessionStatements;
+- (BOOL)finish;
+- (NSString *)lastErrorMessage;
+
+- (double)speedup;
+- (NSString *)speedupSummary;
+
+@end
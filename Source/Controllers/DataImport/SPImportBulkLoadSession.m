@@ -0,0 +1,304 @@
+//
+//  SPImportBulkLoadSession.m
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPImportBulkLoadSession.h"
+#import "SPTransferStatistics.h"
+#import "SPBoundedQueue.h"
+
+// The session variables turned off while loading, in the order they are changed; sql_log_bin comes
+// first as it can't be changed once a transaction has begun
+static NSString * const SPImportBulkLoadVariables[] = { @"sql_log_bin", @"unique_checks", @"foreign_key_checks", @"autocommit" };
+static const NSUInteger SPImportBulkLoadVariableCount = 4;
+
+@interface SPImportBulkLoadSession ()
+
+- (void)_start;
+- (BOOL)_runTimedQuery:(NSString *)query;
+- (uint64_t)_serverNanoseconds;
+
+@end
+
+@implementation SPImportBulkLoadSession
+
+@synthesize started;
+
+/**
+ * Returns how many times faster rows loaded with the session than without, from the server time
+ * taken by each, or 0 if either wasn't measured.
+ */
++ (double)speedupWithBaselineRows:(uint64_t)normalRows nanoseconds:(uint64_t)normalNanoseconds bulkRows:(uint64_t)fastRows nanoseconds:(uint64_t)fastNanoseconds
+{
+	if (!normalRows || !normalNanoseconds || !fastRows || !fastNanoseconds) return 0;
+
+	return ((double)normalNanoseconds / normalRows) / ((double)fastNanoseconds / fastRows);
+}
+
+/**
+ * Initialise a session for the supplied import connection, reading the settings it will need to
+ * restore. Nothing is changed until the calibration rows have loaded, or straight away if there
+ * are none.
+ *
+ * @param aConnection         The import connection
+ * @param transferStatistics  The import's statistics, which the rows loaded and server time are read from
+ * @param rowsPerTransaction  The number of rows to load between commits
+ * @param rowsToCalibrate     The number of rows to load normally first, to compare against
+ */
+- (instancetype)initWithConnection:(SPMySQLConnection *)aConnection statistics:(SPTransferStatistics *)transferStatistics transactionRows:(NSUInteger)rowsPerTransaction calibrationRows:(NSUInteger)rowsToCalibrate
+{
+	if ((self = [super init])) {
+		connection = aConnection;
+		statistics = transferStatistics;
+		transactionRows = MAX(rowsPerTransaction, (NSUInteger)1);
+		calibrationRows = rowsToCalibrate;
+		originalSettings = [[NSMutableDictionary alloc] init];
+		restoreStatements = [[NSMutableArray alloc] init];
+		sessionStatements = [[NSMutableArray alloc] init];
+
+		// Read the current settings now, as an SQL file may change them itself before loading starts
+		for (NSUInteger i = 0; i < SPImportBulkLoadVariableCount; i++)
+		{
+			id value = [connection getFirstFieldFromQuery:[NSString stringWithFormat:@"SELECT @@SESSION.%@", SPImportBulkLoadVariables[i]]];
+
+			if ([connection queryErrored] || ![value respondsToSelector:@selector(integerValue)]) continue;
+
+			[originalSettings setObject:@([value integerValue]) forKey:SPImportBulkLoadVariables[i]];
+		}
+
+		if (!calibrationRows) [self _start];
+	}
+
+	return self;
+}
+
+/**
+ * Asks for the supplied table's non-unique indexes to be disabled while loading, if it is a
+ * MyISAM table; other engines ignore DISABLE KEYS.
+ */
+- (void)disableKeysForTable:(NSString *)table inDatabase:(NSString *)databaseName
+{
+	disableKeysTable = [table copy];
+	disableKeysDatabase = [databaseName copy];
+
+	// Loading may already have begun
+	if (started && !finished && !keysDisabled) {
+		NSString *engine = [connection getFirstFieldFromQuery:[NSString stringWithFormat:@"SELECT ENGINE FROM information_schema.TABLES WHERE TABLE_SCHEMA = %@ AND TABLE_NAME = %@", [connection escapeAndQuoteString:disableKeysDatabase], [connection escapeAndQuoteString:disableKeysTable]]];
+
+		if ([engine isKindOfClass:[NSString class]] && [engine caseInsensitiveCompare:@"MyISAM"] == NSOrderedSame) {
+			keysDisabled = [self _runTimedQuery:[NSString stringWithFormat:@"ALTER TABLE %@.%@ DISABLE KEYS", [disableKeysDatabase backtickQuotedString], [disableKeysTable backtickQuotedString]]];
+		}
+	}
+}
+
+/**
+ * Called after each statement of the import has run. Once the calibration rows have loaded the
+ * session is started, and after that the open transaction is committed every time enough rows
+ * have been loaded.
+ *
+ * @return Whether everything imported so far has been committed
+ */
+- (BOOL)checkpoint
+{
+	if (finished) return NO;
+
+	uint64_t rows = [statistics rows];
+
+	if (!started) {
+
+		// The calibration starts from the first rows loaded, leaving out any tables being created
+		if (!calibrationStarted) {
+			if (!rows) return YES;
+
+			calibrationStarted = YES;
+			calibrationStartRows = rows;
+			calibrationStartNanoseconds = [self _serverNanoseconds];
+
+			return YES;
+		}
+
+		if (rows - calibrationStartRows < calibrationRows) return YES;
+
+		baselineRows = rows - calibrationStartRows;
+		baselineNanoseconds = [self _serverNanoseconds] - calibrationStartNanoseconds;
+
+		[self _start];
+
+		return YES;
+	}
+
+	if (rows - rowsAtLastCommit < transactionRows) return NO;
+
+	BOOL committed = [self _runTimedQuery:@"COMMIT"];
+
+	if (!committed && !lastErrorMessage) lastErrorMessage = [connection lastErrorMessage];
+
+	rowsAtLastCommit = rows;
+
+	return committed;
+}
+
+/**
+ * Returns the statements which put another connection into the same mode, leaving out autocommit
+ * as nothing would commit on it; empty until the session has started.
+ */
+- (NSArray *)sessionStatements
+{
+	return [sessionStatements copy];
+}
+
+/**
+ * Commits anything still uncommitted, rebuilds any disabled indexes and puts the connection's
+ * settings back. A connection lost during the import loses only what was left uncommitted.
+ *
+ * @return NO if a commit failed, with the reason in lastErrorMessage
+ */
+- (BOOL)finish
+{
+	if (finished) return !lastErrorMessage;
+
+	finished = YES;
+
+	if (!started) return YES;
+
+	if ([connection isConnected]) {
+		if (![self _runTimedQuery:@"COMMIT"] && !lastErrorMessage) lastErrorMessage = [connection lastErrorMessage];
+
+		// Rebuilding the indexes is part of what the load cost
+		if (keysDisabled) {
+			[self _runTimedQuery:[NSString stringWithFormat:@"ALTER TABLE %@.%@ ENABLE KEYS", [disableKeysDatabase backtickQuotedString], [disableKeysTable backtickQuotedString]]];
+		}
+
+		for (NSString *restoreStatement in [restoreStatements reverseObjectEnumerator])
+		{
+			[connection queryString:restoreStatement];
+		}
+	}
+	else if (!lastErrorMessage) {
+		lastErrorMessage = NSLocalizedString(@"The connection to the server was lost.", @"fast bulk load connection lost error message");
+	}
+
+	bulkRows = [statistics rows] - bulkStartRows;
+	bulkNanoseconds = [self _serverNanoseconds] - bulkStartNanoseconds;
+
+	return !lastErrorMessage;
+}
+
+/**
+ * Returns the message of the first commit which failed, if any.
+ */
+- (NSString *)lastErrorMessage
+{
+	return lastErrorMessage;
+}
+
+/**
+ * Returns how many times faster rows have loaded since the session started than during the
+ * calibration, or 0 if it hasn't been measured.
+ */
+- (double)speedup
+{
+	if (!started) return 0;
+
+	if (finished) {
+		return [SPImportBulkLoadSession speedupWithBaselineRows:baselineRows nanoseconds:baselineNanoseconds bulkRows:bulkRows nanoseconds:bulkNanoseconds];
+	}
+
+	return [SPImportBulkLoadSession speedupWithBaselineRows:baselineRows nanoseconds:baselineNanoseconds bulkRows:[statistics rows] - bulkStartRows nanoseconds:[self _serverNanoseconds] - bulkStartNanoseconds];
+}
+
+/**
+ * Returns a line describing the speedup for the import summary, or nil if it hasn't been measured.
+ */
+- (NSString *)speedupSummary
+{
+	double measuredSpeedup = [self speedup];
+
+	if (measuredSpeedup <= 0) return nil;
+
+	return [NSString stringWithFormat:NSLocalizedString(@"Fast bulk load: %@× the speed of a normal import", @"import summary : fast bulk load speedup"),
+		[NSNumberFormatter localizedStringFromNumber:@(round(measuredSpeedup * 10) / 10) numberStyle:NSNumberFormatterDecimalStyle]];
+}
+
+#pragma mark -
+#pragma mark Private API
+
+/**
+ * Turns off the checks and autocommit, keeping whichever the user is allowed to change, and
+ * disables the indexes of the table being loaded if asked to.
+ */
+- (void)_start
+{
+	started = YES;
+	bulkStartRows = rowsAtLastCommit = [statistics rows];
+	bulkStartNanoseconds = [self _serverNanoseconds];
+
+	for (NSUInteger i = 0; i < SPImportBulkLoadVariableCount; i++)
+	{
+		NSNumber *originalValue = [originalSettings objectForKey:SPImportBulkLoadVariables[i]];
+
+		if (!originalValue) continue;
+
+		NSString *statement = [NSString stringWithFormat:@"SET SESSION %@ = 0", SPImportBulkLoadVariables[i]];
+
+		// Changing sql_log_bin needs SUPER or SYSTEM_VARIABLES_ADMIN, so may well be refused
+		[connection queryString:statement];
+
+		if ([connection queryErrored]) continue;
+
+		[restoreStatements addObject:[NSString stringWithFormat:@"SET SESSION %@ = %@", SPImportBulkLoadVariables[i], originalValue]];
+
+		if (![SPImportBulkLoadVariables[i] isEqualToString:@"autocommit"]) [sessionStatements addObject:statement];
+	}
+
+	if (disableKeysTable) [self disableKeysForTable:disableKeysTable inDatabase:disableKeysDatabase];
+}
+
+/**
+ * Runs a query the import is waiting on, counting its time as server time.
+ */
+- (BOOL)_runTimedQuery:(NSString *)query
+{
+	uint64_t queryStart = SPPipelineTimestamp();
+
+	[connection queryString:query];
+
+	[statistics addNanoseconds:SPPipelineTimestamp() - queryStart toStage:SPTransferServerStage];
+
+	return ![connection queryErrored];
+}
+
+/**
+ * Returns the time spent waiting on the server so far.
+ */
+- (uint64_t)_serverNanoseconds
+{
+	return [statistics nanosecondsInStage:SPTransferServerStage];
+}
+
+@end
@@ -0,0 +1,143 @@
+//
+//  SPImportCheckpoint.h
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+/**
+ * @class SPImportCheckpoint SPImportCheckpoint.h
+ *
+ * Records how far an import has got, in a checkpoint file kept in the application support folder, so
+ * an import which stops part way - cancelled, or losing its connection - can later carry on from there
+ * rather than starting again. The sandbox only allows reading the imported file itself, so the
+ * checkpoint is named after a hash of the file's path, size and modification date instead of being
+ * stored next to it.
+ *
+ * A SQL import records the offset into the (uncompressed) SQL just after the last statement run, the
+ * number of statements run, the delimiter in effect and the session settings made so far, which a
+ * resumed import has to make again. A CSV import records the number of rows imported and the target
+ * table. Positions are recorded as statements run, but only saved once they have been committed, so
+ * a resumed import never skips rows the server didn't keep. The checkpoint also records the file's
+ * size and modification date, and isn't offered for a file which has changed since.
+ */
+@interface SPImportCheckpoint : NSObject
+{
+	NSString *importFilePath;
+	NSString *importFormat;
+	NSStringEncoding encoding;
+	unsigned long long fileSize;
+	NSDate *fileModificationDate;
+	NSString *checkpointPath;
+	NSString *tableName;
+
+	NSMutableArray *sessionStatements;
+
+	NSUInteger position;
+	unsigned long long offset;
+	unsigned long long storedOffset;
+	NSString *delimiter;
+	NSString *databaseName;
+	NSUInteger sessionStatementCount;
+
+	NSUInteger recordedPosition;
+	unsigned long long recordedOffset;
+	unsigned long long recordedStoredOffset;
+	NSString *recordedDelimiter;
+	NSString *recordedDatabaseName;
+
+	BOOL changedSinceWrite;
+	CFAbsoluteTime lastWriteTime;
+	NSError *writeError;
+}
+
+/**
+ * @property importFilePath The path of the file being imported
+ */
+@property (readonly, copy) NSString *importFilePath;
+
+/**
+ * @property importFormat The import format (SQL or CSV) the checkpoint belongs to
+ */
+@property (readonly, copy) NSString *importFormat;
+
+/**
+ * @property encoding The encoding the file was read in, which a resumed import has to use too
+ */
+@property (readonly, assign) NSStringEncoding encoding;
+
+/**
+ * @property tableName The table a CSV import was loading
+ */
+@property (readwrite, copy) NSString *tableName;
+
+/**
+ * @property position The number of statements run, or CSV rows imported, as of the checkpoint
+ */
+@property (readonly, assign) NSUInteger position;
+
+/**
+ * @property offset The offset into the uncompressed file just after the checkpoint
+ */
+@property (readonly, assign) unsigned long long offset;
+
+/**
+ * @property storedOffset The offset into the file as stored on disk, which differs from the offset
+ * for compressed files
+ */
+@property (readonly, assign) unsigned long long storedOffset;
+
+/**
+ * @property delimiter The SQL delimiter in effect at the checkpoint
+ */
+@property (readonly, copy) NSString *delimiter;
+
+/**
+ * @property databaseName The database in use at the checkpoint
+ */
+@property (readonly, copy) NSString *databaseName;
+
+/**
+ * @property writeError The reason the checkpoint last failed to save, or nil if it was saved
+ */
+@property (readonly, strong) NSError *writeError;
+
++ (NSString *)checkpointPathForImportFilePath:(NSString *)path;
++ (SPImportCheckpoint *)checkpointForImportFilePath:(NSString *)path format:(NSString *)format;
+
+- (instancetype)initWithImportFilePath:(NSString *)path format:(NSString *)format encoding:(NSStringEncoding)fileEncoding;
+
+- (NSArray *)sessionStatements;
+
+- (void)recordPosition:(NSUInteger)newPosition offset:(unsigned long long)newOffset storedOffset:(unsigned long long)newStoredOffset delimiter:(NSString *)newDelimiter databaseName:(NSString *)newDatabaseName;
+- (void)recordSessionStatement:(NSString *)query;
+- (void)commitRecordedPosition;
+
+- (BOOL)writeCheckpointIfDue;
+- (BOOL)writeCheckpoint;
+- (void)removeCheckpoint;
+
+@end
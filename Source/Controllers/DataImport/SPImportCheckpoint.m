@@ -0,0 +1,337 @@
+//
+//  SPImportCheckpoint.m
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPImportCheckpoint.h"
+
+static NSString *SPImportCheckpointExtension = @"checkpoint";
+static const NSInteger SPImportCheckpointVersion = 1;
+
+// Checkpoints are saved at most this often while an import runs
+static const CFAbsoluteTime SPImportCheckpointWriteInterval = 2.0;
+
+static NSString *SPImportCheckpointVersionKey            = @"version";
+static NSString *SPImportCheckpointFormatKey             = @"format";
+static NSString *SPImportCheckpointEncodingKey           = @"encoding";
+static NSString *SPImportCheckpointFileSizeKey           = @"fileBytes";
+static NSString *SPImportCheckpointModificationDateKey   = @"fileModified";
+static NSString *SPImportCheckpointTableKey              = @"table";
+static NSString *SPImportCheckpointPositionKey           = @"position";
+static NSString *SPImportCheckpointOffsetKey             = @"offset";
+static NSString *SPImportCheckpointStoredOffsetKey       = @"storedOffset";
+static NSString *SPImportCheckpointDelimiterKey          = @"delimiter";
+static NSString *SPImportCheckpointDatabaseKey           = @"database";
+static NSString *SPImportCheckpointSessionStatementsKey  = @"sessionStatements";
+
+@interface SPImportCheckpoint ()
+
++ (NSString *)_checkpointPathForImportFilePath:(NSString *)path fileSize:(unsigned long long)size modificationDate:(NSDate *)modificationDate createFolder:(BOOL)create error:(NSError **)error;
+- (BOOL)_readFileAttributes;
+
+@end
+
+@implementation SPImportCheckpoint
+
+@synthesize importFilePath;
+@synthesize importFormat;
+@synthesize encoding;
+@synthesize tableName;
+@synthesize position;
+@synthesize offset;
+@synthesize storedOffset;
+@synthesize delimiter;
+@synthesize databaseName;
+@synthesize writeError;
+
+#pragma mark -
+#pragma mark Initialisation
+
+/**
+ * Returns the path of the checkpoint kept for the supplied import file as it is now.
+ *
+ * @param path The path of the import file
+ *
+ * @return The checkpoint path, or nil if the file or the checkpoints folder can't be found
+ */
++ (NSString *)checkpointPathForImportFilePath:(NSString *)path
+{
+	NSDictionary *attributes = [[NSFileManager defaultManager] attributesOfItemAtPath:path error:NULL];
+
+	if (!attributes) return nil;
+
+	return [self _checkpointPathForImportFilePath:path fileSize:[[attributes objectForKey:NSFileSize] unsignedLongLongValue] modificationDate:[attributes objectForKey:NSFileModificationDate] createFolder:NO error:NULL];
+}
+
+/**
+ * Loads the checkpoint saved by an earlier import of the supplied file in the supplied format.
+ *
+ * @param path   The path of the import file
+ * @param format The import format (SQL or CSV)
+ *
+ * @return The checkpoint, or nil if there is none or the file has changed since it was saved
+ */
++ (SPImportCheckpoint *)checkpointForImportFilePath:(NSString *)path format:(NSString *)format
+{
+	NSString *checkpointPath = [self checkpointPathForImportFilePath:path];
+
+	if (!checkpointPath) return nil;
+
+	NSData *checkpointData = [NSData dataWithContentsOfFile:checkpointPath];
+
+	if (!checkpointData) return nil;
+
+	NSDictionary *saved = [NSPropertyListSerialization propertyListWithData:checkpointData options:NSPropertyListImmutable format:NULL error:NULL];
+
+	if (![saved isKindOfClass:[NSDictionary class]] || [[saved objectForKey:SPImportCheckpointVersionKey] integerValue] != SPImportCheckpointVersion) return nil;
+	if (![[saved objectForKey:SPImportCheckpointFormatKey] isEqual:format]) return nil;
+
+	SPImportCheckpoint *checkpoint = [[SPImportCheckpoint alloc] initWithImportFilePath:path format:format encoding:[[saved objectForKey:SPImportCheckpointEncodingKey] unsignedIntegerValue]];
+
+	if (!checkpoint
+		|| checkpoint->fileSize != [[saved objectForKey:SPImportCheckpointFileSizeKey] unsignedLongLongValue]
+		|| ![checkpoint->fileModificationDate isEqual:[saved objectForKey:SPImportCheckpointModificationDateKey]]) return nil;
+
+	id savedSessionStatements = [saved objectForKey:SPImportCheckpointSessionStatementsKey];
+
+	if ([savedSessionStatements isKindOfClass:[NSArray class]]) {
+		for (id statement in savedSessionStatements)
+		{
+			if ([statement isKindOfClass:[NSString class]]) [checkpoint->sessionStatements addObject:statement];
+		}
+	}
+
+	[checkpoint setTableName:[saved objectForKey:SPImportCheckpointTableKey]];
+	[checkpoint recordPosition:[[saved objectForKey:SPImportCheckpointPositionKey] unsignedIntegerValue]
+	                    offset:[[saved objectForKey:SPImportCheckpointOffsetKey] unsignedLongLongValue]
+	              storedOffset:[[saved objectForKey:SPImportCheckpointStoredOffsetKey] unsignedLongLongValue]
+	                 delimiter:[saved objectForKey:SPImportCheckpointDelimiterKey]
+	              databaseName:[saved objectForKey:SPImportCheckpointDatabaseKey]];
+	[checkpoint commitRecordedPosition];
+
+	checkpoint->changedSinceWrite = NO;
+
+	return checkpoint;
+}
+
+/**
+ * Initialise an empty checkpoint, at the start of the supplied import file.
+ *
+ * @param path         The path of the import file
+ * @param format       The import format (SQL or CSV)
+ * @param fileEncoding The encoding the file is being read in
+ *
+ * @return The initialised instance, or nil if the file can't be found
+ */
+- (instancetype)initWithImportFilePath:(NSString *)path format:(NSString *)format encoding:(NSStringEncoding)fileEncoding
+{
+	if ((self = [super init])) {
+		importFilePath = [path copy];
+		importFormat = [format copy];
+		encoding = fileEncoding;
+		sessionStatements = [[NSMutableArray alloc] init];
+
+		if (![self _readFileAttributes]) return nil;
+	}
+
+	return self;
+}
+
+#pragma mark -
+#pragma mark Recording
+
+/**
+ * Returns the session settings made up to the checkpoint, in order.
+ */
+- (NSArray *)sessionStatements
+{
+	return [sessionStatements subarrayWithRange:NSMakeRange(0, sessionStatementCount)];
+}
+
+/**
+ * Records how far the import has got; this only becomes the checkpoint once committed.
+ *
+ * @param newPosition     The number of statements run, or CSV rows imported
+ * @param newOffset       The offset into the uncompressed file just after them
+ * @param newStoredOffset The offset into the file as stored on disk
+ * @param newDelimiter    The SQL delimiter in effect
+ * @param newDatabaseName The database in use
+ */
+- (void)recordPosition:(NSUInteger)newPosition offset:(unsigned long long)newOffset storedOffset:(unsigned long long)newStoredOffset delimiter:(NSString *)newDelimiter databaseName:(NSString *)newDatabaseName
+{
+	recordedPosition = newPosition;
+	recordedOffset = newOffset;
+	recordedStoredOffset = newStoredOffset;
+	recordedDelimiter = newDelimiter;
+	recordedDatabaseName = newDatabaseName;
+}
+
+/**
+ * Records a session setting the import has made, which a resumed import has to make again.
+ */
+- (void)recordSessionStatement:(NSString *)query
+{
+	[sessionStatements addObject:query];
+}
+
+/**
+ * Marks the recorded position as committed on the server, making it the checkpoint.
+ */
+- (void)commitRecordedPosition
+{
+	if (position == recordedPosition && sessionStatementCount == [sessionStatements count]) return;
+
+	position = recordedPosition;
+	offset = recordedOffset;
+	storedOffset = recordedStoredOffset;
+	delimiter = [recordedDelimiter copy];
+	databaseName = [recordedDatabaseName copy];
+	sessionStatementCount = [sessionStatements count];
+
+	changedSinceWrite = YES;
+}
+
+#pragma mark -
+#pragma mark Saving
+
+/**
+ * Saves the checkpoint if it has moved on and it hasn't been saved in the last couple of seconds,
+ * keeping the cost of checkpointing a fast import down.
+ */
+- (BOOL)writeCheckpointIfDue
+{
+	if (!changedSinceWrite || (CFAbsoluteTimeGetCurrent() - lastWriteTime) < SPImportCheckpointWriteInterval) return NO;
+
+	return [self writeCheckpoint];
+}
+
+/**
+ * Saves the checkpoint, replacing any saved earlier. Until anything has been committed there is
+ * nothing to resume from, so any earlier checkpoint is removed instead.
+ *
+ * @return Whether the checkpoint could be saved; -writeError describes a failure
+ */
+- (BOOL)writeCheckpoint
+{
+	if (!position) {
+		[self removeCheckpoint];
+		changedSinceWrite = NO;
+		return NO;
+	}
+
+	NSMutableDictionary *checkpoint = [NSMutableDictionary dictionaryWithDictionary:@{
+		SPImportCheckpointVersionKey:           @(SPImportCheckpointVersion),
+		SPImportCheckpointFormatKey:            importFormat,
+		SPImportCheckpointEncodingKey:          @(encoding),
+		SPImportCheckpointFileSizeKey:          @(fileSize),
+		SPImportCheckpointModificationDateKey:  fileModificationDate,
+		SPImportCheckpointPositionKey:          @(position),
+		SPImportCheckpointOffsetKey:            @(offset),
+		SPImportCheckpointStoredOffsetKey:      @(storedOffset),
+		SPImportCheckpointSessionStatementsKey: [self sessionStatements]
+	}];
+
+	if (tableName) [checkpoint setObject:tableName forKey:SPImportCheckpointTableKey];
+	if (delimiter) [checkpoint setObject:delimiter forKey:SPImportCheckpointDelimiterKey];
+	if (databaseName) [checkpoint setObject:databaseName forKey:SPImportCheckpointDatabaseKey];
+
+	NSError *error = nil;
+	NSData *checkpointData = [NSPropertyListSerialization dataWithPropertyList:checkpoint format:NSPropertyListBinaryFormat_v1_0 options:0 error:&error];
+
+	lastWriteTime = CFAbsoluteTimeGetCurrent();
+	changedSinceWrite = NO;
+
+	if (!checkpointPath) {
+		checkpointPath = [[self class] _checkpointPathForImportFilePath:importFilePath fileSize:fileSize modificationDate:fileModificationDate createFolder:YES error:&error];
+	}
+
+	if (!checkpointData || !checkpointPath || ![checkpointData writeToFile:checkpointPath options:NSDataWritingAtomic error:&error]) {
+		SPLog(@"Failed to save the import checkpoint for %@: %@", importFilePath, error);
+
+		writeError = error ?: [NSError errorWithDomain:NSCocoaErrorDomain code:NSFileWriteUnknownError userInfo:nil];
+
+		return NO;
+	}
+
+	writeError = nil;
+
+	return YES;
+}
+
+/**
+ * Removes the saved checkpoint, once the import has completed or is started again from the beginning.
+ */
+- (void)removeCheckpoint
+{
+	NSString *path = checkpointPath ?: [[self class] _checkpointPathForImportFilePath:importFilePath fileSize:fileSize modificationDate:fileModificationDate createFolder:NO error:NULL];
+
+	if (path) [[NSFileManager defaultManager] removeItemAtPath:path error:NULL];
+}
+
+#pragma mark -
+#pragma mark Private API
+
+/**
+ * Returns the path of the checkpoint for an import file of the supplied path, size and modification
+ * date, in the import checkpoints folder of the application support folder, creating the folder if
+ * requested.
+ */
++ (NSString *)_checkpointPathForImportFilePath:(NSString *)path fileSize:(unsigned long long)size modificationDate:(NSDate *)modificationDate createFolder:(BOOL)create error:(NSError **)error
+{
+	NSFileManager *fileManager = [NSFileManager defaultManager];
+	NSURL *supportURL = [fileManager URLForDirectory:NSApplicationSupportDirectory inDomain:NSUserDomainMask appropriateForURL:nil create:create error:error];
+
+	if (!supportURL) return nil;
+
+	// Within the sandbox this is the application's own container
+	NSString *applicationName = [[NSBundle mainBundle] objectForInfoDictionaryKey:@"CFBundleExecutable"] ?: @"Sequel Ace";
+	NSString *folder = [[[supportURL path] stringByAppendingPathComponent:applicationName] stringByAppendingPathComponent:SPImportCheckpointsSupportFolder];
+
+	if (create && ![fileManager createDirectoryAtPath:folder withIntermediateDirectories:YES attributes:nil error:error]) return nil;
+
+	NSString *key = [NSString stringWithFormat:@"%@\n%llu\n%.6f", [path stringByStandardizingPath], size, [modificationDate timeIntervalSinceReferenceDate]];
+
+	return [folder stringByAppendingPathComponent:[[key sha256Hash] stringByAppendingPathExtension:SPImportCheckpointExtension]];
+}
+
+/**
+ * Reads the import file's size and modification date, returning NO if it can't be found.
+ */
+- (BOOL)_readFileAttributes
+{
+	NSDictionary *attributes = [[NSFileManager defaultManager] attributesOfItemAtPath:importFilePath error:NULL];
+
+	if (!attributes) return NO;
+
+	fileSize = [[attributes objectForKey:NSFileSize] unsignedLongLongValue];
+	fileModificationDate = [attributes objectForKey:NSFileModificationDate];
+
+	return fileModificationDate != nil;
+}
+
+@end
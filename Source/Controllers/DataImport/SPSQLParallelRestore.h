@@ -0,0 +1,93 @@
+//
+//  SPSQLParallelRestore.h
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import <SPMySQL/SPMySQL.h>
+
+@class SPSQLImportStatement;
+@class SPTransferStatistics;
+
+/**
+ * Whether the query is a SET, possibly inside a versioned comment, which only affects the session.
+ */
+BOOL SPSQLQueryIsSessionStatement(NSString *query);
+
+/**
+ * @class SPSQLParallelRestore SPSQLParallelRestore.h
+ *
+ * Restores the table data of a SQL dump over a small pool of copies of the import connection. Dumps
+ * written by Sequel Ace and mysqldump load each table's rows between LOCK TABLES and UNLOCK TABLES;
+ * each such section is handed to a pooled connection as a job, with foreign key checks disabled, while
+ * the import carries on with the statements after it. Statements creating or dropping a table wait
+ * only for that table's data to finish loading; anything else, such as views, triggers and routines,
+ * waits for all outstanding data, so the dump's own ordering is kept wherever it matters.
+ *
+ * SET statements are recorded and replayed on each pooled connection before its next job, so the data
+ * is loaded with the session settings the dump asked for. Statements which fail on a pooled connection
+ * are collected for the import to report, in the same way as its own errors.
+ */
+@interface SPSQLParallelRestore : NSObject <SPMySQLConnectionDelegate>
+{
+	SPMySQLConnection *connection;
+	SPMySQLConnection *firstWorkerConnection;
+	SPTransferStatistics *statistics;
+	NSStringEncoding encoding;
+	NSUInteger maxConnections;
+	BOOL batchStatements;
+
+	NSCondition *jobCondition;
+	NSMutableArray *pendingJobs;
+	NSMutableArray *unfinishedJobs;
+	NSCountedSet *loadingTables;
+	NSUInteger workerCount;
+	NSUInteger idleWorkerCount;
+	NSMutableArray *sessionStatements;
+	NSMutableArray *failures;
+	BOOL finished;
+	BOOL cancelled;
+	BOOL connectionLost;
+
+	id currentJob;
+	NSMutableArray *currentChunk;
+	NSUInteger currentChunkLength;
+	BOOL skippingSection;
+	BOOL routingDisabled;
+}
+
+- (instancetype)initWithConnection:(SPMySQLConnection *)aConnection encoding:(NSStringEncoding)queryEncoding maxConnections:(NSUInteger)connectionCount batchStatements:(BOOL)batch statistics:(SPTransferStatistics *)transferStatistics;
+
+- (BOOL)takeStatement:(SPSQLImportStatement *)statement inDatabase:(NSString *)databaseName;
+- (void)addSessionStatement:(NSString *)query;
+- (NSArray *)takeFailures;
+
+- (void)finish;
+- (void)cancel;
+- (BOOL)connectionLost;
+
+@end
@@ -0,0 +1,675 @@
+//
+//  SPSQLParallelRestore.m
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPSQLParallelRestore.h"
+#import "SPSQLStatementReader.h"
+#import "SPBoundedQueue.h"
+#import "SPTransferStatistics.h"
+
+// The most statements and bytes of SQL handed to a pooled connection at once, and the number of
+// such chunks a job holds before the import waits for its connection to catch up
+static const NSUInteger SPSQLRestoreChunkStatements = 1000;
+static const NSUInteger SPSQLRestoreChunkLength = 4 * 1024 * 1024;
+static const NSUInteger SPSQLRestoreJobQueueCapacity = 4;
+
+/**
+ * Returns whether the query starts with the keyword, ignoring case, followed by whitespace or the end
+ * of the query.
+ */
+static BOOL SPSQLQueryStartsWithKeyword(NSString *query, NSString *keyword)
+{
+	NSUInteger queryLength = [query length];
+	NSUInteger keywordLength = [keyword length];
+
+	if (queryLength < keywordLength) return NO;
+	if ([query rangeOfString:keyword options:NSAnchoredSearch | NSCaseInsensitiveSearch range:NSMakeRange(0, keywordLength)].location == NSNotFound) return NO;
+
+	return queryLength == keywordLength || [[NSCharacterSet whitespaceAndNewlineCharacterSet] characterIsMember:[query characterAtIndex:keywordLength]];
+}
+
+/**
+ * Returns whether the query is a SET, possibly inside a versioned comment, which only affects the session.
+ */
+BOOL SPSQLQueryIsSessionStatement(NSString *query)
+{
+	if (SPSQLQueryStartsWithKeyword(query, @"SET")) return YES;
+	if (![query hasPrefix:@"/*!"]) return NO;
+
+	NSUInteger i = 3;
+	NSUInteger queryLength = [query length];
+
+	while (i < queryLength && isdigit([query characterAtIndex:i])) i++;
+	while (i < queryLength && isspace([query characterAtIndex:i])) i++;
+
+	return SPSQLQueryStartsWithKeyword([query substringFromIndex:i], @"SET");
+}
+
+/**
+ * Returns whether the query belongs in a table's data section: its rows, and the versioned
+ * ALTER TABLE ... DISABLE KEYS and ENABLE KEYS which dumps put around them.
+ */
+static BOOL SPSQLQueryIsSectionData(NSString *query)
+{
+	if (SPSQLQueryStartsWithKeyword(query, @"INSERT") || SPSQLQueryStartsWithKeyword(query, @"REPLACE")) return YES;
+
+	return [query hasPrefix:@"/*!40000 ALTER TABLE "] && [query hasSuffix:@" KEYS */"];
+}
+
+/**
+ * Returns the unquoted table name captured by the expression's first group, or nil if the query doesn't match.
+ */
+static NSString *SPSQLQueryTableName(NSString *query, NSRegularExpression *expression)
+{
+	NSTextCheckingResult *match = [expression firstMatchInString:query options:0 range:NSMakeRange(0, MIN([query length], 1024))];
+
+	if (!match) return nil;
+
+	NSString *name = [query substringWithRange:[match rangeAtIndex:1]];
+
+	if ([name hasPrefix:@"`"]) {
+		name = [[name substringWithRange:NSMakeRange(1, [name length] - 2)] stringByReplacingOccurrencesOfString:@"``" withString:@"`"];
+	}
+
+	return name;
+}
+
+#pragma mark -
+
+/**
+ * A table's data section, which the import fills with chunks of statements while a pooled
+ * connection loads them.
+ */
+@interface SPSQLRestoreJob : NSObject
+{
+	@public
+	NSString *table;
+	NSString *database;
+	NSUInteger sessionStatementCount;
+	SPBoundedQueue *queue;
+}
+
+@end
+
+@implementation SPSQLRestoreJob
+
+@end
+
+#pragma mark -
+
+@interface SPSQLParallelRestore ()
+
+- (void)_beginJobForTable:(NSString *)table database:(NSString *)databaseName;
+- (void)_flushCurrentChunk;
+- (void)_finishCurrentJob;
+- (void)_waitForTable:(NSString *)table;
+- (void)_runWorker;
+- (void)_runJob:(SPSQLRestoreJob *)job onConnection:(SPMySQLConnection *)workerConnection sessionStatements:(NSArray *)newSessionStatements;
+- (BOOL)_runChunk:(NSArray *)chunk ofJob:(SPSQLRestoreJob *)job onConnection:(SPMySQLConnection *)workerConnection;
+- (BOOL)_recordFailureOfStatement:(SPSQLImportStatement *)statement onConnection:(SPMySQLConnection *)workerConnection;
+- (SPMySQLConnection *)_connectedCopyOfConnection;
+
+@end
+
+@implementation SPSQLParallelRestore
+
+#pragma mark -
+#pragma mark Initialisation
+
+/**
+ * Initialise a parallel restore for the supplied import connection, opening the first pooled
+ * connection straight away.
+ *
+ * @param aConnection        The import connection, which the pooled connections are copied from
+ * @param queryEncoding      The encoding the statements are sent in
+ * @param connectionCount    The most pooled connections to open
+ * @param batch              Whether consecutive statements are sent as multi-statement queries
+ * @param transferStatistics The import statistics, which the pooled connections add their rows to
+ *
+ * @return The initialised instance, or nil if no pooled connection could be opened
+ */
+- (instancetype)initWithConnection:(SPMySQLConnection *)aConnection encoding:(NSStringEncoding)queryEncoding maxConnections:(NSUInteger)connectionCount batchStatements:(BOOL)batch statistics:(SPTransferStatistics *)transferStatistics
+{
+	if ((self = [super init])) {
+		connection = aConnection;
+		encoding = queryEncoding;
+		maxConnections = MAX(connectionCount, 1);
+		batchStatements = batch;
+		statistics = transferStatistics;
+
+		jobCondition = [[NSCondition alloc] init];
+		pendingJobs = [[NSMutableArray alloc] init];
+		unfinishedJobs = [[NSMutableArray alloc] init];
+		loadingTables = [[NSCountedSet alloc] init];
+		sessionStatements = [[NSMutableArray alloc] init];
+		failures = [[NSMutableArray alloc] init];
+
+		// Without a first connection there's nothing to restore in parallel with
+		firstWorkerConnection = [self _connectedCopyOfConnection];
+
+		if (!firstWorkerConnection) return nil;
+	}
+
+	return self;
+}
+
+#pragma mark -
+#pragma mark Import thread
+
+/**
+ * Offers the next statement of the import to the parallel restore, returning YES if it has been
+ * taken - queued to be loaded by a pooled connection, or dropped as the LOCK TABLES or UNLOCK TABLES
+ * around a data section - or NO if the import should run it itself. Before NO is returned, any
+ * table data the statement could depend on has finished loading.
+ *
+ * @param statement    The statement, in file order
+ * @param databaseName The database the import is currently running statements in
+ */
+- (BOOL)takeStatement:(SPSQLImportStatement *)statement inDatabase:(NSString *)databaseName
+{
+	NSString *query = [statement query];
+	NSString *table;
+
+	// Within a data section, hand its rows on until the section ends
+	if (currentJob) {
+		if (SPSQLQueryStartsWithKeyword(query, @"UNLOCK TABLES")) {
+			[self _finishCurrentJob];
+
+			return YES;
+		}
+
+		if (SPSQLQueryIsSectionData(query)) {
+			[currentChunk addObject:statement];
+			currentChunkLength += [statement queryLength];
+
+			if ([currentChunk count] >= SPSQLRestoreChunkStatements || currentChunkLength >= SPSQLRestoreChunkLength) [self _flushCurrentChunk];
+
+			return YES;
+		}
+
+		// Anything unexpected leaves the rest of the section to the import, once all data so far has loaded
+		[self _finishCurrentJob];
+		[self _waitForTable:nil];
+		skippingSection = YES;
+	}
+
+	if (skippingSection) {
+		if (SPSQLQueryStartsWithKeyword(query, @"UNLOCK TABLES")) skippingSection = NO;
+		if (SPSQLQueryIsSessionStatement(query)) [self addSessionStatement:query];
+
+		return NO;
+	}
+
+	// Session settings apply to the pooled connections too, from their next job on
+	if (SPSQLQueryIsSessionStatement(query)) {
+		[self addSessionStatement:query];
+
+		return NO;
+	}
+
+	if (routingDisabled) return NO;
+
+	// A transaction can't span several connections, so the rest of the file is left to the import
+	if (SPSQLQueryStartsWithKeyword(query, @"BEGIN") || SPSQLQueryStartsWithKeyword(query, @"START TRANSACTION")) {
+		[self _waitForTable:nil];
+		routingDisabled = YES;
+
+		return NO;
+	}
+
+	static NSRegularExpression *lockTableExpression = nil;
+	static NSRegularExpression *tableDefinitionExpression = nil;
+	static dispatch_once_t onceToken;
+
+	dispatch_once(&onceToken, ^{
+		lockTableExpression = [NSRegularExpression regularExpressionWithPattern:@"^LOCK\\s+TABLES?\\s+(`(?:[^`]|``)+`|\\w+)\\s+WRITE\\s*$" options:NSRegularExpressionCaseInsensitive error:nil];
+		tableDefinitionExpression = [NSRegularExpression regularExpressionWithPattern:@"^(?:CREATE|DROP)\\s+TABLE\\s+(?:IF\\s+(?:NOT\\s+)?EXISTS\\s+)?(`(?:[^`]|``)+`|\\w+)(?=[\\s(]|$)" options:NSRegularExpressionCaseInsensitive error:nil];
+	});
+
+	// A single table locked for writing starts a data section
+	if ((table = SPSQLQueryTableName(query, lockTableExpression))) {
+		[self _waitForTable:table];
+		[self _beginJobForTable:table database:databaseName];
+
+		return YES;
+	}
+
+	// Creating or dropping a table only has to wait for that table's data, unless it reads from others
+	table = SPSQLQueryTableName(query, tableDefinitionExpression);
+
+	if (table && [query rangeOfString:@"SELECT" options:NSCaseInsensitiveSearch].location != NSNotFound) table = nil;
+
+	[self _waitForTable:table];
+
+	return NO;
+}
+
+/**
+ * Records a statement to be run on each pooled connection before its next job, in order to match
+ * the import connection's session settings.
+ *
+ * @param query The statement, typically a SET
+ */
+- (void)addSessionStatement:(NSString *)query
+{
+	[jobCondition lock];
+	[sessionStatements addObject:query];
+	[jobCondition unlock];
+}
+
+/**
+ * Returns the statements which have failed on the pooled connections since the last call, as
+ * dictionaries holding the statement's sequenceNumber, query, errorMessage and errorID.
+ */
+- (NSArray *)takeFailures
+{
+	@synchronized(failures) {
+		NSArray *takenFailures = [failures copy];
+
+		[failures removeAllObjects];
+
+		return takenFailures;
+	}
+}
+
+/**
+ * Ends any data section in progress and waits for all table data to finish loading, then closes
+ * the pooled connections.
+ */
+- (void)finish
+{
+	if (currentJob) [self _finishCurrentJob];
+
+	[jobCondition lock];
+
+	finished = YES;
+	[jobCondition broadcast];
+
+	while (workerCount) [jobCondition wait];
+
+	[jobCondition unlock];
+
+	[firstWorkerConnection disconnect];
+	firstWorkerConnection = nil;
+}
+
+/**
+ * Stops loading table data as soon as possible, discarding anything not yet sent to the server.
+ */
+- (void)cancel
+{
+	[jobCondition lock];
+
+	cancelled = YES;
+
+	for (SPSQLRestoreJob *job in unfinishedJobs) [job->queue cancel];
+
+	[jobCondition broadcast];
+	[jobCondition unlock];
+}
+
+/**
+ * Returns whether a pooled connection was lost, which cancels the restore.
+ */
+- (BOOL)connectionLost
+{
+	[jobCondition lock];
+
+	BOOL lost = connectionLost;
+
+	[jobCondition unlock];
+
+	return lost;
+}
+
+#pragma mark -
+#pragma mark SPMySQLConnection delegate methods
+
+/**
+ * Forward keychain password requests for the pooled connections to the import connection's delegate.
+ */
+- (NSString *)keychainPasswordForConnection:(id)aConnection
+{
+	NSObject <SPMySQLConnectionDelegate> *connectionDelegate = [connection delegate];
+
+	if (![connectionDelegate respondsToSelector:@selector(keychainPasswordForConnection:)]) return nil;
+
+	return [connectionDelegate keychainPasswordForConnection:connection];
+}
+
+/**
+ * Pooled connections are never reconnected, as the statements they were running can't safely be
+ * retried; losing one cancels the restore instead.
+ */
+- (SPMySQLConnectionLostDecision)connectionLost:(id)aConnection
+{
+	return SPMySQLConnectionLostDisconnect;
+}
+
+#pragma mark -
+#pragma mark Private API
+
+/**
+ * Starts a job for a table's data section, starting another worker if none is free to take it.
+ */
+- (void)_beginJobForTable:(NSString *)table database:(NSString *)databaseName
+{
+	SPSQLRestoreJob *job = [[SPSQLRestoreJob alloc] init];
+
+	job->table = table;
+	job->database = databaseName;
+	job->queue = [[SPBoundedQueue alloc] initWithCapacity:SPSQLRestoreJobQueueCapacity];
+
+	[jobCondition lock];
+
+	job->sessionStatementCount = [sessionStatements count];
+
+	if (cancelled) [job->queue cancel];
+
+	[pendingJobs addObject:job];
+	[unfinishedJobs addObject:job];
+	[loadingTables addObject:table];
+
+	BOOL startWorker = ([pendingJobs count] > idleWorkerCount && workerCount < maxConnections);
+
+	if (startWorker) workerCount++;
+
+	[jobCondition broadcast];
+	[jobCondition unlock];
+
+	if (startWorker) [NSThread detachNewThreadSelector:@selector(_runWorker) toTarget:self withObject:nil];
+
+	currentJob = job;
+	currentChunk = [NSMutableArray array];
+	currentChunkLength = 0;
+}
+
+/**
+ * Passes the statements gathered for the current job on to its pooled connection, waiting if it
+ * is too far behind.
+ */
+- (void)_flushCurrentChunk
+{
+	if (![currentChunk count]) return;
+
+	[((SPSQLRestoreJob *)currentJob)->queue enqueue:currentChunk];
+
+	currentChunk = [NSMutableArray array];
+	currentChunkLength = 0;
+}
+
+/**
+ * Ends the current data section, leaving its pooled connection to finish loading it.
+ */
+- (void)_finishCurrentJob
+{
+	[self _flushCurrentChunk];
+
+	[((SPSQLRestoreJob *)currentJob)->queue close];
+
+	currentJob = nil;
+	currentChunk = nil;
+}
+
+/**
+ * Waits for the data of the supplied table to finish loading, or for all table data if nil.
+ */
+- (void)_waitForTable:(NSString *)table
+{
+	[jobCondition lock];
+
+	while (table ? [loadingTables countForObject:table] : [unfinishedJobs count])
+	{
+		[jobCondition wait];
+	}
+
+	[jobCondition unlock];
+}
+
+/**
+ * A worker thread, which loads jobs over its own pooled connection until the restore finishes.
+ */
+- (void)_runWorker
+{
+	@autoreleasepool {
+		[[NSThread currentThread] setName:@"SPSQLParallelRestore worker"];
+
+		[jobCondition lock];
+
+		SPMySQLConnection *workerConnection = firstWorkerConnection;
+
+		firstWorkerConnection = nil;
+
+		[jobCondition unlock];
+
+		if (!workerConnection) workerConnection = [self _connectedCopyOfConnection];
+
+		// The server may be refusing further connections, so make do with those already open
+		if (!workerConnection) {
+			[jobCondition lock];
+
+			workerCount--;
+			maxConnections = MAX(workerCount, 1);
+
+			[jobCondition broadcast];
+			[jobCondition unlock];
+
+			return;
+		}
+
+		NSUInteger appliedSessionStatementCount = 0;
+
+		while (1)
+		{
+			SPSQLRestoreJob *job = nil;
+			NSArray *newSessionStatements = nil;
+
+			[jobCondition lock];
+
+			idleWorkerCount++;
+
+			while (![pendingJobs count] && !finished) [jobCondition wait];
+
+			idleWorkerCount--;
+
+			if ([pendingJobs count]) {
+				job = [pendingJobs objectAtIndex:0];
+				[pendingJobs removeObjectAtIndex:0];
+
+				newSessionStatements = [sessionStatements subarrayWithRange:NSMakeRange(appliedSessionStatementCount, job->sessionStatementCount - appliedSessionStatementCount)];
+				appliedSessionStatementCount = job->sessionStatementCount;
+			}
+
+			[jobCondition unlock];
+
+			if (!job) break;
+
+			@autoreleasepool {
+				[self _runJob:job onConnection:workerConnection sessionStatements:newSessionStatements];
+			}
+
+			[jobCondition lock];
+
+			[unfinishedJobs removeObject:job];
+			[loadingTables removeObject:job->table];
+
+			[jobCondition broadcast];
+			[jobCondition unlock];
+		}
+
+		[workerConnection disconnect];
+
+		[jobCondition lock];
+
+		workerCount--;
+
+		[jobCondition broadcast];
+		[jobCondition unlock];
+	}
+}
+
+/**
+ * Loads a job's data section, after bringing the connection's session in line with the import's.
+ */
+- (void)_runJob:(SPSQLRestoreJob *)job onConnection:(SPMySQLConnection *)workerConnection sessionStatements:(NSArray *)newSessionStatements
+{
+	for (NSString *query in newSessionStatements)
+	{
+		[workerConnection queryString:query usingEncoding:encoding withResultType:SPMySQLResultAsResult];
+	}
+
+	// Tables are loaded in whatever order the connections get to them
+	[workerConnection queryString:@"SET FOREIGN_KEY_CHECKS=0"];
+
+	NSArray *chunk;
+	BOOL connected = YES;
+
+	while ((chunk = [job->queue dequeue]))
+	{
+		@autoreleasepool {
+			if (connected) connected = [self _runChunk:chunk ofJob:job onConnection:workerConnection];
+		}
+	}
+
+	// Make the data permanent, should the dump have turned autocommit off
+	if (connected) [workerConnection queryString:@"COMMIT"];
+}
+
+/**
+ * Runs a chunk of a job's statements, returning NO if the connection was lost.
+ */
+- (BOOL)_runChunk:(NSArray *)chunk ofJob:(SPSQLRestoreJob *)job onConnection:(SPMySQLConnection *)workerConnection
+{
+	NSUInteger chunkCount = [chunk count];
+	NSUInteger index = 0;
+
+	while (index < chunkCount)
+	{
+		NSUInteger remainingCount = chunkCount - index;
+
+		// Send the rest of the chunk in one round trip; it stops at the first statement which fails
+		if (batchStatements && remainingCount > 1) {
+			NSArray *statements = [chunk subarrayWithRange:NSMakeRange(index, remainingCount)];
+			unsigned long long *rowCounts = calloc(remainingCount, sizeof(unsigned long long));
+
+			NSUInteger succeededCount = [workerConnection queryStatements:[statements valueForKey:@"query"] usingEncoding:encoding affectedRowCounts:rowCounts assertingDatabaseContext:job->database];
+
+			if (succeededCount != NSNotFound) {
+				uint64_t rowCount = 0;
+				uint64_t byteCount = 0;
+
+				for (NSUInteger i = 0; i < succeededCount; i++)
+				{
+					rowCount += rowCounts[i];
+					byteCount += [[statements objectAtIndex:i] queryLength];
+				}
+
+				[statistics addRows:rowCount];
+				[statistics addServerBytes:byteCount];
+				[statistics addStatements:succeededCount errors:0];
+
+				index += succeededCount;
+			}
+
+			free(rowCounts);
+
+			if (succeededCount != NSNotFound) {
+				if (index < chunkCount && ![self _recordFailureOfStatement:[chunk objectAtIndex:index++] onConnection:workerConnection]) return NO;
+
+				continue;
+			}
+		}
+
+		SPSQLImportStatement *statement = [chunk objectAtIndex:index++];
+
+		[workerConnection queryString:[statement query] usingEncoding:encoding withResultType:SPMySQLResultAsResult assertingDatabaseContext:job->database];
+
+		[statistics addServerBytes:[statement queryLength]];
+
+		if (![workerConnection queryErrored]) {
+			[statistics addRows:[workerConnection rowsAffectedByLastQuery]];
+			[statistics addStatements:1 errors:0];
+		}
+		else if (![[workerConnection lastErrorMessage] isEqualToString:@"Query was empty"]) {
+			if (![self _recordFailureOfStatement:statement onConnection:workerConnection]) return NO;
+		}
+	}
+
+	return YES;
+}
+
+/**
+ * Records the connection's last error against the statement, returning NO if the error was the loss
+ * of the connection, in which case the restore is cancelled.
+ */
+- (BOOL)_recordFailureOfStatement:(SPSQLImportStatement *)statement onConnection:(SPMySQLConnection *)workerConnection
+{
+	BOOL lost = [SPMySQLConnection isErrorIDConnectionError:[workerConnection lastErrorID]] || ![workerConnection isConnected];
+
+	[statistics addStatements:1 errors:1];
+
+	@synchronized(failures) {
+		[failures addObject:@{
+			@"sequenceNumber" : @([statement sequenceNumber]),
+			@"query" : [statement query],
+			@"errorMessage" : [workerConnection lastErrorMessage] ?: @"",
+			@"errorID" : @([workerConnection lastErrorID])
+		}];
+	}
+
+	if (lost) {
+		[jobCondition lock];
+		connectionLost = YES;
+		[jobCondition unlock];
+
+		[self cancel];
+	}
+
+	return !lost;
+}
+
+/**
+ * Returns a new connection with the import connection's settings and character set.
+ */
+- (SPMySQLConnection *)_connectedCopyOfConnection
+{
+	SPMySQLConnection *copy = [connection copy];
+
+	[copy setDelegate:self];
+	[copy setDelegateQueryLogging:NO];
+	[copy setRetryQueriesOnConnectionFailure:NO];
+
+	if (![copy connect]) return nil;
+
+	[copy setEncoding:[connection encoding]];
+
+	return copy;
+}
+
+@end
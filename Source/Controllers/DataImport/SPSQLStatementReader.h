@@ -0,0 +1,141 @@
+//
+//  SPSQLStatementReader.h
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPBoundedQueue.h"
+
+@class SPFileHandle;
+@class SPTransferStatistics;
+@class SPSQLStatementReadStage;
+
+/**
+ * Whether SQL in the encoding can be split into statements as raw bytes: quotes, comment markers
+ * and delimiters must never appear as part of a multibyte character.
+ */
+BOOL SPSQLEncodingCanBeSplitAsBytes(NSStringEncoding encoding);
+
+/**
+ * @class SPSQLImportStatement SPSQLStatementReader.h
+ *
+ * A statement read from a SQL file, numbered from 1 in file order.
+ */
+@interface SPSQLImportStatement : NSObject
+{
+	NSString *query;
+	NSUInteger sequenceNumber;
+	NSUInteger processedLength;
+	NSUInteger storedLength;
+	NSUInteger queryLength;
+	NSString *delimiter;
+	BOOL mayChangeServerStatus;
+	BOOL canBeBatched;
+}
+
+/**
+ * @property query The statement, ready to be executed
+ */
+@property (readonly, strong) NSString *query;
+
+/**
+ * @property sequenceNumber The statement's position in the file, counting from 1
+ */
+@property (readonly, assign) NSUInteger sequenceNumber;
+
+/**
+ * @property processedLength The number of bytes of SQL read up to the end of the statement
+ */
+@property (readonly, assign) NSUInteger processedLength;
+
+/**
+ * @property storedLength The number of bytes read from the file itself when the statement was
+ * split, which differs from the processed length for compressed files
+ */
+@property (readonly, assign) NSUInteger storedLength;
+
+/**
+ * @property mayChangeServerStatus Whether the statement could change the sql_mode. No further
+ * statements are split until the reader is told the resulting NO_BACKSLASH_ESCAPES setting.
+ */
+@property (readonly, assign) BOOL mayChangeServerStatus;
+
+/**
+ * @property queryLength The length of the statement in the file, in bytes
+ */
+@property (readonly, assign) NSUInteger queryLength;
+
+/**
+ * @property delimiter The delimiter in effect when the statement was read, so reading can later
+ * carry on from after it
+ */
+@property (readonly, strong) NSString *delimiter;
+
+/**
+ * @property canBeBatched Whether the statement is a small INSERT or REPLACE, which can be sent
+ * to the server together with its neighbours in a single multi-statement query
+ */
+@property (readonly, assign) BOOL canBeBatched;
+
+@end
+
+/**
+ * @class SPSQLStatementReader SPSQLStatementReader.h
+ *
+ * Reads a SQL file and splits it into statements on background threads, ahead of the import
+ * executing them. One thread reads, and so decompresses, the file into chunks; a second splits
+ * the chunks into statements and decodes them. Each hands its output on through a bounded queue,
+ * so the connection can be kept busy while the next statements are prepared, without holding
+ * more than a few chunks of the file in memory.
+ *
+ * Statements are returned strictly in file order. A read or decoding error ends the statements
+ * early, after those before it have been returned. A consumer stopping before the end should
+ * call cancel.
+ */
+@interface SPSQLStatementReader : NSObject
+{
+	SPSQLStatementReadStage *readStage;
+
+	NSArray *currentBatch;
+	NSUInteger currentBatchIndex;
+}
+
+- (instancetype)initWithFileHandle:(SPFileHandle *)fileHandle encoding:(NSStringEncoding)encoding noBackslashEscapes:(BOOL)noBackslashEscapes statistics:(SPTransferStatistics *)statistics;
+- (instancetype)initWithFileHandle:(SPFileHandle *)fileHandle encoding:(NSStringEncoding)encoding noBackslashEscapes:(BOOL)noBackslashEscapes statistics:(SPTransferStatistics *)statistics resumingAtOffset:(NSUInteger)offset afterStatement:(NSUInteger)sequenceNumber delimiter:(NSString *)delimiter;
+
+- (SPSQLImportStatement *)nextStatement;
+- (void)resumeWithNoBackslashEscapes:(BOOL)noBackslashEscapes;
+- (void)cancel;
+
+- (NSString *)readErrorReason;
+- (BOOL)decodingFailed;
+
+- (SPPipelineStageCounters)readStageCounters;
+- (SPPipelineStageCounters)splitStageCounters;
+- (uint64_t)statementWaitNanoseconds;
+
+@end
@@ -0,0 +1,665 @@
+//
+//  SPSQLStatementReader.m
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPSQLStatementReader.h"
+#import "SPSQLStatementSplitter.h"
+#import "SPSQLParser.h"
+#import "SPFileHandle.h"
+#import "SPTransferStatistics.h"
+
+#include <ctype.h>
+
+static const NSUInteger SPSQLImportChunkLength = 1024 * 1024;
+static const NSUInteger SPSQLImportChunkQueueCapacity = 4;
+static const NSUInteger SPSQLImportStatementBatchSize = 64;
+static const NSUInteger SPSQLImportStatementQueueCapacity = 8;
+static const NSUInteger SPSQLImportMaxBatchableLength = 64 * 1024;
+
+BOOL SPSQLEncodingCanBeSplitAsBytes(NSStringEncoding encoding)
+{
+	switch (encoding) {
+		case NSUTF8StringEncoding:
+		case NSASCIIStringEncoding:
+		case NSISOLatin1StringEncoding:
+		case NSISOLatin2StringEncoding:
+		case NSWindowsCP1250StringEncoding:
+		case NSWindowsCP1251StringEncoding:
+		case NSWindowsCP1252StringEncoding:
+		case NSWindowsCP1253StringEncoding:
+		case NSWindowsCP1254StringEncoding:
+		case NSMacOSRomanStringEncoding:
+		case NSJapaneseEUCStringEncoding:
+			return YES;
+		default:
+			return NO;
+	}
+}
+
+/**
+ * Returns whether the statement is a SET, possibly inside a versioned comment, which mentions
+ * the sql_mode. Other statements can't change how backslashes are treated in the ones after them.
+ */
+static BOOL SPSQLStatementMaySetSQLMode(const uint8_t *bytes, size_t length)
+{
+	static const char keyword[] = "sql_mode";
+	size_t keywordLength = sizeof(keyword) - 1;
+	size_t i = 0;
+
+	// Step into a leading /*!40101 ... */ comment
+	if (length >= 3 && bytes[0] == '/' && bytes[1] == '*' && bytes[2] == '!') {
+		for (i = 3; i < length && isdigit(bytes[i]); i++);
+		for (; i < length && isspace(bytes[i]); i++);
+	}
+
+	if (i + 4 > length || tolower(bytes[i]) != 's' || tolower(bytes[i + 1]) != 'e' || tolower(bytes[i + 2]) != 't' || !isspace(bytes[i + 3])) return NO;
+
+	for (i += 4; i + keywordLength <= length; i++)
+	{
+		size_t k = 0;
+
+		while (k < keywordLength && tolower(bytes[i + k]) == keyword[k]) k++;
+
+		if (k == keywordLength) return YES;
+	}
+
+	return NO;
+}
+
+/**
+ * Returns whether the statement is an INSERT or REPLACE short enough to be worth batching. Such
+ * statements return no result set and don't change the session, so they can safely be run as
+ * part of a multi-statement query.
+ */
+static BOOL SPSQLStatementCanBeBatched(const uint8_t *bytes, size_t length)
+{
+	if (length > SPSQLImportMaxBatchableLength) return NO;
+
+	if (length > 7 && strncasecmp((const char *)bytes, "INSERT", 6) == 0 && isspace(bytes[6])) return YES;
+	if (length > 8 && strncasecmp((const char *)bytes, "REPLACE", 7) == 0 && isspace(bytes[7])) return YES;
+
+	return NO;
+}
+
+#pragma mark -
+
+@interface SPSQLImportStatement ()
+
+- (instancetype)initWithQuery:(NSString *)statementQuery sequenceNumber:(NSUInteger)number processedLength:(NSUInteger)processed storedLength:(NSUInteger)stored queryLength:(NSUInteger)length delimiter:(NSString *)statementDelimiter mayChangeServerStatus:(BOOL)mayChange canBeBatched:(BOOL)batchable;
+
+@end
+
+@implementation SPSQLImportStatement
+
+@synthesize query;
+@synthesize sequenceNumber;
+@synthesize processedLength;
+@synthesize storedLength;
+@synthesize mayChangeServerStatus;
+@synthesize queryLength;
+@synthesize delimiter;
+@synthesize canBeBatched;
+
+- (instancetype)initWithQuery:(NSString *)statementQuery sequenceNumber:(NSUInteger)number processedLength:(NSUInteger)processed storedLength:(NSUInteger)stored queryLength:(NSUInteger)length delimiter:(NSString *)statementDelimiter mayChangeServerStatus:(BOOL)mayChange canBeBatched:(BOOL)batchable
+{
+	if ((self = [super init])) {
+		query = statementQuery;
+		sequenceNumber = number;
+		processedLength = processed;
+		storedLength = stored;
+		queryLength = length;
+		delimiter = statementDelimiter;
+		mayChangeServerStatus = mayChange;
+		canBeBatched = batchable;
+	}
+
+	return self;
+}
+
+@end
+
+#pragma mark -
+
+/**
+ * The read and split stages' state, kept apart from the reader so that the background threads,
+ * which retain it, don't keep the reader alive; releasing the reader then cancels the stages.
+ */
+@interface SPSQLStatementReadStage : NSObject
+{
+	@public
+	SPFileHandle *fileHandle;
+	NSStringEncoding encoding;
+	SPTransferStatistics *statistics;
+	SPSQLStatementSplitter *splitter;
+	NSUInteger startOffset;
+	NSUInteger startSequenceNumber;
+
+	SPBoundedQueue *chunkQueue;
+	SPBoundedQueue *statementQueue;
+
+	dispatch_semaphore_t serverStatusUpdated;
+	atomic_bool noBackslashEscapes;
+
+	NSString *readErrorReason;
+	atomic_bool readFailed;
+	BOOL decodingFailed;
+
+	_Atomic NSUInteger storedLength;
+	_Atomic uint64_t readBusyNanoseconds;
+	_Atomic uint64_t splitBusyNanoseconds;
+	_Atomic uint64_t serverStatusWaitNanoseconds;
+	_Atomic uint64_t statementCount;
+
+	dispatch_semaphore_t readFinished;
+	dispatch_semaphore_t splitFinished;
+	atomic_bool finished;
+}
+
+- (void)readChunks;
+- (void)splitStatements;
+
+@end
+
+@implementation SPSQLStatementReadStage
+
+/**
+ * Reads the file into chunks and queues them until the end of the file, a read error or
+ * the queue being cancelled. Reading decompresses compressed files; uncompressed files are
+ * mapped into memory, and the chunks are slices of the mapping.
+ */
+- (void)readChunks
+{
+	@autoreleasepool {
+		NSUInteger lastStoredLength = 0;
+		BOOL compressed = ([fileHandle compressionFormat] != SPNoCompression);
+
+		while (![chunkQueue isCancelled])
+		{
+			@autoreleasepool {
+				uint64_t start = SPPipelineTimestamp();
+				NSData *chunk = nil;
+
+				@try {
+					chunk = [fileHandle readStreamedDataOfLength:SPSQLImportChunkLength];
+				}
+				@catch (NSException *exception) {
+					readErrorReason = [exception reason];
+					atomic_store(&readFailed, true);
+					break;
+				}
+
+				uint64_t elapsed = SPPipelineTimestamp() - start;
+				NSUInteger readLength = [fileHandle realDataReadLength];
+
+				atomic_fetch_add(&readBusyNanoseconds, elapsed);
+				atomic_store(&storedLength, readLength);
+
+				if (![chunk length]) break;
+
+				[statistics addFileBytes:[chunk length]];
+				[statistics addStoredFileBytes:(readLength > lastStoredLength) ? readLength - lastStoredLength : 0];
+				[statistics addNanoseconds:elapsed toStage:compressed ? SPTransferCompressionStage : SPTransferDiskStage];
+
+				lastStoredLength = readLength;
+
+				[chunkQueue enqueue:chunk];
+			}
+		}
+
+		[chunkQueue close];
+
+		dispatch_semaphore_signal(readFinished);
+	}
+}
+
+/**
+ * Splits the queued chunks into statements and queues them in batches, until the chunks run out,
+ * a statement can't be decoded or the queue is cancelled. After a statement which may change the
+ * sql_mode, splitting waits for the consumer to report the server's backslash handling.
+ *
+ * Files in encodings which can't be split as bytes are decoded a line at a time, as multibyte
+ * characters can't contain a line ending, and passed on to the splitter as UTF-8. The decoded
+ * text is kept until it has been split, so the file bytes it was read from can be counted as
+ * processed. Other files' chunks are split where they are, without being copied, and kept until
+ * they have been split.
+ */
+- (void)splitStatements
+{
+	@autoreleasepool {
+		BOOL splitFileBytes = SPSQLEncodingCanBeSplitAsBytes(encoding);
+		NSStringEncoding statementEncoding = splitFileBytes ? encoding : NSUTF8StringEncoding;
+		NSMutableData *lineBuffer = splitFileBytes ? nil : [NSMutableData data];
+		NSMutableData *unsplitText = splitFileBytes ? nil : [NSMutableData data];
+		NSUInteger unsplitTextStart = 0;
+		NSUInteger unsplitFileLength = 0;
+		uint64_t splitTextLength = 0;
+		NSMutableArray *splitChunks = [NSMutableArray array];
+		uint64_t splitChunksStart = 0;
+		NSMutableArray *batch = [NSMutableArray arrayWithCapacity:SPSQLImportStatementBatchSize];
+		NSUInteger sequenceNumber = startSequenceNumber;
+		NSUInteger processedLength = startOffset;
+		NSString *delimiter = nil;
+		size_t delimiterLength = 0;
+		const uint8_t *delimiterBytes = SPSQLStatementSplitterDelimiter(splitter, &delimiterLength);
+		NSData *lastDelimiterBytes = [NSData dataWithBytes:delimiterBytes length:delimiterLength];
+		BOOL endOfInput = NO;
+		BOOL stopped = NO;
+		SPSQLStatement statement;
+
+		while (!endOfInput && !stopped && ![statementQueue isCancelled])
+		{
+			@autoreleasepool {
+				NSData *chunk = [chunkQueue dequeue];
+				uint64_t start = SPPipelineTimestamp();
+
+				// Don't run a statement cut short by a read error or cancellation
+				if (!chunk && ([chunkQueue isCancelled] || atomic_load(&readFailed))) break;
+
+				endOfInput = (chunk == nil);
+
+				if (splitFileBytes) {
+					if (chunk) {
+						if (!SPSQLStatementSplitterAppendNoCopy(splitter, [chunk bytes], [chunk length])) {
+							[NSException raise:NSMallocException format:@"Unable to allocate memory for the SQL import buffer"];
+						}
+
+						[splitChunks addObject:chunk];
+					}
+
+					// Let go of the chunks the splitter has finished with
+					while ([splitChunks count] && splitChunksStart + [[splitChunks objectAtIndex:0] length] <= SPSQLStatementSplitterConsumedLength(splitter))
+					{
+						splitChunksStart += [[splitChunks objectAtIndex:0] length];
+						[splitChunks removeObjectAtIndex:0];
+					}
+				}
+				else {
+					if (chunk) [lineBuffer appendData:chunk];
+
+					// Decode up to the last line ending, or everything at the end of the file
+					const uint8_t *lineBytes = [lineBuffer bytes];
+					NSUInteger lineLength = [lineBuffer length];
+
+					if (!endOfInput) {
+						while (lineLength && lineBytes[lineLength - 1] != 0x0A && lineBytes[lineLength - 1] != 0x0D) lineLength--;
+					}
+
+					if (lineLength) {
+						NSString *lines = [[NSString alloc] initWithBytes:lineBytes length:lineLength encoding:encoding];
+
+						if (!lines) {
+							decodingFailed = YES;
+							stopped = YES;
+						}
+						else {
+							NSData *utf8Lines = [lines dataUsingEncoding:NSUTF8StringEncoding];
+
+							if (!SPSQLStatementSplitterAppend(splitter, [utf8Lines bytes], [utf8Lines length])) {
+								[NSException raise:NSMallocException format:@"Unable to allocate memory for the SQL import buffer"];
+							}
+
+							// Keep the text alongside the number of file bytes it was decoded from
+							if (unsplitTextStart) {
+								[unsplitText replaceBytesInRange:NSMakeRange(0, unsplitTextStart) withBytes:NULL length:0];
+								unsplitTextStart = 0;
+							}
+
+							[unsplitText appendData:utf8Lines];
+							unsplitFileLength += lineLength;
+
+							[lineBuffer replaceBytesInRange:NSMakeRange(0, lineLength) withBytes:NULL length:0];
+						}
+					}
+				}
+
+				while (!stopped && SPSQLStatementSplitterNextStatement(splitter, endOfInput, &statement))
+				{
+					NSString *query = [[NSString alloc] initWithBytes:statement.bytes length:statement.length encoding:statementEncoding];
+
+					if (!query) {
+						decodingFailed = YES;
+						stopped = YES;
+						break;
+					}
+
+					if (splitFileBytes) {
+						processedLength = startOffset + (NSUInteger)SPSQLStatementSplitterConsumedLength(splitter);
+					}
+					else {
+						// Count the file bytes of everything split so far, including delimiters, comments and
+						// DELIMITER commands. Text split up to the end of what was decoded is counted exactly,
+						// and part way through by encoding it back, which is exact at a statement boundary.
+						uint64_t consumedLength = SPSQLStatementSplitterConsumedLength(splitter);
+						NSUInteger textLength = (NSUInteger)(consumedLength - splitTextLength);
+
+						if (textLength >= [unsplitText length] - unsplitTextStart) {
+							processedLength += unsplitFileLength;
+
+							[unsplitText setLength:0];
+							unsplitTextStart = 0;
+							unsplitFileLength = 0;
+						}
+						else if (textLength) {
+							NSString *splitText = [[NSString alloc] initWithBytesNoCopy:(uint8_t *)[unsplitText mutableBytes] + unsplitTextStart length:textLength encoding:NSUTF8StringEncoding freeWhenDone:NO];
+							NSUInteger fileLength = MIN([splitText lengthOfBytesUsingEncoding:encoding], unsplitFileLength);
+
+							processedLength += fileLength;
+
+							unsplitTextStart += textLength;
+							unsplitFileLength -= fileLength;
+						}
+
+						splitTextLength = consumedLength;
+					}
+
+					if (statement.containsCarriageReturns) query = [SPSQLParser normaliseQueryForExecution:query];
+
+					BOOL mayChangeServerStatus = SPSQLStatementMaySetSQLMode(statement.bytes, statement.length);
+
+					// Statements share the delimiter's string until a DELIMITER command changes it
+					delimiterBytes = SPSQLStatementSplitterDelimiter(splitter, &delimiterLength);
+
+					if (!delimiter || delimiterLength != [lastDelimiterBytes length] || memcmp(delimiterBytes, [lastDelimiterBytes bytes], delimiterLength)) {
+						lastDelimiterBytes = [NSData dataWithBytes:delimiterBytes length:delimiterLength];
+						delimiter = [[NSString alloc] initWithData:lastDelimiterBytes encoding:statementEncoding];
+					}
+
+					[batch addObject:[[SPSQLImportStatement alloc] initWithQuery:query
+					                                             sequenceNumber:++sequenceNumber
+					                                            processedLength:processedLength
+					                                               storedLength:atomic_load(&storedLength)
+					                                                queryLength:statement.length
+					                                                  delimiter:delimiter
+					                                      mayChangeServerStatus:mayChangeServerStatus
+					                                               canBeBatched:SPSQLStatementCanBeBatched(statement.bytes, statement.length)]];
+
+					atomic_fetch_add(&statementCount, 1);
+
+					if (mayChangeServerStatus) {
+						atomic_fetch_add(&splitBusyNanoseconds, SPPipelineTimestamp() - start);
+
+						// Hand the statement over and wait to hear how the server now treats backslashes
+						[statementQueue enqueue:batch];
+						batch = [NSMutableArray arrayWithCapacity:SPSQLImportStatementBatchSize];
+
+						uint64_t waitStart = SPPipelineTimestamp();
+
+						dispatch_semaphore_wait(serverStatusUpdated, DISPATCH_TIME_FOREVER);
+
+						start = SPPipelineTimestamp();
+						atomic_fetch_add(&serverStatusWaitNanoseconds, start - waitStart);
+
+						if ([statementQueue isCancelled]) {
+							stopped = YES;
+							break;
+						}
+
+						SPSQLStatementSplitterSetNoBackslashEscapes(splitter, atomic_load(&noBackslashEscapes));
+					}
+					else if ([batch count] == SPSQLImportStatementBatchSize) {
+						[statementQueue enqueue:batch];
+						batch = [NSMutableArray arrayWithCapacity:SPSQLImportStatementBatchSize];
+					}
+				}
+
+				uint64_t elapsed = SPPipelineTimestamp() - start;
+
+				atomic_fetch_add(&splitBusyNanoseconds, elapsed);
+				[statistics addNanoseconds:elapsed toStage:SPTransferEncodingStage];
+
+				// Don't keep a part batch back while waiting for the next chunk
+				if ([batch count]) {
+					[statementQueue enqueue:batch];
+					batch = [NSMutableArray arrayWithCapacity:SPSQLImportStatementBatchSize];
+				}
+			}
+		}
+
+		[statementQueue close];
+
+		// Release the read thread if splitting stopped before the end of the file
+		[chunkQueue cancel];
+
+		dispatch_semaphore_signal(splitFinished);
+	}
+}
+
+- (void)dealloc
+{
+	SPSQLStatementSplitterFree(splitter);
+}
+
+@end
+
+#pragma mark -
+
+@interface SPSQLStatementReader ()
+
+- (void)_waitForStages;
+
+@end
+
+@implementation SPSQLStatementReader
+
+/**
+ * Initialises a reader for the supplied file handle, which must not yet have been read from,
+ * and starts reading. The chunks read, and the time spent reading and splitting them, are
+ * added to the supplied statistics.
+ */
+- (instancetype)initWithFileHandle:(SPFileHandle *)fileHandle encoding:(NSStringEncoding)encoding noBackslashEscapes:(BOOL)noBackslashEscapes statistics:(SPTransferStatistics *)statistics
+{
+	return [self initWithFileHandle:fileHandle encoding:encoding noBackslashEscapes:noBackslashEscapes statistics:statistics resumingAtOffset:0 afterStatement:0 delimiter:nil];
+}
+
+/**
+ * Initialises a reader which carries on part way through a file, after a statement returned by an
+ * earlier reader. The file handle must already have been moved past the statement's processed
+ * length, and the statement's delimiter is used until the file changes it; statements are then
+ * numbered, and their processed lengths counted, as if the whole file had been read.
+ */
+- (instancetype)initWithFileHandle:(SPFileHandle *)fileHandle encoding:(NSStringEncoding)encoding noBackslashEscapes:(BOOL)noBackslashEscapes statistics:(SPTransferStatistics *)statistics resumingAtOffset:(NSUInteger)offset afterStatement:(NSUInteger)sequenceNumber delimiter:(NSString *)delimiter
+{
+	if ((self = [super init])) {
+		readStage = [[SPSQLStatementReadStage alloc] init];
+
+		readStage->fileHandle = fileHandle;
+		readStage->encoding = encoding;
+		readStage->statistics = statistics;
+		readStage->splitter = SPSQLStatementSplitterCreate();
+		readStage->startOffset = offset;
+		readStage->startSequenceNumber = sequenceNumber;
+		readStage->chunkQueue = [[SPBoundedQueue alloc] initWithCapacity:SPSQLImportChunkQueueCapacity];
+		readStage->statementQueue = [[SPBoundedQueue alloc] initWithCapacity:SPSQLImportStatementQueueCapacity];
+		readStage->serverStatusUpdated = dispatch_semaphore_create(0);
+		readStage->readFinished = dispatch_semaphore_create(0);
+		readStage->splitFinished = dispatch_semaphore_create(0);
+
+		atomic_init(&readStage->noBackslashEscapes, noBackslashEscapes);
+		atomic_init(&readStage->readFailed, false);
+		atomic_init(&readStage->storedLength, 0);
+		atomic_init(&readStage->readBusyNanoseconds, 0);
+		atomic_init(&readStage->splitBusyNanoseconds, 0);
+		atomic_init(&readStage->serverStatusWaitNanoseconds, 0);
+		atomic_init(&readStage->statementCount, 0);
+		atomic_init(&readStage->finished, false);
+
+		SPSQLStatementSplitterSetNoBackslashEscapes(readStage->splitter, noBackslashEscapes);
+
+		if ([delimiter length]) {
+			NSData *delimiterData = [delimiter dataUsingEncoding:SPSQLEncodingCanBeSplitAsBytes(encoding) ? encoding : NSUTF8StringEncoding];
+
+			SPSQLStatementSplitterSetDelimiter(readStage->splitter, [delimiterData bytes], [delimiterData length]);
+		}
+
+		currentBatch = nil;
+		currentBatchIndex = 0;
+
+		NSThread *readThread = [[NSThread alloc] initWithTarget:readStage selector:@selector(readChunks) object:nil];
+		NSThread *splitThread = [[NSThread alloc] initWithTarget:readStage selector:@selector(splitStatements) object:nil];
+
+		[readThread setName:@"SPSQLStatementReader file reading thread"];
+		[splitThread setName:@"SPSQLStatementReader statement splitting thread"];
+
+		[readThread start];
+		[splitThread start];
+	}
+
+	return self;
+}
+
+/**
+ * Returns the next statement in the file, waiting for it to be split if necessary, or nil once
+ * all statements have been returned. If the statement may change the sql_mode, call
+ * resumeWithNoBackslashEscapes: once it has been executed.
+ */
+- (SPSQLImportStatement *)nextStatement
+{
+	if (currentBatchIndex == [currentBatch count]) {
+		currentBatch = [readStage->statementQueue dequeue];
+		currentBatchIndex = 0;
+
+		if (!currentBatch) {
+			[self _waitForStages];
+			return nil;
+		}
+	}
+
+	return [currentBatch objectAtIndex:currentBatchIndex++];
+}
+
+/**
+ * Lets splitting continue after a statement which may have changed the sql_mode, with the
+ * server's current NO_BACKSLASH_ESCAPES setting.
+ */
+- (void)resumeWithNoBackslashEscapes:(BOOL)noBackslashEscapes
+{
+	atomic_store(&readStage->noBackslashEscapes, noBackslashEscapes);
+
+	dispatch_semaphore_signal(readStage->serverStatusUpdated);
+}
+
+/**
+ * Stops reading and splitting, discards any statements which haven't been returned and waits
+ * for both threads to finish with the file handle.
+ */
+- (void)cancel
+{
+	if (atomic_load(&readStage->finished)) return;
+
+	[readStage->statementQueue cancel];
+	[readStage->chunkQueue cancel];
+
+	// Wake the split thread if it's waiting to resume
+	dispatch_semaphore_signal(readStage->serverStatusUpdated);
+
+	[self _waitForStages];
+
+	currentBatch = nil;
+	currentBatchIndex = 0;
+}
+
+/**
+ * Returns the reason reading the file failed, or nil if it didn't.
+ */
+- (NSString *)readErrorReason
+{
+	return readStage->readErrorReason;
+}
+
+/**
+ * Returns whether part of the file couldn't be decoded in its encoding.
+ */
+- (BOOL)decodingFailed
+{
+	return readStage->decodingFailed;
+}
+
+/**
+ * Returns how the read stage has spent its time: busy reading and decompressing chunks, or
+ * waiting for the split stage to make room for another.
+ */
+- (SPPipelineStageCounters)readStageCounters
+{
+	SPPipelineStageCounters counters;
+
+	counters.items = [readStage->chunkQueue enqueuedCount];
+	counters.busyNanoseconds = atomic_load(&readStage->readBusyNanoseconds);
+	counters.waitNanoseconds = [readStage->chunkQueue producerWaitNanoseconds];
+
+	return counters;
+}
+
+/**
+ * Returns how the split stage has spent its time: busy splitting and decoding statements, or
+ * waiting for chunks, for room for another batch or for the consumer to resume it.
+ */
+- (SPPipelineStageCounters)splitStageCounters
+{
+	SPPipelineStageCounters counters;
+
+	counters.items = atomic_load(&readStage->statementCount);
+	counters.busyNanoseconds = atomic_load(&readStage->splitBusyNanoseconds);
+	counters.waitNanoseconds = [readStage->chunkQueue consumerWaitNanoseconds] + [readStage->statementQueue producerWaitNanoseconds] + atomic_load(&readStage->serverStatusWaitNanoseconds);
+
+	return counters;
+}
+
+/**
+ * Returns the time the consumer has spent waiting for statements to be split.
+ */
+- (uint64_t)statementWaitNanoseconds
+{
+	return [readStage->statementQueue consumerWaitNanoseconds];
+}
+
+#pragma mark -
+#pragma mark Private API
+
+/**
+ * Waits for both threads to exit, so the error state is final and the file handle is free.
+ */
+- (void)_waitForStages
+{
+	if (atomic_exchange(&readStage->finished, true)) return;
+
+	dispatch_semaphore_wait(readStage->splitFinished, DISPATCH_TIME_FOREVER);
+	dispatch_semaphore_wait(readStage->readFinished, DISPATCH_TIME_FOREVER);
+}
+
+#pragma mark -
+
+- (void)dealloc
+{
+	// Stop the threads if the consumer gave up without cancelling
+	[readStage->statementQueue cancel];
+	[readStage->chunkQueue cancel];
+	dispatch_semaphore_signal(readStage->serverStatusUpdated);
+}
+
+@end
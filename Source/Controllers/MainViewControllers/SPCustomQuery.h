@@ -222,6 +222,7 @@
 // Accessors
 - (NSArray *)currentResult;
 - (NSArray *)currentDataResultWithNULLs:(BOOL)includeNULLs truncateDataFields:(BOOL)truncate;
+- (NSArray *)currentDataResultForExport;
 - (NSUInteger)currentResultRowCount;
 - (void)updateResultStore:(SPMySQLStreamingResultStore *)theResultStore;
 
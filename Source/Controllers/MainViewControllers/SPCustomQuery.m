@@ -44,6 +44,7 @@
 #import "SPQueryController.h"
 #import "SPEncodingPopupAccessory.h"
 #import "SPDataStorage.h"
+#import "SPExportLoadedResult.h"
 #import "SPCopyTable.h"
 #import "SPGeometryDataView.h"
 #import "SPSplitView.h"
@@ -1878,6 +1879,29 @@ static NSString * const SPDashStyleCommentMarker = @"-- ";
     return currentResult;
 }
 
+/**
+ * Returns the current result for exporting, in the same layout as currentDataResultWithNULLs:YES
+ * truncateDataFields:NO. Once the result has completely loaded, its rows are read from the result
+ * store as they are exported rather than being copied up front.
+ *
+ * MUST BE CALLED ON THE UI THREAD!
+ */
+- (NSArray *)currentDataResultForExport
+{
+    if (isWorking) return [self currentDataResultWithNULLs:YES truncateDataFields:NO];
+
+    NSMutableArray *fieldNames = [NSMutableArray array];
+    NSMutableArray *columnIndexes = [NSMutableArray array];
+
+    for (NSTableColumn *tableColumn in [customQueryView tableColumns])
+    {
+        [fieldNames addObject:[[[tableColumn headerCell] stringValue] componentsSeparatedByString:[NSString columnHeaderSplittingSpace]][0]];
+        [columnIndexes addObject:@([[tableColumn identifier] integerValue])];
+    }
+
+    return [[SPExportLoadedResult alloc] initWithDataStorage:resultData fieldNames:fieldNames columnIndexes:columnIndexes stringEncoding:[mySQLConnection stringEncoding]];
+}
+
 #pragma mark -
 #pragma mark Additional methods
 
@@ -71,6 +71,9 @@ typedef NS_ENUM(NSUInteger, SPExportType) {
 	SPPDFExport   = 4,
 	SPHTMLExport  = 5,
 	SPExcelExport = 6,
+	SPArrowExport = 7,
+	SPParquetExport = 8,
+	SPJSONExport  = 9,
 	SPAnyExportType = NSUIntegerMax, // this is a transient type to indicate "no specific choice"
 };
 
@@ -93,6 +96,18 @@ typedef NS_ENUM(NSUInteger, SPXMLExportFormat) {
 	SPXMLExportPlainFormat = 1
 };
 
+// JSON export formats
+typedef NS_ENUM(NSUInteger, SPJSONExportFormat) {
+	SPJSONExportNDJSONFormat = 0, // One object per line
+	SPJSONExportArrayFormat  = 1  // A single array of objects
+};
+
+// JSON export encodings of binary data
+typedef NS_ENUM(NSUInteger, SPJSONExportBinaryEncoding) {
+	SPJSONExportBase64Encoding = 0,
+	SPJSONExportHexEncoding    = 1
+};
+
 // Table row count query usage levels
 typedef enum {
 	SPRowCountFetchNever   = 0,
@@ -294,6 +309,7 @@ extern NSString *SPFConnectionContentType;
 extern NSString *SPThemesSupportFolder;
 extern NSString *SPBundleSupportFolder;
 extern NSString *SPDataSupportFolder;
+extern NSString *SPImportCheckpointsSupportFolder;
 
 // Table filter
 extern NSString *SPTableContentFilterKey;
@@ -420,6 +436,22 @@ extern NSString *SPCSVImportFirstLineIsHeader;
 extern NSString *SPCSVFieldImportMappingAlignment;
 extern NSString *SPImportClipboardTempFileNamePrefix;
 extern NSString *SPLastExportSettings;
+extern NSString *SPExportChunkedByPrimaryKey;
+extern NSString *SPExportChunkRowCount;
+extern NSString *SPExportSplitFileSizeMB;
+extern NSString *SPExportSplitFileRowCount;
+extern NSString *SPWriteTransferReports;
+extern NSString *SPImportBatchStatements;
+extern NSString *SPImportParallelRestore;
+extern NSString *SPImportParallelRestoreConnections;
+extern NSString *SPCSVImportUseLoadData;
+extern NSString *SPCSVImportParallelParsing;
+extern NSString *SPCSVImportPreparedInserts;
+extern NSString *SPImportFastBulkLoad;
+extern NSString *SPImportBulkLoadTransactionRows;
+extern NSString *SPImportBulkLoadDisableKeys;
+extern NSString *SPImportCheckpoints;
+extern NSString *SPExportInterruptedError;
 extern NSString *SPAutoCheckClipboardForConnectionStrings;
 
 // Export filename tokens
@@ -100,6 +100,7 @@ NSString *SPSSHConfigContainsUserKnownHostsFile  = @"SSHConfigContainsUserKnownH
 NSString *SPThemesSupportFolder                  = @"Themes";
 NSString *SPBundleSupportFolder                  = @"Bundles";
 NSString *SPDataSupportFolder                    = @"Data";
+NSString *SPImportCheckpointsSupportFolder       = @"Import Checkpoints";
 
 // Table filter
 NSString *SPTableContentFilterKey                = @"filter";
@@ -231,6 +232,22 @@ NSString *SPCSVImportLineTerminator              = @"CSVImportLineTerminator";
 NSString *SPCSVFieldImportMappingAlignment       = @"CSVFieldImportMappingAlignment";
 NSString *SPImportClipboardTempFileNamePrefix    = @"~/tmp/_SP_ClipBoard_Import_File_";
 NSString *SPLastExportSettings                   = @"LastExportSettings";
+NSString *SPExportChunkedByPrimaryKey            = @"ExportChunkedByPrimaryKey";
+NSString *SPExportChunkRowCount                  = @"ExportChunkRowCount";
+NSString *SPExportSplitFileSizeMB                = @"ExportSplitFileSizeMB";
+NSString *SPExportSplitFileRowCount              = @"ExportSplitFileRowCount";
+NSString *SPWriteTransferReports                 = @"WriteTransferReports";
+NSString *SPImportBatchStatements                = @"ImportBatchStatements";
+NSString *SPImportParallelRestore                = @"ImportParallelRestore";
+NSString *SPImportParallelRestoreConnections     = @"ImportParallelRestoreConnections";
+NSString *SPCSVImportUseLoadData                 = @"CSVImportUseLoadData";
+NSString *SPCSVImportParallelParsing             = @"CSVImportParallelParsing";
+NSString *SPCSVImportPreparedInserts             = @"CSVImportPreparedInserts";
+NSString *SPImportFastBulkLoad                   = @"ImportFastBulkLoad";
+NSString *SPImportBulkLoadTransactionRows        = @"ImportBulkLoadTransactionRows";
+NSString *SPImportBulkLoadDisableKeys            = @"ImportBulkLoadDisableKeys";
+NSString *SPImportCheckpoints                    = @"ImportCheckpoints";
+NSString *SPExportInterruptedError               = @"exportInterrupted";
 NSString *SPAutoCheckClipboardForConnectionStrings = @"AutoCheckClipboardForConnectionStrings";
 NSString *SASecureBookmarks                      = @"SPSecureBookmarks"; // MUST be SPSecureBookmarks for var name SASecureBookmarks
 NSString *SPStaleSecureBookmarks                 = @"SPStaleSecureBookmarks";
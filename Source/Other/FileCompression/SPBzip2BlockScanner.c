@@ -0,0 +1,302 @@
+//
+//  SPBzip2BlockScanner.c
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#include "SPBzip2BlockScanner.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define SPBzip2BlockMagic 0x314159265359ULL
+#define SPBzip2StreamEndMagic 0x177245385090ULL
+#define SPBzip2MagicMask 0xFFFFFFFFFFFFULL
+#define SPBzip2MagicBits 48
+#define SPBzip2CRCBits 32
+#define SPBzip2NoBlock UINT64_MAX
+#define SPBzip2ScannerMinimumCapacity (1024 * 1024)
+
+struct SPBzip2BlockScanner {
+	uint8_t *buffer;
+	size_t length;
+	size_t capacity;
+	uint64_t discardedLength;  // Bytes dropped from the front of the buffer
+	uint64_t scannedLength;    // Bytes of the file scanned so far
+	uint64_t window;           // The last 64 bits scanned
+	uint64_t blockStart;       // The bit offset in the file of the current block's magic, or SPBzip2NoBlock
+	uint64_t captureStart;     // The bit offset in the file the current block's bits are kept from, or SPBzip2NoBlock
+};
+
+/**
+ * Reads count bits, at most 64, starting at a bit offset, most significant bit first.
+ */
+static uint64_t SPBzip2ReadBits(const uint8_t *bytes, uint64_t bit, unsigned count)
+{
+	uint64_t value = 0;
+
+	for (unsigned i = 0; i < count; i++, bit++)
+	{
+		value = (value << 1) | ((bytes[bit >> 3] >> (7 - (bit & 7))) & 1);
+	}
+
+	return value;
+}
+
+/**
+ * Writes count bits from a bit offset of the source to a bit offset of the destination, whose
+ * bytes from there on must start zeroed. Copies to a byte boundary are done a byte at a time.
+ */
+static void SPBzip2CopyBits(uint8_t *destination, uint64_t destinationBit, const uint8_t *source, uint64_t sourceBit, uint64_t count)
+{
+	if (!(destinationBit & 7)) {
+		uint8_t *output = destination + (destinationBit >> 3);
+		const uint8_t *input = source + (sourceBit >> 3);
+		unsigned shift = sourceBit & 7;
+		uint64_t wholeBytes = count >> 3;
+
+		if (!shift) {
+			memcpy(output, input, (size_t)wholeBytes);
+		}
+		else {
+			for (uint64_t i = 0; i < wholeBytes; i++)
+			{
+				output[i] = (uint8_t)((input[i] << shift) | (input[i + 1] >> (8 - shift)));
+			}
+		}
+
+		destinationBit += wholeBytes << 3;
+		sourceBit += wholeBytes << 3;
+		count &= 7;
+	}
+
+	for (uint64_t i = 0; i < count; i++, destinationBit++, sourceBit++)
+	{
+		if ((source[sourceBit >> 3] >> (7 - (sourceBit & 7))) & 1) destination[destinationBit >> 3] |= (uint8_t)(0x80 >> (destinationBit & 7));
+	}
+}
+
+/**
+ * Writes the low count bits of a value at a bit offset of the destination, which must start zeroed.
+ */
+static void SPBzip2WriteBits(uint8_t *destination, uint64_t destinationBit, uint64_t value, unsigned count)
+{
+	for (unsigned i = count; i > 0; i--, destinationBit++)
+	{
+		if ((value >> (i - 1)) & 1) destination[destinationBit >> 3] |= (uint8_t)(0x80 >> (destinationBit & 7));
+	}
+}
+
+/**
+ * Copies the bits of the file kept for the current block, up to an end bit, into a block.
+ */
+static bool SPBzip2ScannerTakeBlock(SPBzip2BlockScanner *scanner, uint64_t end, SPBzip2Block *block)
+{
+	uint64_t bitLength = end - scanner->captureStart;
+	size_t byteLength = (size_t)((bitLength + 7) >> 3);
+
+	// One spare byte, as a shifted copy reads the byte after the last
+	block->bytes = calloc(byteLength + 1, 1);
+	if (!block->bytes) return false;
+
+	SPBzip2CopyBits(block->bytes, 0, scanner->buffer, scanner->captureStart - (scanner->discardedLength << 3), bitLength);
+
+	block->bitLength = bitLength;
+	block->startBit = scanner->blockStart - scanner->captureStart;
+	block->compressedEnd = (end + 7) >> 3;
+
+	return true;
+}
+
+SPBzip2BlockScanner *SPBzip2BlockScannerCreate(void)
+{
+	SPBzip2BlockScanner *scanner = calloc(1, sizeof(SPBzip2BlockScanner));
+
+	if (!scanner) return NULL;
+
+	scanner->blockStart = SPBzip2NoBlock;
+	scanner->captureStart = SPBzip2NoBlock;
+
+	return scanner;
+}
+
+void SPBzip2BlockScannerFree(SPBzip2BlockScanner *scanner)
+{
+	if (!scanner) return;
+
+	free(scanner->buffer);
+	free(scanner);
+}
+
+bool SPBzip2BlockScannerAppend(SPBzip2BlockScanner *scanner, const void *bytes, size_t length)
+{
+	// Drop everything before the bits kept for the current block or, if there are none, everything
+	// scanned but the last few bytes, which may yet prove to start a magic number
+	uint64_t keepFrom = scanner->captureStart >> 3;
+
+	if (scanner->captureStart == SPBzip2NoBlock) {
+		keepFrom = (scanner->scannedLength > scanner->discardedLength + 7) ? scanner->scannedLength - 7 : scanner->discardedLength;
+	}
+	size_t discard = (size_t)(keepFrom - scanner->discardedLength);
+
+	if (discard) {
+		memmove(scanner->buffer, scanner->buffer + discard, scanner->length - discard);
+
+		scanner->length -= discard;
+		scanner->discardedLength += discard;
+	}
+
+	// Keep a spare byte beyond the data for shifted copies to read
+	if (scanner->length + length + 1 > scanner->capacity) {
+		size_t capacity = scanner->capacity ? scanner->capacity : SPBzip2ScannerMinimumCapacity;
+
+		while (capacity < scanner->length + length + 1) capacity *= 2;
+
+		uint8_t *buffer = realloc(scanner->buffer, capacity);
+
+		if (!buffer) return false;
+
+		scanner->buffer = buffer;
+		scanner->capacity = capacity;
+	}
+
+	memcpy(scanner->buffer + scanner->length, bytes, length);
+	scanner->length += length;
+	scanner->buffer[scanner->length] = 0;
+
+	return true;
+}
+
+bool SPBzip2BlockScannerNextBlock(SPBzip2BlockScanner *scanner, bool endOfInput, SPBzip2Block *block, bool *failed)
+{
+	uint64_t end = scanner->discardedLength + scanner->length;
+
+	*failed = false;
+
+	while (scanner->scannedLength < end)
+	{
+		scanner->window = (scanner->window << 8) | scanner->buffer[scanner->scannedLength - scanner->discardedLength];
+		scanner->scannedLength++;
+
+		// Less than a whole magic number has been read
+		if (scanner->scannedLength < 6) continue;
+
+		// Try the earliest bit offset first; a magic number can't match twice within a byte
+		for (int shift = 7; shift >= 0; shift--)
+		{
+			uint64_t candidate = (scanner->window >> shift) & SPBzip2MagicMask;
+
+			if (candidate != SPBzip2BlockMagic && candidate != SPBzip2StreamEndMagic) continue;
+			if (scanner->scannedLength < 7 && shift) continue;
+
+			uint64_t magicStart = (scanner->scannedLength << 3) - (uint64_t)shift - SPBzip2MagicBits;
+			bool blockFound = false;
+
+			// A block ends at the next magic number of either kind
+			if (scanner->blockStart != SPBzip2NoBlock) {
+				if (!SPBzip2ScannerTakeBlock(scanner, magicStart, block)) {
+					*failed = true;
+					return false;
+				}
+
+				blockFound = true;
+				scanner->captureStart = magicStart;
+			}
+
+			// The bits after a stream's end are kept with the next block, unless this is the start of the file
+			if (candidate == SPBzip2BlockMagic) {
+				scanner->blockStart = magicStart;
+				if (scanner->captureStart == SPBzip2NoBlock) scanner->captureStart = magicStart;
+			}
+			else {
+				scanner->blockStart = SPBzip2NoBlock;
+			}
+
+			if (blockFound) return true;
+
+			break;
+		}
+	}
+
+	// A stream cut short leaves its last block without an end
+	if (endOfInput && scanner->blockStart != SPBzip2NoBlock) {
+		if (!SPBzip2ScannerTakeBlock(scanner, end << 3, block)) {
+			*failed = true;
+			return false;
+		}
+
+		scanner->blockStart = SPBzip2NoBlock;
+		scanner->captureStart = SPBzip2NoBlock;
+
+		return true;
+	}
+
+	return false;
+}
+
+void SPBzip2BlockFree(SPBzip2Block *block)
+{
+	free(block->bytes);
+	block->bytes = NULL;
+}
+
+uint8_t *SPBzip2StreamCreate(const SPBzip2Block *blocks, size_t blockCount, size_t *length)
+{
+	static const uint8_t header[] = { 'B', 'Z', 'h', '9' };
+
+	// Only the first block's bits are taken from its magic number on; the blocks joined to it were
+	// found by false matches, so everything kept before them belongs to the first
+	uint64_t bitLength = (sizeof(header) << 3) - blocks[0].startBit;
+
+	for (size_t i = 0; i < blockCount; i++) bitLength += blocks[i].bitLength;
+
+	bitLength += SPBzip2MagicBits + SPBzip2CRCBits;
+
+	*length = (size_t)((bitLength + 7) >> 3);
+
+	// One spare byte, as a shifted copy reads the byte after the last
+	uint8_t *stream = calloc(*length + 1, 1);
+
+	if (!stream) return NULL;
+
+	memcpy(stream, header, sizeof(header));
+
+	uint64_t bit = sizeof(header) << 3;
+
+	for (size_t i = 0; i < blockCount; i++)
+	{
+		uint64_t startBit = i ? 0 : blocks[0].startBit;
+
+		SPBzip2CopyBits(stream, bit, blocks[i].bytes, startBit, blocks[i].bitLength - startBit);
+		bit += blocks[i].bitLength - startBit;
+	}
+
+	// The stream's combined CRC is just the CRC of its one block, which follows the block's magic
+	SPBzip2WriteBits(stream, bit, SPBzip2StreamEndMagic, SPBzip2MagicBits);
+	SPBzip2WriteBits(stream, bit + SPBzip2MagicBits, SPBzip2ReadBits(blocks[0].bytes, blocks[0].startBit + SPBzip2MagicBits, SPBzip2CRCBits), SPBzip2CRCBits);
+
+	return stream;
+}
@@ -0,0 +1,94 @@
+//
+//  SPBzip2BlockScanner.h
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#ifndef __SPBzip2BlockScanner__
+#define __SPBzip2BlockScanner__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Splits a bzip2 file into its compressed blocks, so that they can be decompressed at the same time.
+ *
+ * Each block of a bzip2 stream is compressed independently and starts with a 48-bit magic number,
+ * but at any bit offset rather than on a byte boundary; the stream ends with another 48-bit magic
+ * number and the combined CRC of its blocks. The file is scanned for these bit patterns, and each
+ * block found can then be made into a standalone single-block stream to be decompressed by libbz2.
+ * Files holding several streams one after another, as written by parallel compressors, are split
+ * into the blocks of all of them.
+ *
+ * The magic numbers can, very rarely, also turn up inside compressed data. A block ended by such a
+ * false match won't decompress on its own, but does once joined with the block after it, which is
+ * why a stream can be made from several blocks; so that nothing is lost by the join, each block
+ * keeps any bits between the end of the block before it and its own magic number.
+ *
+ * A scanner is NOT thread safe.
+ */
+typedef struct SPBzip2BlockScanner SPBzip2BlockScanner;
+
+/**
+ * A compressed block: its bits, from the end of the block before it up to the next block or the
+ * end of its stream, copied to start on a byte boundary. The block itself starts at its magic
+ * number, startBit bits in; anything before that is the end of the previous stream.
+ */
+typedef struct {
+	uint8_t *bytes;
+	uint64_t bitLength;
+	uint64_t startBit;
+	uint64_t compressedEnd;  // The offset in the file of the byte holding the block's last bit, plus one
+} SPBzip2Block;
+
+SPBzip2BlockScanner *SPBzip2BlockScannerCreate(void);
+void SPBzip2BlockScannerFree(SPBzip2BlockScanner *scanner);
+
+/**
+ * Appends the next chunk of the file, returning false if the buffer could not be grown.
+ */
+bool SPBzip2BlockScannerAppend(SPBzip2BlockScanner *scanner, const void *bytes, size_t length);
+
+/**
+ * Finds the next complete block in the appended data, returning false if more data is needed or,
+ * once endOfInput is passed, there are no more blocks; a stream cut short at the end of the file is
+ * returned as a final block which won't decompress. The block's bytes must be freed with
+ * SPBzip2BlockFree. Returns false as well if the block could not be allocated, setting *failed.
+ */
+bool SPBzip2BlockScannerNextBlock(SPBzip2BlockScanner *scanner, bool endOfInput, SPBzip2Block *block, bool *failed);
+
+void SPBzip2BlockFree(SPBzip2Block *block);
+
+/**
+ * Makes a standalone bzip2 stream from a block, or from several consecutive blocks taken as one
+ * where the blocks after the first were only found by false matches. Returns a buffer to be freed
+ * with free(), or NULL if it could not be allocated.
+ */
+uint8_t *SPBzip2StreamCreate(const SPBzip2Block *blocks, size_t blockCount, size_t *length);
+
+#endif /* defined(__SPBzip2BlockScanner__) */
@@ -28,7 +28,21 @@
 //
 //  More info at <https://github.com/sequelpro/sequelpro>
 
+#import "SPBoundedQueue.h"
+
+@class SPMappedFile;
+@class SPParallelDecompressor;
+
 struct SPRawFileHandles;
+
+/**
+ * The background stages data passes through on its way to disk when writing.
+ */
+typedef NS_ENUM(NSInteger, SPFileHandleWriteStage) {
+	SPFileHandleCompressionStage = 0,
+	SPFileHandleDiskWriteStage   = 1
+};
+
 /**
  * @class SPFileHandle SPFileHandle.h
  *
@@ -37,23 +51,44 @@ struct SPRawFileHandles;
  * Provides a class which aims to duplicate some of the most-used functionality
  * of NSFileHandle, while also transparently supporting gzip and bzip2 compressed content
  * on reading; gzip and bzip2 compression is also supported on writing.
+ *
+ * Written data is gathered into blocks which are compressed on one background thread
+ * and written to disk on another, so the writing thread, the compressor and the disk
+ * all work at the same time.
+ *
+ * Files may also be read as a stream: uncompressed files through a memory mapping, which
+ * hands out the data without copying it, and compressed files by decompressing them on
+ * background threads ahead of the reads. Once this has started all reading goes through it.
  */
 @interface SPFileHandle : NSObject 
 {
 	struct SPRawFileHandles *wrappedFile;
 	char *wrappedFilePath;
+	SPMappedFile *mappedFile;
+	SPParallelDecompressor *decompressor;
+	unsigned long long decompressedReadLength;
 
 	NSMutableData *buffer;
 	NSUInteger bufferDataLength;
 	NSUInteger bufferPosition;
 	BOOL endOfFile;
 	pthread_mutex_t bufferLock;
-	NSThread *processingThread;
+
+	SPBoundedQueue *compressionQueue;
+	SPBoundedQueue *writeQueue;
+	NSThread *compressionThread;
+	NSThread *writeThread;
 
 	int fileMode;
 	BOOL dataWritten;
-	BOOL allDataWritten;
 	BOOL fileIsClosed;
+	unsigned long long dataQueuedLength;
+	_Atomic unsigned long long dataWrittenLength;
+	_Atomic unsigned long long dataStoredLength;
+	_Atomic bool writeFailed;
+
+	_Atomic uint64_t compressionBusyNanoseconds;
+	_Atomic uint64_t writeBusyNanoseconds;
 	
 	SPFileCompressionFormat compressionFormat;
 }
@@ -63,6 +98,7 @@ struct SPRawFileHandles;
 
 + (id)fileHandleForReadingAtPath:(NSString *)path;
 + (id)fileHandleForWritingAtPath:(NSString *)path;
++ (id)fileHandleForAppendingAtPath:(NSString *)path;
 + (id)fileHandleForPath:(NSString *)path mode:(int)mode;
 
 #pragma mark -
@@ -77,12 +113,18 @@ struct SPRawFileHandles;
 // Reads data up to a specified number of bytes from the file
 - (NSMutableData *)readDataOfLength:(NSUInteger)length;
 
+// Reads data up to a specified number of bytes, mapping uncompressed files and decompressing compressed ones in the background
+- (NSData *)readStreamedDataOfLength:(NSUInteger)length;
+
 // Returns the data to the end of the file
 - (NSMutableData *)readDataToEndOfFile;
 
 // Returns the on-disk (raw) length of data read so far - can be used in progress bars
 - (NSUInteger)realDataReadLength;
 
+// Moves past a specified number of uncompressed bytes without returning them
+- (BOOL)skipDataOfLength:(unsigned long long)length;
+
 #pragma mark -
 #pragma mark Data writing
 
@@ -99,6 +141,21 @@ struct SPRawFileHandles;
 // Ensures any buffers are written to disk
 - (void)synchronizeFile;
 
+// Returns the number of (uncompressed) bytes written out so far, including existing content when appending
+- (unsigned long long)dataWrittenLength;
+
+// Returns the number of bytes this handle has stored on disk, after any compression
+- (unsigned long long)dataStoredLength;
+
+// Returns whether writing to the file has failed; no further data is written once it has
+- (BOOL)writeFailed;
+
+// Returns the time writers have spent blocked waiting for the background stages to catch up
+- (uint64_t)writerWaitNanoseconds;
+
+// Returns how the supplied background write stage has spent its time so far
+- (SPPipelineStageCounters)countersForWriteStage:(SPFileHandleWriteStage)stage;
+
 // Prevents further access to the file
 - (void)closeFile;
 
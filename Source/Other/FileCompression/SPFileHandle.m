@@ -29,23 +29,48 @@
 //  More info at <https://github.com/sequelpro/sequelpro>
 
 #import "SPFileHandle.h"
+#import "SPMappedFile.h"
+#import "SPParallelDecompressor.h"
 #import "bzlib.h"
 #import <zlib.h>
+#import <sys/stat.h>
 #import "pthread.h"
 
-// Define the maximum size of the background write buffer before the writing thread
-// waits until some has been written out.  This can affect speed and memory usage.
-#define SPFH_MAX_WRITE_BUFFER_SIZE 1048576
+// Define the size of the blocks written data is gathered into before being handed to the
+// compression thread, and the number of blocks each background stage may have queued before
+// the stage feeding it waits.  Together these bound memory use and affect speed.
+#define SPFH_WRITE_BLOCK_SIZE 262144
+#define SPFH_WRITE_QUEUE_CAPACITY 4
 
 struct SPRawFileHandles {
 	FILE *file;
 	BZFILE *bzfile;
 	gzFile gzfile;
+
+	// Compressor state when writing
+	z_stream gzstream;
+	bz_stream bzstream;
 };
 
+/**
+ * A block of output on its way from the compression thread to the disk writing thread.
+ */
+@interface SPFileHandleWriteBlock : NSObject
+
+@property (readwrite, strong) NSData *data;
+@property (readwrite, assign) NSUInteger inputLength;
+
+@end
+
+@implementation SPFileHandleWriteBlock
+@end
+
 @interface SPFileHandle ()
 
-- (void)_writeBufferToData;
+- (void)_queueBufferedData;
+- (NSData *)_compressBytes:(const void *)bytes length:(NSUInteger)length finish:(BOOL)finish;
+- (void)_compressQueuedData;
+- (void)_writeQueuedData;
 - (void)_closeFileHandles;
 
 @end
@@ -68,8 +93,14 @@ struct SPRawFileHandles {
 {
 	if ((self = [super init])) {
 		dataWritten = NO;
-		allDataWritten = YES;
 		fileIsClosed = NO;
+		dataQueuedLength = 0;
+		decompressedReadLength = 0;
+		atomic_init(&dataWrittenLength, 0);
+		atomic_init(&dataStoredLength, 0);
+		atomic_init(&writeFailed, false);
+		atomic_init(&compressionBusyNanoseconds, 0);
+		atomic_init(&writeBusyNanoseconds, 0);
 
 		wrappedFile = malloc(sizeof(*wrappedFile)); //FIXME ivar can be moved to .m file with "modern objc", replacing the opaque struct pointer
 		wrappedFilePath = malloc(strlen(path) + 1);
@@ -91,7 +122,8 @@ struct SPRawFileHandles {
 		endOfFile = NO;
 		
 		compressionFormat = SPNoCompression;
-		processingThread = nil;
+		compressionThread = nil;
+		writeThread = nil;
 
 		// If in read mode, set up the buffer
 		if (fileMode == O_RDONLY) {
@@ -144,12 +176,20 @@ struct SPRawFileHandles {
 				fclose(theFile);
 			}
 		} 
-		// In write mode, set up a thread to handle writing in the background
+		// In write mode, set up threads to compress and write the data in the background
 		else if (fileMode == O_WRONLY) {
 			wrappedFile->file = theFile; // can be changed later via setCompressionFormat:
-			processingThread = [[NSThread alloc] initWithTarget:self selector:@selector(_writeBufferToData) object:nil];
-			[processingThread setName:@"SPFileHandle data writing thread"];
-			[processingThread start];
+
+			compressionQueue = [[SPBoundedQueue alloc] initWithCapacity:SPFH_WRITE_QUEUE_CAPACITY];
+			writeQueue = [[SPBoundedQueue alloc] initWithCapacity:SPFH_WRITE_QUEUE_CAPACITY];
+
+			compressionThread = [[NSThread alloc] initWithTarget:self selector:@selector(_compressQueuedData) object:nil];
+			[compressionThread setName:@"SPFileHandle data compression thread"];
+			[compressionThread start];
+
+			writeThread = [[NSThread alloc] initWithTarget:self selector:@selector(_writeQueuedData) object:nil];
+			[writeThread setName:@"SPFileHandle data writing thread"];
+			[writeThread start];
 		}
 	}
 
@@ -178,6 +218,36 @@ struct SPRawFileHandles {
 	return [self fileHandleForPath:path mode:O_WRONLY];
 }
 
+/**
+ * Retrieve and return a SPFileHandle for appending to an existing file at
+ * the supplied path; data is always written uncompressed after the current
+ * end of the file.  Returns nil if the file could not be found or opened.
+ */
++ (id)fileHandleForAppendingAtPath:(NSString *)path
+{
+	const char *pathRepresentation = [path fileSystemRepresentation];
+	if (!pathRepresentation) {
+		SPLog(@"Failed to get fileSystemRepresentation for: %@", path);
+		return nil;
+	}
+
+	FILE *file = fopen(pathRepresentation, "ab");
+
+	if (file == NULL) {
+		SPLog(@"Failed to open for appending: %@", path);
+		return nil;
+	}
+
+	SPFileHandle *fileHandle = [[self alloc] initWithFile:file fromPath:pathRepresentation mode:O_WRONLY];
+
+	// Count the existing content so written lengths match offsets within the file
+	fseeko(file, 0, SEEK_END);
+	fileHandle->dataQueuedLength = (unsigned long long)ftello(file);
+	atomic_store(&fileHandle->dataWrittenLength, fileHandle->dataQueuedLength);
+
+	return fileHandle;
+}
+
 /**
  * Retrieve and return a SPFileHandle for a file at the specified path,
  * using the supplied file status flag. Returns nil if the file could
@@ -217,6 +287,21 @@ struct SPRawFileHandles {
  */
 - (NSMutableData *)readDataOfLength:(NSUInteger)length
 {	
+	if (mappedFile) return [NSMutableData dataWithData:[mappedFile readDataOfLength:length]];
+
+	// The decompressor hands out a chunk at a time, so gather as many as are needed
+	if (decompressor) {
+		NSMutableData *data = [NSMutableData data];
+		NSData *slice;
+
+		while ([data length] < length && [(slice = [decompressor readDataOfLength:length - [data length]]) length])
+		{
+			[data appendData:slice];
+		}
+
+		return data;
+	}
+
 	long dataLength = 0;
 	void *data = malloc(length);
 	
@@ -229,10 +314,82 @@ struct SPRawFileHandles {
 	else {
 		dataLength = fread(data, 1, length, wrappedFile->file);
 	}
+
+	if (compressionFormat != SPNoCompression && dataLength > 0) decompressedReadLength += (unsigned long long)dataLength;
 		
 	return [NSMutableData dataWithBytesNoCopy:data length:dataLength freeWhenDone:YES];
 }
 
+/**
+ * Reads data up to a specified number of uncompressed bytes from the file, as readDataOfLength:
+ * does, but without copying it where it can and with compressed files decompressed ahead of time.
+ *
+ * The first read of an uncompressed file maps it into memory, and this and later reads return
+ * slices of the mapping, which stay valid while they are kept and are contiguous in memory until
+ * the mapping moves on to its next window (see SPMappedFile). The first read of a compressed file
+ * starts decompressing it on background threads (see SPParallelDecompressor), and this and later
+ * reads return slices of the decompressed chunks, so may be shorter than asked for before the end
+ * of the file. Files which can't be mapped or reopened are read as usual.
+ */
+- (NSData *)readStreamedDataOfLength:(NSUInteger)length
+{
+	if (!mappedFile && !decompressor && fileMode == O_RDONLY && !fileIsClosed) {
+		if (compressionFormat == SPNoCompression) {
+			mappedFile = [[SPMappedFile alloc] initWithPath:wrappedFilePath offset:(unsigned long long)ftello(wrappedFile->file)];
+		}
+		else {
+			decompressor = [[SPParallelDecompressor alloc] initWithPath:wrappedFilePath compressionFormat:compressionFormat];
+
+			// The decompressor starts from the beginning of the file, so catch up with anything read already
+			if (decompressedReadLength) [decompressor skipDataOfLength:decompressedReadLength];
+		}
+	}
+
+	if (mappedFile) return [mappedFile readDataOfLength:length];
+
+	if (decompressor) return [decompressor readDataOfLength:length];
+
+	return [self readDataOfLength:length];
+}
+
+/**
+ * Moves past a specified number of uncompressed bytes, as if they had been read. Uncompressed files
+ * are seeked; compressed ones still have to be decompressed up to that point, but nothing is kept.
+ *
+ * @return NO if the file ended before that many bytes
+ */
+- (BOOL)skipDataOfLength:(unsigned long long)length
+{
+	if (mappedFile) return [mappedFile skipDataOfLength:length];
+
+	if (decompressor) return [decompressor skipDataOfLength:length];
+
+	if (compressionFormat == SPNoCompression) {
+		struct stat fileStatus;
+
+		if (fstat(fileno(wrappedFile->file), &fileStatus) || (unsigned long long)ftello(wrappedFile->file) + length > (unsigned long long)fileStatus.st_size) return NO;
+
+		return !fseeko(wrappedFile->file, (off_t)length, SEEK_CUR);
+	}
+
+	const NSUInteger discardLength = 1024 * 1024;
+	void *discard = malloc(discardLength);
+
+	while (length) {
+		unsigned readLength = (unsigned)MIN(length, (unsigned long long)discardLength);
+		int dataLength = (compressionFormat == SPGzipCompression) ? gzread(wrappedFile->gzfile, discard, readLength) : BZ2_bzread(wrappedFile->bzfile, discard, (int)readLength);
+
+		if (dataLength <= 0) break;
+
+		length -= (unsigned long long)dataLength;
+		decompressedReadLength += (unsigned long long)dataLength;
+	}
+
+	free(discard);
+
+	return !length;
+}
+
 /**
  * Returns all the data to the end of the file.
  */
@@ -249,6 +406,10 @@ struct SPRawFileHandles {
 - (NSUInteger)realDataReadLength
 {
 	if (fileMode == O_WRONLY) return 0;
+
+	if (mappedFile) return (NSUInteger)[mappedFile offset];
+
+	if (decompressor) return (NSUInteger)[decompressor compressedOffset];
 	
 	if (compressionFormat == SPGzipCompression) {
 		return gzoffset(wrappedFile->gzfile);
@@ -279,17 +440,20 @@ struct SPRawFileHandles {
 	if (dataWritten) [NSException raise:NSInternalInconsistencyException format:@"Cannot change compression settings when data has already been written."];
 
 	compressionFormat = useCompressionFormat;
-	
+
+	// The compression thread produces the compressed stream, so the file itself is always written as-is
+	wrappedFile->file = fopen(wrappedFilePath, "wb");
+
 	if (compressionFormat == SPGzipCompression) {
-		wrappedFile->gzfile = gzopen(wrappedFilePath, "wb");
-		gzbuffer(wrappedFile->gzfile, 131072);
+		memset(&wrappedFile->gzstream, 0, sizeof(wrappedFile->gzstream));
+
+		// A window size of 15 plus 16 selects a gzip wrapper, as written by gzopen
+		deflateInit2(&wrappedFile->gzstream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY);
 	}
 	else if (compressionFormat == SPBzip2Compression) {
-		wrappedFile->file = fopen(wrappedFilePath, "wb");
-		wrappedFile->bzfile = BZ2_bzWriteOpen(NULL, wrappedFile->file, 9, 0, 0);
-	}
-	else {
-		wrappedFile->file = fopen(wrappedFilePath, "wb");
+		memset(&wrappedFile->bzstream, 0, sizeof(wrappedFile->bzstream));
+
+		BZ2_bzCompressInit(&wrappedFile->bzstream, 9, 0, 0);
 	}
 }
 
@@ -303,23 +467,19 @@ struct SPRawFileHandles {
         [NSException raise:NSInternalInconsistencyException format:@"Cannot write to a file handle after it has been closed"];
     }
 
+	// Once a write has failed the file can't be completed, so there's no point compressing more
+	if (![data length] || atomic_load(&writeFailed)) return;
+
 	pthread_mutex_lock(&bufferLock);
-	
+
 	// Add the data to the buffer
-	if ([data length]) {
-		[buffer appendData:data];
-		allDataWritten = NO;
-		bufferDataLength += [data length];
-	}
+	[buffer appendData:data];
+	dataQueuedLength += [data length];
+
+	// Once a block has been gathered hand it to the compression thread, waiting if the
+	// background stages are already busy with enough data
+	if ([buffer length] >= SPFH_WRITE_BLOCK_SIZE) [self _queueBufferedData];
 
-	// If the buffer is large, wait for some to be written out
-	while (bufferDataLength > SPFH_MAX_WRITE_BUFFER_SIZE) 
-	{
-		pthread_mutex_unlock(&bufferLock);
-		usleep(100);
-		pthread_mutex_lock(&bufferLock);
-	}
-	
 	pthread_mutex_unlock(&bufferLock);
 }
 
@@ -328,16 +488,85 @@ struct SPRawFileHandles {
  */
 - (void)synchronizeFile
 {
+	if (fileMode != O_WRONLY || fileIsClosed) return;
+
 	pthread_mutex_lock(&bufferLock);
-	
-	while (!allDataWritten) 
-	{
-		pthread_mutex_unlock(&bufferLock);
-		usleep(100);
-		pthread_mutex_lock(&bufferLock);
-	}
-	
+
+	[self _queueBufferedData];
+
+	unsigned long long queuedLength = dataQueuedLength;
+
 	pthread_mutex_unlock(&bufferLock);
+
+	// A failed write leaves dataWrittenLength short of the queued length for good, so stop waiting then
+	while (atomic_load(&dataWrittenLength) < queuedLength && !atomic_load(&writeFailed)) usleep(100);
+
+	// Flush the stdio buffer for uncompressed files so the on-disk length matches dataWrittenLength
+	if (compressionFormat == SPNoCompression && wrappedFile->file && fflush(wrappedFile->file) != 0) {
+		SPLog(@"Failed to flush %s", wrappedFilePath);
+		atomic_store(&writeFailed, true);
+	}
+}
+
+/**
+ * Returns the number of uncompressed bytes written out to the file so far.
+ * When appending this includes the content the file already contained, so
+ * after synchronizeFile it matches the on-disk length of uncompressed files.
+ */
+- (unsigned long long)dataWrittenLength
+{
+	return atomic_load(&dataWrittenLength);
+}
+
+/**
+ * Returns the number of bytes this handle has written to disk so far - the compressed
+ * length when compressing. Existing content of an appended file is not included.
+ */
+- (unsigned long long)dataStoredLength
+{
+	return atomic_load(&dataStoredLength);
+}
+
+/**
+ * Returns whether writing to the file has failed.  The flag stays set once raised,
+ * and dataWrittenLength then only covers the data written before the failure.
+ */
+- (BOOL)writeFailed
+{
+	return atomic_load(&writeFailed);
+}
+
+/**
+ * Returns the time callers of writeData: have spent blocked because the compression
+ * queue was full, which is how long the file stages held up the writer.
+ */
+- (uint64_t)writerWaitNanoseconds
+{
+	return [compressionQueue producerWaitNanoseconds];
+}
+
+/**
+ * Returns how the supplied background write stage has spent its time so far: busy
+ * compressing or writing, or waiting for data to arrive or for the next stage to catch up.
+ */
+- (SPPipelineStageCounters)countersForWriteStage:(SPFileHandleWriteStage)stage
+{
+	SPPipelineStageCounters counters = {0, 0, 0};
+
+	if (fileMode != O_WRONLY) return counters;
+
+	if (stage == SPFileHandleCompressionStage) {
+		counters.items = [writeQueue enqueuedCount];
+		counters.busyNanoseconds = atomic_load(&compressionBusyNanoseconds);
+		counters.waitNanoseconds = [compressionQueue consumerWaitNanoseconds] + [writeQueue producerWaitNanoseconds];
+	}
+	else {
+		counters.items = [writeQueue enqueuedCount];
+		counters.busyNanoseconds = atomic_load(&writeBusyNanoseconds);
+		counters.waitNanoseconds = [writeQueue consumerWaitNanoseconds];
+	}
+
+	return counters;
 }
 
 /**
@@ -348,15 +577,32 @@ struct SPRawFileHandles {
 {
     SPLog(@"in closeFile, fileIsClosed: %d", fileIsClosed);
 	if (!fileIsClosed) {
-		[self synchronizeFile];
-		[self _closeFileHandles];
-		
-		if (processingThread) {
-			if ([processingThread isExecuting]) {
-				[processingThread cancel];
-				while ([processingThread isExecuting]) usleep(100);
-			}
+		if (fileMode == O_WRONLY) {
+			pthread_mutex_lock(&bufferLock);
+
+			[self _queueBufferedData];
+
+			pthread_mutex_unlock(&bufferLock);
+
+			// Closing the queue lets the compression thread finish the compressed stream and then
+			// end the writing thread's input, so once the writing thread exits everything is on disk
+			[compressionQueue close];
+
+			while (![writeThread isFinished]) usleep(100);
+
+			SPLog(@"Write stage utilisation: compression %.0f%%, disk %.0f%%, waiting for background stages %.3fs",
+				  SPPipelineStageUtilisation([self countersForWriteStage:SPFileHandleCompressionStage]) * 100,
+				  SPPipelineStageUtilisation([self countersForWriteStage:SPFileHandleDiskWriteStage]) * 100,
+				  [compressionQueue producerWaitNanoseconds] / 1e9);
 		}
+
+		[self _closeFileHandles];
+
+		// Slices already read keep their part of the mapping or their decompressed chunk
+		mappedFile = nil;
+
+		[decompressor cancel];
+		decompressor = nil;
 		
 		fileIsClosed = YES;
 	}
@@ -375,63 +621,161 @@ struct SPRawFileHandles {
 }
 
 /**
- * A method to be called on a background thread, allowing write data to build
- * up in a buffer and write to disk in chunks as the buffer fills.  This allows
- * background compression of the data when using Gzip compression.
+ * Hands the data gathered in the buffer to the compression thread as one block.
+ * Must be called with the buffer lock held.
+ */
+- (void)_queueBufferedData
+{
+	if (![buffer length]) return;
+
+	NSData *block = buffer;
+
+	buffer = [[NSMutableData alloc] initWithCapacity:SPFH_WRITE_BLOCK_SIZE];
+
+	[compressionQueue enqueue:block];
+}
+
+/**
+ * Runs the supplied bytes through the compressor for the current compression format,
+ * returning whatever compressed output is ready.  When finishing, the compressor's
+ * remaining output and the stream trailer are returned instead.
  */
-- (void)_writeBufferToData
+- (NSData *)_compressBytes:(const void *)bytes length:(NSUInteger)length finish:(BOOL)finish
+{
+	NSMutableData *output = [NSMutableData dataWithLength:MAX(length / 2, 16384)];
+	NSUInteger outputLength = 0;
+
+	if (compressionFormat == SPGzipCompression) {
+		z_stream *stream = &wrappedFile->gzstream;
+
+		stream->next_in = (Bytef *)bytes;
+		stream->avail_in = (uInt)length;
+
+		while (1)
+		{
+			if (outputLength == [output length]) [output increaseLengthBy:[output length]];
+
+			stream->next_out = (Bytef *)[output mutableBytes] + outputLength;
+			stream->avail_out = (uInt)([output length] - outputLength);
+
+			int status = deflate(stream, finish ? Z_FINISH : Z_NO_FLUSH);
+
+			outputLength = [output length] - stream->avail_out;
+
+			if (status == Z_STREAM_ERROR) break;
+			if (finish ? (status == Z_STREAM_END) : (!stream->avail_in && stream->avail_out)) break;
+		}
+	}
+	else if (compressionFormat == SPBzip2Compression) {
+		bz_stream *stream = &wrappedFile->bzstream;
+
+		stream->next_in = (char *)bytes;
+		stream->avail_in = (unsigned int)length;
+
+		while (1)
+		{
+			if (outputLength == [output length]) [output increaseLengthBy:[output length]];
+
+			stream->next_out = (char *)[output mutableBytes] + outputLength;
+			stream->avail_out = (unsigned int)([output length] - outputLength);
+
+			int status = BZ2_bzCompress(stream, finish ? BZ_FINISH : BZ_RUN);
+
+			outputLength = [output length] - stream->avail_out;
+
+			if (status < 0) break;
+			if (finish ? (status == BZ_STREAM_END) : !stream->avail_in) break;
+		}
+	}
+
+	[output setLength:outputLength];
+
+	return output;
+}
+
+/**
+ * The compression stage, run on a background thread.  Takes blocks of written data
+ * from the compression queue and passes their compressed form on to the writing thread
+ * until the queue is closed, then finishes the compressed stream.
+ */
+- (void)_compressQueuedData
 {
 	@autoreleasepool {
-		// Process the buffer in a loop into the file, until cancelled
-		while (!fileIsClosed && ![processingThread isCancelled]) {
+		NSData *block;
 
-			// Check whether any data in the buffer needs to be written out - using thread locks for safety
-			pthread_mutex_lock(&bufferLock);
+		while ((block = [compressionQueue dequeue]))
+		{
+			@autoreleasepool {
+				uint64_t start = SPPipelineTimestamp();
+
+				SPFileHandleWriteBlock *writeBlock = [[SPFileHandleWriteBlock alloc] init];
+
+				[writeBlock setData:(compressionFormat == SPNoCompression) ? block : [self _compressBytes:[block bytes] length:[block length] finish:NO]];
+				[writeBlock setInputLength:[block length]];
+
+				atomic_fetch_add(&compressionBusyNanoseconds, SPPipelineTimestamp() - start);
 
-			if (!bufferDataLength) {
-				pthread_mutex_unlock(&bufferLock);
-				usleep(1000);
-				continue;
+				[writeQueue enqueue:writeBlock];
 			}
+		}
 
-			// Copy the data into a local buffer
-			NSData *dataToBeWritten = [buffer copy];
+		// Flush the compressor's remaining output and the stream trailer
+		if (compressionFormat != SPNoCompression) {
+			SPFileHandleWriteBlock *writeBlock = [[SPFileHandleWriteBlock alloc] init];
 
-			[buffer setLength:0];
-			bufferDataLength = 0;
+			[writeBlock setData:[self _compressBytes:NULL length:0 finish:YES]];
 
-			pthread_mutex_unlock(&bufferLock);
+			[writeQueue enqueue:writeBlock];
+		}
 
-			// Write out the data
-			long bufferLengthWrittenOut = 0;
-
-			switch (compressionFormat) {
-				case SPGzipCompression:
-					bufferLengthWrittenOut = gzwrite(wrappedFile->gzfile, [dataToBeWritten bytes], (unsigned)[dataToBeWritten length]);
-					break;
-				case SPBzip2Compression:
-					bufferLengthWrittenOut = BZ2_bzwrite(wrappedFile->bzfile, (void *)[dataToBeWritten bytes], (int)[dataToBeWritten length]);
-					break;
-				default:
-					bufferLengthWrittenOut = fwrite([dataToBeWritten bytes], 1, [dataToBeWritten length], wrappedFile->file);
-			}
+		[writeQueue close];
+	}
+}
 
-			// Restore data to the buffer if it wasn't written out
-			pthread_mutex_lock(&bufferLock);
+/**
+ * The disk writing stage, run on a background thread.  Writes blocks from the write
+ * queue out to the file until the compression thread closes the queue.  After a failed
+ * write the remaining blocks are only dequeued, so the earlier stages can still finish.
+ */
+- (void)_writeQueuedData
+{
+	@autoreleasepool {
+		SPFileHandleWriteBlock *writeBlock;
+
+		while ((writeBlock = [writeQueue dequeue]))
+		{
+			@autoreleasepool {
+				uint64_t start = SPPipelineTimestamp();
+
+				NSData *data = [writeBlock data];
+				NSUInteger dataLength = [data length];
+				NSUInteger dataLengthWrittenOut = 0;
+
+				// Nothing after a failed write can be used, so just drain the queue
+				if (atomic_load(&writeFailed)) continue;
+
+				while (dataLengthWrittenOut < dataLength)
+				{
+					size_t lengthWritten = fwrite((const char *)[data bytes] + dataLengthWrittenOut, 1, dataLength - dataLengthWrittenOut, wrappedFile->file);
+
+					if (!lengthWritten) break;
 
-			if (bufferLengthWrittenOut < (NSInteger)[dataToBeWritten length]) {
-				if ([buffer length]) {
-					long dataLengthToRestore = [dataToBeWritten length] - bufferLengthWrittenOut;
-					[buffer replaceBytesInRange:NSMakeRange(0, 0) withBytes:[[dataToBeWritten subdataWithRange:NSMakeRange(bufferLengthWrittenOut, dataLengthToRestore)] bytes] length:dataLengthToRestore];
-					bufferDataLength += dataLengthToRestore;
+					dataLengthWrittenOut += lengthWritten;
 				}
-			}
-			// Otherwise, mark all data as written if it has been - allows synching to hard disk.
-			else if (![buffer length]) {
-				allDataWritten = YES;
-			}
 
-			pthread_mutex_unlock(&bufferLock);
+				atomic_fetch_add(&dataStoredLength, dataLengthWrittenOut);
+
+				if (dataLengthWrittenOut < dataLength) {
+					SPLog(@"Failed to write %lu bytes to %s", (unsigned long)(dataLength - dataLengthWrittenOut), wrappedFilePath);
+
+					atomic_store(&writeFailed, true);
+				}
+				else {
+					atomic_fetch_add(&dataWrittenLength, [writeBlock inputLength]);
+				}
+
+				atomic_fetch_add(&writeBusyNanoseconds, SPPipelineTimestamp() - start);
+			}
 		}
 	}
 }
@@ -441,6 +785,24 @@ struct SPRawFileHandles {
  */
 - (void)_closeFileHandles
 {
+	// When writing, the compressors only hold state in memory and the file itself is plain
+	if (fileMode == O_WRONLY) {
+		if (compressionFormat == SPGzipCompression) {
+			deflateEnd(&wrappedFile->gzstream);
+		}
+		else if (compressionFormat == SPBzip2Compression) {
+			BZ2_bzCompressEnd(&wrappedFile->bzstream);
+		}
+
+		if (wrappedFile->file && fclose(wrappedFile->file) != 0) {
+			SPLog(@"Failed to close %s", wrappedFilePath);
+			atomic_store(&writeFailed, true);
+		}
+		wrappedFile->file = NULL;
+
+		return;
+	}
+
 	if (compressionFormat == SPGzipCompression) {
 		gzclose(wrappedFile->gzfile);
 		wrappedFile->gzfile = NULL;
@@ -0,0 +1,70 @@
+//
+//  SPMappedFile.h
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+@class SPMappedFileWindow;
+
+/**
+ * @class SPMappedFile SPMappedFile.h
+ *
+ * Reads an uncompressed file through a memory mapping, handing out the data as slices of the
+ * mapping rather than copies. The file is mapped a window at a time so that even very large files
+ * use a bounded amount of address space; each slice lies within one window and keeps it mapped
+ * for as long as the slice is kept. Consecutive slices within a window are contiguous in memory.
+ *
+ * Windows are mapped for sequential access, and the pages of each slice are asked for as it is
+ * handed out so the disk reads ahead of whoever reads the slices.
+ *
+ * As with any mapping, a file which is truncated while it is being read can't be read safely, so
+ * this is only for files which aren't expected to change, such as those being imported.
+ */
+@interface SPMappedFile : NSObject
+{
+	int fileDescriptor;
+	unsigned long long fileLength;
+	unsigned long long offset;
+	SPMappedFileWindow *window;
+}
+
+/**
+ * @property fileLength The length of the file when it was opened
+ */
+@property (readonly, assign) unsigned long long fileLength;
+
+/**
+ * @property offset The offset of the next data to be read
+ */
+@property (readonly, assign) unsigned long long offset;
+
+- (instancetype)initWithPath:(const char *)path offset:(unsigned long long)startOffset;
+
+- (NSData *)readDataOfLength:(NSUInteger)length;
+- (BOOL)skipDataOfLength:(unsigned long long)length;
+
+@end
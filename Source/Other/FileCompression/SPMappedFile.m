@@ -0,0 +1,179 @@
+//
+//  SPMappedFile.m
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPMappedFile.h"
+#import <sys/mman.h>
+#import <sys/stat.h>
+
+// The most of the file mapped at once
+static const unsigned long long SPMappedFileWindowLength = 64 * 1024 * 1024;
+
+/**
+ * One mapped window of the file, unmapped once the last slice of it has been released.
+ */
+@interface SPMappedFileWindow : NSObject
+{
+	@public
+	void *address;
+	size_t length;
+	unsigned long long offset;
+}
+
+@end
+
+@implementation SPMappedFileWindow
+
+- (void)dealloc
+{
+	if (address) munmap(address, length);
+}
+
+@end
+
+@interface SPMappedFile ()
+
+- (BOOL)_mapWindowAtOffset:(unsigned long long)windowOffset;
+
+@end
+
+@implementation SPMappedFile
+
+@synthesize fileLength;
+@synthesize offset;
+
+/**
+ * Opens a file for reading through a mapping.
+ *
+ * @param path        The file system representation of the file's path
+ * @param startOffset The offset to start reading from
+ *
+ * @return The initialised instance, or nil if the file isn't a regular file which can be opened
+ */
+- (instancetype)initWithPath:(const char *)path offset:(unsigned long long)startOffset
+{
+	if ((self = [super init])) {
+		struct stat fileStatus;
+
+		fileDescriptor = open(path, O_RDONLY);
+
+		if (fileDescriptor < 0) return nil;
+
+		if (fstat(fileDescriptor, &fileStatus) || !S_ISREG(fileStatus.st_mode)) {
+			close(fileDescriptor);
+			fileDescriptor = -1;
+			return nil;
+		}
+
+		fileLength = (unsigned long long)fileStatus.st_size;
+		offset = MIN(startOffset, fileLength);
+	}
+
+	return self;
+}
+
+/**
+ * Reads data up to a specified number of bytes from the file, as a slice of the mapping which
+ * must not be modified. Less is returned where the current window ends, and an empty slice at
+ * the end of the file; an exception is raised if the file can't be mapped.
+ */
+- (NSData *)readDataOfLength:(NSUInteger)length
+{
+	if (offset >= fileLength || !length) return [NSData data];
+
+	if (!window || offset < window->offset || offset >= window->offset + window->length) {
+		if (![self _mapWindowAtOffset:offset]) {
+			[NSException raise:NSFileHandleOperationException format:@"The file could not be mapped into memory (%s)", strerror(errno)];
+		}
+	}
+
+	SPMappedFileWindow *sliceWindow = window;
+	size_t windowPosition = (size_t)(offset - sliceWindow->offset);
+	size_t sliceLength = (size_t)MIN((unsigned long long)length, sliceWindow->length - windowPosition);
+	uint8_t *sliceBytes = (uint8_t *)sliceWindow->address + windowPosition;
+
+	// Start the disk on the slice's pages now, rather than when they are first read
+	uintptr_t pageMask = (uintptr_t)getpagesize() - 1;
+	uint8_t *firstPage = (uint8_t *)((uintptr_t)sliceBytes & ~pageMask);
+	madvise(firstPage, (size_t)(sliceBytes + sliceLength - firstPage), MADV_WILLNEED);
+
+	offset += sliceLength;
+
+	return [[NSData alloc] initWithBytesNoCopy:sliceBytes length:sliceLength deallocator:^(void *bytes, NSUInteger bytesLength) {
+		(void)sliceWindow;
+	}];
+}
+
+/**
+ * Moves past a specified number of bytes without mapping them.
+ *
+ * @return NO, leaving the offset unchanged, if the file ends before that many bytes
+ */
+- (BOOL)skipDataOfLength:(unsigned long long)length
+{
+	if (length > fileLength - offset) return NO;
+
+	offset += length;
+
+	return YES;
+}
+
+#pragma mark -
+#pragma mark Private API
+
+/**
+ * Maps the window of the file holding the supplied offset, in place of the current one.
+ */
+- (BOOL)_mapWindowAtOffset:(unsigned long long)windowOffset
+{
+	unsigned long long pageSize = (unsigned long long)getpagesize();
+	SPMappedFileWindow *newWindow = [[SPMappedFileWindow alloc] init];
+
+	newWindow->offset = windowOffset - (windowOffset % pageSize);
+	newWindow->length = (size_t)MIN(SPMappedFileWindowLength, fileLength - newWindow->offset);
+
+	void *address = mmap(NULL, newWindow->length, PROT_READ, MAP_PRIVATE, fileDescriptor, (off_t)newWindow->offset);
+
+	if (address == MAP_FAILED) return NO;
+
+	newWindow->address = address;
+
+	madvise(address, newWindow->length, MADV_SEQUENTIAL);
+
+	window = newWindow;
+
+	return YES;
+}
+
+- (void)dealloc
+{
+	if (fileDescriptor >= 0) close(fileDescriptor);
+}
+
+@end
@@ -0,0 +1,75 @@
+//
+//  SPParallelDecompressor.h
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPBoundedQueue.h"
+
+@class SPDecompressedChunk;
+
+/**
+ * @class SPParallelDecompressor SPParallelDecompressor.h
+ *
+ * Decompresses a gzip or bzip2 file on background threads, so that whoever reads the data only
+ * waits for decompression when it falls behind.
+ *
+ * bzip2 files are split into their independently compressed blocks as they are read, and the
+ * blocks are decompressed on as many threads as there are processors. gzip can't be split like
+ * this, so instead one thread reads the file ahead and another inflates it. Either way the
+ * decompressed data is handed out in file order, in the chunks it was decompressed in.
+ *
+ * Only as many chunks as it takes to keep each thread busy are held at once. Reading must be done
+ * from one thread at a time; a file which can't be read or decompressed raises an
+ * NSFileHandleOperationException from the read.
+ */
+@interface SPParallelDecompressor : NSObject
+{
+	SPFileCompressionFormat compressionFormat;
+	FILE *file;
+	SPBoundedQueue *chunkQueue;
+	SPBoundedQueue *readQueue;
+	SPDecompressedChunk *pendingChunk;
+	NSData *currentChunkData;
+	NSUInteger currentChunkPosition;
+	unsigned long long compressedOffset;
+	BOOL endOfFile;
+}
+
+/**
+ * @property compressedOffset How far through the compressed file the data read so far reaches
+ */
+@property (readonly, assign) unsigned long long compressedOffset;
+
+- (instancetype)initWithPath:(const char *)path compressionFormat:(SPFileCompressionFormat)format;
+
+- (NSData *)readDataOfLength:(NSUInteger)length;
+- (BOOL)skipDataOfLength:(unsigned long long)length;
+
+- (void)cancel;
+
+@end
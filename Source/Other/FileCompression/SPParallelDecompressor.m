@@ -0,0 +1,605 @@
+//
+//  SPParallelDecompressor.m
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPParallelDecompressor.h"
+#import "SPBzip2BlockScanner.h"
+#import "bzlib.h"
+#import <zlib.h>
+
+// The length of each read of the compressed file
+static const NSUInteger SPParallelDecompressorReadLength = 1024 * 1024;
+
+// The length of each chunk of inflated gzip data, and the number of chunks of either the compressed
+// or the inflated data which may wait to be taken
+static const NSUInteger SPParallelDecompressorInflateLength = 1024 * 1024;
+static const NSUInteger SPParallelDecompressorGzipQueueCapacity = 4;
+
+// The most bzip2 blocks found by false matches of a magic number that are joined to a block before
+// giving up on it as damaged
+#define SPParallelDecompressorMaxJoinedBlocks 4
+
+/**
+ * A chunk of the file, decompressed once its semaphore has been signalled.
+ */
+@interface SPDecompressedChunk : NSObject
+{
+	@public
+	NSData *data;
+	NSString *errorMessage;
+	unsigned long long compressedEnd;
+	dispatch_semaphore_t decompressed;
+	SPBzip2Block block;
+}
+
+@end
+
+@implementation SPDecompressedChunk
+
+- (instancetype)init
+{
+	if ((self = [super init])) {
+		decompressed = dispatch_semaphore_create(0);
+	}
+
+	return self;
+}
+
+- (void)dealloc
+{
+	SPBzip2BlockFree(&block);
+}
+
+@end
+
+/**
+ * Decompresses bzip2 blocks made into a standalone stream, returning nil if they don't form a
+ * valid stream.
+ */
+static NSData *SPDecompressBzip2Blocks(const SPBzip2Block *blocks, size_t blockCount)
+{
+	size_t streamLength;
+	uint8_t *stream = SPBzip2StreamCreate(blocks, blockCount, &streamLength);
+
+	if (!stream) return nil;
+
+	bz_stream bzstream;
+	memset(&bzstream, 0, sizeof(bzstream));
+
+	if (BZ2_bzDecompressInit(&bzstream, 0, 0) != BZ_OK) {
+		free(stream);
+		return nil;
+	}
+
+	size_t capacity = SPParallelDecompressorInflateLength;
+	size_t outputLength = 0;
+	char *output = malloc(capacity);
+	int result = BZ_OK;
+
+	bzstream.next_in = (char *)stream;
+	bzstream.avail_in = (unsigned int)streamLength;
+
+	while (output && result == BZ_OK)
+	{
+		// Runs of repeated bytes can make a block many times its compressed length
+		if (outputLength == capacity) {
+			char *grownOutput = realloc(output, capacity * 2);
+
+			if (!grownOutput) break;
+
+			output = grownOutput;
+			capacity *= 2;
+		}
+
+		bzstream.next_out = output + outputLength;
+		bzstream.avail_out = (unsigned int)MIN(capacity - outputLength, (size_t)UINT_MAX);
+
+		result = BZ2_bzDecompress(&bzstream);
+
+		outputLength = (size_t)(bzstream.next_out - output);
+
+		// Out of input without reaching the end of the stream
+		if (result == BZ_OK && !bzstream.avail_in && bzstream.avail_out) break;
+	}
+
+	BZ2_bzDecompressEnd(&bzstream);
+	free(stream);
+
+	if (result != BZ_STREAM_END) {
+		free(output);
+		return nil;
+	}
+
+	return [NSData dataWithBytesNoCopy:output length:outputLength freeWhenDone:YES];
+}
+
+@interface SPParallelDecompressor ()
+
+- (void)_readBzip2Blocks;
+- (void)_readGzipData;
+- (void)_inflateGzipData;
+- (void)_queueErrorChunk:(NSString *)message;
+- (SPDecompressedChunk *)_nextDecompressedChunk;
+- (BOOL)_takeNextChunk;
+
+@end
+
+@implementation SPParallelDecompressor
+
+@synthesize compressedOffset;
+
+/**
+ * Opens a compressed file and starts decompressing it in the background.
+ *
+ * @param path   The file system representation of the file's path
+ * @param format The file's compression format, either gzip or bzip2
+ *
+ * @return The initialised instance, or nil if the file can't be opened
+ */
+- (instancetype)initWithPath:(const char *)path compressionFormat:(SPFileCompressionFormat)format
+{
+	if ((self = [super init])) {
+		if (format != SPGzipCompression && format != SPBzip2Compression) return nil;
+
+		file = fopen(path, "rb");
+
+		if (!file) return nil;
+
+		compressionFormat = format;
+		compressedOffset = 0;
+		endOfFile = NO;
+
+		if (compressionFormat == SPBzip2Compression) {
+
+			// Blocks are decompressed from when they are queued until they are taken, so the queue's
+			// capacity is also the number of blocks being decompressed at once
+			chunkQueue = [[SPBoundedQueue alloc] initWithCapacity:[[NSProcessInfo processInfo] activeProcessorCount] * 2];
+
+			NSThread *scanThread = [[NSThread alloc] initWithTarget:self selector:@selector(_readBzip2Blocks) object:nil];
+			[scanThread setName:@"SPParallelDecompressor bzip2 block reading thread"];
+			[scanThread start];
+		}
+		else {
+			chunkQueue = [[SPBoundedQueue alloc] initWithCapacity:SPParallelDecompressorGzipQueueCapacity];
+			readQueue = [[SPBoundedQueue alloc] initWithCapacity:SPParallelDecompressorGzipQueueCapacity];
+
+			NSThread *readThread = [[NSThread alloc] initWithTarget:self selector:@selector(_readGzipData) object:nil];
+			[readThread setName:@"SPParallelDecompressor gzip reading thread"];
+			[readThread start];
+
+			NSThread *inflateThread = [[NSThread alloc] initWithTarget:self selector:@selector(_inflateGzipData) object:nil];
+			[inflateThread setName:@"SPParallelDecompressor gzip inflating thread"];
+			[inflateThread start];
+		}
+	}
+
+	return self;
+}
+
+#pragma mark -
+#pragma mark Reading
+
+/**
+ * Reads data up to a specified number of decompressed bytes, waiting for it to be decompressed if
+ * need be. The data is a slice of one decompressed chunk, so may be shorter than asked for even
+ * before the end of the file, and isn't copied.
+ *
+ * @return The data, empty once the end of the file has been reached
+ */
+- (NSData *)readDataOfLength:(NSUInteger)length
+{
+	if (!length) return [NSData data];
+
+	while (currentChunkPosition == [currentChunkData length])
+	{
+		if (![self _takeNextChunk]) return [NSData data];
+	}
+
+	NSData *chunkData = currentChunkData;
+	NSUInteger sliceLength = MIN(length, [chunkData length] - currentChunkPosition);
+	NSUInteger slicePosition = currentChunkPosition;
+
+	currentChunkPosition += sliceLength;
+
+	if (sliceLength == [chunkData length]) return chunkData;
+
+	return [[NSData alloc] initWithBytesNoCopy:(uint8_t *)[chunkData bytes] + slicePosition length:sliceLength deallocator:^(void *bytes, NSUInteger bytesLength) {
+		(void)chunkData;
+	}];
+}
+
+/**
+ * Moves past a specified number of decompressed bytes, which still have to be decompressed.
+ *
+ * @return NO if the file ended before that many bytes
+ */
+- (BOOL)skipDataOfLength:(unsigned long long)length
+{
+	while (length)
+	{
+		if (currentChunkPosition == [currentChunkData length] && ![self _takeNextChunk]) return NO;
+
+		NSUInteger skipLength = (NSUInteger)MIN(length, (unsigned long long)([currentChunkData length] - currentChunkPosition));
+
+		currentChunkPosition += skipLength;
+		length -= skipLength;
+	}
+
+	return YES;
+}
+
+/**
+ * Stops decompressing; the background threads finish once they next check in.
+ */
+- (void)cancel
+{
+	[chunkQueue cancel];
+	[readQueue cancel];
+}
+
+#pragma mark -
+#pragma mark bzip2
+
+/**
+ * Reads the file, splitting it into blocks which are each queued and handed off to be decompressed.
+ */
+- (void)_readBzip2Blocks
+{
+	@autoreleasepool {
+		SPBzip2BlockScanner *scanner = SPBzip2BlockScannerCreate();
+		void *readBuffer = malloc(SPParallelDecompressorReadLength);
+		dispatch_queue_t decompressionQueue = dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0);
+		BOOL endOfInput = NO;
+
+		while (!endOfInput && ![chunkQueue isCancelled])
+		{
+			size_t readLength = (scanner && readBuffer) ? fread(readBuffer, 1, SPParallelDecompressorReadLength, file) : 0;
+
+			if (!scanner || !readBuffer || (readLength < SPParallelDecompressorReadLength && ferror(file))) {
+				[self _queueErrorChunk:NSLocalizedString(@"The file could not be read.", @"compressed import file read error")];
+				break;
+			}
+
+			endOfInput = (readLength < SPParallelDecompressorReadLength);
+
+			if (!SPBzip2BlockScannerAppend(scanner, readBuffer, readLength)) {
+				[self _queueErrorChunk:NSLocalizedString(@"The file could not be read.", @"compressed import file read error")];
+				break;
+			}
+
+			SPBzip2Block block;
+			bool scanFailed;
+
+			while (SPBzip2BlockScannerNextBlock(scanner, endOfInput, &block, &scanFailed))
+			{
+				SPDecompressedChunk *chunk = [[SPDecompressedChunk alloc] init];
+
+				chunk->block = block;
+				chunk->compressedEnd = block.compressedEnd;
+
+				// Waits for space, so no more blocks are decompressed at once than the queue holds
+				if (![chunkQueue enqueue:chunk]) break;
+
+				dispatch_async(decompressionQueue, ^{
+					chunk->data = SPDecompressBzip2Blocks(&chunk->block, 1);
+					dispatch_semaphore_signal(chunk->decompressed);
+				});
+			}
+
+			if (scanFailed) {
+				[self _queueErrorChunk:NSLocalizedString(@"The file could not be read.", @"compressed import file read error")];
+				break;
+			}
+		}
+
+		[chunkQueue close];
+
+		SPBzip2BlockScannerFree(scanner);
+		free(readBuffer);
+		fclose(file);
+	}
+}
+
+#pragma mark -
+#pragma mark gzip
+
+/**
+ * Reads the file ahead of the inflating thread.
+ */
+- (void)_readGzipData
+{
+	@autoreleasepool {
+		while (![readQueue isCancelled])
+		{
+			NSMutableData *compressedData = [NSMutableData dataWithLength:SPParallelDecompressorReadLength];
+			size_t readLength = fread([compressedData mutableBytes], 1, SPParallelDecompressorReadLength, file);
+
+			// An empty read marks a read error for the inflating thread
+			if (readLength < SPParallelDecompressorReadLength && ferror(file)) {
+				[readQueue enqueue:[NSData data]];
+				break;
+			}
+
+			if (!readLength) break;
+
+			[compressedData setLength:readLength];
+
+			if (![readQueue enqueue:compressedData] || readLength < SPParallelDecompressorReadLength) break;
+		}
+
+		[readQueue close];
+
+		fclose(file);
+	}
+}
+
+/**
+ * Inflates the data read by the reading thread into chunks. A file may hold several gzip members
+ * one after another, as parallel compressors write them, which are read as one; anything else
+ * after a member is ignored, as gzread does.
+ */
+- (void)_inflateGzipData
+{
+	@autoreleasepool {
+		z_stream stream;
+		memset(&stream, 0, sizeof(stream));
+
+		// A window size of 15 plus 32 detects the gzip wrapper
+		if (inflateInit2(&stream, 15 + 32) != Z_OK) {
+			[self _queueErrorChunk:NSLocalizedString(@"The file could not be decompressed.", @"compressed import file decompression error")];
+			[chunkQueue close];
+			return;
+		}
+
+		NSMutableData *output = [NSMutableData dataWithLength:SPParallelDecompressorInflateLength];
+		unsigned long long compressedReadLength = 0;
+		BOOL memberEnded = NO;
+		BOOL memberStarted = NO;
+		BOOL finished = NO;
+		NSString *errorMessage = nil;
+		NSData *compressedData;
+
+		stream.next_out = [output mutableBytes];
+		stream.avail_out = (uInt)SPParallelDecompressorInflateLength;
+
+		while (!finished && (compressedData = [readQueue dequeue]))
+		{
+			if (![compressedData length]) {
+				errorMessage = NSLocalizedString(@"The file could not be read.", @"compressed import file read error");
+				break;
+			}
+
+			stream.next_in = (Bytef *)[compressedData bytes];
+			stream.avail_in = (uInt)[compressedData length];
+
+			while (!finished)
+			{
+				if (memberEnded && stream.avail_in) {
+					if (*stream.next_in != 0x1f) {
+						finished = YES;
+						break;
+					}
+
+					inflateReset(&stream);
+					memberEnded = NO;
+				}
+
+				int result = inflate(&stream, Z_NO_FLUSH);
+
+				if (result == Z_STREAM_END) {
+					memberEnded = YES;
+				}
+				else if (result != Z_OK && result != Z_BUF_ERROR) {
+					errorMessage = NSLocalizedString(@"The file could not be decompressed; it may be damaged.", @"compressed import file damaged error");
+					finished = YES;
+					break;
+				}
+
+				memberStarted = YES;
+
+				// Hand on a full chunk; inflate may still have more output for the same input
+				if (!stream.avail_out) {
+					SPDecompressedChunk *chunk = [[SPDecompressedChunk alloc] init];
+
+					chunk->data = output;
+					chunk->compressedEnd = compressedReadLength + [compressedData length] - stream.avail_in;
+					dispatch_semaphore_signal(chunk->decompressed);
+
+					if (![chunkQueue enqueue:chunk]) {
+						finished = YES;
+						break;
+					}
+
+					output = [NSMutableData dataWithLength:SPParallelDecompressorInflateLength];
+					stream.next_out = [output mutableBytes];
+					stream.avail_out = (uInt)SPParallelDecompressorInflateLength;
+
+					continue;
+				}
+
+				if (!stream.avail_in) break;
+			}
+
+			compressedReadLength += [compressedData length];
+		}
+
+		if (!errorMessage && ![chunkQueue isCancelled]) {
+			if (memberStarted && !memberEnded && !finished) {
+				errorMessage = NSLocalizedString(@"The file ended unexpectedly; it may be incomplete.", @"compressed import file truncated error");
+			}
+
+			// The rest of the last member's output
+			if (stream.avail_out < SPParallelDecompressorInflateLength) {
+				SPDecompressedChunk *chunk = [[SPDecompressedChunk alloc] init];
+
+				[output setLength:SPParallelDecompressorInflateLength - stream.avail_out];
+
+				chunk->data = output;
+				chunk->compressedEnd = compressedReadLength;
+				dispatch_semaphore_signal(chunk->decompressed);
+
+				[chunkQueue enqueue:chunk];
+			}
+		}
+
+		if (errorMessage) [self _queueErrorChunk:errorMessage];
+
+		[chunkQueue close];
+
+		// Let the reading thread finish if it is waiting on a full queue
+		[readQueue cancel];
+
+		inflateEnd(&stream);
+	}
+}
+
+#pragma mark -
+#pragma mark Private API
+
+/**
+ * Queues a chunk which raises the supplied error when it is taken.
+ */
+- (void)_queueErrorChunk:(NSString *)message
+{
+	SPDecompressedChunk *chunk = [[SPDecompressedChunk alloc] init];
+
+	chunk->errorMessage = message;
+	dispatch_semaphore_signal(chunk->decompressed);
+
+	[chunkQueue enqueue:chunk];
+}
+
+/**
+ * Waits for the next chunk in the file to be decompressed, raising an exception if it can't be.
+ *
+ * A bzip2 block which won't decompress may have been cut short by a false match of a magic number
+ * inside it, so it is tried joined with the blocks after it before it's taken to be damaged.
+ */
+- (SPDecompressedChunk *)_nextDecompressedChunk
+{
+	SPDecompressedChunk *chunk = pendingChunk ? pendingChunk : [chunkQueue dequeue];
+
+	pendingChunk = nil;
+
+	if (!chunk) return nil;
+
+	dispatch_semaphore_wait(chunk->decompressed, DISPATCH_TIME_FOREVER);
+
+	if (!chunk->data && !chunk->errorMessage) {
+		NSMutableArray *joinedChunks = [NSMutableArray arrayWithObject:chunk];
+		SPBzip2Block blocks[SPParallelDecompressorMaxJoinedBlocks + 1];
+		size_t blockCount = 1;
+
+		blocks[0] = chunk->block;
+		chunk->errorMessage = NSLocalizedString(@"The file could not be decompressed; it may be damaged.", @"compressed import file damaged error");
+
+		while (blockCount <= SPParallelDecompressorMaxJoinedBlocks)
+		{
+			SPDecompressedChunk *nextChunk = [chunkQueue dequeue];
+
+			if (!nextChunk) break;
+
+			dispatch_semaphore_wait(nextChunk->decompressed, DISPATCH_TIME_FOREVER);
+
+			if (nextChunk->errorMessage) {
+				chunk = nextChunk;
+				break;
+			}
+
+			[joinedChunks addObject:nextChunk];
+
+			// After a false match of the end of a stream, only the bits up to the next block's own
+			// magic number belong to the block being joined, and the next block stands on its own
+			if (nextChunk->block.startBit) {
+				blocks[blockCount] = nextChunk->block;
+				blocks[blockCount].bitLength = nextChunk->block.startBit;
+				blocks[blockCount].startBit = 0;
+
+				NSData *joinedData = SPDecompressBzip2Blocks(blocks, blockCount + 1);
+
+				if (joinedData) {
+					chunk->data = joinedData;
+					pendingChunk = nextChunk;
+					break;
+				}
+			}
+
+			blocks[blockCount++] = nextChunk->block;
+
+			NSData *joinedData = SPDecompressBzip2Blocks(blocks, blockCount);
+
+			if (joinedData) {
+				chunk = nextChunk;
+				chunk->data = joinedData;
+				break;
+			}
+		}
+	}
+
+	if (!chunk->data) {
+		endOfFile = YES;
+		[self cancel];
+
+		[NSException raise:NSFileHandleOperationException format:@"%@", chunk->errorMessage];
+	}
+
+	return chunk;
+}
+
+/**
+ * Moves on to the next decompressed chunk, returning NO at the end of the file.
+ */
+- (BOOL)_takeNextChunk
+{
+	currentChunkData = nil;
+	currentChunkPosition = 0;
+
+	if (endOfFile) return NO;
+
+	SPDecompressedChunk *chunk = [self _nextDecompressedChunk];
+
+	if (!chunk) {
+		endOfFile = YES;
+		return NO;
+	}
+
+	compressedOffset = chunk->compressedEnd;
+	currentChunkData = chunk->data;
+
+	return YES;
+}
+
+#pragma mark -
+
+- (void)dealloc
+{
+	[self cancel];
+}
+
+@end
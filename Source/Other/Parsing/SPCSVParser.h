@@ -28,10 +28,13 @@
 //
 //  More info at <https://github.com/sequelpro/sequelpro>
 
+#import "SPCSVTokenizer.h"
+
 /**
  * This class provides a string class intended for CSV parsing.  Unlike SPSQLParser, this
  * does not extend NSMutableString and instead provides only a subset of similar methods.
- * Internally, an approach similar to NSScanner is used to support multi-character strings.
+ * The CSV is held as UTF-8 and split into rows by SPCSVTokenizer, which works on the bytes
+ * directly; only the fields of each returned row are decoded into strings.
  * The methods are designed with the intention that as a string is parsed the parsed content
  * is removed.  This also allows parsing to occur in "streaming" mode, with parseable content
  * being pulled off the start of the string as additional content is appended onto the end of
@@ -40,45 +43,39 @@
  * Supports:
  *  - Control of field terminator, line terminator, string enclosures and escape characters.
  *  - Multi-character field terminator, line terminator, string enclosures, and escape strings.
- *  - Stream-based processing (recommended that strings split by \n or \r are used when streaming
- *    to minimise multibyte issues)
+ *  - Stream-based processing, either of strings or of raw UTF-8 data split at any point
  *  - Correct treatment of line terminators within quoted strings and proper escape support
  *    including escape characters matching the quote characters in Excel style
  *
- * The internal usage of string range finding, similar to the NSScanner approach, means this
- * could be significantly sped up for single-character terminators.
+ * Lengths and positions are counted in bytes of UTF-8.
+ *
+ * When streaming with several parsing threads allowed, a large amount of unparsed data is split
+ * into chunks which are parsed at the same time. Where each chunk's rows start is worked out by a
+ * quick scan of every chunk from each quoting state it could start in, then resolved in order; the
+ * chunks' rows are then only used if the rows before really do end where each chunk was taken to
+ * start, and parsed again in order otherwise, so the rows returned are always the same.
  */
 
-#define SPCSVPARSER_TRIM_ENACT_LENGTH 250000
-
 @interface SPCSVParser : NSObject
 {
-	NSMutableString *csvString;
-
-	NSUInteger trimPosition;
-	NSUInteger parserPosition;
-	NSUInteger totalLengthParsed;
-	NSUInteger csvStringLength;
+	SPCSVTokenizer *tokenizer;
+	NSMutableArray *appendedChunks;
+	NSMutableArray *appendedChunkEnds;
 	NSInteger fieldCount;
+	BOOL decodingFailed;
 
 	NSString *nullReplacementString;
 	NSString *fieldEndString;
 	NSString *lineEndString;
 	NSString *fieldQuoteString;
 	NSString *escapeString;
-	NSString *escapedFieldEndString;
-	NSString *escapedLineEndString;
-	NSString *escapedFieldQuoteString;
-	NSString *escapedEscapeString;
-	NSInteger fieldEndLength;
-	NSInteger lineEndLength;
-	NSInteger fieldQuoteLength;
-	NSInteger escapeLength;
-	NSCharacterSet *skipCharacterSet;
-	NSScanner *csvScanner;
-
-	BOOL escapeStringIsFieldQuoteString;
 	BOOL useStrictEscapeMatching;
+
+	NSUInteger parsingThreads;
+	NSMutableArray *queuedRows;
+	NSMutableData *queuedRowInfo;
+	NSUInteger queuedRowIndex;
+	NSUInteger queuedLengthParsed;
 }
 
 /* Retrieving data from the CSV string */
@@ -88,6 +85,8 @@
 
 /* Adding new data to the string */
 - (void) appendString:(NSString *)aString;
+- (void) appendData:(NSData *)someData;
+- (void) appendDataNoCopy:(NSData *)someData;
 - (void) setString:(NSString *)aString;
 
 /* Basic information */
@@ -95,6 +94,7 @@
 - (NSString *) string;
 - (NSUInteger) parserPosition;
 - (NSUInteger) totalLengthParsed;
+- (BOOL) decodingFailed;
 
 /* Setting the terminator, quote, escape and null character replacement strings */
 - (void) setFieldTerminatorString:(NSString *)theString convertDisplayStrings:(BOOL)convertString;
@@ -104,16 +104,21 @@
 - (void) setNullReplacementString:(NSString *)nullString;
 - (void) setEscapeStringsAreMatchedStrictly:(BOOL)strictMatching;
 
+/* Parsing on several threads when streaming */
+- (void) setParsingThreads:(NSUInteger)threadCount;
+- (NSUInteger) parsingThreads;
+
 /* Accessors for configured separators */
+- (NSString *)fieldTerminatorString;
 - (NSString *)lineTerminatorString;
+- (NSString *)fieldQuoteString;
+- (NSString *)escapeString;
+- (BOOL)escapeStringsAreMatchedStrictly;
+- (NSString *)nullReplacementString;
 
 /* Init and internal update methods */
 - (void) _initialiseCSVParserDefaults;
-- (void) _moveParserPastSkippableCharacters;
-- (NSUInteger) _getDistanceToString:(NSString *)theString;
-- (void) _updateState;
 - (NSString *) _convertDisplayString:(NSString *)theString;
-- (void) _updateSkipCharacterSet;
 
 /* Initialisation and teardown */
 #pragma mark -
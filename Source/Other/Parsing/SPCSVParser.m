@@ -31,6 +31,57 @@
 #import "SPCSVParser.h"
 #import "SPNotLoaded.h"
 
+// Unparsed data is only split for parsing on several threads once there is enough to fill two chunks
+static const NSUInteger SPCSVParallelMinimumChunkLength = 1024 * 1024;
+
+// The most data parsed ahead in one go, which bounds the rows held waiting to be returned
+static const NSUInteger SPCSVParallelMaximumLength = 64 * 1024 * 1024;
+
+/**
+ * A parsed row waiting to be returned, in queuedRowInfo alongside queuedRows.
+ */
+typedef struct {
+	NSUInteger lengthParsed;
+	BOOL decodingFailed;
+} SPCSVQueuedRowInfo;
+
+/**
+ * Decodes the fields of a row returned by the tokenizer, inserting NSNull for any it found to
+ * be NULL. Fields which aren't valid UTF-8 are returned empty and noted in decodingFailed. This
+ * touches no parser state, so chunks may be decoded on several threads at once.
+ */
+static NSMutableArray *SPCSVRowArray(const SPCSVRow *row, NSUInteger capacity, BOOL *decodingFailed)
+{
+	NSMutableArray *csvRowArray = [NSMutableArray arrayWithCapacity:MAX(row->fieldCount, capacity)];
+
+	for (NSUInteger i = 0; i < row->fieldCount; i++)
+	{
+		if (row->fields[i].isNull) {
+			[csvRowArray addObject:[NSNull null]];
+			continue;
+		}
+
+		NSString *csvCellString = [[NSString alloc] initWithBytes:row->fields[i].bytes length:row->fields[i].length encoding:NSUTF8StringEncoding];
+
+		if (!csvCellString) {
+			*decodingFailed = YES;
+			csvCellString = @"";
+		}
+
+		[csvRowArray addObject:csvCellString];
+	}
+
+	return csvRowArray;
+}
+
+@interface SPCSVParser ()
+
+- (NSArray *)_rowArrayPaddedToFieldCount:(NSMutableArray *)csvRowArray;
+- (void)_parseAheadOnParsingThreads;
+- (void)_clearQueuedRows;
+
+@end
+
 /**
  * Please see the header files for a general description of the purpose of this class.
  */
@@ -50,8 +101,8 @@
 	NSArray *csvRowArray;
 
 	// Ensure that the full string is being parsed by resetting the parser position
-	parserPosition = trimPosition;
-	totalLengthParsed = 0;
+	[self _clearQueuedRows];
+	SPCSVTokenizerRewind(tokenizer);
 
 	// Loop through the results fetching process
 	while ((csvRowArray = [self getRowAsArrayAndTrimString:NO stringIsComplete:YES]))
@@ -86,250 +137,81 @@
  */
 - (NSArray *) getRowAsArrayAndTrimString:(BOOL)trimString stringIsComplete:(BOOL)stringComplete
 {
-	NSMutableArray *csvRowArray;
-	NSMutableString *csvCellString = [NSMutableString string];
-	NSUInteger startingParserPosition, nextQuoteDistance, nextFieldEndDistance, nextLineEndDistance;
-	NSInteger skipLength, j;
-	BOOL fieldIsQuoted, isEscaped;
-	BOOL nonStrictEscapeMatchingFallback = NO;
-	BOOL lineEndingEncountered = NO;
-
-	if (fieldCount == NSNotFound)
-		csvRowArray = [NSMutableArray array];
-	else
-		csvRowArray = [NSMutableArray arrayWithCapacity:fieldCount];
-
-	// Store the starting parser position so it can be restored if necessary
-	startingParserPosition = parserPosition;
-
-	// Loop along the CSV string, parsing.
-	while (parserPosition < csvStringLength && !lineEndingEncountered) {
-		[csvCellString setString:@""];
-		fieldIsQuoted = NO;
-
-		// Skip unescaped, unquoted whitespace where possible
-		[self _moveParserPastSkippableCharacters];
-
-		// Check the start of the string for the quote character, and loop along the string
-		// if so to capture the entire quoted string.
-		if (fieldQuoteLength && parserPosition + fieldQuoteLength <= csvStringLength
-			&& [[csvString substringWithRange:NSMakeRange(parserPosition, fieldQuoteLength)] isEqualToString:fieldQuoteString])
-		{
-			parserPosition += fieldQuoteLength;
-			fieldIsQuoted = YES;
-
-			while (parserPosition < csvStringLength) {
-
-				// Find the next quote string
-				nextQuoteDistance = [self _getDistanceToString:fieldQuoteString];
-
-				// Check to see if the quote string encountered was escaped... or an escaper
-				if (escapeLength && nextQuoteDistance != NSNotFound) {
-					j = 1;
-					isEscaped = NO;
-					nonStrictEscapeMatchingFallback = NO;
-					if (!escapeStringIsFieldQuoteString) {
-						while (j * escapeLength <= (NSInteger)nextQuoteDistance
-								&& ([[csvString substringWithRange:NSMakeRange((parserPosition + nextQuoteDistance - (j*escapeLength)), escapeLength)] isEqualToString:escapeString]))
-						{
-							isEscaped = !isEscaped;
-							j++;
-						}
-						skipLength = fieldQuoteLength;
-						if (!useStrictEscapeMatching && !isEscaped) nonStrictEscapeMatchingFallback = YES;
-					}
-					
-					// If the escape string is the field quote string, check for doubled (Excel-style) usage.
-					// Also, if the parser is in loose mode, also support field end strings quoted by using
-					// another field end string, as used by Excel
-					if (escapeStringIsFieldQuoteString || nonStrictEscapeMatchingFallback) {
-						if (parserPosition + nextQuoteDistance + (2 * fieldQuoteLength) <= csvStringLength
-							&& [[csvString substringWithRange:NSMakeRange(parserPosition + nextQuoteDistance + fieldQuoteLength, fieldQuoteLength)] isEqualToString:fieldQuoteString])
-						{
-							isEscaped = YES;
-							skipLength = 2 * fieldQuoteLength;
-						}
-					}
-
-					// If it was escaped, keep processing the field.
-					if (isEscaped) {
-						
-						// Append the matched string, together with the field quote character
-						// which has been determined to be within the string - but append the
-						// field end character unescaped to avoid later processing.
-						if (escapeStringIsFieldQuoteString || nonStrictEscapeMatchingFallback) {
-							[csvCellString appendString:[csvString substringWithRange:NSMakeRange(parserPosition, nextQuoteDistance+fieldQuoteLength)]];
-						} else {
-							[csvCellString appendString:[csvString substringWithRange:NSMakeRange(parserPosition, nextQuoteDistance - escapeLength)]];
-							[csvCellString appendString:fieldQuoteString];
-						}
-
-						// Move the parser location to beyond the field end character[s]
-						parserPosition += nextQuoteDistance + skipLength;
-						continue;
-					}
-				}
-				
-				// Add on the scanned string up to the terminating quote character.
-				if (nextQuoteDistance != NSNotFound) {
-					[csvCellString appendString:[csvString substringWithRange:NSMakeRange(parserPosition, nextQuoteDistance)]];
-					parserPosition += nextQuoteDistance + fieldQuoteLength;
-				} else {
-					[csvCellString appendString:[csvString substringWithRange:NSMakeRange(parserPosition, csvStringLength - parserPosition)]];
-					parserPosition = csvStringLength;
-				}
+	SPCSVRow row;
 
-				// We should now be at the end of the field - continue on past the quote,
-				// and remove whitespace if possible.
-				if (parserPosition < csvStringLength) {
-					[self _moveParserPastSkippableCharacters];
-				}
+	// When streaming, parse as much as possible ahead on the parsing threads, if allowed
+	if (!queuedRows && trimString && parsingThreads > 1) [self _parseAheadOnParsingThreads];
 
-				// Break out of the quoted field processing loop.
-				break;
-			}
-		}
+	// Return rows parsed ahead first, in order
+	if (queuedRows) {
+		NSMutableArray *csvRowArray = [queuedRows objectAtIndex:queuedRowIndex];
+		const SPCSVQueuedRowInfo *info = (const SPCSVQueuedRowInfo *)[queuedRowInfo bytes] + queuedRowIndex;
 
-		// With quoted strings processed, now process the field until the next field end
-		// character, or the next line end character, both of which may terminate the current
-		// field.  This also handles unquoted strings/numbers.
-		while (parserPosition < csvStringLength) {
-
-			// Determine whether a line end or a field end occurs first
-			nextFieldEndDistance = [self _getDistanceToString:fieldEndString];
-			nextLineEndDistance = [self _getDistanceToString:lineEndString];
-			if (nextLineEndDistance != NSNotFound
-				&& (nextLineEndDistance < nextFieldEndDistance
-					|| nextFieldEndDistance == NSNotFound))
-			{
-				nextFieldEndDistance = nextLineEndDistance;
-				lineEndingEncountered = YES;
-				skipLength = lineEndLength;
-			} else if (nextFieldEndDistance != NSNotFound) {
-				skipLength = fieldEndLength;
-			} else {
-				[csvCellString appendString:[csvString substringWithRange:NSMakeRange(parserPosition, csvStringLength - parserPosition)]];
-				parserPosition = csvStringLength;
-				break;
-			}
+		if (info->decodingFailed) decodingFailed = YES;
+		queuedLengthParsed = info->lengthParsed;
 
-			// Check to see if the termination character was escaped
-			if (escapeLength) {
-				j = 1;
-				isEscaped = NO;
-				while (j * escapeLength <= (NSInteger)nextFieldEndDistance
-						&& ([[csvString substringWithRange:NSMakeRange((parserPosition + nextFieldEndDistance - (j*escapeLength)), escapeLength)] isEqualToString:escapeString]))
-				{
-					isEscaped = !isEscaped;
-					j++;
-				}
+		if (++queuedRowIndex == [queuedRows count]) [self _clearQueuedRows];
 
-				// If it was, continue processing the field
-				if (isEscaped) {
-				
-					// Append the matched string, together with the field/line character
-					// which was encountered - but append the string unescaped to avoid
-					// later processing.
-					[csvCellString appendString:[csvString substringWithRange:NSMakeRange(parserPosition, nextFieldEndDistance - escapeLength)]];
-					if (lineEndingEncountered) {
-						[csvCellString appendString:lineEndString];
-						lineEndingEncountered = NO;
-					} else {
-						[csvCellString appendString:fieldEndString];
-					}
-
-					// Update the parser location as appropriate
-					parserPosition += nextFieldEndDistance + skipLength;
-					continue;
-				}
-			}
+		return [self _rowArrayPaddedToFieldCount:csvRowArray];
+	}
 
-			// Add on the scanned string up to the terminating character
-			[csvCellString appendString:[csvString substringWithRange:NSMakeRange(parserPosition, nextFieldEndDistance)]];
-			parserPosition += nextFieldEndDistance + skipLength;
+	if (!SPCSVTokenizerNextRow(tokenizer, stringComplete, trimString, &row)) return nil;
 
-			break;
-		}
+	// Only the fields themselves are decoded; note data which isn't valid UTF-8 for the
+	// caller, keeping the row shape intact
+	NSMutableArray *csvRowArray = SPCSVRowArray(&row, (fieldCount == NSNotFound) ? 0 : (NSUInteger)fieldCount, &decodingFailed);
 
-		// We now have a field content string.
-		// Insert a NSNull object if the cell contains an unescaped null character or 
-		// an unquoted string which matches the set null replacement string.
-		if ([csvCellString isEqualToString:@"\\N"]
-			|| (!fieldIsQuoted && nullReplacementString && [csvCellString isEqualToString:nullReplacementString]))
-		{
-			[csvRowArray addObject:[NSNull null]];
-		} else {
-				
-			// Clean up escaped characters
-			if (escapeLength) {
-				if (fieldIsQuoted && fieldEndLength)
-					[csvCellString replaceOccurrencesOfString:escapedFieldEndString withString:fieldEndString options:NSLiteralSearch range:NSMakeRange(0, [csvCellString length])];
-				if (!fieldIsQuoted && fieldQuoteLength)
-					[csvCellString replaceOccurrencesOfString:escapedFieldQuoteString withString:fieldQuoteString options:NSLiteralSearch range:NSMakeRange(0, [csvCellString length])];
-				if (fieldIsQuoted && lineEndLength)
-					[csvCellString replaceOccurrencesOfString:escapedLineEndString withString:lineEndString options:NSLiteralSearch range:NSMakeRange(0, [csvCellString length])];
-				if (!escapeStringIsFieldQuoteString)
-					[csvCellString replaceOccurrencesOfString:escapedEscapeString withString:escapeString options:NSLiteralSearch range:NSMakeRange(0, [csvCellString length])];
-			}
+	return [self _rowArrayPaddedToFieldCount:csvRowArray];
+}
 
-			// Add the field to the row array
-			[csvRowArray addObject:[NSString stringWithString:csvCellString]];
-		}
-	}
+#pragma mark -
+#pragma mark Adding new data to the string
+
+/**
+ * Append additional data to the CSV string, for example to allow streaming parsing.
+ */
+- (void) appendString:(NSString *)aString
+{
+	[self appendData:[aString dataUsingEncoding:NSUTF8StringEncoding allowLossyConversion:YES]];
+}
 
-	// If no line ending was encountered, as stringIsComplete is set to NO, return nil
-	// to ensure we don't return a "row" which is incomplete
-	if (!lineEndingEncountered && !stringComplete) {
-		parserPosition = startingParserPosition;
-		return nil;
+/**
+ * Append additional UTF-8 data to the CSV, which may end part way through a row or even
+ * a character; this avoids decoding a file being streamed in before it is parsed.
+ */
+- (void) appendData:(NSData *)someData
+{
+	if (!SPCSVTokenizerAppend(tokenizer, [someData bytes], [someData length])) {
+		[NSException raise:NSMallocException format:@"Unable to grow the CSV buffer by %lu bytes", (unsigned long)[someData length]];
 	}
+}
 
-	// Update the total parsed length (differs from parserPosition following trims)
-	totalLengthParsed += parserPosition - startingParserPosition;
+/**
+ * Append additional UTF-8 data as appendData: does, but keep the data rather than copying it
+ * where it follows on in memory from the data appended before, as slices of a memory-mapped
+ * file do. The data is kept until the rows it holds have been parsed and trimmed.
+ */
+- (void) appendDataNoCopy:(NSData *)someData
+{
+	size_t untrimmedLength;
 
-	// Skip empty rows.  Note the NSNull pointer comparison; as [NSNull null] is a singleton this works correctly.
-	if ([csvRowArray count] == 0
-		|| ([csvRowArray count] == 1
-			&& ([csvRowArray objectAtIndex:0] == [NSNull null]
-				|| ![[csvRowArray objectAtIndex:0] length])))
+	// Let go of the data already parsed and trimmed
+	while ([appendedChunkEnds count] && [[appendedChunkEnds objectAtIndex:0] unsignedLongLongValue] <= SPCSVTokenizerTrimmedLength(tokenizer))
 	{
-
-		// If the parser is at the end of the string, return nil
-		if (parserPosition == csvStringLength) return nil;
-
-		// Otherwise, retrieve the next row and return that instead
-		return [self getRowAsArrayAndTrimString:trimString stringIsComplete:stringComplete];
+		[appendedChunks removeObjectAtIndex:0];
+		[appendedChunkEnds removeObjectAtIndex:0];
 	}
 
-	// Update the string trim state if appropriate, and lazily trigger trims
-	if (trimString) {
-		trimPosition = parserPosition;
-		[self _updateState];
+	if (!SPCSVTokenizerAppendNoCopy(tokenizer, [someData bytes], [someData length])) {
+		[NSException raise:NSMallocException format:@"Unable to grow the CSV buffer by %lu bytes", (unsigned long)[someData length]];
 	}
 
-	// Capture the length of the first row when processing, and ensure that all
-	// subsequent rows contain that many cells (fill them with [SPNotLoaded notLoaded]
-	// to allow to replace these by the table column's DEFAULT value)
-	if (fieldCount == NSNotFound) {
-		fieldCount = [csvRowArray count];
-	} else if ([csvRowArray count] < (NSUInteger)fieldCount) {
-		for (j = [csvRowArray count]; j < fieldCount; j++) [csvRowArray addObject:[SPNotLoaded notLoaded]];
-	}
+	if (![someData length]) return;
 
-	// Return the row
-	return csvRowArray;
-}
+	SPCSVTokenizerUntrimmedBytes(tokenizer, &untrimmedLength);
 
-#pragma mark -
-#pragma mark Adding new data to the string
-
-/**
- * Append additional data to the CSV string, for example to allow streaming parsing.
- */
-- (void) appendString:(NSString *)aString
-{
-	[csvString appendString:aString];
-	csvStringLength += [aString length];
+	[appendedChunks addObject:someData];
+	[appendedChunkEnds addObject:@(SPCSVTokenizerTrimmedLength(tokenizer) + untrimmedLength)];
 }
 
 /**
@@ -337,10 +219,12 @@
  */
 - (void) setString:(NSString *)aString
 {
-	trimPosition = 0;
-	totalLengthParsed = 0;
-	[csvString setString:aString];
-	csvStringLength = [csvString length];
+	[self _clearQueuedRows];
+	SPCSVTokenizerReset(tokenizer);
+	[appendedChunks removeAllObjects];
+	[appendedChunkEnds removeAllObjects];
+	decodingFailed = NO;
+	[self appendString:aString];
 }
 
 #pragma mark -
@@ -351,7 +235,11 @@
  */
 - (NSUInteger) length
 {
-	return csvStringLength - trimPosition;
+	size_t untrimmedLength;
+
+	SPCSVTokenizerUntrimmedBytes(tokenizer, &untrimmedLength);
+
+	return untrimmedLength;
 }
 
 /**
@@ -359,7 +247,10 @@
  */
 - (NSString *) string
 {
-	return [csvString substringWithRange:NSMakeRange(trimPosition, csvStringLength - trimPosition)];
+	size_t untrimmedLength;
+	const uint8_t *untrimmedBytes = SPCSVTokenizerUntrimmedBytes(tokenizer, &untrimmedLength);
+
+	return [[NSString alloc] initWithBytes:untrimmedBytes length:untrimmedLength encoding:NSUTF8StringEncoding];
 }
 
 /**
@@ -367,7 +258,7 @@
  */
 - (NSUInteger) parserPosition
 {
-	return parserPosition;
+	return SPCSVTokenizerParserPosition(tokenizer);
 }
 
 /**
@@ -376,7 +267,18 @@
  */
 - (NSUInteger) totalLengthParsed
 {
-	return totalLengthParsed;
+	// The tokenizer has already moved on past rows parsed ahead
+	if (queuedRows) return queuedLengthParsed;
+
+	return (NSUInteger)SPCSVTokenizerTotalLengthParsed(tokenizer);
+}
+
+/**
+ * Return whether any field returned so far was not valid UTF-8, and so was returned empty.
+ */
+- (BOOL) decodingFailed
+{
+	return decodingFailed;
 }
 
 #pragma mark -
@@ -393,10 +295,9 @@
 		theString = [self _convertDisplayString:theString];
 	}
 	fieldEndString = [[NSString alloc] initWithString:theString];
-	fieldEndLength = [fieldEndString length];
-	escapedFieldEndString = [[NSString alloc] initWithFormat:@"%@%@", escapeString, fieldEndString];
 
-	[self _updateSkipCharacterSet];
+	NSData *stringData = [fieldEndString dataUsingEncoding:NSUTF8StringEncoding];
+	SPCSVTokenizerSetFieldTerminator(tokenizer, [stringData bytes], [stringData length]);
 }
 
 /**
@@ -410,10 +311,9 @@
 		theString = [self _convertDisplayString:theString];
 	}
 	lineEndString = [[NSString alloc] initWithString:theString];
-	lineEndLength = [lineEndString length];
-	escapedLineEndString = [[NSString alloc] initWithFormat:@"%@%@", escapeString, lineEndString];
 
-	[self _updateSkipCharacterSet];
+	NSData *stringData = [lineEndString dataUsingEncoding:NSUTF8StringEncoding];
+	SPCSVTokenizerSetLineTerminator(tokenizer, [stringData bytes], [stringData length]);
 }
 
 /**
@@ -427,11 +327,9 @@
 		theString = [self _convertDisplayString:theString];
 	}
 	fieldQuoteString = [[NSString alloc] initWithString:theString];
-	fieldQuoteLength = [fieldQuoteString length];
-	escapedFieldQuoteString = [[NSString alloc] initWithFormat:@"%@%@", escapeString, fieldQuoteString];
-	escapeStringIsFieldQuoteString = [fieldQuoteString isEqualToString:escapeString];
 
-	[self _updateSkipCharacterSet];
+	NSData *stringData = [fieldQuoteString dataUsingEncoding:NSUTF8StringEncoding];
+	SPCSVTokenizerSetFieldQuote(tokenizer, [stringData bytes], [stringData length]);
 }
 
 /**
@@ -445,11 +343,9 @@
 		theString = [self _convertDisplayString:theString];
 	}
 	escapeString = [[NSString alloc] initWithString:theString];
-	escapeLength = [escapeString length];
-	escapedEscapeString = [[NSString alloc] initWithFormat:@"%@%@", escapeString, escapeString];
-	escapeStringIsFieldQuoteString = [fieldQuoteString isEqualToString:escapeString];
 
-	[self _updateSkipCharacterSet];
+	NSData *stringData = [escapeString dataUsingEncoding:NSUTF8StringEncoding];
+	SPCSVTokenizerSetEscape(tokenizer, [stringData bytes], [stringData length]);
 }
 
 /**
@@ -458,9 +354,12 @@
  */
 - (void) setNullReplacementString:(NSString *)nullString
 {
-	
+	if (!nullString) return;
+
+	nullReplacementString = [[NSString alloc] initWithString:nullString];
 
-	if (nullString) nullReplacementString = [[NSString alloc] initWithString:nullString];
+	NSData *stringData = [nullReplacementString dataUsingEncoding:NSUTF8StringEncoding];
+	SPCSVTokenizerSetNullReplacement(tokenizer, [stringData bytes] ? [stringData bytes] : "", [stringData length]);
 }
 
 /**
@@ -472,6 +371,32 @@
 - (void) setEscapeStringsAreMatchedStrictly:(BOOL)strictMatching
 {
 	useStrictEscapeMatching = strictMatching;
+	SPCSVTokenizerSetStrictEscapeMatching(tokenizer, strictMatching);
+}
+
+/**
+ * Allow up to the supplied number of threads to parse at once when streaming with trimming; the
+ * default of one parses each row as it is requested.
+ */
+- (void) setParsingThreads:(NSUInteger)threadCount
+{
+	parsingThreads = MAX(threadCount, (NSUInteger)1);
+}
+
+/**
+ * Return the number of threads allowed to parse at once.
+ */
+- (NSUInteger) parsingThreads
+{
+	return parsingThreads;
+}
+
+/**
+ * Return the currently configured field terminator string.
+ */
+- (NSString *)fieldTerminatorString
+{
+	return fieldEndString;
 }
 
 /**
@@ -482,65 +407,274 @@
 	return lineEndString;
 }
 
+/**
+ * Return the currently configured field quote string.
+ */
+- (NSString *)fieldQuoteString
+{
+	return fieldQuoteString;
+}
+
+/**
+ * Return the currently configured escape string.
+ */
+- (NSString *)escapeString
+{
+	return escapeString;
+}
+
+/**
+ * Return whether only the escape string escapes field quotes, rather than doubled quotes too.
+ */
+- (BOOL)escapeStringsAreMatchedStrictly
+{
+	return useStrictEscapeMatching;
+}
+
+/**
+ * Return the string read as NULL when unquoted, if any.
+ */
+- (NSString *)nullReplacementString
+{
+	return nullReplacementString;
+}
+
 #pragma mark -
-#pragma mark Init and internal update methods
+#pragma mark Parsing on several threads
 
 /**
- * Set up the string for CSV parsing, together with class defaults.
+ * Capture the length of the first row when processing, and ensure that all subsequent rows
+ * contain that many cells (fill them with [SPNotLoaded notLoaded] to allow to replace these
+ * by the table column's DEFAULT value)
  */
-- (void) _initialiseCSVParserDefaults
+- (NSArray *)_rowArrayPaddedToFieldCount:(NSMutableArray *)csvRowArray
 {
-	trimPosition = 0;
-	fieldCount = NSNotFound;
-	parserPosition = 0;
-	totalLengthParsed = 0;
-	csvStringLength = [csvString length];
+	if (fieldCount == NSNotFound) {
+		fieldCount = [csvRowArray count];
+	} else if ([csvRowArray count] < (NSUInteger)fieldCount) {
+		for (NSUInteger i = [csvRowArray count]; i < (NSUInteger)fieldCount; i++) [csvRowArray addObject:[SPNotLoaded notLoaded]];
+	}
 
-	// Set up the default field and line separators, together with quote
-	// and escape strings
-	fieldEndString = @",";
-	lineEndString = @"\n";
-	fieldQuoteString = @"\"";
-	escapeString = @"\\";
-	escapeStringIsFieldQuoteString = NO;
-	escapedFieldEndString = @"\\,";
-	escapedLineEndString = @"\\\n";
-	escapedFieldQuoteString = @"\\\"";
-	escapedEscapeString = @"\\\\";
-	useStrictEscapeMatching = NO;
-	fieldEndLength = [fieldEndString length];
-	lineEndLength = [lineEndString length];
-	fieldQuoteLength = [fieldQuoteString length];
-	escapeLength = [escapeString length];
+	return csvRowArray;
+}
 
-	// Set up the default null replacement character string as nil
-	nullReplacementString = nil;
+/**
+ * Parses the unparsed data, up to SPCSVParallelMaximumLength of it, on several threads, queueing
+ * the complete rows found for the following requests. Any row left incomplete at the end is left
+ * for later.
+ *
+ * The data is split into equal chunks. Each chunk is first scanned for its first row start from
+ * each quoting state it might start in; the state at the end of each chunk then gives the state
+ * the next starts in, and so which of its scans to believe. Each chunk is then parsed from that
+ * row start up to its end on its own tokenizer, and the chunks' rows are joined up in order.
+ * A chunk's rows are only taken if the rows parsed before it end exactly where it was taken to
+ * start; the rows running over from one chunk into the next, and any chunk whose start was
+ * guessed wrongly, are parsed here in the usual way.
+ */
+- (void)_parseAheadOnParsingThreads
+{
+	size_t untrimmedLength;
+	const uint8_t *untrimmedBytes = SPCSVTokenizerUntrimmedBytes(tokenizer, &untrimmedLength);
+	size_t parseStart = SPCSVTokenizerParserPosition(tokenizer);
+	size_t parseLength = MIN(untrimmedLength - parseStart, (size_t)SPCSVParallelMaximumLength);
+	size_t chunkCount = MIN(parsingThreads * 4, parseLength / SPCSVParallelMinimumChunkLength);
+
+	if (chunkCount < 2) return;
+
+	size_t *chunkOffsets = malloc((chunkCount + 1) * sizeof(size_t));
+	size_t *scanRowStarts = malloc(chunkCount * SPCSVScanStateCount * sizeof(size_t));
+	SPCSVScanState *scanEndStates = malloc(chunkCount * SPCSVScanStateCount * sizeof(SPCSVScanState));
+	size_t *chunkRowStarts = malloc(chunkCount * sizeof(size_t));
+	size_t *chunkRowEnds = malloc(chunkCount * sizeof(size_t));
+
+	if (!chunkOffsets || !scanRowStarts || !scanEndStates || !chunkRowStarts || !chunkRowEnds) {
+		free(chunkOffsets);
+		free(scanRowStarts);
+		free(scanEndStates);
+		free(chunkRowStarts);
+		free(chunkRowEnds);
+		return;
+	}
+
+	for (size_t i = 0; i <= chunkCount; i++) chunkOffsets[i] = parseStart + parseLength * i / chunkCount;
+
+	dispatch_queue_t parsingQueue = dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0);
+	SPCSVTokenizer *scannedTokenizer = tokenizer;
+
+	// Scan every chunk from every state, all at once
+	dispatch_apply(chunkCount * SPCSVScanStateCount, parsingQueue, ^(size_t scan) {
+		size_t chunk = scan / SPCSVScanStateCount;
+
+		scanEndStates[scan] = SPCSVTokenizerScan(scannedTokenizer, chunkOffsets[chunk], chunkOffsets[chunk + 1], (SPCSVScanState)(scan % SPCSVScanStateCount), &scanRowStarts[scan]);
+	});
+
+	// Resolve which state each chunk starts in, and so where its first row starts
+	SPCSVScanState state = SPCSVScanFieldStart;
+
+	chunkRowStarts[0] = parseStart;
+
+	for (size_t i = 1; i < chunkCount; i++)
+	{
+		state = scanEndStates[(i - 1) * SPCSVScanStateCount + state];
+		chunkRowStarts[i] = scanRowStarts[i * SPCSVScanStateCount + state];
+	}
+
+	// Parse and decode every chunk's complete rows
+	NSMutableArray *chunkRows = [NSMutableArray arrayWithCapacity:chunkCount];
+	NSMutableArray *chunkRowInfo = [NSMutableArray arrayWithCapacity:chunkCount];
+
+	for (size_t i = 0; i < chunkCount; i++)
+	{
+		[chunkRows addObject:[NSMutableArray array]];
+		[chunkRowInfo addObject:[NSMutableData data]];
+	}
+
+	NSUInteger rowCapacity = (fieldCount == NSNotFound) ? 0 : (NSUInteger)fieldCount;
+
+	dispatch_apply(chunkCount, parsingQueue, ^(size_t chunk) {
+		size_t rowStart = chunkRowStarts[chunk];
+
+		chunkRowEnds[chunk] = SIZE_MAX;
+
+		if (rowStart == SIZE_MAX || rowStart >= chunkOffsets[chunk + 1]) return;
+
+		SPCSVTokenizer *chunkTokenizer = SPCSVTokenizerCreateCopy(scannedTokenizer);
+
+		if (!chunkTokenizer) return;
+
+		// The chunk is parsed where it is, as the input doesn't change while the chunks are parsed
+		if (SPCSVTokenizerAppendNoCopy(chunkTokenizer, untrimmedBytes + rowStart, chunkOffsets[chunk + 1] - rowStart)) {
+			NSMutableArray *rows = [chunkRows objectAtIndex:chunk];
+			NSMutableData *rowInfo = [chunkRowInfo objectAtIndex:chunk];
+			SPCSVRow row;
+
+			@autoreleasepool {
+				while (SPCSVTokenizerNextRow(chunkTokenizer, false, false, &row))
+				{
+					SPCSVQueuedRowInfo info = { 0, NO };
+
+					[rows addObject:SPCSVRowArray(&row, rowCapacity, &info.decodingFailed)];
+
+					// Offsets for now, made into parsed lengths once the rows are joined up
+					info.lengthParsed = rowStart + SPCSVTokenizerParserPosition(chunkTokenizer);
+					[rowInfo appendBytes:&info length:sizeof(info)];
+				}
+			}
+
+			if ([rows count]) chunkRowEnds[chunk] = ((const SPCSVQueuedRowInfo *)[rowInfo bytes])[[rows count] - 1].lengthParsed;
+		}
+
+		SPCSVTokenizerFree(chunkTokenizer);
+	});
+
+	// Join the chunks' rows up in order
+	NSUInteger lengthParsedAtStart = (NSUInteger)SPCSVTokenizerTotalLengthParsed(tokenizer);
+	NSMutableArray *rows = [NSMutableArray array];
+	NSMutableData *rowInfo = [NSMutableData data];
+	size_t position = parseStart;
+
+	for (size_t i = 0; i < chunkCount; i++)
+	{
+		if (chunkRowEnds[i] == SIZE_MAX) continue;
+
+		// Parse up to the chunk's start here, stopping if there isn't a complete row to parse
+		SPCSVRow row;
+		BOOL rowsRunOut = NO;
+
+		while (position < chunkRowStarts[i])
+		{
+			if (!SPCSVTokenizerNextRow(tokenizer, false, false, &row)) {
+				rowsRunOut = YES;
+				break;
+			}
+
+			SPCSVQueuedRowInfo info = { 0, NO };
+
+			[rows addObject:SPCSVRowArray(&row, rowCapacity, &info.decodingFailed)];
+
+			position = SPCSVTokenizerParserPosition(tokenizer);
+			info.lengthParsed = lengthParsedAtStart + (position - parseStart);
+			[rowInfo appendBytes:&info length:sizeof(info)];
+		}
+
+		if (rowsRunOut) break;
+
+		// Skip the chunk if the rows before it ran on past where it was taken to start
+		if (position != chunkRowStarts[i]) continue;
+
+		NSArray *chunkRowArrays = [chunkRows objectAtIndex:i];
+		SPCSVQueuedRowInfo *chunkInfo = (SPCSVQueuedRowInfo *)[[chunkRowInfo objectAtIndex:i] mutableBytes];
+
+		for (NSUInteger j = 0; j < [chunkRowArrays count]; j++)
+		{
+			chunkInfo[j].lengthParsed = lengthParsedAtStart + (chunkInfo[j].lengthParsed - parseStart);
+		}
+
+		[rows addObjectsFromArray:chunkRowArrays];
+		[rowInfo appendData:[chunkRowInfo objectAtIndex:i]];
+
+		position = chunkRowEnds[i];
+		SPCSVTokenizerAdvance(tokenizer, position, false);
+	}
+
+	SPCSVTokenizerAdvance(tokenizer, position, true);
+
+	free(chunkOffsets);
+	free(scanRowStarts);
+	free(scanEndStates);
+	free(chunkRowStarts);
+	free(chunkRowEnds);
+
+	if (![rows count]) return;
 
-	// With the default field and line separators, it's possible to skip
-	// a few characters - reset the character set that can be skipped
-	skipCharacterSet = nil;
-	[self _updateSkipCharacterSet];
+	queuedRows = rows;
+	queuedRowInfo = rowInfo;
+	queuedRowIndex = 0;
 }
 
 /**
- * Update the string state, enacting trims lazily to trade-off memory usage and the
- * speed hit with constant string updates and NSScanner resets.
+ * Discards any rows parsed ahead but not yet returned.
  */
-- (void) _updateState
+- (void)_clearQueuedRows
 {
+	queuedRows = nil;
+	queuedRowInfo = nil;
+	queuedRowIndex = 0;
+}
 
-	// If the trim position is still before the trim enact point, do nothing.
-	if (trimPosition < SPCSVPARSER_TRIM_ENACT_LENGTH) return;
+#pragma mark -
+#pragma mark Init and internal update methods
 
-	// Trim the string
-	[csvString deleteCharactersInRange:NSMakeRange(0, trimPosition)];
+/**
+ * Set up the tokenizer for CSV parsing, together with class defaults.
+ */
+- (void) _initialiseCSVParserDefaults
+{
+	fieldCount = NSNotFound;
+	decodingFailed = NO;
+	parsingThreads = 1;
+	queuedRows = nil;
+	queuedRowInfo = nil;
+	queuedRowIndex = 0;
+	queuedLengthParsed = 0;
+	appendedChunks = [[NSMutableArray alloc] init];
+	appendedChunkEnds = [[NSMutableArray alloc] init];
+
+	// The tokenizer starts with the same default field and line separators, together
+	// with quote and escape strings
+	tokenizer = SPCSVTokenizerCreate();
+	if (!tokenizer) {
+		[NSException raise:NSMallocException format:@"Unable to create a CSV tokenizer"];
+	}
 
-	// Update the parse position and stored string length
-	parserPosition -= trimPosition;
-	csvStringLength -= trimPosition;
+	fieldEndString = @",";
+	lineEndString = @"\n";
+	fieldQuoteString = @"\"";
+	escapeString = @"\\";
+	useStrictEscapeMatching = NO;
 
-	// Reset the trim position
-	trimPosition = 0;
+	// Set up the default null replacement character string as nil
+	nullReplacementString = nil;
 }
 
 /**
@@ -565,58 +699,6 @@
 	return [NSString stringWithString:conversionString];
 }
 
-/**
- * Reset the character set that can be skipped when processing the CSV.
- * This is called whenever the delimiters, quotes and escapes are updated.
- */
-- (void) _updateSkipCharacterSet
-{
-	NSMutableString *charactersToSkip;
-
-	
-
-	charactersToSkip = [[NSMutableString alloc] init];
-	if (![fieldEndString isEqualToString:@" "] && ![fieldQuoteString isEqualToString:@" "] && ![escapeString isEqualToString:@" "] && ![lineEndString isEqualToString:@" "])
-		[charactersToSkip appendString:@" "];
-	if (![fieldEndString isEqualToString:@"\t"] && ![fieldQuoteString isEqualToString:@"\t"] && ![escapeString isEqualToString:@"\t"] && ![lineEndString isEqualToString:@"\t"])
-		[charactersToSkip appendString:@"\t"];
-
-	if ([charactersToSkip length])
-		skipCharacterSet = [NSCharacterSet characterSetWithCharactersInString:charactersToSkip];
-}
-
-/**
- * Get the distance to the next occurence of the specified string, from the current
- * parser location. Returns NSNotFound if the string could not be found before the end
- * of the string.
- */
-- (NSUInteger) _getDistanceToString:(NSString *)theString
-{
-	NSRange stringRange = [csvString rangeOfString:theString options:NSLiteralSearch range:NSMakeRange(parserPosition, csvStringLength - parserPosition)];
-
-	if (stringRange.location == NSNotFound) return NSNotFound;
-
-	return stringRange.location - parserPosition;
-}
-
-/**
- * Move the parser past any skippable characters - this should be called to effectively trim
- * whitespace from the starts and ends of cells, unless that whitespace is quoted.  By
- * maintaining a list of skippable characters, any whitespace used in quote/line end/field
- * end chars is preserved safely.
- */ 
-- (void) _moveParserPastSkippableCharacters
-{
-	if (!skipCharacterSet) return;
-
-	NSInteger i = 0;
-	while (parserPosition + i < csvStringLength) {
-		if (![skipCharacterSet characterIsMember:[csvString characterAtIndex:parserPosition+i]]) break;
-		i++;
-	}
-	if (i) parserPosition += i;
-}
-
 /**
  * Required and primitive methods to allow subclassing class cluster
  */
@@ -624,7 +706,6 @@
 
 - (instancetype)init {
 	if (self = [super init]) {
-		csvString = [[NSMutableString alloc] init];
 		[self _initialiseCSVParserDefaults];
 	}
 	return self;
@@ -632,18 +713,24 @@
 
 - (instancetype)initWithString:(NSString *)aString {
 	if (self = [super init]) {
-		csvString = [[NSMutableString alloc] initWithString:aString];
 		[self _initialiseCSVParserDefaults];
+		[self appendString:aString];
 	}
 	return self;
 }
 
 - (instancetype)initWithContentsOfFile:(NSString *)path encoding:(NSStringEncoding)encoding error:(NSError **)error {
 	if (self = [super init]) {
-		csvString = [[NSMutableString alloc] initWithContentsOfFile:path encoding:encoding error:error];
+		NSString *fileString = [[NSString alloc] initWithContentsOfFile:path encoding:encoding error:error];
+
 		[self _initialiseCSVParserDefaults];
+		if (fileString) [self appendString:fileString];
 	}
 	return self;
 }
 
+- (void)dealloc {
+	SPCSVTokenizerFree(tokenizer);
+}
+
 @end
@@ -0,0 +1,935 @@
+//
+//  SPCSVTokenizer.c
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#include "SPCSVTokenizer.h"
+#include "SPInputBuffer.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#define SPCSVNotFound SIZE_MAX
+#define SPCSVTokenizerMinimumCapacity (64 * 1024)
+
+// Consumed input is only discarded once this much has built up, as SPCSVParser did
+#define SPCSVTokenizerCompactionLength (256 * 1024)
+
+typedef struct {
+	uint8_t *bytes;
+	size_t length;
+} SPCSVString;
+
+/**
+ * A field while its row is being parsed: either a span of the input, or of the scratch buffer once
+ * it has had to be assembled or unescaped. Offsets are used as either buffer may move.
+ */
+typedef struct {
+	size_t offset;
+	size_t length;
+	bool inScratch;
+	bool quoted;
+	bool isNull;
+} SPCSVFieldSpan;
+
+struct SPCSVTokenizer {
+	SPInputBuffer input;
+	size_t trimPosition;
+	size_t parserPosition;
+	uint64_t totalLengthParsed;
+
+	SPCSVString fieldEnd;
+	SPCSVString lineEnd;
+	SPCSVString fieldQuote;
+	SPCSVString escape;
+	SPCSVString nullReplacement;
+	bool hasNullReplacement;
+	bool escapeIsFieldQuote;
+	bool strictEscapeMatching;
+	bool skipSpaces;
+	bool skipTabs;
+
+	uint8_t *scratch;
+	size_t scratchLength;
+	size_t scratchCapacity;
+
+	SPCSVFieldSpan *spans;
+	SPCSVField *fields;
+	size_t fieldCount;
+	size_t fieldCapacity;
+
+	// The field being parsed
+	SPCSVFieldSpan cell;
+	bool cellHasContent;
+};
+
+static bool SPCSVStringSet(SPCSVString *string, const void *bytes, size_t length)
+{
+	uint8_t *copy = NULL;
+
+	if (length) {
+		if (!(copy = malloc(length))) return false;
+
+		memcpy(copy, bytes, length);
+	}
+
+	free(string->bytes);
+
+	string->bytes = copy;
+	string->length = length;
+
+	return true;
+}
+
+static inline bool SPCSVStringEquals(const SPCSVString *string, const char *literal)
+{
+	size_t literalLength = strlen(literal);
+
+	return string->length == literalLength && !memcmp(string->bytes, literal, literalLength);
+}
+
+static inline bool SPCSVMatches(const SPCSVTokenizer *tokenizer, size_t position, const SPCSVString *string)
+{
+	return string->length && position + string->length <= tokenizer->input.length && !memcmp(tokenizer->input.bytes + position, string->bytes, string->length);
+}
+
+/**
+ * Works out which whitespace can be skipped around fields: spaces and tabs, unless they are part of
+ * the terminators, quote or escape.
+ */
+static void SPCSVTokenizerUpdateSkippedCharacters(SPCSVTokenizer *tokenizer)
+{
+	tokenizer->escapeIsFieldQuote = tokenizer->escape.length == tokenizer->fieldQuote.length && (!tokenizer->escape.length || !memcmp(tokenizer->escape.bytes, tokenizer->fieldQuote.bytes, tokenizer->escape.length));
+
+	tokenizer->skipSpaces = !SPCSVStringEquals(&tokenizer->fieldEnd, " ") && !SPCSVStringEquals(&tokenizer->fieldQuote, " ") && !SPCSVStringEquals(&tokenizer->escape, " ") && !SPCSVStringEquals(&tokenizer->lineEnd, " ");
+	tokenizer->skipTabs = !SPCSVStringEquals(&tokenizer->fieldEnd, "\t") && !SPCSVStringEquals(&tokenizer->fieldQuote, "\t") && !SPCSVStringEquals(&tokenizer->escape, "\t") && !SPCSVStringEquals(&tokenizer->lineEnd, "\t");
+}
+
+/**
+ * Returns the offset of the first byte at or after position which is either a or b, or the length if
+ * there is none. Sixteen bytes are compared at a time where SSE2 or NEON is available.
+ */
+static size_t SPCSVNextByteOfPair(const uint8_t *bytes, size_t position, size_t length, uint8_t a, uint8_t b)
+{
+	size_t i = position;
+
+#if defined(__SSE2__)
+	__m128i first = _mm_set1_epi8((char)a);
+	__m128i second = _mm_set1_epi8((char)b);
+
+	for (; i + 16 <= length; i += 16)
+	{
+		__m128i block = _mm_loadu_si128((const __m128i *)(bytes + i));
+		int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, first), _mm_cmpeq_epi8(block, second)));
+
+		if (mask) return i + (size_t)__builtin_ctz((unsigned int)mask);
+	}
+#elif defined(__ARM_NEON)
+	uint8x16_t first = vdupq_n_u8(a);
+	uint8x16_t second = vdupq_n_u8(b);
+
+	for (; i + 16 <= length; i += 16)
+	{
+		uint8x16_t block = vld1q_u8(bytes + i);
+		uint8x16_t matches = vorrq_u8(vceqq_u8(block, first), vceqq_u8(block, second));
+
+		// Narrow each byte's comparison result to four bits, so the first match is the lowest set nibble
+		uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(matches), 4)), 0);
+
+		if (mask) return i + (size_t)(__builtin_ctzll(mask) >> 2);
+	}
+#endif
+
+	for (; i < length; i++)
+	{
+		if (bytes[i] == a || bytes[i] == b) return i;
+	}
+
+	return length;
+}
+
+/**
+ * Returns the offset of the first byte at or after position which is a, b or c, or the length if
+ * there is none.
+ */
+static size_t SPCSVNextByteOfThree(const uint8_t *bytes, size_t position, size_t length, uint8_t a, uint8_t b, uint8_t c)
+{
+	size_t i = position;
+
+	if (c == a || c == b) return SPCSVNextByteOfPair(bytes, position, length, a, b);
+
+#if defined(__SSE2__)
+	__m128i first = _mm_set1_epi8((char)a);
+	__m128i second = _mm_set1_epi8((char)b);
+	__m128i third = _mm_set1_epi8((char)c);
+
+	for (; i + 16 <= length; i += 16)
+	{
+		__m128i block = _mm_loadu_si128((const __m128i *)(bytes + i));
+		int mask = _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, first), _mm_cmpeq_epi8(block, second)), _mm_cmpeq_epi8(block, third)));
+
+		if (mask) return i + (size_t)__builtin_ctz((unsigned int)mask);
+	}
+#elif defined(__ARM_NEON)
+	uint8x16_t first = vdupq_n_u8(a);
+	uint8x16_t second = vdupq_n_u8(b);
+	uint8x16_t third = vdupq_n_u8(c);
+
+	for (; i + 16 <= length; i += 16)
+	{
+		uint8x16_t block = vld1q_u8(bytes + i);
+		uint8x16_t matches = vorrq_u8(vorrq_u8(vceqq_u8(block, first), vceqq_u8(block, second)), vceqq_u8(block, third));
+		uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(matches), 4)), 0);
+
+		if (mask) return i + (size_t)(__builtin_ctzll(mask) >> 2);
+	}
+#endif
+
+	for (; i < length; i++)
+	{
+		if (bytes[i] == a || bytes[i] == b || bytes[i] == c) return i;
+	}
+
+	return length;
+}
+
+/**
+ * Returns the offset of the next occurrence of the string at or after position, or SPCSVNotFound.
+ */
+static size_t SPCSVFind(const SPCSVTokenizer *tokenizer, size_t position, const SPCSVString *string)
+{
+	if (!string->length) return SPCSVNotFound;
+
+	const uint8_t *bytes = tokenizer->input.bytes;
+	const uint8_t *match = bytes + position;
+	const uint8_t *end = bytes + tokenizer->input.length;
+
+	while ((match = memchr(match, string->bytes[0], (size_t)(end - match))))
+	{
+		if ((size_t)(end - match) < string->length) return SPCSVNotFound;
+		if (!memcmp(match, string->bytes, string->length)) return (size_t)(match - bytes);
+
+		match++;
+	}
+
+	return SPCSVNotFound;
+}
+
+/**
+ * Returns the offset of whichever of the field and line terminators comes first at or after position,
+ * or SPCSVNotFound. A field terminator wins if both start at the same offset.
+ */
+static size_t SPCSVFindTerminator(const SPCSVTokenizer *tokenizer, size_t position, bool *isLineEnd)
+{
+	const SPCSVString *fieldEnd = &tokenizer->fieldEnd;
+	const SPCSVString *lineEnd = &tokenizer->lineEnd;
+
+	if (!fieldEnd->length && !lineEnd->length) return SPCSVNotFound;
+
+	uint8_t a = fieldEnd->length ? fieldEnd->bytes[0] : lineEnd->bytes[0];
+	uint8_t b = lineEnd->length ? lineEnd->bytes[0] : fieldEnd->bytes[0];
+	size_t i = position;
+
+	while ((i = SPCSVNextByteOfPair(tokenizer->input.bytes, i, tokenizer->input.length, a, b)) < tokenizer->input.length)
+	{
+		if (SPCSVMatches(tokenizer, i, fieldEnd)) {
+			*isLineEnd = false;
+			return i;
+		}
+		if (SPCSVMatches(tokenizer, i, lineEnd)) {
+			*isLineEnd = true;
+			return i;
+		}
+
+		i++;
+	}
+
+	return SPCSVNotFound;
+}
+
+/**
+ * Returns whether the terminator or quote at offset is escaped, by an odd number of escapes directly
+ * before it and after the segment start.
+ */
+static bool SPCSVIsEscaped(const SPCSVTokenizer *tokenizer, size_t segmentStart, size_t offset)
+{
+	const SPCSVString *escape = &tokenizer->escape;
+	bool isEscaped = false;
+
+	for (size_t j = 1; j * escape->length <= offset - segmentStart && !memcmp(tokenizer->input.bytes + offset - j * escape->length, escape->bytes, escape->length); j++)
+	{
+		isEscaped = !isEscaped;
+	}
+
+	return isEscaped;
+}
+
+static bool SPCSVReserve(uint8_t **buffer, size_t *capacity, size_t required)
+{
+	if (required <= *capacity) return true;
+
+	size_t newCapacity = *capacity ? *capacity : SPCSVTokenizerMinimumCapacity;
+
+	while (newCapacity < required) newCapacity *= 2;
+
+	uint8_t *newBuffer = realloc(*buffer, newCapacity);
+
+	if (!newBuffer) return false;
+
+	*buffer = newBuffer;
+	*capacity = newCapacity;
+
+	return true;
+}
+
+/**
+ * Moves the field being parsed into the scratch buffer, so that more can be added to it or it can be
+ * unescaped in place.
+ */
+static bool SPCSVCellMoveToScratch(SPCSVTokenizer *tokenizer)
+{
+	SPCSVFieldSpan *cell = &tokenizer->cell;
+
+	if (cell->inScratch) return true;
+
+	if (!SPCSVReserve(&tokenizer->scratch, &tokenizer->scratchCapacity, tokenizer->scratchLength + cell->length)) return false;
+
+	memcpy(tokenizer->scratch + tokenizer->scratchLength, tokenizer->input.bytes + cell->offset, cell->length);
+
+	cell->offset = tokenizer->scratchLength;
+	cell->inScratch = true;
+	tokenizer->scratchLength += cell->length;
+
+	return true;
+}
+
+static bool SPCSVCellAppendBytes(SPCSVTokenizer *tokenizer, const uint8_t *bytes, size_t length)
+{
+	if (!SPCSVCellMoveToScratch(tokenizer)) return false;
+	if (!SPCSVReserve(&tokenizer->scratch, &tokenizer->scratchCapacity, tokenizer->scratchLength + length)) return false;
+
+	memcpy(tokenizer->scratch + tokenizer->scratchLength, bytes, length);
+
+	tokenizer->scratchLength += length;
+	tokenizer->cell.length += length;
+	tokenizer->cellHasContent = true;
+
+	return true;
+}
+
+/**
+ * Adds a span of the input to the field being parsed, which stays a span of the input if it is the first.
+ */
+static bool SPCSVCellAppendInput(SPCSVTokenizer *tokenizer, size_t offset, size_t length)
+{
+	if (!tokenizer->cellHasContent) {
+		tokenizer->cell.offset = offset;
+		tokenizer->cell.length = length;
+		tokenizer->cell.inScratch = false;
+		tokenizer->cellHasContent = true;
+
+		return true;
+	}
+
+	// The input may move while the scratch buffer grows
+	if (!SPCSVCellMoveToScratch(tokenizer)) return false;
+	if (!SPCSVReserve(&tokenizer->scratch, &tokenizer->scratchCapacity, tokenizer->scratchLength + length)) return false;
+
+	memcpy(tokenizer->scratch + tokenizer->scratchLength, tokenizer->input.bytes + offset, length);
+
+	tokenizer->scratchLength += length;
+	tokenizer->cell.length += length;
+
+	return true;
+}
+
+static inline const uint8_t *SPCSVSpanBytes(const SPCSVTokenizer *tokenizer, const SPCSVFieldSpan *span)
+{
+	return (span->inScratch ? tokenizer->scratch : tokenizer->input.bytes) + span->offset;
+}
+
+/**
+ * Replaces each occurrence of the escape followed by the target with the target alone, working
+ * along the bytes without overlaps as -replaceOccurrencesOfString: does. Returns the new length.
+ */
+static size_t SPCSVUnescape(uint8_t *bytes, size_t length, const SPCSVString *escape, const SPCSVString *target)
+{
+	size_t sequenceLength = escape->length + target->length;
+	size_t read = 0;
+	size_t write = 0;
+
+	while (read < length)
+	{
+		if (read + sequenceLength <= length && !memcmp(bytes + read, escape->bytes, escape->length) && !memcmp(bytes + read + escape->length, target->bytes, target->length)) {
+			memmove(bytes + write, target->bytes, target->length);
+			write += target->length;
+			read += sequenceLength;
+		}
+		else {
+			bytes[write++] = bytes[read++];
+		}
+	}
+
+	return write;
+}
+
+/**
+ * Completes the field being parsed, checking it against the NULL markers and removing escapes, and
+ * adds it to the row.
+ */
+static bool SPCSVFinishCell(SPCSVTokenizer *tokenizer, bool fieldIsQuoted)
+{
+	SPCSVFieldSpan *cell = &tokenizer->cell;
+	const uint8_t *bytes = SPCSVSpanBytes(tokenizer, cell);
+
+	cell->quoted = fieldIsQuoted;
+	cell->isNull = (cell->length == 2 && bytes[0] == '\\' && bytes[1] == 'N')
+		|| (!fieldIsQuoted && tokenizer->hasNullReplacement && cell->length == tokenizer->nullReplacement.length && !memcmp(bytes, tokenizer->nullReplacement.bytes, cell->length));
+
+	// Every escape sequence starts with the escape, so fields without it can be left alone
+	const SPCSVString *escape = &tokenizer->escape;
+
+	if (!cell->isNull && escape->length && memchr(bytes, escape->bytes[0], cell->length)) {
+		if (!SPCSVCellMoveToScratch(tokenizer)) return false;
+
+		uint8_t *cellBytes = tokenizer->scratch + cell->offset;
+		size_t cellLength = cell->length;
+
+		if (fieldIsQuoted && tokenizer->fieldEnd.length) cellLength = SPCSVUnescape(cellBytes, cellLength, escape, &tokenizer->fieldEnd);
+		if (!fieldIsQuoted && tokenizer->fieldQuote.length) cellLength = SPCSVUnescape(cellBytes, cellLength, escape, &tokenizer->fieldQuote);
+		if (fieldIsQuoted && tokenizer->lineEnd.length) cellLength = SPCSVUnescape(cellBytes, cellLength, escape, &tokenizer->lineEnd);
+		if (!tokenizer->escapeIsFieldQuote) cellLength = SPCSVUnescape(cellBytes, cellLength, escape, escape);
+
+		// The cell is last in the scratch buffer, so the space it no longer needs can be reused
+		tokenizer->scratchLength -= cell->length - cellLength;
+		cell->length = cellLength;
+	}
+
+	if (tokenizer->fieldCount == tokenizer->fieldCapacity) {
+		size_t newCapacity = tokenizer->fieldCapacity ? tokenizer->fieldCapacity * 2 : 32;
+		SPCSVFieldSpan *newSpans = realloc(tokenizer->spans, newCapacity * sizeof(SPCSVFieldSpan));
+
+		if (!newSpans) return false;
+
+		tokenizer->spans = newSpans;
+
+		SPCSVField *newFields = realloc(tokenizer->fields, newCapacity * sizeof(SPCSVField));
+
+		if (!newFields) return false;
+
+		tokenizer->fields = newFields;
+		tokenizer->fieldCapacity = newCapacity;
+	}
+
+	tokenizer->spans[tokenizer->fieldCount++] = *cell;
+
+	return true;
+}
+
+static inline void SPCSVSkipWhitespace(SPCSVTokenizer *tokenizer)
+{
+	if (!tokenizer->skipSpaces && !tokenizer->skipTabs) return;
+
+	while (tokenizer->parserPosition < tokenizer->input.length)
+	{
+		uint8_t byte = tokenizer->input.bytes[tokenizer->parserPosition];
+
+		if (!((byte == ' ' && tokenizer->skipSpaces) || (byte == '\t' && tokenizer->skipTabs))) break;
+
+		tokenizer->parserPosition++;
+	}
+}
+
+/**
+ * Discards the trimmed input once enough has built up, or whenever it costs nothing or is forced.
+ */
+static void SPCSVTokenizerCompact(SPCSVTokenizer *tokenizer, bool force)
+{
+	if (!tokenizer->trimPosition) return;
+	if (!force && !SPInputBufferIsBorrowed(&tokenizer->input) && tokenizer->trimPosition < SPCSVTokenizerCompactionLength) return;
+
+	SPInputBufferDiscard(&tokenizer->input, tokenizer->trimPosition);
+
+	tokenizer->parserPosition -= tokenizer->trimPosition;
+	tokenizer->trimPosition = 0;
+}
+
+/**
+ * Parses one row from the parser position, leaving the position after it. Returns false if the row
+ * is incomplete, in which case the position is unchanged, or if memory ran out.
+ */
+static bool SPCSVParseRow(SPCSVTokenizer *tokenizer, bool inputComplete, bool *lineEndingEncountered)
+{
+	const SPCSVString *fieldQuote = &tokenizer->fieldQuote;
+	const SPCSVString *escape = &tokenizer->escape;
+	size_t startingPosition = tokenizer->parserPosition;
+
+	tokenizer->fieldCount = 0;
+	tokenizer->scratchLength = 0;
+	*lineEndingEncountered = false;
+
+	while (tokenizer->parserPosition < tokenizer->input.length && !*lineEndingEncountered)
+	{
+		bool fieldIsQuoted = false;
+
+		memset(&tokenizer->cell, 0, sizeof(tokenizer->cell));
+		tokenizer->cellHasContent = false;
+
+		// Skip unescaped, unquoted whitespace where possible
+		SPCSVSkipWhitespace(tokenizer);
+
+		// A field starting with the quote runs until an unescaped closing quote
+		if (SPCSVMatches(tokenizer, tokenizer->parserPosition, fieldQuote)) {
+			tokenizer->parserPosition += fieldQuote->length;
+			fieldIsQuoted = true;
+
+			while (tokenizer->parserPosition < tokenizer->input.length)
+			{
+				size_t position = tokenizer->parserPosition;
+				size_t quote = SPCSVFind(tokenizer, position, fieldQuote);
+
+				// Check to see if the quote encountered was escaped... or an escaper
+				if (escape->length && quote != SPCSVNotFound) {
+					bool isEscaped = false;
+					bool nonStrictEscapeMatchingFallback = false;
+					size_t skipLength = fieldQuote->length;
+
+					if (!tokenizer->escapeIsFieldQuote) {
+						isEscaped = SPCSVIsEscaped(tokenizer, position, quote);
+
+						if (!tokenizer->strictEscapeMatching && !isEscaped) nonStrictEscapeMatchingFallback = true;
+					}
+
+					// Doubled (Excel-style) quotes, if the escape is the quote or escaping isn't strict
+					if ((tokenizer->escapeIsFieldQuote || nonStrictEscapeMatchingFallback) && SPCSVMatches(tokenizer, quote + fieldQuote->length, fieldQuote)) {
+						isEscaped = true;
+						skipLength = 2 * fieldQuote->length;
+					}
+
+					if (isEscaped) {
+
+						// Keep a doubled quote's first quote, for the unescaping to leave alone; otherwise
+						// drop the escape now in favour of the quote
+						if (tokenizer->escapeIsFieldQuote || nonStrictEscapeMatchingFallback) {
+							if (!SPCSVCellAppendInput(tokenizer, position, quote - position + fieldQuote->length)) return false;
+						}
+						else {
+							if (!SPCSVCellAppendInput(tokenizer, position, quote - position - escape->length)) return false;
+							if (!SPCSVCellAppendBytes(tokenizer, fieldQuote->bytes, fieldQuote->length)) return false;
+						}
+
+						tokenizer->parserPosition = quote + skipLength;
+						continue;
+					}
+				}
+
+				if (quote != SPCSVNotFound) {
+					if (!SPCSVCellAppendInput(tokenizer, position, quote - position)) return false;
+
+					tokenizer->parserPosition = quote + fieldQuote->length;
+				}
+				else {
+					if (!SPCSVCellAppendInput(tokenizer, position, tokenizer->input.length - position)) return false;
+
+					tokenizer->parserPosition = tokenizer->input.length;
+				}
+
+				// Continue on past the quote, removing whitespace
+				SPCSVSkipWhitespace(tokenizer);
+
+				break;
+			}
+		}
+
+		// Run on to the next field or line terminator, whichever is first; this also handles unquoted fields
+		while (tokenizer->parserPosition < tokenizer->input.length)
+		{
+			size_t position = tokenizer->parserPosition;
+			bool isLineEnd = false;
+			size_t terminator = SPCSVFindTerminator(tokenizer, position, &isLineEnd);
+
+			if (terminator == SPCSVNotFound) {
+				if (!SPCSVCellAppendInput(tokenizer, position, tokenizer->input.length - position)) return false;
+
+				tokenizer->parserPosition = tokenizer->input.length;
+				break;
+			}
+
+			const SPCSVString *terminatorString = isLineEnd ? &tokenizer->lineEnd : &tokenizer->fieldEnd;
+
+			// An escaped terminator is part of the field
+			if (escape->length && SPCSVIsEscaped(tokenizer, position, terminator)) {
+				if (!SPCSVCellAppendInput(tokenizer, position, terminator - position - escape->length)) return false;
+				if (!SPCSVCellAppendBytes(tokenizer, terminatorString->bytes, terminatorString->length)) return false;
+
+				tokenizer->parserPosition = terminator + terminatorString->length;
+				continue;
+			}
+
+			if (!SPCSVCellAppendInput(tokenizer, position, terminator - position)) return false;
+
+			tokenizer->parserPosition = terminator + terminatorString->length;
+			*lineEndingEncountered = isLineEnd;
+			break;
+		}
+
+		if (!SPCSVFinishCell(tokenizer, fieldIsQuoted)) return false;
+	}
+
+	// Don't return a row which may continue in input still to come
+	if (!*lineEndingEncountered && !inputComplete) {
+		tokenizer->parserPosition = startingPosition;
+		return false;
+	}
+
+	tokenizer->totalLengthParsed += tokenizer->parserPosition - startingPosition;
+
+	return true;
+}
+
+SPCSVTokenizer *SPCSVTokenizerCreate(void)
+{
+	SPCSVTokenizer *tokenizer = calloc(1, sizeof(SPCSVTokenizer));
+
+	if (!tokenizer) return NULL;
+
+	if (!SPCSVStringSet(&tokenizer->fieldEnd, ",", 1) || !SPCSVStringSet(&tokenizer->lineEnd, "\n", 1) || !SPCSVStringSet(&tokenizer->fieldQuote, "\"", 1) || !SPCSVStringSet(&tokenizer->escape, "\\", 1)) {
+		SPCSVTokenizerFree(tokenizer);
+		return NULL;
+	}
+
+	SPCSVTokenizerUpdateSkippedCharacters(tokenizer);
+
+	return tokenizer;
+}
+
+SPCSVTokenizer *SPCSVTokenizerCreateCopy(const SPCSVTokenizer *tokenizer)
+{
+	SPCSVTokenizer *copy = calloc(1, sizeof(SPCSVTokenizer));
+
+	if (!copy) return NULL;
+
+	if (!SPCSVStringSet(&copy->fieldEnd, tokenizer->fieldEnd.bytes, tokenizer->fieldEnd.length)
+		|| !SPCSVStringSet(&copy->lineEnd, tokenizer->lineEnd.bytes, tokenizer->lineEnd.length)
+		|| !SPCSVStringSet(&copy->fieldQuote, tokenizer->fieldQuote.bytes, tokenizer->fieldQuote.length)
+		|| !SPCSVStringSet(&copy->escape, tokenizer->escape.bytes, tokenizer->escape.length)
+		|| !SPCSVStringSet(&copy->nullReplacement, tokenizer->nullReplacement.bytes, tokenizer->nullReplacement.length)) {
+		SPCSVTokenizerFree(copy);
+		return NULL;
+	}
+
+	copy->hasNullReplacement = tokenizer->hasNullReplacement;
+	copy->strictEscapeMatching = tokenizer->strictEscapeMatching;
+
+	SPCSVTokenizerUpdateSkippedCharacters(copy);
+
+	return copy;
+}
+
+void SPCSVTokenizerFree(SPCSVTokenizer *tokenizer)
+{
+	if (!tokenizer) return;
+
+	SPInputBufferFree(&tokenizer->input);
+	free(tokenizer->fieldEnd.bytes);
+	free(tokenizer->lineEnd.bytes);
+	free(tokenizer->fieldQuote.bytes);
+	free(tokenizer->escape.bytes);
+	free(tokenizer->nullReplacement.bytes);
+	free(tokenizer->scratch);
+	free(tokenizer->spans);
+	free(tokenizer->fields);
+	free(tokenizer);
+}
+
+bool SPCSVTokenizerSetFieldTerminator(SPCSVTokenizer *tokenizer, const void *bytes, size_t length)
+{
+	if (!SPCSVStringSet(&tokenizer->fieldEnd, bytes, length)) return false;
+
+	SPCSVTokenizerUpdateSkippedCharacters(tokenizer);
+
+	return true;
+}
+
+bool SPCSVTokenizerSetLineTerminator(SPCSVTokenizer *tokenizer, const void *bytes, size_t length)
+{
+	if (!SPCSVStringSet(&tokenizer->lineEnd, bytes, length)) return false;
+
+	SPCSVTokenizerUpdateSkippedCharacters(tokenizer);
+
+	return true;
+}
+
+bool SPCSVTokenizerSetFieldQuote(SPCSVTokenizer *tokenizer, const void *bytes, size_t length)
+{
+	if (!SPCSVStringSet(&tokenizer->fieldQuote, bytes, length)) return false;
+
+	SPCSVTokenizerUpdateSkippedCharacters(tokenizer);
+
+	return true;
+}
+
+bool SPCSVTokenizerSetEscape(SPCSVTokenizer *tokenizer, const void *bytes, size_t length)
+{
+	if (!SPCSVStringSet(&tokenizer->escape, bytes, length)) return false;
+
+	SPCSVTokenizerUpdateSkippedCharacters(tokenizer);
+
+	return true;
+}
+
+bool SPCSVTokenizerSetNullReplacement(SPCSVTokenizer *tokenizer, const void *bytes, size_t length)
+{
+	tokenizer->hasNullReplacement = (bytes != NULL);
+
+	return SPCSVStringSet(&tokenizer->nullReplacement, bytes, bytes ? length : 0);
+}
+
+void SPCSVTokenizerSetStrictEscapeMatching(SPCSVTokenizer *tokenizer, bool strict)
+{
+	tokenizer->strictEscapeMatching = strict;
+}
+
+bool SPCSVTokenizerAppend(SPCSVTokenizer *tokenizer, const void *bytes, size_t length)
+{
+	SPCSVTokenizerCompact(tokenizer, false);
+
+	return SPInputBufferAppend(&tokenizer->input, bytes, length);
+}
+
+bool SPCSVTokenizerAppendNoCopy(SPCSVTokenizer *tokenizer, const void *bytes, size_t length)
+{
+	SPCSVTokenizerCompact(tokenizer, true);
+
+	return SPInputBufferAppendNoCopy(&tokenizer->input, bytes, length);
+}
+
+void SPCSVTokenizerReset(SPCSVTokenizer *tokenizer)
+{
+	SPInputBufferReset(&tokenizer->input);
+	tokenizer->trimPosition = 0;
+	tokenizer->parserPosition = 0;
+	tokenizer->totalLengthParsed = 0;
+}
+
+void SPCSVTokenizerRewind(SPCSVTokenizer *tokenizer)
+{
+	tokenizer->parserPosition = tokenizer->trimPosition;
+	tokenizer->totalLengthParsed = 0;
+}
+
+bool SPCSVTokenizerNextRow(SPCSVTokenizer *tokenizer, bool inputComplete, bool trim, SPCSVRow *row)
+{
+	bool lineEndingEncountered;
+
+	SPCSVTokenizerCompact(tokenizer, false);
+
+	while (SPCSVParseRow(tokenizer, inputComplete, &lineEndingEncountered))
+	{
+		// Skip empty rows, and rows holding only an empty or NULL field
+		if (!tokenizer->fieldCount || (tokenizer->fieldCount == 1 && (tokenizer->spans[0].isNull || !tokenizer->spans[0].length))) {
+			if (tokenizer->parserPosition == tokenizer->input.length) return false;
+
+			continue;
+		}
+
+		if (trim) tokenizer->trimPosition = tokenizer->parserPosition;
+
+		for (size_t i = 0; i < tokenizer->fieldCount; i++)
+		{
+			const SPCSVFieldSpan *span = &tokenizer->spans[i];
+
+			tokenizer->fields[i] = (SPCSVField){ SPCSVSpanBytes(tokenizer, span), span->length, span->quoted, span->isNull };
+		}
+
+		row->fields = tokenizer->fields;
+		row->fieldCount = tokenizer->fieldCount;
+
+		return true;
+	}
+
+	return false;
+}
+
+const uint8_t *SPCSVTokenizerUntrimmedBytes(const SPCSVTokenizer *tokenizer, size_t *length)
+{
+	*length = tokenizer->input.length - tokenizer->trimPosition;
+
+	return tokenizer->input.bytes + tokenizer->trimPosition;
+}
+
+size_t SPCSVTokenizerParserPosition(const SPCSVTokenizer *tokenizer)
+{
+	return tokenizer->parserPosition - tokenizer->trimPosition;
+}
+
+uint64_t SPCSVTokenizerTrimmedLength(const SPCSVTokenizer *tokenizer)
+{
+	return tokenizer->input.discardedLength + tokenizer->trimPosition;
+}
+
+uint64_t SPCSVTokenizerTotalLengthParsed(const SPCSVTokenizer *tokenizer)
+{
+	return tokenizer->totalLengthParsed;
+}
+
+void SPCSVTokenizerAdvance(SPCSVTokenizer *tokenizer, size_t position, bool trim)
+{
+	size_t newPosition = tokenizer->trimPosition + position;
+
+	if (newPosition > tokenizer->input.length) newPosition = tokenizer->input.length;
+
+	if (newPosition > tokenizer->parserPosition) {
+		tokenizer->totalLengthParsed += newPosition - tokenizer->parserPosition;
+		tokenizer->parserPosition = newPosition;
+	}
+
+	if (trim) tokenizer->trimPosition = tokenizer->parserPosition;
+}
+
+/**
+ * Returns whether the input from start up to position holds only whitespace the parser skips.
+ */
+static bool SPCSVOnlySkippedWhitespace(const SPCSVTokenizer *tokenizer, size_t start, size_t position)
+{
+	for (size_t i = start; i < position; i++)
+	{
+		uint8_t byte = tokenizer->input.bytes[i];
+
+		if (!((byte == ' ' && tokenizer->skipSpaces) || (byte == '\t' && tokenizer->skipTabs))) return false;
+	}
+
+	return true;
+}
+
+/**
+ * Follows the same rules as SPCSVParseRow for where quoted fields open and close and which
+ * terminators are escaped, so a scan from a row start meets the row starts the parser would.
+ * From elsewhere it is a guess, which the caller checks against the rows parsed before.
+ */
+SPCSVScanState SPCSVTokenizerScan(const SPCSVTokenizer *tokenizer, size_t start, size_t end, SPCSVScanState state, size_t *firstRowStart)
+{
+	const SPCSVString *fieldEnd = &tokenizer->fieldEnd;
+	const SPCSVString *lineEnd = &tokenizer->lineEnd;
+	const SPCSVString *fieldQuote = &tokenizer->fieldQuote;
+	const SPCSVString *escape = &tokenizer->escape;
+	size_t position = tokenizer->trimPosition + start;
+	size_t stop = tokenizer->trimPosition + end;
+	size_t segmentStart = position;
+
+	*firstRowStart = SPCSVNotFound;
+
+	if (stop > tokenizer->input.length) stop = tokenizer->input.length;
+	if (!fieldEnd->length && !lineEnd->length) return state;
+	if (!fieldQuote->length && state == SPCSVScanQuoted) state = SPCSVScanUnquoted;
+
+	uint8_t a = fieldEnd->length ? fieldEnd->bytes[0] : lineEnd->bytes[0];
+	uint8_t b = lineEnd->length ? lineEnd->bytes[0] : fieldEnd->bytes[0];
+	uint8_t c = fieldQuote->length ? fieldQuote->bytes[0] : a;
+
+	while (position < stop)
+	{
+		// Inside a quoted field only an unescaped, undoubled closing quote matters
+		if (state == SPCSVScanQuoted) {
+			size_t quote = SPCSVFind(tokenizer, position, fieldQuote);
+
+			if (quote == SPCSVNotFound || quote >= stop) return SPCSVScanQuoted;
+
+			bool isEscaped = false;
+			size_t skipLength = fieldQuote->length;
+
+			if (escape->length) {
+				bool nonStrictEscapeMatchingFallback = false;
+
+				if (!tokenizer->escapeIsFieldQuote) {
+					isEscaped = SPCSVIsEscaped(tokenizer, segmentStart, quote);
+
+					if (!tokenizer->strictEscapeMatching && !isEscaped) nonStrictEscapeMatchingFallback = true;
+				}
+
+				if ((tokenizer->escapeIsFieldQuote || nonStrictEscapeMatchingFallback) && SPCSVMatches(tokenizer, quote + fieldQuote->length, fieldQuote)) {
+					isEscaped = true;
+					skipLength = 2 * fieldQuote->length;
+				}
+			}
+
+			position = quote + skipLength;
+			segmentStart = position;
+
+			if (!isEscaped) state = SPCSVScanUnquoted;
+
+			continue;
+		}
+
+		size_t next = SPCSVNextByteOfThree(tokenizer->input.bytes, position, stop, a, b, c);
+
+		if (next >= stop) break;
+
+		// As when parsing, a field terminator wins over a line terminator starting at the same byte
+		const SPCSVString *terminator = SPCSVMatches(tokenizer, next, fieldEnd) ? fieldEnd : (SPCSVMatches(tokenizer, next, lineEnd) ? lineEnd : NULL);
+
+		if (terminator) {
+			position = next + terminator->length;
+
+			if (escape->length && SPCSVIsEscaped(tokenizer, segmentStart, next)) {
+				segmentStart = position;
+				state = SPCSVScanUnquoted;
+				continue;
+			}
+
+			segmentStart = position;
+			state = SPCSVScanFieldStart;
+
+			if (terminator == lineEnd && *firstRowStart == SPCSVNotFound) *firstRowStart = position - tokenizer->trimPosition;
+
+			continue;
+		}
+
+		// A field quote only opens a quoted field at the start of a field, after any skipped whitespace
+		if (SPCSVMatches(tokenizer, next, fieldQuote) && state == SPCSVScanFieldStart && SPCSVOnlySkippedWhitespace(tokenizer, segmentStart, next)) {
+			position = next + fieldQuote->length;
+			segmentStart = position;
+			state = SPCSVScanQuoted;
+			continue;
+		}
+
+		position = next + 1;
+
+		if (state == SPCSVScanFieldStart && !SPCSVOnlySkippedWhitespace(tokenizer, segmentStart, position)) state = SPCSVScanUnquoted;
+	}
+
+	// Whatever followed the last terminator decides whether the next chunk starts mid-field
+	if (state == SPCSVScanFieldStart && !SPCSVOnlySkippedWhitespace(tokenizer, segmentStart, stop)) state = SPCSVScanUnquoted;
+
+	return state;
+}
@@ -0,0 +1,174 @@
+//
+//  SPCSVTokenizer.h
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#ifndef __SPCSVTokenizer__
+#define __SPCSVTokenizer__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Splits a stream of UTF-8 CSV bytes into rows of fields without decoding it.
+ *
+ * Field and line terminators, field quotes, escapes and the NULL replacement are handled exactly as
+ * SPCSVParser handles them, and may each be several bytes long. Runs of field content between
+ * terminators are found sixteen bytes at a time where SSE2 or NEON is available; quoted fields are
+ * scanned for their closing quote with memchr. Fields which need no unescaping are returned as spans
+ * of the input, so most are never copied.
+ *
+ * A tokenizer is NOT thread safe.
+ */
+typedef struct SPCSVTokenizer SPCSVTokenizer;
+
+/**
+ * A field of a row returned by the tokenizer. The bytes are only valid until the tokenizer is next used.
+ */
+typedef struct {
+	const uint8_t *bytes;
+	size_t length;
+	bool quoted;  // Whether the field started with the field quote
+	bool isNull;  // Whether the field was \N, or unquoted and matching the NULL replacement
+} SPCSVField;
+
+/**
+ * A row returned by the tokenizer, as an array of its fields.
+ */
+typedef struct {
+	const SPCSVField *fields;
+	size_t fieldCount;
+} SPCSVRow;
+
+/**
+ * Where a scan of the input stands relative to the CSV's quoting, used to split input for parsing on
+ * several threads. A chunk is scanned once from each state, as the state at its start is only known
+ * once the chunks before it have been.
+ */
+typedef enum {
+	SPCSVScanFieldStart = 0,  // At the start of a field, where a field quote opens a quoted field
+	SPCSVScanUnquoted = 1,    // Within an unquoted field, or after a quoted field's closing quote
+	SPCSVScanQuoted = 2,      // Within a quoted field
+	SPCSVScanStateCount = 3
+} SPCSVScanState;
+
+SPCSVTokenizer *SPCSVTokenizerCreate(void);
+void SPCSVTokenizerFree(SPCSVTokenizer *tokenizer);
+
+/**
+ * Create a tokenizer with the same settings as another, but none of its input.
+ */
+SPCSVTokenizer *SPCSVTokenizerCreateCopy(const SPCSVTokenizer *tokenizer);
+
+/**
+ * Set the UTF-8 field terminator, line terminator, field quote and escape. An empty quote or escape
+ * turns quoting or escaping off. The defaults are a comma, a newline, a double quote and a backslash.
+ * Return false if the string could not be copied.
+ */
+bool SPCSVTokenizerSetFieldTerminator(SPCSVTokenizer *tokenizer, const void *bytes, size_t length);
+bool SPCSVTokenizerSetLineTerminator(SPCSVTokenizer *tokenizer, const void *bytes, size_t length);
+bool SPCSVTokenizerSetFieldQuote(SPCSVTokenizer *tokenizer, const void *bytes, size_t length);
+bool SPCSVTokenizerSetEscape(SPCSVTokenizer *tokenizer, const void *bytes, size_t length);
+
+/**
+ * Set the unquoted field content read as NULL, or pass NULL for none, the default.
+ */
+bool SPCSVTokenizerSetNullReplacement(SPCSVTokenizer *tokenizer, const void *bytes, size_t length);
+
+/**
+ * Whether only the escape can escape a field quote. Otherwise, as by default, a doubled field quote
+ * (as written by Excel) is accepted too.
+ */
+void SPCSVTokenizerSetStrictEscapeMatching(SPCSVTokenizer *tokenizer, bool strict);
+
+/**
+ * Appends the next chunk of the input, which may end part way through a row, returning false if the
+ * buffer could not be grown.
+ */
+bool SPCSVTokenizerAppend(SPCSVTokenizer *tokenizer, const void *bytes, size_t length);
+
+/**
+ * Appends the next chunk of the input as SPCSVTokenizerAppend does, but parses it where it is
+ * rather than copying it whenever it directly follows the chunk before in memory, as slices of a
+ * memory-mapped file do (see SPInputBuffer). The bytes must stay unchanged until the input trimmed,
+ * as returned by SPCSVTokenizerTrimmedLength, has passed them.
+ */
+bool SPCSVTokenizerAppendNoCopy(SPCSVTokenizer *tokenizer, const void *bytes, size_t length);
+
+/**
+ * Discards all input, leaving the settings unchanged.
+ */
+void SPCSVTokenizerReset(SPCSVTokenizer *tokenizer);
+
+/**
+ * Moves back to the first row not yet trimmed, and starts counting the parsed length again.
+ */
+void SPCSVTokenizerRewind(SPCSVTokenizer *tokenizer);
+
+/**
+ * Finds the next row with any content, returning false if there is none. Unless inputComplete is
+ * passed, a row is only returned once its line terminator has been read, so that it isn't cut short.
+ * Passing trim allows the input up to the end of the returned row to be discarded.
+ */
+bool SPCSVTokenizerNextRow(SPCSVTokenizer *tokenizer, bool inputComplete, bool trim, SPCSVRow *row);
+
+/**
+ * The input not yet trimmed, and the offset within it of the next row.
+ */
+const uint8_t *SPCSVTokenizerUntrimmedBytes(const SPCSVTokenizer *tokenizer, size_t *length);
+size_t SPCSVTokenizerParserPosition(const SPCSVTokenizer *tokenizer);
+
+/**
+ * The number of bytes of input trimmed since the last reset; input before this is no longer read.
+ */
+uint64_t SPCSVTokenizerTrimmedLength(const SPCSVTokenizer *tokenizer);
+
+/**
+ * The number of bytes covered by the rows parsed since the last rewind, including empty rows skipped.
+ */
+uint64_t SPCSVTokenizerTotalLengthParsed(const SPCSVTokenizer *tokenizer);
+
+/**
+ * Moves the parser position on to an offset within the untrimmed input, counting the bytes passed
+ * over as parsed; the rows they hold must have been parsed elsewhere. Passing trim allows the input
+ * up to the new position to be discarded.
+ */
+void SPCSVTokenizerAdvance(SPCSVTokenizer *tokenizer, size_t position, bool trim);
+
+/**
+ * Scans the untrimmed input from start up to end, following field quotes and terminators but not
+ * building any fields, and returns the state at end. The offset of the first row start found is
+ * returned in firstRowStart, or SIZE_MAX if none is.
+ *
+ * This only reads the input, so several threads may scan one tokenizer at once as long as it isn't
+ * otherwise used meanwhile.
+ */
+SPCSVScanState SPCSVTokenizerScan(const SPCSVTokenizer *tokenizer, size_t start, size_t end, SPCSVScanState state, size_t *firstRowStart);
+
+#endif /* defined(__SPCSVTokenizer__) */
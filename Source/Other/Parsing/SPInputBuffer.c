@@ -0,0 +1,158 @@
+//
+//  SPInputBuffer.c
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#include "SPInputBuffer.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define SPInputBufferMinimumCapacity (64 * 1024)
+
+/**
+ * Makes room in the storage for the input and length more bytes, first moving any input read in
+ * place into it.
+ */
+static bool SPInputBufferReserve(SPInputBuffer *input, size_t length)
+{
+	bool borrowed = SPInputBufferIsBorrowed(input);
+
+	if (input->length + length > input->capacity) {
+		size_t capacity = input->capacity ? input->capacity : SPInputBufferMinimumCapacity;
+
+		while (capacity < input->length + length) capacity *= 2;
+
+		// Storage not holding the input has nothing worth keeping
+		uint8_t *storage;
+
+		if (borrowed) {
+			free(input->storage);
+			input->storage = NULL;
+			input->capacity = 0;
+			storage = malloc(capacity);
+		}
+		else {
+			storage = realloc(input->storage, capacity);
+		}
+
+		if (!storage) return false;
+
+		input->storage = storage;
+		input->capacity = capacity;
+	}
+
+	if (borrowed) memcpy(input->storage, input->bytes, input->length);
+
+	input->bytes = input->storage;
+
+	return true;
+}
+
+void SPInputBufferFree(SPInputBuffer *input)
+{
+	free(input->storage);
+
+	memset(input, 0, sizeof(SPInputBuffer));
+}
+
+void SPInputBufferReset(SPInputBuffer *input)
+{
+	input->bytes = input->storage;
+	input->length = 0;
+	input->discardedLength = 0;
+	input->borrowedEnd = NULL;
+	input->borrowedLength = 0;
+}
+
+bool SPInputBufferAppend(SPInputBuffer *input, const void *bytes, size_t length)
+{
+	if (!SPInputBufferReserve(input, length)) return false;
+
+	if (length) memcpy(input->storage + input->length, bytes, length);
+	input->length += length;
+
+	input->borrowedEnd = NULL;
+	input->borrowedLength = 0;
+
+	return true;
+}
+
+bool SPInputBufferAppendNoCopy(SPInputBuffer *input, const void *bytes, size_t length)
+{
+	if (!length) return true;
+
+	const uint8_t *start = bytes;
+	bool follows = (start == input->borrowedEnd);
+
+	// All the input is the memory just before the bytes, so can be read in place along with them
+	if (follows && input->borrowedLength >= input->length) {
+		input->bytes = start - input->length;
+		input->length += length;
+	}
+	else if (!input->length) {
+		input->bytes = start;
+		input->length = length;
+	}
+	else {
+		size_t borrowedLength = follows ? input->borrowedLength : 0;
+
+		if (!SPInputBufferAppend(input, bytes, length)) return false;
+
+		input->borrowedEnd = start + length;
+		input->borrowedLength = borrowedLength + length;
+
+		return true;
+	}
+
+	input->borrowedEnd = start + length;
+	input->borrowedLength = input->length;
+
+	return true;
+}
+
+void SPInputBufferDiscard(SPInputBuffer *input, size_t length)
+{
+	if (!length) return;
+
+	if (SPInputBufferIsBorrowed(input)) {
+		input->bytes += length;
+	}
+	else {
+		memmove(input->storage, input->storage + length, input->length - length);
+	}
+
+	input->length -= length;
+	input->discardedLength += length;
+
+	if (input->borrowedLength > input->length) input->borrowedLength = input->length;
+}
+
+bool SPInputBufferIsBorrowed(const SPInputBuffer *input)
+{
+	return input->bytes != input->storage;
+}
@@ -0,0 +1,90 @@
+//
+//  SPInputBuffer.h
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#ifndef __SPInputBuffer__
+#define __SPInputBuffer__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * The input held by SPSQLStatementSplitter and SPCSVTokenizer while they work through it: data
+ * appended in chunks, consumed from the front.
+ *
+ * Appended data is normally copied into the buffer's own storage. Data appended without copying
+ * is instead read where it is, for as long as each chunk directly follows the one before in memory,
+ * as consecutive slices of a memory-mapped file do; only where it doesn't is the input not yet
+ * consumed copied, and the input goes back to being read in place once that has been consumed.
+ * Memory appended without copying must stay unchanged until it has been discarded, or the buffer
+ * is reset or freed.
+ */
+typedef struct {
+	const uint8_t *bytes;          // The input: the storage, or memory appended without copying
+	size_t length;
+	uint64_t discardedLength;      // The input discarded from the front so far
+
+	uint8_t *storage;
+	size_t capacity;
+
+	const uint8_t *borrowedEnd;    // Just past the memory last appended without copying
+	size_t borrowedLength;         // How much of the end of the input is the memory up to borrowedEnd
+} SPInputBuffer;
+
+void SPInputBufferFree(SPInputBuffer *input);
+
+/**
+ * Discards all the input, and starts counting the discarded length again.
+ */
+void SPInputBufferReset(SPInputBuffer *input);
+
+/**
+ * Appends a copy of the supplied bytes, returning false if the storage could not be grown.
+ */
+bool SPInputBufferAppend(SPInputBuffer *input, const void *bytes, size_t length);
+
+/**
+ * Appends the supplied bytes, reading them in place where they follow on from the input in memory;
+ * returns false if they had to be copied and the storage could not be grown.
+ */
+bool SPInputBufferAppendNoCopy(SPInputBuffer *input, const void *bytes, size_t length);
+
+/**
+ * Discards the first length bytes of the input. Input read in place is discarded for nothing;
+ * the rest of the input in the storage is moved down.
+ */
+void SPInputBufferDiscard(SPInputBuffer *input, size_t length);
+
+/**
+ * Whether the input is being read in place rather than from the storage.
+ */
+bool SPInputBufferIsBorrowed(const SPInputBuffer *input);
+
+#endif /* defined(__SPInputBuffer__) */
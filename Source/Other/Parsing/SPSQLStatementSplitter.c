@@ -0,0 +1,519 @@
+//
+//  SPSQLStatementSplitter.c
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#include "SPSQLStatementSplitter.h"
+#include "SPInputBuffer.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#define SPSQLByteSetTriggerCount 8
+
+typedef enum {
+	SPSQLSplitterNormal = 0,
+	SPSQLSplitterSingleQuote = 1,
+	SPSQLSplitterDoubleQuote = 2,
+	SPSQLSplitterBacktick = 3,
+	SPSQLSplitterLineComment = 4,
+	SPSQLSplitterBlockComment = 5,
+	SPSQLSplitterStateCount = 6
+} SPSQLSplitterState;
+
+typedef enum {
+	SPSQLDelimiterCommandNoMatch = 0,
+	SPSQLDelimiterCommandMatch = 1,
+	SPSQLDelimiterCommandNeedsMoreData = 2
+} SPSQLDelimiterCommandResult;
+
+/**
+ * The bytes which end a run of uninteresting bytes in one state. Unused trigger slots repeat the
+ * first trigger so the vector comparison can always test all of them.
+ */
+typedef struct {
+	uint8_t triggers[SPSQLByteSetTriggerCount];
+	bool member[256];
+} SPSQLByteSet;
+
+struct SPSQLStatementSplitter {
+	SPInputBuffer input;
+	size_t statementStart;
+	size_t scanPosition;
+	SPSQLSplitterState state;
+	bool statementHasCode;
+	bool containsCarriageReturns;
+	bool noBackslashEscapes;
+	uint8_t delimiter[SPSQLStatementSplitterMaxDelimiterLength];
+	size_t delimiterLength;
+	SPSQLByteSet byteSets[SPSQLSplitterStateCount];
+};
+
+static inline bool SPSQLIsWhitespace(uint8_t byte)
+{
+	return byte == ' ' || byte == '\t' || byte == '\n' || byte == '\r' || byte == '\v' || byte == '\f';
+}
+
+static void SPSQLByteSetInit(SPSQLByteSet *set, const uint8_t *bytes, size_t count)
+{
+	memset(set->member, 0, sizeof(set->member));
+
+	for (size_t i = 0; i < SPSQLByteSetTriggerCount; i++)
+	{
+		set->triggers[i] = bytes[i < count ? i : 0];
+	}
+
+	for (size_t i = 0; i < count; i++)
+	{
+		set->member[bytes[i]] = true;
+	}
+}
+
+static void SPSQLSplitterUpdateByteSets(SPSQLStatementSplitter *splitter)
+{
+	const uint8_t normal[] = { '\'', '"', '`', '#', '-', '/', '\r', splitter->delimiter[0] };
+	const uint8_t singleQuote[] = { '\'', '\\' };
+	const uint8_t doubleQuote[] = { '"', '\\' };
+	const uint8_t backtick[] = { '`' };
+	const uint8_t lineComment[] = { '\n', '\r' };
+	const uint8_t blockComment[] = { '*', '\r' };
+
+	// Backslashes never escape inside backticks, and only escape inside strings outside NO_BACKSLASH_ESCAPES
+	size_t quoteCount = splitter->noBackslashEscapes ? 1 : 2;
+
+	SPSQLByteSetInit(&splitter->byteSets[SPSQLSplitterNormal], normal, sizeof(normal));
+	SPSQLByteSetInit(&splitter->byteSets[SPSQLSplitterSingleQuote], singleQuote, quoteCount);
+	SPSQLByteSetInit(&splitter->byteSets[SPSQLSplitterDoubleQuote], doubleQuote, quoteCount);
+	SPSQLByteSetInit(&splitter->byteSets[SPSQLSplitterBacktick], backtick, sizeof(backtick));
+	SPSQLByteSetInit(&splitter->byteSets[SPSQLSplitterLineComment], lineComment, sizeof(lineComment));
+	SPSQLByteSetInit(&splitter->byteSets[SPSQLSplitterBlockComment], blockComment, sizeof(blockComment));
+}
+
+/**
+ * Returns the offset of the first byte at or after position which is in the set, or the length if
+ * there is none. Sixteen bytes are compared at a time where SSE2 or NEON is available, with the
+ * lookup table used for the remainder.
+ */
+static size_t SPSQLNextTriggerByte(const uint8_t *bytes, size_t position, size_t length, const SPSQLByteSet *set)
+{
+	size_t i = position;
+
+#if defined(__SSE2__)
+	__m128i triggers[SPSQLByteSetTriggerCount];
+
+	for (size_t t = 0; t < SPSQLByteSetTriggerCount; t++) triggers[t] = _mm_set1_epi8((char)set->triggers[t]);
+
+	for (; i + 16 <= length; i += 16)
+	{
+		__m128i block = _mm_loadu_si128((const __m128i *)(bytes + i));
+		__m128i matches = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, triggers[0]), _mm_cmpeq_epi8(block, triggers[1])),
+		                                             _mm_or_si128(_mm_cmpeq_epi8(block, triggers[2]), _mm_cmpeq_epi8(block, triggers[3]))),
+		                               _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, triggers[4]), _mm_cmpeq_epi8(block, triggers[5])),
+		                                            _mm_or_si128(_mm_cmpeq_epi8(block, triggers[6]), _mm_cmpeq_epi8(block, triggers[7]))));
+
+		int mask = _mm_movemask_epi8(matches);
+
+		if (mask) return i + (size_t)__builtin_ctz((unsigned int)mask);
+	}
+#elif defined(__ARM_NEON)
+	uint8x16_t triggers[SPSQLByteSetTriggerCount];
+
+	for (size_t t = 0; t < SPSQLByteSetTriggerCount; t++) triggers[t] = vdupq_n_u8(set->triggers[t]);
+
+	for (; i + 16 <= length; i += 16)
+	{
+		uint8x16_t block = vld1q_u8(bytes + i);
+		uint8x16_t matches = vorrq_u8(vorrq_u8(vorrq_u8(vceqq_u8(block, triggers[0]), vceqq_u8(block, triggers[1])),
+		                                       vorrq_u8(vceqq_u8(block, triggers[2]), vceqq_u8(block, triggers[3]))),
+		                              vorrq_u8(vorrq_u8(vceqq_u8(block, triggers[4]), vceqq_u8(block, triggers[5])),
+		                                       vorrq_u8(vceqq_u8(block, triggers[6]), vceqq_u8(block, triggers[7]))));
+
+		// Narrow each byte's comparison result to four bits, so the first match is the lowest set nibble
+		uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(matches), 4)), 0);
+
+		if (mask) return i + (size_t)(__builtin_ctzll(mask) >> 2);
+	}
+#endif
+
+	for (; i < length; i++)
+	{
+		if (set->member[bytes[i]]) return i;
+	}
+
+	return length;
+}
+
+/**
+ * Matches a "DELIMITER <string>" command at the start of a statement, as the mysql client does,
+ * and switches to the new delimiter. On a match, end is set to the offset just after the new delimiter.
+ */
+static SPSQLDelimiterCommandResult SPSQLMatchDelimiterCommand(SPSQLStatementSplitter *splitter, size_t position, bool endOfInput, size_t *end)
+{
+	static const char keyword[] = "delimiter";
+
+	const uint8_t *bytes = splitter->input.bytes;
+	size_t length = splitter->input.length;
+	size_t i = position;
+	SPSQLDelimiterCommandResult shortResult = endOfInput ? SPSQLDelimiterCommandNoMatch : SPSQLDelimiterCommandNeedsMoreData;
+
+	for (size_t k = 0; k < sizeof(keyword) - 1; k++, i++)
+	{
+		if (i >= length) return shortResult;
+		if ((bytes[i] | 0x20) != keyword[k]) return SPSQLDelimiterCommandNoMatch;
+	}
+
+	if (i >= length) return shortResult;
+	if (bytes[i] != ' ' && bytes[i] != '\t') return SPSQLDelimiterCommandNoMatch;
+
+	while (i < length && (bytes[i] == ' ' || bytes[i] == '\t')) i++;
+
+	if (i >= length) return shortResult;
+
+	size_t delimiterStart = i;
+
+	while (i < length && !SPSQLIsWhitespace(bytes[i])) i++;
+
+	if (i >= length && !endOfInput) return SPSQLDelimiterCommandNeedsMoreData;
+	if (i - delimiterStart > SPSQLStatementSplitterMaxDelimiterLength) return SPSQLDelimiterCommandNoMatch;
+
+	memcpy(splitter->delimiter, bytes + delimiterStart, i - delimiterStart);
+	splitter->delimiterLength = i - delimiterStart;
+	SPSQLSplitterUpdateByteSets(splitter);
+
+	*end = i;
+
+	return SPSQLDelimiterCommandMatch;
+}
+
+/**
+ * Fills in the statement ending at end and moves on to the one starting at nextStart, returning
+ * whether the finished statement was anything other than whitespace.
+ */
+static bool SPSQLSplitterFinishStatement(SPSQLStatementSplitter *splitter, size_t end, size_t nextStart, bool terminated, SPSQLStatement *statement)
+{
+	size_t start = splitter->statementStart;
+
+	while (start < end && SPSQLIsWhitespace(splitter->input.bytes[start])) start++;
+	while (end > start && SPSQLIsWhitespace(splitter->input.bytes[end - 1])) end--;
+
+	statement->bytes = splitter->input.bytes + start;
+	statement->length = end - start;
+	statement->containsCarriageReturns = splitter->containsCarriageReturns;
+	statement->terminated = terminated;
+
+	splitter->statementStart = nextStart;
+	splitter->scanPosition = nextStart;
+	splitter->state = SPSQLSplitterNormal;
+	splitter->statementHasCode = false;
+	splitter->containsCarriageReturns = false;
+
+	return end > start;
+}
+
+SPSQLStatementSplitter *SPSQLStatementSplitterCreate(void)
+{
+	SPSQLStatementSplitter *splitter = calloc(1, sizeof(SPSQLStatementSplitter));
+
+	if (!splitter) return NULL;
+
+	splitter->delimiter[0] = ';';
+	splitter->delimiterLength = 1;
+	SPSQLSplitterUpdateByteSets(splitter);
+
+	return splitter;
+}
+
+void SPSQLStatementSplitterFree(SPSQLStatementSplitter *splitter)
+{
+	if (!splitter) return;
+
+	SPInputBufferFree(&splitter->input);
+	free(splitter);
+}
+
+void SPSQLStatementSplitterSetNoBackslashEscapes(SPSQLStatementSplitter *splitter, bool noBackslashEscapes)
+{
+	if (splitter->noBackslashEscapes == noBackslashEscapes) return;
+
+	splitter->noBackslashEscapes = noBackslashEscapes;
+	SPSQLSplitterUpdateByteSets(splitter);
+}
+
+const uint8_t *SPSQLStatementSplitterDelimiter(const SPSQLStatementSplitter *splitter, size_t *length)
+{
+	*length = splitter->delimiterLength;
+
+	return splitter->delimiter;
+}
+
+bool SPSQLStatementSplitterSetDelimiter(SPSQLStatementSplitter *splitter, const void *bytes, size_t length)
+{
+	if (!length || length > SPSQLStatementSplitterMaxDelimiterLength) return false;
+
+	memcpy(splitter->delimiter, bytes, length);
+	splitter->delimiterLength = length;
+	SPSQLSplitterUpdateByteSets(splitter);
+
+	return true;
+}
+
+/**
+ * Drops the consumed bytes: always when they are read in place, or when appending without copying
+ * so the rest may be, and otherwise once they outweigh the unconsumed ones, so the move is paid
+ * for by the data consumed.
+ */
+static void SPSQLSplitterDiscardConsumed(SPSQLStatementSplitter *splitter, bool force)
+{
+	size_t consumed = splitter->statementStart;
+
+	if (!consumed) return;
+	if (!force && !SPInputBufferIsBorrowed(&splitter->input) && consumed < splitter->input.length - consumed) return;
+
+	SPInputBufferDiscard(&splitter->input, consumed);
+
+	splitter->scanPosition -= consumed;
+	splitter->statementStart = 0;
+}
+
+bool SPSQLStatementSplitterAppend(SPSQLStatementSplitter *splitter, const void *bytes, size_t length)
+{
+	SPSQLSplitterDiscardConsumed(splitter, false);
+
+	return SPInputBufferAppend(&splitter->input, bytes, length);
+}
+
+bool SPSQLStatementSplitterAppendNoCopy(SPSQLStatementSplitter *splitter, const void *bytes, size_t length)
+{
+	SPSQLSplitterDiscardConsumed(splitter, true);
+
+	return SPInputBufferAppendNoCopy(&splitter->input, bytes, length);
+}
+
+bool SPSQLStatementSplitterNextStatement(SPSQLStatementSplitter *splitter, bool endOfInput, SPSQLStatement *statement)
+{
+	const uint8_t *bytes = splitter->input.bytes;
+	size_t length = splitter->input.length;
+	size_t i = splitter->scanPosition;
+
+	while (1)
+	{
+		if (i >= length) {
+			if (!endOfInput) break;
+
+			// Whatever is left, even inside an unterminated string or comment, is the last statement
+			if (SPSQLSplitterFinishStatement(splitter, length, length, false, statement)) return true;
+
+			return false;
+		}
+
+		switch (splitter->state)
+		{
+			case SPSQLSplitterNormal:
+			{
+				if (!splitter->statementHasCode) {
+
+					// Step over whitespace, comments and DELIMITER commands one byte at a time until the statement starts
+					if (SPSQLIsWhitespace(bytes[i])) {
+						if (bytes[i] == '\r') splitter->containsCarriageReturns = true;
+						i++;
+						continue;
+					}
+
+					if ((bytes[i] | 0x20) == 'd') {
+						size_t commandEnd = 0;
+						SPSQLDelimiterCommandResult result = SPSQLMatchDelimiterCommand(splitter, i, endOfInput, &commandEnd);
+
+						if (result == SPSQLDelimiterCommandNeedsMoreData) goto needsMoreData;
+
+						if (result == SPSQLDelimiterCommandMatch) {
+							splitter->statementStart = commandEnd;
+							splitter->containsCarriageReturns = false;
+							i = commandEnd;
+							continue;
+						}
+					}
+				}
+				else {
+					i = SPSQLNextTriggerByte(bytes, i, length, &splitter->byteSets[SPSQLSplitterNormal]);
+
+					if (i >= length) continue;
+				}
+
+				uint8_t byte = bytes[i];
+
+				if (byte == splitter->delimiter[0]) {
+					size_t delimiterLength = splitter->delimiterLength;
+
+					if (i + delimiterLength > length && !endOfInput) goto needsMoreData;
+
+					if (i + delimiterLength <= length && !memcmp(bytes + i, splitter->delimiter, delimiterLength)) {
+						if (SPSQLSplitterFinishStatement(splitter, i, i + delimiterLength, true, statement)) return true;
+
+						i += delimiterLength;
+						continue;
+					}
+				}
+
+				switch (byte)
+				{
+					case '\'':
+						splitter->state = SPSQLSplitterSingleQuote;
+						splitter->statementHasCode = true;
+						i++;
+						break;
+					case '"':
+						splitter->state = SPSQLSplitterDoubleQuote;
+						splitter->statementHasCode = true;
+						i++;
+						break;
+					case '`':
+						splitter->state = SPSQLSplitterBacktick;
+						splitter->statementHasCode = true;
+						i++;
+						break;
+					case '#':
+						splitter->state = SPSQLSplitterLineComment;
+						i++;
+						break;
+					case '-':
+						// "--" only starts a comment when followed by whitespace or a control character
+						if (i + 2 >= length && !endOfInput) goto needsMoreData;
+
+						if (i + 1 < length && bytes[i + 1] == '-' && (i + 2 >= length || bytes[i + 2] <= ' ')) {
+							splitter->state = SPSQLSplitterLineComment;
+							i += 2;
+						}
+						else {
+							splitter->statementHasCode = true;
+							i++;
+						}
+						break;
+					case '/':
+						if (i + 1 >= length && !endOfInput) goto needsMoreData;
+
+						if (i + 1 < length && bytes[i + 1] == '*') {
+							splitter->state = SPSQLSplitterBlockComment;
+							i += 2;
+						}
+						else {
+							splitter->statementHasCode = true;
+							i++;
+						}
+						break;
+					case '\r':
+						splitter->containsCarriageReturns = true;
+						i++;
+						break;
+					default:
+						splitter->statementHasCode = true;
+						i++;
+				}
+				break;
+			}
+
+			case SPSQLSplitterSingleQuote:
+			case SPSQLSplitterDoubleQuote:
+			case SPSQLSplitterBacktick:
+			{
+				i = SPSQLNextTriggerByte(bytes, i, length, &splitter->byteSets[splitter->state]);
+
+				if (i >= length) continue;
+
+				if (bytes[i] == '\\') {
+					if (i + 1 >= length && !endOfInput) goto needsMoreData;
+
+					i += 2;
+					continue;
+				}
+
+				// A doubled quote character is an escaped quote rather than the end of the string
+				if (i + 1 >= length && !endOfInput) goto needsMoreData;
+
+				if (i + 1 < length && bytes[i + 1] == bytes[i]) {
+					i += 2;
+					continue;
+				}
+
+				splitter->state = SPSQLSplitterNormal;
+				i++;
+				break;
+			}
+
+			case SPSQLSplitterLineComment:
+			{
+				i = SPSQLNextTriggerByte(bytes, i, length, &splitter->byteSets[SPSQLSplitterLineComment]);
+
+				// Leave the line ending to be scanned as part of the statement
+				if (i < length) splitter->state = SPSQLSplitterNormal;
+				break;
+			}
+
+			case SPSQLSplitterBlockComment:
+			{
+				i = SPSQLNextTriggerByte(bytes, i, length, &splitter->byteSets[SPSQLSplitterBlockComment]);
+
+				if (i >= length) continue;
+
+				if (bytes[i] == '\r') {
+					splitter->containsCarriageReturns = true;
+					i++;
+					continue;
+				}
+
+				if (i + 1 >= length && !endOfInput) goto needsMoreData;
+
+				if (i + 1 < length && bytes[i + 1] == '/') {
+					splitter->state = SPSQLSplitterNormal;
+					i += 2;
+				}
+				else {
+					i++;
+				}
+				break;
+			}
+
+			default:
+				break;
+		}
+	}
+
+needsMoreData:
+	splitter->scanPosition = i;
+
+	return false;
+}
+
+uint64_t SPSQLStatementSplitterConsumedLength(const SPSQLStatementSplitter *splitter)
+{
+	return splitter->input.discardedLength + splitter->statementStart;
+}
@@ -0,0 +1,113 @@
+//
+//  SPSQLStatementSplitter.h
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#ifndef __SPSQLStatementSplitter__
+#define __SPSQLStatementSplitter__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * The longest delimiter a DELIMITER command may set.
+ */
+#define SPSQLStatementSplitterMaxDelimiterLength 16
+
+/**
+ * Splits a stream of SQL bytes into statements without decoding it.
+ *
+ * Quoted strings, backtick identifiers, "#", "-- " and C-style comments and DELIMITER commands are
+ * handled as SPSQLParser does, so the bytes must be in an encoding in which those characters and the
+ * delimiter can't appear inside a multibyte character (UTF-8, ASCII or a single-byte encoding).
+ * Data is appended in chunks of any size; statements are returned as soon as their delimiter has
+ * been read, and the bytes between them are scanned sixteen at a time where SSE2 or NEON is available.
+ *
+ * A splitter is NOT thread safe.
+ */
+typedef struct SPSQLStatementSplitter SPSQLStatementSplitter;
+
+/**
+ * A statement found by the splitter. The bytes point into the splitter's input, have surrounding
+ * whitespace trimmed and don't include the delimiter; they are only valid until data is next appended.
+ */
+typedef struct {
+	const uint8_t *bytes;
+	size_t length;
+	bool containsCarriageReturns; // A CR outside a quoted string; see +[SPSQLParser normaliseQueryForExecution:]
+	bool terminated;              // NO for text left at the end of the input without a delimiter
+} SPSQLStatement;
+
+SPSQLStatementSplitter *SPSQLStatementSplitterCreate(void);
+void SPSQLStatementSplitterFree(SPSQLStatementSplitter *splitter);
+
+/**
+ * Whether backslashes escape characters inside quoted strings, matching the NO_BACKSLASH_ESCAPES sql_mode.
+ */
+void SPSQLStatementSplitterSetNoBackslashEscapes(SPSQLStatementSplitter *splitter, bool noBackslashEscapes);
+
+/**
+ * The delimiter in effect, as set by the last DELIMITER command read, with its length returned
+ * through length. Valid until the splitter next reads a DELIMITER command.
+ */
+const uint8_t *SPSQLStatementSplitterDelimiter(const SPSQLStatementSplitter *splitter, size_t *length);
+
+/**
+ * Switches to the supplied delimiter as a DELIMITER command would, so splitting can start part way
+ * through a file; returns false, leaving the delimiter unchanged, if it is empty or too long.
+ */
+bool SPSQLStatementSplitterSetDelimiter(SPSQLStatementSplitter *splitter, const void *bytes, size_t length);
+
+/**
+ * Appends the next chunk of the input, returning false if the buffer could not be grown.
+ * Any statement previously returned is invalidated.
+ */
+bool SPSQLStatementSplitterAppend(SPSQLStatementSplitter *splitter, const void *bytes, size_t length);
+
+/**
+ * Appends the next chunk of the input as SPSQLStatementSplitterAppend does, but splits it where it
+ * is rather than copying it whenever it directly follows the chunk before in memory, as slices of
+ * a memory-mapped file do (see SPInputBuffer). The bytes must stay unchanged until all the input
+ * before SPSQLStatementSplitterConsumedLength has passed them.
+ */
+bool SPSQLStatementSplitterAppendNoCopy(SPSQLStatementSplitter *splitter, const void *bytes, size_t length);
+
+/**
+ * Finds the next non-empty statement in the appended data, returning false if more data is needed.
+ * Once endOfInput is passed any remaining text is returned as a final, unterminated statement.
+ */
+bool SPSQLStatementSplitterNextStatement(SPSQLStatementSplitter *splitter, bool endOfInput, SPSQLStatement *statement);
+
+/**
+ * The number of input bytes consumed by the statements returned so far, including delimiters,
+ * comments and DELIMITER commands between them.
+ */
+uint64_t SPSQLStatementSplitterConsumedLength(const SPSQLStatementSplitter *splitter);
+
+#endif /* defined(__SPSQLStatementSplitter__) */
@@ -0,0 +1,102 @@
+//
+//  SPBoundedQueue.h
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import <stdatomic.h>
+
+/**
+ * Counters describing how one stage of a pipeline spent its time. A stage whose
+ * busy share is close to 1 is the one limiting the pipeline's throughput.
+ */
+typedef struct {
+	uint64_t items;            // Number of objects the stage handled
+	uint64_t busyNanoseconds;  // Time spent working on them
+	uint64_t waitNanoseconds;  // Time spent blocked on an empty input or a full output queue
+} SPPipelineStageCounters;
+
+// Returns a monotonic timestamp in nanoseconds, for use with the counters above
+uint64_t SPPipelineTimestamp(void);
+
+// Returns the share of a stage's time spent working, between 0 and 1
+double SPPipelineStageUtilisation(SPPipelineStageCounters counters);
+
+/**
+ * @class SPBoundedQueue SPBoundedQueue.h
+ *
+ * A fixed-capacity FIFO connecting one producer thread to one consumer thread.
+ *
+ * Objects are passed through a ring buffer whose indices are only ever advanced by
+ * atomic stores, so neither side takes a lock. A side only sleeps when it has to -
+ * the producer when the ring is full, the consumer when it is empty - which keeps a
+ * fast stage from racing ahead of a slow one and bounds the memory held in between.
+ * The time each side spends blocked is recorded, for stage utilisation reporting.
+ */
+@interface SPBoundedQueue : NSObject
+{
+	void **slots;
+	NSUInteger capacity;
+
+	_Atomic NSUInteger head;
+	_Atomic NSUInteger tail;
+
+	dispatch_semaphore_t freeSlots;
+	dispatch_semaphore_t filledSlots;
+
+	atomic_bool closed;
+	atomic_bool cancelled;
+
+	_Atomic uint64_t enqueuedCount;
+	_Atomic uint64_t producerWaitNanoseconds;
+	_Atomic uint64_t consumerWaitNanoseconds;
+}
+
+/**
+ * @property capacity The number of objects the queue holds before the producer blocks
+ */
+@property (readonly, assign) NSUInteger capacity;
+
+- (instancetype)initWithCapacity:(NSUInteger)queueCapacity;
+
+// Producer side
+- (BOOL)enqueue:(id)object;
+- (void)close;
+
+// Consumer side
+- (id)dequeue;
+
+// Either side
+- (void)cancel;
+- (BOOL)isCancelled;
+
+// Statistics
+- (uint64_t)enqueuedCount;
+- (uint64_t)producerWaitNanoseconds;
+- (uint64_t)consumerWaitNanoseconds;
+
+@end
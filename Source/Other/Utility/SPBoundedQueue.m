@@ -0,0 +1,231 @@
+//
+//  SPBoundedQueue.m
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPBoundedQueue.h"
+#import <time.h>
+
+uint64_t SPPipelineTimestamp(void)
+{
+	return clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+}
+
+double SPPipelineStageUtilisation(SPPipelineStageCounters counters)
+{
+	uint64_t total = counters.busyNanoseconds + counters.waitNanoseconds;
+
+	return total ? (double)counters.busyNanoseconds / total : 0;
+}
+
+/**
+ * Waits on the supplied semaphore, adding any time spent blocked to the supplied counter.
+ */
+static inline void SPBoundedQueueWait(dispatch_semaphore_t semaphore, _Atomic uint64_t *waitNanoseconds)
+{
+	// Only read the clock when the semaphore isn't immediately available
+	if (!dispatch_semaphore_wait(semaphore, DISPATCH_TIME_NOW)) return;
+
+	uint64_t start = SPPipelineTimestamp();
+
+	dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+
+	atomic_fetch_add_explicit(waitNanoseconds, SPPipelineTimestamp() - start, memory_order_relaxed);
+}
+
+@implementation SPBoundedQueue
+
+@synthesize capacity;
+
+/**
+ * Initialises a queue holding up to the supplied number of objects.
+ */
+- (instancetype)initWithCapacity:(NSUInteger)queueCapacity
+{
+	if ((self = [super init])) {
+		capacity = MAX(queueCapacity, 1);
+		slots = calloc(capacity, sizeof(void *));
+
+		atomic_init(&head, 0);
+		atomic_init(&tail, 0);
+		atomic_init(&closed, false);
+		atomic_init(&cancelled, false);
+		atomic_init(&enqueuedCount, 0);
+		atomic_init(&producerWaitNanoseconds, 0);
+		atomic_init(&consumerWaitNanoseconds, 0);
+
+		// libdispatch refuses to free a semaphore whose value is below its initial value, which
+		// a queue released while still holding objects would trip, so start at zero and signal up
+		freeSlots = dispatch_semaphore_create(0);
+		filledSlots = dispatch_semaphore_create(0);
+
+		for (NSUInteger i = 0; i < capacity; i++) dispatch_semaphore_signal(freeSlots);
+	}
+
+	return self;
+}
+
+#pragma mark -
+#pragma mark Producer
+
+/**
+ * Appends an object to the queue, blocking while the queue is full. Returns NO without
+ * queueing the object if the queue has been closed or cancelled. Must only be called
+ * from the producer thread.
+ */
+- (BOOL)enqueue:(id)object
+{
+	if (!object || atomic_load(&closed) || atomic_load(&cancelled)) return NO;
+
+	SPBoundedQueueWait(freeSlots, &producerWaitNanoseconds);
+
+	// Woken by a cancellation rather than by a free slot; pass the wakeup on
+	if (atomic_load(&cancelled)) {
+		dispatch_semaphore_signal(freeSlots);
+		return NO;
+	}
+
+	NSUInteger index = atomic_load_explicit(&head, memory_order_relaxed);
+
+	slots[index % capacity] = (void *)CFBridgingRetain(object);
+
+	// Publish the slot before the consumer can see the new head
+	atomic_store_explicit(&head, index + 1, memory_order_release);
+	atomic_fetch_add_explicit(&enqueuedCount, 1, memory_order_relaxed);
+
+	dispatch_semaphore_signal(filledSlots);
+
+	return YES;
+}
+
+/**
+ * Marks the end of the producer's output; the consumer receives nil once it has taken
+ * every object queued before this call.
+ */
+- (void)close
+{
+	if (atomic_exchange(&closed, true)) return;
+
+	dispatch_semaphore_signal(filledSlots);
+}
+
+#pragma mark -
+#pragma mark Consumer
+
+/**
+ * Removes and returns the oldest object in the queue, blocking while the queue is empty.
+ * Returns nil once the queue has been closed and drained, or as soon as it is cancelled.
+ * Must only be called from the consumer thread.
+ */
+- (id)dequeue
+{
+	if (atomic_load(&cancelled)) return nil;
+
+	SPBoundedQueueWait(filledSlots, &consumerWaitNanoseconds);
+
+	NSUInteger index = atomic_load_explicit(&tail, memory_order_relaxed);
+
+	// Woken by a close or cancellation rather than by an object; pass the wakeup on for any later call
+	if (atomic_load(&cancelled) || index == atomic_load_explicit(&head, memory_order_acquire)) {
+		dispatch_semaphore_signal(filledSlots);
+		return nil;
+	}
+
+	void *slot = slots[index % capacity];
+
+	slots[index % capacity] = NULL;
+
+	atomic_store_explicit(&tail, index + 1, memory_order_release);
+
+	dispatch_semaphore_signal(freeSlots);
+
+	return CFBridgingRelease(slot);
+}
+
+#pragma mark -
+#pragma mark Cancellation
+
+/**
+ * Abandons the queue, waking both sides. Queued objects are released with the queue.
+ */
+- (void)cancel
+{
+	if (atomic_exchange(&cancelled, true)) return;
+
+	dispatch_semaphore_signal(freeSlots);
+	dispatch_semaphore_signal(filledSlots);
+}
+
+- (BOOL)isCancelled
+{
+	return atomic_load(&cancelled);
+}
+
+#pragma mark -
+#pragma mark Statistics
+
+/**
+ * Returns the number of objects queued so far.
+ */
+- (uint64_t)enqueuedCount
+{
+	return atomic_load_explicit(&enqueuedCount, memory_order_relaxed);
+}
+
+/**
+ * Returns the time the producer has spent blocked on a full queue.
+ */
+- (uint64_t)producerWaitNanoseconds
+{
+	return atomic_load_explicit(&producerWaitNanoseconds, memory_order_relaxed);
+}
+
+/**
+ * Returns the time the consumer has spent blocked on an empty queue.
+ */
+- (uint64_t)consumerWaitNanoseconds
+{
+	return atomic_load_explicit(&consumerWaitNanoseconds, memory_order_relaxed);
+}
+
+#pragma mark -
+
+- (void)dealloc
+{
+	NSUInteger index = atomic_load(&tail);
+	NSUInteger end = atomic_load(&head);
+
+	for (; index < end; index++)
+	{
+		if (slots[index % capacity]) CFRelease(slots[index % capacity]);
+	}
+
+	free(slots);
+}
+
+@end
@@ -0,0 +1,125 @@
+//
+//  SPTransferStatistics.h
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import <stdatomic.h>
+#import <pthread.h>
+
+typedef NS_ENUM(NSUInteger, SPTransferDirection) {
+	SPTransferExport = 0,
+	SPTransferImport = 1
+};
+
+/**
+ * The stages a transfer's time is attributed to. Stages run on different threads, so
+ * their times overlap; the stage with the largest share is the one to look at first.
+ */
+typedef NS_ENUM(NSUInteger, SPTransferStage) {
+	SPTransferServerStage = 0,       // Waiting on the MySQL server
+	SPTransferEncodingStage = 1,     // Encoding rows for export, or parsing the file for import
+	SPTransferCompressionStage = 2,  // Compressing or decompressing the file
+	SPTransferDiskStage = 3,         // Reading or writing the file
+	SPTransferStageCount = 4
+};
+
+/**
+ * @class SPTransferStatistics SPTransferStatistics.h
+ *
+ * Throughput telemetry for a single export or import.
+ *
+ * Counters are updated with relaxed atomics from whichever thread does the work -
+ * exporter, compression or writer thread - so recording costs nothing noticeable on
+ * the hot paths, and the progress sheet can read a consistent-enough summary at any
+ * time. Once finished, the figures can be saved as a JSON report next to the file.
+ */
+@interface SPTransferStatistics : NSObject
+{
+	SPTransferDirection direction;
+
+	uint64_t startTimestamp;
+	_Atomic uint64_t finishTimestamp;
+	_Atomic uint64_t pauseTimestamp;
+	_Atomic uint64_t pausedNanoseconds;
+
+	_Atomic uint64_t rows;
+	_Atomic uint64_t serverBytes;
+	_Atomic uint64_t fileBytes;
+	_Atomic uint64_t storedFileBytes;
+	_Atomic uint64_t statements;
+	_Atomic uint64_t statementErrors;
+	_Atomic uint64_t stageNanoseconds[SPTransferStageCount];
+
+	pthread_mutex_t tablesLock;
+	NSMutableArray *tables;
+}
+
+/**
+ * @property direction Whether the figures describe an export or an import
+ */
+@property (readonly, assign) SPTransferDirection direction;
+
+- (instancetype)initWithDirection:(SPTransferDirection)transferDirection;
+
+// Recording
+- (void)addRows:(uint64_t)count;
+- (void)addServerBytes:(uint64_t)length;
+- (void)addFileBytes:(uint64_t)length;
+- (void)addStoredFileBytes:(uint64_t)length;
+- (void)addStatements:(uint64_t)count errors:(uint64_t)errorCount;
+- (void)addNanoseconds:(uint64_t)nanoseconds toStage:(SPTransferStage)stage;
+- (void)addUnattributedTimeToStage:(SPTransferStage)stage;
+- (void)recordTable:(NSString *)table rowCount:(uint64_t)rowCount duration:(uint64_t)nanoseconds;
+- (void)pause;
+- (void)resume;
+- (void)finish;
+
+// Reading
+- (uint64_t)rows;
+- (uint64_t)serverBytes;
+- (uint64_t)fileBytes;
+- (uint64_t)storedFileBytes;
+- (uint64_t)statements;
+- (uint64_t)statementErrors;
+- (uint64_t)nanosecondsInStage:(SPTransferStage)stage;
+- (uint64_t)elapsedNanoseconds;
+
+- (double)rowsPerSecond;
+- (double)statementsPerSecond;
+- (double)inputBytesPerSecond;
+- (double)outputBytesPerSecond;
+- (double)compressionRatio;
+
+- (NSString *)progressSummary;
+- (NSDictionary *)reportDictionary;
+
+// Reports
++ (NSString *)reportPathForFileAtPath:(NSString *)path;
+- (BOOL)writeReportForFileAtPath:(NSString *)path;
+
+@end
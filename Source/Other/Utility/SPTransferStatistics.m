@@ -0,0 +1,400 @@
+//
+//  SPTransferStatistics.m
+//  sequel-ace
+//
+//  Created by Sequel Ace contributors on October 19, 2026.
+//  Copyright (c) 2026 Sequel Ace. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person
+//  obtaining a copy of this software and associated documentation
+//  files (the "Software"), to deal in the Software without
+//  restriction, including without limitation the rights to use,
+//  copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following
+//  conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+//  OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+//  HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+//  WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+//  OTHER DEALINGS IN THE SOFTWARE.
+//
+//  More info at <https://github.com/sequelpro/sequelpro>
+
+#import "SPTransferStatistics.h"
+#import "SPBoundedQueue.h"
+
+static NSString *SPTransferStageNames[SPTransferStageCount] = { @"server", @"encoding", @"compression", @"disk" };
+
+static inline void SPTransferAdd(_Atomic uint64_t *counter, uint64_t value)
+{
+	if (value) atomic_fetch_add_explicit(counter, value, memory_order_relaxed);
+}
+
+static inline uint64_t SPTransferLoad(_Atomic uint64_t *counter)
+{
+	return atomic_load_explicit(counter, memory_order_relaxed);
+}
+
+@implementation SPTransferStatistics
+
+@synthesize direction;
+
+/**
+ * Initialises an empty set of statistics, with the clock starting now.
+ */
+- (instancetype)initWithDirection:(SPTransferDirection)transferDirection
+{
+	if ((self = [super init])) {
+		direction = transferDirection;
+		startTimestamp = SPPipelineTimestamp();
+
+		atomic_init(&finishTimestamp, 0);
+		atomic_init(&pauseTimestamp, 0);
+		atomic_init(&pausedNanoseconds, 0);
+		atomic_init(&rows, 0);
+		atomic_init(&serverBytes, 0);
+		atomic_init(&fileBytes, 0);
+		atomic_init(&storedFileBytes, 0);
+		atomic_init(&statements, 0);
+		atomic_init(&statementErrors, 0);
+
+		for (NSUInteger i = 0; i < SPTransferStageCount; i++) atomic_init(&stageNanoseconds[i], 0);
+
+		pthread_mutex_init(&tablesLock, NULL);
+		tables = [[NSMutableArray alloc] init];
+	}
+
+	return self;
+}
+
+#pragma mark -
+#pragma mark Recording
+
+/**
+ * Adds rows exported from, or imported into, the server.
+ */
+- (void)addRows:(uint64_t)count
+{
+	SPTransferAdd(&rows, count);
+}
+
+/**
+ * Adds bytes received from the server during an export, or sent to it during an import.
+ */
+- (void)addServerBytes:(uint64_t)length
+{
+	SPTransferAdd(&serverBytes, length);
+}
+
+/**
+ * Adds uncompressed bytes written to, or read from, the file.
+ */
+- (void)addFileBytes:(uint64_t)length
+{
+	SPTransferAdd(&fileBytes, length);
+}
+
+/**
+ * Adds bytes as stored on disk - after compression for an export, before decompression for an import.
+ */
+- (void)addStoredFileBytes:(uint64_t)length
+{
+	SPTransferAdd(&storedFileBytes, length);
+}
+
+/**
+ * Adds executed statements and how many of them failed.
+ */
+- (void)addStatements:(uint64_t)count errors:(uint64_t)errorCount
+{
+	SPTransferAdd(&statements, count);
+	SPTransferAdd(&statementErrors, errorCount);
+}
+
+/**
+ * Attributes time to one of the transfer stages.
+ */
+- (void)addNanoseconds:(uint64_t)nanoseconds toStage:(SPTransferStage)stage
+{
+	if (stage < SPTransferStageCount) SPTransferAdd(&stageNanoseconds[stage], nanoseconds);
+}
+
+/**
+ * Attributes all elapsed time not yet attributed to a stage to the supplied one. Only meaningful
+ * when every stage runs on the same thread, so that stage times add up to the elapsed time.
+ */
+- (void)addUnattributedTimeToStage:(SPTransferStage)stage
+{
+	uint64_t attributed = 0;
+
+	for (NSUInteger i = 0; i < SPTransferStageCount; i++) attributed += [self nanosecondsInStage:i];
+
+	uint64_t elapsed = [self elapsedNanoseconds];
+
+	if (elapsed > attributed) [self addNanoseconds:elapsed - attributed toStage:stage];
+}
+
+/**
+ * Records how long a single table took and how many rows it contained.
+ */
+- (void)recordTable:(NSString *)table rowCount:(uint64_t)rowCount duration:(uint64_t)nanoseconds
+{
+	if (!table) return;
+
+	NSDictionary *entry = @{
+		@"table" : table,
+		@"rows" : @(rowCount),
+		@"seconds" : @(nanoseconds / (double)NSEC_PER_SEC)
+	};
+
+	pthread_mutex_lock(&tablesLock);
+	[tables addObject:entry];
+	pthread_mutex_unlock(&tablesLock);
+}
+
+/**
+ * Stops the clock while the transfer waits on something outside of it, such as the user.
+ */
+- (void)pause
+{
+	atomic_store(&pauseTimestamp, SPPipelineTimestamp());
+}
+
+/**
+ * Restarts the clock stopped by pause.
+ */
+- (void)resume
+{
+	uint64_t paused = atomic_exchange(&pauseTimestamp, 0);
+
+	if (paused) SPTransferAdd(&pausedNanoseconds, SPPipelineTimestamp() - paused);
+}
+
+/**
+ * Stops the clock. Later calls leave the original finish time in place.
+ */
+- (void)finish
+{
+	uint64_t unset = 0;
+
+	atomic_compare_exchange_strong(&finishTimestamp, &unset, SPPipelineTimestamp());
+}
+
+#pragma mark -
+#pragma mark Reading
+
+- (uint64_t)rows { return SPTransferLoad(&rows); }
+- (uint64_t)serverBytes { return SPTransferLoad(&serverBytes); }
+- (uint64_t)fileBytes { return SPTransferLoad(&fileBytes); }
+- (uint64_t)statements { return SPTransferLoad(&statements); }
+- (uint64_t)statementErrors { return SPTransferLoad(&statementErrors); }
+
+/**
+ * Returns the number of bytes stored on disk, which is the uncompressed length when nothing
+ * recorded a separate stored length.
+ */
+- (uint64_t)storedFileBytes
+{
+	uint64_t stored = SPTransferLoad(&storedFileBytes);
+
+	return stored ? stored : [self fileBytes];
+}
+
+- (uint64_t)nanosecondsInStage:(SPTransferStage)stage
+{
+	return (stage < SPTransferStageCount) ? SPTransferLoad(&stageNanoseconds[stage]) : 0;
+}
+
+/**
+ * Returns the time since the statistics were created, up to when they were finished, less any pauses.
+ */
+- (uint64_t)elapsedNanoseconds
+{
+	uint64_t end = SPTransferLoad(&finishTimestamp);
+	uint64_t paused = SPTransferLoad(&pauseTimestamp);
+
+	if (!end) end = paused ? paused : SPPipelineTimestamp();
+
+	uint64_t elapsed = end - startTimestamp;
+	uint64_t excluded = SPTransferLoad(&pausedNanoseconds);
+
+	return (elapsed > excluded) ? elapsed - excluded : 0;
+}
+
+- (double)_perSecond:(uint64_t)value
+{
+	uint64_t elapsed = [self elapsedNanoseconds];
+
+	return elapsed ? value * (double)NSEC_PER_SEC / elapsed : 0;
+}
+
+- (double)rowsPerSecond
+{
+	return [self _perSecond:[self rows]];
+}
+
+- (double)statementsPerSecond
+{
+	return [self _perSecond:[self statements]];
+}
+
+/**
+ * Returns the rate data is read from its source - the server for an export, the disk for an import.
+ */
+- (double)inputBytesPerSecond
+{
+	return [self _perSecond:(direction == SPTransferExport) ? [self serverBytes] : [self storedFileBytes]];
+}
+
+/**
+ * Returns the rate data is written to its destination - the disk for an export, the server for an import.
+ */
+- (double)outputBytesPerSecond
+{
+	return [self _perSecond:(direction == SPTransferExport) ? [self storedFileBytes] : [self serverBytes]];
+}
+
+/**
+ * Returns the uncompressed file length divided by the stored length, or 0 before anything has been stored.
+ */
+- (double)compressionRatio
+{
+	uint64_t stored = [self storedFileBytes];
+
+	return stored ? [self fileBytes] / (double)stored : 0;
+}
+
+/**
+ * Returns two lines for the progress sheet: the throughput, then how the stage time splits up.
+ */
+- (NSString *)progressSummary
+{
+	static NSNumberFormatter *rowsFormatter = nil;
+	static NSNumberFormatter *percentFormatter = nil;
+	static dispatch_once_t onceToken;
+
+	dispatch_once(&onceToken, ^{
+		rowsFormatter = [[NSNumberFormatter alloc] init];
+		[rowsFormatter setNumberStyle:NSNumberFormatterDecimalStyle];
+		[rowsFormatter setMaximumFractionDigits:0];
+
+		percentFormatter = [[NSNumberFormatter alloc] init];
+		[percentFormatter setNumberStyle:NSNumberFormatterPercentStyle];
+		[percentFormatter setMaximumFractionDigits:0];
+	});
+
+	NSMutableString *summary = [NSMutableString stringWithFormat:NSLocalizedString(@"%1$@ rows/s, in %2$@/s, out %3$@/s", @"transfer statistics : throughput line"),
+		[rowsFormatter stringFromNumber:@([self rowsPerSecond])],
+		[NSByteCountFormatter stringFromByteCount:(long long)[self inputBytesPerSecond] countStyle:NSByteCountFormatterCountStyleFile],
+		[NSByteCountFormatter stringFromByteCount:(long long)[self outputBytesPerSecond] countStyle:NSByteCountFormatterCountStyleFile]];
+
+	double ratio = [self compressionRatio];
+
+	if (ratio > 1.01) [summary appendFormat:NSLocalizedString(@", %.1f× compression", @"transfer statistics : compression ratio"), ratio];
+
+	uint64_t stageTotal = 0;
+
+	for (NSUInteger i = 0; i < SPTransferStageCount; i++) stageTotal += [self nanosecondsInStage:i];
+
+	if (stageTotal) {
+		double share[SPTransferStageCount];
+
+		for (NSUInteger i = 0; i < SPTransferStageCount; i++) share[i] = [self nanosecondsInStage:i] / (double)stageTotal;
+
+		[summary appendString:@"\n"];
+		[summary appendFormat:NSLocalizedString(@"Server %1$@, encoding %2$@, compression %3$@, disk %4$@", @"transfer statistics : stage time split line"),
+			[percentFormatter stringFromNumber:@(share[SPTransferServerStage])],
+			[percentFormatter stringFromNumber:@(share[SPTransferEncodingStage])],
+			[percentFormatter stringFromNumber:@(share[SPTransferCompressionStage])],
+			[percentFormatter stringFromNumber:@(share[SPTransferDiskStage])]];
+	}
+
+	uint64_t errorCount = [self statementErrors];
+
+	if (errorCount) [summary appendFormat:NSLocalizedString(@", %llu errors", @"transfer statistics : statement error count"), errorCount];
+
+	return summary;
+}
+
+/**
+ * Returns the figures in a form suitable for JSON serialisation.
+ */
+- (NSDictionary *)reportDictionary
+{
+	NSMutableDictionary *stages = [NSMutableDictionary dictionaryWithCapacity:SPTransferStageCount];
+
+	for (NSUInteger i = 0; i < SPTransferStageCount; i++)
+	{
+		stages[SPTransferStageNames[i]] = @([self nanosecondsInStage:i] / (double)NSEC_PER_SEC);
+	}
+
+	NSArray *tableEntries;
+
+	pthread_mutex_lock(&tablesLock);
+	tableEntries = [tables copy];
+	pthread_mutex_unlock(&tablesLock);
+
+	return @{
+		@"direction" : (direction == SPTransferExport) ? @"export" : @"import",
+		@"seconds" : @([self elapsedNanoseconds] / (double)NSEC_PER_SEC),
+		@"rows" : @([self rows]),
+		@"rowsPerSecond" : @([self rowsPerSecond]),
+		@"serverBytes" : @([self serverBytes]),
+		@"fileBytes" : @([self fileBytes]),
+		@"storedFileBytes" : @([self storedFileBytes]),
+		@"inputBytesPerSecond" : @([self inputBytesPerSecond]),
+		@"outputBytesPerSecond" : @([self outputBytesPerSecond]),
+		@"compressionRatio" : @([self compressionRatio]),
+		@"statements" : @([self statements]),
+		@"statementErrors" : @([self statementErrors]),
+		@"statementsPerSecond" : @([self statementsPerSecond]),
+		@"stageSeconds" : stages,
+		@"tables" : tableEntries
+	};
+}
+
+#pragma mark -
+#pragma mark Reports
+
+/**
+ * Returns the path of the report saved alongside the supplied file.
+ */
++ (NSString *)reportPathForFileAtPath:(NSString *)path
+{
+	return [path stringByAppendingString:@".report.json"];
+}
+
+/**
+ * Writes the report alongside the supplied file, replacing any earlier report.
+ */
+- (BOOL)writeReportForFileAtPath:(NSString *)path
+{
+	if (![path length]) return NO;
+
+	NSError *error = nil;
+	NSData *json = [NSJSONSerialization dataWithJSONObject:[self reportDictionary] options:NSJSONWritingPrettyPrinted error:&error];
+
+	if (!json) {
+		SPLog(@"Unable to serialise transfer report: %@", error);
+		return NO;
+	}
+
+	return [json writeToFile:[SPTransferStatistics reportPathForFileAtPath:path] options:NSDataWritingAtomic error:nil];
+}
+
+#pragma mark -
+
+- (void)dealloc
+{
+	pthread_mutex_destroy(&tablesLock);
+}
+
+@end
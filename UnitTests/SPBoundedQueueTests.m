@@ -0,0 +1,90 @@
+//
+//  SPBoundedQueueTests.m
+//  Unit Tests
+//
+//  Created by Sequel Ace contributors on 19.10.26.
+//  Copyright © 2026 Sequel-Ace. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "SPBoundedQueue.h"
+
+@interface SPBoundedQueueTests : XCTestCase
+
+@end
+
+@implementation SPBoundedQueueTests
+
+- (void)testObjectsArriveInOrderAndCloseEndsTheQueue
+{
+	SPBoundedQueue *queue = [[SPBoundedQueue alloc] initWithCapacity:4];
+
+	XCTAssertTrue([queue enqueue:@1]);
+	XCTAssertTrue([queue enqueue:@2]);
+
+	[queue close];
+
+	XCTAssertFalse([queue enqueue:@3]);
+	XCTAssertEqualObjects([queue dequeue], @1);
+	XCTAssertEqualObjects([queue dequeue], @2);
+	XCTAssertNil([queue dequeue]);
+	XCTAssertNil([queue dequeue]);
+	XCTAssertEqual([queue enqueuedCount], 2ULL);
+}
+
+- (void)testProducerAndConsumerOnSeparateThreads
+{
+	SPBoundedQueue *queue = [[SPBoundedQueue alloc] initWithCapacity:3];
+	NSUInteger objectCount = 10000;
+
+	dispatch_async(dispatch_get_global_queue(QOS_CLASS_DEFAULT, 0), ^{
+		for (NSUInteger i = 0; i < objectCount; i++) [queue enqueue:@(i)];
+
+		[queue close];
+	});
+
+	NSUInteger expected = 0;
+	NSNumber *object;
+
+	while ((object = [queue dequeue]))
+	{
+		XCTAssertEqual([object unsignedIntegerValue], expected);
+		expected++;
+	}
+
+	XCTAssertEqual(expected, objectCount);
+}
+
+- (void)testCancelWakesABlockedProducer
+{
+	SPBoundedQueue *queue = [[SPBoundedQueue alloc] initWithCapacity:1];
+	XCTestExpectation *producerStopped = [self expectationWithDescription:@"producer stopped"];
+
+	XCTAssertTrue([queue enqueue:@1]);
+
+	dispatch_async(dispatch_get_global_queue(QOS_CLASS_DEFAULT, 0), ^{
+		// Blocks on the full queue until it is cancelled
+		if (![queue enqueue:@2]) [producerStopped fulfill];
+	});
+
+	[NSThread sleepForTimeInterval:0.05];
+	[queue cancel];
+
+	[self waitForExpectationsWithTimeout:5 handler:nil];
+
+	XCTAssertTrue([queue isCancelled]);
+	XCTAssertNil([queue dequeue]);
+	XCTAssertGreaterThan([queue producerWaitNanoseconds], 0ULL);
+}
+
+- (void)testStageUtilisation
+{
+	SPPipelineStageCounters idle = {0, 0, 0};
+	SPPipelineStageCounters busy = {10, 750, 250};
+
+	XCTAssertEqual(SPPipelineStageUtilisation(idle), 0);
+	XCTAssertEqualWithAccuracy(SPPipelineStageUtilisation(busy), 0.75, 0.0001);
+}
+
+@end
@@ -0,0 +1,129 @@
+//
+//  SPCSVImportSamplerTests.m
+//  Unit Tests
+//
+//  Created by Sequel Ace contributors on 19.10.26.
+//  Copyright © 2026 Sequel-Ace. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "SPCSVImportSampler.h"
+#import "SPCSVColumnProfile.h"
+#import "SPCSVParser.h"
+
+@interface SPCSVImportSamplerTests : XCTestCase
+
+@property (nonatomic, copy) NSString *filePath;
+
+@end
+
+@implementation SPCSVImportSamplerTests
+
+- (void)setUp
+{
+	[super setUp];
+
+	self.filePath = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSString stringWithFormat:@"%@.csv", [[NSUUID UUID] UUIDString]]];
+}
+
+- (void)tearDown
+{
+	[[NSFileManager defaultManager] removeItemAtPath:self.filePath error:nil];
+
+	[super tearDown];
+}
+
+- (SPCSVParser *)_parserWithFieldTerminator:(NSString *)fieldTerminator
+{
+	SPCSVParser *parser = [[SPCSVParser alloc] init];
+
+	[parser setFieldTerminatorString:fieldTerminator convertDisplayStrings:NO];
+	[parser setLineTerminatorString:@"\n" convertDisplayStrings:NO];
+	[parser setFieldQuoteString:@"\"" convertDisplayStrings:NO];
+	[parser setEscapeString:@"\\" convertDisplayStrings:NO];
+
+	return parser;
+}
+
+- (void)testSmallFileParsedAgainWithoutReading
+{
+	[@"id,name;note\n1,Smith;a\n2,Jones;b\n" writeToFile:self.filePath atomically:YES encoding:NSUTF8StringEncoding error:NULL];
+
+	SPCSVImportSampler *sampler = [[SPCSVImportSampler alloc] initWithPath:self.filePath];
+
+	XCTAssertTrue([sampler readSample]);
+	XCTAssertTrue([sampler sampleIsWholeFile]);
+	XCTAssertTrue([sampler isSampleOfFileAtPath:self.filePath]);
+
+	NSArray *rows = [sampler rowsParsedWithSettingsOfParser:[self _parserWithFieldTerminator:@","] encoding:NSUTF8StringEncoding limit:100];
+
+	XCTAssertEqualObjects(rows, (@[@[@"id", @"name;note"], @[@"1", @"Smith;a"], @[@"2", @"Jones;b"]]));
+
+	// Changing the settings only parses the sample again
+	[[NSFileManager defaultManager] removeItemAtPath:self.filePath error:nil];
+
+	rows = [sampler rowsParsedWithSettingsOfParser:[self _parserWithFieldTerminator:@";"] encoding:NSUTF8StringEncoding limit:2];
+
+	XCTAssertEqualObjects(rows, (@[@[@"id,name", @"note"], @[@"1,Smith", @"a"]]));
+	XCTAssertFalse([sampler isSampleOfFileAtPath:self.filePath]);
+}
+
+- (void)testLargeFileProfiledFromSlices
+{
+	NSMutableString *csv = [NSMutableString stringWithString:@"id,code\n"];
+
+	// Codes are numbers at the start of the file, but not further on
+	for (NSUInteger i = 1; [csv length] < 4 * 1024 * 1024; i++)
+	{
+		[csv appendFormat:@"%lu,%@\n", (unsigned long)i, ([csv length] < 1024 * 1024) ? @"42" : @"X-1234"];
+	}
+
+	[csv writeToFile:self.filePath atomically:YES encoding:NSUTF8StringEncoding error:NULL];
+
+	SPCSVImportSampler *sampler = [[SPCSVImportSampler alloc] initWithPath:self.filePath];
+
+	XCTAssertTrue([sampler readSample]);
+	XCTAssertFalse([sampler sampleIsWholeFile]);
+
+	NSArray *rows = [sampler rowsParsedWithSettingsOfParser:[self _parserWithFieldTerminator:@","] encoding:NSUTF8StringEncoding limit:100];
+
+	XCTAssertEqual([rows count], 100U);
+	XCTAssertEqualObjects([rows objectAtIndex:1], (@[@"1", @"42"]));
+
+	SPCSVColumnProfile *profile = [sampler columnProfileIncludingFirstRow:NO];
+
+	XCTAssertEqual([profile columnCount], 2U);
+	XCTAssertTrue([profile columnIsInteger:0]);
+	XCTAssertFalse([profile columnIsInteger:1]);
+	XCTAssertEqual([profile maxLengthOfColumn:1], 6U);
+	XCTAssertGreaterThan([profile rowCount], [rows count]);
+
+	// The header row isn't a number
+	XCTAssertFalse([[sampler columnProfileIncludingFirstRow:YES] columnIsInteger:0]);
+}
+
+- (void)testColumnProfile
+{
+	SPCSVColumnProfile *profile = [[SPCSVColumnProfile alloc] initWithColumnCount:3];
+
+	[profile addRow:@[@"12", @"abc", [NSNull null]]];
+	[profile addRow:@[@"-7", @"1.5"]];
+
+	XCTAssertTrue([profile columnIsInteger:0]);
+	XCTAssertFalse([profile columnIsInteger:1]);
+	XCTAssertTrue([profile columnIsInteger:2]);
+	XCTAssertEqual([profile maxLengthOfColumn:1], 3U);
+	XCTAssertEqual([profile rowCount], 2U);
+
+	SPCSVColumnProfile *otherProfile = [[SPCSVColumnProfile alloc] initWithColumnCount:3];
+
+	[otherProfile addRow:@[@"007", @"", @"123456789"]];
+	[profile addProfile:otherProfile];
+
+	XCTAssertFalse([profile columnIsInteger:0]);
+	XCTAssertEqual([profile maxLengthOfColumn:2], 9U);
+	XCTAssertEqual([profile rowCount], 3U);
+}
+
+@end
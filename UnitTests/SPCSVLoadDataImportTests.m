@@ -0,0 +1,50 @@
+//
+//  SPCSVLoadDataImportTests.m
+//  Unit Tests
+//
+//  Created by Sequel Ace contributors on 19.10.26.
+//  Copyright © 2026 Sequel-Ace. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "SPCSVLoadDataImport.h"
+
+@interface SPCSVLoadDataImportTests : XCTestCase
+
+@end
+
+@implementation SPCSVLoadDataImportTests
+
+- (void)testQuotedString
+{
+	XCTAssertEqualObjects([SPCSVLoadDataImport quotedString:@","], @"','");
+	XCTAssertEqualObjects([SPCSVLoadDataImport quotedString:@"\r\n"], @"'\\r\\n'");
+	XCTAssertEqualObjects([SPCSVLoadDataImport quotedString:@"\\"], @"'\\\\'");
+	XCTAssertEqualObjects([SPCSVLoadDataImport quotedString:@"it's.csv"], @"'it\\'s.csv'");
+}
+
+- (void)testFormatClause
+{
+	XCTAssertEqualObjects([SPCSVLoadDataImport formatClauseWithFieldTerminator:@"," lineTerminator:@"\n" fieldQuote:@"\"" escape:@""],
+		@"FIELDS TERMINATED BY ',' OPTIONALLY ENCLOSED BY '\"' ESCAPED BY '' LINES TERMINATED BY '\\n'");
+
+	// Doubled quotes are read as quotes anyway, so a quote escape needs no ESCAPED BY
+	XCTAssertEqualObjects([SPCSVLoadDataImport formatClauseWithFieldTerminator:@"\t" lineTerminator:@"\r\n" fieldQuote:@"\"" escape:@"\""],
+		@"FIELDS TERMINATED BY '\\t' OPTIONALLY ENCLOSED BY '\"' ESCAPED BY '' LINES TERMINATED BY '\\r\\n'");
+
+	XCTAssertEqualObjects([SPCSVLoadDataImport formatClauseWithFieldTerminator:@";" lineTerminator:@"\n" fieldQuote:@"" escape:@""],
+		@"FIELDS TERMINATED BY ';' ESCAPED BY '' LINES TERMINATED BY '\\n'");
+}
+
+- (void)testUnsupportedFormatsReturnNil
+{
+	XCTAssertNil([SPCSVLoadDataImport formatClauseWithFieldTerminator:@"," lineTerminator:@"\n" fieldQuote:@"''" escape:@"\\"]);
+	XCTAssertNil([SPCSVLoadDataImport formatClauseWithFieldTerminator:@"," lineTerminator:@"\n" fieldQuote:@"\"" escape:@"\\\\"]);
+	XCTAssertNil([SPCSVLoadDataImport formatClauseWithFieldTerminator:@"" lineTerminator:@"\n" fieldQuote:@"\"" escape:@"\\"]);
+
+	// The server would decode sequences such as \n and \N which the parser keeps
+	XCTAssertNil([SPCSVLoadDataImport formatClauseWithFieldTerminator:@"," lineTerminator:@"\n" fieldQuote:@"\"" escape:@"\\"]);
+}
+
+@end
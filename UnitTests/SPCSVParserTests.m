@@ -60,4 +60,134 @@
 	XCTAssertEqualObjects(rows[1], (@[@"line one\r\nline two", @"2"]));
 }
 
+
+- (void)testEscapesAndNullValues
+{
+	SPCSVParser *parser = [[SPCSVParser alloc] initWithString:@"\"a\\\"b\",c\\,d,e\\\\f,\\N,NULL,\"NULL\",\"say \"\"hi\"\"\"\n"];
+	[parser setNullReplacementString:@"NULL"];
+
+	NSArray *rows = [parser array];
+
+	XCTAssertEqual([rows count], 1U);
+	XCTAssertEqualObjects(rows[0], (@[@"a\"b", @"c,d", @"e\\f", [NSNull null], [NSNull null], @"NULL", @"say \"hi\""]));
+}
+
+- (void)testStreamedDataSplitWithinRowsAndCharacters
+{
+	SPCSVParser *parser = [[SPCSVParser alloc] init];
+	NSData *csvData = [@"name,city\n\"Zoë\",Zürich\nLuis,\"São\nPaulo\"\n" dataUsingEncoding:NSUTF8StringEncoding];
+	NSMutableArray *rows = [NSMutableArray array];
+	NSArray *row;
+
+	for (NSUInteger i = 0; i < [csvData length]; i += 3)
+	{
+		[parser appendData:[csvData subdataWithRange:NSMakeRange(i, MIN(3, [csvData length] - i))]];
+
+		while ((row = [parser getRowAsArrayAndTrimString:YES stringIsComplete:NO])) [rows addObject:row];
+	}
+	while ((row = [parser getRowAsArrayAndTrimString:YES stringIsComplete:YES])) [rows addObject:row];
+
+	XCTAssertFalse([parser decodingFailed]);
+	XCTAssertEqual([rows count], 3U);
+	XCTAssertEqualObjects(rows[1], (@[@"Zoë", @"Zürich"]));
+	XCTAssertEqualObjects(rows[2], (@[@"Luis", @"São\nPaulo"]));
+	XCTAssertEqual([parser totalLengthParsed], [csvData length]);
+}
+
+- (void)testDataAppendedWithoutCopying
+{
+	NSMutableString *csvString = [NSMutableString string];
+
+	for (NSUInteger i = 0; i < 20000; i++) [csvString appendFormat:@"%lu,\"quoted, \"\"value\"\"\",Zoë\n", (unsigned long)i];
+
+	NSData *csvData = [csvString dataUsingEncoding:NSUTF8StringEncoding];
+	SPCSVParser *copyingParser = [[SPCSVParser alloc] init];
+	SPCSVParser *parser = [[SPCSVParser alloc] init];
+	NSMutableArray *expectedRows = [NSMutableArray array];
+	NSMutableArray *rows = [NSMutableArray array];
+	NSArray *row;
+
+	[copyingParser appendData:csvData];
+	while ((row = [copyingParser getRowAsArrayAndTrimString:YES stringIsComplete:YES])) [expectedRows addObject:row];
+
+	// Slices of the one buffer follow each other in memory, as slices of a mapped file do; every
+	// fourth piece is a copy, which doesn't
+	for (NSUInteger i = 0, piece = 0; i < [csvData length]; i += 50001, piece++)
+	{
+		NSData *slice = [csvData subdataWithRange:NSMakeRange(i, MIN(50001, [csvData length] - i))];
+
+		if (piece % 4) slice = [[NSData alloc] initWithBytesNoCopy:(void *)((const uint8_t *)[csvData bytes] + i) length:[slice length] freeWhenDone:NO];
+
+		[parser appendDataNoCopy:slice];
+
+		while ((row = [parser getRowAsArrayAndTrimString:YES stringIsComplete:NO])) [rows addObject:row];
+	}
+	while ((row = [parser getRowAsArrayAndTrimString:YES stringIsComplete:YES])) [rows addObject:row];
+
+	XCTAssertEqual([rows count], 20000U);
+	XCTAssertEqualObjects(rows, expectedRows);
+	XCTAssertEqual([parser totalLengthParsed], [csvData length]);
+}
+
+- (void)testInvalidUTF8IsReported
+{
+	SPCSVParser *parser = [[SPCSVParser alloc] init];
+	[parser appendData:[NSData dataWithBytes:"1,\xFF\xFE\n" length:5]];
+
+	XCTAssertNotNil([parser getRowAsArray]);
+	XCTAssertTrue([parser decodingFailed]);
+}
+
+- (void)testParsingThreadsReturnTheSameRows
+{
+	NSMutableString *csvString = [NSMutableString string];
+
+	// Several megabytes, with quoted line and field terminators, doubled and escaped quotes,
+	// mid-field quotes, padding and blank lines for the chunk scans to get past
+	for (NSUInteger i = 0; i < 200000; i++)
+	{
+		switch (i % 5) {
+			case 0: [csvString appendFormat:@"%lu,\"multi\nline, \"\"quoted\"\" value\",plain\n", (unsigned long)i]; break;
+			case 1: [csvString appendFormat:@"%lu,  5\" pipe ,\"a\\\"b\"\n\n", (unsigned long)i]; break;
+			case 2: [csvString appendFormat:@"%lu,NULL,escaped\\,comma\n", (unsigned long)i]; break;
+			case 3: [csvString appendFormat:@"%lu,\"\n\n\",\"Zoë\"\n", (unsigned long)i]; break;
+			default: [csvString appendFormat:@"%lu,short\n", (unsigned long)i]; break;
+		}
+	}
+
+	NSData *csvData = [csvString dataUsingEncoding:NSUTF8StringEncoding];
+	SPCSVParser *sequentialParser = [[SPCSVParser alloc] init];
+	SPCSVParser *parallelParser = [[SPCSVParser alloc] init];
+	NSMutableArray *sequentialRows = [NSMutableArray array];
+	NSMutableArray *parallelRows = [NSMutableArray array];
+	NSMutableArray *parallelLengths = [NSMutableArray array];
+	NSArray *row;
+
+	[sequentialParser setNullReplacementString:@"NULL"];
+	[parallelParser setNullReplacementString:@"NULL"];
+	[parallelParser setParsingThreads:4];
+
+	[sequentialParser appendData:csvData];
+	while ((row = [sequentialParser getRowAsArrayAndTrimString:YES stringIsComplete:YES])) [sequentialRows addObject:row];
+
+	// Streamed in uneven pieces, so chunks start part way through rows
+	for (NSUInteger i = 0; i < [csvData length]; i += 3000001)
+	{
+		[parallelParser appendData:[csvData subdataWithRange:NSMakeRange(i, MIN(3000001, [csvData length] - i))]];
+
+		while ((row = [parallelParser getRowAsArrayAndTrimString:YES stringIsComplete:NO])) {
+			[parallelRows addObject:row];
+			[parallelLengths addObject:@([parallelParser totalLengthParsed])];
+		}
+	}
+	while ((row = [parallelParser getRowAsArrayAndTrimString:YES stringIsComplete:YES])) [parallelRows addObject:row];
+
+	XCTAssertEqual([sequentialRows count], 200000U);
+	XCTAssertEqualObjects(parallelRows, sequentialRows);
+	XCTAssertEqual([parallelParser totalLengthParsed], [csvData length]);
+
+	// Positions reported along the way only ever move on
+	for (NSUInteger i = 1; i < [parallelLengths count]; i++) XCTAssertGreaterThan([parallelLengths[i] unsignedIntegerValue], [parallelLengths[i - 1] unsignedIntegerValue]);
+}
+
 @end
@@ -0,0 +1,72 @@
+//
+//  SPCSVPreparedInsertTests.m
+//  Unit Tests
+//
+//  Created by Sequel Ace contributors on 19.10.26.
+//  Copyright © 2026 Sequel-Ace. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "SPCSVPreparedInsert.h"
+
+@interface SPCSVPreparedInsertTests : XCTestCase
+
+@end
+
+@implementation SPCSVPreparedInsertTests
+
+- (void)testQuery
+{
+	XCTAssertEqualObjects([SPCSVPreparedInsert queryWithInsertString:@"INSERT INTO `t` (`a`,`b`) VALUES\n" tailString:nil columnCount:2 rowCount:3],
+		@"INSERT INTO `t` (`a`,`b`) VALUES\n(?,?),\n(?,?),\n(?,?)");
+
+	XCTAssertEqualObjects([SPCSVPreparedInsert queryWithInsertString:@"INSERT INTO `t` (`a`) VALUES\n" tailString:@"ON DUPLICATE KEY UPDATE `a` = VALUES(`a`)" columnCount:1 rowCount:1],
+		@"INSERT INTO `t` (`a`) VALUES\n(?) ON DUPLICATE KEY UPDATE `a` = VALUES(`a`)");
+}
+
+- (void)testRowsAreLimitedByPlaceholders
+{
+	SPMySQLConnection *connection = [[SPMySQLConnection alloc] init];
+
+	XCTAssertEqual([[[SPCSVPreparedInsert alloc] initWithConnection:connection insertString:@"" tailString:nil columnCount:1] maxRowsPerStatement], 65535U);
+	XCTAssertEqual([[[SPCSVPreparedInsert alloc] initWithConnection:connection insertString:@"" tailString:nil columnCount:10] maxRowsPerStatement], 6553U);
+}
+
+- (void)testRemovingRows
+{
+	SPCSVPreparedInsert *insert = [[SPCSVPreparedInsert alloc] initWithConnection:[[SPMySQLConnection alloc] init] insertString:@"INSERT INTO `t` (`a`,`b`) VALUES\n" tailString:nil columnCount:2];
+
+	XCTAssertEqual([insert rowCount], 0U);
+
+	[insert appendString:@"1"];
+	[insert appendString:@"café"];
+	[insert appendString:@"2"];
+	[insert appendNull];
+
+	XCTAssertEqual([insert rowCount], 2U);
+
+	NSUInteger twoRowLength = [insert executeLength];
+
+	[insert appendString:@"3"];
+
+	// An unfinished row isn't counted
+	XCTAssertEqual([insert rowCount], 2U);
+
+	[insert appendString:@"a longer value"];
+	[insert removeRowsFromIndex:2];
+
+	XCTAssertEqual([insert rowCount], 2U);
+	XCTAssertEqual([insert executeLength], twoRowLength);
+
+	[insert removeRowsFromIndex:1];
+
+	XCTAssertEqual([insert rowCount], 1U);
+	XCTAssertLessThan([insert executeLength], twoRowLength);
+
+	[insert removeAllRows];
+
+	XCTAssertEqual([insert rowCount], 0U);
+}
+
+@end
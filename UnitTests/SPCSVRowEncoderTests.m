@@ -0,0 +1,196 @@
+//
+//  SPCSVRowEncoderTests.m
+//  Unit Tests
+//
+//  Created by Sequel Ace contributors on 19.10.26.
+//  Copyright © 2026 Sequel-Ace. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "SPCSVRowEncoder.h"
+#import "SPTestingUtils.h"
+
+@interface SPCSVRowEncoderTests : XCTestCase
+
+@end
+
+@implementation SPCSVRowEncoderTests
+
+/**
+ * Escapes a cell the way SPCSVExporter does when the row encoder can't be used.
+ */
+- (NSString *)stringEscapedCell:(NSString *)cell enclosed:(BOOL)enclosed separator:(NSString *)separator enclosure:(NSString *)enclosure escape:(NSString *)escape lineEnding:(NSString *)lineEnding
+{
+	if (![cell length]) return [enclosure stringByAppendingString:enclosure];
+
+	NSMutableString *escaped = [NSMutableString stringWithString:cell];
+
+	[escaped replaceOccurrencesOfString:escape withString:[escape stringByAppendingString:escape] options:NSLiteralSearch range:NSMakeRange(0, [escaped length])];
+
+	if (![escape isEqualToString:enclosure] && [enclosure length]) {
+		[escaped replaceOccurrencesOfString:enclosure withString:[escape stringByAppendingString:enclosure] options:NSLiteralSearch range:NSMakeRange(0, [escaped length])];
+	}
+
+	if (![enclosure length] || !enclosed) {
+		[escaped replaceOccurrencesOfString:separator withString:[escape stringByAppendingString:separator] options:NSLiteralSearch range:NSMakeRange(0, [escaped length])];
+		[escaped replaceOccurrencesOfString:lineEnding withString:[escape stringByAppendingString:lineEnding] options:NSLiteralSearch range:NSMakeRange(0, [escaped length])];
+	}
+
+	if (!enclosed) return escaped;
+
+	return [NSString stringWithFormat:@"%@%@%@", enclosure, escaped, enclosure];
+}
+
+- (NSString *)encodedCell:(NSString *)cell enclosed:(BOOL)enclosed withEncoder:(SPCSVRowEncoder *)encoder
+{
+	[encoder removeAllBytes];
+	[encoder appendCellString:cell enclosed:enclosed];
+
+	return [[NSString alloc] initWithBytes:[encoder bytes] length:[encoder length] encoding:NSUTF8StringEncoding];
+}
+
+- (NSArray *)textHeavyCells
+{
+	NSMutableArray *cells = [NSMutableArray array];
+	NSString *paragraph = @"Lorem ipsum dolor sit amet, consectetur adipiscing elit; sed do eiusmod tempor incididunt ut labore et dolore magna aliqua. ";
+
+	for (NSUInteger i = 0; i < 2000; i++)
+	{
+		NSMutableString *cell = [NSMutableString string];
+
+		for (NSUInteger j = 0; j < (i % 8) + 1; j++) [cell appendString:paragraph];
+
+		// Roughly one in ten cells contains characters which need escaping
+		if (i % 10 == 0) [cell appendString:@"She said \"hello\"\nand left."];
+		if (i % 25 == 0) [cell appendString:@" – naïve café"];
+
+		[cells addObject:cell];
+	}
+
+	return cells;
+}
+
+- (void)testRowEncoding
+{
+	SPCSVRowEncoder *encoder = [[SPCSVRowEncoder alloc] initWithFieldSeparator:@"," enclosingCharacter:@"\"" escapeString:@"\\" lineEnding:@"\n" nullString:@"NULL"];
+
+	XCTAssertNotNil(encoder);
+
+	[encoder appendCellString:@"1" enclosed:NO];
+	[encoder appendFieldSeparator];
+	[encoder appendCellString:@"say \"hi\", \\o/\n" enclosed:YES];
+	[encoder appendFieldSeparator];
+	[encoder appendNULL];
+	[encoder appendFieldSeparator];
+	[encoder appendCellString:@"" enclosed:NO];
+	[encoder appendLineEnding];
+
+	NSString *row = [[NSString alloc] initWithBytes:[encoder bytes] length:[encoder length] encoding:NSUTF8StringEncoding];
+
+	XCTAssertEqualObjects(row, @"1,\"say \\\"hi\\\", \\\\o/\n\",NULL,\"\"\n");
+}
+
+- (void)testMatchesStringEscaping
+{
+	NSArray *options = @[
+		@[@",", @"\"", @"\"", @"\n"],
+		@[@",", @"\"", @"\\", @"\r\n"],
+		@[@"\t", @"", @"\\", @"\n"],
+		@[@";", @"'", @"\\", @"\r"]
+	];
+
+	NSArray *cells = @[
+		@"plain",
+		@"a,b;c\td",
+		@"quote \" and 'apostrophe'",
+		@"back\\slash",
+		@"line\none\r\ntwo\rthree",
+		@"ünïcödé \"ß\" ✓, with more than sixteen bytes of text\n",
+		@"\"\"\"\"\"\"\"\"\"\"\"\"\"\"\"\"\"\"",
+		@"0123456789abcdef0123456789abcdef\\"
+	];
+
+	for (NSArray *option in options)
+	{
+		SPCSVRowEncoder *encoder = [[SPCSVRowEncoder alloc] initWithFieldSeparator:option[0] enclosingCharacter:option[1] escapeString:option[2] lineEnding:option[3] nullString:@""];
+
+		XCTAssertNotNil(encoder);
+
+		for (NSString *cell in cells)
+		{
+			for (NSNumber *enclosed in @[@YES, @NO])
+			{
+				NSString *expected = [self stringEscapedCell:cell enclosed:[enclosed boolValue] separator:option[0] enclosure:option[1] escape:option[2] lineEnding:option[3]];
+
+				XCTAssertEqualObjects([self encodedCell:cell enclosed:[enclosed boolValue] withEncoder:encoder], expected, @"%@ with %@", cell, option);
+			}
+		}
+	}
+}
+
+- (void)testUnsupportedOptions
+{
+	// Non-ASCII strings
+	XCTAssertFalse([SPCSVRowEncoder canEncodeWithFieldSeparator:@"¦" enclosingCharacter:@"\"" escapeString:@"\\" lineEnding:@"\n"]);
+
+	// An empty escape string
+	XCTAssertFalse([SPCSVRowEncoder canEncodeWithFieldSeparator:@"," enclosingCharacter:@"\"" escapeString:@"" lineEnding:@"\n"]);
+
+	// Strings containing another's first character
+	XCTAssertFalse([SPCSVRowEncoder canEncodeWithFieldSeparator:@"," enclosingCharacter:@"\"" escapeString:@"\\" lineEnding:@",\n"]);
+	XCTAssertFalse([SPCSVRowEncoder canEncodeWithFieldSeparator:@"\n" enclosingCharacter:@"\"" escapeString:@"\\" lineEnding:@"\n"]);
+
+	XCTAssertNil([[SPCSVRowEncoder alloc] initWithFieldSeparator:@"¦" enclosingCharacter:@"\"" escapeString:@"\\" lineEnding:@"\n" nullString:@""]);
+
+	XCTAssertTrue([SPCSVRowEncoder canEncodeWithFieldSeparator:@"," enclosingCharacter:@"\"" escapeString:@"\"" lineEnding:@"\r\n"]);
+}
+
+- (void)testPerformance_stringEscaping
+{
+	SASkipUnlessPerformanceTestsEnabled();
+
+	NSArray *cells = [self textHeavyCells];
+
+	[self measureBlock:^{
+		for (NSUInteger pass = 0; pass < 20; pass++)
+		{
+			@autoreleasepool {
+				NSMutableString *output = [NSMutableString string];
+
+				for (NSString *cell in cells)
+				{
+					[output appendString:[self stringEscapedCell:cell enclosed:YES separator:@"," enclosure:@"\"" escape:@"\"" lineEnding:@"\n"]];
+					[output appendString:@","];
+				}
+
+				XCTAssertNotNil([output dataUsingEncoding:NSUTF8StringEncoding]);
+			}
+		}
+	}];
+}
+
+- (void)testPerformance_rowEncoder
+{
+	SASkipUnlessPerformanceTestsEnabled();
+
+	NSArray *cells = [self textHeavyCells];
+	SPCSVRowEncoder *encoder = [[SPCSVRowEncoder alloc] initWithFieldSeparator:@"," enclosingCharacter:@"\"" escapeString:@"\"" lineEnding:@"\n" nullString:@""];
+
+	[self measureBlock:^{
+		for (NSUInteger pass = 0; pass < 20; pass++)
+		{
+			[encoder removeAllBytes];
+
+			for (NSString *cell in cells)
+			{
+				[encoder appendCellString:cell enclosed:YES];
+				[encoder appendFieldSeparator];
+			}
+
+			XCTAssertGreaterThan([encoder length], 0U);
+		}
+	}];
+}
+
+@end
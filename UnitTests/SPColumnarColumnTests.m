@@ -0,0 +1,174 @@
+//
+//  SPColumnarColumnTests.m
+//  Unit Tests
+//
+//  Created by Sequel Ace contributors on 19.10.26.
+//  Copyright © 2026 Sequel-Ace. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "SPColumnarColumn.h"
+
+@interface SPColumnarColumnTests : XCTestCase
+
+@end
+
+@implementation SPColumnarColumnTests
+
+- (void)testFieldTypeMapping
+{
+	XCTAssertEqual([[SPColumnarColumn columnWithName:@"a" fieldDefinition:@{@"type": @"TINYINT", @"typegrouping": @"integer"}] type], SPColumnarInt8Type);
+	XCTAssertEqual([[SPColumnarColumn columnWithName:@"a" fieldDefinition:@{@"type": @"INT", @"typegrouping": @"integer", @"UNSIGNED_FLAG": @YES}] type], SPColumnarUInt32Type);
+	XCTAssertEqual([[SPColumnarColumn columnWithName:@"a" fieldDefinition:@{@"type": @"BIGINT", @"typegrouping": @"integer"}] type], SPColumnarInt64Type);
+	XCTAssertEqual([[SPColumnarColumn columnWithName:@"a" fieldDefinition:@{@"type": @"DOUBLE", @"typegrouping": @"float"}] type], SPColumnarDoubleType);
+	XCTAssertEqual([[SPColumnarColumn columnWithName:@"a" fieldDefinition:@{@"type": @"DATE", @"typegrouping": @"date"}] type], SPColumnarDateType);
+	XCTAssertEqual([[SPColumnarColumn columnWithName:@"a" fieldDefinition:@{@"type": @"DATETIME", @"typegrouping": @"date"}] type], SPColumnarTimestampType);
+	XCTAssertEqual([[SPColumnarColumn columnWithName:@"a" fieldDefinition:@{@"type": @"TIME", @"typegrouping": @"date"}] type], SPColumnarStringType);
+	XCTAssertEqual([[SPColumnarColumn columnWithName:@"a" fieldDefinition:@{@"type": @"MEDIUMBLOB", @"typegrouping": @"blobdata"}] type], SPColumnarBinaryType);
+	XCTAssertEqual([[SPColumnarColumn columnWithName:@"a" fieldDefinition:nil] type], SPColumnarStringType);
+
+	SPColumnarColumn *enumColumn = [SPColumnarColumn columnWithName:@"a" fieldDefinition:@{@"type": @"ENUM", @"typegrouping": @"enum"}];
+
+	XCTAssertEqual([enumColumn type], SPColumnarStringType);
+	XCTAssertTrue([enumColumn prefersDictionaryEncoding]);
+}
+
+- (void)testDecimalPrecisionFromDisplayLength
+{
+	// DECIMAL(10,2): 10 digits, the decimal point and the sign
+	SPColumnarColumn *column = [SPColumnarColumn columnWithName:@"price" fieldDefinition:@{@"type": @"DECIMAL", @"typegrouping": @"float", @"byte_length": @12, @"decimals": @2}];
+
+	XCTAssertEqual([column type], SPColumnarDecimalType);
+	XCTAssertEqual([column precision], 10U);
+	XCTAssertEqual([column scale], 2U);
+
+	// DECIMAL(65,0) doesn't fit into 128 bits
+	column = [SPColumnarColumn columnWithName:@"wide" fieldDefinition:@{@"type": @"DECIMAL", @"typegrouping": @"float", @"byte_length": @66, @"decimals": @0}];
+
+	XCTAssertEqual([column type], SPColumnarStringType);
+}
+
+- (void)testIntegerValuesAndValidity
+{
+	SPColumnarColumn *column = [[SPColumnarColumn alloc] initWithName:@"id" type:SPColumnarInt16Type];
+
+	[column appendValue:@"-42"];
+	[column appendValue:[NSNull null]];
+	[column appendValue:@"12abc"];
+	[column appendValue:@1000];
+
+	XCTAssertEqual([column length], 4U);
+	XCTAssertEqual([column nullCount], 2U);
+	XCTAssertEqual([[column values] length], 8U);
+	XCTAssertFalse([column isNullAtIndex:0]);
+	XCTAssertTrue([column isNullAtIndex:1]);
+	XCTAssertTrue([column isNullAtIndex:2]);
+	XCTAssertFalse([column isNullAtIndex:3]);
+
+	const int16_t *values = [[column values] bytes];
+
+	XCTAssertEqual(values[0], -42);
+	XCTAssertEqual(values[1], 0);
+	XCTAssertEqual(values[3], 1000);
+
+	// The validity bitmap is LSB ordered
+	XCTAssertEqual(((const uint8_t *)[[column validity] bytes])[0], 0x09);
+
+	[column reset];
+
+	XCTAssertEqual([column length], 0U);
+	XCTAssertEqual([column nullCount], 0U);
+	XCTAssertEqual([[column values] length], 0U);
+}
+
+- (void)testDecimalValues
+{
+	SPColumnarColumn *column = [[SPColumnarColumn alloc] initWithName:@"price" type:SPColumnarDecimalType];
+
+	[column setScale:2];
+
+	[column appendValue:@"1234.5"];
+	[column appendValue:@"-0.07"];
+	[column appendValue:@"1.2.3"];
+
+	const __int128 *values = [[column values] bytes];
+
+	XCTAssertTrue(values[0] == 123450);
+	XCTAssertTrue(values[1] == -7);
+	XCTAssertTrue([column isNullAtIndex:2]);
+}
+
+- (void)testDateAndTimestampValues
+{
+	SPColumnarColumn *dates = [[SPColumnarColumn alloc] initWithName:@"d" type:SPColumnarDateType];
+
+	[dates appendValue:@"1970-01-01"];
+	[dates appendValue:@"2000-03-01"];
+	[dates appendValue:@"1969-12-31"];
+	[dates appendValue:@"0000-00-00"];
+
+	const int32_t *days = [[dates values] bytes];
+
+	XCTAssertEqual(days[0], 0);
+	XCTAssertEqual(days[1], 11017);
+	XCTAssertEqual(days[2], -1);
+	XCTAssertTrue([dates isNullAtIndex:3]);
+
+	SPColumnarColumn *timestamps = [[SPColumnarColumn alloc] initWithName:@"t" type:SPColumnarTimestampType];
+
+	[timestamps appendValue:@"1970-01-02 00:00:01"];
+	[timestamps appendValue:@"1970-01-01 00:00:00.25"];
+
+	const int64_t *microseconds = [[timestamps values] bytes];
+
+	XCTAssertEqual(microseconds[0], 86401000000LL);
+	XCTAssertEqual(microseconds[1], 250000LL);
+}
+
+- (void)testStringOffsets
+{
+	SPColumnarColumn *column = [[SPColumnarColumn alloc] initWithName:@"s" type:SPColumnarStringType];
+
+	[column appendValue:@"ab"];
+	[column appendValue:[NSNull null]];
+	[column appendValue:[@"cde" dataUsingEncoding:NSUTF8StringEncoding]];
+
+	const int32_t *offsets = [[column offsets] bytes];
+
+	XCTAssertEqual([[column offsets] length], 4 * sizeof(int32_t));
+	XCTAssertEqual(offsets[0], 0);
+	XCTAssertEqual(offsets[1], 2);
+	XCTAssertEqual(offsets[2], 2);
+	XCTAssertEqual(offsets[3], 5);
+	XCTAssertEqualObjects([[NSString alloc] initWithData:[column values] encoding:NSUTF8StringEncoding], @"abcde");
+}
+
+- (void)testDictionaryBuilding
+{
+	SPColumnarColumn *column = [[SPColumnarColumn alloc] initWithName:@"colour" type:SPColumnarStringType];
+
+	for (NSString *value in @[@"red", @"green", @"red", @"red", @"green"])
+	{
+		[column appendValue:value];
+	}
+
+	[column appendValue:[NSNull null]];
+
+	XCTAssertFalse([column buildDictionaryWithMaximumLength:1]);
+	XCTAssertTrue([column buildDictionaryWithMaximumLength:2]);
+	XCTAssertEqual([column dictionaryLength], 2U);
+	XCTAssertEqualObjects([[NSString alloc] initWithData:[column dictionaryValues] encoding:NSUTF8StringEncoding], @"redgreen");
+
+	const int32_t *indices = [[column dictionaryIndices] bytes];
+
+	XCTAssertEqual(indices[0], 0);
+	XCTAssertEqual(indices[1], 1);
+	XCTAssertEqual(indices[3], 0);
+	XCTAssertEqual(indices[4], 1);
+
+	// Only string columns can be dictionary encoded
+	XCTAssertFalse([[[SPColumnarColumn alloc] initWithName:@"n" type:SPColumnarInt32Type] buildDictionaryWithMaximumLength:10]);
+}
+
+@end
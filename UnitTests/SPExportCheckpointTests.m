@@ -0,0 +1,93 @@
+//
+//  SPExportCheckpointTests.m
+//  Unit Tests
+//
+//  Created by Sequel Ace contributors on 19.10.26.
+//  Copyright © 2026 Sequel-Ace. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "SPExportCheckpoint.h"
+
+@interface SPExportCheckpointTests : XCTestCase
+
+@property (nonatomic, copy) NSString *exportFilePath;
+
+@end
+
+@implementation SPExportCheckpointTests
+
+- (void)setUp
+{
+	[super setUp];
+
+	self.exportFilePath = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSString stringWithFormat:@"%@.sql", [[NSUUID UUID] UUIDString]]];
+}
+
+- (void)tearDown
+{
+	[[NSFileManager defaultManager] removeItemAtPath:[SPExportCheckpoint manifestPathForExportFilePath:self.exportFilePath] error:nil];
+
+	[super tearDown];
+}
+
+- (void)testNoManifestReturnsNil
+{
+	XCTAssertNil([SPExportCheckpoint checkpointForExportFilePath:self.exportFilePath]);
+}
+
+- (void)testManifestRoundTrip
+{
+	SPExportCheckpoint *checkpoint = [[SPExportCheckpoint alloc] initWithExportFilePath:self.exportFilePath];
+	[checkpoint setExportFormat:@"SQL"];
+	[checkpoint setDatabaseName:@"shop"];
+
+	XCTAssertFalse([checkpoint hasProgress]);
+
+	[checkpoint recordByteOffset:120];
+	[checkpoint recordCompletedTable:@"customers" atByteOffset:4096];
+	[checkpoint recordLastKey:@"'ORD-0042'" forTable:@"orders" atByteOffset:8192];
+
+	SPExportCheckpoint *loaded = [SPExportCheckpoint checkpointForExportFilePath:self.exportFilePath];
+
+	XCTAssertNotNil(loaded);
+	XCTAssertTrue([loaded hasProgress]);
+	XCTAssertEqualObjects([loaded exportFormat], @"SQL");
+	XCTAssertEqualObjects([loaded databaseName], @"shop");
+	XCTAssertEqual([loaded byteOffset], 8192ULL);
+	XCTAssertTrue([loaded isTableCompleted:@"customers"]);
+	XCTAssertFalse([loaded isTableCompleted:@"orders"]);
+	XCTAssertEqualObjects([loaded lastKeyForTable:@"orders"], @"'ORD-0042'");
+	XCTAssertNil([loaded lastKeyForTable:@"customers"]);
+	XCTAssertTrue([loaded hasOutputForTable:@"orders"]);
+	XCTAssertFalse([loaded hasOutputForTable:@"invoices"]);
+}
+
+- (void)testCompletingTableClearsLastKey
+{
+	SPExportCheckpoint *checkpoint = [[SPExportCheckpoint alloc] initWithExportFilePath:self.exportFilePath];
+
+	[checkpoint recordLastKey:@"10000" forTable:@"orders" atByteOffset:100];
+	[checkpoint recordCompletedTable:@"orders" atByteOffset:200];
+
+	SPExportCheckpoint *loaded = [SPExportCheckpoint checkpointForExportFilePath:self.exportFilePath];
+
+	XCTAssertNil([loaded currentTable]);
+	XCTAssertNil([loaded lastKeyForTable:@"orders"]);
+	XCTAssertTrue([loaded isTableCompleted:@"orders"]);
+	XCTAssertEqual([loaded byteOffset], 200ULL);
+}
+
+- (void)testRemoveManifest
+{
+	SPExportCheckpoint *checkpoint = [[SPExportCheckpoint alloc] initWithExportFilePath:self.exportFilePath];
+
+	[checkpoint recordByteOffset:10];
+	XCTAssertNotNil([SPExportCheckpoint checkpointForExportFilePath:self.exportFilePath]);
+
+	[checkpoint removeManifest];
+	XCTAssertNil([SPExportCheckpoint checkpointForExportFilePath:self.exportFilePath]);
+}
+
+@end
@@ -0,0 +1,98 @@
+//
+//  SPExportPartManifestTests.m
+//  Unit Tests
+//
+//  Created by Sequel Ace contributors on 19.10.26.
+//  Copyright © 2026 Sequel-Ace. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "SPExportPartManifest.h"
+
+@interface SPExportPartManifestTests : XCTestCase
+
+@property (nonatomic, copy) NSString *exportFilePath;
+
+@end
+
+@implementation SPExportPartManifestTests
+
+- (void)setUp
+{
+	[super setUp];
+
+	self.exportFilePath = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSString stringWithFormat:@"%@.sql", [[NSUUID UUID] UUIDString]]];
+}
+
+- (void)tearDown
+{
+	[[NSFileManager defaultManager] removeItemAtPath:[SPExportPartManifest manifestPathForExportFilePath:self.exportFilePath] error:nil];
+
+	[super tearDown];
+}
+
+- (void)testPartPaths
+{
+	XCTAssertEqualObjects([SPExportPartManifest pathForPart:1 ofExportFilePath:@"/tmp/dump.sql.gz"], @"/tmp/dump.sql.gz");
+	XCTAssertEqualObjects([SPExportPartManifest pathForPart:2 ofExportFilePath:@"/tmp/dump.sql.gz"], @"/tmp/dump.part0002.sql.gz");
+	XCTAssertEqualObjects([SPExportPartManifest pathForPart:3 ofExportFilePath:@"/tmp/orders.csv"], @"/tmp/orders.part0003.csv");
+	XCTAssertEqualObjects([SPExportPartManifest pathForPart:12 ofExportFilePath:@"/tmp/dump"], @"/tmp/dump.part0012");
+}
+
+- (void)testNoManifestReturnsNil
+{
+	XCTAssertNil([SPExportPartManifest manifestForExportFilePath:self.exportFilePath]);
+}
+
+- (void)testManifestRoundTrip
+{
+	SPExportPartManifest *manifest = [[SPExportPartManifest alloc] initWithExportFilePath:self.exportFilePath];
+	[manifest setExportFormat:@"SQL"];
+	[manifest setDatabaseName:@"shop"];
+
+	XCTAssertEqualObjects([manifest beginNextPart], self.exportFilePath);
+
+	[manifest recordStructureForTable:@"customers"];
+	[manifest recordRows:10 forTable:@"customers"];
+	[manifest recordStructureForTable:@"orders"];
+	[manifest recordRows:5 forTable:@"orders"];
+
+	NSString *secondPart = [manifest beginNextPart];
+
+	[manifest recordRows:7 forTable:@"orders"];
+	[manifest recordRows:1 forTable:@"orders"];
+
+	XCTAssertTrue([manifest writeManifest]);
+
+	SPExportPartManifest *loaded = [SPExportPartManifest manifestForExportFilePath:self.exportFilePath];
+
+	XCTAssertNotNil(loaded);
+	XCTAssertEqualObjects([loaded exportFormat], @"SQL");
+	XCTAssertEqualObjects([loaded databaseName], @"shop");
+	XCTAssertEqual([loaded partCount], 2U);
+	XCTAssertEqualObjects([loaded partPaths], (@[self.exportFilePath, secondPart]));
+	XCTAssertEqualObjects([loaded partPathsForTable:@"customers"], @[self.exportFilePath]);
+	XCTAssertEqualObjects([loaded partPathsForTable:@"orders"], (@[self.exportFilePath, secondPart]));
+	XCTAssertEqualObjects([loaded structurePartPathForTable:@"orders"], self.exportFilePath);
+	XCTAssertNil([loaded structurePartPathForTable:@"missing"]);
+	XCTAssertEqual([loaded rowCountForTable:@"orders" inPart:1], 5U);
+	XCTAssertEqual([loaded rowCountForTable:@"orders" inPart:2], 8U);
+	XCTAssertEqual([loaded rowCountForTable:@"customers" inPart:2], 0U);
+}
+
+- (void)testRemoveManifest
+{
+	SPExportPartManifest *manifest = [[SPExportPartManifest alloc] initWithExportFilePath:self.exportFilePath];
+
+	[manifest beginNextPart];
+	[manifest writeManifest];
+
+	XCTAssertTrue([[NSFileManager defaultManager] fileExistsAtPath:[SPExportPartManifest manifestPathForExportFilePath:self.exportFilePath]]);
+
+	[manifest removeManifest];
+
+	XCTAssertNil([SPExportPartManifest manifestForExportFilePath:self.exportFilePath]);
+}
+
+@end
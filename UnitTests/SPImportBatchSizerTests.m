@@ -0,0 +1,114 @@
+//
+//  SPImportBatchSizerTests.m
+//  Unit Tests
+//
+//  Created by Sequel Ace contributors on 19.10.26.
+//  Copyright © 2026 Sequel-Ace. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "SPImportBatchSizer.h"
+
+static const uint64_t SPTestTargetNanoseconds = 250 * NSEC_PER_MSEC;
+
+@interface SPImportBatchSizerTests : XCTestCase
+
+@end
+
+@implementation SPImportBatchSizerTests
+
+- (void)testBatchLengthIsAShareOfTheMaxQuerySize
+{
+	XCTAssertEqual([[[SPImportBatchSizer alloc] initWithMaxQuerySize:1024 * 1024 targetNanoseconds:SPTestTargetNanoseconds] maxBatchLength], 786432U);
+	XCTAssertEqual([[[SPImportBatchSizer alloc] initWithMaxQuerySize:1024 * 1024 * 1024 targetNanoseconds:SPTestTargetNanoseconds] maxBatchLength], 64U * 1024 * 1024);
+	XCTAssertEqual([[[SPImportBatchSizer alloc] initWithMaxQuerySize:1024 targetNanoseconds:SPTestTargetNanoseconds] maxBatchLength], 16U * 1024);
+}
+
+- (void)testReadChunkLength
+{
+	XCTAssertEqual([[[SPImportBatchSizer alloc] initWithMaxQuerySize:1024 * 1024 targetNanoseconds:SPTestTargetNanoseconds] readChunkLength], 393216U);
+	XCTAssertEqual([[[SPImportBatchSizer alloc] initWithMaxQuerySize:64 * 1024 targetNanoseconds:SPTestTargetNanoseconds] readChunkLength], 256U * 1024);
+	XCTAssertEqual([[[SPImportBatchSizer alloc] initWithMaxQuerySize:1024 * 1024 * 1024 targetNanoseconds:SPTestTargetNanoseconds] readChunkLength], 4U * 1024 * 1024);
+}
+
+- (void)testFastBatchesGrowAtMostTwofold
+{
+	SPImportBatchSizer *sizer = [[SPImportBatchSizer alloc] initWithMaxQuerySize:16 * 1024 * 1024 targetNanoseconds:SPTestTargetNanoseconds];
+
+	XCTAssertEqual([sizer rowsPerBatch], 1000U);
+	XCTAssertEqual([sizer measuredBatches], 0U);
+
+	[sizer recordBatchOfRows:1000 duration:10 * NSEC_PER_MSEC];
+
+	XCTAssertEqual([sizer rowsPerBatch], 2000U);
+	XCTAssertEqual([sizer measuredBatches], 1U);
+}
+
+- (void)testSlowBatchesShrinkAtMostByHalf
+{
+	SPImportBatchSizer *sizer = [[SPImportBatchSizer alloc] initWithMaxQuerySize:16 * 1024 * 1024 targetNanoseconds:SPTestTargetNanoseconds];
+
+	[sizer recordBatchOfRows:1000 duration:2 * NSEC_PER_SEC];
+
+	XCTAssertEqual([sizer rowsPerBatch], 500U);
+}
+
+- (void)testBatchOnTargetKeepsItsSize
+{
+	SPImportBatchSizer *sizer = [[SPImportBatchSizer alloc] initWithMaxQuerySize:16 * 1024 * 1024 targetNanoseconds:SPTestTargetNanoseconds];
+
+	[sizer recordBatchOfRows:1000 duration:SPTestTargetNanoseconds];
+	[sizer recordBatchOfRows:1000 duration:SPTestTargetNanoseconds];
+
+	XCTAssertEqual([sizer rowsPerBatch], 1000U);
+}
+
+- (void)testShortBatchesDoNotGrow
+{
+	SPImportBatchSizer *sizer = [[SPImportBatchSizer alloc] initWithMaxQuerySize:16 * 1024 * 1024 targetNanoseconds:SPTestTargetNanoseconds];
+
+	[sizer recordBatchOfRows:100 duration:NSEC_PER_MSEC];
+
+	XCTAssertEqual([sizer rowsPerBatch], 1000U);
+}
+
+- (void)testRowCountStaysWithinLimits
+{
+	SPImportBatchSizer *sizer = [[SPImportBatchSizer alloc] initWithMaxQuerySize:16 * 1024 * 1024 targetNanoseconds:SPTestTargetNanoseconds];
+
+	for (NSUInteger i = 0; i < 20; i++) [sizer recordBatchOfRows:[sizer rowsPerBatch] duration:10 * NSEC_PER_SEC];
+
+	XCTAssertEqual([sizer rowsPerBatch], 10U);
+
+	for (NSUInteger i = 0; i < 40; i++) [sizer recordBatchOfRows:[sizer rowsPerBatch] duration:NSEC_PER_MSEC];
+
+	XCTAssertEqual([sizer rowsPerBatch], 100000U);
+}
+
+- (void)testRowCountsRoundedToPowersOfTwo
+{
+	SPImportBatchSizer *sizer = [[SPImportBatchSizer alloc] initWithMaxQuerySize:16 * 1024 * 1024 targetNanoseconds:SPTestTargetNanoseconds];
+
+	[sizer setRoundsRowsToPowersOfTwo:YES];
+
+	XCTAssertEqual([sizer rowsPerBatch], 1024U);
+
+	[sizer recordBatchOfRows:1024 duration:10 * NSEC_PER_MSEC];
+
+	XCTAssertEqual([sizer rowsPerBatch], 2048U);
+
+	[sizer recordBatchOfRows:2048 duration:10 * NSEC_PER_SEC];
+
+	XCTAssertEqual([sizer rowsPerBatch], 1024U);
+
+	for (NSUInteger i = 0; i < 20; i++) [sizer recordBatchOfRows:[sizer rowsPerBatch] duration:10 * NSEC_PER_SEC];
+
+	XCTAssertEqual([sizer rowsPerBatch], 16U);
+
+	for (NSUInteger i = 0; i < 40; i++) [sizer recordBatchOfRows:[sizer rowsPerBatch] duration:NSEC_PER_MSEC];
+
+	XCTAssertEqual([sizer rowsPerBatch], 65536U);
+}
+
+@end
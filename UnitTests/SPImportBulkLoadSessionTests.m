@@ -0,0 +1,41 @@
+//
+//  SPImportBulkLoadSessionTests.m
+//  Unit Tests
+//
+//  Created by Sequel Ace contributors on 19.10.26.
+//  Copyright © 2026 Sequel-Ace. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "SPImportBulkLoadSession.h"
+
+@interface SPImportBulkLoadSessionTests : XCTestCase
+
+@end
+
+@implementation SPImportBulkLoadSessionTests
+
+- (void)testSpeedupComparesTimePerRow
+{
+	// 5000 rows in 2s normally, then 100000 rows in 10s
+	double speedup = [SPImportBulkLoadSession speedupWithBaselineRows:5000 nanoseconds:2 * NSEC_PER_SEC bulkRows:100000 nanoseconds:10 * NSEC_PER_SEC];
+
+	XCTAssertEqualWithAccuracy(speedup, 4.0, 0.0001);
+}
+
+- (void)testSpeedupOfSlowerLoadIsBelowOne
+{
+	double speedup = [SPImportBulkLoadSession speedupWithBaselineRows:1000 nanoseconds:NSEC_PER_SEC bulkRows:1000 nanoseconds:2 * NSEC_PER_SEC];
+
+	XCTAssertEqualWithAccuracy(speedup, 0.5, 0.0001);
+}
+
+- (void)testUnmeasuredSpeedupIsZero
+{
+	XCTAssertEqual([SPImportBulkLoadSession speedupWithBaselineRows:0 nanoseconds:0 bulkRows:1000 nanoseconds:NSEC_PER_SEC], 0);
+	XCTAssertEqual([SPImportBulkLoadSession speedupWithBaselineRows:1000 nanoseconds:NSEC_PER_SEC bulkRows:0 nanoseconds:0], 0);
+	XCTAssertEqual([SPImportBulkLoadSession speedupWithBaselineRows:1000 nanoseconds:0 bulkRows:1000 nanoseconds:NSEC_PER_SEC], 0);
+}
+
+@end
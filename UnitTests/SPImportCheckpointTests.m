@@ -0,0 +1,121 @@
+//
+//  SPImportCheckpointTests.m
+//  Unit Tests
+//
+//  Created by Sequel Ace contributors on 19.10.26.
+//  Copyright © 2026 Sequel-Ace. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "SPImportCheckpoint.h"
+
+@interface SPImportCheckpointTests : XCTestCase
+
+@property (nonatomic, copy) NSString *importFilePath;
+
+@end
+
+@implementation SPImportCheckpointTests
+
+- (void)setUp
+{
+	[super setUp];
+
+	self.importFilePath = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSString stringWithFormat:@"%@.sql", [[NSUUID UUID] UUIDString]]];
+
+	[[@"SET NAMES utf8;\nINSERT INTO t VALUES (1);\nINSERT INTO t VALUES (2);\n" dataUsingEncoding:NSUTF8StringEncoding] writeToFile:self.importFilePath atomically:YES];
+}
+
+- (void)tearDown
+{
+	NSString *checkpointPath = [SPImportCheckpoint checkpointPathForImportFilePath:self.importFilePath];
+
+	if (checkpointPath) [[NSFileManager defaultManager] removeItemAtPath:checkpointPath error:nil];
+	[[NSFileManager defaultManager] removeItemAtPath:self.importFilePath error:nil];
+
+	[super tearDown];
+}
+
+- (void)testNoCheckpointReturnsNil
+{
+	XCTAssertNil([SPImportCheckpoint checkpointForImportFilePath:self.importFilePath format:@"SQL"]);
+	XCTAssertNil([[SPImportCheckpoint alloc] initWithImportFilePath:[self.importFilePath stringByAppendingString:@".missing"] format:@"SQL" encoding:NSUTF8StringEncoding]);
+}
+
+- (void)testCheckpointRoundTrip
+{
+	SPImportCheckpoint *checkpoint = [[SPImportCheckpoint alloc] initWithImportFilePath:self.importFilePath format:@"SQL" encoding:NSUTF8StringEncoding];
+
+	[checkpoint recordSessionStatement:@"SET NAMES utf8"];
+	[checkpoint recordPosition:2 offset:42 storedOffset:42 delimiter:@";;" databaseName:@"shop"];
+	[checkpoint commitRecordedPosition];
+
+	XCTAssertTrue([checkpoint writeCheckpoint]);
+	XCTAssertNil([checkpoint writeError]);
+
+	// The sandbox doesn't allow writing next to the imported file
+	XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:[self.importFilePath stringByAppendingPathExtension:@"checkpoint"]]);
+	XCTAssertTrue([[NSFileManager defaultManager] fileExistsAtPath:[SPImportCheckpoint checkpointPathForImportFilePath:self.importFilePath]]);
+
+	SPImportCheckpoint *loaded = [SPImportCheckpoint checkpointForImportFilePath:self.importFilePath format:@"SQL"];
+
+	XCTAssertNotNil(loaded);
+	XCTAssertEqual([loaded encoding], NSUTF8StringEncoding);
+	XCTAssertEqual([loaded position], 2U);
+	XCTAssertEqual([loaded offset], 42ULL);
+	XCTAssertEqualObjects([loaded delimiter], @";;");
+	XCTAssertEqualObjects([loaded databaseName], @"shop");
+	XCTAssertEqualObjects([loaded sessionStatements], @[@"SET NAMES utf8"]);
+
+	// A checkpoint only belongs to the format it was saved by
+	XCTAssertNil([SPImportCheckpoint checkpointForImportFilePath:self.importFilePath format:@"CSV"]);
+}
+
+- (void)testUncommittedPositionIsNotSaved
+{
+	SPImportCheckpoint *checkpoint = [[SPImportCheckpoint alloc] initWithImportFilePath:self.importFilePath format:@"SQL" encoding:NSUTF8StringEncoding];
+
+	[checkpoint recordPosition:1 offset:15 storedOffset:15 delimiter:@";" databaseName:nil];
+	[checkpoint commitRecordedPosition];
+	[checkpoint recordSessionStatement:@"SET autocommit=0"];
+	[checkpoint recordPosition:3 offset:67 storedOffset:67 delimiter:@";" databaseName:nil];
+
+	XCTAssertEqual([checkpoint position], 1U);
+	XCTAssertEqualObjects([checkpoint sessionStatements], @[]);
+
+	[checkpoint writeCheckpoint];
+
+	XCTAssertEqual([[SPImportCheckpoint checkpointForImportFilePath:self.importFilePath format:@"SQL"] offset], 15ULL);
+
+	// Nothing committed leaves nothing to resume from
+	SPImportCheckpoint *emptyCheckpoint = [[SPImportCheckpoint alloc] initWithImportFilePath:self.importFilePath format:@"SQL" encoding:NSUTF8StringEncoding];
+
+	XCTAssertFalse([emptyCheckpoint writeCheckpoint]);
+	XCTAssertNil([SPImportCheckpoint checkpointForImportFilePath:self.importFilePath format:@"SQL"]);
+}
+
+- (void)testChangedFileInvalidatesCheckpoint
+{
+	SPImportCheckpoint *checkpoint = [[SPImportCheckpoint alloc] initWithImportFilePath:self.importFilePath format:@"CSV" encoding:NSUTF8StringEncoding];
+
+	[checkpoint setTableName:@"orders"];
+	[checkpoint recordPosition:100 offset:2048 storedOffset:2048 delimiter:nil databaseName:@"shop"];
+	[checkpoint commitRecordedPosition];
+	[checkpoint writeCheckpoint];
+
+	XCTAssertEqualObjects([[SPImportCheckpoint checkpointForImportFilePath:self.importFilePath format:@"CSV"] tableName], @"orders");
+
+	NSString *checkpointPath = [SPImportCheckpoint checkpointPathForImportFilePath:self.importFilePath];
+
+	NSFileHandle *fileHandle = [NSFileHandle fileHandleForWritingAtPath:self.importFilePath];
+	[fileHandle seekToEndOfFile];
+	[fileHandle writeData:[@"INSERT INTO t VALUES (3);\n" dataUsingEncoding:NSUTF8StringEncoding]];
+	[fileHandle closeFile];
+
+	XCTAssertNil([SPImportCheckpoint checkpointForImportFilePath:self.importFilePath format:@"CSV"]);
+
+	[[NSFileManager defaultManager] removeItemAtPath:checkpointPath error:nil];
+}
+
+@end
@@ -0,0 +1,93 @@
+//
+//  SPJSONRowEncoderTests.m
+//  Unit Tests
+//
+//  Created by Sequel Ace contributors on 19.10.26.
+//  Copyright © 2026 Sequel-Ace. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "SPJSONRowEncoder.h"
+
+#import <SPMySQL/SPMySQL.h>
+
+@interface SPJSONRowEncoderTests : XCTestCase
+
+@end
+
+@implementation SPJSONRowEncoderTests
+
+- (NSString *)encodedRow:(NSArray *)row withEncoder:(SPJSONRowEncoder *)encoder
+{
+	[encoder removeAllBytes];
+	[encoder appendRow:row];
+
+	return [[NSString alloc] initWithBytes:[encoder bytes] length:[encoder length] encoding:NSUTF8StringEncoding];
+}
+
+- (void)testValueKindMapping
+{
+	XCTAssertEqual([SPJSONRowEncoder valueKindForFieldDefinition:@{@"type": @"INT", @"typegrouping": @"integer"}], SPJSONNumberKind);
+	XCTAssertEqual([SPJSONRowEncoder valueKindForFieldDefinition:@{@"type": @"DECIMAL", @"typegrouping": @"float"}], SPJSONNumberKind);
+	XCTAssertEqual([SPJSONRowEncoder valueKindForFieldDefinition:@{@"type": @"JSON", @"typegrouping": @"textdata"}], SPJSONRawKind);
+	XCTAssertEqual([SPJSONRowEncoder valueKindForFieldDefinition:@{@"type": @"VARBINARY", @"typegrouping": @"binary"}], SPJSONBinaryKind);
+	XCTAssertEqual([SPJSONRowEncoder valueKindForFieldDefinition:@{@"type": @"BIT", @"typegrouping": @"bit"}], SPJSONStringKind);
+	XCTAssertEqual([SPJSONRowEncoder valueKindForFieldDefinition:nil], SPJSONStringKind);
+}
+
+- (void)testRowEncoding
+{
+	NSArray *definitions = @[
+		@{@"type": @"INT", @"typegrouping": @"integer"},
+		@{@"type": @"DOUBLE", @"typegrouping": @"float"},
+		@{@"type": @"VARCHAR", @"typegrouping": @"string"},
+		@{@"type": @"JSON", @"typegrouping": @"textdata"},
+		@{@"type": @"VARCHAR", @"typegrouping": @"string"}
+	];
+
+	SPJSONRowEncoder *encoder = [[SPJSONRowEncoder alloc] initWithFieldNames:@[@"id", @"ratio", @"name", @"doc", @"say \"hi\""] fieldDefinitions:definitions];
+
+	XCTAssertEqualObjects([self encodedRow:@[@"1", @"-2.5e-3", @"café", @"{\"a\": [1, 2]}", [NSNull null]] withEncoder:encoder],
+						  @"{\"id\":1,\"ratio\":-2.5e-3,\"name\":\"café\",\"doc\":{\"a\": [1, 2]},\"say \\\"hi\\\"\":null}");
+
+	// Text which isn't a valid JSON number is written as a string
+	XCTAssertEqualObjects([self encodedRow:@[@"007", @"inf", @"a\\b\n\t\x01", [NSNull null], @"x"] withEncoder:encoder],
+						  @"{\"id\":\"007\",\"ratio\":\"inf\",\"name\":\"a\\\\b\\n\\t\\u0001\",\"doc\":null,\"say \\\"hi\\\"\":\"x\"}");
+}
+
+- (void)testBinaryEncoding
+{
+	NSData *data = [NSData dataWithBytes:"\x00\xff\x10" "fo" length:5];
+
+	SPJSONRowEncoder *encoder = [[SPJSONRowEncoder alloc] initWithFieldNames:@[@"b"] fieldDefinitions:@[@{@"type": @"BLOB", @"typegrouping": @"blobdata"}]];
+
+	XCTAssertEqualObjects([self encodedRow:@[data] withEncoder:encoder], @"{\"b\":\"AP8QZm8=\"}");
+
+	[encoder setBinaryEncoding:SPJSONExportHexEncoding];
+
+	XCTAssertEqualObjects([self encodedRow:@[data] withEncoder:encoder], @"{\"b\":\"00ff10666f\"}");
+}
+
+- (void)testGeometryAsGeoJSON
+{
+	// SRID 0, little endian WKB POINT(1.5 -2)
+	double point[2] = {1.5, -2};
+	NSMutableData *wkb = [NSMutableData dataWithBytes:"\x00\x00\x00\x00\x01\x01\x00\x00\x00" length:9];
+	[wkb appendBytes:point length:sizeof(point)];
+
+	SPMySQLGeometryData *geometry = [SPMySQLGeometryData dataWithBytes:[wkb bytes] length:[wkb length] version:5];
+
+	XCTAssertEqualObjects([geometry geoJSONString], @"{\"type\":\"Point\",\"coordinates\":[1.5,-2]}");
+
+	SPJSONRowEncoder *encoder = [[SPJSONRowEncoder alloc] initWithFieldNames:@[@"g"] fieldDefinitions:@[@{@"type": @"GEOMETRY", @"typegrouping": @"geometry"}]];
+
+	XCTAssertEqualObjects([self encodedRow:@[geometry] withEncoder:encoder], @"{\"g\":{\"type\":\"Point\",\"coordinates\":[1.5,-2]}}");
+
+	// A truncated buffer can't be parsed
+	geometry = [SPMySQLGeometryData dataWithBytes:[wkb bytes] length:([wkb length] - 4) version:5];
+
+	XCTAssertNil([geometry geoJSONString]);
+}
+
+@end
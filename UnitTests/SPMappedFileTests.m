@@ -0,0 +1,101 @@
+//
+//  SPMappedFileTests.m
+//  Unit Tests
+//
+//  Created by Sequel Ace contributors on 19.10.26.
+//  Copyright © 2026 Sequel-Ace. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "SPMappedFile.h"
+#import "SPFileHandle.h"
+
+@interface SPMappedFileTests : XCTestCase
+
+@property (nonatomic, copy) NSString *filePath;
+@property (nonatomic, strong) NSData *fileData;
+
+@end
+
+@implementation SPMappedFileTests
+
+- (void)setUp
+{
+	[super setUp];
+
+	NSMutableData *data = [NSMutableData dataWithLength:3 * 1024 * 1024 + 17];
+	uint8_t *bytes = [data mutableBytes];
+
+	for (NSUInteger i = 0; i < [data length]; i++) bytes[i] = (uint8_t)(i * 31 + i / 251);
+
+	self.fileData = data;
+	self.filePath = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSString stringWithFormat:@"%@.sql", [[NSUUID UUID] UUIDString]]];
+
+	[data writeToFile:self.filePath atomically:YES];
+}
+
+- (void)tearDown
+{
+	[[NSFileManager defaultManager] removeItemAtPath:self.filePath error:nil];
+
+	[super tearDown];
+}
+
+- (void)testSequentialSlicesAreContiguous
+{
+	SPMappedFile *mappedFile = [[SPMappedFile alloc] initWithPath:[self.filePath fileSystemRepresentation] offset:0];
+	NSMutableData *readData = [NSMutableData data];
+	const uint8_t *expectedBytes = NULL;
+	NSData *slice;
+
+	XCTAssertNotNil(mappedFile);
+	XCTAssertEqual([mappedFile fileLength], (unsigned long long)[self.fileData length]);
+
+	while ([(slice = [mappedFile readDataOfLength:1000003]) length])
+	{
+		if (expectedBytes) XCTAssertEqual((const uint8_t *)[slice bytes], expectedBytes);
+		expectedBytes = (const uint8_t *)[slice bytes] + [slice length];
+
+		[readData appendData:slice];
+	}
+
+	XCTAssertEqualObjects(readData, self.fileData);
+	XCTAssertEqual([mappedFile offset], (unsigned long long)[self.fileData length]);
+}
+
+- (void)testStartOffsetAndSkipping
+{
+	SPMappedFile *mappedFile = [[SPMappedFile alloc] initWithPath:[self.filePath fileSystemRepresentation] offset:4097];
+
+	XCTAssertTrue([mappedFile skipDataOfLength:10]);
+	XCTAssertEqualObjects([mappedFile readDataOfLength:100], [self.fileData subdataWithRange:NSMakeRange(4107, 100)]);
+
+	XCTAssertFalse([mappedFile skipDataOfLength:[self.fileData length]]);
+	XCTAssertEqual([mappedFile offset], 4207ULL);
+}
+
+- (void)testMissingFileReturnsNil
+{
+	XCTAssertNil([[SPMappedFile alloc] initWithPath:[[self.filePath stringByAppendingString:@".missing"] fileSystemRepresentation] offset:0]);
+}
+
+- (void)testFileHandleReadsMappedData
+{
+	SPFileHandle *fileHandle = [SPFileHandle fileHandleForReadingAtPath:self.filePath];
+	NSMutableData *readData = [NSMutableData data];
+
+	// Reading switches to the mapping part way through the file
+	[readData appendData:[fileHandle readDataOfLength:5]];
+
+	NSData *chunk;
+
+	while ([(chunk = [fileHandle readStreamedDataOfLength:262144]) length]) [readData appendData:chunk];
+
+	XCTAssertEqualObjects(readData, self.fileData);
+	XCTAssertEqual([fileHandle realDataReadLength], [self.fileData length]);
+
+	[fileHandle closeFile];
+}
+
+@end
@@ -0,0 +1,204 @@
+//
+//  SPParallelDecompressorTests.m
+//  Unit Tests
+//
+//  Created by Sequel Ace contributors on 19.10.26.
+//  Copyright © 2026 Sequel-Ace. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "SPParallelDecompressor.h"
+#import "SPFileHandle.h"
+#import "bzlib.h"
+#import <zlib.h>
+
+@interface SPParallelDecompressorTests : XCTestCase
+
+@property (nonatomic, copy) NSString *filePath;
+@property (nonatomic, strong) NSData *fileData;
+
+@end
+
+@implementation SPParallelDecompressorTests
+
+- (void)setUp
+{
+	[super setUp];
+
+	// Rows of varied text, so that bzip2 makes many blocks of it
+	NSMutableString *rows = [NSMutableString string];
+	uint32_t seed = 1;
+
+	for (NSUInteger i = 0; [rows length] < 2 * 1024 * 1024; i++)
+	{
+		seed = seed * 1103515245 + 12345;
+		[rows appendFormat:@"INSERT INTO `orders` VALUES (%lu,'customer %u','%08x');\n", (unsigned long)i, seed % 5000, seed];
+	}
+
+	self.fileData = [rows dataUsingEncoding:NSUTF8StringEncoding];
+	self.filePath = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSString stringWithFormat:@"%@.sql", [[NSUUID UUID] UUIDString]]];
+}
+
+- (void)tearDown
+{
+	[[NSFileManager defaultManager] removeItemAtPath:self.filePath error:nil];
+
+	[super tearDown];
+}
+
+/**
+ * Compresses each of the supplied ranges of the file data as a separate stream, one after another.
+ */
+- (NSData *)_bzip2DataWithStreamRanges:(NSArray *)ranges
+{
+	NSMutableData *compressedData = [NSMutableData data];
+
+	for (NSValue *range in ranges)
+	{
+		NSRange streamRange = [range rangeValue];
+		unsigned int compressedLength = (unsigned int)(streamRange.length * 2 + 1024);
+		NSMutableData *stream = [NSMutableData dataWithLength:compressedLength];
+
+		// The smallest block size, for more blocks
+		XCTAssertEqual(BZ2_bzBuffToBuffCompress([stream mutableBytes], &compressedLength, (char *)[self.fileData bytes] + streamRange.location, (unsigned int)streamRange.length, 1, 0, 0), BZ_OK);
+
+		[compressedData appendBytes:[stream bytes] length:compressedLength];
+	}
+
+	return compressedData;
+}
+
+- (NSData *)_gzipDataWithMemberRanges:(NSArray *)ranges
+{
+	NSMutableData *compressedData = [NSMutableData data];
+
+	for (NSValue *range in ranges)
+	{
+		NSRange memberRange = [range rangeValue];
+		NSMutableData *member = [NSMutableData dataWithLength:memberRange.length * 2 + 1024];
+		z_stream stream;
+
+		memset(&stream, 0, sizeof(stream));
+		deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY);
+
+		stream.next_in = (Bytef *)[self.fileData bytes] + memberRange.location;
+		stream.avail_in = (uInt)memberRange.length;
+		stream.next_out = [member mutableBytes];
+		stream.avail_out = (uInt)[member length];
+
+		XCTAssertEqual(deflate(&stream, Z_FINISH), Z_STREAM_END);
+
+		[compressedData appendBytes:[member bytes] length:[member length] - stream.avail_out];
+
+		deflateEnd(&stream);
+	}
+
+	return compressedData;
+}
+
+- (NSData *)_decompressFileWithFormat:(SPFileCompressionFormat)format readLength:(NSUInteger)readLength
+{
+	SPParallelDecompressor *decompressor = [[SPParallelDecompressor alloc] initWithPath:[self.filePath fileSystemRepresentation] compressionFormat:format];
+	NSMutableData *readData = [NSMutableData data];
+	NSData *chunk;
+
+	XCTAssertNotNil(decompressor);
+
+	while ([(chunk = [decompressor readDataOfLength:readLength]) length])
+	{
+		XCTAssertLessThanOrEqual([chunk length], readLength);
+
+		[readData appendData:chunk];
+	}
+
+	return readData;
+}
+
+- (void)testBzip2Blocks
+{
+	NSData *compressedData = [self _bzip2DataWithStreamRanges:@[[NSValue valueWithRange:NSMakeRange(0, [self.fileData length])]]];
+
+	[compressedData writeToFile:self.filePath atomically:YES];
+
+	XCTAssertEqualObjects([self _decompressFileWithFormat:SPBzip2Compression readLength:262144], self.fileData);
+	XCTAssertEqualObjects([self _decompressFileWithFormat:SPBzip2Compression readLength:1000], self.fileData);
+}
+
+- (void)testConcatenatedBzip2Streams
+{
+	NSUInteger third = [self.fileData length] / 3;
+	NSData *compressedData = [self _bzip2DataWithStreamRanges:@[
+		[NSValue valueWithRange:NSMakeRange(0, third)],
+		[NSValue valueWithRange:NSMakeRange(third, 17)],
+		[NSValue valueWithRange:NSMakeRange(third + 17, [self.fileData length] - third - 17)]
+	]];
+
+	[compressedData writeToFile:self.filePath atomically:YES];
+
+	XCTAssertEqualObjects([self _decompressFileWithFormat:SPBzip2Compression readLength:262144], self.fileData);
+}
+
+- (void)testConcatenatedGzipMembers
+{
+	NSUInteger half = [self.fileData length] / 2;
+	NSData *compressedData = [self _gzipDataWithMemberRanges:@[
+		[NSValue valueWithRange:NSMakeRange(0, half)],
+		[NSValue valueWithRange:NSMakeRange(half, [self.fileData length] - half)]
+	]];
+
+	[compressedData writeToFile:self.filePath atomically:YES];
+
+	XCTAssertEqualObjects([self _decompressFileWithFormat:SPGzipCompression readLength:262144], self.fileData);
+}
+
+- (void)testDamagedFileRaises
+{
+	NSMutableData *compressedData = [[self _bzip2DataWithStreamRanges:@[[NSValue valueWithRange:NSMakeRange(0, [self.fileData length])]]] mutableCopy];
+
+	// Damage the middle of the first block
+	((uint8_t *)[compressedData mutableBytes])[5000] ^= 0xFF;
+
+	[compressedData writeToFile:self.filePath atomically:YES];
+
+	XCTAssertThrowsSpecificNamed([self _decompressFileWithFormat:SPBzip2Compression readLength:262144], NSException, NSFileHandleOperationException);
+}
+
+- (void)testTruncatedGzipFileRaises
+{
+	NSData *compressedData = [self _gzipDataWithMemberRanges:@[[NSValue valueWithRange:NSMakeRange(0, [self.fileData length])]]];
+
+	[[compressedData subdataWithRange:NSMakeRange(0, [compressedData length] / 2)] writeToFile:self.filePath atomically:YES];
+
+	XCTAssertThrowsSpecificNamed([self _decompressFileWithFormat:SPGzipCompression readLength:262144], NSException, NSFileHandleOperationException);
+}
+
+- (void)testFileHandleReadsStreamedData
+{
+	NSData *compressedData = [self _bzip2DataWithStreamRanges:@[[NSValue valueWithRange:NSMakeRange(0, [self.fileData length])]]];
+
+	[compressedData writeToFile:self.filePath atomically:YES];
+
+	SPFileHandle *fileHandle = [SPFileHandle fileHandleForReadingAtPath:self.filePath];
+	NSMutableData *readData = [NSMutableData data];
+
+	XCTAssertEqual([fileHandle compressionFormat], SPBzip2Compression);
+
+	// Reading switches to the decompressor part way through the file
+	[readData appendData:[fileHandle readDataOfLength:5]];
+
+	XCTAssertTrue([fileHandle skipDataOfLength:10]);
+
+	[readData appendData:[self.fileData subdataWithRange:NSMakeRange(5, 10)]];
+
+	NSData *chunk;
+
+	while ([(chunk = [fileHandle readStreamedDataOfLength:262144]) length]) [readData appendData:chunk];
+
+	XCTAssertEqualObjects(readData, self.fileData);
+	XCTAssertEqual([fileHandle realDataReadLength], [compressedData length]);
+
+	[fileHandle closeFile];
+}
+
+@end
@@ -0,0 +1,235 @@
+//
+//  SPSQLStatementSplitterTests.m
+//  Unit Tests
+//
+//  Created by Sequel Ace contributors on 19.10.26.
+//  Copyright © 2026 Sequel-Ace. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "SPSQLStatementSplitter.h"
+#import "SPTestingUtils.h"
+
+@interface SPSQLStatementSplitterTests : XCTestCase
+
+@end
+
+@implementation SPSQLStatementSplitterTests
+
+/**
+ * Splits the SQL, appending it in chunks of the given length (or all at once for 0), and returns the statements.
+ */
+- (NSArray *)statementsInSQL:(NSString *)sql chunkLength:(NSUInteger)chunkLength noBackslashEscapes:(BOOL)noBackslashEscapes
+{
+	NSData *data = [sql dataUsingEncoding:NSUTF8StringEncoding];
+	const uint8_t *bytes = [data bytes];
+	NSUInteger length = [data length];
+	NSUInteger position = 0;
+	NSMutableArray *statements = [NSMutableArray array];
+	SPSQLStatement statement;
+
+	SPSQLStatementSplitter *splitter = SPSQLStatementSplitterCreate();
+	SPSQLStatementSplitterSetNoBackslashEscapes(splitter, noBackslashEscapes);
+
+	while (1)
+	{
+		NSUInteger appendLength = chunkLength ? MIN(chunkLength, length - position) : length - position;
+		BOOL endOfInput = !appendLength;
+
+		if (appendLength) XCTAssertTrue(SPSQLStatementSplitterAppend(splitter, bytes + position, appendLength));
+		position += appendLength;
+
+		while (SPSQLStatementSplitterNextStatement(splitter, endOfInput, &statement))
+		{
+			[statements addObject:[[NSString alloc] initWithBytes:statement.bytes length:statement.length encoding:NSUTF8StringEncoding]];
+		}
+
+		if (endOfInput) break;
+	}
+
+	XCTAssertEqual(SPSQLStatementSplitterConsumedLength(splitter), (uint64_t)length);
+
+	SPSQLStatementSplitterFree(splitter);
+
+	return statements;
+}
+
+/**
+ * Checks the statements found are the same however the SQL is broken into chunks.
+ */
+- (void)assertSQL:(NSString *)sql noBackslashEscapes:(BOOL)noBackslashEscapes splitsInto:(NSArray *)expected
+{
+	NSUInteger length = [sql lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+
+	for (NSUInteger chunkLength = 0; chunkLength <= length; chunkLength++)
+	{
+		XCTAssertEqualObjects([self statementsInSQL:sql chunkLength:chunkLength noBackslashEscapes:noBackslashEscapes], expected, @"chunk length %lu", (unsigned long)chunkLength);
+	}
+}
+
+- (void)testSimpleStatements
+{
+	[self assertSQL:@"SELECT 1; SELECT 2;\nSELECT 3" noBackslashEscapes:NO splitsInto:(@[@"SELECT 1", @"SELECT 2", @"SELECT 3"])];
+	[self assertSQL:@"  ;;  ; \n" noBackslashEscapes:NO splitsInto:@[]];
+}
+
+- (void)testQuotedDelimiters
+{
+	[self assertSQL:@"INSERT INTO t VALUES ('a;b', \"c;d\", `e;f`);" noBackslashEscapes:NO splitsInto:@[@"INSERT INTO t VALUES ('a;b', \"c;d\", `e;f`)"]];
+	[self assertSQL:@"SELECT 'it''s;'; SELECT `a``;`;" noBackslashEscapes:NO splitsInto:(@[@"SELECT 'it''s;'", @"SELECT `a``;`"])];
+	[self assertSQL:@"SELECT 'ünïcødé; ✓'; SELECT 2" noBackslashEscapes:NO splitsInto:(@[@"SELECT 'ünïcødé; ✓'", @"SELECT 2"])];
+}
+
+- (void)testBackslashEscapes
+{
+	[self assertSQL:@"SELECT 'it\\'s;'; SELECT 2" noBackslashEscapes:NO splitsInto:(@[@"SELECT 'it\\'s;'", @"SELECT 2"])];
+	[self assertSQL:@"SELECT 'a\\'; SELECT 2" noBackslashEscapes:YES splitsInto:(@[@"SELECT 'a\\'", @"SELECT 2"])];
+	[self assertSQL:@"SELECT `a\\`; SELECT 2" noBackslashEscapes:NO splitsInto:(@[@"SELECT `a\\`", @"SELECT 2"])];
+}
+
+- (void)testComments
+{
+	[self assertSQL:@"-- c;\nSELECT 1; # x;y\nSELECT 2 /* ; */;" noBackslashEscapes:NO splitsInto:(@[@"-- c;\nSELECT 1", @"# x;y\nSELECT 2 /* ; */"])];
+	[self assertSQL:@"SELECT 1--2;\nSELECT 3;" noBackslashEscapes:NO splitsInto:(@[@"SELECT 1--2", @"SELECT 3"])];
+	[self assertSQL:@"SELECT 1 /*/ ; */;" noBackslashEscapes:NO splitsInto:@[@"SELECT 1 /*/ ; */"]];
+}
+
+- (void)testDelimiterCommands
+{
+	NSString *dump = @"/*!40101 SET NAMES utf8 */;\nDELIMITER ;;\nCREATE TRIGGER t BEGIN SET a=1; SET b=2; END ;;\nDELIMITER ;\nSELECT 1;";
+
+	[self assertSQL:dump noBackslashEscapes:NO splitsInto:(@[@"/*!40101 SET NAMES utf8 */", @"CREATE TRIGGER t BEGIN SET a=1; SET b=2; END", @"SELECT 1"])];
+	[self assertSQL:@"delimiter //\nSELECT 1//SELECT '//'//" noBackslashEscapes:NO splitsInto:(@[@"SELECT 1", @"SELECT '//'"])];
+
+	// DELIMITER is only a command at the start of a statement
+	[self assertSQL:@"SELECT delimiter FROM t;" noBackslashEscapes:NO splitsInto:@[@"SELECT delimiter FROM t"]];
+}
+
+- (void)testUnterminatedStatement
+{
+	[self assertSQL:@"SELECT 1; SELECT 'unterminated; x" noBackslashEscapes:NO splitsInto:(@[@"SELECT 1", @"SELECT 'unterminated; x"])];
+}
+
+- (void)testCarriageReturns
+{
+	const char *sql = "SELECT 1;\nSELECT\r\n2;";
+	SPSQLStatement statement;
+	SPSQLStatementSplitter *splitter = SPSQLStatementSplitterCreate();
+
+	SPSQLStatementSplitterAppend(splitter, sql, strlen(sql));
+
+	XCTAssertTrue(SPSQLStatementSplitterNextStatement(splitter, true, &statement));
+	XCTAssertFalse(statement.containsCarriageReturns);
+	XCTAssertTrue(statement.terminated);
+
+	XCTAssertTrue(SPSQLStatementSplitterNextStatement(splitter, true, &statement));
+	XCTAssertTrue(statement.containsCarriageReturns);
+
+	XCTAssertFalse(SPSQLStatementSplitterNextStatement(splitter, true, &statement));
+
+	SPSQLStatementSplitterFree(splitter);
+}
+
+- (void)testAppendNoCopy
+{
+	NSMutableString *sql = [NSMutableString string];
+
+	for (NSUInteger i = 0; i < 5000; i++) [sql appendFormat:@"INSERT INTO t VALUES (%lu, 'a;b');\n", (unsigned long)i];
+	[sql appendString:@"DELIMITER ;;\nCREATE TRIGGER x BEGIN SELECT 1; END;;\nDELIMITER ;\nSELECT 'tail'"];
+
+	NSArray *expectedStatements = [self statementsInSQL:sql chunkLength:0 noBackslashEscapes:NO];
+	NSData *data = [sql dataUsingEncoding:NSUTF8StringEncoding];
+	NSMutableArray *copies = [NSMutableArray array];
+	NSMutableArray *statements = [NSMutableArray array];
+	SPSQLStatement statement;
+
+	SPSQLStatementSplitter *splitter = SPSQLStatementSplitterCreate();
+
+	// Pieces of the one buffer follow each other in memory, as slices of a mapped file do; every
+	// third piece is a copy elsewhere, which doesn't
+	for (NSUInteger position = 0, piece = 0; ; piece++)
+	{
+		NSUInteger length = MIN(7001, [data length] - position);
+		const uint8_t *bytes = (const uint8_t *)[data bytes] + position;
+
+		if (length && !(piece % 3)) {
+			NSData *copy = [NSData dataWithBytes:bytes length:length];
+			[copies addObject:copy];
+			bytes = [copy bytes];
+		}
+
+		if (length) XCTAssertTrue(SPSQLStatementSplitterAppendNoCopy(splitter, bytes, length));
+
+		while (SPSQLStatementSplitterNextStatement(splitter, !length, &statement))
+		{
+			[statements addObject:[[NSString alloc] initWithBytes:statement.bytes length:statement.length encoding:NSUTF8StringEncoding]];
+		}
+
+		if (!length) break;
+
+		position += length;
+	}
+
+	XCTAssertEqualObjects(statements, expectedStatements);
+	XCTAssertEqual(SPSQLStatementSplitterConsumedLength(splitter), (uint64_t)[data length]);
+
+	SPSQLStatementSplitterFree(splitter);
+}
+
+- (void)testSetDelimiter
+{
+	const char *sql = "CREATE TRIGGER t BEGIN SET a=1; END ;;\nDELIMITER ;\nSELECT 1;";
+	SPSQLStatement statement;
+	size_t delimiterLength;
+	SPSQLStatementSplitter *splitter = SPSQLStatementSplitterCreate();
+
+	// A resumed read starts part way through the dump, inside a DELIMITER section
+	XCTAssertTrue(SPSQLStatementSplitterSetDelimiter(splitter, ";;", 2));
+	SPSQLStatementSplitterAppend(splitter, sql, strlen(sql));
+
+	XCTAssertTrue(SPSQLStatementSplitterNextStatement(splitter, true, &statement));
+	XCTAssertEqualObjects([[NSString alloc] initWithBytes:statement.bytes length:statement.length encoding:NSUTF8StringEncoding], @"CREATE TRIGGER t BEGIN SET a=1; END");
+
+	XCTAssertTrue(SPSQLStatementSplitterNextStatement(splitter, true, &statement));
+	XCTAssertEqualObjects([[NSString alloc] initWithBytes:statement.bytes length:statement.length encoding:NSUTF8StringEncoding], @"SELECT 1");
+
+	const uint8_t *delimiter = SPSQLStatementSplitterDelimiter(splitter, &delimiterLength);
+	XCTAssertEqual(delimiterLength, (size_t)1);
+	XCTAssertEqual(delimiter[0], ';');
+
+	XCTAssertFalse(SPSQLStatementSplitterSetDelimiter(splitter, "", 0));
+
+	SPSQLStatementSplitterFree(splitter);
+}
+
+- (void)testPerformance_splitDump
+{
+	SASkipUnlessPerformanceTestsEnabled();
+
+	NSMutableData *dump = [NSMutableData data];
+	NSData *insert = [@"INSERT INTO `orders` VALUES (1,'Some customer name, with a comma',NULL,3.14159,'A longer description \\'quoted\\' here'),(2,'x','y',4,'z');\n" dataUsingEncoding:NSUTF8StringEncoding];
+
+	for (NSUInteger i = 0; i < 200000; i++) [dump appendData:insert];
+
+	[self measureBlock:^{
+		SPSQLStatementSplitter *splitter = SPSQLStatementSplitterCreate();
+		SPSQLStatement statement;
+		NSUInteger statementCount = 0;
+
+		for (NSUInteger position = 0; position < [dump length]; position += 1024 * 1024)
+		{
+			SPSQLStatementSplitterAppend(splitter, (const uint8_t *)[dump bytes] + position, MIN(1024 * 1024, [dump length] - position));
+
+			while (SPSQLStatementSplitterNextStatement(splitter, false, &statement)) statementCount++;
+		}
+
+		while (SPSQLStatementSplitterNextStatement(splitter, true, &statement)) statementCount++;
+
+		XCTAssertEqual(statementCount, 200000U);
+
+		SPSQLStatementSplitterFree(splitter);
+	}];
+}
+
+@end
@@ -0,0 +1,142 @@
+//
+//  SPTransferStatisticsTests.m
+//  Unit Tests
+//
+//  Created by Sequel Ace contributors on 19.10.26.
+//  Copyright © 2026 Sequel-Ace. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "SPTransferStatistics.h"
+
+@interface SPTransferStatisticsTests : XCTestCase
+
+@end
+
+@implementation SPTransferStatisticsTests
+
+- (void)testExportDirectionReadsFromServerAndWritesToFile
+{
+	SPTransferStatistics *statistics = [[SPTransferStatistics alloc] initWithDirection:SPTransferExport];
+
+	[statistics addRows:100];
+	[statistics addServerBytes:4000];
+	[statistics addFileBytes:3000];
+	[statistics addStoredFileBytes:1000];
+	[statistics finish];
+
+	XCTAssertEqual([statistics rows], 100ULL);
+	XCTAssertEqualWithAccuracy([statistics compressionRatio], 3.0, 0.0001);
+
+	double elapsed = [statistics elapsedNanoseconds] / (double)NSEC_PER_SEC;
+
+	XCTAssertGreaterThan(elapsed, 0);
+	XCTAssertEqualWithAccuracy([statistics inputBytesPerSecond], 4000 / elapsed, 0.01);
+	XCTAssertEqualWithAccuracy([statistics outputBytesPerSecond], 1000 / elapsed, 0.01);
+}
+
+- (void)testImportDirectionReadsFromFileAndWritesToServer
+{
+	SPTransferStatistics *statistics = [[SPTransferStatistics alloc] initWithDirection:SPTransferImport];
+
+	[statistics addFileBytes:500];
+	[statistics addServerBytes:800];
+	[statistics finish];
+
+	// Without a separate stored length the file is taken to be uncompressed
+	XCTAssertEqual([statistics storedFileBytes], 500ULL);
+	XCTAssertEqualWithAccuracy([statistics compressionRatio], 1.0, 0.0001);
+
+	double elapsed = [statistics elapsedNanoseconds] / (double)NSEC_PER_SEC;
+
+	XCTAssertEqualWithAccuracy([statistics inputBytesPerSecond], 500 / elapsed, 0.01);
+	XCTAssertEqualWithAccuracy([statistics outputBytesPerSecond], 800 / elapsed, 0.01);
+}
+
+- (void)testFinishFreezesTheClock
+{
+	SPTransferStatistics *statistics = [[SPTransferStatistics alloc] initWithDirection:SPTransferExport];
+
+	[statistics finish];
+
+	uint64_t elapsed = [statistics elapsedNanoseconds];
+
+	usleep(2000);
+
+	[statistics finish];
+
+	XCTAssertEqual([statistics elapsedNanoseconds], elapsed);
+}
+
+- (void)testPausedTimeIsExcluded
+{
+	SPTransferStatistics *statistics = [[SPTransferStatistics alloc] initWithDirection:SPTransferImport];
+
+	[statistics pause];
+	usleep(50000);
+	[statistics resume];
+	[statistics finish];
+
+	XCTAssertLessThan([statistics elapsedNanoseconds], 25 * NSEC_PER_MSEC);
+}
+
+- (void)testUnattributedTimeFillsTheRemainder
+{
+	SPTransferStatistics *statistics = [[SPTransferStatistics alloc] initWithDirection:SPTransferImport];
+
+	usleep(2000);
+
+	[statistics addNanoseconds:1000 toStage:SPTransferServerStage];
+	[statistics finish];
+	[statistics addUnattributedTimeToStage:SPTransferEncodingStage];
+
+	XCTAssertEqual([statistics nanosecondsInStage:SPTransferServerStage] + [statistics nanosecondsInStage:SPTransferEncodingStage], [statistics elapsedNanoseconds]);
+
+	// Everything is attributed now, so a second call adds nothing
+	uint64_t encoding = [statistics nanosecondsInStage:SPTransferEncodingStage];
+
+	[statistics addUnattributedTimeToStage:SPTransferEncodingStage];
+
+	XCTAssertEqual([statistics nanosecondsInStage:SPTransferEncodingStage], encoding);
+}
+
+- (void)testReportDictionary
+{
+	SPTransferStatistics *statistics = [[SPTransferStatistics alloc] initWithDirection:SPTransferExport];
+
+	[statistics addStatements:3 errors:1];
+	[statistics addNanoseconds:2 * NSEC_PER_SEC toStage:SPTransferDiskStage];
+	[statistics recordTable:@"orders" rowCount:42 duration:NSEC_PER_SEC / 2];
+	[statistics finish];
+
+	NSDictionary *report = [statistics reportDictionary];
+
+	XCTAssertEqualObjects(report[@"direction"], @"export");
+	XCTAssertEqualObjects(report[@"statements"], @3);
+	XCTAssertEqualObjects(report[@"statementErrors"], @1);
+	XCTAssertEqualObjects(report[@"stageSeconds"][@"disk"], @2.0);
+	XCTAssertEqualObjects(report[@"tables"], (@[@{@"table" : @"orders", @"rows" : @42, @"seconds" : @0.5}]));
+	XCTAssertTrue([NSJSONSerialization isValidJSONObject:report]);
+}
+
+- (void)testWriteReport
+{
+	SPTransferStatistics *statistics = [[SPTransferStatistics alloc] initWithDirection:SPTransferExport];
+	NSString *exportPath = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSString stringWithFormat:@"%@.sql", [[NSUUID UUID] UUIDString]]];
+	NSString *reportPath = [SPTransferStatistics reportPathForFileAtPath:exportPath];
+
+	[statistics addRows:7];
+	[statistics finish];
+
+	XCTAssertEqualObjects(reportPath, [exportPath stringByAppendingString:@".report.json"]);
+	XCTAssertTrue([statistics writeReportForFileAtPath:exportPath]);
+
+	NSDictionary *report = [NSJSONSerialization JSONObjectWithData:[NSData dataWithContentsOfFile:reportPath] options:0 error:nil];
+
+	XCTAssertEqualObjects(report[@"rows"], @7);
+
+	[[NSFileManager defaultManager] removeItemAtPath:reportPath error:nil];
+}
+
+@end
@@ -0,0 +1,56 @@
+//
+//  SPXMLRowEncoderTests.m
+//  Unit Tests
+//
+//  Created by Sequel Ace contributors on 19.10.26.
+//  Copyright © 2026 Sequel-Ace. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "SPXMLRowEncoder.h"
+
+@interface SPXMLRowEncoderTests : XCTestCase
+
+@end
+
+@implementation SPXMLRowEncoderTests
+
+- (NSString *)encodedRow:(NSArray *)row withEncoder:(SPXMLRowEncoder *)encoder
+{
+	[encoder removeAllBytes];
+	[encoder appendRow:row];
+
+	return [[NSString alloc] initWithBytes:[encoder bytes] length:[encoder length] encoding:NSUTF8StringEncoding];
+}
+
+- (void)testMySQLFormat
+{
+	SPXMLRowEncoder *encoder = [[SPXMLRowEncoder alloc] initWithFieldNames:@[@"id", @"a<b", @"note"] format:SPXMLExportMySQLFormat nullString:@"NULL"];
+
+	XCTAssertEqualObjects([self encodedRow:@[@"1", [NSNull null], @"fish & \"chips\" <b>café</b>"] withEncoder:encoder],
+						  @"\t<row>\n"
+						  @"\t\t<field name=\"id\">1</field>\n"
+						  @"\t\t<field name=\"a&lt;b\" xsi:nil=\"true\" />\n"
+						  @"\t\t<field name=\"note\">fish &amp; \"chips\" &lt;b&gt;café&lt;/b&gt;</field>\n"
+						  @"\t</row>\n\n");
+}
+
+- (void)testPlainFormat
+{
+	SPXMLRowEncoder *encoder = [[SPXMLRowEncoder alloc] initWithFieldNames:@[@"id", @"note"] format:SPXMLExportPlainFormat nullString:@"<null>"];
+
+	XCTAssertEqualObjects([self encodedRow:@[[@"7" dataUsingEncoding:NSUTF8StringEncoding], [NSNull null]] withEncoder:encoder],
+						  @"\t<row>\n"
+						  @"\t\t<id>7</id>\n"
+						  @"\t\t<note>&lt;null&gt;</note>\n"
+						  @"\t</row>\n\n");
+
+	// Content matches the string escaping used when writing other encodings
+	NSString *content = @"1 < 2 && 3 > 2 – ✓";
+
+	XCTAssertEqualObjects([self encodedRow:@[content, @""] withEncoder:encoder],
+						  ([NSString stringWithFormat:@"\t<row>\n\t\t<id>%@</id>\n\t\t<note></note>\n\t</row>\n\n", [content XMLEscapeStringForContent]]));
+}
+
+@end